@@ -1,5 +1,5 @@
 /*
-    Copyright (C) 1995-2017, The AROS Development Team. All rights reserved.
+    Copyright (C) 1995-2026, The AROS Development Team. All rights reserved.
 
     Desc: X11 hidd. Connects to the X server and receives events.
 */
@@ -17,6 +17,7 @@
 #include "x11gfx_fullscreen.h"
 
 VOID X11BM_ExposeFB(APTR data, WORD x, WORD y, WORD width, WORD height);
+VOID X11BM_FlushShadow(APTR data);
 
 /****************************************************************************************/
 
@@ -600,15 +601,34 @@ VOID x11task_entry(struct x11task_params *xtpparam)
             x11clipboard_handle_commands(xsd);
         }
 
+        if ((sigs & SIGBREAKF_CTRL_D) && (xsd->options & OPTION_SHADOWFB))
+        {
+            struct xwinnode *node;
+
+            /* Once per frame, show what was drawn into the shadow framebuffers */
+            ForeachNode(&xwindowlist, node)
+            {
+                X11BM_FlushShadow(OOP_INST_DATA(OOP_OCLASS(node->bmobj), node->bmobj));
+            }
+        }
+
         for (;;)
         {
             struct xwinnode *node;
             int pending;
 
             LOCK_X11
-            XCALL(XFlush, xsd->display);
-            XCALL(XSync, xsd->display, FALSE);
-            pending = XCALL(XEventsQueued, xsd->display, QueuedAlready);
+            if (xsd->options & OPTION_SHADOWFB)
+            {
+                /* Read what has arrived, without a round trip every frame */
+                pending = XCALL(XEventsQueued, xsd->display, QueuedAfterFlush);
+            }
+            else
+            {
+                XCALL(XFlush, xsd->display);
+                XCALL(XSync, xsd->display, FALSE);
+                pending = XCALL(XEventsQueued, xsd->display, QueuedAlready);
+            }
             UNLOCK_X11
 
             if (pending == 0)
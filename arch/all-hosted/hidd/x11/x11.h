@@ -2,7 +2,7 @@
 #define HIDD_X11_H
 
 /*
-    Copyright  1995-2025, The AROS Development Team. All rights reserved.
+    Copyright  1995-2026, The AROS Development Team. All rights reserved.
     $Id$
 
     Desc: Include for the x11 HIDD.
@@ -153,6 +153,7 @@ struct x11_staticdata
     OOP_Class 	    	        *gfxclass;
 
     OOP_Class 	    	        *bmclass;
+    OOP_Class 	    	        *shadowbmclass;
     OOP_Class 	    	        *mouseclass;
     OOP_Class 	    	        *kbdclass;
 
@@ -223,6 +224,7 @@ struct x11_staticdata
 #define OPTION_BACKINGSTORE     (1 << 1)
 #define OPTION_FORCESTDMODES    (1 << 2)
 #define OPTION_DELAYXWINMAPPING (1 << 3)
+#define OPTION_SHADOWFB         (1 << 4)    /* Render the framebuffer into XShm memory, see x11gfx_shadowbitmap.c */
 
 /* Send the message and wait for the reply */
 static inline void X11DoNotify(struct x11_staticdata *xsd, struct notify_msg *msg)
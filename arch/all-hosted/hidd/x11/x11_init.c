@@ -1,5 +1,5 @@
 /*
-    Copyright (C) 1995-2020, The AROS Development Team. All rights reserved.
+    Copyright (C) 1995-2026, The AROS Development Team. All rights reserved.
 
     Desc: X11 hidd initialization code.
 */
@@ -188,6 +188,11 @@ int X11_Init(struct x11_staticdata *xsd)
                         xsd->options |= OPTION_DELAYXWINMAPPING;
                     }
 
+                    if (strcmp("--shadowfb", n->ln_Name) == 0)
+                    {
+                        xsd->options |= OPTION_SHADOWFB;
+                    }
+
                 }
             }
         }
@@ -197,6 +202,10 @@ int X11_Init(struct x11_staticdata *xsd)
             {
                 D(bug("[X11] %s: option DELAYXWINMAPPING\n", __func__));
             }
+            if (xsd->options & OPTION_SHADOWFB)
+            {
+                D(bug("[X11] %s: option SHADOWFB\n", __func__));
+            }
         )
 
         xsd->delete_win_atom            = XCALL(XInternAtom, xsd->display, "WM_DELETE_WINDOW", FALSE);
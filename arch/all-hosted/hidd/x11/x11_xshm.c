@@ -1,5 +1,5 @@
 /*
-    Copyright (C) 1995-2017, The AROS Development Team. All rights reserved.
+    Copyright (C) 1995-2026, The AROS Development Team. All rights reserved.
 */
 
 /* I have to put his in its own file because of include file
@@ -101,7 +101,7 @@ ADD2EXPUNGELIB(xext_hostlib_expunge, 1)
 
 /****************************************************************************************/
 
-void *init_shared_mem(Display *display)
+void *init_shared_mem(Display *display, size_t size)
 {
     /* TODO: Also check if this is a local display */
     
@@ -146,7 +146,7 @@ void *init_shared_mem(Display *display)
             memset(shminfo, 0, sizeof (*shminfo));
                 
             /* Allocate shared memory */
-            shminfo->shmid = CCALL(shmget, key, XSHM_MEMSIZE, IPC_CREAT|0777);
+            shminfo->shmid = CCALL(shmget, key, size, IPC_CREAT|0777);
                         
             if (shminfo->shmid >= 0)
             {
@@ -218,6 +218,10 @@ XImage *create_xshm_ximage(Display *display, Visual *visual, int depth, int form
         
 /****************************************************************************************/
 
+/*
+ * The caller reuses the segment for the next chunk as soon as we return,
+ * so wait until the server has read it.
+ */
 void put_xshm_ximage(Display *display, Drawable d, GC gc, XImage *image,
                      int xsrc,  int ysrc, int xdest, int ydest,
                      int width, int height, Bool send_event)
@@ -229,6 +233,21 @@ void put_xshm_ximage(Display *display, Drawable d, GC gc, XImage *image,
 
 /****************************************************************************************/
 
+/*
+ * Same without waiting, for images that stay valid (the shadow framebuffer).
+ * If the image changes before the server reads it, the server just sees
+ * newer pixels, which are damaged and queued again anyway.
+ */
+void queue_xshm_ximage(Display *display, Drawable d, GC gc, XImage *image,
+                       int xsrc,  int ysrc, int xdest, int ydest,
+                       int width, int height)
+{
+    XEXTCALL(XShmPutImage, display, d, gc, image, xsrc, ysrc, xdest, ydest,
+                           width, height, False);
+}
+
+/****************************************************************************************/
+
 int get_xshm_ximage(Display *display, Drawable d, XImage *image, int x, int y)
 {
     XCALL(XSync, display, False);
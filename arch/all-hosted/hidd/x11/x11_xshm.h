@@ -1,5 +1,5 @@
 /*
-    Copyright (C) 1995-2017, The AROS Development Team. All rights reserved.
+    Copyright (C) 1995-2026, The AROS Development Team. All rights reserved.
 */
 
 #ifndef X11HIDD_XSHM_H
@@ -11,7 +11,7 @@
 
 #define XSHM_MEMSIZE 5000000	/* We allocate 5M for dumping images to X */
 
-void *init_shared_mem(Display *display);
+void *init_shared_mem(Display *display, size_t size);
 
 void cleanup_shared_mem(Display *display, void *meminfo);
 
@@ -22,6 +22,10 @@ void put_xshm_ximage(Display *display, Drawable d, GC gc, XImage *ximage,
     	    	     int xsrc, int ysrc, int xdest, int ydest,
 		     int width, int height, Bool send_event);
 
+void queue_xshm_ximage(Display *display, Drawable d, GC gc, XImage *ximage,
+    	    	       int xsrc, int ysrc, int xdest, int ydest,
+		       int width, int height);
+
 int get_xshm_ximage(Display *display, Drawable d, XImage *image, int x, int y);
 	
 void destroy_xshm_ximage(XImage *image);
@@ -1,5 +1,5 @@
 /*
-    Copyright (C) 1995-2017, The AROS Development Team. All rights reserved.
+    Copyright (C) 1995-2026, The AROS Development Team. All rights reserved.
 
     Desc: X11 bitmap class, internal definitions
 */
@@ -13,6 +13,8 @@
 #define DRAWABLE(data)      (data->drawable)
 #define WINDRAWABLE(data)   (data->windowdrawable)
 
+#define SHADOW_MAXDAMAGE    16      /* Damage rectangles kept apart before merging */
+
 /* This structure is used as instance data for the bitmap class. */
 struct bitmap_data
 {
@@ -29,11 +31,18 @@ struct bitmap_data
     IPTR            height;
     OOP_Object      *gfxhidd;       /* Cached owner, for ModeID switch    */
     Drawable        windowdrawable; /* Explicit pointer to window drawable for BMDF_FRAMEBUFFER */
+    /* Only for BMDF_SHADOWFB */
+    struct _XImage  *shadow;        /* XShm image the chunky superclass renders into */
+    void            *shadowinfo;    /* Its shared memory segment */
+    struct SignalSemaphore damagelock;
+    UWORD           numdamage;
+    struct Rectangle damage[SHADOW_MAXDAMAGE]; /* Not yet shown, flushed by the X11 task */
 };
 
 #define BMDF_COLORMAP_ALLOCED   1
 #define BMDF_FRAMEBUFFER        2
 #define BMDF_BACKINGSTORE       4
+#define BMDF_SHADOWFB           8   /* Instance of the shadow framebuffer class */
 
 BOOL X11BM_InitFB(OOP_Class *cl, OOP_Object *o, struct TagItem *attrList);
 BOOL X11BM_NotifyFB(OOP_Class *cl, OOP_Object *o);
@@ -46,3 +55,5 @@ VOID X11BM_ExposeFB(struct bitmap_data *data, WORD x, WORD y, WORD width, WORD h
 BOOL X11BM_InitPM(OOP_Class *cl, OOP_Object *o, struct TagItem *attrList);
 VOID X11BM_DisposePM(struct bitmap_data *data);
 VOID X11BM_ClearPM(struct bitmap_data *data, HIDDT_Pixel bg);
+
+VOID X11BM_FlushShadow(struct bitmap_data *data);
@@ -1,5 +1,5 @@
 /*
-    Copyright (C) 1995-2022, The AROS Development Team. All rights reserved.
+    Copyright (C) 1995-2026, The AROS Development Team. All rights reserved.
 
     Desc: X11 gfx HIDD for AROS.
 */
@@ -584,6 +584,7 @@ OOP_Object *X11Cl__Hidd_Gfx__CreateObject(OOP_Class *cl, OOP_Object *o, struct p
         struct pHidd_Gfx_CreateObject  p;
         HIDDT_ModeID                modeid;
         struct gfx_data             *data;
+        BOOL                        shadow = FALSE;
         struct TagItem              tags[] =
         {
             { aHidd_BitMap_X11_SysDisplay   , 0 }, /* 0 */
@@ -607,7 +608,29 @@ OOP_Object *X11Cl__Hidd_Gfx__CreateObject(OOP_Class *cl, OOP_Object *o, struct p
         /* Displayable bitmap ? */
         modeid = GetTagData(aHidd_BitMap_ModeID, vHidd_ModeID_Invalid, msg->attrList);
 
-        if (modeid != vHidd_ModeID_Invalid)
+        if (XSD(cl)->options & OPTION_SHADOWFB)
+        {
+            OOP_Object *friend = (OOP_Object *)GetTagData(aHidd_BitMap_Friend, 0, msg->attrList);
+
+            if (modeid != vHidd_ModeID_Invalid && GetTagData(aHidd_BitMap_FrameBuffer, FALSE, msg->attrList))
+            {
+                tags[5].ti_Tag  = aHidd_BitMap_ClassPtr;
+                tags[5].ti_Data = (IPTR)XSD(cl)->shadowbmclass;
+                shadow = TRUE;
+            }
+            else if (modeid != vHidd_ModeID_Invalid ||
+                     (friend && OOP_OCLASS(friend) == XSD(cl)->shadowbmclass))
+            {
+                /*
+                 * Screens are only copied into the shadow framebuffer when
+                 * shown, and their friends must not create X windows, so
+                 * all of them are plain memory
+                 */
+                tags[5].ti_Tag  = aHidd_BitMap_ClassID;
+                tags[5].ti_Data = (IPTR)CLID_Hidd_ChunkyBM;
+            }
+        }
+        else if (modeid != vHidd_ModeID_Invalid)
         {
             /* ModeID supplied, it's for sure X11 bitmap */
             tags[5].ti_Tag    = aHidd_BitMap_ClassPtr;
@@ -619,6 +642,17 @@ OOP_Object *X11Cl__Hidd_Gfx__CreateObject(OOP_Class *cl, OOP_Object *o, struct p
         p.attrList = tags;
 
         object = (OOP_Object *)OOP_DoSuperMethod(cl, o, (OOP_Msg)&p);
+
+        if (!object && shadow)
+        {
+            /* The framebuffer comes first, so nothing depends on the option yet */
+            D(bug("[X11:Gfx] %s: no shadow framebuffer, using X drawing\n", __func__));
+
+            XSD(cl)->options &= ~OPTION_SHADOWFB;
+            tags[5].ti_Data = (IPTR)XSD(cl)->bmclass;
+
+            object = (OOP_Object *)OOP_DoSuperMethod(cl, o, (OOP_Msg)&p);
+        }
     }
     else
         object = (OOP_Object *)OOP_DoSuperMethod(cl, o, (OOP_Msg)msg);
@@ -1027,7 +1061,7 @@ static BOOL initx11stuff(struct x11_staticdata *xsd)
             /* Display is local, not remote. XSHM is possible */
 
             /* Do we have Xshm support ? */
-            xsd->xshm_info = init_shared_mem(xsd->display);
+            xsd->xshm_info = init_shared_mem(xsd->display, XSHM_MEMSIZE);
 
             if (NULL == xsd->xshm_info)
             {
@@ -1045,6 +1079,12 @@ static BOOL initx11stuff(struct x11_staticdata *xsd)
             }
         }
     }
+
+    /* The shadow framebuffer needs XShm and a visual our pixel formats describe */
+    if (!xsd->use_xshm || !xsd->vi || xsd->vi->class != TrueColor)
+        xsd->options &= ~OPTION_SHADOWFB;
+#else
+    xsd->options &= ~OPTION_SHADOWFB;
 #endif
 
     UNLOCK_X11
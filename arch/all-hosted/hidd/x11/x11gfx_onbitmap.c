@@ -1,5 +1,5 @@
 /*
-    Copyright (C) 1995-2017, The AROS Development Team. All rights reserved.
+    Copyright (C) 1995-2026, The AROS Development Team. All rights reserved.
 
     Desc: Bitmap class for X11 hidd.
 */
@@ -13,6 +13,7 @@
 #include "x11.h"
 #include "x11_hostlib.h"
 #include "x11gfx_bitmap.h"
+#include "x11_xshm.h"
 
 /****************************************************************************************/
 
@@ -209,7 +210,12 @@ BOOL X11BM_InitFB(OOP_Class *cl, OOP_Object *o, struct TagItem *attrList)
             XCALL(XSetWMHints, GetSysDisplay(), MASTERWIN(data), &hints);
         }
 
-        if (XSD(cl)->options & OPTION_BACKINGSTORE)
+        if (data->flags & BMDF_SHADOWFB)
+        {
+            /* The shadow image is the only backing store needed */
+            DRAWABLE(data) = WINDRAWABLE(data);
+        }
+        else if (XSD(cl)->options & OPTION_BACKINGSTORE)
         {
             DRAWABLE(data) = WINDRAWABLE(data);
             data->flags |= BMDF_BACKINGSTORE;
@@ -357,7 +363,7 @@ VOID X11BM_DisposeFB(struct bitmap_data *data, struct x11_staticdata *xsd)
     if (data->flags & BMDF_COLORMAP_ALLOCED)
         XCALL(XFreeColormap, GetSysDisplay(), data->colmap);
 
-    if (!(data->flags & BMDF_BACKINGSTORE))
+    if (!(data->flags & (BMDF_BACKINGSTORE | BMDF_SHADOWFB)))
         XCALL(XFreePixmap, GetSysDisplay(), DRAWABLE(data));
 
     XCALL(XFlush, GetSysDisplay());
@@ -448,6 +454,15 @@ VOID X11BM_ExposeFB(struct bitmap_data *data, WORD x, WORD y, WORD width, WORD h
     D(bug("[X11OnBm] %s(%d, %d, %d, %d)\n", __PRETTY_FUNCTION__,
         x, y, width, height));
 
+#if USE_XSHM
+    if (data->flags & BMDF_SHADOWFB)
+    {
+        /* Repaint straight from the shadow, the GC is always GXcopy */
+        queue_xshm_ximage(data->display, WINDRAWABLE(data), data->gc, data->shadow,
+                x, y, x, y, width, height);
+    }
+    else
+#endif
     if (!(data->flags & BMDF_BACKINGSTORE))
     {
         XCALL(XSetFunction, data->display, data->gc, GXcopy);
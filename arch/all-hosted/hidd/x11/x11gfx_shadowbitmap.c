@@ -0,0 +1,330 @@
+/*
+    Copyright (C) 2026, The AROS Development Team. All rights reserved.
+
+    Desc: Shadow framebuffer class for X11 hidd.
+*/
+
+/*
+ * With --shadowfb the framebuffer is a chunky bitmap whose pixel buffer is
+ * an XShm image. All rendering is plain memory access in the superclass,
+ * UpdateRect only records the damaged area, and the X11 task pushes the
+ * merged damage to the window once per VBlank with XShmPutImage, without
+ * waiting for the server. The on-screen bitmap class would instead make an
+ * X request, and often a round trip, for every single operation.
+ */
+
+#include "x11_debug.h"
+
+#include <hidd/gfx.h>
+#include <proto/utility.h>
+
+#include "x11_types.h"
+#include "x11.h"
+#include "x11_hostlib.h"
+#include "x11gfx_bitmap.h"
+#include "x11_xshm.h"
+
+/****************************************************************************************/
+
+#define MIN(a, b) (((a) < (b)) ? (a) : (b))
+#define MAX(a, b) (((a) > (b)) ? (a) : (b))
+
+/****************************************************************************************/
+
+static inline LONG area(WORD minx, WORD miny, WORD maxx, WORD maxy)
+{
+    return (LONG)(maxx - minx + 1) * (maxy - miny + 1);
+}
+
+/*
+ * Add a rectangle to the damage list. Rectangles are merged when their
+ * bounding box is not larger than both of them together (overlapping or
+ * adjacent areas). When the list is full, the pair whose bounding box
+ * grows least is merged instead.
+ */
+static VOID add_damage(struct bitmap_data *data, WORD minx, WORD miny, WORD maxx, WORD maxy)
+{
+    ObtainSemaphore(&data->damagelock);
+
+    for (;;)
+    {
+        struct Rectangle *r;
+        LONG growth, bestgrowth = 0;
+        WORD best = -1;
+        UWORD i;
+
+        for (i = 0; i < data->numdamage; i++)
+        {
+            r = &data->damage[i];
+            growth = area(MIN(r->MinX, minx), MIN(r->MinY, miny), MAX(r->MaxX, maxx), MAX(r->MaxY, maxy))
+                    - area(r->MinX, r->MinY, r->MaxX, r->MaxY) - area(minx, miny, maxx, maxy);
+
+            if ((growth <= 0 || data->numdamage == SHADOW_MAXDAMAGE) &&
+                (best == -1 || growth < bestgrowth))
+            {
+                best = i;
+                bestgrowth = growth;
+            }
+        }
+
+        if (best == -1)
+        {
+            r = &data->damage[data->numdamage++];
+            r->MinX = minx;
+            r->MinY = miny;
+            r->MaxX = maxx;
+            r->MaxY = maxy;
+            break;
+        }
+
+        /* Take the rectangle out and try to merge the union again */
+        r = &data->damage[best];
+        minx = MIN(r->MinX, minx);
+        miny = MIN(r->MinY, miny);
+        maxx = MAX(r->MaxX, maxx);
+        maxy = MAX(r->MaxY, maxy);
+        *r = data->damage[--data->numdamage];
+    }
+
+    ReleaseSemaphore(&data->damagelock);
+}
+
+/****************************************************************************************/
+
+/* Called by the X11 task on every VBlank */
+VOID X11BM_FlushShadow(struct bitmap_data *data)
+{
+    struct Rectangle damage[SHADOW_MAXDAMAGE];
+    UWORD count;
+#if USE_XSHM
+    UWORD i;
+#endif
+
+    if (!(data->flags & BMDF_SHADOWFB) || !data->numdamage)
+        return;
+
+    ObtainSemaphore(&data->damagelock);
+    count = data->numdamage;
+    CopyMem(data->damage, damage, count * sizeof(struct Rectangle));
+    data->numdamage = 0;
+    ReleaseSemaphore(&data->damagelock);
+
+    DB2(bug("[X11ShadowBm] %s: %u rectangles\n", __PRETTY_FUNCTION__, count));
+
+#if USE_XSHM
+    LOCK_X11
+
+    for (i = 0; i < count; i++)
+    {
+        struct Rectangle *r = &damage[i];
+
+        /* The window may be smaller than the bitmap after a mode change */
+        if (r->MinX >= (WORD)data->width || r->MinY >= (WORD)data->height)
+            continue;
+        if (r->MaxX >= (WORD)data->width)
+            r->MaxX = data->width - 1;
+        if (r->MaxY >= (WORD)data->height)
+            r->MaxY = data->height - 1;
+
+        queue_xshm_ximage(data->display, WINDRAWABLE(data), data->gc, data->shadow,
+                r->MinX, r->MinY, r->MinX, r->MinY,
+                r->MaxX - r->MinX + 1, r->MaxY - r->MinY + 1);
+    }
+
+    XCALL(XFlush, data->display);
+
+    UNLOCK_X11
+#endif
+}
+
+/****************************************************************************************/
+
+static BOOL init_shadow(OOP_Class *cl, OOP_Object *o)
+{
+#if USE_XSHM
+    struct bitmap_data *data = OOP_INST_DATA(cl, o);
+    IPTR width, height, bytesperrow, bytesperpixel;
+    OOP_Object *pf;
+    XImage *image = NULL;
+    struct TagItem attrs[] =
+    {
+        { aHidd_ChunkyBM_Buffer , 0 },
+        { TAG_DONE              , 0 }
+    };
+
+    OOP_GetAttr(o, aHidd_BitMap_Width, &width);
+    OOP_GetAttr(o, aHidd_BitMap_Height, &height);
+    OOP_GetAttr(o, aHidd_BitMap_BytesPerRow, &bytesperrow);
+    OOP_GetAttr(o, aHidd_BitMap_PixFmt, (IPTR *)&pf);
+    OOP_GetAttr(pf, aHidd_PixFmt_BytesPerPixel, &bytesperpixel);
+
+    LOCK_X11
+
+    data->shadowinfo = init_shared_mem(data->display, bytesperrow * height);
+    if (data->shadowinfo)
+    {
+        image = create_xshm_ximage(data->display, DefaultVisual(data->display, data->screen),
+                DefaultDepth(data->display, data->screen), ZPixmap, width, height, data->shadowinfo);
+    }
+
+    UNLOCK_X11
+
+    if (!image)
+        return FALSE;
+
+    data->shadow = image;
+
+    /*
+     * Our pixel format is the one of the X visual, so only the row length
+     * can differ. XShmPutImage() takes it from bytes_per_line.
+     */
+    D(bug("[X11ShadowBm] %s: %ldx%ld, %ld bytes per row, X image %d bpp, %d bytes per line\n", __PRETTY_FUNCTION__,
+        width, height, bytesperrow, image->bits_per_pixel, image->bytes_per_line));
+
+    if (image->bits_per_pixel != bytesperpixel * 8 || (bytesperrow % bytesperpixel) != 0)
+        return FALSE;
+
+    image->bytes_per_line = bytesperrow;
+
+    attrs[0].ti_Data = (IPTR)image->data;
+    OOP_SetAttrs(o, attrs);
+
+    return TRUE;
+#else
+    /* x11gfx_hiddclass.c never picks us without XShm */
+    return FALSE;
+#endif
+}
+
+/****************************************************************************************/
+
+OOP_Object *X11ShadowBM__Root__New(OOP_Class *cl, OOP_Object *o, struct pRoot_New *msg)
+{
+    /* Create the chunky bitmap without a buffer, init_shadow() attaches one */
+    struct TagItem tags[] =
+    {
+        { aHidd_ChunkyBM_Buffer , 0                     },
+        { TAG_MORE              , (IPTR)msg->attrList   }
+    };
+    struct pRoot_New p;
+
+    D(bug("[X11ShadowBm] %s()\n", __PRETTY_FUNCTION__));
+
+    p.mID = msg->mID;
+    p.attrList = tags;
+
+    o = (OOP_Object *) OOP_DoSuperMethod(cl, o, &p.mID);
+    if (o)
+    {
+        struct bitmap_data *data = OOP_INST_DATA(cl, o);
+        BOOL ok;
+
+        data->display = (Display *) GetTagData(aHidd_BitMap_X11_SysDisplay, 0, msg->attrList);
+        data->screen = GetTagData(aHidd_BitMap_X11_SysScreen, 0, msg->attrList);
+        data->cursor = (Cursor) GetTagData(aHidd_BitMap_X11_SysCursor, 0, msg->attrList);
+        data->colmap = (Colormap) GetTagData(aHidd_BitMap_X11_ColorMap, 0, msg->attrList);
+        data->flags = BMDF_FRAMEBUFFER | BMDF_SHADOWFB;
+        InitSemaphore(&data->damagelock);
+
+        ok = X11BM_InitFB(cl, o, msg->attrList);
+
+        if (ok)
+        {
+            /* Only used to put the shadow, so it never changes */
+            XGCValues gcval;
+
+            gcval.plane_mask = AllPlanes;
+            gcval.graphics_exposures = False;
+            gcval.function = GXcopy;
+
+            HostLib_Lock();
+            data->gc = XCALL(XCreateGC, data->display, WINDRAWABLE(data),
+                    GCPlaneMask | GCGraphicsExposures | GCFunction, &gcval);
+            HostLib_Unlock();
+
+            if (!data->gc)
+                ok = FALSE;
+        }
+
+        if (ok)
+            ok = init_shadow(cl, o);
+
+        if (ok)
+            ok = X11BM_NotifyFB(cl, o);
+
+        if (!ok)
+        {
+            OOP_MethodID disp_mid = OOP_GetMethodID(IID_Root, moRoot_Dispose);
+
+            OOP_CoerceMethod(cl, o, (OOP_Msg) &disp_mid);
+            o = NULL;
+        }
+    }
+
+    D(bug("[X11ShadowBm] %s: returning object @ 0x%p\n", __PRETTY_FUNCTION__, o));
+    return o;
+}
+
+/****************************************************************************************/
+
+VOID X11ShadowBM__Root__Dispose(OOP_Class *cl, OOP_Object *o, OOP_Msg msg)
+{
+    struct bitmap_data *data = OOP_INST_DATA(cl, o);
+
+    D(bug("[X11ShadowBm] %s()\n", __PRETTY_FUNCTION__));
+
+    /* Removes us from the X11 task's list, so no more flushes after this */
+    X11BM_DisposeFB(data, XSD(cl));
+
+    HostLib_Lock();
+
+    if (data->gc)
+        XCALL(XFreeGC, data->display, data->gc);
+
+#if USE_XSHM
+    if (data->shadow)
+        destroy_xshm_ximage(data->shadow);
+
+    if (data->shadowinfo)
+        cleanup_shared_mem(data->display, data->shadowinfo);
+#endif
+
+    HostLib_Unlock();
+
+    OOP_DoSuperMethod(cl, o, msg);
+}
+
+/****************************************************************************************/
+
+BOOL X11ShadowBM__Root__Set(OOP_Class *cl, OOP_Object *o, struct pRoot_Set *msg)
+{
+    D(bug("[X11ShadowBm] %s()\n", __PRETTY_FUNCTION__));
+
+#if ADJUST_XWIN_SIZE
+    /* Same as X11BM__Root__Set() */
+    struct bitmap_data *data = OOP_INST_DATA(cl, o);
+    struct TagItem *tag = FindTagItem(aHidd_BitMap_ModeID, msg->attrList);
+
+    if (tag)
+    {
+        if (!X11BM_SetMode(data, tag->ti_Data, XSD(cl)))
+            return FALSE;
+
+        add_damage(data, 0, 0, data->width - 1, data->height - 1);
+    }
+#endif
+    return OOP_DoSuperMethod(cl, o, &msg->mID);
+}
+
+/****************************************************************************************/
+
+VOID X11ShadowBM__Hidd_BitMap__UpdateRect(OOP_Class *cl, OOP_Object *o, struct pHidd_BitMap_UpdateRect *msg)
+{
+    struct bitmap_data *data = OOP_INST_DATA(cl, o);
+
+    DB2(bug("[X11ShadowBm] %s(%d, %d, %d, %d)\n", __PRETTY_FUNCTION__,
+        msg->x, msg->y, msg->width, msg->height));
+
+    if (msg->width > 0 && msg->height > 0)
+        add_damage(data, msg->x, msg->y, msg->x + msg->width - 1, msg->y + msg->height - 1);
+}
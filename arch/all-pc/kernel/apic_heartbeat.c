@@ -15,6 +15,7 @@
 #include "exec_intern.h"
 
 #include "kernel_intern.h"
+#include "kernel_sample.h"
 
 #include "intservers.h"
 #include "cpu_freq.h"
@@ -54,6 +55,14 @@ int APICHeartbeatServer(struct ExceptionContext *regs, struct KernelBase *Kernel
         // Relaunch LAPIC timer
         APIC_REG(__LAPICBase, APIC_TIMER_ICR) = icrval;
 
+        // Take a profiling sample, if somebody is sampling
+        krnSample(KernelBase, cpuNum, INTR_FROMUSERMODE ? GET_THIS_TASK : NULL,
+#if (__WORDSIZE==64)
+                  (APTR)regs->rip, (APTR)regs->rbp);
+#else
+                  (APTR)regs->eip, (APTR)regs->ebp);
+#endif
+
 #if defined(__AROSEXEC_SMP__)
         if ((now - apicData->cores[cpuNum].cpu_LastCPULoadTime) > apicData->cores[cpuNum].cpu_TSCFreq)
         {
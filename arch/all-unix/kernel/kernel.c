@@ -1,5 +1,5 @@
 /*
-    Copyright (C) 1995-2017, The AROS Development Team. All rights reserved.
+    Copyright (C) 1995-2026, The AROS Development Team. All rights reserved.
 
     Desc: Initialize the interface to the "hardware".
 */
@@ -24,6 +24,7 @@
 #include "kernel_intr.h"
 #include "kernel_intern.h"
 #include "kernel_interrupts.h"
+#include "kernel_sample.h"
 #include "kernel_scheduler.h"
 #include "kernel_unix.h"
 
@@ -38,6 +39,20 @@
 #define D(x)
 #define DSC(x)
 
+/* The timer signal, as installed by core_Start() */
+#if DEBUG
+#define SIG_TIMER SIGVTALRM
+#else
+#define SIG_TIMER SIGALRM
+#endif
+
+/* Frame pointer of the interrupted code, if the CPU has one */
+#ifdef FP
+#define SAMPLE_FP(sc) ((APTR)FP(sc))
+#else
+#define SAMPLE_FP(sc) NULL
+#endif
+
 #ifdef SIGCORE_NEED_SA_SIGINFO
 #define SETHANDLER(sa, h)                       \
     sa.sa_sigaction = h ## _gate;       \
@@ -121,6 +136,13 @@ static void core_IRQ(int sig, regs_t *sc)
     if (sig < IRQ_COUNT)
         krnRunIRQHandlers(KernelBase, sig);
 
+    if (sig == SIG_TIMER)
+    {
+        krnSample(KernelBase, 0,
+                  (UKB(KernelBase)->SupervisorCount == 1) ? GET_THIS_TASK : NULL,
+                  (APTR)PC(sc), SAMPLE_FP(sc));
+    }
+
     if (UKB(KernelBase)->SupervisorCount == 1)
         core_ExitInterrupt(sc);
 
@@ -1,5 +1,5 @@
 /*
-    Copyright (C) 2025, The AROS Development Team. All rights reserved.
+    Copyright (C) 2025-2026, The AROS Development Team. All rights reserved.
 
     Desc:
 */
@@ -9,6 +9,7 @@
 #include <aros/libcall.h>
 
 #include <kernel_base.h>
+#include <kernel_sample.h>
 
 #include <proto/kernel.h>
 
@@ -20,12 +21,25 @@ AROS_LH3(ULONG, KrnBacktraceFromFrame,
 {
     AROS_LIBFUNC_INIT
 
+    return krnBacktrace(frame_in, (APTR)~(IPTR)0, out_pcs, max_depth);
+
+    AROS_LIBFUNC_EXIT
+}
+
+ULONG krnBacktrace(APTR frame, APTR limit, APTR *out_pcs, ULONG max_depth)
+{
     ULONG n = 0;
-    IPTR *rbp = (IPTR *)frame_in;
+    IPTR *rbp = (IPTR *)frame;
 
     while (rbp && n < max_depth) {
-        IPTR saved_rbp = rbp[0];
-        IPTR ret       = rbp[1];
+        IPTR saved_rbp, ret;
+
+        /* Both the saved frame pointer and the return address must be below limit */
+        if ((IPTR)&rbp[2] > (IPTR)limit)
+            break;
+
+        saved_rbp = rbp[0];
+        ret       = rbp[1];
 
         if (!ret)
             break;
@@ -40,6 +54,4 @@ AROS_LH3(ULONG, KrnBacktraceFromFrame,
     }
 
     return n;
-
-    AROS_LIBFUNC_EXIT
 }
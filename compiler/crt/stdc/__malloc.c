@@ -0,0 +1,316 @@
+/*
+    Copyright (C) 2026, The AROS Development Team. All rights reserved.
+
+    Size class allocator with per task caches behind malloc() and free().
+*/
+
+#include <exec/memory.h>
+#include <proto/exec.h>
+#include <proto/task.h>
+#include <resources/task.h>
+#include <aros/debug.h>
+
+#include "__malloc.h"
+#include "debug.h"
+
+const UWORD __malloc_classsize[MALLOC_CLASSES] =
+{
+    16, 32, 48, 64, 96, 128, 192, 256, 384, 512, 768, 1024, 1536, 2048
+};
+
+/*
+ * Carve a new chunk for class cls into blocks and put them on the shared
+ * list. Called with ms_Lock held.
+ */
+static BOOL newChunk(struct StdCIntBase *StdCBase, struct MallocState *ms, ULONG cls)
+{
+    ULONG stride = MALLOC_HDRSIZE + __malloc_classsize[cls];
+    ULONG count = MALLOC_CHUNKSIZE / stride, i;
+    UBYTE *chunk;
+
+    if (count < 4)
+        count = 4;
+
+    chunk = AllocPooled(StdCBase->mempool, count * stride);
+    if (chunk == NULL)
+        return FALSE;
+
+    D(bug("[%s] %s: class %u, %u blocks at 0x%p\n", STDCNAME, __func__,
+          cls, count, chunk
+    ));
+
+    __sync_add_and_fetch(&ms->ms_Arena, count * stride);
+
+    for (i = 0; i < count; i++, chunk += stride)
+    {
+        struct MallocBlock *mb = (struct MallocBlock *)(chunk + MALLOC_HDRSIZE);
+
+        *((size_t *)chunk) = __malloc_classsize[cls];
+        mb->mb_Next = ms->ms_Free[cls];
+        ms->ms_Free[cls] = mb;
+    }
+    ms->ms_Count[cls] += count;
+
+    return TRUE;
+}
+
+/*
+ * Hand the blocks of a dead task's cache back to the shared lists and
+ * free its slot. Called with ms_Lock held.
+ */
+static void flushCache(struct MallocState *ms, struct MallocCache *mc)
+{
+    ULONG cls;
+
+    D(bug("[%s] %s: task 0x%p (%u), cache 0x%p\n", STDCNAME, __func__,
+          mc->mc_Task, mc->mc_TaskID, mc
+    ));
+
+    for (cls = 0; cls < MALLOC_CLASSES; cls++)
+    {
+        struct MallocBlock *mb;
+
+        while ((mb = mc->mc_Free[cls]) != NULL)
+        {
+            mc->mc_Free[cls] = mb->mb_Next;
+            mb->mb_Next = ms->ms_Free[cls];
+            ms->ms_Free[cls] = mb;
+        }
+        ms->ms_Count[cls] += mc->mc_Count[cls];
+        mc->mc_Count[cls] = 0;
+    }
+
+    /* Whatever it still had allocated is now owned by nobody in particular */
+    ms->ms_InUse += mc->mc_InUse;
+    mc->mc_InUse = 0;
+
+    mc->mc_Task = NULL;
+    if (ms->ms_Last == mc)
+        ms->ms_Last = NULL;
+}
+
+/*
+ * Flush the caches of all tasks that have exited. Called with ms_Lock
+ * held.
+ */
+static void reclaimCaches(struct MallocState *ms)
+{
+    APTR TaskResBase = OpenResource("task.resource");
+    struct TaskList *tl;
+    struct Task *task;
+    BOOL alive[MALLOC_CACHETASKS];
+    ULONG i;
+
+    if (TaskResBase == NULL)
+        return;
+
+    for (i = 0; i < MALLOC_CACHETASKS; i++)
+        alive[i] = FALSE;
+
+    tl = LockTaskList(LTF_ALL);
+    if (tl == NULL)
+        return;
+    while ((task = NextTaskEntry(tl, LTF_ALL)) != NULL)
+    {
+        ULONG id = GetETaskID(task);
+
+        for (i = 0; i < MALLOC_CACHETASKS; i++)
+        {
+            struct MallocCache *mc = ms->ms_Caches[i];
+
+            if (mc && mc->mc_Task == task && mc->mc_TaskID == id)
+                alive[i] = TRUE;
+        }
+    }
+    UnLockTaskList(tl, LTF_ALL);
+
+    for (i = 0; i < MALLOC_CACHETASKS; i++)
+    {
+        struct MallocCache *mc = ms->ms_Caches[i];
+
+        if (mc && mc->mc_Task && !alive[i])
+            flushCache(ms, mc);
+    }
+}
+
+/*
+ * Find the cache of the calling task, or claim a free slot for it. Slots
+ * are filled under ms_Lock, so the lock free lookup only ever sees
+ * complete caches. Returns NULL if all slots belong to live tasks; such
+ * tasks use the shared lists directly, and only look for dead slots again
+ * every MALLOC_RESCAN calls.
+ */
+static struct MallocCache *getCache(struct StdCIntBase *StdCBase, struct MallocState *ms)
+{
+    struct Task *me = FindTask(NULL);
+    ULONG id = GetETaskID(me);
+    struct MallocCache *mc = ms->ms_Last;
+    ULONG slot, i;
+    BOOL full = TRUE;
+
+    if (mc && mc->mc_Task == me && mc->mc_TaskID == id)
+        return mc;
+
+    slot = MALLOC_SLOT(me);
+    for (i = 0; i < MALLOC_CACHETASKS; i++, slot = (slot + 1) % MALLOC_CACHETASKS)
+    {
+        mc = ms->ms_Caches[slot];
+        if (mc == NULL)
+        {
+            full = FALSE;
+            break;
+        }
+        if (mc->mc_Task == NULL)
+            full = FALSE;
+        else if (mc->mc_Task == me && mc->mc_TaskID == id)
+        {
+            ms->ms_Last = mc;
+            return mc;
+        }
+    }
+
+    if (full && (++ms->ms_Misses % MALLOC_RESCAN) != 1)
+        return NULL;
+
+    ObtainSemaphore(&ms->ms_Lock);
+
+    reclaimCaches(ms);
+
+    /* Take the first slot on our probe sequence that is unused or free again */
+    slot = MALLOC_SLOT(me);
+    for (mc = NULL, i = 0; i < MALLOC_CACHETASKS; i++, slot = (slot + 1) % MALLOC_CACHETASKS)
+    {
+        mc = ms->ms_Caches[slot];
+        if (mc && mc->mc_Task == NULL)
+        {
+            mc->mc_TaskID = id;
+            __sync_synchronize();
+            mc->mc_Task = me;
+            break;
+        }
+        if (mc == NULL)
+        {
+            mc = AllocPooled(StdCBase->mempool, sizeof(struct MallocCache));
+            if (mc)
+            {
+                ULONG cls;
+
+                mc->mc_Task = me;
+                mc->mc_TaskID = id;
+                for (cls = 0; cls < MALLOC_CLASSES; cls++)
+                {
+                    mc->mc_Free[cls] = NULL;
+                    mc->mc_Count[cls] = 0;
+                }
+                mc->mc_InUse = 0;
+                __sync_add_and_fetch(&ms->ms_Arena, sizeof(struct MallocCache));
+
+                __sync_synchronize();
+                ms->ms_Caches[slot] = mc;
+            }
+            break;
+        }
+        mc = NULL;
+    }
+
+    ReleaseSemaphore(&ms->ms_Lock);
+
+    D(bug("[%s] %s: task 0x%p, cache 0x%p\n", STDCNAME, __func__, me, mc));
+
+    if (mc)
+        ms->ms_Last = mc;
+
+    return mc;
+}
+
+void *__malloc_small(struct StdCIntBase *StdCBase, size_t size)
+{
+    struct MallocState *ms = StdCBase->mallocstate;
+    struct MallocCache *mc = getCache(StdCBase, ms);
+    ULONG cls = MALLOC_CLASS(ms, size);
+    struct MallocBlock *mb;
+
+    if (mc && (mb = mc->mc_Free[cls]))
+    {
+        mc->mc_Free[cls] = mb->mb_Next;
+        mc->mc_Count[cls]--;
+        mc->mc_InUse += __malloc_classsize[cls];
+
+        return mb;
+    }
+
+    ObtainSemaphore(&ms->ms_Lock);
+
+    if (ms->ms_Free[cls] == NULL && !newChunk(StdCBase, ms, cls))
+    {
+        ReleaseSemaphore(&ms->ms_Lock);
+        return NULL;
+    }
+
+    mb = ms->ms_Free[cls];
+    ms->ms_Free[cls] = mb->mb_Next;
+    ms->ms_Count[cls]--;
+
+    if (mc)
+    {
+        ULONG n;
+
+        /* Take a batch along, so the next allocations stay lock free */
+        for (n = 1; n < MALLOC_BATCH && ms->ms_Free[cls]; n++)
+        {
+            struct MallocBlock *next = ms->ms_Free[cls];
+
+            ms->ms_Free[cls] = next->mb_Next;
+            next->mb_Next = mc->mc_Free[cls];
+            mc->mc_Free[cls] = next;
+        }
+        ms->ms_Count[cls] -= n - 1;
+        mc->mc_Count[cls] += n - 1;
+        mc->mc_InUse += __malloc_classsize[cls];
+    }
+    else
+        ms->ms_InUse += __malloc_classsize[cls];
+
+    ReleaseSemaphore(&ms->ms_Lock);
+
+    return mb;
+}
+
+void __free_small(struct StdCIntBase *StdCBase, UBYTE *mem, size_t size)
+{
+    struct MallocState *ms = StdCBase->mallocstate;
+    struct MallocCache *mc = getCache(StdCBase, ms);
+    struct MallocBlock *mb = (struct MallocBlock *)mem;
+    ULONG cls = MALLOC_CLASS(ms, size);
+
+    if (mc)
+    {
+        mb->mb_Next = mc->mc_Free[cls];
+        mc->mc_Free[cls] = mb;
+        mc->mc_InUse -= size;
+
+        if (++mc->mc_Count[cls] <= MALLOC_CACHEMAX)
+            return;
+
+        /* Cache is full, hand a batch back to the shared lists */
+        ObtainSemaphore(&ms->ms_Lock);
+        for (; mc->mc_Count[cls] > MALLOC_CACHEMAX - MALLOC_BATCH; mc->mc_Count[cls]--)
+        {
+            mb = mc->mc_Free[cls];
+            mc->mc_Free[cls] = mb->mb_Next;
+            mb->mb_Next = ms->ms_Free[cls];
+            ms->ms_Free[cls] = mb;
+            ms->ms_Count[cls]++;
+        }
+        ReleaseSemaphore(&ms->ms_Lock);
+    }
+    else
+    {
+        ObtainSemaphore(&ms->ms_Lock);
+        mb->mb_Next = ms->ms_Free[cls];
+        ms->ms_Free[cls] = mb;
+        ms->ms_Count[cls]++;
+        ms->ms_InUse -= size;
+        ReleaseSemaphore(&ms->ms_Lock);
+    }
+}
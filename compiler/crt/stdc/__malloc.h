@@ -0,0 +1,88 @@
+#ifndef ___MALLOC_H
+#define ___MALLOC_H
+
+/*
+    Copyright (C) 2026, The AROS Development Team. All rights reserved.
+
+    Internal state of the malloc() family.
+*/
+
+#include <exec/types.h>
+#include <exec/tasks.h>
+#include <exec/semaphores.h>
+#include <aros/cpu.h>
+
+#include "__stdc_intbase.h"
+
+/*
+ * Every block starts with a size_t holding its usable size, so the user
+ * pointer is MALLOC_HDRSIZE bytes into it. Requests up to MALLOC_SMALLMAX
+ * are rounded up to one of MALLOC_CLASSES size classes and recycled through
+ * free lists; larger ones come straight from the pool.
+ *
+ * Each task using the library gets a private cache holding up to
+ * MALLOC_CACHEMAX free blocks per class, so most small allocations never
+ * touch a lock. An empty cache is refilled with MALLOC_BATCH blocks from
+ * the shared lists (carving a new chunk from the pool if those are empty
+ * too), and a full one hands MALLOC_BATCH blocks back. Small blocks stay
+ * with the library base until it is closed and the pool deleted.
+ *
+ * Tasks don't tell the library when they exit, so caches are reclaimed
+ * lazily: whenever a task needs a slot, the caches of tasks no longer in
+ * the task list are flushed back to the shared lists and their slots
+ * handed out again. Tasks are told apart by address and ETask ID, as a
+ * new task may well be allocated where an old one was.
+ */
+
+#define MALLOC_HDRSIZE          AROS_ALIGN(sizeof(size_t))
+#define MALLOC_SMALLMAX         2048
+#define MALLOC_CLASSES          14
+#define MALLOC_CACHETASKS       32
+#define MALLOC_CACHEMAX         32
+#define MALLOC_BATCH            16
+#define MALLOC_CHUNKSIZE        8192
+#define MALLOC_RESCAN           256     /* Cacheless calls between reclaims */
+
+#define MALLOC_SLOT(task)       ((((IPTR)(task)) >> 4) % MALLOC_CACHETASKS)
+
+struct MallocBlock
+{
+    struct MallocBlock          *mb_Next;       /* Overlays the user data */
+};
+
+struct MallocCache
+{
+    struct Task * volatile      mc_Task;        /* NULL once reclaimed */
+    ULONG                       mc_TaskID;
+    struct MallocBlock          *mc_Free[MALLOC_CLASSES];
+    ULONG                       mc_Count[MALLOC_CLASSES];
+    /* Only written by mc_Task, may go negative when it frees blocks
+       another task allocated */
+    SIPTR                       mc_InUse;
+};
+
+struct MallocState
+{
+    struct SignalSemaphore      ms_Lock;        /* Guards the lists and ms_InUse */
+    struct MallocBlock          *ms_Free[MALLOC_CLASSES];
+    ULONG                       ms_Count[MALLOC_CLASSES];
+    /* Claimed and reclaimed under ms_Lock, freed with the pool */
+    struct MallocCache * volatile ms_Caches[MALLOC_CACHETASKS];
+    struct MallocCache          *ms_Last;       /* Lookup hint */
+    ULONG                       ms_Misses;      /* Lookups that found no slot */
+    SIPTR                       ms_InUse;       /* Small blocks of cacheless tasks */
+    /* Updated atomically */
+    volatile IPTR               ms_Arena;       /* Bytes taken from the pool */
+    volatile IPTR               ms_LargeBlocks;
+    volatile IPTR               ms_LargeBytes;
+    UBYTE                       ms_ClassIndex[MALLOC_SMALLMAX / 16 + 1];
+};
+
+extern const UWORD __malloc_classsize[MALLOC_CLASSES];
+
+#define MALLOC_CLASS(ms, size)  ((ms)->ms_ClassIndex[((size) + 15) >> 4])
+
+void *__malloc_small(struct StdCIntBase *StdCBase, size_t size);
+void __free_small(struct StdCIntBase *StdCBase, UBYTE *mem, size_t size);
+
+#endif /* ___MALLOC_H */
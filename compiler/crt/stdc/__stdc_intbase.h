@@ -1,5 +1,5 @@
 /*
-    Copyright (C) 2012-2025, The AROS Development Team. All rights reserved.
+    Copyright (C) 2012-2026, The AROS Development Team. All rights reserved.
 
     This file defines the private part of StdCBase.
     This should only be used internally in stdc.library code so
@@ -24,6 +24,7 @@
 
 /* Some structs that are defined privately */
 struct signal_func_data;
+struct MallocState;
 
 struct StdCIntBase
 {
@@ -42,6 +43,7 @@ struct StdCIntBase
 
     /* stdlib.h */
     APTR                        mempool;
+    struct MallocState          *mallocstate;       // __malloc.h
     unsigned int                srand_seed;
 
     /* time.h and it's functions */
@@ -1,11 +1,12 @@
 /*
-    Copyright (C) 1995-2024, The AROS Development Team. All rights reserved.
+    Copyright (C) 1995-2026, The AROS Development Team. All rights reserved.
 
     C99 function free().
 */
 
 #include "__stdc_intbase.h"
 #include "__memalign.h"
+#include "__malloc.h"
 
 #include <exec/memory.h>
 #include <proto/exec.h>
@@ -51,16 +52,24 @@
         unsigned char *mem;
         size_t         size;
 
-        mem = ((UBYTE *)memory) - AROS_ALIGN(sizeof(size_t));
+        mem = ((UBYTE *)memory) - MALLOC_HDRSIZE;
 
         size = *((size_t *) mem);
         if (size == MEMALIGN_MAGIC) {
             mem -= AROS_ALIGN(sizeof(void *));
             free(((void **) mem)[0]);
         }
+        else if (size <= MALLOC_SMALLMAX) {
+            __free_small(StdCBase, memory, size);
+        }
         else {
-            size += AROS_ALIGN(sizeof(size_t));
-            FreePooled (StdCBase->mempool, mem, size);
+            struct MallocState *ms = StdCBase->mallocstate;
+
+            __sync_sub_and_fetch(&ms->ms_Arena, size + MALLOC_HDRSIZE);
+            __sync_sub_and_fetch(&ms->ms_LargeBlocks, 1);
+            __sync_sub_and_fetch(&ms->ms_LargeBytes, size);
+
+            FreePooled (StdCBase->mempool, mem, size + MALLOC_HDRSIZE);
         }
     }
 
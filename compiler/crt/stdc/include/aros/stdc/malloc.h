@@ -0,0 +1,39 @@
+#ifndef _STDC_MALLOC_H_
+#define _STDC_MALLOC_H_
+
+/*
+    Copyright (C) 2026, The AROS Development Team. All rights reserved.
+
+    Desc: Non-standard header file <malloc.h>
+          Memory allocation functions and statistics
+*/
+#include <aros/system.h>
+
+#include <stdlib.h>
+
+/*
+ * Usage statistics of the malloc() family, as returned by mallinfo().
+ * Fields AROS does not track are always 0.
+ */
+struct mallinfo
+{
+    int arena;          /* Bytes obtained from the system */
+    int ordblks;        /* Free small blocks held in caches */
+    int smblks;         /* Unused */
+    int hblks;          /* Large blocks in use */
+    int hblkhd;         /* Bytes in large blocks */
+    int usmblks;        /* Unused */
+    int fsmblks;        /* Unused */
+    int uordblks;       /* Bytes in use */
+    int fordblks;       /* Bytes in free small blocks */
+    int keepcost;       /* Unused */
+};
+
+__BEGIN_DECLS
+
+/* AROS-specific extensions */
+struct mallinfo mallinfo(void);
+
+__END_DECLS
+
+#endif /* _STDC_MALLOC_H_ */
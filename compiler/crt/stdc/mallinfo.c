@@ -0,0 +1,108 @@
+/*
+    Copyright (C) 2026, The AROS Development Team. All rights reserved.
+
+    SVID/GNU function mallinfo().
+*/
+
+#include "__stdc_intbase.h"
+#include "__malloc.h"
+
+#include <proto/exec.h>
+#include <string.h>
+
+/*****************************************************************************
+
+    NAME */
+#include <malloc.h>
+
+        struct mallinfo mallinfo (
+
+/*  SYNOPSIS */
+        void)
+
+/*  FUNCTION
+        Return statistics about the memory allocated with malloc() and
+        friends by the calling program.
+
+    INPUTS
+        None.
+
+    RESULT
+        A struct mallinfo with these fields filled in:
+
+        arena    - Bytes obtained from the system, including bookkeeping.
+        ordblks  - Number of free small blocks kept for reuse.
+        hblks    - Number of large blocks in use.
+        hblkhd   - Bytes in large blocks in use.
+        uordblks - Bytes in use, small allocations counted at the size of
+                   their size class.
+        fordblks - Bytes in free small blocks kept for reuse.
+
+        All other fields are 0.
+
+    NOTES
+        The counters of other tasks sharing the library base are read
+        without stopping them, so the result is only a snapshot. Values
+        that do not fit into an int are clipped.
+
+    EXAMPLE
+
+    BUGS
+
+    SEE ALSO
+        malloc(), free()
+
+    INTERNALS
+
+******************************************************************************/
+{
+    struct StdCIntBase *StdCBase = (struct StdCIntBase *)__aros_getbase_StdCBase();
+    struct MallocState *ms = StdCBase->mallocstate;
+    struct mallinfo mi;
+    SIPTR inuse;
+    IPTR freeblks = 0, freebytes = 0;
+    ULONG cls, i;
+
+    memset(&mi, 0, sizeof(mi));
+
+    ObtainSemaphoreShared(&ms->ms_Lock);
+
+    inuse = ms->ms_InUse;
+    for (cls = 0; cls < MALLOC_CLASSES; cls++)
+    {
+        freeblks += ms->ms_Count[cls];
+        freebytes += ms->ms_Count[cls] * __malloc_classsize[cls];
+    }
+
+    for (i = 0; i < MALLOC_CACHETASKS; i++)
+    {
+        struct MallocCache *mc = ms->ms_Caches[i];
+
+        if (mc == NULL)
+            continue;
+
+        inuse += mc->mc_InUse;
+        for (cls = 0; cls < MALLOC_CLASSES; cls++)
+        {
+            freeblks += mc->mc_Count[cls];
+            freebytes += mc->mc_Count[cls] * __malloc_classsize[cls];
+        }
+    }
+
+    ReleaseSemaphore(&ms->ms_Lock);
+
+    inuse += ms->ms_LargeBytes;
+    if (inuse < 0)
+        inuse = 0;
+
+#define CLIP(x) ((x) > 0x7fffffff ? 0x7fffffff : (int)(x))
+    mi.arena    = CLIP(ms->ms_Arena);
+    mi.ordblks  = CLIP(freeblks);
+    mi.hblks    = CLIP(ms->ms_LargeBlocks);
+    mi.hblkhd   = CLIP(ms->ms_LargeBytes);
+    mi.uordblks = CLIP((IPTR)inuse);
+    mi.fordblks = CLIP(freebytes);
+#undef CLIP
+
+    return mi;
+} /* mallinfo */
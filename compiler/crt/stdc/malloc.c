@@ -1,10 +1,11 @@
 /*
-    Copyright (C) 1995-2020, The AROS Development Team. All rights reserved.
+    Copyright (C) 1995-2026, The AROS Development Team. All rights reserved.
 
     C99 function malloc().
 */
 
 #include "__stdc_intbase.h"
+#include "__malloc.h"
 
 #include <errno.h>
 #include <dos/dos.h>
@@ -44,21 +45,45 @@
     BUGS
 
     SEE ALSO
-        free()
+        free(), mallinfo()
 
     INTERNALS
+        Requests up to MALLOC_SMALLMAX bytes are rounded up to a size class
+        and served from a cache private to the calling task. Larger ones
+        are allocated from the pool directly.
 
 ******************************************************************************/
 {
     struct StdCIntBase *StdCBase = (struct StdCIntBase *)__aros_getbase_StdCBase();
+    struct MallocState *ms = StdCBase->mallocstate;
     UBYTE *mem = NULL;
 
+    if (size <= MALLOC_SMALLMAX)
+    {
+        mem = __malloc_small(StdCBase, size);
+        if (!mem)
+            errno = ENOMEM;
+
+        return mem;
+    }
+
+    /* Guard against the header wrapping the size around */
+    if (size > ~(size_t)0 - MALLOC_HDRSIZE)
+    {
+        errno = ENOMEM;
+        return NULL;
+    }
+
     /* Allocate the memory */
-    mem = AllocPooled (StdCBase->mempool, size + AROS_ALIGN(sizeof(size_t)));
+    mem = AllocPooled (StdCBase->mempool, size + MALLOC_HDRSIZE);
     if (mem)
     {
         *((size_t *)mem) = size;
-        mem += AROS_ALIGN(sizeof(size_t));
+        mem += MALLOC_HDRSIZE;
+
+        __sync_add_and_fetch(&ms->ms_Arena, size + MALLOC_HDRSIZE);
+        __sync_add_and_fetch(&ms->ms_LargeBlocks, 1);
+        __sync_add_and_fetch(&ms->ms_LargeBytes, size);
     }
     else
         errno = ENOMEM;
@@ -70,6 +95,8 @@
 
 int __init_memstuff(struct StdCIntBase *StdCBase)
 {
+    ULONG cls = 0, i;
+
     D(bug("[%s] %s: task(0x%p), StdCBase(0x%p)\n", STDCNAME, __func__,
           FindTask(NULL), StdCBase
     ));
@@ -83,6 +110,24 @@ int __init_memstuff(struct StdCIntBase *StdCBase)
         return 0;
     }
 
+    StdCBase->mallocstate = AllocMem(sizeof(struct MallocState), MEMF_ANY | MEMF_CLEAR);
+    if (!StdCBase->mallocstate)
+    {
+        DeletePool(StdCBase->mempool);
+        StdCBase->mempool = NULL;
+        return 0;
+    }
+
+    InitSemaphore(&StdCBase->mallocstate->ms_Lock);
+
+    /* Map sizes in 16 byte steps to the smallest class they fit */
+    for (i = 0; i <= MALLOC_SMALLMAX / 16; i++)
+    {
+        while (__malloc_classsize[cls] < i * 16)
+            cls++;
+        StdCBase->mallocstate->ms_ClassIndex[i] = cls;
+    }
+
     return 1;
 }
 
@@ -93,10 +138,15 @@ void __exit_memstuff(struct StdCIntBase *StdCBase)
           FindTask(NULL), StdCBase, StdCBase->mempool
     ));
 
+    /* Small blocks and task caches all live in the pool */
     if (StdCBase->mempool)
     {
         DeletePool(StdCBase->mempool);
     }
+    if (StdCBase->mallocstate)
+    {
+        FreeMem(StdCBase->mallocstate, sizeof(struct MallocState));
+    }
 }
 
 ADD2OPENLIB(__init_memstuff, 0);
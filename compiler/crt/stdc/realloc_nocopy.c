@@ -1,10 +1,12 @@
 /*
-    Copyright (C) 1995-2014, The AROS Development Team. All rights reserved.
+    Copyright (C) 1995-2026, The AROS Development Team. All rights reserved.
 */
 
 #include <aros/cpu.h>
 #include <proto/exec.h>
 
+#include "__malloc.h"
+
 /*****************************************************************************
 
     NAME */
@@ -56,7 +58,9 @@
     if (!oldmem)
         return malloc (size);
 
-    mem = (UBYTE *)oldmem - AROS_ALIGN(sizeof(size_t));
+    /* This is the usable size of the block, small requests are rounded
+       up to their size class and can grow up to it in place */
+    mem = (UBYTE *)oldmem - MALLOC_HDRSIZE;
     oldsize = *((size_t *)mem);
 
     /* Reduce or enlarge the memory ? */
@@ -0,0 +1,77 @@
+#ifndef AROS_INSTRFUNC_H
+#define AROS_INSTRFUNC_H
+
+/*
+    Copyright (C) 2026, The AROS Development Team. All rights reserved.
+
+    Desc: Function trace buffers filled by the instrfunc linklib
+*/
+
+#include <exec/types.h>
+#include <exec/semaphores.h>
+#include <exec/tasks.h>
+
+/*
+ * Code built with -finstrument-functions is linked against instrfunc,
+ * whose hooks log every function entry and exit into a ring buffer owned
+ * by the running task. The buffers hang off a profiler base that the
+ * collector (Debug:FuncProfile) publishes as a semaphore named
+ * INSTRFUNC_NAME. Until it exists the hooks only look for it every
+ * INSTRFUNC_PROBE calls.
+ *
+ * Each buffer has a single writer, its task, which advances ifb_Head,
+ * and a single reader, the collector, which advances ifb_Tail. Records
+ * that do not fit are counted in ifb_Dropped.
+ *
+ * A buffer belongs to the task with address ifb_Task and exec unique ID
+ * ifb_TaskID. The collector releases the buffers of tasks that have
+ * exited by clearing ifb_Task once they are empty, and a new task takes
+ * over a released buffer. A new task that finds a buffer with its own
+ * address but another ID takes it over directly, starting with an
+ * IFR_RESET record.
+ */
+
+#define INSTRFUNC_NAME          "instrfunc.profiler"
+#define INSTRFUNC_VERSION       2
+#define INSTRFUNC_MAXTASKS      64
+#define INSTRFUNC_RECORDS       65536   /* Per task, must be a power of two */
+#define INSTRFUNC_PROBE         1024
+
+/* ifr_Type */
+#define IFR_ENTER               0
+#define IFR_EXIT                1
+#define IFR_RESET               2       /* New owner, nothing before returns */
+
+struct InstrFuncRecord
+{
+    UQUAD           ifr_Stamp;          /* KrnTimeStamp() */
+    APTR            ifr_Function;
+    IPTR            ifr_Type;
+};
+
+struct InstrFuncBuffer
+{
+    struct Task * volatile ifb_Task;    /* NULL once released */
+    ULONG           ifb_TaskID;         /* GetETaskID() of the owner */
+    volatile ULONG  ifb_Head;
+    volatile ULONG  ifb_Tail;
+    volatile ULONG  ifb_Dropped;
+    struct InstrFuncRecord ifb_Records[INSTRFUNC_RECORDS];
+};
+
+struct InstrFuncProfiler
+{
+    struct SignalSemaphore  ifp_Semaphore;
+    UWORD                   ifp_Version;
+    volatile UWORD          ifp_Enabled;        /* Hooks record only while set */
+    APTR                    ifp_KernelBase;
+    /* Slots are claimed and released under Forbid(), a task probes
+       from (task >> 4) % INSTRFUNC_MAXTASKS */
+    struct InstrFuncBuffer * volatile ifp_Buffers[INSTRFUNC_MAXTASKS];
+    volatile ULONG          ifp_Overflow;       /* Tasks that found no slot */
+    TEXT                    ifp_Name[sizeof(INSTRFUNC_NAME)];
+};
+
+#define INSTRFUNC_SLOT(task)    ((((IPTR)(task)) >> 4) % INSTRFUNC_MAXTASKS)
+
+#endif /* AROS_INSTRFUNC_H */
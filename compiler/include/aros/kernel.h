@@ -2,7 +2,7 @@
 #define AROS_KERNEL_H
 
 /*
-    Copyright  1995-2025, The AROS Development Team. All rights reserved.
+    Copyright  1995-2026, The AROS Development Team. All rights reserved.
     $Id$
 
     Desc: TagItems for the kernel.resource
@@ -122,4 +122,37 @@ struct KrnSymInfo
 /* Single-address resolver callback type (must be trap-safe, non-blocking). */
 typedef LONG (*KrnSymResolver_t)(APTR priv, APTR addr, struct KrnSymInfo *out);
 
+/*
+ * Statistical sampling, see KrnSetSampler(). Every ksr_Period timer ticks
+ * the timer interrupt of each CPU stores the interrupted PC and a short
+ * backtrace into that CPU's buffer. The kernel advances ksb_Head, the
+ * owner of the sampler reads up to it and advances ksb_Tail.
+ */
+#define KRNSAMPLE_DEPTH         8
+
+struct KrnSample
+{
+    APTR        ks_Task;                /* Interrupted task, NULL if the timer interrupted other interrupt code */
+    ULONG       ks_Depth;               /* Valid entries in ks_PC */
+    APTR        ks_PC[KRNSAMPLE_DEPTH]; /* Interrupted PC, followed by the return addresses */
+};
+
+struct KrnSampleBuffer
+{
+    volatile ULONG      ksb_Head;
+    volatile ULONG      ksb_Tail;
+    volatile ULONG      ksb_Dropped;    /* Samples lost because the buffer was full */
+    ULONG               ksb_Ticks;      /* Private */
+    struct KrnSample   *ksb_Samples;
+};
+
+struct KrnSampler
+{
+    ULONG                   ksr_Period;     /* Timer ticks between samples, at least 1 */
+    ULONG                   ksr_Depth;      /* Entries to record, 1 to KRNSAMPLE_DEPTH */
+    ULONG                   ksr_Size;       /* Samples per buffer, a power of two */
+    ULONG                   ksr_CPUCount;   /* One buffer per CPU, see KrnGetCPUCount() */
+    struct KrnSampleBuffer *ksr_Buffers;
+};
+
 #endif /* AROS_KERNEL_H */
@@ -71,6 +71,9 @@ struct ColorRegister
 #define PDTA_SourceMode		(DTA_Dummy + 250) /* Set the interface mode for the sub datatype. See below. */
 #define PDTA_DestMode		(DTA_Dummy + 251) /* Set the interface mode for the app datatype. See below. */
 #define PDTA_UseFriendBitMap	(DTA_Dummy + 255) /* Make the allocated bitmap be a "friend" bitmap (BOOL) */
+#define PDTA_ThumbnailSize	(DTA_Dummy + 260) /* (OM_NEW) Hint for sub datatypes that only a picture of about
+                                                     this size (largest dimension) is needed. Decoders may then
+                                                     deliver a reduced resolution picture (ULONG) */
 
 /* Interface modes */
 #define PMODE_V42 (0)	/* Mode used for backward compatibility */
@@ -2,7 +2,7 @@
 #define WORKBENCH_ICON_H
 
 /*
-    Copyright  1995-2008, The AROS Development Team. All rights reserved.
+    Copyright  1995-2026, The AROS Development Team. All rights reserved.
     $Id$
 */
 
@@ -86,6 +86,20 @@
 #define ICONCTRLA_GetGlobalScaleBox     (ICONA_BASE+401)
 #define ICONCTRLA_SetGlobalScaleBox     (ICONA_BASE+402)
 
+/*
+    Size of the cache of decoded icons, in bytes (ULONG). Unused
+    icons are dropped until the cache fits. Default icons do not
+    count against it and are always cached, 0 disables caching of
+    all other icons.
+ */
+#define ICONCTRLA_GetGlobalCacheSize    (ICONA_BASE+405)
+#define ICONCTRLA_SetGlobalCacheSize    (ICONA_BASE+406)
+/* Drop all cached icons, icons in use stay valid (BOOL) */
+#define ICONCTRLA_FlushGlobalCache      (ICONA_BASE+407)
+/* Number of cache hits and misses so far (ULONG *) */
+#define ICONCTRLA_GetGlobalCacheHits    (ICONA_BASE+408)
+#define ICONCTRLA_GetGlobalCacheMisses  (ICONA_BASE+409)
+
 /*** Per icon local options for IconControlA() ******************************/
 /* Get the icon rendering masks (PLANEPTR) */
 #define ICONCTRLA_GetImageMask1         (ICONA_BASE+14)
@@ -0,0 +1,20 @@
+/*
+    Copyright (C) 2026, The AROS Development Team. All rights reserved.
+
+    Desc: Internal definitions of the instrfunc linklib
+*/
+
+#ifndef INSTRFUNC_INTERN_H
+#define INSTRFUNC_INTERN_H
+
+#include <aros/instrfunc.h>
+
+/* The hooks must not call themselves */
+#define __noinstrument __attribute__((no_instrument_function))
+
+extern struct InstrFuncProfiler *__instrfunc_profiler;
+
+struct InstrFuncBuffer *__instrfunc_buffer(void) __noinstrument;
+void __instrfunc_record(struct InstrFuncBuffer *buf, APTR fn, IPTR type) __noinstrument;
+
+#endif /* INSTRFUNC_INTERN_H */
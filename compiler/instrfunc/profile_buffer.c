@@ -0,0 +1,167 @@
+/*
+    Copyright (C) 2026, The AROS Development Team. All rights reserved.
+
+    Desc: per task trace buffers for the function entry/exit hooks
+*/
+
+#include <exec/memory.h>
+#include <proto/exec.h>
+
+#include "instrfunc_intern.h"
+
+#define KernelBase (__instrfunc_profiler->ifp_KernelBase)
+#include <proto/kernel.h>
+
+struct InstrFuncProfiler *__instrfunc_profiler = NULL;
+
+static ULONG probecount;
+static struct InstrFuncBuffer *lastbuf;
+
+static struct InstrFuncBuffer *claimBuffer(struct Task *me, ULONG id) __noinstrument;
+
+/*
+ * Find the slot of the calling task, or claim one. Slots are claimed
+ * under Forbid(), so the lock free lookup in __instrfunc_buffer() only
+ * ever sees complete buffers. The collector releases slots under
+ * Forbid() too.
+ */
+static struct InstrFuncBuffer *claimBuffer(struct Task *me, ULONG id)
+{
+    struct InstrFuncProfiler *p = __instrfunc_profiler;
+    struct InstrFuncBuffer *buf = NULL, *released = NULL;
+    ULONG slot = INSTRFUNC_SLOT(me), i;
+    LONG empty = -1;
+
+    Forbid();
+
+    for (i = 0; i < INSTRFUNC_MAXTASKS; i++, slot = (slot + 1) % INSTRFUNC_MAXTASKS)
+    {
+        buf = p->ifp_Buffers[slot];
+
+        if (buf == NULL)
+        {
+            /* Slots are filled in order, ours can't come after this */
+            empty = slot;
+            break;
+        }
+
+        if (buf->ifb_Task == me)
+        {
+            if (buf->ifb_TaskID != id)
+            {
+                /* Left behind by an exited task at the same address */
+                buf->ifb_TaskID = id;
+                __instrfunc_record(buf, NULL, IFR_RESET);
+            }
+            break;
+        }
+
+        if (buf->ifb_Task == NULL && released == NULL)
+            released = buf;
+
+        buf = NULL;
+    }
+
+    if (buf == NULL && released != NULL)
+    {
+        buf = released;
+        buf->ifb_TaskID = id;
+        __sync_synchronize();
+        buf->ifb_Task = me;
+    }
+    else if (buf == NULL && empty >= 0)
+    {
+        buf = AllocMem(sizeof(struct InstrFuncBuffer), MEMF_PUBLIC | MEMF_CLEAR);
+        if (buf)
+        {
+            buf->ifb_Task = me;
+            buf->ifb_TaskID = id;
+            p->ifp_Buffers[empty] = buf;
+        }
+    }
+
+    if (buf == NULL)
+        p->ifp_Overflow++;
+
+    Permit();
+
+    return buf;
+}
+
+/*
+ * Return the trace buffer of the calling task, or NULL if nothing is being
+ * collected. Interrupt code is not traced, since it would race with the
+ * task it interrupted for the same buffer.
+ */
+struct InstrFuncBuffer *__instrfunc_buffer(void)
+{
+    struct InstrFuncProfiler *p = __instrfunc_profiler;
+    struct InstrFuncBuffer *buf;
+    struct Task *me;
+    ULONG id, slot, i;
+
+    if (p == NULL)
+    {
+        if ((probecount++ % INSTRFUNC_PROBE) != 0)
+            return NULL;
+
+        Forbid();
+        p = (struct InstrFuncProfiler *)FindSemaphore(INSTRFUNC_NAME);
+        Permit();
+
+        if (p == NULL || p->ifp_Version != INSTRFUNC_VERSION)
+            return NULL;
+        __instrfunc_profiler = p;
+    }
+
+    if (!p->ifp_Enabled || KrnIsSuper())
+        return NULL;
+
+    me = FindTask(NULL);
+    id = GetETaskID(me);
+
+    buf = lastbuf;
+    if (buf && buf->ifb_Task == me && buf->ifb_TaskID == id)
+        return buf;
+
+    slot = INSTRFUNC_SLOT(me);
+    for (i = 0; i < INSTRFUNC_MAXTASKS; i++, slot = (slot + 1) % INSTRFUNC_MAXTASKS)
+    {
+        buf = p->ifp_Buffers[slot];
+
+        if (buf == NULL)
+            break;
+
+        if (buf->ifb_Task == me && buf->ifb_TaskID == id)
+        {
+            lastbuf = buf;
+            return buf;
+        }
+    }
+
+    if ((buf = claimBuffer(me, id)))
+        lastbuf = buf;
+
+    return buf;
+}
+
+void __instrfunc_record(struct InstrFuncBuffer *buf, APTR fn, IPTR type)
+{
+    ULONG head = buf->ifb_Head;
+    struct InstrFuncRecord *rec;
+
+    if (head - buf->ifb_Tail >= INSTRFUNC_RECORDS)
+    {
+        buf->ifb_Dropped++;
+        return;
+    }
+
+    rec = &buf->ifb_Records[head & (INSTRFUNC_RECORDS - 1)];
+    rec->ifr_Stamp = KrnTimeStamp();
+    rec->ifr_Function = fn;
+    rec->ifr_Type = type;
+
+    /* Publish the record only once it is complete */
+    __sync_synchronize();
+    buf->ifb_Head = head + 1;
+}
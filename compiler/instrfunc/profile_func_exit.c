@@ -1,15 +1,19 @@
 /*
-    Copyright (C) 2019, The AROS Development Team. All rights reserved.
+    Copyright (C) 2019-2026, The AROS Development Team. All rights reserved.
     
     Desc: called when a function is exited
 */
 
-#include <aros/debug.h>
-#include <proto/exec.h>
+#include "instrfunc_intern.h"
+
+void __cyg_profile_func_exit  (void *this_fn,
+                               void *call_site) __noinstrument;
 
 void __cyg_profile_func_exit  (void *this_fn,
                                void *call_site)
 {
-    struct Task *thisTask = FindTask(NULL);
-    bug("[0x%p<<] Exit Func @ 0x%p\n", thisTask, this_fn);
+    struct InstrFuncBuffer *buf = __instrfunc_buffer();
+
+    if (buf)
+        __instrfunc_record(buf, this_fn, IFR_EXIT);
 }
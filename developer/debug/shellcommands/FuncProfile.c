@@ -0,0 +1,620 @@
+/*
+    Copyright (C) 2026, The AROS Development Team. All rights reserved.
+
+    Desc: FuncProfile CLI command
+*/
+
+/******************************************************************************
+
+    NAME
+
+        FuncProfile
+
+    SYNOPSIS
+
+        TO/A,INTERVAL/N/K
+
+    LOCATION
+
+        Debug:
+
+    FUNCTION
+
+        Profiles code built with function instrumentation (FUNCINSTR,
+        -finstrument-functions) and linked against the instrfunc linklib.
+
+        While FuncProfile runs, every instrumented function entry and exit
+        is logged with a KrnTimeStamp() time into a buffer of the task that
+        makes it. FuncProfile empties the buffers every INTERVAL ticks and
+        adds up, per function, the number of calls and the time spent in
+        the function alone (exclusive) and including its callees
+        (inclusive), as well as the calls between each caller and callee.
+
+        Press Ctrl-C to stop. The profile is then written in callgrind
+        format, readable with KCachegrind or callgrind_annotate, with the
+        function names resolved through debug.library.
+
+    INPUTS
+
+        TO       -- File to write the profile to.
+        INTERVAL -- Time between collections, in 1/50 s. The default is 5.
+                    Records are lost if a task fills its buffer of 65536
+                    entries in less time.
+
+    RESULT
+
+    NOTES
+
+        Times are in the units of KrnTimeStamp(), which depend on the
+        architecture.
+
+        Functions that are still running when profiling stops are not
+        counted.
+
+        At most 64 tasks are traced at the same time. The buffers of
+        tasks that have exited are given to new tasks.
+
+    EXAMPLE
+
+        Run >NIL: Debug:FuncProfile TO RAM:app.callgrind
+        MyInstrumentedApp
+        Break <process number>
+
+    BUGS
+
+    SEE ALSO
+
+        <aros/instrfunc.h>
+
+    INTERNALS
+
+******************************************************************************/
+
+#include <proto/exec.h>
+#include <proto/dos.h>
+#include <proto/debug.h>
+#include <proto/task.h>
+
+#include <exec/memory.h>
+#include <dos/dos.h>
+#include <libraries/debug.h>
+#include <resources/task.h>
+#include <aros/instrfunc.h>
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+const TEXT version[] = "$VER: FuncProfile 41.1 (19.10.2026)\n";
+
+#define ARG_TEMPLATE "TO/A,INTERVAL/N/K"
+
+enum
+{
+    ARG_TO = 0,
+    ARG_INTERVAL,
+    NOOFARGS
+};
+
+#define MAXDEPTH        512
+
+struct FuncStat
+{
+    APTR    fs_Function;
+    ULONG   fs_Calls;
+    UQUAD   fs_Inclusive;
+    UQUAD   fs_Exclusive;
+    char   *fs_Module;
+    char   *fs_Symbol;
+};
+
+struct CallStat
+{
+    APTR    cs_Caller;
+    APTR    cs_Callee;
+    ULONG   cs_Calls;
+    UQUAD   cs_Inclusive;
+};
+
+struct Frame
+{
+    APTR    f_Function;
+    UQUAD   f_Enter;
+    UQUAD   f_Children;
+};
+
+/* Shadow call stack of one traced task */
+struct TaskState
+{
+    struct InstrFuncBuffer *ts_Buffer;
+    ULONG                   ts_FirstDropped;    /* ifb_Dropped when first seen */
+    ULONG                   ts_Dropped;
+    ULONG                   ts_Depth;
+    struct Frame            ts_Stack[MAXDEPTH];
+};
+
+static struct FuncStat *funcs;
+static ULONG numfuncs, maxfuncs;
+static struct CallStat *calls;
+static ULONG numcalls, maxcalls;
+static struct TaskState *states[INSTRFUNC_MAXTASKS];
+static UQUAD records, unmatched;
+
+APTR TaskResBase;
+
+int __nocommandline = 1;
+
+static ULONG hashPtr(APTR a, APTR b)
+{
+    IPTR h = (IPTR)a * 31 + (IPTR)b;
+
+    return (ULONG)(h ^ (h >> 7) ^ (h >> 17));
+}
+
+static char *copyName(CONST_STRPTR name)
+{
+    char *copy = name ? strdup(name) : NULL;
+
+    return copy;
+}
+
+static struct FuncStat *funcStat(APTR fn)
+{
+    ULONG i;
+
+    if (numfuncs * 2 >= maxfuncs)
+    {
+        struct FuncStat *old = funcs;
+        ULONG oldmax = maxfuncs, j;
+
+        maxfuncs = maxfuncs ? maxfuncs * 2 : 1024;
+        funcs = calloc(maxfuncs, sizeof(struct FuncStat));
+        if (!funcs)
+        {
+            funcs = old;
+            maxfuncs = oldmax;
+            return NULL;
+        }
+
+        for (j = 0; j < oldmax; j++)
+        {
+            if (old[j].fs_Function)
+            {
+                for (i = hashPtr(old[j].fs_Function, NULL) % maxfuncs; funcs[i].fs_Function; i = (i + 1) % maxfuncs)
+                    ;
+                funcs[i] = old[j];
+            }
+        }
+        free(old);
+    }
+
+    for (i = hashPtr(fn, NULL) % maxfuncs; funcs[i].fs_Function; i = (i + 1) % maxfuncs)
+    {
+        if (funcs[i].fs_Function == fn)
+            return &funcs[i];
+    }
+
+    /* Resolve the name now, the code may be gone when the profile is written */
+    {
+        STRPTR module = NULL, symbol = NULL;
+
+        DecodeLocation(fn, DL_ModuleName, &module, DL_SymbolName, &symbol, TAG_DONE);
+        funcs[i].fs_Module = copyName(module);
+        funcs[i].fs_Symbol = copyName(symbol);
+    }
+
+    funcs[i].fs_Function = fn;
+    numfuncs++;
+
+    return &funcs[i];
+}
+
+static struct CallStat *callStat(APTR caller, APTR callee)
+{
+    ULONG i;
+
+    if (numcalls * 2 >= maxcalls)
+    {
+        struct CallStat *old = calls;
+        ULONG oldmax = maxcalls, j;
+
+        maxcalls = maxcalls ? maxcalls * 2 : 1024;
+        calls = calloc(maxcalls, sizeof(struct CallStat));
+        if (!calls)
+        {
+            calls = old;
+            maxcalls = oldmax;
+            return NULL;
+        }
+
+        for (j = 0; j < oldmax; j++)
+        {
+            if (old[j].cs_Callee)
+            {
+                for (i = hashPtr(old[j].cs_Caller, old[j].cs_Callee) % maxcalls; calls[i].cs_Callee; i = (i + 1) % maxcalls)
+                    ;
+                calls[i] = old[j];
+            }
+        }
+        free(old);
+    }
+
+    for (i = hashPtr(caller, callee) % maxcalls; calls[i].cs_Callee; i = (i + 1) % maxcalls)
+    {
+        if (calls[i].cs_Caller == caller && calls[i].cs_Callee == callee)
+            return &calls[i];
+    }
+
+    calls[i].cs_Caller = caller;
+    calls[i].cs_Callee = callee;
+    numcalls++;
+
+    return &calls[i];
+}
+
+/* Account for the return of the function in stack slot idx */
+static void finishFrame(struct TaskState *ts, ULONG idx, UQUAD stamp)
+{
+    struct Frame *f = &ts->ts_Stack[idx];
+    UQUAD duration = stamp > f->f_Enter ? stamp - f->f_Enter : 0;
+    struct FuncStat *fs = funcStat(f->f_Function);
+    BOOL recursive = FALSE;
+    ULONG i;
+
+    for (i = 0; i < idx && !recursive; i++)
+        recursive = ts->ts_Stack[i].f_Function == f->f_Function;
+
+    if (fs)
+    {
+        fs->fs_Calls++;
+        fs->fs_Exclusive += duration > f->f_Children ? duration - f->f_Children : 0;
+        /* Time of a recursive call is already part of the outer call */
+        if (!recursive)
+            fs->fs_Inclusive += duration;
+    }
+
+    if (idx > 0)
+    {
+        struct Frame *parent = &ts->ts_Stack[idx - 1];
+        struct CallStat *cs = callStat(parent->f_Function, f->f_Function);
+
+        parent->f_Children += duration;
+        if (cs)
+        {
+            cs->cs_Calls++;
+            cs->cs_Inclusive += duration;
+        }
+    }
+
+    ts->ts_Depth = idx;
+}
+
+static void processRecord(struct TaskState *ts, struct InstrFuncRecord *rec)
+{
+    if (rec->ifr_Type == IFR_RESET)
+    {
+        /* The buffer changed hands, the old task's calls never return */
+        ts->ts_Depth = 0;
+        return;
+    }
+
+    records++;
+
+    if (rec->ifr_Type == IFR_ENTER)
+    {
+        struct Frame *f;
+
+        /* Too deep to follow, start over */
+        if (ts->ts_Depth == MAXDEPTH)
+            ts->ts_Depth = 0;
+
+        f = &ts->ts_Stack[ts->ts_Depth++];
+        f->f_Function = rec->ifr_Function;
+        f->f_Enter = rec->ifr_Stamp;
+        f->f_Children = 0;
+    }
+    else
+    {
+        ULONG i = ts->ts_Depth;
+
+        /* Frames above the returning function were left without an exit
+           record (longjmp() and the like), close them at the same time */
+        while (i > 0 && ts->ts_Stack[i - 1].f_Function != rec->ifr_Function)
+            i--;
+
+        if (i == 0)
+        {
+            /* Entered before profiling started */
+            unmatched++;
+            return;
+        }
+
+        while (ts->ts_Depth > i)
+            finishFrame(ts, ts->ts_Depth - 1, rec->ifr_Stamp);
+        finishFrame(ts, i - 1, rec->ifr_Stamp);
+    }
+}
+
+/*
+ * Find the slots whose task has exited, leaving their owner in
+ * exited[] and NULL for the others.
+ */
+static void findExited(struct InstrFuncProfiler *p, struct Task **exited, ULONG *ids)
+{
+    struct TaskList *tasklist;
+    struct Task *task;
+    ULONG slot;
+
+    if (TaskResBase == NULL)
+    {
+        /* Can't tell, keep them all */
+        memset(exited, 0, INSTRFUNC_MAXTASKS * sizeof(struct Task *));
+        return;
+    }
+
+    Forbid();
+    for (slot = 0; slot < INSTRFUNC_MAXTASKS; slot++)
+    {
+        struct InstrFuncBuffer *buf = p->ifp_Buffers[slot];
+
+        exited[slot] = buf ? buf->ifb_Task : NULL;
+        ids[slot] = buf ? buf->ifb_TaskID : 0;
+    }
+    Permit();
+
+    tasklist = LockTaskList(LTF_ALL);
+    while ((task = NextTaskEntry(tasklist, LTF_ALL)) != NULL)
+    {
+        for (slot = 0; slot < INSTRFUNC_MAXTASKS; slot++)
+        {
+            if (exited[slot] == task && ids[slot] == GetETaskID(task))
+                exited[slot] = NULL;
+        }
+    }
+    UnLockTaskList(tasklist, LTF_ALL);
+}
+
+static void collect(struct InstrFuncProfiler *p)
+{
+    struct Task *exited[INSTRFUNC_MAXTASKS];
+    ULONG ids[INSTRFUNC_MAXTASKS];
+    ULONG slot;
+
+    /* Before draining, so that all records of an exited task are in */
+    findExited(p, exited, ids);
+
+    for (slot = 0; slot < INSTRFUNC_MAXTASKS; slot++)
+    {
+        struct InstrFuncBuffer *buf = p->ifp_Buffers[slot];
+        struct TaskState *ts = states[slot];
+        ULONG head, tail;
+
+        if (buf == NULL)
+            continue;
+
+        if (ts == NULL)
+        {
+            if (!(ts = states[slot] = calloc(1, sizeof(struct TaskState))))
+                continue;
+            ts->ts_Buffer = buf;
+            ts->ts_FirstDropped = ts->ts_Dropped = buf->ifb_Dropped;
+        }
+
+        head = buf->ifb_Head;
+        __sync_synchronize();
+
+        for (tail = buf->ifb_Tail; tail != head; tail++)
+            processRecord(ts, &buf->ifb_Records[tail & (INSTRFUNC_RECORDS - 1)]);
+
+        __sync_synchronize();
+        buf->ifb_Tail = tail;
+
+        /* Records were lost, the shadow stack can no longer be trusted */
+        if (buf->ifb_Dropped != ts->ts_Dropped)
+        {
+            ts->ts_Dropped = buf->ifb_Dropped;
+            ts->ts_Depth = 0;
+        }
+
+        if (exited[slot])
+        {
+            BOOL released = FALSE;
+
+            /* Unless a new task at the same address has taken it over */
+            Forbid();
+            if (buf->ifb_Task == exited[slot] && buf->ifb_TaskID == ids[slot] && buf->ifb_Head == tail)
+            {
+                buf->ifb_Task = NULL;
+                released = TRUE;
+            }
+            Permit();
+
+            if (released)
+                ts->ts_Depth = 0;
+        }
+    }
+}
+
+static int compareFuncs(const void *a, const void *b)
+{
+    APTR fa = ((const struct FuncStat *)a)->fs_Function;
+    APTR fb = ((const struct FuncStat *)b)->fs_Function;
+
+    return (fa > fb) - (fa < fb);
+}
+
+static int compareCalls(const void *a, const void *b)
+{
+    APTR ca = ((const struct CallStat *)a)->cs_Caller;
+    APTR cb = ((const struct CallStat *)b)->cs_Caller;
+
+    return (ca > cb) - (ca < cb);
+}
+
+static void writeName(FILE *out, const char *obkey, const char *fnkey, struct FuncStat *fs)
+{
+    fprintf(out, "%s=%s\n", obkey, fs->fs_Module ? fs->fs_Module : "???");
+    if (fs->fs_Symbol)
+        fprintf(out, "%s=%s\n", fnkey, fs->fs_Symbol);
+    else
+        fprintf(out, "%s=%p\n", fnkey, fs->fs_Function);
+}
+
+static BOOL writeProfile(CONST_STRPTR name)
+{
+    FILE *out = fopen(name, "w");
+    UQUAD total = 0;
+    ULONG i, c = 0;
+
+    if (!out)
+        return FALSE;
+
+    /* Compact both tables and sort them, so that the calls made by each
+       function can be written in one pass */
+    for (i = 0; i < maxfuncs; i++)
+        if (funcs[i].fs_Function)
+            funcs[c++] = funcs[i];
+    qsort(funcs, numfuncs, sizeof(struct FuncStat), compareFuncs);
+
+    for (i = 0, c = 0; i < maxcalls; i++)
+        if (calls[i].cs_Callee)
+            calls[c++] = calls[i];
+    qsort(calls, numcalls, sizeof(struct CallStat), compareCalls);
+
+    for (i = 0; i < numfuncs; i++)
+        total += funcs[i].fs_Exclusive;
+
+    fprintf(out, "# callgrind format\n");
+    fprintf(out, "version: 1\n");
+    fprintf(out, "creator: FuncProfile\n");
+    fprintf(out, "events: Ticks\n");
+    fprintf(out, "summary: %llu\n\n", (unsigned long long)total);
+
+    for (i = 0, c = 0; i < numfuncs; i++)
+    {
+        struct FuncStat *fs = &funcs[i];
+
+        writeName(out, "ob", "fn", fs);
+        fprintf(out, "0 %llu\n", (unsigned long long)fs->fs_Exclusive);
+
+        while (c < numcalls && calls[c].cs_Caller < fs->fs_Function)
+            c++;
+
+        for (; c < numcalls && calls[c].cs_Caller == fs->fs_Function; c++)
+        {
+            struct FuncStat key, *callee;
+
+            key.fs_Function = calls[c].cs_Callee;
+            callee = bsearch(&key, funcs, numfuncs, sizeof(struct FuncStat), compareFuncs);
+            if (callee == NULL)
+                continue;
+
+            writeName(out, "cob", "cfn", callee);
+            fprintf(out, "calls=%lu 0\n", (unsigned long)calls[c].cs_Calls);
+            fprintf(out, "0 %llu\n", (unsigned long long)calls[c].cs_Inclusive);
+        }
+        fprintf(out, "\n");
+    }
+
+    fclose(out);
+
+    return TRUE;
+}
+
+int main(void)
+{
+    IPTR args[NOOFARGS] = { 0 };
+    struct RDArgs *rda;
+    struct InstrFuncProfiler *p;
+    LONG interval = 5;
+    ULONG dropped = 0, slot;
+    LONG return_code = RETURN_OK;
+
+    rda = ReadArgs(ARG_TEMPLATE, args, NULL);
+    if (rda == NULL)
+    {
+        PrintFault(IoErr(), "FuncProfile");
+        return RETURN_FAIL;
+    }
+
+    if (args[ARG_INTERVAL] && *(LONG *)args[ARG_INTERVAL] > 0)
+        interval = *(LONG *)args[ARG_INTERVAL];
+
+    /* The profiler base outlives us, instrumented code keeps a pointer
+       to it. A later run picks it up again */
+    Forbid();
+    p = (struct InstrFuncProfiler *)FindSemaphore(INSTRFUNC_NAME);
+    if (p == NULL)
+    {
+        p = AllocMem(sizeof(struct InstrFuncProfiler), MEMF_PUBLIC | MEMF_CLEAR);
+        if (p)
+        {
+            p->ifp_Version = INSTRFUNC_VERSION;
+            p->ifp_KernelBase = OpenResource("kernel.resource");
+            strcpy(p->ifp_Name, INSTRFUNC_NAME);
+            p->ifp_Semaphore.ss_Link.ln_Name = p->ifp_Name;
+            AddSemaphore(&p->ifp_Semaphore);
+        }
+    }
+    Permit();
+
+    if (p == NULL || p->ifp_Version != INSTRFUNC_VERSION)
+    {
+        PutStr("Cannot set up the profiler\n");
+        FreeArgs(rda);
+        return RETURN_FAIL;
+    }
+
+    if (!AttemptSemaphore(&p->ifp_Semaphore))
+    {
+        PutStr("FuncProfile is already running\n");
+        FreeArgs(rda);
+        return RETURN_WARN;
+    }
+
+    TaskResBase = OpenResource("task.resource");
+
+    /* Skip whatever an earlier run left behind */
+    for (slot = 0; slot < INSTRFUNC_MAXTASKS; slot++)
+    {
+        if (p->ifp_Buffers[slot])
+            p->ifp_Buffers[slot]->ifb_Tail = p->ifp_Buffers[slot]->ifb_Head;
+    }
+
+    p->ifp_Enabled = TRUE;
+
+    PutStr("Profiling, press Ctrl-C to stop\n");
+
+    while (!CheckSignal(SIGBREAKF_CTRL_C))
+    {
+        collect(p);
+        Delay(interval);
+    }
+
+    p->ifp_Enabled = FALSE;
+    collect(p);
+
+    for (slot = 0; slot < INSTRFUNC_MAXTASKS; slot++)
+    {
+        if (states[slot])
+            dropped += states[slot]->ts_Dropped - states[slot]->ts_FirstDropped;
+    }
+
+    ReleaseSemaphore(&p->ifp_Semaphore);
+
+    Printf("%lu records, %lu functions, %lu call pairs\n",
+           (ULONG)records, numfuncs, numcalls);
+    if (dropped || unmatched || p->ifp_Overflow)
+        Printf("%lu records dropped, %lu unmatched exits, %lu tasks not traced\n",
+               dropped, (ULONG)unmatched, p->ifp_Overflow);
+
+    if (!writeProfile((CONST_STRPTR)args[ARG_TO]))
+    {
+        PrintFault(IoErr(), (CONST_STRPTR)args[ARG_TO]);
+        return_code = RETURN_ERROR;
+    }
+
+    FreeArgs(rda);
+
+    return return_code;
+}
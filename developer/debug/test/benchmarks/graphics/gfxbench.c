@@ -1,5 +1,5 @@
 /*
-    Copyright (C) 2011-2013, The AROS Development Team. All rights reserved.
+    Copyright (C) 2011-2026, The AROS Development Team. All rights reserved.
 
     Desc: Cumulative graphics benchmarks
 */
@@ -72,6 +72,8 @@ STRPTR          consttext = "The AROS Development Team. All rights reserved.";
 LONG            mode = JAM1;
 BOOL            antialias = FALSE;
 LONG            linelen = 100;
+LONG            style = FS_NORMAL;
+ULONG           textcalls;
 LONG            function = 0;
 LONG            pixfmt = RECTFMT_ARGB;
 
@@ -461,7 +463,7 @@ static void detectsystem()
     printf("\n\n");
 }
 
-static void textbenchmark(LONG optmode, BOOL optantialias, LONG optlen)
+static void textbenchmark(LONG optmode, BOOL optantialias, LONG optlen, LONG optstyle)
 {
     STRPTR modestr = "UNKNOWN";
     STRPTR aastr = "UNKNOWN";
@@ -483,8 +485,13 @@ static void textbenchmark(LONG optmode, BOOL optantialias, LONG optlen)
     
     sprintf(lenstr, "LEN %d", (int)optlen);
     linelen = optlen;
+
+    style = optstyle;
     
-    printf("|%s, %s, %s|", modestr, aastr, lenstr);
+    printf("|%s, %s, %s%s%s%s|", modestr, aastr, lenstr,
+        (optstyle & FSF_BOLD) ? ", BOLD" : "",
+        (optstyle & FSF_ITALIC) ? ", ITALIC" : "",
+        (optstyle & FSF_UNDERLINED) ? ", UNDERLINED" : "");
     
     action_text();
 }
@@ -493,18 +500,21 @@ static void textbenchmarkset()
 {
     printf("*Text benchmark %dx%d*\n", (int)width, (int)height);
     printf("||Test||Blits/s||MB/s||\n");
-    textbenchmark(JAM1,         FALSE,  100);
-    textbenchmark(JAM2,         FALSE,  100);
-    textbenchmark(COMPLEMENT,   FALSE,  100);
-    textbenchmark(JAM1,         TRUE,   100);
-    textbenchmark(JAM2,         TRUE,   100);
-    textbenchmark(COMPLEMENT,   TRUE,   100);
-    textbenchmark(JAM1,         FALSE,  5);
-    textbenchmark(JAM2,         FALSE,  5);
-    textbenchmark(COMPLEMENT,   FALSE,  5);
-    textbenchmark(JAM1,         TRUE,   5);
-    textbenchmark(JAM2,         TRUE,   5);
-    textbenchmark(COMPLEMENT,   TRUE,   5);
+    textbenchmark(JAM1,         FALSE,  100, FS_NORMAL);
+    textbenchmark(JAM2,         FALSE,  100, FS_NORMAL);
+    textbenchmark(COMPLEMENT,   FALSE,  100, FS_NORMAL);
+    textbenchmark(JAM1,         TRUE,   100, FS_NORMAL);
+    textbenchmark(JAM2,         TRUE,   100, FS_NORMAL);
+    textbenchmark(COMPLEMENT,   TRUE,   100, FS_NORMAL);
+    textbenchmark(JAM1,         FALSE,  5,   FS_NORMAL);
+    textbenchmark(JAM2,         FALSE,  5,   FS_NORMAL);
+    textbenchmark(COMPLEMENT,   FALSE,  5,   FS_NORMAL);
+    textbenchmark(JAM1,         TRUE,   5,   FS_NORMAL);
+    textbenchmark(JAM2,         TRUE,   5,   FS_NORMAL);
+    textbenchmark(COMPLEMENT,   TRUE,   5,   FS_NORMAL);
+    textbenchmark(JAM1,         FALSE,  100, FSF_BOLD);
+    textbenchmark(JAM1,         FALSE,  100, FSF_ITALIC);
+    textbenchmark(JAM1,         FALSE,  100, FSF_BOLD | FSF_ITALIC | FSF_UNDERLINED);
     printf("\n\n");
 }
 
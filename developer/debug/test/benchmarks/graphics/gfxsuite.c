@@ -0,0 +1,802 @@
+/*
+    Copyright (C) 2026, The AROS Development Team. All rights reserved.
+
+    Desc: Graphics throughput suite for the headless display driver
+*/
+
+/*
+ * Measures the graphics.library, layers.library and cybergraphics.library
+ * rendering paths down to the display driver: RectFill(), BltBitMap()
+ * with every minterm between bitmaps of different formats, Text() with a
+ * bitmap and an anti-aliased font, Write/ReadPixelArray(), region
+ * operations, moving layers and ScrollRaster().
+ *
+ * By default it opens its screen on a mode of headlessgfx.hidd, which
+ * renders into plain memory and never waits for a display, so the
+ * figures only depend on the code under test. Boot with the headless
+ * driver as the only display driver, or use ANYDRIVER to run on whatever
+ * driver provides the best mode.
+ *
+ * Every test is repeated for TIME milliseconds. The results are printed
+ * as comma separated values, one line per test:
+ *
+ *     test,variant,ops,seconds,ops_per_sec,mpixels_per_sec
+ *
+ * mpixels_per_sec is "-" where no pixels are touched. Lines starting
+ * with '#' are comments. TEST selects tests with an AmigaDOS pattern.
+ */
+
+#include <aros/macros.h>
+#include <exec/types.h>
+#include <dos/dos.h>
+#include <graphics/gfx.h>
+#include <graphics/displayinfo.h>
+#include <graphics/regions.h>
+#include <graphics/text.h>
+#include <graphics/rastport.h>
+#include <graphics/modeid.h>
+#include <intuition/screens.h>
+#include <cybergraphx/cybergraphics.h>
+#include <proto/exec.h>
+#include <proto/dos.h>
+#include <proto/graphics.h>
+#include <proto/layers.h>
+#include <proto/intuition.h>
+#include <proto/diskfont.h>
+#include <proto/cybergraphics.h>
+#include <proto/utility.h>
+#include <sys/time.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdio.h>
+
+#define TEMPLATE        "TEST/K,TIME/K/N,MODEID/K,WIDTH/K/N,HEIGHT/K/N,DEPTH/K/N,AAFONT/K,AASIZE/K/N,ANYDRIVER/S"
+#define DEFAULT_TIME    200     /* milliseconds per test */
+#define DEFAULT_AAFONT  "ttcourier.font"
+#define DEFAULT_AASIZE  14
+
+enum
+{
+    ARG_TEST, ARG_TIME, ARG_MODEID, ARG_WIDTH, ARG_HEIGHT, ARG_DEPTH,
+    ARG_AAFONT, ARG_AASIZE, ARG_ANYDRIVER, ARG_COUNT
+};
+
+#define BLITSIZE        128
+#define ARRAYSIZE       256
+#define LAYERCOUNT      8
+#define LAYERWIDTH      200
+#define LAYERHEIGHT     150
+#define REGIONRECTS     64
+
+static struct Screen *scr;
+static struct RastPort *rp;
+static WORD scrw, scrh;
+static ULONG penmask;
+static double duration;
+static UBYTE testpat[128];
+static BOOL aborted;
+
+static double elapsed(struct timeval *start, struct timeval *stop)
+{
+    return (stop->tv_sec - start->tv_sec) + (stop->tv_usec - start->tv_usec) / 1000000.0;
+}
+
+static BOOL selected(CONST_STRPTR test)
+{
+    return !testpat[0] || MatchPatternNoCase(testpat, (STRPTR)test);
+}
+
+/*
+ * Repeat op() until the time is up. The clock is read after batches
+ * which grow until one takes a sixteenth of the time, so short operations
+ * are not dominated by gettimeofday().
+ */
+static void measure(CONST_STRPTR test, CONST_STRPTR variant, ULONG pixels,
+                    void (*op)(APTR, ULONG), APTR data)
+{
+    struct timeval start, now;
+    ULONG ops = 0, batch = 1, i;
+    double secs;
+
+    if (aborted)
+        return;
+
+    gettimeofday(&start, NULL);
+    do
+    {
+        for (i = 0; i < batch; i++)
+            op(data, ops + i);
+        ops += batch;
+        WaitBlit();
+
+        gettimeofday(&now, NULL);
+        secs = elapsed(&start, &now);
+        if (secs < duration / 16)
+            batch *= 2;
+    } while (secs < duration);
+
+    if (pixels)
+        printf("%s,%s,%lu,%.3f,%.1f,%.2f\n", test, variant, (unsigned long)ops, secs,
+               ops / secs, (double)ops * pixels / secs / 1000000.0);
+    else
+        printf("%s,%s,%lu,%.3f,%.1f,-\n", test, variant, (unsigned long)ops, secs,
+               ops / secs);
+    fflush(stdout);
+
+    if (SetSignal(0, SIGBREAKF_CTRL_C) & SIGBREAKF_CTRL_C)
+        aborted = TRUE;
+}
+
+/* Spread the operations over the screen so no single area stays cached */
+static WORD spread(ULONG i, ULONG step, WORD range)
+{
+    return (range > 0) ? (WORD)((i * step) % range) : 0;
+}
+
+/****************************************************************************************/
+
+struct rectfill
+{
+    WORD w, h;
+};
+
+static void op_rectfill(APTR data, ULONG i)
+{
+    struct rectfill *r = data;
+    WORD x = spread(i, 37, scrw - r->w);
+    WORD y = spread(i, 23, scrh - r->h);
+
+    SetAPen(rp, i & penmask);
+    RectFill(rp, x, y, x + r->w - 1, y + r->h - 1);
+}
+
+static void test_rectfill(void)
+{
+    static const WORD sizes[] = { 1, 8, 64, 256 };
+    struct rectfill r;
+    char variant[32];
+    UWORD i;
+
+    SetDrMd(rp, JAM1);
+    for (i = 0; i < sizeof(sizes) / sizeof(sizes[0]); i++)
+    {
+        r.w = r.h = sizes[i];
+        sprintf(variant, "%dx%d", r.w, r.h);
+        measure("rectfill", variant, r.w * r.h, op_rectfill, &r);
+    }
+
+    r.w = scrw;
+    r.h = scrh;
+    measure("rectfill", "screen", r.w * r.h, op_rectfill, &r);
+}
+
+/****************************************************************************************/
+
+/*
+ * Blit sources and destinations. Apart from the screen every bitmap is
+ * two blits wide, so copying within one bitmap does not overlap.
+ */
+struct blitfmt
+{
+    CONST_STRPTR name;
+    ULONG depth;
+    ULONG flags;
+    BOOL friend;
+    struct BitMap *bm;
+};
+
+static struct blitfmt blitfmts[] =
+{
+    { "screen", 0,  0,                                                FALSE },
+    { "friend", 0,  0,                                                TRUE  },
+    { "planar", 8,  0,                                                FALSE },
+    { "lut8",   8,  BMF_SPECIALFMT | SHIFT_PIXFMT(PIXFMT_LUT8),      FALSE },
+    { "rgb16",  16, BMF_SPECIALFMT | SHIFT_PIXFMT(PIXFMT_RGB16),     FALSE },
+    { "argb32", 32, BMF_SPECIALFMT | SHIFT_PIXFMT(PIXFMT_ARGB32),    FALSE },
+};
+
+#define NUMBLITFMTS (sizeof(blitfmts) / sizeof(blitfmts[0]))
+
+struct blit
+{
+    struct BitMap *src, *dst;
+    UBYTE minterm;
+};
+
+static void op_blit(APTR data, ULONG i)
+{
+    struct blit *b = data;
+
+    BltBitMap(b->src, 0, 0, b->dst, BLITSIZE, 0, BLITSIZE, BLITSIZE, b->minterm, 0xff, NULL);
+}
+
+static void test_blit(void)
+{
+    struct RastPort tmprp;
+    struct blit b;
+    char variant[48];
+    UWORD s, d, m, j;
+
+    for (s = 0; s < NUMBLITFMTS; s++)
+    {
+        struct blitfmt *f = &blitfmts[s];
+
+        if (f->depth == 0 && !f->friend)
+            f->bm = scr->RastPort.BitMap;
+        else
+            f->bm = AllocBitMap(BLITSIZE * 2, BLITSIZE, f->friend ? GetBitMapAttr(scr->RastPort.BitMap, BMA_DEPTH) : f->depth,
+                                f->flags | BMF_CLEAR, f->friend ? scr->RastPort.BitMap : NULL);
+
+        if (!f->bm)
+        {
+            printf("# blit: cannot allocate %s bitmap\n", f->name);
+            continue;
+        }
+
+        /* Something else than a plain area to copy */
+        InitRastPort(&tmprp);
+        tmprp.BitMap = f->bm;
+        for (j = 0; j < BLITSIZE; j += 8)
+        {
+            SetAPen(&tmprp, (j / 8) & penmask);
+            RectFill(&tmprp, j, j / 2, j + 7, BLITSIZE - 1);
+        }
+    }
+
+    for (s = 0; s < NUMBLITFMTS; s++)
+    {
+        for (d = 0; d < NUMBLITFMTS; d++)
+        {
+            if (!blitfmts[s].bm || !blitfmts[d].bm)
+                continue;
+
+            b.src = blitfmts[s].bm;
+            b.dst = blitfmts[d].bm;
+
+            /* All sixteen minterms that do not need a mask (ABC) */
+            for (m = 0; m < 16; m++)
+            {
+                b.minterm = m << 4;
+                sprintf(variant, "%s>%s:0x%02x", blitfmts[s].name, blitfmts[d].name, b.minterm);
+                measure("blit", variant, BLITSIZE * BLITSIZE, op_blit, &b);
+            }
+        }
+    }
+
+    for (s = 0; s < NUMBLITFMTS; s++)
+    {
+        if (blitfmts[s].bm && blitfmts[s].bm != scr->RastPort.BitMap)
+            FreeBitMap(blitfmts[s].bm);
+        blitfmts[s].bm = NULL;
+    }
+}
+
+/****************************************************************************************/
+
+static const char textstr[] = "The quick brown fox jumps over the lazy dog 0123456789 ABCDEFGHI";
+
+struct text
+{
+    WORD w, h;
+};
+
+static void op_text(APTR data, ULONG i)
+{
+    struct text *t = data;
+
+    SetAPen(rp, i & penmask);
+    SetBPen(rp, (i + 1) & penmask);
+    Move(rp, spread(i, 37, scrw - t->w), rp->TxBaseline + spread(i, 23, scrh - t->h));
+    Text(rp, textstr, sizeof(textstr) - 1);
+}
+
+static void text_font(struct TextFont *font, CONST_STRPTR name)
+{
+    struct text t;
+    char variant[48];
+
+    SetFont(rp, font);
+    t.w = TextLength(rp, textstr, sizeof(textstr) - 1);
+    t.h = font->tf_YSize;
+
+    sprintf(variant, "%s:jam1", name);
+    SetDrMd(rp, JAM1);
+    measure("text", variant, t.w * t.h, op_text, &t);
+
+    sprintf(variant, "%s:jam2", name);
+    SetDrMd(rp, JAM2);
+    measure("text", variant, t.w * t.h, op_text, &t);
+
+    SetDrMd(rp, JAM1);
+}
+
+static void test_text(CONST_STRPTR aafont, UWORD aasize)
+{
+    struct TextAttr ta = { "topaz.font", 8, FS_NORMAL, FPF_ROMFONT };
+    struct TextFont *font, *oldfont = rp->Font;
+
+    if ((font = OpenFont(&ta)))
+    {
+        text_font(font, "topaz8");
+        CloseFont(font);
+    }
+    else
+        printf("# text: cannot open topaz.font 8\n");
+
+    ta.ta_Name = (STRPTR)aafont;
+    ta.ta_YSize = aasize;
+    ta.ta_Flags = FPF_DISKFONT;
+
+    if ((font = OpenDiskFont(&ta)))
+    {
+        /* Text() only blends when the font really is anti-aliased */
+        if ((font->tf_Style & FSF_COLORFONT) &&
+            (((struct ColorTextFont *)font)->ctf_Flags & CT_COLORMASK) == CT_ANTIALIAS)
+            text_font(font, "aa");
+        else
+        {
+            printf("# text: %s %d is not anti-aliased\n", aafont, aasize);
+            text_font(font, "outline");
+        }
+        CloseFont(font);
+    }
+    else
+        printf("# text: cannot open %s %d\n", aafont, aasize);
+
+    SetFont(rp, oldfont);
+}
+
+/****************************************************************************************/
+
+struct pixarray
+{
+    APTR buf;
+    UWORD bpp;
+    UBYTE fmt;
+};
+
+static void op_writepixelarray(APTR data, ULONG i)
+{
+    struct pixarray *p = data;
+
+    WritePixelArray(p->buf, 0, 0, ARRAYSIZE * p->bpp, rp,
+                    spread(i, 37, scrw - ARRAYSIZE), spread(i, 23, scrh - ARRAYSIZE),
+                    ARRAYSIZE, ARRAYSIZE, p->fmt);
+}
+
+static void op_writepixelarrayalpha(APTR data, ULONG i)
+{
+    struct pixarray *p = data;
+
+    WritePixelArrayAlpha(p->buf, 0, 0, ARRAYSIZE * 4, rp,
+                         spread(i, 37, scrw - ARRAYSIZE), spread(i, 23, scrh - ARRAYSIZE),
+                         ARRAYSIZE, ARRAYSIZE, 0xffffffff);
+}
+
+static void op_readpixelarray(APTR data, ULONG i)
+{
+    struct pixarray *p = data;
+
+    ReadPixelArray(p->buf, 0, 0, ARRAYSIZE * p->bpp, rp,
+                   spread(i, 37, scrw - ARRAYSIZE), spread(i, 23, scrh - ARRAYSIZE),
+                   ARRAYSIZE, ARRAYSIZE, p->fmt);
+}
+
+static void test_pixelarray(void)
+{
+    static const struct
+    {
+        CONST_STRPTR name;
+        UBYTE fmt;
+        UWORD bpp;
+        BOOL read;
+    } fmts[] =
+    {
+        { "rgb",   RECTFMT_RGB,   3, TRUE  },
+        { "rgba",  RECTFMT_RGBA,  4, TRUE  },
+        { "argb",  RECTFMT_ARGB,  4, TRUE  },
+        { "grey8", RECTFMT_GREY8, 1, FALSE },
+    };
+    struct pixarray p;
+    ULONG j;
+    UWORD i;
+
+    if (!(p.buf = AllocVec(ARRAYSIZE * ARRAYSIZE * 4, MEMF_ANY)))
+        return;
+
+    /* A gradient with some alpha, so nothing can take a shortcut */
+    for (j = 0; j < ARRAYSIZE * ARRAYSIZE; j++)
+        ((ULONG *)p.buf)[j] = AROS_LONG2BE(j * 0x01030507);
+
+    for (i = 0; i < sizeof(fmts) / sizeof(fmts[0]); i++)
+    {
+        p.fmt = fmts[i].fmt;
+        p.bpp = fmts[i].bpp;
+        if (selected("writepixelarray"))
+            measure("writepixelarray", fmts[i].name, ARRAYSIZE * ARRAYSIZE, op_writepixelarray, &p);
+        if (fmts[i].read && selected("readpixelarray"))
+            measure("readpixelarray", fmts[i].name, ARRAYSIZE * ARRAYSIZE, op_readpixelarray, &p);
+    }
+
+    if (selected("writepixelarray"))
+        measure("writepixelarray", "alpha", ARRAYSIZE * ARRAYSIZE, op_writepixelarrayalpha, &p);
+
+    FreeVec(p.buf);
+}
+
+/****************************************************************************************/
+
+struct regions
+{
+    struct Region *a, *b, *tmp;
+};
+
+/* A staggered grid of partly overlapping rectangles */
+static void region_rect(struct Rectangle *r, UWORD n, WORD offset)
+{
+    r->MinX = (n % 8) * 48 + offset;
+    r->MinY = (n / 8) * 40 + (n % 3) * 8 + offset;
+    r->MaxX = r->MinX + 63;
+    r->MaxY = r->MinY + 47;
+}
+
+static void op_region_build(APTR data, ULONG i)
+{
+    struct regions *r = data;
+    struct Rectangle rect;
+    UWORD n;
+
+    ClearRegion(r->tmp);
+    for (n = 0; n < REGIONRECTS; n++)
+    {
+        region_rect(&rect, n, 0);
+        OrRectRegion(r->tmp, &rect);
+    }
+}
+
+/* Each operation starts from a copy of region a, made with OrRegionRegion() */
+static void op_region_or(APTR data, ULONG i)
+{
+    struct regions *r = data;
+
+    ClearRegion(r->tmp);
+    OrRegionRegion(r->a, r->tmp);
+    OrRegionRegion(r->b, r->tmp);
+}
+
+static void op_region_and(APTR data, ULONG i)
+{
+    struct regions *r = data;
+
+    ClearRegion(r->tmp);
+    OrRegionRegion(r->a, r->tmp);
+    AndRegionRegion(r->b, r->tmp);
+}
+
+static void op_region_xor(APTR data, ULONG i)
+{
+    struct regions *r = data;
+
+    ClearRegion(r->tmp);
+    OrRegionRegion(r->a, r->tmp);
+    XorRegionRegion(r->b, r->tmp);
+}
+
+static void op_region_clip(APTR data, ULONG i)
+{
+    struct regions *r = data;
+    struct Rectangle rect;
+
+    region_rect(&rect, i % REGIONRECTS, 5);
+    ClearRegion(r->tmp);
+    OrRegionRegion(r->a, r->tmp);
+    AndRectRegion(r->tmp, &rect);
+}
+
+static void test_region(void)
+{
+    struct regions r;
+    struct Rectangle rect;
+    UWORD n;
+
+    r.a = NewRegion();
+    r.b = NewRegion();
+    r.tmp = NewRegion();
+
+    if (r.a && r.b && r.tmp)
+    {
+        for (n = 0; n < REGIONRECTS; n++)
+        {
+            region_rect(&rect, n, 0);
+            OrRectRegion(r.a, &rect);
+            region_rect(&rect, n, 21);
+            OrRectRegion(r.b, &rect);
+        }
+
+        measure("region", "build64", 0, op_region_build, &r);
+        measure("region", "or", 0, op_region_or, &r);
+        measure("region", "and", 0, op_region_and, &r);
+        measure("region", "xor", 0, op_region_xor, &r);
+        measure("region", "andrect", 0, op_region_clip, &r);
+    }
+
+    if (r.tmp)
+        DisposeRegion(r.tmp);
+    if (r.b)
+        DisposeRegion(r.b);
+    if (r.a)
+        DisposeRegion(r.a);
+}
+
+/****************************************************************************************/
+
+struct layers
+{
+    struct Layer *layer;
+};
+
+/* Back and forth, so the layer never leaves the bitmap */
+static void op_movelayer(APTR data, ULONG i)
+{
+    struct layers *l = data;
+
+    MoveLayer(0, l->layer, (i & 1) ? -16 : 16, (i & 2) ? -8 : 8);
+}
+
+static void layer_moves(CONST_STRPTR variant, ULONG flags, BOOL back)
+{
+    struct Layer *layers[LAYERCOUNT];
+    struct Layer_Info *li;
+    struct BitMap *bm;
+    struct layers l;
+    UWORD i;
+
+    if (!(bm = AllocBitMap(scrw, scrh, GetBitMapAttr(scr->RastPort.BitMap, BMA_DEPTH),
+                           BMF_CLEAR, scr->RastPort.BitMap)))
+        return;
+
+    if ((li = NewLayerInfo()))
+    {
+        memset(layers, 0, sizeof(layers));
+
+        /* A cascade of overlapping windows */
+        for (i = 0; i < LAYERCOUNT; i++)
+        {
+            WORD x = 32 + i * ((scrw - LAYERWIDTH - 64) / LAYERCOUNT);
+            WORD y = 16 + i * ((scrh - LAYERHEIGHT - 32) / LAYERCOUNT);
+
+            layers[i] = CreateUpfrontLayer(li, bm, x, y, x + LAYERWIDTH - 1, y + LAYERHEIGHT - 1,
+                                           flags, NULL);
+            if (!layers[i])
+                break;
+
+            SetAPen(layers[i]->rp, (i + 1) & penmask);
+            RectFill(layers[i]->rp, 0, 0, LAYERWIDTH - 1, LAYERHEIGHT - 1);
+        }
+
+        if (i == LAYERCOUNT)
+        {
+            l.layer = layers[back ? 0 : LAYERCOUNT - 1];
+            measure("layer", variant, LAYERWIDTH * LAYERHEIGHT, op_movelayer, &l);
+        }
+        else
+            printf("# layer: cannot create %s layers\n", variant);
+
+        while (i--)
+            DeleteLayer(0, layers[i]);
+
+        DisposeLayerInfo(li);
+    }
+
+    FreeBitMap(bm);
+}
+
+static void test_layer(void)
+{
+    layer_moves("simple:front", LAYERSIMPLE, FALSE);
+    layer_moves("smart:front", LAYERSMART, FALSE);
+    layer_moves("smart:back", LAYERSMART, TRUE);
+}
+
+/****************************************************************************************/
+
+struct scroll
+{
+    WORD dx, dy;
+    WORD w, h;
+};
+
+static void op_scrollraster(APTR data, ULONG i)
+{
+    struct scroll *s = data;
+
+    /* Alternate the direction, so the content keeps changing */
+    if (i & 1)
+        ScrollRaster(rp, -s->dx, -s->dy, 0, 0, s->w - 1, s->h - 1);
+    else
+        ScrollRaster(rp, s->dx, s->dy, 0, 0, s->w - 1, s->h - 1);
+}
+
+static void test_scroll(void)
+{
+    static const WORD deltas[][2] = { { 0, 1 }, { 1, 0 }, { 0, 16 }, { 8, 8 } };
+    struct scroll s;
+    char variant[32];
+    UWORD i;
+
+    s.w = scrw;
+    s.h = scrh;
+    SetBPen(rp, 0);
+
+    for (i = 0; i < sizeof(deltas) / sizeof(deltas[0]); i++)
+    {
+        s.dx = deltas[i][0];
+        s.dy = deltas[i][1];
+        sprintf(variant, "%d/%d", s.dx, s.dy);
+        measure("scrollraster", variant, s.w * s.h, op_scrollraster, &s);
+    }
+}
+
+/****************************************************************************************/
+
+/*
+ * The headless driver names its modes "Headless:<width>x<height>". Take
+ * the requested size if given, otherwise the largest one.
+ */
+static ULONG find_headless_mode(LONG width, LONG height)
+{
+    struct DimensionInfo dims;
+    struct NameInfo name;
+    ULONG id = INVALID_ID, best = INVALID_ID;
+    LONG bestsize = 0;
+
+    while ((id = NextDisplayInfo(id)) != INVALID_ID)
+    {
+        LONG w, h;
+
+        if (!GetDisplayInfoData(NULL, (UBYTE *)&name, sizeof(name), DTAG_NAME, id) ||
+            !GetDisplayInfoData(NULL, (UBYTE *)&dims, sizeof(dims), DTAG_DIMS, id))
+            continue;
+
+        if (Strnicmp(name.Name, "Headless", 8) != 0)
+            continue;
+
+        w = dims.Nominal.MaxX - dims.Nominal.MinX + 1;
+        h = dims.Nominal.MaxY - dims.Nominal.MinY + 1;
+
+        if ((width && w != width) || (height && h != height))
+            continue;
+
+        if (w * h > bestsize)
+        {
+            best = id;
+            bestsize = w * h;
+        }
+    }
+
+    return best;
+}
+
+int main(void)
+{
+    IPTR args[ARG_COUNT] = { 0 };
+    struct RDArgs *rda;
+    struct NameInfo name;
+    ULONG modeid;
+    LONG width = 0, height = 0, depth = 0;
+    CONST_STRPTR aafont = DEFAULT_AAFONT;
+    UWORD aasize = DEFAULT_AASIZE;
+    int rc = RETURN_OK;
+
+    duration = DEFAULT_TIME / 1000.0;
+
+    if (!(rda = ReadArgs(TEMPLATE, args, NULL)))
+    {
+        PrintFault(IoErr(), "gfxsuite");
+        return RETURN_FAIL;
+    }
+
+    if (args[ARG_TEST] && ParsePatternNoCase((STRPTR)args[ARG_TEST], testpat, sizeof(testpat)) < 0)
+    {
+        printf("Bad TEST pattern\n");
+        FreeArgs(rda);
+        return RETURN_FAIL;
+    }
+    if (args[ARG_TIME])
+        duration = *(LONG *)args[ARG_TIME] / 1000.0;
+    if (args[ARG_WIDTH])
+        width = *(LONG *)args[ARG_WIDTH];
+    if (args[ARG_HEIGHT])
+        height = *(LONG *)args[ARG_HEIGHT];
+    if (args[ARG_DEPTH])
+        depth = *(LONG *)args[ARG_DEPTH];
+    if (args[ARG_AAFONT])
+        aafont = (CONST_STRPTR)args[ARG_AAFONT];
+    if (args[ARG_AASIZE])
+        aasize = *(LONG *)args[ARG_AASIZE];
+
+    if (args[ARG_MODEID])
+        modeid = strtoul((const char *)args[ARG_MODEID], NULL, 16);
+    else
+    {
+        modeid = find_headless_mode(width, height);
+        if (modeid == INVALID_ID && args[ARG_ANYDRIVER])
+        {
+            modeid = BestModeID(BIDTAG_NominalWidth, width ? width : 1024,
+                                BIDTAG_NominalHeight, height ? height : 768,
+                                BIDTAG_Depth, depth ? depth : 24,
+                                TAG_DONE);
+        }
+    }
+
+    if (modeid == INVALID_ID)
+    {
+        printf("No headless display mode found. Add headlessgfx.hidd or use ANYDRIVER.\n");
+        FreeArgs(rda);
+        return RETURN_FAIL;
+    }
+
+    if (!depth)
+    {
+        struct DimensionInfo dims;
+
+        if (GetDisplayInfoData(NULL, (UBYTE *)&dims, sizeof(dims), DTAG_DIMS, modeid))
+            depth = dims.MaxDepth;
+        else
+            depth = 8;
+    }
+
+    scr = OpenScreenTags(NULL,
+                         SA_DisplayID, modeid,
+                         SA_Depth, depth,
+                         width ? SA_Width : TAG_IGNORE, width,
+                         height ? SA_Height : TAG_IGNORE, height,
+                         SA_Type, CUSTOMSCREEN,
+                         SA_Quiet, TRUE,
+                         SA_ShowTitle, FALSE,
+                         TAG_DONE);
+    if (!scr)
+    {
+        printf("Cannot open a screen on mode 0x%08lx, depth %ld\n", (unsigned long)modeid, (long)depth);
+        FreeArgs(rda);
+        return RETURN_FAIL;
+    }
+
+    rp = &scr->RastPort;
+    scrw = scr->Width;
+    scrh = scr->Height;
+    penmask = (1 << ((depth > 8) ? 8 : depth)) - 1;
+
+    if (!GetDisplayInfoData(NULL, (UBYTE *)&name, sizeof(name), DTAG_NAME, modeid))
+        strcpy((char *)name.Name, "unknown");
+
+    printf("# gfxsuite: mode 0x%08lx \"%s\", %dx%d, depth %ld, %.0f ms per test\n",
+           (unsigned long)modeid, name.Name, scrw, scrh, (long)depth, duration * 1000);
+    printf("test,variant,ops,seconds,ops_per_sec,mpixels_per_sec\n");
+
+    if (selected("rectfill"))
+        test_rectfill();
+    if (selected("blit"))
+        test_blit();
+    if (selected("text"))
+        test_text(aafont, aasize);
+    if (selected("writepixelarray") || selected("readpixelarray"))
+        test_pixelarray();
+    if (selected("region"))
+        test_region();
+    if (selected("layer"))
+        test_layer();
+    if (selected("scrollraster"))
+        test_scroll();
+
+    if (aborted)
+    {
+        printf("# aborted\n");
+        rc = RETURN_WARN;
+    }
+
+    CloseScreen(scr);
+    FreeArgs(rda);
+
+    return rc;
+}
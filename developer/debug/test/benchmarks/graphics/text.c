@@ -1,5 +1,5 @@
 /*
-    Copyright (C) 2011, The AROS Development Team. All rights reserved.
+    Copyright (C) 2011-2026, The AROS Development Team. All rights reserved.
 
     Desc: Benchmark for:
           graphics.library/Text
@@ -12,10 +12,16 @@
 
     SYNOPSIS
 
+        WIDTH=W/N/K,HEIGHT=H/N/K,LEN=W/N/K,MODE=P/K,ANTIALIAS/S,STYLE=S/K
+
     LOCATION
 
     FUNCTION
-    
+
+        Fills a window with lines of LEN characters drawn with Text() for
+        two seconds. STYLE takes any combination of the letters B, I and U
+        to render with the algorithmic bold, italic and underline styles.
+
     RESULT
 
     NOTES
@@ -44,13 +50,14 @@
 
 /****************************************************************************************/
 
-#define ARG_TEMPLATE    "WIDTH=W/N/K,HEIGHT=H/N/K,LEN=W/N/K,MODE=P/K,ANTIALIAS/S"
+#define ARG_TEMPLATE    "WIDTH=W/N/K,HEIGHT=H/N/K,LEN=W/N/K,MODE=P/K,ANTIALIAS/S,STYLE=S/K"
 #define ARG_W           0
 #define ARG_H           1
 #define ARG_LEN         2
 #define ARG_MODE        3
 #define ARG_ANTIALIAS   4
-#define NUM_ARGS        5
+#define ARG_STYLE       5
+#define NUM_ARGS        6
 
 /****************************************************************************************/
 
@@ -65,6 +72,8 @@ STRPTR          aa = "NON-ANTIALIASED";
 LONG            mode = JAM1;
 BOOL            antialias = FALSE;
 STRPTR          consttext = "The AROS Development Team. All rights reserved.";
+LONG            style = FS_NORMAL;
+ULONG           textcalls;
 
 struct Window   *win;
 
@@ -121,6 +130,21 @@ static void getarguments(void)
         antialias = (BOOL)args[ARG_ANTIALIAS];
         if (antialias) aa = "ANTIALIASED";
     }
+
+    if (args[ARG_STYLE])
+    {
+        STRPTR c;
+
+        for (c = (STRPTR)args[ARG_STYLE]; *c; c++)
+        {
+            switch (*c)
+            {
+            case 'b': case 'B': style |= FSF_BOLD; break;
+            case 'i': case 'I': style |= FSF_ITALIC; break;
+            case 'u': case 'U': style |= FSF_UNDERLINED; break;
+            }
+        }
+    }
     
 }
 
@@ -131,9 +155,16 @@ static void printresults(LONG t, LONG i)
     QUAD q;
 
     printf("Mode                 : %s, %s\n", modename, aa);
+    printf("Style                : %s%s%s%s\n",
+        style ? "" : "NORMAL",
+        (style & FSF_BOLD) ? "BOLD " : "",
+        (style & FSF_ITALIC) ? "ITALIC " : "",
+        (style & FSF_UNDERLINED) ? "UNDERLINED" : "");
     printf("Elapsed time         : %d us (%f s)\n", (int)t, (double)t / 1000000);
     printf("Blits                : %d\n", (int)i);
     printf("Blits/sec            : %f\n", i * 1000000.0 / t);
+    printf("Text() calls/sec     : %f\n", textcalls * 1000000.0 / t);
+    printf("Characters/sec       : %f\n", textcalls * (double)linelen * 1000000.0 / t);
     printf("Time/blit            : %f us (%f s) (%d%% of 25Hz Frame)\n",
         (double)t / i,
         (double)t / i / 1000000.0,
@@ -213,7 +244,11 @@ static void action_text(void)
     for (i = 0; i < linelen; i++)
         buffer[i] = consttext[i % consttextlen];
 
+    SetSoftStyle(win->RPort, style, AskSoftStyle(win->RPort));
+
     TextExtent(win->RPort, buffer, linelen, &extend);
+
+    textcalls = 0;
     
     for(i = 0; ; i++)
     {
@@ -226,6 +261,7 @@ static void action_text(void)
             {
                 Move(win->RPort, x, y);
                 Text(win->RPort, buffer, linelen);
+                textcalls++;
             }
     }
 
@@ -0,0 +1,300 @@
+/*
+    Copyright (C) 2026, The AROS Development Team. All rights reserved.
+
+    Desc: WaitSelect() versus socket event sets with many idle connections
+*/
+
+/*
+ * Opens CONNECTIONS loopback TCP connections and then, for ROUNDS
+ * rounds, writes one byte to ACTIVE of them and waits until the server
+ * side has read them all. The time per round is measured once with
+ * WaitSelect() over all server descriptors and once with an event set,
+ * which should not depend on the number of idle connections.
+ */
+
+#include <exec/types.h>
+#include <exec/memory.h>
+#include <dos/dos.h>
+#include <proto/exec.h>
+#include <proto/dos.h>
+#include <sys/socket.h>
+#include <sys/time.h>
+#include <sys/select.h>
+#include <sys/ioctl.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <bsdsocket/socketbasetags.h>
+#include <bsdsocket/eventset.h>
+#include <proto/socket.h>
+#include <string.h>
+#include <stdio.h>
+
+#define TEMPLATE            "CONNECTIONS/K/N,ACTIVE/K/N,ROUNDS/K/N"
+#define DEFAULT_CONNECTIONS 1000
+#define DEFAULT_ACTIVE      10
+#define DEFAULT_ROUNDS      1000
+#define MAX_CONNECTIONS     16000
+
+struct Library *SocketBase = NULL;
+
+static LONG *clients, *servers;
+static LONG connections, active, rounds;
+static LONG maxfd;
+
+static double elapsed(struct timeval *start, struct timeval *stop)
+{
+    return (stop->tv_sec - start->tv_sec) + (stop->tv_usec - start->tv_usec) / 1000000.0;
+}
+
+static BOOL open_connections(void)
+{
+    struct sockaddr_in sin;
+    socklen_t len = sizeof(sin);
+    LONG ls, i, one = 1;
+    BOOL ok = FALSE;
+
+    if ((ls = socket(AF_INET, SOCK_STREAM, 0)) < 0)
+        return FALSE;
+
+    memset(&sin, 0, sizeof(sin));
+    sin.sin_len = sizeof(sin);
+    sin.sin_family = AF_INET;
+    sin.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+
+    if (bind(ls, (struct sockaddr *)&sin, sizeof(sin)) == 0 &&
+        getsockname(ls, (struct sockaddr *)&sin, &len) == 0 &&
+        listen(ls, 5) == 0)
+    {
+        for (i = 0; i < connections; i++)
+        {
+            if ((clients[i] = socket(AF_INET, SOCK_STREAM, 0)) < 0 ||
+                connect(clients[i], (struct sockaddr *)&sin, sizeof(sin)) < 0 ||
+                (servers[i] = accept(ls, NULL, NULL)) < 0)
+                break;
+
+            /* The server side is drained without blocking */
+            IoctlSocket(servers[i], FIONBIO, (char *)&one);
+            setsockopt(clients[i], IPPROTO_TCP, TCP_NODELAY, &one, sizeof(one));
+            if (servers[i] > maxfd)
+                maxfd = servers[i];
+        }
+        ok = (i == connections);
+        if (!ok)
+            printf("Only %ld connections could be opened\n", (long)i);
+    }
+
+    CloseSocket(ls);
+    return ok;
+}
+
+static void close_connections(void)
+{
+    LONG i;
+
+    for (i = 0; i < connections; i++)
+    {
+        if (clients[i] >= 0)
+            CloseSocket(clients[i]);
+        if (servers[i] >= 0)
+            CloseSocket(servers[i]);
+    }
+}
+
+/* Write one byte to 'active' connections, spread over all of them */
+static void poke(LONG round)
+{
+    LONG i, step = connections / active;
+    char c = 'x';
+
+    for (i = 0; i < active; i++)
+        send(clients[(round + i * step) % connections], &c, 1, 0);
+}
+
+static LONG drain(LONG fd)
+{
+    char buf[64];
+    LONG n, total = 0;
+
+    while ((n = recv(fd, buf, sizeof(buf), 0)) > 0)
+        total += n;
+    return total;
+}
+
+static BOOL bench_select(void)
+{
+    ULONG setsize = ((maxfd + 1 + 31) / 32) * 4;
+    fd_set *want, *ready;
+    struct timeval start, stop;
+    LONG round, i, n, got;
+    BOOL ok = TRUE;
+
+    want = AllocVec(setsize, MEMF_ANY | MEMF_CLEAR);
+    ready = AllocVec(setsize, MEMF_ANY);
+    if (!want || !ready)
+    {
+        FreeVec(want);
+        FreeVec(ready);
+        return FALSE;
+    }
+
+    for (i = 0; i < connections; i++)
+        FD_SET(servers[i], want);
+
+    gettimeofday(&start, NULL);
+    for (round = 0; ok && round < rounds; round++)
+    {
+        poke(round);
+        for (got = 0; got < active;)
+        {
+            CopyMem(want, ready, setsize);
+            if ((n = WaitSelect(maxfd + 1, ready, NULL, NULL, NULL, NULL)) <= 0)
+            {
+                ok = FALSE;
+                break;
+            }
+            for (i = 0; i < connections && n > 0; i++)
+            {
+                if (FD_ISSET(servers[i], ready))
+                {
+                    got += drain(servers[i]);
+                    n--;
+                }
+            }
+        }
+    }
+    gettimeofday(&stop, NULL);
+
+    if (ok)
+        printf("WaitSelect():         %8.1f us per round\n",
+               elapsed(&start, &stop) * 1000000.0 / rounds);
+    else
+        printf("WaitSelect():         failed\n");
+
+    FreeVec(want);
+    FreeVec(ready);
+    return ok;
+}
+
+static BOOL bench_eventset(BOOL edge)
+{
+    struct SocketEvent ev, *events;
+    struct timeval start, stop;
+    LONG set, round, i, n, got;
+    BOOL ok = TRUE;
+
+    if ((set = CreateSocketEventSet(0)) < 0)
+    {
+        printf("CreateSocketEventSet() failed\n");
+        return FALSE;
+    }
+    if (!(events = AllocVec(active * sizeof(*events), MEMF_ANY)))
+    {
+        DeleteSocketEventSet(set);
+        return FALSE;
+    }
+
+    for (i = 0; ok && i < connections; i++)
+    {
+        ev.se_Events = FD_READ | (edge ? SEVF_EDGE : 0);
+        ev.se_UserData = i;
+        if (ModifySocketEventSet(set, SEVOP_ADD, servers[i], &ev) < 0)
+            ok = FALSE;
+    }
+
+    gettimeofday(&start, NULL);
+    for (round = 0; ok && round < rounds; round++)
+    {
+        poke(round);
+        for (got = 0; got < active;)
+        {
+            if ((n = WaitSocketEventSet(set, events, active, NULL, NULL)) <= 0)
+            {
+                ok = FALSE;
+                break;
+            }
+            for (i = 0; i < n; i++)
+                got += drain(servers[events[i].se_UserData]);
+        }
+    }
+    gettimeofday(&stop, NULL);
+
+    if (ok)
+        printf("Event set (%s): %8.1f us per round\n", edge ? "edge " : "level",
+               elapsed(&start, &stop) * 1000000.0 / rounds);
+    else
+        printf("Event set (%s): failed\n", edge ? "edge " : "level");
+
+    FreeVec(events);
+    DeleteSocketEventSet(set);
+    return ok;
+}
+
+int main(void)
+{
+    struct RDArgs *rdargs;
+    IPTR args[3] = { 0, 0, 0 };
+    int rc = RETURN_OK;
+    LONG i;
+
+    if (!(rdargs = ReadArgs(TEMPLATE, args, NULL)))
+    {
+        PrintFault(IoErr(), "c10k");
+        return RETURN_FAIL;
+    }
+    connections = args[0] ? *(LONG *)args[0] : DEFAULT_CONNECTIONS;
+    active = args[1] ? *(LONG *)args[1] : DEFAULT_ACTIVE;
+    rounds = args[2] ? *(LONG *)args[2] : DEFAULT_ROUNDS;
+    FreeArgs(rdargs);
+
+    if (connections < 1 || connections > MAX_CONNECTIONS ||
+        active < 1 || active > connections || rounds < 1)
+    {
+        printf("CONNECTIONS must be 1 to %d, ACTIVE 1 to CONNECTIONS and ROUNDS at least 1\n",
+               MAX_CONNECTIONS);
+        return RETURN_FAIL;
+    }
+
+    if (!(SocketBase = OpenLibrary("bsdsocket.library", 4)))
+    {
+        printf("Cannot open bsdsocket.library\n");
+        return RETURN_FAIL;
+    }
+    if (SocketBase->lib_Version == 4 && SocketBase->lib_Revision < 60)
+    {
+        printf("bsdsocket.library 4.60 or newer is needed for event sets\n");
+        CloseLibrary(SocketBase);
+        return RETURN_FAIL;
+    }
+
+    /* Both ends of every connection live in this task */
+    SocketBaseTags(SBTM_SETVAL(SBTC_DTABLESIZE), 2 * connections + 8, TAG_DONE);
+
+    clients = AllocVec(connections * sizeof(LONG), MEMF_ANY);
+    servers = AllocVec(connections * sizeof(LONG), MEMF_ANY);
+    if (clients && servers)
+    {
+        for (i = 0; i < connections; i++)
+            clients[i] = servers[i] = -1;
+
+        printf("%ld connections, %ld active per round, %ld rounds\n",
+               (long)connections, (long)active, (long)rounds);
+
+        if (open_connections())
+        {
+            if (!bench_select() || !bench_eventset(FALSE) || !bench_eventset(TRUE))
+                rc = RETURN_WARN;
+        }
+        else
+            rc = RETURN_FAIL;
+
+        close_connections();
+    }
+    else
+        rc = RETURN_FAIL;
+
+    FreeVec(clients);
+    FreeVec(servers);
+    CloseLibrary(SocketBase);
+
+    return rc;
+}
@@ -0,0 +1,225 @@
+/*
+    Copyright (C) 2026, The AROS Development Team. All rights reserved.
+
+    Desc: Internet checksum and copy-and-checksum throughput
+*/
+
+/*
+ * Builds the checksum routines of AROSTCP (netinet/in_cksum.h) and
+ * compares them with the 16-bit BSD routine the stack used before: the
+ * plain sum, and copying a packet into a buffer with and without
+ * summing it at the same time. All variants are first checked against
+ * each other for every alignment and many lengths. No network stack is
+ * needed.
+ */
+
+#include <exec/types.h>
+#include <exec/memory.h>
+#include <dos/dos.h>
+#include <proto/exec.h>
+#include <proto/dos.h>
+#include <sys/types.h>
+#include <sys/time.h>
+#include <string.h>
+#include <stdio.h>
+
+#include "in_cksum.h"
+
+#define TEMPLATE        "SIZE/K/N"
+#define DEFAULT_SIZE    256     /* megabytes summed per test */
+#define BUFFER_SIZE     (64 * 1024 + 8)
+
+static const LONG lengths[] = { 40, 576, 1500, 9000, 65536 };
+
+static double elapsed(struct timeval *start, struct timeval *stop)
+{
+    return (stop->tv_sec - start->tv_sec) + (stop->tv_usec - start->tv_usec) / 1000000.0;
+}
+
+/*
+ * The portable routine from 4.3BSD, reduced to a single buffer
+ */
+static u_int bsd_cksum(const void *buf, LONG len)
+{
+    const u_short *w = buf;
+    ULONG sum = 0;
+    union
+    {
+        u_char  c[2];
+        u_short s;
+    } s_util;
+
+    while ((len -= 32) >= 0)
+    {
+        sum += w[0]; sum += w[1]; sum += w[2]; sum += w[3];
+        sum += w[4]; sum += w[5]; sum += w[6]; sum += w[7];
+        sum += w[8]; sum += w[9]; sum += w[10]; sum += w[11];
+        sum += w[12]; sum += w[13]; sum += w[14]; sum += w[15];
+        w += 16;
+    }
+    len += 32;
+    while ((len -= 2) >= 0)
+        sum += *w++;
+    if (len == -1)
+    {
+        s_util.c[0] = *(const u_char *)w;
+        s_util.c[1] = 0;
+        sum += s_util.s;
+    }
+    sum = (sum >> 16) + (sum & 0xffff);
+    sum += sum >> 16;
+    return sum & 0xffff;
+}
+
+/* One's complement values are equal modulo 0xffff, 0 and 0xffff alike */
+static BOOL same_sum(u_int a, u_int b)
+{
+    return a % 0xffff == b % 0xffff;
+}
+
+static BOOL verify(UBYTE *src, UBYTE *dst)
+{
+    LONG len, soff, doff;
+    u_int ref;
+
+    for (len = 0; len <= 2048; len += (len < 128) ? 1 : 61)
+    {
+        for (soff = 0; soff < 8; soff++)
+        {
+            /* The 16-bit routine needs an even start, move the data there */
+            CopyMem(src + soff, dst, len);
+            ref = bsd_cksum(dst, len);
+
+            if (!same_sum(in_cksum_block(src + soff, len), ref))
+            {
+                printf("in_cksum_block() wrong, length %ld, offset %ld\n",
+                       (long)len, (long)soff);
+                return FALSE;
+            }
+            for (doff = 0; doff < 8; doff++)
+            {
+                memset(dst, 0, len + 16);
+                if (!same_sum(in_cksum_copy(src + soff, dst + doff, len), ref) ||
+                    memcmp(src + soff, dst + doff, len) != 0)
+                {
+                    printf("in_cksum_copy() wrong, length %ld, offsets %ld/%ld\n",
+                           (long)len, (long)soff, (long)doff);
+                    return FALSE;
+                }
+            }
+        }
+    }
+    return TRUE;
+}
+
+enum { T_BSD, T_BLOCK, T_COPY_THEN_SUM, T_COPY_AND_SUM, T_MAX };
+
+static const char *names[T_MAX] =
+{
+    "BSD 16-bit sum",
+    "in_cksum_block()",
+    "CopyMem() + sum",
+    "in_cksum_copy()"
+};
+
+static double run(int test, UBYTE *src, UBYTE *dst, LONG len, UQUAD total)
+{
+    struct timeval start, stop;
+    UQUAD done;
+    volatile u_int sink = 0;
+    double secs;
+
+    gettimeofday(&start, NULL);
+    for (done = 0; done < total; done += len)
+    {
+        switch (test)
+        {
+        case T_BSD:
+            sink += bsd_cksum(src, len);
+            break;
+        case T_BLOCK:
+            sink += in_cksum_block(src, len);
+            break;
+        case T_COPY_THEN_SUM:
+            CopyMem(src, dst, len);
+            sink += in_cksum_block(dst, len);
+            break;
+        case T_COPY_AND_SUM:
+            sink += in_cksum_copy(src, dst, len);
+            break;
+        }
+    }
+    gettimeofday(&stop, NULL);
+
+    secs = elapsed(&start, &stop);
+    return secs > 0 ? total / secs / (1024 * 1024) : 0;
+}
+
+int main(void)
+{
+    struct RDArgs *rdargs;
+    IPTR args[1] = { 0 };
+    ULONG size = DEFAULT_SIZE;
+    UBYTE *src, *dst;
+    LONG i, t;
+    int rc = RETURN_OK;
+
+    if (!(rdargs = ReadArgs(TEMPLATE, args, NULL)))
+    {
+        PrintFault(IoErr(), "cksum");
+        return RETURN_FAIL;
+    }
+    if (args[0])
+        size = *(LONG *)args[0];
+    FreeArgs(rdargs);
+
+    if (size == 0)
+    {
+        printf("SIZE must not be 0\n");
+        return RETURN_FAIL;
+    }
+
+    src = AllocVec(BUFFER_SIZE, MEMF_ANY);
+    dst = AllocVec(BUFFER_SIZE + 16, MEMF_ANY);
+    if (!src || !dst)
+    {
+        printf("Not enough memory\n");
+        FreeVec(src);
+        FreeVec(dst);
+        return RETURN_FAIL;
+    }
+    for (i = 0; i < BUFFER_SIZE; i++)
+        src[i] = (UBYTE)(i * 131 + (i >> 8));
+
+    if (!verify(src, dst))
+        rc = RETURN_ERROR;
+    else
+    {
+#if IN_CKSUM_SSE2
+        printf("Checksum with SSE2");
+#elif IN_CKSUM_NEON
+        printf("Checksum with NEON");
+#else
+        printf("Checksum with 32-bit words");
+#endif
+        printf(", %lu MB per test, MB/s\n\n", (unsigned long)size);
+
+        printf("%-18s", "Length");
+        for (i = 0; i < sizeof(lengths) / sizeof(lengths[0]); i++)
+            printf(" %9ld", (long)lengths[i]);
+        printf("\n");
+
+        for (t = 0; t < T_MAX; t++)
+        {
+            printf("%-18s", names[t]);
+            for (i = 0; i < sizeof(lengths) / sizeof(lengths[0]); i++)
+                printf(" %9.1f", run(t, src, dst, lengths[i], (UQUAD)size << 20));
+            printf("\n");
+        }
+    }
+
+    FreeVec(src);
+    FreeVec(dst);
+
+    return rc;
+}
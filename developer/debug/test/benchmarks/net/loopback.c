@@ -0,0 +1,405 @@
+/*
+    Copyright (C) 2026, The AROS Development Team. All rights reserved.
+
+    Desc: TCP throughput and UDP latency over the loopback interface
+*/
+
+/*
+ * Every TCP stream is a pair of processes, one sending and one receiving,
+ * so running several streams at once shows how well socket calls made by
+ * different tasks proceed in parallel inside the TCP/IP stack. The UDP
+ * test bounces a small datagram between two processes and reports the
+ * average round trip time.
+ */
+
+#include <exec/types.h>
+#include <dos/dos.h>
+#include <dos/dostags.h>
+#include <proto/exec.h>
+#include <proto/dos.h>
+#include <sys/socket.h>
+#include <sys/time.h>
+#include <netinet/in.h>
+#include <proto/socket.h>
+#include <string.h>
+#include <stdio.h>
+
+#define TEMPLATE        "SIZE/K/N,STREAMS/K/N,ROUNDS/K/N"
+#define DEFAULT_SIZE    64      /* megabytes per stream */
+#define DEFAULT_STREAMS 1
+#define DEFAULT_ROUNDS  10000
+#define MAX_STREAMS     16
+#define BUFFER_SIZE     32768
+
+#define SIGF_READY      SIGBREAKF_CTRL_F
+
+struct Library *SocketBase = NULL;
+
+struct stream
+{
+    struct Task *parent;
+    struct Task *child;
+    UWORD        port;
+    ULONG        rounds;
+    UQUAD        size;
+    UQUAD        received;
+    LONG         error;
+    UBYTE        buffer[BUFFER_SIZE];
+};
+
+static struct stream streams[MAX_STREAMS];
+
+static double elapsed(struct timeval *start, struct timeval *stop)
+{
+    return (stop->tv_sec - start->tv_sec) + (stop->tv_usec - start->tv_usec) / 1000000.0;
+}
+
+static LONG bind_loopback(struct Library *SocketBase, LONG type, UWORD *port)
+{
+    struct sockaddr_in sin;
+    socklen_t len = sizeof(sin);
+    LONG s;
+
+    if ((s = socket(AF_INET, type, 0)) < 0)
+        return -1;
+
+    memset(&sin, 0, sizeof(sin));
+    sin.sin_len = sizeof(sin);
+    sin.sin_family = AF_INET;
+    sin.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+
+    if (bind(s, (struct sockaddr *)&sin, sizeof(sin)) < 0 ||
+        getsockname(s, (struct sockaddr *)&sin, &len) < 0 ||
+        (type == SOCK_STREAM && listen(s, 1) < 0))
+    {
+        CloseSocket(s);
+        return -1;
+    }
+
+    *port = ntohs(sin.sin_port);
+    return s;
+}
+
+static void loopback_address(struct sockaddr_in *sin, UWORD port)
+{
+    memset(sin, 0, sizeof(*sin));
+    sin->sin_len = sizeof(*sin);
+    sin->sin_family = AF_INET;
+    sin->sin_port = htons(port);
+    sin->sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+}
+
+static void receiver(void)
+{
+    struct stream *st = FindTask(NULL)->tc_UserData;
+    struct Library *SocketBase;
+    LONG ls, s = -1, n;
+
+    if (!(SocketBase = OpenLibrary("bsdsocket.library", 4)))
+    {
+        st->error = 1;
+        Signal(st->parent, SIGF_READY);
+        return;
+    }
+
+    ls = bind_loopback(SocketBase, SOCK_STREAM, &st->port);
+    if (ls < 0)
+        st->error = 1;
+    Signal(st->parent, SIGF_READY);
+
+    if (ls >= 0 && (s = accept(ls, NULL, NULL)) >= 0)
+    {
+        while ((n = recv(s, st->buffer, BUFFER_SIZE, 0)) > 0)
+            st->received += n;
+        if (n < 0)
+            st->error = 1;
+        CloseSocket(s);
+    }
+    if (ls >= 0)
+        CloseSocket(ls);
+
+    CloseLibrary(SocketBase);
+}
+
+static void sender(void)
+{
+    struct stream *st = FindTask(NULL)->tc_UserData;
+    struct Library *SocketBase;
+    struct sockaddr_in sin;
+    UBYTE buffer[1024];
+    UQUAD left = st->size;
+    LONG s, n;
+
+    if (!(SocketBase = OpenLibrary("bsdsocket.library", 4)))
+    {
+        st->error = 1;
+        return;
+    }
+
+    /* The receiver owns the stream buffer, so send from a small one */
+    memset(buffer, 0x55, sizeof(buffer));
+
+    loopback_address(&sin, st->port);
+    if ((s = socket(AF_INET, SOCK_STREAM, 0)) >= 0)
+    {
+        if (connect(s, (struct sockaddr *)&sin, sizeof(sin)) == 0)
+        {
+            while (left > 0)
+            {
+                n = send(s, buffer, left < sizeof(buffer) ? left : sizeof(buffer), 0);
+                if (n <= 0)
+                {
+                    st->error = 1;
+                    break;
+                }
+                left -= n;
+            }
+        }
+        else
+            st->error = 1;
+        CloseSocket(s);
+    }
+    else
+        st->error = 1;
+
+    CloseLibrary(SocketBase);
+}
+
+static void echo(void)
+{
+    struct stream *st = FindTask(NULL)->tc_UserData;
+    struct Library *SocketBase;
+    struct sockaddr_in from;
+    socklen_t len;
+    ULONG i;
+    LONG s, n;
+
+    if (!(SocketBase = OpenLibrary("bsdsocket.library", 4)))
+    {
+        st->error = 1;
+        Signal(st->parent, SIGF_READY);
+        return;
+    }
+
+    s = bind_loopback(SocketBase, SOCK_DGRAM, &st->port);
+    if (s < 0)
+        st->error = 1;
+    Signal(st->parent, SIGF_READY);
+
+    if (s >= 0)
+    {
+        for (i = 0; i < st->rounds; i++)
+        {
+            len = sizeof(from);
+            n = recvfrom(s, st->buffer, BUFFER_SIZE, 0, (struct sockaddr *)&from, &len);
+            if (n < 0 || sendto(s, st->buffer, n, 0, (struct sockaddr *)&from, len) != n)
+            {
+                st->error = 1;
+                break;
+            }
+        }
+        CloseSocket(s);
+    }
+
+    CloseLibrary(SocketBase);
+}
+
+static ULONG start_child(void (*entry)(void), CONST_STRPTR name, struct stream *st, struct Task **task)
+{
+    struct Process *proc;
+
+    proc = CreateNewProcTags(NP_Entry,         (IPTR)entry,
+                             NP_Name,          (IPTR)name,
+                             NP_UserData,      (IPTR)st,
+                             NP_NotifyOnDeath, TRUE,
+                             NP_StackSize,     65536,
+                             TAG_DONE);
+    if (!proc)
+        return 0;
+
+    if (task)
+        *task = &proc->pr_Task;
+    return GetETask(proc)->et_UniqueID;
+}
+
+static void wait_children(ULONG *ids, LONG count)
+{
+    LONG i;
+
+    for (i = 0; i < count; i++)
+    {
+        if (ids[i] != 0)
+        {
+            ChildWait(ids[i]);
+            ChildFree(ids[i]);
+        }
+    }
+}
+
+static BOOL tcp_throughput(LONG count, ULONG size)
+{
+    ULONG ids[2 * MAX_STREAMS];
+    struct timeval start, stop;
+    UQUAD total = 0;
+    double secs;
+    LONG i;
+    BOOL ok = TRUE;
+
+    memset(ids, 0, sizeof(ids));
+    SetSignal(0, SIGF_READY);
+
+    for (i = 0; i < count; i++)
+    {
+        streams[i].parent = FindTask(NULL);
+        streams[i].size = (UQUAD)size << 20;
+        if (!(ids[i] = start_child(receiver, "loopback receiver", &streams[i], &streams[i].child)))
+        {
+            ok = FALSE;
+            break;
+        }
+        Wait(SIGF_READY);
+        if (streams[i].error)
+        {
+            ok = FALSE;
+            break;
+        }
+    }
+
+    gettimeofday(&start, NULL);
+    for (i = 0; ok && i < count; i++)
+    {
+        if (!(ids[count + i] = start_child(sender, "loopback sender", &streams[i], NULL)))
+            ok = FALSE;
+    }
+    /* A receiver without a sender would wait in accept() forever; the
+       default break mask makes the call fail with EINTR instead */
+    if (!ok)
+    {
+        for (i = 0; i < count; i++)
+            if (ids[i] != 0 && ids[count + i] == 0)
+                Signal(streams[i].child, SIGBREAKF_CTRL_C);
+    }
+    wait_children(ids, 2 * count);
+    gettimeofday(&stop, NULL);
+
+    for (i = 0; i < count; i++)
+    {
+        if (streams[i].error || streams[i].received != streams[i].size)
+            ok = FALSE;
+        total += streams[i].received;
+    }
+
+    secs = elapsed(&start, &stop);
+    if (ok && secs > 0)
+        printf("TCP %ld stream%s: %.2f MB/s\n", (long)count, count == 1 ? "" : "s",
+               total / 1048576.0 / secs);
+    else
+        printf("TCP %ld stream%s: failed\n", (long)count, count == 1 ? "" : "s");
+
+    return ok;
+}
+
+static BOOL udp_latency(ULONG rounds)
+{
+    struct stream *st = &streams[0];
+    struct sockaddr_in sin;
+    struct timeval start, stop;
+    ULONG id, i;
+    LONG s;
+    BOOL ok = FALSE;
+
+    memset(st, 0, sizeof(*st));
+    st->parent = FindTask(NULL);
+    st->rounds = rounds;
+    SetSignal(0, SIGF_READY);
+
+    if (!(id = start_child(echo, "loopback echo", st, &st->child)))
+        return FALSE;
+    Wait(SIGF_READY);
+
+    if (!st->error && (s = socket(AF_INET, SOCK_DGRAM, 0)) >= 0)
+    {
+        UBYTE ping[32];
+
+        memset(ping, 0xaa, sizeof(ping));
+        loopback_address(&sin, st->port);
+
+        gettimeofday(&start, NULL);
+        for (i = 0; i < rounds; i++)
+        {
+            if (sendto(s, ping, sizeof(ping), 0, (struct sockaddr *)&sin, sizeof(sin)) != sizeof(ping) ||
+                recv(s, ping, sizeof(ping), 0) != sizeof(ping))
+                break;
+        }
+        gettimeofday(&stop, NULL);
+        CloseSocket(s);
+
+        if (i == rounds)
+        {
+            printf("UDP round trip: %.1f us\n", elapsed(&start, &stop) * 1000000.0 / rounds);
+            ok = TRUE;
+        }
+    }
+
+    if (!ok)
+    {
+        printf("UDP round trip: failed\n");
+        Signal(st->child, SIGBREAKF_CTRL_C);
+    }
+    wait_children(&id, 1);
+
+    return ok;
+}
+
+int main(void)
+{
+    struct RDArgs *rdargs;
+    IPTR args[3] = { 0, 0, 0 };
+    ULONG size = DEFAULT_SIZE, rounds = DEFAULT_ROUNDS;
+    LONG count = DEFAULT_STREAMS, n;
+    int rc = RETURN_OK;
+
+    if (!(rdargs = ReadArgs(TEMPLATE, args, NULL)))
+    {
+        PrintFault(IoErr(), "loopback");
+        return RETURN_FAIL;
+    }
+    if (args[0])
+        size = *(LONG *)args[0];
+    if (args[1])
+        count = *(LONG *)args[1];
+    if (args[2])
+        rounds = *(LONG *)args[2];
+    FreeArgs(rdargs);
+
+    if (count < 1 || count > MAX_STREAMS || size == 0 || rounds == 0)
+    {
+        printf("STREAMS must be 1 to %d, SIZE and ROUNDS must not be 0\n", MAX_STREAMS);
+        return RETURN_FAIL;
+    }
+
+    if (!(SocketBase = OpenLibrary("bsdsocket.library", 4)))
+    {
+        printf("Cannot open bsdsocket.library\n");
+        return RETURN_FAIL;
+    }
+
+    printf("Loopback benchmark, %lu MB per stream\n", (unsigned long)size);
+
+    /* One stream first, then as many as asked for, to see the scaling */
+    for (n = 1; n <= count; n = (n < count && n * 2 > count) ? count : n * 2)
+    {
+        memset(streams, 0, sizeof(streams));
+        if (!tcp_throughput(n, size))
+            rc = RETURN_WARN;
+        if (n == count)
+            break;
+    }
+
+    if (!udp_latency(rounds))
+        rc = RETURN_WARN;
+
+    CloseLibrary(SocketBase);
+
+    return rc;
+}
@@ -0,0 +1,365 @@
+/*
+    Copyright (C) 2026, The AROS Development Team. All rights reserved.
+
+    Desc: TCP throughput over a lossy loopback interface
+*/
+
+/*
+ * Makes AROSTCP drop a share of the loopback packets (the LOOPBACK_LOSS
+ * variable) and measures one TCP stream with every combination of the
+ * congestion control algorithm (TCP_CC) and selective acknowledgements
+ * (TCP_SACK). The variables are set through the ARexx port of the stack,
+ * so this only works with AROSTCP. The original settings are restored
+ * at the end.
+ */
+
+#include <exec/types.h>
+#include <dos/dos.h>
+#include <dos/dostags.h>
+#include <rexx/storage.h>
+#include <rexx/errors.h>
+#include <proto/exec.h>
+#include <proto/dos.h>
+#include <proto/rexxsyslib.h>
+#include <sys/socket.h>
+#include <sys/time.h>
+#include <netinet/in.h>
+#include <proto/socket.h>
+#include <string.h>
+#include <stdio.h>
+#include <stdlib.h>
+
+#define TEMPLATE        "SIZE/K/N,LOSS/K/N,BUFFER/K/N"
+#define DEFAULT_SIZE    8       /* megabytes per run */
+#define DEFAULT_LOSS    10      /* packets per thousand */
+#define DEFAULT_BUFFER  256     /* kilobytes of socket buffer */
+#define COPY_SIZE       32768
+#define STACK_PORT      "AROSTCP"
+
+#define SIGF_READY      SIGBREAKF_CTRL_F
+
+struct Library *SocketBase = NULL;
+struct RxsLib *RexxSysBase = NULL;
+
+struct stream
+{
+    struct Task *parent;
+    struct Task *child;
+    UWORD        port;
+    LONG         bufsize;
+    UQUAD        received;
+    LONG         error;
+    UBYTE        buffer[COPY_SIZE];
+};
+
+static struct stream stream;
+
+static double elapsed(struct timeval *start, struct timeval *stop)
+{
+    return (stop->tv_sec - start->tv_sec) + (stop->tv_usec - start->tv_usec) / 1000000.0;
+}
+
+/*
+ * Send a command to the ARexx port of the stack. The result string, if
+ * asked for, is copied to result.
+ */
+static LONG stack_command(CONST_STRPTR command, STRPTR result, LONG size)
+{
+    struct MsgPort *reply, *port;
+    struct RexxMsg *rm;
+    LONG rc = RC_FATAL;
+
+    if (!(reply = CreateMsgPort()))
+        return rc;
+
+    if ((rm = CreateRexxMsg(reply, NULL, NULL)))
+    {
+        rm->rm_Args[0] = (IPTR)CreateArgstring(command, strlen(command));
+        rm->rm_Action = RXCOMM | (result ? RXFF_RESULT : 0);
+
+        if (rm->rm_Args[0])
+        {
+            Forbid();
+            if ((port = FindPort(STACK_PORT)))
+                PutMsg(port, &rm->rm_Node);
+            Permit();
+
+            if (port)
+            {
+                WaitPort(reply);
+                GetMsg(reply);
+                rc = rm->rm_Result1;
+                if (rc == RC_OK && result && rm->rm_Result2)
+                {
+                    strncpy(result, (STRPTR)rm->rm_Result2, size - 1);
+                    result[size - 1] = '\0';
+                    DeleteArgstring((UBYTE *)rm->rm_Result2);
+                }
+            }
+            DeleteArgstring((UBYTE *)rm->rm_Args[0]);
+        }
+        DeleteRexxMsg(rm);
+    }
+
+    DeleteMsgPort(reply);
+    return rc;
+}
+
+static BOOL stack_set(CONST_STRPTR var, CONST_STRPTR value)
+{
+    char command[80];
+
+    snprintf(command, sizeof(command), "SET %s=%s", var, value);
+    return stack_command(command, NULL, 0) == RC_OK;
+}
+
+static BOOL stack_query(CONST_STRPTR var, STRPTR value, LONG size)
+{
+    char command[80];
+
+    snprintf(command, sizeof(command), "QUERY %s", var);
+    return stack_command(command, value, size) == RC_OK;
+}
+
+static ULONG stack_counter(CONST_STRPTR var)
+{
+    char value[32];
+
+    return stack_query(var, value, sizeof(value)) ? strtoul(value, NULL, 10) : 0;
+}
+
+static void set_buffers(LONG s, LONG size)
+{
+    setsockopt(s, SOL_SOCKET, SO_SNDBUF, &size, sizeof(size));
+    setsockopt(s, SOL_SOCKET, SO_RCVBUF, &size, sizeof(size));
+}
+
+static void receiver(void)
+{
+    struct stream *st = FindTask(NULL)->tc_UserData;
+    struct Library *SocketBase;
+    struct sockaddr_in sin;
+    socklen_t len = sizeof(sin);
+    LONG ls, s, n;
+
+    if (!(SocketBase = OpenLibrary("bsdsocket.library", 4)))
+    {
+        st->error = 1;
+        Signal(st->parent, SIGF_READY);
+        return;
+    }
+
+    memset(&sin, 0, sizeof(sin));
+    sin.sin_len = sizeof(sin);
+    sin.sin_family = AF_INET;
+    sin.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+
+    /* The accepted socket inherits the buffers, and with them the
+       window scale offered in the SYN,ACK */
+    if ((ls = socket(AF_INET, SOCK_STREAM, 0)) >= 0)
+    {
+        set_buffers(ls, st->bufsize);
+        if (bind(ls, (struct sockaddr *)&sin, sizeof(sin)) < 0 ||
+            getsockname(ls, (struct sockaddr *)&sin, &len) < 0 ||
+            listen(ls, 1) < 0)
+        {
+            CloseSocket(ls);
+            ls = -1;
+        }
+    }
+    if (ls < 0)
+        st->error = 1;
+    else
+        st->port = ntohs(sin.sin_port);
+    Signal(st->parent, SIGF_READY);
+
+    if (ls >= 0 && (s = accept(ls, NULL, NULL)) >= 0)
+    {
+        while ((n = recv(s, st->buffer, COPY_SIZE, 0)) > 0)
+            st->received += n;
+        if (n < 0)
+            st->error = 1;
+        CloseSocket(s);
+    }
+    if (ls >= 0)
+        CloseSocket(ls);
+
+    CloseLibrary(SocketBase);
+}
+
+static BOOL send_stream(struct stream *st, UQUAD size)
+{
+    struct sockaddr_in sin;
+    UBYTE buffer[4096];
+    LONG s, n;
+    BOOL ok = FALSE;
+
+    memset(buffer, 0x55, sizeof(buffer));
+    memset(&sin, 0, sizeof(sin));
+    sin.sin_len = sizeof(sin);
+    sin.sin_family = AF_INET;
+    sin.sin_port = htons(st->port);
+    sin.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+
+    if ((s = socket(AF_INET, SOCK_STREAM, 0)) < 0)
+        return FALSE;
+
+    set_buffers(s, st->bufsize);
+    if (connect(s, (struct sockaddr *)&sin, sizeof(sin)) == 0)
+    {
+        while (size > 0)
+        {
+            n = send(s, buffer, size < sizeof(buffer) ? size : sizeof(buffer), 0);
+            if (n <= 0)
+                break;
+            size -= n;
+        }
+        ok = (size == 0);
+    }
+    CloseSocket(s);
+    return ok;
+}
+
+static BOOL run(CONST_STRPTR cc, BOOL sack, LONG loss, ULONG size, LONG bufsize)
+{
+    struct Process *proc;
+    struct timeval start, stop;
+    ULONG id, rexmit, recoveries;
+    char value[16];
+    double secs;
+    BOOL ok;
+
+    snprintf(value, sizeof(value), "%ld", (long)loss);
+    if (!stack_set("TCP_CC", cc) || !stack_set("TCP_SACK", sack ? "YES" : "NO") ||
+        !stack_set("LOOPBACK_LOSS", value))
+    {
+        printf("Cannot configure the stack through the %s port\n", STACK_PORT);
+        return FALSE;
+    }
+
+    memset(&stream, 0, sizeof(stream));
+    stream.parent = FindTask(NULL);
+    stream.bufsize = bufsize;
+    SetSignal(0, SIGF_READY);
+
+    proc = CreateNewProcTags(NP_Entry,         (IPTR)receiver,
+                             NP_Name,          (IPTR)"lossy receiver",
+                             NP_UserData,      (IPTR)&stream,
+                             NP_NotifyOnDeath, TRUE,
+                             NP_StackSize,     65536,
+                             TAG_DONE);
+    if (!proc)
+        return FALSE;
+    stream.child = &proc->pr_Task;
+    id = GetETask(proc)->et_UniqueID;
+    Wait(SIGF_READY);
+
+    rexmit = stack_counter("TCP SREB");
+    recoveries = stack_counter("TCP FR");
+
+    gettimeofday(&start, NULL);
+    ok = !stream.error && send_stream(&stream, (UQUAD)size << 20);
+    /* A receiver that was never connected to would wait in accept()
+       forever; the default break mask makes the call fail with EINTR */
+    if (!ok)
+        Signal(stream.child, SIGBREAKF_CTRL_C);
+    ChildWait(id);
+    ChildFree(id);
+    gettimeofday(&stop, NULL);
+
+    rexmit = stack_counter("TCP SREB") - rexmit;
+    recoveries = stack_counter("TCP FR") - recoveries;
+    stack_set("LOOPBACK_LOSS", "0");
+
+    if (stream.error || stream.received != (UQUAD)size << 20)
+        ok = FALSE;
+
+    secs = elapsed(&start, &stop);
+    if (ok && secs > 0)
+        printf("%-7s %-7s %4ld/1000: %8.2f MB/s, %9lu bytes retransmitted, %5lu fast recoveries\n",
+               cc, sack ? "SACK" : "no SACK", (long)loss, size / secs,
+               (unsigned long)rexmit, (unsigned long)recoveries);
+    else
+        printf("%-7s %-7s %4ld/1000: failed\n", cc, sack ? "SACK" : "no SACK", (long)loss);
+
+    return ok;
+}
+
+int main(void)
+{
+    static CONST_STRPTR algorithms[] = { "NEWRENO", "CUBIC" };
+    struct RDArgs *rdargs;
+    IPTR args[3] = { 0, 0, 0 };
+    ULONG size = DEFAULT_SIZE;
+    LONG loss = DEFAULT_LOSS, bufsize = DEFAULT_BUFFER, pass, i, sack;
+    char old_cc[16], old_sack[16], old_loss[16];
+    int rc = RETURN_OK;
+
+    if (!(rdargs = ReadArgs(TEMPLATE, args, NULL)))
+    {
+        PrintFault(IoErr(), "lossy");
+        return RETURN_FAIL;
+    }
+    if (args[0])
+        size = *(LONG *)args[0];
+    if (args[1])
+        loss = *(LONG *)args[1];
+    if (args[2])
+        bufsize = *(LONG *)args[2];
+    FreeArgs(rdargs);
+
+    if (size == 0 || loss < 0 || loss > 500 || bufsize < 4)
+    {
+        printf("SIZE must not be 0, LOSS must be 0 to 500 and BUFFER at least 4\n");
+        return RETURN_FAIL;
+    }
+
+    if (!(RexxSysBase = (struct RxsLib *)OpenLibrary("rexxsyslib.library", 0)))
+    {
+        printf("Cannot open rexxsyslib.library\n");
+        return RETURN_FAIL;
+    }
+    if (!(SocketBase = OpenLibrary("bsdsocket.library", 4)))
+    {
+        printf("Cannot open bsdsocket.library\n");
+        CloseLibrary((struct Library *)RexxSysBase);
+        return RETURN_FAIL;
+    }
+
+    if (!stack_query("TCP_CC", old_cc, sizeof(old_cc)) ||
+        !stack_query("TCP_SACK", old_sack, sizeof(old_sack)) ||
+        !stack_query("LOOPBACK_LOSS", old_loss, sizeof(old_loss)))
+    {
+        printf("This needs AROSTCP with the TCP_CC, TCP_SACK and LOOPBACK_LOSS variables\n");
+        CloseLibrary(SocketBase);
+        CloseLibrary((struct Library *)RexxSysBase);
+        return RETURN_FAIL;
+    }
+
+    printf("Lossy loopback benchmark, %lu MB per run, %ld KB socket buffers\n",
+           (unsigned long)size, (long)bufsize);
+
+    /* Without loss first, as the reference */
+    for (pass = 0; pass < 2; pass++)
+    {
+        for (i = 0; i < 2; i++)
+        {
+            for (sack = 0; sack < 2; sack++)
+            {
+                if (!run(algorithms[i], sack, pass ? loss : 0, size, bufsize << 10))
+                    rc = RETURN_WARN;
+            }
+        }
+        if (loss == 0)
+            break;
+    }
+
+    stack_set("TCP_CC", old_cc);
+    stack_set("TCP_SACK", old_sack);
+    stack_set("LOOPBACK_LOSS", old_loss);
+
+    CloseLibrary(SocketBase);
+    CloseLibrary((struct Library *)RexxSysBase);
+
+    return rc;
+}
@@ -0,0 +1,75 @@
+/*
+    Copyright (C) 2026, The AROS Development Team. All rights reserved.
+
+    Check that the malloc() caches of exited tasks are reclaimed, by running
+    more tasks one after another than the library has cache slots.
+*/
+
+#include <proto/exec.h>
+#include <proto/dos.h>
+#include <dos/dostags.h>
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <malloc.h>
+#include "test.h"
+
+#define TASKS   100     /* Well over the 32 cache slots */
+#define BLOCKS  64
+
+static volatile int failed;
+
+static void worker(void)
+{
+    void *blocks[BLOCKS];
+    int i;
+
+    for (i = 0; i < BLOCKS; i++)
+    {
+        blocks[i] = malloc(100);
+        if (blocks[i] == NULL)
+            failed = 1;
+    }
+    for (i = 0; i < BLOCKS; i++)
+        free(blocks[i]);
+}
+
+static int runworker(void)
+{
+    return CreateNewProcTags(
+        NP_Entry, worker, NP_Name, "malloctasks worker",
+        NP_Synchronous, TRUE, TAG_DONE
+    ) != NULL;
+}
+
+int main(void)
+{
+    struct mallinfo first, last;
+    int i;
+
+    TEST( runworker() );
+    first = mallinfo();
+    printf("After 1 task: arena %d, in use %d, free %d\n",
+           first.arena, first.uordblks, first.fordblks);
+
+    for (i = 1; i < TASKS; i++)
+        TESTFALSE( runworker() );
+
+    last = mallinfo();
+    printf("After %d tasks: arena %d, in use %d, free %d\n",
+           TASKS, last.arena, last.uordblks, last.fordblks);
+
+    TEST( !failed );
+    TEST( last.uordblks == first.uordblks );
+    /* Without reclaiming, every exited task would strand a cache full of
+       blocks and the later ones would keep carving new chunks */
+    TEST( last.arena - first.arena < 16384 );
+
+    return OK;
+}
+
+
+void cleanup()
+{
+    /* Nothing to clean up */
+}
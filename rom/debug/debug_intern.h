@@ -1,5 +1,5 @@
 /*
-    Copyright (C) 1995-2013, The AROS Development Team. All rights reserved.
+    Copyright (C) 1995-2026, The AROS Development Team. All rights reserved.
 
     Desc:
 */
@@ -17,6 +17,26 @@ typedef struct
     void *s_highest;            /* End address */
 } dbg_sym_t;
 
+/* Entry of the address ordered symbol index */
+typedef struct
+{
+    dbg_sym_t *si_sym;          /* Symbol */
+    void *si_maxend;            /* Highest end address of this and all preceding symbols */
+} dbg_symidx_t;
+
+/* Recent symbol lookups of a module, indexed by address */
+#define SYMCACHE_SIZE   16
+#define SYMCACHE_SLOT(addr) (((IPTR)(addr) >> 2) % SYMCACHE_SIZE)
+
+typedef struct
+{
+    void *sc_addr;
+    dbg_sym_t *sc_sym;
+} dbg_symcache_t;
+
+/* End address of a symbol. Symbols with zero length have zero in s_highest */
+#define SYMEND(sym) ((sym)->s_highest ? (sym)->s_highest : (sym)->s_lowest)
+
 struct segment;
 
 typedef struct
@@ -32,6 +52,9 @@ typedef struct
 #endif
     dbg_sym_t       *m_symbols;     /* Array of associated symbols */
     unsigned long   m_symcnt;       /* Number of symbols in the array */
+    dbg_symidx_t    *m_symindex;    /* Symbols sorted by address, may be NULL */
+    unsigned long   m_symidxcnt;    /* Number of symbols in the index */
+    dbg_symcache_t  m_symcache[SYMCACHE_SIZE];
     void            *m_lowest;      /* Lowest address of all segments */
     void            *m_highest;     /* Highest address of all segments */
     void            *m_gaplowest;   /* Lowest address of biggest gap */
@@ -57,6 +80,7 @@ struct DebugBase
     struct SignalSemaphore  db_ModSem;
     APTR                    db_KernelBase;
     IPTR                    db_Flags;
+    struct segment          *db_LastSegment;    /* Segment of the last lookup */
 };
 
 #if !defined(DEBUG_NOPRIVATEINLINE)
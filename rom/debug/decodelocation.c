@@ -1,5 +1,5 @@
 /*
-    Copyright (C) 1995-2013, The AROS Development Team. All rights reserved.
+    Copyright (C) 1995-2026, The AROS Development Team. All rights reserved.
 
     Desc:
 */
@@ -55,8 +55,13 @@ static struct segment * FindSegmentInModule(void *addr, module_t *mod)
 static struct segment * FindSegment(void *addr, struct Library *DebugBase)
 {
     struct DebugBase *debugBase = DBGBASE(DebugBase);
+    struct segment *seg = debugBase->db_LastSegment;
     module_t * mod;
 
+    /* Backtraces tend to stay within one segment */
+    if (seg && (seg->s_lowest <= addr) && (seg->s_highest >= addr))
+        return seg;
+
     ForeachNode(&debugBase->db_Modules, mod)
     {
         DSEGS(bug("[Debug] Checking module 0x%p - 0x%p, %s\n", mod->m_lowest, mod->m_highest, mod->m_name));
@@ -65,19 +70,87 @@ static struct segment * FindSegment(void *addr, struct Library *DebugBase)
         if (!((mod->m_gaplowest <= addr) && (mod->m_gaphighest >= addr)) &&
                 ((mod->m_lowest <= addr) && (mod->m_highest >= addr)))
         {
-            struct segment *seg = FindSegmentInModule(addr, mod);
+            seg = FindSegmentInModule(addr, mod);
             if (seg)
+            {
+                debugBase->db_LastSegment = seg;
                 return seg;
+            }
         }
     }
 
     return NULL;
 }
 
+/*
+ * Find the symbol containing addr. Symbols may overlap, in which case the one
+ * that comes first in the symbol table is returned, like a linear scan would.
+ */
+static dbg_sym_t *LookupSymbol(module_t *mod, void *addr)
+{
+    dbg_symidx_t *index = mod->m_symindex;
+    dbg_symcache_t *cache;
+    dbg_sym_t *found = NULL;
+    LONG i, minidx, maxidx;
+
+    /* No index, the module is still being registered or memory was short */
+    if (!index)
+    {
+        dbg_sym_t *sym = mod->m_symbols;
+        unsigned long j;
+
+        for (j = 0; j < mod->m_symcnt; j++)
+        {
+            if (sym[j].s_lowest <= addr && SYMEND(&sym[j]) >= addr)
+                return &sym[j];
+        }
+        return NULL;
+    }
+
+    /*
+     * The cache is updated without locking, by concurrent lookups too, so
+     * make sure the symbol still covers the address before using it.
+     */
+    cache = &mod->m_symcache[SYMCACHE_SLOT(addr)];
+    found = cache->sc_sym;
+    if (found && (cache->sc_addr == addr) && (found->s_lowest <= addr) && (SYMEND(found) >= addr))
+        return found;
+    found = NULL;
+
+    /* Binary search for the last symbol starting at or below addr */
+    minidx = 0;
+    maxidx = mod->m_symidxcnt - 1;
+    while (minidx <= maxidx)
+    {
+        i = (minidx + maxidx) / 2;
+
+        if (index[i].si_sym->s_lowest <= addr)
+            minidx = i + 1;
+        else
+            maxidx = i - 1;
+    }
+
+    /* Walk back over all symbols that may still reach addr */
+    for (i = maxidx; (i >= 0) && (index[i].si_maxend >= addr); i--)
+    {
+        dbg_sym_t *sym = index[i].si_sym;
+
+        if ((SYMEND(sym) >= addr) && (!found || sym < found))
+            found = sym;
+    }
+
+    if (found)
+    {
+        cache->sc_sym  = found;
+        cache->sc_addr = addr;
+    }
+
+    return found;
+}
+
 static BOOL FindSymbol(module_t *mod, char **function, void **funstart, void **funend, void *addr)
 {
-    dbg_sym_t *sym = mod->m_symbols;
-    unsigned int i;
+    dbg_sym_t *sym;
 
     /* Caller didn't care about symbols? */
     if (!addr)
@@ -87,21 +160,14 @@ static BOOL FindSymbol(module_t *mod, char **function, void **funstart, void **f
     *funstart = NULL;
     *funend   = NULL;
 
-    for (i = 0; i < mod->m_symcnt; i++)
+    sym = LookupSymbol(mod, addr);
+    if (sym)
     {
-        APTR highest = sym[i].s_highest;
-
-        /* Symbols with zero length have zero in s_highest */
-        if (!highest)
-            highest = sym[i].s_lowest;
+        *function = sym->s_name;
+        *funstart = sym->s_lowest;
+        *funend   = sym->s_highest;
 
-        if (sym[i].s_lowest <= addr && highest >= addr) {
-            *function = sym[i].s_name;
-            *funstart = sym[i].s_lowest;
-            *funend   = sym[i].s_highest;
-
-            return TRUE;
-        }
+        return TRUE;
     }
 
     /* Indicate that symbol not found */
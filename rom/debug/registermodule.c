@@ -26,6 +26,8 @@ static void addsymbol(module_t *mod, dbg_sym_t *sym, struct symbol *st, APTR val
 static void HandleModuleSegments(module_t *mod, struct MinList * list);
 static void RegisterModule_Hunk(const char *name, BPTR segList, ULONG DebugType, APTR DebugInfo, struct Library *DebugBase);
 static int compare_segments(const void *left, const void *right);
+static int compare_symbols(const void *left, const void *right);
+static void BuildSymbolIndex(module_t *mod, struct Library *DebugBase);
 
 /*****************************************************************************
 
@@ -163,6 +165,7 @@ static int compare_segments(const void *left, const void *right);
                             ReleaseSemaphore(&DBGBASE(DebugBase)->db_ModSem);
 
                             HandleModuleSegments(mod, &tmplist);
+                            BuildSymbolIndex(mod, DebugBase);
 
                             continue;
                         }
@@ -224,6 +227,67 @@ static int compare_segments(const void *left, const void *right)
     return 0;
 }
 
+static int compare_symbols(const void *left, const void *right)
+{
+    const dbg_symidx_t *left_idx = left;
+    const dbg_symidx_t *right_idx = right;
+    IPTR left_lowest = (IPTR)left_idx->si_sym->s_lowest;
+    IPTR right_lowest = (IPTR)right_idx->si_sym->s_lowest;
+
+    if (left_lowest < right_lowest)
+        return -1;
+    if (left_lowest > right_lowest)
+        return 1;
+
+    /* Keep symbols at the same address in table order */
+    if (left_idx->si_sym < right_idx->si_sym)
+        return -1;
+    if (left_idx->si_sym > right_idx->si_sym)
+        return 1;
+    return 0;
+}
+
+/*
+ * Build the index of the module's symbols by address, which lets
+ * DecodeLocationA() binary search them instead of scanning the whole
+ * table. m_symbols itself keeps its order for EnumerateSymbolsA().
+ */
+static void BuildSymbolIndex(module_t *mod, struct Library *DebugBase)
+{
+    dbg_symidx_t *index;
+    unsigned long i, count = mod->m_symcnt;
+    void *maxend = NULL;
+
+    if (count == 0)
+        return;
+
+    index = AllocVec(count * sizeof(dbg_symidx_t), MEMF_PUBLIC);
+    if (!index)
+        return;
+
+    for (i = 0; i < count; i++)
+        index[i].si_sym = &mod->m_symbols[i];
+
+    qsort(index, count, sizeof(dbg_symidx_t), compare_symbols);
+
+    /* Symbols may overlap, so record how far back a lookup has to look */
+    for (i = 0; i < count; i++)
+    {
+        void *end = SYMEND(index[i].si_sym);
+
+        if (end > maxend)
+            maxend = end;
+        index[i].si_maxend = maxend;
+    }
+
+    ObtainSemaphore(&DBGBASE(DebugBase)->db_ModSem);
+    mod->m_symidxcnt = count;
+    mod->m_symindex = index;
+    ReleaseSemaphore(&DBGBASE(DebugBase)->db_ModSem);
+
+    DSYMS(bug("[Debug] Indexed %lu symbols of %s\n", count, mod->m_name));
+}
+
 static void HandleModuleSegments(module_t *mod, struct MinList * list)
 {
     struct segment *seg;
@@ -472,6 +536,8 @@ void RegisterModule_ELF(const char *name, BPTR segList, struct elfheader *eh, st
                             sym++;
                         }
                     }
+
+                    BuildSymbolIndex(mod, DebugBase);
                 }
                 break;
             }
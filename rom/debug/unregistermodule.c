@@ -1,5 +1,5 @@
 /*
-    Copyright (C) 1995-2016, The AROS Development Team. All rights reserved.
+    Copyright (C) 1995-2026, The AROS Development Team. All rights reserved.
 
     Desc:
 */
@@ -61,6 +61,9 @@ static VOID RemoveSegmentRange(module_t * mod, LONG firstidx, LONG count);
     D(bug("[Debug] UnregisterModule(0x%p)\n", segList));
     ObtainSemaphore(&DBGBASE(DebugBase)->db_ModSem);
 
+    /* The segment may be about to go away */
+    DBGBASE(DebugBase)->db_LastSegment = NULL;
+
     while (segList)
     {
         if (mod == NULL) /* Search for new module */
@@ -161,6 +164,9 @@ static VOID RemoveSegmentRange(module_t * mod, LONG firstidx, LONG count)
                 FreeVec(mod->m_symbols);
             }
 
+            if (mod->m_symindex)
+                FreeVec(mod->m_symindex);
+
             /* Free associated string tables */
             if (mod->m_str) {
                 D(bug("[Debug] Removing symbol name table 0x%p\n", mod->m_str));
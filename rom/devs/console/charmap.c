@@ -1,5 +1,5 @@
 /*
-    Copyright (C) 2010-2020, The AROS Development Team. All rights reserved.
+    Copyright (C) 2010-2026, The AROS Development Team. All rights reserved.
 
     Desc: Code for CONU_CHARMAP console units.
 */
@@ -18,15 +18,15 @@ struct charmap_line *charmap_dispose_line(struct charmap_line *line)
     if (line)
     {
         next = line->next;
-        if (line->size)
-        {
-            if (line->text)
-                FreeMem(line->text, line->size);
-            if (line->fgpen)
-                FreeMem(line->fgpen, line->size);
-            if (line->bgpen)
-                FreeMem(line->bgpen, line->size);
-        }
+        if (next)
+            next->prev = line->prev;
+        if (line->prev)
+            line->prev->next = next;
+        if (line->text)
+            FreeMem(line->text, line->capacity);
+        if (line->attrs)
+            FreeMem(line->attrs,
+                line->maxattrs * sizeof(struct charmap_attr));
         FreeMem(line, sizeof(struct charmap_line));
     }
     return next;
@@ -42,72 +42,312 @@ struct charmap_line *charmap_newline(struct charmap_line *next,
 {
     struct charmap_line *newline =
         (struct charmap_line *)AllocMem(sizeof(struct charmap_line),
-        MEMF_ANY);
+        MEMF_ANY | MEMF_CLEAR);
+    if (!newline)
+        return NULL;
     newline->next = next;
     newline->prev = prev;
     if (next)
         next->prev = newline;
     if (prev)
         prev->next = newline;
-    newline->text = 0;
-    newline->fgpen = 0;
-    newline->bgpen = 0;
-    newline->flags = 0;
-    newline->size = 0;
     return newline;
 }
 
+ULONG charmap_line_bytes(struct charmap_line *line)
+{
+    return sizeof(struct charmap_line) + line->capacity +
+        line->maxattrs * sizeof(struct charmap_attr);
+}
 
-// FIXME: **much** faster if add capacity to charmap_line and allocate
-// a few characters at a time
-VOID charmap_resize(struct ConsoleBase *ConsoleDevice, struct charmap_line *line, ULONG newsize)
+static BOOL charmap_grow_attrs(struct charmap_line *line, ULONG needed)
 {
-    char *text = line->text;
-    BYTE *fgpen = line->fgpen;
-    BYTE *bgpen = line->bgpen;
-    BYTE *flags = line->flags;
-    ULONG size = line->size;
+    struct charmap_attr *attrs;
+    ULONG maxattrs;
+
+    if (needed <= line->maxattrs)
+        return TRUE;
+
+    maxattrs = (needed + CHARMAP_ATTR_GRANULE - 1) &
+        ~(CHARMAP_ATTR_GRANULE - 1);
+    attrs = AllocMem(maxattrs * sizeof(struct charmap_attr), MEMF_ANY);
+    if (!attrs)
+        return FALSE;
 
-    if (newsize)
+    if (line->attrs)
     {
-        line->text = (char *)AllocMem(newsize, MEMF_ANY);
+        CopyMem(line->attrs, attrs,
+            line->numattrs * sizeof(struct charmap_attr));
+        FreeMem(line->attrs, line->maxattrs * sizeof(struct charmap_attr));
+    }
+    line->attrs = attrs;
+    line->maxattrs = maxattrs;
+
+    return TRUE;
+}
+
+/* Drop runs that have become empty or lie beyond the end of the line,
+   and merge neighbours with identical attributes */
+static VOID charmap_compact_attrs(struct charmap_line *line)
+{
+    struct charmap_attr *attrs = line->attrs;
+    ULONG i, n = 0;
+
+    for (i = 0; i < line->numattrs; i++)
+    {
+        if (attrs[i].start >= line->size)
+            break;
+        if (i + 1 < line->numattrs && attrs[i + 1].start == attrs[i].start)
+            continue;
+        if (n > 0 &&
+            attrs[n - 1].fgpen == attrs[i].fgpen &&
+            attrs[n - 1].bgpen == attrs[i].bgpen &&
+            attrs[n - 1].flags == attrs[i].flags)
+            continue;
+        attrs[n++] = attrs[i];
+    }
+    line->numattrs = n;
+}
+
+/* Make sure a run starts at column x. The caller must have made room
+   for one more run */
+static VOID charmap_split_attr(struct charmap_line *line, ULONG x)
+{
+    ULONG i;
+
+    if (x == 0 || x >= line->size)
+        return;
+
+    i = charmap_find_attr(line, x);
+    if (line->attrs[i].start == x)
+        return;
+
+    memmove(&line->attrs[i + 2], &line->attrs[i + 1],
+        (line->numattrs - i - 1) * sizeof(struct charmap_attr));
+    line->attrs[i + 1] = line->attrs[i];
+    line->attrs[i + 1].start = x;
+    line->numattrs++;
+}
+
+/* Returns the run covering column x */
+ULONG charmap_find_attr(struct charmap_line *line, ULONG x)
+{
+    ULONG lo = 0, hi;
+
+    if (line->numattrs == 0)
+        return 0;
+
+    hi = line->numattrs - 1;
+    while (lo < hi)
+    {
+        ULONG mid = (lo + hi + 1) / 2;
+
+        if (line->attrs[mid].start <= x)
+            lo = mid;
+        else
+            hi = mid - 1;
+    }
+    return lo;
+}
+
+BOOL charmap_set_attrs(struct charmap_line *line, ULONG start, ULONG len,
+    BYTE fgpen, BYTE bgpen, BYTE flags)
+{
+    ULONG end = start + len, i;
+
+    if (start >= line->size || len == 0)
+        return TRUE;
+    if (end > line->size)
+        end = line->size;
+
+    if (!charmap_grow_attrs(line, line->numattrs + 2))
+        return FALSE;
+
+    charmap_split_attr(line, end);
+    charmap_split_attr(line, start);
+
+    for (i = charmap_find_attr(line, start);
+        i < line->numattrs && line->attrs[i].start < end; i++)
+    {
+        line->attrs[i].fgpen = fgpen;
+        line->attrs[i].bgpen = bgpen;
+        line->attrs[i].flags = flags;
+    }
+    charmap_compact_attrs(line);
+
+    return TRUE;
+}
+
+/* Text grows in CHARMAP_TEXT_GRANULE steps, so appending to a line only
+   reallocates once every few characters. New characters are cleared and
+   take the attributes of the last run */
+BOOL charmap_resize(struct ConsoleBase *ConsoleDevice, struct charmap_line *line, ULONG newsize)
+{
+    if (newsize == 0)
+    {
+        if (line->text)
+            FreeMem(line->text, line->capacity);
+        if (line->attrs)
+            FreeMem(line->attrs,
+                line->maxattrs * sizeof(struct charmap_attr));
+        line->text = 0;
+        line->attrs = 0;
+        line->size = line->capacity = 0;
+        line->numattrs = line->maxattrs = 0;
+        return TRUE;
+    }
+
+    if (newsize > line->capacity)
+    {
+        ULONG capacity = (newsize + CHARMAP_TEXT_GRANULE - 1) &
+            ~(CHARMAP_TEXT_GRANULE - 1);
+        char *text = (char *)AllocMem(capacity, MEMF_ANY);
+
+        if (!text)
+            return FALSE;
         if (line->text)
-            SetMem(line->text, 0, newsize);
-        line->fgpen = (BYTE *) AllocMem(newsize, MEMF_ANY);
-        if (line->fgpen)
-            SetMem(line->fgpen, 0, newsize);
-        line->bgpen = (BYTE *) AllocMem(newsize, MEMF_ANY);
-        if (line->bgpen)
-            SetMem(line->bgpen, 0, newsize);
-        line->flags = (BYTE *) AllocMem(newsize, MEMF_ANY);
-        if (line->flags)
-            SetMem(line->flags, 0, newsize);
+        {
+            CopyMem(line->text, text, line->size);
+            FreeMem(line->text, line->capacity);
+        }
+        line->text = text;
+        line->capacity = capacity;
+    }
+
+    if (newsize > line->size)
+    {
+        if (line->numattrs == 0)
+        {
+            if (!charmap_grow_attrs(line, 1))
+                return FALSE;
+            SetMem(line->attrs, 0, sizeof(struct charmap_attr));
+            line->numattrs = 1;
+        }
+        SetMem(line->text + line->size, 0, newsize - line->size);
         line->size = newsize;
     }
     else
     {
-        line->text = 0;
-        line->fgpen = 0;
-        line->bgpen = 0;
-        line->flags = 0;
-        line->size = 0;
+        line->size = newsize;
+        charmap_compact_attrs(line);
     }
 
-    if (text && line->text)
-        memcpy(line->text, text, size);
-    if (fgpen && line->fgpen)
-        memcpy(line->fgpen, fgpen, size);
-    if (bgpen && line->bgpen)
-        memcpy(line->bgpen, bgpen, size);
-    if (flags && line->flags)
-        memcpy(line->flags, flags, size);
-
-    if (text)
-        FreeMem(text, size);
-    if (fgpen)
-        FreeMem(fgpen, size);
-    if (bgpen)
-        FreeMem(bgpen, size);
-    if (flags)
-        FreeMem(flags, size);
+    return TRUE;
+}
+
+BOOL charmap_insert(struct ConsoleBase *ConsoleDevice, struct charmap_line *line, ULONG x,
+    char c, BYTE fgpen, BYTE bgpen, BYTE flags)
+{
+    ULONG i;
+
+    if (x >= line->size)
+        return FALSE;
+
+    if (!charmap_resize(ConsoleDevice, line, line->size + 1))
+        return FALSE;
+
+    memmove(line->text + x + 1, line->text + x, line->size - x - 1);
+    for (i = charmap_find_attr(line, x) + 1; i < line->numattrs; i++)
+        line->attrs[i].start += 1;
+
+    line->text[x] = c;
+    return charmap_set_attrs(line, x, 1, fgpen, bgpen, flags);
+}
+
+VOID charmap_delete(struct charmap_line *line, ULONG x)
+{
+    ULONG i;
+
+    if (x >= line->size)
+        return;
+
+    memmove(line->text + x, line->text + x + 1, line->size - x - 1);
+    for (i = charmap_find_attr(line, x) + 1; i < line->numattrs; i++)
+        line->attrs[i].start -= 1;
+
+    line->size -= 1;
+    charmap_compact_attrs(line);
+}
+
+BOOL charmap_index_append(struct charmap_index *index,
+    struct charmap_line *line)
+{
+    ULONG slot = index->first + index->count;
+    ULONG chunk = slot / CHARMAP_INDEX_CHUNK;
+
+    if (chunk >= index->numchunks)
+    {
+        if (chunk >= index->maxchunks)
+        {
+            ULONG maxchunks = index->maxchunks + 8;
+            struct charmap_line ***chunks =
+                AllocMem(maxchunks * sizeof(*chunks), MEMF_ANY);
+
+            if (!chunks)
+                return FALSE;
+            if (index->chunks)
+            {
+                CopyMem(index->chunks, chunks,
+                    index->numchunks * sizeof(*chunks));
+                FreeMem(index->chunks, index->maxchunks * sizeof(*chunks));
+            }
+            index->chunks = chunks;
+            index->maxchunks = maxchunks;
+        }
+
+        index->chunks[chunk] =
+            AllocMem(CHARMAP_INDEX_CHUNK * sizeof(struct charmap_line *),
+            MEMF_ANY);
+        if (!index->chunks[chunk])
+            return FALSE;
+        index->numchunks++;
+    }
+
+    index->chunks[chunk][slot % CHARMAP_INDEX_CHUNK] = line;
+    index->count++;
+
+    return TRUE;
+}
+
+VOID charmap_index_remove_first(struct charmap_index *index)
+{
+    if (index->count == 0)
+        return;
+
+    index->count--;
+    if (++index->first == CHARMAP_INDEX_CHUNK)
+    {
+        FreeMem(index->chunks[0],
+            CHARMAP_INDEX_CHUNK * sizeof(struct charmap_line *));
+        index->numchunks--;
+        memmove(index->chunks, index->chunks + 1,
+            index->numchunks * sizeof(*index->chunks));
+        index->first = 0;
+    }
+}
+
+struct charmap_line *charmap_index_line(struct charmap_index *index,
+    ULONG row)
+{
+    ULONG slot = index->first + row;
+
+    if (row >= index->count)
+        return NULL;
+
+    return index->chunks[slot / CHARMAP_INDEX_CHUNK]
+        [slot % CHARMAP_INDEX_CHUNK];
+}
+
+VOID charmap_index_free(struct charmap_index *index)
+{
+    ULONG i;
+
+    for (i = 0; i < index->numchunks; i++)
+        FreeMem(index->chunks[i],
+            CHARMAP_INDEX_CHUNK * sizeof(struct charmap_line *));
+    if (index->chunks)
+        FreeMem(index->chunks, index->maxchunks * sizeof(*index->chunks));
+    index->chunks = NULL;
+    index->numchunks = index->maxchunks = 0;
+    index->first = index->count = 0;
 }
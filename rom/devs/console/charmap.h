@@ -1,5 +1,5 @@
 /*
-    Copyright (C) 1995-2020, The AROS Development Team. All rights reserved.
+    Copyright (C) 1995-2026, The AROS Development Team. All rights reserved.
 */
 
 #ifndef CHARMAP_H
@@ -7,27 +7,71 @@
 
 #include <exec/types.h>
 
-// FIXME:
-// This wastes a lot of memory - most characters are likely to share the
-// same fg/bg/flags. One option would be to optimize away the fgpen/bgpen/
-// flags buffers if they're the same for every character in the line
+/* Line text is allocated in steps of this many characters, and attribute
+   runs in steps of CHARMAP_ATTR_GRANULE entries */
+#define CHARMAP_TEXT_GRANULE    32
+#define CHARMAP_ATTR_GRANULE    4
+
+/* Number of line pointers held in each block of a struct charmap_index */
+#define CHARMAP_INDEX_CHUNK     128
+
+/* A run of characters sharing the same pens and style. A run extends
+   from its start column up to the start of the next run, or the end of
+   the line for the last one */
+struct charmap_attr
+{
+    ULONG start;
+    BYTE fgpen;
+    BYTE bgpen;
+    BYTE flags;
+    BYTE pad;
+};
+
 struct charmap_line
 {
     // FIXME: Replace with a MinNode?
     struct charmap_line *next;
     struct charmap_line *prev;
 
-    ULONG size;
+    ULONG size;                 /* Characters in use */
+    ULONG capacity;             /* Characters allocated for text */
     char *text;
-    BYTE *fgpen;
-    BYTE *bgpen;
-    BYTE *flags;
+
+    struct charmap_attr *attrs; /* Sorted by start, first one at column 0 */
+    ULONG numattrs;
+    ULONG maxattrs;
+};
+
+/* Lines of a charmap by row number, kept in fixed size blocks so that
+   lines can be appended at the end and dropped from the start without
+   moving more than the (short) block table */
+struct charmap_index
+{
+    struct charmap_line ***chunks;
+    ULONG numchunks;            /* Blocks allocated */
+    ULONG maxchunks;            /* Size of the block table */
+    ULONG first;                /* Slot of row 0 in chunks[0] */
+    ULONG count;                /* Rows in the index */
 };
 
 VOID charmap_dispose_lines(struct charmap_line *line);
 struct charmap_line *charmap_dispose_line(struct charmap_line *line);
 struct charmap_line *charmap_newline(struct charmap_line *next,
     struct charmap_line *prev);
-VOID charmap_resize(struct ConsoleBase *ConsoleDevice, struct charmap_line *line, ULONG newsize);
+BOOL charmap_resize(struct ConsoleBase *ConsoleDevice, struct charmap_line *line, ULONG newsize);
+BOOL charmap_set_attrs(struct charmap_line *line, ULONG start, ULONG len,
+    BYTE fgpen, BYTE bgpen, BYTE flags);
+ULONG charmap_find_attr(struct charmap_line *line, ULONG x);
+BOOL charmap_insert(struct ConsoleBase *ConsoleDevice, struct charmap_line *line, ULONG x,
+    char c, BYTE fgpen, BYTE bgpen, BYTE flags);
+VOID charmap_delete(struct charmap_line *line, ULONG x);
+ULONG charmap_line_bytes(struct charmap_line *line);
+
+BOOL charmap_index_append(struct charmap_index *index,
+    struct charmap_line *line);
+VOID charmap_index_remove_first(struct charmap_index *index);
+struct charmap_line *charmap_index_line(struct charmap_index *index,
+    ULONG row);
+VOID charmap_index_free(struct charmap_index *index);
 
 #endif
@@ -1,5 +1,5 @@
 /*
-    Copyright (C) 1995-2025, The AROS Development Team. All rights reserved.
+    Copyright (C) 1995-2026, The AROS Development Team. All rights reserved.
 
     Desc: Code for CONU_CHARMAP console units.
 */
@@ -78,6 +78,12 @@ struct charmapcondata
 
     ULONG scrollback_max;       /* Maximum number of lines in scrollback
                                    buffer on top of CHAR_YMAX(o) */
+    ULONG scrollback_bytes;     /* Memory used by the lines in the buffer */
+    ULONG scrollback_maxbytes;  /* Memory the scrollback may use before
+                                   trimming it, whatever its line count */
+
+    /* Every line from top_of_scrollback on, by row */
+    struct charmap_index lines;
 
     BOOL unrendered;            /* Unrendered cursor while scrolled back? */
 
@@ -350,6 +356,7 @@ static Object *charmapcon_new(Class *cl, Object *o, struct opSet *msg)
         SetMem(data, 0, sizeof(struct charmapcondata));
 
         data->scrollback_max = 1000;    /* FIXME: Don't hardcode it */
+        data->scrollback_maxbytes = 512 * 1024;
         data->ccd_GfxBase = newGfxBase;
         charmapcon_add_prop(cl, o);
 
@@ -368,6 +375,7 @@ static VOID charmapcon_dispose(Class *cl, Object *o, Msg msg)
     struct charmapcondata *data = INST_DATA(cl, o);
 
     charmap_dispose_lines(data->top_of_scrollback);
+    charmap_index_free(&data->lines);
     charmapcon_free_prop(cl, o);
 
     CloseLibrary(data->ccd_GfxBase);
@@ -377,42 +385,46 @@ static VOID charmapcon_dispose(Class *cl, Object *o, Msg msg)
 
 /*********  CharMapCon::DoCommand()  ****************************/
 
-static struct charmap_line *charmapcon_find_line(Class *cl, Object *o,
-    ULONG ycp)
+/* Append an empty line to the end of the buffer */
+static struct charmap_line *charmapcon_add_line(struct charmapcondata *data)
 {
-    struct charmapcondata *data = INST_DATA(cl, o);
+    struct charmap_line *last = NULL, *line;
 
-    // Find the line. This is inefficient but the number of lines on screen
-    // should never be very high.
-    // FIXME: Optimizing the case of appending to the end (e.g. know what line
-    // is on the last line of the buffer).
+    if (data->lines.count)
+        last = charmap_index_line(&data->lines, data->lines.count - 1);
 
-    struct charmap_line *line = data->top_of_window;
+    line = charmap_newline(0, last);
     if (!line)
-    {
-        D(bug("Initializing charmap\n"));
-        data->top_of_window = data->top_of_scrollback = line =
-            charmap_newline(0, 0);
-        data->scrollback_size = 1;
-    }
+        return NULL;
 
-    D(bug("Finding line %ld\n", ycp));
-    while (ycp > 0)
+    if (!charmap_index_append(&data->lines, line))
     {
-        if (!line->next)
-        {
-            charmap_newline(0, line);
-            data->scrollback_size += 1;
-        }
-        line = line->next;
-        ycp -= 1;
+        charmap_dispose_line(line);
+        return NULL;
     }
 
-    while (data->scrollback_size > data->scrollback_max + CHAR_YMAX(o) &&
+    if (!data->top_of_scrollback)
+        data->top_of_window = data->top_of_scrollback = line;
+    data->scrollback_size += 1;
+    data->scrollback_bytes += charmap_line_bytes(line);
+
+    return line;
+}
+
+/* Drop lines from the start of the scrollback buffer while it holds more
+   lines or memory than allowed, never going past the top of the window */
+static VOID charmapcon_trim_scrollback(Class *cl, Object *o)
+{
+    struct charmapcondata *data = INST_DATA(cl, o);
+
+    while ((data->scrollback_size > data->scrollback_max + CHAR_YMAX(o) ||
+            data->scrollback_bytes > data->scrollback_maxbytes) &&
         data->top_of_window != data->top_of_scrollback)
     {
         data->scrollback_size -= 1;
         data->scrollback_pos -= 1;
+        if (data->unrendered)
+            data->saved_scrollback_pos -= 1;
 
         /* FIXME: Needs testing... */
         if (data->select_line_max == data->select_line_min &&
@@ -442,9 +454,29 @@ static struct charmap_line *charmapcon_find_line(Class *cl, Object *o,
             data->select_x_max = 0;
         }
 
+        data->scrollback_bytes -= charmap_line_bytes(data->top_of_scrollback);
+        charmap_index_remove_first(&data->lines);
         data->top_of_scrollback =
             charmap_dispose_line(data->top_of_scrollback);
     }
+}
+
+static struct charmap_line *charmapcon_find_line(Class *cl, Object *o,
+    ULONG ycp)
+{
+    struct charmapcondata *data = INST_DATA(cl, o);
+    struct charmap_line *line;
+    ULONG row = data->scrollback_pos + ycp;
+
+    D(bug("Finding line %ld\n", ycp));
+    while (data->lines.count <= row)
+    {
+        if (!charmapcon_add_line(data))
+            return NULL;
+    }
+
+    line = charmap_index_line(&data->lines, row);
+    charmapcon_trim_scrollback(cl, o);
 
     return line;
 }
@@ -452,28 +484,36 @@ static struct charmap_line *charmapcon_find_line(Class *cl, Object *o,
 static VOID charmap_ascii(Class *cl, Object *o, ULONG xcp, ULONG ycp,
     char *str, ULONG len)
 {
+    struct charmapcondata *data = INST_DATA(cl, o);
     struct charmap_line *line = charmapcon_find_line(cl, o, ycp);
-    ULONG oldsize = line->size;
+    ULONG oldsize, oldbytes, from;
 
-    // Ensure the line has sufficient capacity.
-    if (line->size < xcp + len)
-        charmap_resize(ConsoleDevice, line, xcp + len);
+    if (!line)
+        return;
 
-    // .. copy the required data
-    SetMem(line->fgpen + xcp, CU(o)->cu_FgPen, len);
-    SetMem(line->bgpen + xcp, CU(o)->cu_BgPen, len);
-    SetMem(line->flags + xcp, CU(o)->cu_TxFlags, len);
-    memcpy(line->text + xcp, str, len);
+    oldsize = line->size;
+    oldbytes = charmap_line_bytes(line);
+
+    // Ensure the line has sufficient capacity.
+    if (line->size < xcp + len &&
+        !charmap_resize(ConsoleDevice, line, xcp + len))
+        return;
 
     // If cursor output is moved further right on the screen than
     // the last output, we need to fill the line
+    from = xcp;
     if (oldsize < xcp)
     {
-        SetMem(line->fgpen + oldsize, CU(o)->cu_FgPen, xcp - oldsize);
-        SetMem(line->bgpen + oldsize, CU(o)->cu_BgPen, xcp - oldsize);
-        SetMem(line->flags + oldsize, CU(o)->cu_TxFlags, xcp - oldsize);
         SetMem(line->text + oldsize, ' ', xcp - oldsize);
+        from = oldsize;
     }
+
+    // .. copy the required data, the gap taking the same attributes
+    memcpy(line->text + xcp, str, len);
+    charmap_set_attrs(line, from, xcp + len - from,
+        CU(o)->cu_FgPen, CU(o)->cu_BgPen, CU(o)->cu_TxFlags);
+
+    data->scrollback_bytes += charmap_line_bytes(line) - oldbytes;
 }
 
 static VOID charmap_scroll_up(Class *cl, Object *o, ULONG y)
@@ -483,19 +523,21 @@ static VOID charmap_scroll_up(Class *cl, Object *o, ULONG y)
     if (!data->top_of_window)
         return;
 
-    while (y--)
+    while (data->lines.count <= data->scrollback_pos + y)
     {
-        if (!data->top_of_window->next)
+        if (!charmapcon_add_line(data))
         {
-            charmap_newline(0, data->top_of_window);
-            data->scrollback_size += 1;
+            y = data->lines.count - 1 - data->scrollback_pos;
+            break;
         }
-        data->top_of_window = data->top_of_window->next;
-        data->scrollback_pos += 1;
-        data->select_y_max -= 1;
-        data->select_y_min -= 1;
     }
 
+    data->scrollback_pos += y;
+    data->top_of_window = charmap_index_line(&data->lines,
+        data->scrollback_pos);
+    data->select_y_max -= y;
+    data->select_y_min -= y;
+
     if (data->scrollback_size - CHAR_YMAX(o) - 1 <= data->scrollback_pos &&
         data->unrendered)
     {
@@ -503,14 +545,7 @@ static VOID charmap_scroll_up(Class *cl, Object *o, ULONG y)
         data->unrendered = 0;
     }
 
-    while (data->scrollback_size > data->scrollback_max + CHAR_YMAX(o) &&
-        data->top_of_window != data->top_of_scrollback)
-    {
-        data->scrollback_size -= 1;
-        data->scrollback_pos -= 1;
-        data->top_of_scrollback =
-            charmap_dispose_line(data->top_of_scrollback);
-    }
+    charmapcon_trim_scrollback(cl, o);
 }
 
 static VOID charmap_scroll_down(Class *cl, Object *o, ULONG y)
@@ -528,13 +563,14 @@ static VOID charmap_scroll_down(Class *cl, Object *o, ULONG y)
     }
     if (data->top_of_window)
     {
-        while (y-- && data->top_of_window->prev)
-        {
-            data->top_of_window = data->top_of_window->prev;
-            data->scrollback_pos -= 1;
-            data->select_y_max += 1;
-            data->select_y_min += 1;
-        }
+        if (y > data->scrollback_pos)
+            y = data->scrollback_pos;
+
+        data->scrollback_pos -= y;
+        data->top_of_window = charmap_index_line(&data->lines,
+            data->scrollback_pos);
+        data->select_y_max += y;
+        data->select_y_min += y;
     }
 }
 
@@ -607,39 +643,23 @@ static VOID charmap_delete_char(Class *cl, Object *o, ULONG x, ULONG y)
     if (!line || x >= line->size)
         return;
 
-    // FIXME: Shrink the buffer, or keep track of capacity separately.
-    if (x + 1 >= line->size)
-    {
-        line->text[x] = 0;
-        return;
-    }
-
-    memmove(line->fgpen + x, line->fgpen + x + 1, 1);
-    memmove(line->bgpen + x, line->bgpen + x + 1, 1);
-    memmove(line->flags + x, line->flags + x + 1, 1);
-    memmove(line->text + x, line->text + x + 1, 1);
+    /* The line keeps its capacity, so this never reallocates */
+    charmap_delete(line, x);
 }
 
 static VOID charmap_insert_char(Class *cl, Object *o, ULONG x, ULONG y)
 {
+    struct charmapcondata *data = INST_DATA(cl, o);
     struct charmap_line *line = charmapcon_find_line(cl, o, y);
+    ULONG oldbytes;
 
-    if (x >= line->size)
+    if (!line || x >= line->size)
         return;
 
-    /* FIXME: This is wasteful, since it copies the buffers straight over,
-     * so we have to do memmove's further down. */
-    charmap_resize(ConsoleDevice, line, line->size + 1);
-
-    memmove(line->fgpen + x + 1, line->fgpen + x, line->size - x - 1);
-    memmove(line->bgpen + x + 1, line->bgpen + x, line->size - x - 1);
-    memmove(line->flags + x + 1, line->flags + x, line->size - x - 1);
-    memmove(line->text + x + 1, line->text + x, line->size - x - 1);
-
-    line->fgpen[x] = CU(o)->cu_FgPen;
-    line->bgpen[x] = CU(o)->cu_BgPen;
-    line->flags[x] = CU(o)->cu_TxFlags;
-    line->text[x] = ' ';
+    oldbytes = charmap_line_bytes(line);
+    charmap_insert(ConsoleDevice, line, x, ' ',
+        CU(o)->cu_FgPen, CU(o)->cu_BgPen, CU(o)->cu_TxFlags);
+    data->scrollback_bytes += charmap_line_bytes(line) - oldbytes;
 }
 
 static VOID charmap_formfeed(Class *cl, Object *o)
@@ -649,7 +669,9 @@ static VOID charmap_formfeed(Class *cl, Object *o)
 
     while (line)
     {
+        data->scrollback_bytes -= charmap_line_bytes(line);
         charmap_resize(ConsoleDevice, line, 0);
+        data->scrollback_bytes += charmap_line_bytes(line);
         line = line->next;
     }
 }
@@ -803,17 +825,29 @@ static VOID charmapcon_refresh_lines(Class *cl, Object *o, LONG fromLine,
     while (line && yc <= toLine)
     {
         const char *str = line->text;
+        const char *nul = str ? memchr(str, 0, line->size) : NULL;
+        ULONG end = nul ? nul - str : line->size;
         ULONG start = 0;
+        ULONG attr = 0;
         ULONG remaining_space = CHAR_XMAX(o) + 1;
         Move(rp, GFX_XMIN(o), y);
-        while (line->size > start && remaining_space > 0 && str[start])
+        while (end > start && remaining_space > 0)
         {
-            /* Identify a batch of characters with the same fgpen/bgpen
-               to avoid having to move/set pens and do Text() on single
-               characters */
+            /* Each attribute run is drawn with a single Text(), unless
+               the selection starts or ends within it */
+
+            struct charmap_attr *a;
+            ULONG runend;
+
+            while (attr + 1 < line->numattrs &&
+                line->attrs[attr + 1].start <= start)
+                attr++;
+            a = &line->attrs[attr];
+            runend = attr + 1 < line->numattrs ?
+                line->attrs[attr + 1].start : end;
 
-            UBYTE fgpen = line->fgpen[start];
-            UBYTE bgpen = line->bgpen[start];
+            UBYTE fgpen = a->fgpen;
+            UBYTE bgpen = a->bgpen;
 
             /* Is any part of this line part of a selection?
              * If so, we bake in a state transition on "stop".
@@ -863,26 +897,26 @@ static VOID charmapcon_refresh_lines(Class *cl, Object *o, LONG fromLine,
 
             if (in_selection)
             {
-                fgpen = line->bgpen[start];
-                bgpen = line->fgpen[start];
+                fgpen = a->bgpen;
+                bgpen = a->fgpen;
             }
 
-            ULONG len = 0;
-            while (line->size > start + len && str[start + len] &&
-                len < remaining_space &&
-                line->fgpen[start] == line->fgpen[start + len] &&
-                line->bgpen[start] == line->bgpen[start + len] &&
-                line->flags[start] == line->flags[start + len] &&
-                start + len < stop)
-                len += 1;
-
-            setabpen(GfxBase, rp, line->flags[start], fgpen, bgpen);
-            if ((line->flags[start] & CON_TXTFLAGS_MASK) !=
+            if (runend > end)
+                runend = end;
+            if (runend > stop)
+                runend = stop;
+
+            ULONG len = runend - start;
+            if (len > remaining_space)
+                len = remaining_space;
+
+            setabpen(GfxBase, rp, a->flags, fgpen, bgpen);
+            if ((a->flags & CON_TXTFLAGS_MASK) !=
                 (flags & CON_TXTFLAGS_MASK))
             {
-                SetSoftStyle(rp, line->flags[start], CON_TXTFLAGS_MASK);
+                SetSoftStyle(rp, a->flags, CON_TXTFLAGS_MASK);
             }
-            flags = line->flags[start];
+            flags = a->flags;
 
             Text(rp, &str[start], len);
 
@@ -903,10 +937,7 @@ static VOID charmapcon_refresh_lines(Class *cl, Object *o, LONG fromLine,
            etc.
          */
         if (!line->next && yc <= toLine)
-        {
-            line->next = charmap_newline(0, line);
-            data->scrollback_size += 1;
-        }
+            charmapcon_add_line(data);
         line = line->next;
     }
 
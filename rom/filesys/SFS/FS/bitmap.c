@@ -1,12 +1,15 @@
 #include "asmsupport.h"
 
 #include <clib/macros.h>
+#include <devices/timer.h>
 #include <dos/dos.h>
 #include <exec/types.h>
 #include <proto/exec.h>
+#include <proto/timer.h>
 
 #include "bitmap.h"
 #include "cachebuffers_protos.h"
+#include "freespacetree_protos.h"
 #include "debug.h"
 #include "objects.h"
 #include "transactions_protos.h"
@@ -77,8 +80,36 @@ static BOOL enoughspace(ULONG blocks) {
 LONG availablespace(BLCK block,ULONG maxneeded);
 
 
+static void starttiming(struct EClockVal *ev) {
+  ReadEClock(ev);
+}
+
+
+
+static void stoptiming(struct EClockVal *start) {
+  struct EClockVal ev;
+  UQUAD ticks;
+
+  /* Keeps track of how long the space allocation functions take, so
+     the effect of the free space tree can be seen with SFSQuery. */
+
+  globals->statistics.eclock_freq=ReadEClock(&ev);
+
+  ticks=(((UQUAD)ev.ev_hi<<32) | ev.ev_lo) - (((UQUAD)start->ev_hi<<32) | start->ev_lo);
+
+  globals->statistics.alloc_calls++;
+  globals->statistics.alloc_ticks+=ticks;
+  if(ticks>globals->statistics.alloc_maxticks) {
+    globals->statistics.alloc_maxticks=ticks>0xFFFFFFFF ? 0xFFFFFFFF : (ULONG)ticks;
+  }
+}
+
+
+
 LONG markspace(BLCK block,ULONG blocks) {
+  BLCK firstblock=block;
   ULONG freeblocks;
+  ULONG totalblocks=blocks;
   LONG errorcode;
 
   _XDEBUG(DEBUG_BITMAP,"markspace: Marking %ld blocks from block %ld\n",blocks,block);
@@ -115,14 +146,18 @@ LONG markspace(BLCK block,ULONG blocks) {
           block=0;
 
           if((errorcode=storecachebuffer(cb))!=0) {
+            stalefreespacetree();
             return(errorcode);
           }
         }
         else {
+          stalefreespacetree();
           return(errorcode);
         }
       }
 
+      freespacetree_mark(firstblock,totalblocks);
+
       // block_rovingblockptr=newrovingptr;
       // if(block_rovingblockptr>=blocks_total) {
       //   block_rovingblockptr=0;
@@ -136,7 +171,9 @@ LONG markspace(BLCK block,ULONG blocks) {
 
 
 LONG freespace(BLCK block,ULONG blocks) {
+  BLCK firstblock=block;
   ULONG freeblocks;
+  ULONG totalblocks=blocks;
   LONG errorcode;
 
   _XDEBUG(DEBUG_BITMAP,"freespace: Freeing %ld blocks from block %ld\n",blocks,block);
@@ -167,13 +204,17 @@ LONG freespace(BLCK block,ULONG blocks) {
           block=0;
 
           if((errorcode=storecachebuffer(cb))!=0) {
+            stalefreespacetree();
             return(errorcode);
           }
         }
         else {
+          stalefreespacetree();
           return(errorcode);
         }
       }
+
+      freespacetree_free(firstblock,totalblocks);
     }
   }
 
@@ -243,6 +284,10 @@ LONG availablespace(BLCK block,ULONG maxneeded) {
      an allocated block is encountered or until maxneeded has been
      exceeded. */
 
+  if(usefreespacetree()!=FALSE) {
+    return(freespacetree_available(block));
+  }
+
   bitstart=block % globals->blocks_inbitmap;
 
   while(nextblock<maxbitmapblock && (errorcode=readcachebuffercheck(&cb,nextblock++,BITMAP_ID))==0) {
@@ -287,6 +332,10 @@ LONG allocatedspace(BLCK block,ULONG maxneeded) {
      an allocated block is encountered or until maxneeded has been
      exceeded. */
 
+  if(usefreespacetree()!=FALSE) {
+    return(freespacetree_allocated(block));
+  }
+
   bitstart=block % globals->blocks_inbitmap;
 
   while(nextblock<maxbitmapblock && (errorcode=readcachebuffercheck(&cb,nextblock++,BITMAP_ID))==0) {
@@ -352,6 +401,11 @@ LONG findspace2(ULONG maxneeded, BLCK start, BLCK end, BLCK *returned_block, ULO
           9             1        2........1
          10             2        11........ */
 
+  if(usefreespacetree()!=FALSE) {
+    freespacetree_findspace(maxneeded, start, end, returned_block, returned_blocks);
+    return(0);
+  }
+
   if(start>=globals->blocks_total) {
     start-=globals->blocks_total;
   }
@@ -504,15 +558,25 @@ LONG findspace(ULONG blocksneeded, BLCK startblock, BLCK endblock, BLCK *returne
 
 
 LONG findandmarkspace(ULONG blocksneeded, BLCK *returned_block) {
+  struct EClockVal start;
   LONG errorcode;
 
   // This function is currently only used by AdminSpace allocation. */
 
+  starttiming(&start);
+
   if(enoughspace(blocksneeded)!=FALSE) {
 
 //  if((errorcode=findspace(blocksneeded, block_rovingblockptr, block_rovingblockptr, returned_block))==0)
 
-    if((errorcode=findspace(blocksneeded, 0, globals->blocks_total, returned_block))==0) {
+    /* AdminSpace containers are small and never grow, so they are placed
+       in the smallest free area which fits when the free space tree is
+       available.  This keeps the large free areas intact for file data. */
+
+    if(freespacetree_bestfit(blocksneeded, returned_block)!=FALSE) {
+      errorcode=markspace(*returned_block,blocksneeded);
+    }
+    else if((errorcode=findspace(blocksneeded, 0, globals->blocks_total, returned_block))==0) {
       errorcode=markspace(*returned_block,blocksneeded);
     }
   }
@@ -520,12 +584,14 @@ LONG findandmarkspace(ULONG blocksneeded, BLCK *returned_block) {
     errorcode=ERROR_DISK_FULL;
   }
 
+  stoptiming(&start);
+
   return(errorcode);
 }
 
 
 
-LONG smartfindandmarkspace(BLCK startblock,ULONG blocksneeded) {
+static LONG smartfindandmarkspace2(BLCK startblock,ULONG blocksneeded) {
   LONG freeblocks,allocblocks;
   BLCK block=startblock;
   ULONG blocksfound=0;
@@ -682,6 +748,19 @@ LONG smartfindandmarkspace(BLCK startblock,ULONG blocksneeded) {
 
 
 
+LONG smartfindandmarkspace(BLCK startblock,ULONG blocksneeded) {
+  struct EClockVal start;
+  LONG errorcode;
+
+  starttiming(&start);
+  errorcode=smartfindandmarkspace2(startblock, blocksneeded);
+  stoptiming(&start);
+
+  return(errorcode);
+}
+
+
+
 
 /*
 
@@ -731,6 +810,12 @@ LONG findspace2_backwards(ULONG maxneeded, BLCK start, BLCK end, BLCK *returned_
 
   breakpoint=(start<end ? start : 0);
 */
+
+  if(usefreespacetree()!=FALSE) {
+    freespacetree_findspace_backwards(maxneeded, start, end, returned_block, returned_blocks);
+    return(0);
+  }
+
   breakpoint=start;
 
   *returned_block=0;
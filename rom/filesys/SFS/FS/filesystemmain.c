@@ -46,6 +46,7 @@
 #include "bitmap_protos.h"
 #include "btreenodes_protos.h"
 #include "cachebuffers_protos.h"
+#include "freespacetree_protos.h"
 #include "debug.h"
 #include "locks_protos.h"
 #include "nodes_protos.h"
@@ -438,6 +439,7 @@ LONG mainprogram(struct ExecBase *SysBase) {
                                                             }
                                                         }
 
+                                                        freefreespacetree();
                                                         cleanuptransactions();
                                                     }
 
@@ -874,6 +876,24 @@ void mainloop(void) {
                         case ASQ_INACTIVITY_FLUSH_TIMEOUT:
                             tag->ti_Data = globals->inactivity_timeout;
                             break;
+                        case ASQ_FREE_EXTENTS:
+                            tag->ti_Data = usefreespacetree() ? globals->freeextents : 0;
+                            break;
+                        case ASQ_ALLOC_CALLS:
+                            tag->ti_Data = globals->statistics.alloc_calls;
+                            break;
+                        case ASQ_ALLOC_AVERAGE_TIME:
+                            tag->ti_Data = 0;
+                            if(globals->statistics.alloc_calls != 0 && globals->statistics.eclock_freq != 0) {
+                                tag->ti_Data = (ULONG)(globals->statistics.alloc_ticks * 1000000 / globals->statistics.eclock_freq / globals->statistics.alloc_calls);
+                            }
+                            break;
+                        case ASQ_ALLOC_MAXIMUM_TIME:
+                            tag->ti_Data = 0;
+                            if(globals->statistics.eclock_freq != 0) {
+                                tag->ti_Data = (ULONG)((UQUAD)globals->statistics.alloc_maxticks * 1000000 / globals->statistics.eclock_freq);
+                            }
+                            break;
                         }
                     }
 
@@ -3044,6 +3064,7 @@ void invalidatecaches() {
 
     invalidatecachebuffers();
     invalidateiocaches();
+    freefreespacetree();
 }
 
 
@@ -3290,9 +3311,16 @@ LONG initdisk() {
                         UWORD cnt = globals->blocks_bitmap;
                         WORD n;
 
+                        /* The free space tree is built while we're at it, so
+                           the bitmap doesn't have to be read twice. */
+
+                        beginfreespacetree();
+
                         while(cnt-- > 0 && (errorcode = readcachebuffercheck(&cb, bitmapblock, BITMAP_ID)) == 0) {
                             b = cb->data;
 
+                            addbitmaptofreespacetree(b->bitmap, (bitmapblock - globals->block_bitmapbase) * globals->blocks_inbitmap);
+
                             for(n = 0; n < ((WORD)((globals->bytes_block - sizeof(struct fsBitmap)) >> 2)); n++) {
                                 if(b->bitmap[n] != 0) {
                                     if(b->bitmap[n] == 0xFFFFFFFF) {
@@ -3304,6 +3332,8 @@ LONG initdisk() {
                             }
                             bitmapblock++;
                         }
+
+                        endfreespacetree(errorcode);
                     }
 
                     unlockcachebuffer(cb);
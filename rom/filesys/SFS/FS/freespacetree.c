@@ -0,0 +1,504 @@
+#include "asmsupport.h"
+
+#include <clib/macros.h>
+#include <dos/dos.h>
+#include <exec/memory.h>
+#include <exec/types.h>
+#include <proto/exec.h>
+
+#include "bitmap.h"
+#include "cachebuffers_protos.h"
+#include "freespacetree.h"
+#include "freespacetree_protos.h"
+#include "debug.h"
+#include "req_protos.h"
+#include "support_protos.h"
+#include "globals.h"
+
+extern LONG readcachebuffercheck(struct CacheBuffer **,ULONG,ULONG);
+
+/* Searching the bitmap for free space means reading bitmap blocks through
+   the cache, which becomes slow on large and fragmented volumes.  This
+   file keeps a copy of the free space in memory as a tree of extents.
+   It is built from the bitmap when the disk is inserted, and markspace()
+   and freespace() keep it up to date afterwards.
+
+   The bitmap stays the authority: when a transaction is deleted the
+   bitmap returns to an older state, and the tree is marked stale and
+   rebuilt the next time it is needed.  If there isn't enough memory for
+   the tree, the bitmap is searched like before. */
+
+/* Definitions for Red Black tree */
+
+#define ROOT     globals->freeextentroot       /* The name of the root variable */
+#define RBNODE   struct FreeExtent   /* The name of the structure containing the left,
+                                        right, parent, nodecolor & data fields. */
+#define SENTINEL globals->freeextentsentinel   /* The name of the sentinel node variable (must be a RBNODE) */
+#define DATA     block               /* The name of the data field (example: data, sub.mydata) */
+
+#define CompLT(a,b) (a < b)      /* modify these lines to establish data type */
+#define CompEQ(a,b) (a == b)
+
+#include "redblacktree.c"
+
+#define POOLSIZE (sizeof(struct FreeExtent)*128)
+
+
+
+static void addtoclass(struct FreeExtent *fe) {
+  struct FreeExtent **head=&globals->freeclass[fe->sizeclass=fls(fe->blocks)-1];
+
+  fe->classprev=0;
+  if((fe->classnext=*head)!=0) {
+    fe->classnext->classprev=fe;
+  }
+  *head=fe;
+}
+
+
+
+static void removefromclass(struct FreeExtent *fe) {
+  if(fe->classprev!=0) {
+    fe->classprev->classnext=fe->classnext;
+  }
+  else {
+    globals->freeclass[fe->sizeclass]=fe->classnext;
+  }
+
+  if(fe->classnext!=0) {
+    fe->classnext->classprev=fe->classprev;
+  }
+}
+
+
+
+static void resizeextent(struct FreeExtent *fe, BLCK block, ULONG blocks) {
+
+  /* Changing the first block in place is allowed, as long as the extent
+     doesn't overlap its neighbours -- the tree order stays the same. */
+
+  fe->block=block;
+  if(fls(blocks)-1!=fe->sizeclass) {
+    removefromclass(fe);
+    fe->blocks=blocks;
+    addtoclass(fe);
+  }
+  else {
+    fe->blocks=blocks;
+  }
+}
+
+
+
+static void removeextent(struct FreeExtent *fe) {
+  removefromclass(fe);
+  DeleteNode(fe);
+  FreePooled(globals->freeextentpool, fe, sizeof(struct FreeExtent));
+  globals->freeextents--;
+}
+
+
+
+static void droptree(UBYTE newstate) {
+  if(globals->freeextentpool!=0) {
+    DeletePool(globals->freeextentpool);
+    globals->freeextentpool=0;
+  }
+
+  InitRedBlackTree();
+  ClearMemQuick(globals->freeclass, sizeof(globals->freeclass));
+  globals->freeextents=0;
+  globals->freetreestate=newstate;
+}
+
+
+
+static BOOL insertextent(BLCK block, ULONG blocks) {
+  struct FreeExtent *fe;
+
+  if((fe=AllocPooled(globals->freeextentpool, sizeof(struct FreeExtent)))==0) {
+    _DEBUG("freespacetree: out of memory, falling back to the bitmap\n");
+    droptree(FREETREE_NONE);
+    return(FALSE);
+  }
+
+  fe->block=block;
+  fe->blocks=blocks;
+  InsertNode(fe);
+  addtoclass(fe);
+  globals->freeextents++;
+
+  return(TRUE);
+}
+
+
+
+static struct FreeExtent *PrevNode(struct FreeExtent *n) {
+  if(n->left != &SENTINEL) {
+    n=n->left;
+    while(n->right != &SENTINEL) {
+      n=n->right;
+    }
+    return(n);
+  }
+
+  while(n->parent!=0) {
+    if(n->parent->right == n) {
+      break;
+    }
+
+    n=n->parent;
+  }
+
+  return(n->parent);
+}
+
+
+
+static struct FreeExtent *findextent(BLCK block) {
+  struct FreeExtent *current=ROOT;
+  struct FreeExtent *found=0;
+
+  /* Returns the last extent starting at or before /block/, or 0 if
+     there is none.  The extent doesn't necessarily contain /block/. */
+
+  while(current != &SENTINEL) {
+    if(current->block <= block) {
+      found=current;
+      current=current->right;
+    }
+    else {
+      current=current->left;
+    }
+  }
+
+  return(found);
+}
+
+
+
+static void addextent(BLCK block, ULONG blocks) {
+  struct FreeExtent *prev, *next;
+
+  prev=findextent(block);
+  next=(prev!=0 ? NextNode(prev) : FirstNode());
+
+  if((prev!=0 && prev->block+prev->blocks>block) || (next!=0 && next->block<block+blocks)) {
+    req_unusual("Freed %ld blocks from block %ld,\n but some of them were already free.", blocks, block);
+    droptree(FREETREE_STALE);
+    return;
+  }
+
+  if(prev!=0 && prev->block+prev->blocks==block) {
+    if(next!=0 && next->block==block+blocks) {
+      ULONG nextblocks=next->blocks;
+
+      removeextent(next);
+      resizeextent(prev, prev->block, prev->blocks+blocks+nextblocks);
+    }
+    else {
+      resizeextent(prev, prev->block, prev->blocks+blocks);
+    }
+  }
+  else if(next!=0 && next->block==block+blocks) {
+    resizeextent(next, block, next->blocks+blocks);
+  }
+  else {
+    insertextent(block, blocks);
+  }
+}
+
+
+
+void beginfreespacetree(void) {
+
+  /* Starts building a new tree.  Feed it every bitmap block in order
+     using addbitmaptofreespacetree(), and finish with endfreespacetree(). */
+
+  droptree(FREETREE_NONE);
+
+  globals->freeextentpool=CreatePool(0, POOLSIZE, POOLSIZE);
+}
+
+
+
+void addbitmaptofreespacetree(ULONG *bitmap, BLCK firstblock) {
+  ULONG longs=globals->blocks_inbitmap>>5;
+  LONG bitstart, bitend=0;
+  BLCK block;
+  ULONG blocks;
+
+  while(globals->freeextentpool!=0 && bitend<(LONG)globals->blocks_inbitmap && (bitstart=bmffo(bitmap, longs, bitend))<(LONG)globals->blocks_inbitmap) {
+    bitend=bmffz(bitmap, longs, bitstart);
+
+    block=firstblock+bitstart;
+    if(block>=globals->blocks_total) {
+      break;
+    }
+
+    blocks=bitend-bitstart;
+    if(block+blocks>globals->blocks_total) {
+      blocks=globals->blocks_total-block;
+    }
+
+    addextent(block, blocks);
+  }
+}
+
+
+
+void endfreespacetree(LONG errorcode) {
+  if(globals->freeextentpool!=0 && errorcode==0) {
+    _DEBUG("freespacetree: %ld extents of free space\n", globals->freeextents);
+    globals->freetreestate=FREETREE_VALID;
+  }
+  else {
+    droptree(FREETREE_NONE);
+  }
+}
+
+
+
+void freefreespacetree(void) {
+  droptree(FREETREE_NONE);
+}
+
+
+
+void stalefreespacetree(void) {
+  if(globals->freetreestate!=FREETREE_NONE) {
+    droptree(FREETREE_STALE);
+  }
+}
+
+
+
+BOOL usefreespacetree(void) {
+
+  /* Returns TRUE if the tree can be used instead of the bitmap,
+     rebuilding it first if it went stale. */
+
+  if(globals->freetreestate==FREETREE_STALE) {
+    struct CacheBuffer *cb;
+    BLCK bitmapblock;
+    LONG errorcode=0;
+
+    _DEBUG("freespacetree: rebuilding\n");
+
+    beginfreespacetree();
+
+    for(bitmapblock=0; bitmapblock<globals->blocks_bitmap && globals->freeextentpool!=0; bitmapblock++) {
+      if((errorcode=readcachebuffercheck(&cb, globals->block_bitmapbase+bitmapblock, BITMAP_ID))!=0) {
+        break;
+      }
+
+      addbitmaptofreespacetree(((struct fsBitmap *)cb->data)->bitmap, bitmapblock*globals->blocks_inbitmap);
+    }
+
+    endfreespacetree(errorcode);
+  }
+
+  return((BOOL)(globals->freetreestate==FREETREE_VALID));
+}
+
+
+
+void freespacetree_mark(BLCK block, ULONG blocks) {
+  struct FreeExtent *fe;
+  BLCK end;
+
+  if(globals->freetreestate!=FREETREE_VALID) {
+    return;
+  }
+
+  if((fe=findextent(block))==0 || fe->block+fe->blocks<block+blocks) {
+    droptree(FREETREE_STALE);
+    return;
+  }
+
+  end=fe->block+fe->blocks;
+
+  if(fe->block==block) {
+    if(fe->blocks==blocks) {
+      removeextent(fe);
+    }
+    else {
+      resizeextent(fe, block+blocks, fe->blocks-blocks);
+    }
+  }
+  else {
+    resizeextent(fe, fe->block, block-fe->block);
+    if(block+blocks<end) {
+      insertextent(block+blocks, end-(block+blocks));
+    }
+  }
+}
+
+
+
+void freespacetree_free(BLCK block, ULONG blocks) {
+  if(globals->freetreestate==FREETREE_VALID) {
+    addextent(block, blocks);
+  }
+}
+
+
+
+LONG freespacetree_available(BLCK block) {
+  struct FreeExtent *fe;
+
+  /* Same as availablespace(), but never limited by maxneeded. */
+
+  if((fe=findextent(block))!=0 && fe->block+fe->blocks>block) {
+    return(fe->block+fe->blocks-block);
+  }
+
+  return(0);
+}
+
+
+
+LONG freespacetree_allocated(BLCK block) {
+  struct FreeExtent *fe;
+
+  /* Same as allocatedspace(), but never limited by maxneeded.  Returns
+     the number of blocks up to the end of the volume if there is no more
+     free space after /block/. */
+
+  if((fe=findextent(block))!=0) {
+    if(fe->block+fe->blocks>block) {
+      return(0);
+    }
+    fe=NextNode(fe);
+  }
+  else {
+    fe=FirstNode();
+  }
+
+  if(fe!=0) {
+    return(fe->block-block);
+  }
+
+  return(block<globals->blocks_total ? globals->blocks_total-block : 0);
+}
+
+
+
+BOOL freespacetree_bestfit(ULONG blocksneeded, BLCK *returned_block) {
+  struct FreeExtent *fe, *best=0;
+  WORD class;
+
+  /* Finds the smallest extent which can hold /blocksneeded/ blocks.  Only
+     the size class of /blocksneeded/ has to be searched for an extent which
+     is large enough; in any higher class every extent will do, so the
+     smallest of the first non-empty one is taken. */
+
+  if(usefreespacetree()==FALSE) {
+    return(FALSE);
+  }
+
+  for(class=MAX(fls(blocksneeded)-1, 0); class<FREECLASSES && best==0; class++) {
+    for(fe=globals->freeclass[class]; fe!=0; fe=fe->classnext) {
+      if(fe->blocks>=blocksneeded && (best==0 || fe->blocks<best->blocks || (fe->blocks==best->blocks && fe->block<best->block))) {
+        best=fe;
+        if(fe->blocks==blocksneeded) {
+          break;
+        }
+      }
+    }
+  }
+
+  if(best!=0) {
+    *returned_block=best->block;
+    return(TRUE);
+  }
+
+  return(FALSE);
+}
+
+
+
+static BOOL checkrun(BLCK runstart, BLCK runend, ULONG maxneeded, BLCK *returned_block, ULONG *returned_blocks) {
+  ULONG space=runend-runstart;
+
+  if(runend>runstart && *returned_blocks<space) {
+    *returned_block=runstart;
+    if(space>=maxneeded) {
+      *returned_blocks=maxneeded;
+      return(TRUE);
+    }
+    *returned_blocks=space;
+  }
+
+  return(FALSE);
+}
+
+
+
+static BOOL findinarea(ULONG maxneeded, BLCK start, BLCK end, BLCK *returned_block, ULONG *returned_blocks) {
+  struct FreeExtent *fe;
+
+  if((fe=findextent(start))==0) {
+    fe=FirstNode();
+  }
+
+  while(fe!=0 && fe->block<end) {
+    if(checkrun(MAX(fe->block, start), MIN(fe->block+fe->blocks, end), maxneeded, returned_block, returned_blocks)!=FALSE) {
+      return(TRUE);
+    }
+    fe=NextNode(fe);
+  }
+
+  return(FALSE);
+}
+
+
+
+void freespacetree_findspace(ULONG maxneeded, BLCK start, BLCK end, BLCK *returned_block, ULONG *returned_blocks) {
+
+  /* Same as findspace2(), including the wrap-around search area when
+     start>=end. */
+
+  if(start>=globals->blocks_total) {
+    start-=globals->blocks_total;
+  }
+
+  if(end==0) {
+    end=globals->blocks_total;
+  }
+
+  *returned_block=0;
+  *returned_blocks=0;
+
+  if(findinarea(maxneeded, start, start<end ? end : globals->blocks_total, returned_block, returned_blocks)==FALSE && start>=end) {
+    findinarea(maxneeded, 0, end, returned_block, returned_blocks);
+  }
+}
+
+
+
+void freespacetree_findspace_backwards(ULONG maxneeded, BLCK start, BLCK end, BLCK *returned_block, ULONG *returned_blocks) {
+  struct FreeExtent *fe;
+
+  /* Same as findspace2_backwards(): searches from /end/ (exclusive) down
+     to /start/, and returns the last /maxneeded/ blocks of the first run
+     large enough, or the largest run found. */
+
+  *returned_block=0;
+  *returned_blocks=0;
+
+  for(fe=findextent(end-1); fe!=0 && fe->block+fe->blocks>start; fe=PrevNode(fe)) {
+    BLCK runstart=MAX(fe->block, start);
+    BLCK runend=MIN(fe->block+fe->blocks, end);
+
+    if(runend>runstart && *returned_blocks<runend-runstart) {
+      *returned_block=runstart;
+      if(runend-runstart>=maxneeded) {
+        *returned_block=runend-maxneeded;
+        *returned_blocks=maxneeded;
+        return;
+      }
+      *returned_blocks=runend-runstart;
+    }
+  }
+}
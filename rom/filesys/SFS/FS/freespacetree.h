@@ -0,0 +1,35 @@
+#ifndef _FREESPACETREE_H
+#define _FREESPACETREE_H
+
+#include <exec/types.h>
+#include "blockstructure.h"
+#include "redblacktree.h"
+
+/* The free space of the volume is kept in memory as a red-black tree of
+   extents of free blocks, sorted on their first block.  Every extent is
+   also linked into a list for its size class (the highest bit set in
+   its size), which is used to quickly find the best fitting extent. */
+
+#define FREECLASSES (32)
+
+struct FreeExtent {
+  struct FreeExtent *left;
+  struct FreeExtent *right;
+  struct FreeExtent *parent;
+  NodeColor color;
+  UBYTE sizeclass;
+
+  struct FreeExtent *classnext;
+  struct FreeExtent *classprev;
+
+  BLCK block;
+  ULONG blocks;
+};
+
+/* Defines for globals->freetreestate: */
+
+#define FREETREE_NONE   (0)    /* No tree, the bitmap is searched instead. */
+#define FREETREE_VALID  (1)    /* The tree matches the bitmap. */
+#define FREETREE_STALE  (2)    /* The bitmap changed behind the tree's back; rebuild before use. */
+
+#endif // _FREESPACETREE_H
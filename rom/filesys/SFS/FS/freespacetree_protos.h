@@ -0,0 +1,23 @@
+#ifndef _FREESPACETREE_PROTOS_H
+#define _FREESPACETREE_PROTOS_H
+
+#include <exec/types.h>
+#include "blockstructure.h"
+
+void beginfreespacetree(void);
+void addbitmaptofreespacetree(ULONG *bitmap, BLCK firstblock);
+void endfreespacetree(LONG errorcode);
+void freefreespacetree(void);
+void stalefreespacetree(void);
+BOOL usefreespacetree(void);
+
+void freespacetree_mark(BLCK block, ULONG blocks);
+void freespacetree_free(BLCK block, ULONG blocks);
+
+LONG freespacetree_available(BLCK block);
+LONG freespacetree_allocated(BLCK block);
+BOOL freespacetree_bestfit(ULONG blocksneeded, BLCK *returned_block);
+void freespacetree_findspace(ULONG maxneeded, BLCK start, BLCK end, BLCK *returned_block, ULONG *returned_blocks);
+void freespacetree_findspace_backwards(ULONG maxneeded, BLCK start, BLCK end, BLCK *returned_block, ULONG *returned_blocks);
+
+#endif // _FREESPACETREE_PROTOS_H
@@ -86,6 +86,11 @@ struct fsStatistics {
 
   ULONG cachedio_hits;
   ULONG cachedio_misses;
+
+  ULONG alloc_calls;         /* Calls to findandmarkspace() and smartfindandmarkspace() */
+  ULONG alloc_maxticks;      /* Slowest of those in EClock ticks */
+  UQUAD alloc_ticks;         /* Total time spent in them in EClock ticks */
+  ULONG eclock_freq;
 };
 
 #endif // _FS_H
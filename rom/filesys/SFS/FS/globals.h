@@ -10,6 +10,7 @@
 #include "deviceio.h"
 #include "bitmap.h"
 #include "transactions.h"
+#include "freespacetree.h"
 #include "nodes.h"
 #include "fs.h"
 
@@ -178,6 +179,13 @@ struct SFSBase
     struct Operation *operationroot;
     struct Operation operationsentinel;
 
+    struct FreeExtent *freeextentroot;
+    struct FreeExtent freeextentsentinel;
+    struct FreeExtent *freeclass[FREECLASSES];   /* Extents by size class, see freespacetree.h */
+    void *freeextentpool;
+    ULONG freeextents;                /* Number of extents in the free space tree */
+    UBYTE freetreestate;              /* FREETREE_NONE, FREETREE_VALID or FREETREE_STALE */
+
     #define IOC_HASHSHIFT (6)
     #define IOC_HASHSIZE (1<<IOC_HASHSHIFT)
     
@@ -55,6 +55,16 @@
 
 #define ASQ_VERSION                 (ASQBASE+5001)  /* Returns (Major Version)*65536 + (Minor Version) */
 
+/* Space allocation */
+
+#define ASQ_FREE_EXTENTS            (ASQBASE+6001)  /* Number of free areas in the free space tree,
+                                                        or zero if the tree is not in use. */
+#define ASQ_ALLOC_CALLS             (ASQBASE+6002)  /* Number of space allocations made. */
+#define ASQ_ALLOC_AVERAGE_TIME      (ASQBASE+6003)  /* Average time in microseconds a space
+                                                        allocation took. */
+#define ASQ_ALLOC_MAXIMUM_TIME      (ASQBASE+6004)  /* Longest time in microseconds a space
+                                                        allocation took. */
+
 /* Defines for ASQ_DEVICE_API: */
 
 #define ASQDA_NORMAL     (0)
@@ -2,7 +2,8 @@
 #include "redblacktree.h"
 
 /* The constants below must be defined in the file which includes
-   the redblacktree.c code. */
+   the redblacktree.c code.  All functions are static, so more than
+   one file can include it for its own tree. */
 
 #if 0
 
@@ -33,13 +34,15 @@ struct RBTreeNode {
 
 /* prototypes */
 
-void InsertNode(RBNODE *X);
+static void InsertNode(RBNODE *X);
 static void DeleteNode(RBNODE *X);
-void InsertFixup(RBNODE *X);
+static void InsertFixup(RBNODE *X);
 static void DeleteFixup(RBNODE *X);
-void RotateLeft(RBNODE *X);
-void RotateRight(RBNODE *X);
-RBNODE *FindNode(unsigned long data);
+static void RotateLeft(RBNODE *X);
+static void RotateRight(RBNODE *X);
+#ifdef RBT_NEED_FINDNODE
+static RBNODE *FindNode(unsigned long data);
+#endif
 
 #if 0
 #define NIL &SENTINEL           /* all leafs are sentinels */
@@ -50,7 +53,7 @@ RBNODE *Root = NULL;               /* root of red-black tree */
 
 
 
-void InitRedBlackTree(void) {
+static void InitRedBlackTree(void) {
   ROOT=&SENTINEL;
   SENTINEL.left=&SENTINEL;
   SENTINEL.right=&SENTINEL;
@@ -62,7 +65,7 @@ void InitRedBlackTree(void) {
 
 
 
-void InsertNode(RBNODE *X) {
+static void InsertNode(RBNODE *X) {
   RBNODE *current, *parent;
 
  /***********************************************
@@ -101,7 +104,7 @@ void InsertNode(RBNODE *X) {
 
 
 
-void InsertFixup(RBNODE *X) {
+static void InsertFixup(RBNODE *X) {
 
  /*************************************
   *  maintain red-black tree balance  *
@@ -160,7 +163,7 @@ void InsertFixup(RBNODE *X) {
   ROOT->color = BLACK;
 }
 
-void RotateLeft(RBNODE *X) {
+static void RotateLeft(RBNODE *X) {
 
  /**************************
   *  rotate Node X to left *
@@ -197,7 +200,7 @@ void RotateLeft(RBNODE *X) {
   }
 }
 
-void RotateRight(RBNODE *X) {
+static void RotateRight(RBNODE *X) {
 
  /****************************
   *  rotate Node X to right  *
@@ -307,7 +310,7 @@ static void DeleteNode(RBNODE *Z) {
   }
 }
 
-void DeleteFixup(RBNODE *X) {
+static void DeleteFixup(RBNODE *X) {
 
    /*************************************
     *  maintain red-black tree balance  *
@@ -394,7 +397,11 @@ static RBNODE *FindClosestNode(unsigned long data) {
 }
 #endif
 
-RBNODE *FindNode(unsigned long data) {
+/* Define RBT_NEED_FINDNODE before including this file to get FindNode()
+   and FindNodeFrom(). */
+
+#ifdef RBT_NEED_FINDNODE
+static RBNODE *FindNode(unsigned long data) {
   RBNODE *current = ROOT;
 
  /*******************************
@@ -414,7 +421,7 @@ RBNODE *FindNode(unsigned long data) {
 
 
 
-RBNODE *FindNodeFrom(RBNODE *current,unsigned long data) {
+static RBNODE *FindNodeFrom(RBNODE *current,unsigned long data) {
 
  /*******************************
   *  find node containing data  *
@@ -430,6 +437,7 @@ RBNODE *FindNodeFrom(RBNODE *current,unsigned long data) {
   }
   return(0);
 }
+#endif
 
 
 
@@ -459,16 +467,7 @@ static void FindAllNodes(RBNODE *current,unsigned long data) {
 #endif
 
 
-void WalkTree(RBNODE *current) {
-  if(current!=&SENTINEL) {
-    WalkTree(current->left);
-    WalkTree(current->right);
-  }
-}
-
-
-
-RBNODE *FirstNode(void) {
+static RBNODE *FirstNode(void) {
   RBNODE *n=ROOT;
 
   /* This function returns the first node, or 0 if there are no nodes at all. */
@@ -485,7 +484,7 @@ RBNODE *FirstNode(void) {
 }
 
 
-RBNODE *NextNode(RBNODE *n) {
+static RBNODE *NextNode(RBNODE *n) {
 //  cop(n, "nextnode 1");
 
   if(n->right != &SENTINEL) {
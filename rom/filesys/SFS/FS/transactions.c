@@ -12,6 +12,7 @@
 #include "cachebuffers_protos.h"
 #include "debug.h"
 #include "cachedio_protos.h"
+#include "freespacetree_protos.h"
 #include "req_protos.h"
 #include "support_protos.h"
 
@@ -46,6 +47,8 @@ void restorecachebuffer(struct CacheBuffer *cb);
 #define CompLT(a,b) (a < b)      /* modify these lines to establish data type */
 #define CompEQ(a,b) (a == b)
 
+#define RBT_NEED_FINDNODE
+
 #ifdef CHECKCODE_TRANSACTIONS
 void cop(struct Operation *o, UBYTE *where) {
   if(o->magicvalue!=0x4a4f) {
@@ -661,6 +664,11 @@ void deletetransaction(void) {
 
   _DEBUG("-DEL------>\n");
 
+  /* Any bitmap changes made in this transaction are about to be undone,
+     so the free space tree must be rebuilt from the restored bitmap. */
+
+  stalefreespacetree();
+
   o=FirstNode();
 
   while(o!=0) {
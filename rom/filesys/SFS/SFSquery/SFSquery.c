@@ -8,7 +8,7 @@
 #include "../FS/packets.h"
 #include "../FS/query.h"
 
-const char version[]="\0$VER: SFSquery 1.0 (" ADATE ")\r\n";
+const char version[]="\0$VER: SFSquery 1.1 (" ADATE ")\r\n";
 
 LONG main() {
   struct RDArgs *readarg;
@@ -64,6 +64,11 @@ LONG main() {
 
                 {ASQ_IS_CASESENSITIVE     , 0},
                 {ASQ_HAS_RECYCLED         , 0},
+
+                {ASQ_FREE_EXTENTS         , 0},
+                {ASQ_ALLOC_CALLS          , 0},
+                {ASQ_ALLOC_AVERAGE_TIME   , 0},
+                {ASQ_ALLOC_MAXIMUM_TIME   , 0},
                 {TAG_END                  , 0}
 	    };
 
@@ -109,6 +114,8 @@ LONG main() {
             }
 
             printf("DOS buffers      : %-8ld\n", tags[17].ti_Data);
+            printf("Free extents     : %-8ld   Allocations  : %ld\n", tags[20].ti_Data, tags[21].ti_Data);
+            printf("Allocation time  : %ld us average, %ld us maximum\n", tags[22].ti_Data, tags[23].ti_Data);
 
             printf("SFS settings     : ");
 
@@ -252,6 +252,7 @@
 #include "update_protos.h"
 #include "lru_protos.h"
 #include "ass_protos.h"
+#include "dirhash_protos.h"
 #include "support.c"
 
 void PFSDoNotify(struct fileinfo *object, BOOL checkparent, globaldata * g);
@@ -708,6 +709,7 @@ static BOOL SearchInDir(ULONG dirnodenr, STRPTR objectname, union objectinfo *in
 	struct canode anode;
 	struct cdirblock *dirblock;
 	struct direntry *entry = NULL;
+	struct dirhash *dh;
 	BOOL found = FALSE, eod = FALSE;
 	ULONG anodeoffset;
 	UBYTE intl_name[PATHSIZE];
@@ -720,6 +722,34 @@ static BOOL SearchInDir(ULONG dirnodenr, STRPTR objectname, union objectinfo *in
 		intl_name[0] = FILENAMESIZE - 1;
 
 	intltoupper(intl_name);     /* international uppercase objectname */
+
+	/* use the name index: only scan blocks with a matching hash */
+	if ((dh = GetDirHash(dirnodenr, g)))
+	{
+		ULONG hash = DirHashName(intl_name), cursor = 0, blocknr;
+
+		while (!found && (blocknr = DirHashNext(dh, hash, &cursor)))
+		{
+			if (!(dirblock = LoadDirBlock(blocknr, g)))
+				return FALSE;
+
+			for (entry = FIRSTENTRY(dirblock); entry->next; entry = NEXTENTRY(entry))
+			{
+				found = intlcmp(intl_name, DIRENTRYNAME(entry));
+				if (found)
+					break;
+			}
+		}
+
+		if (!found)
+			return FALSE;
+
+		info->file.direntry = entry;
+		info->file.dirblock = dirblock;
+		LOCK(dirblock);
+		return TRUE;
+	}
+
 	GetAnode(&anode, dirnodenr, g);
 	anodeoffset = 0;
 	dirblock = LoadDirBlock(anode.blocknr, g);
@@ -1844,6 +1874,8 @@ static BOOL DeleteDir(union objectinfo *info, SIPTR *error, globaldata * g)
 	}
 	else
 	{
+		FreeDirHash(anode.nr, g);
+
 		/* check if tobefreedcache is sufficiently large,
 		 * otherwise update disk
 		 */
@@ -3164,6 +3196,7 @@ static BOOL MoveToPrevious(struct fileinfo de, struct direntry *to, struct filei
 
 	LOCK(result->dirblock);
 	MakeBlockDirty((struct cachedblock *)result->dirblock, g);
+	DirHashAdd(result->dirblock, result->direntry, g);
 
 	/* remove old entry & make blocks dirty */
 	removedlen = de.direntry->next;
@@ -3181,11 +3214,12 @@ static void RenameInPlace(struct fileinfo from, struct direntry *to, struct file
 {
 	UBYTE *dest, *start, *end;
 	SIPTR error;
-	ULONG movelen;
+	ULONG movelen, oldhash;
 	int diff;
 	union objectinfo parent;
 
 	LOCK(from.dirblock);
+	oldhash = DirHashEntry(from.direntry, g);
 
 	/* change date parent */
 	if (GetParent((union objectinfo *)&from, &parent, &error, g))
@@ -3205,6 +3239,8 @@ static void RenameInPlace(struct fileinfo from, struct direntry *to, struct file
 	/* fill in result and make block dirty */
 	*result = from;
 	MakeBlockDirty((struct cachedblock *)from.dirblock, g);
+	DirHashRemove(from.dirblock, oldhash, g);
+	DirHashAdd(from.dirblock, from.direntry, g);
 
 	/* update references */
 	UpdateChangedRef(from, result, diff, g);
@@ -3221,10 +3257,12 @@ static void RemoveDirEntry(struct fileinfo info, globaldata * g)
 {
 	UBYTE *endofblok, *startofblok, *destofblok, *startofclear;
 	UWORD clearlen;
+	ULONG hash;
 	SIPTR error;
 	union objectinfo parent;
 
 	LOCK(info.dirblock);
+	hash = DirHashEntry(info.direntry, g);
 
 	/* change date parent %6.5 */
 	if (GetParent((union objectinfo *)&info, &parent, &error, g))
@@ -3242,6 +3280,7 @@ static void RemoveDirEntry(struct fileinfo info, globaldata * g)
 	if (info.direntry->next)
 		memset(startofclear, 0, clearlen);
 	MakeBlockDirty((struct cachedblock *)info.dirblock, g);     // %6.2
+	DirHashRemove(info.dirblock, hash, g);
 
 }
 
@@ -3267,9 +3306,10 @@ static BOOL AddDirectoryEntry(union objectinfo *dir, struct direntry *newentry,
 							  struct fileinfo *newinfo, globaldata * g)
 {
 	struct canode anode;
-	ULONG anodeoffset = 0, diranodenr;
+	ULONG anodeoffset = 0, diranodenr, blocknr;
 	struct cdirblock *blok;
 	struct direntry *entry = NULL;
+	struct dirhash *dh;
 	BOOL done = FALSE, eof = FALSE;
 	UCOUNT i;
 
@@ -3278,6 +3318,36 @@ static BOOL AddDirectoryEntry(union objectinfo *dir, struct direntry *newentry,
 	else
 		diranodenr = dir->file.direntry->anode;
 
+	/* let the name index point out a dirblock with enough space */
+	if ((dh = GetDirHash(diranodenr, g)))
+	{
+		while ((blocknr = DirHashFindSpace(dh, newentry->next, g)))
+		{
+			if (!(blok = LoadDirBlock(blocknr, g)))
+				return FALSE;
+
+			if ((entry = CheckFit(blok, newentry->next + 1, g)))
+			{
+				memcpy(entry, newentry, newentry->next);
+				*(UBYTE *)NEXTENTRY(entry) = 0;     // dirblock afsluiten
+				done = TRUE;
+				break;
+			}
+
+			/* index was wrong about this block */
+			DirHashUpdateBlock(blok, g);
+		}
+
+		/* all blocks full: the new one takes the parent from the first */
+		if (!done)
+		{
+			GetAnode(&anode, diranodenr, g);
+			if (!(blok = LoadDirBlock(anode.blocknr, g)))
+				return FALSE;
+			eof = TRUE;
+		}
+	}
+
 	/* check if space in existing dirblocks */
 	for (GetAnode(&anode, diranodenr, g); !done && !eof; eof = !NextBlock(&anode, &anodeoffset, g))
 	{
@@ -3337,7 +3407,7 @@ static BOOL AddDirectoryEntry(union objectinfo *dir, struct direntry *newentry,
 	{
 		LOCK(blok);
 		MakeBlockDirty((struct cachedblock *)blok, g);
-
+		DirHashAdd(blok, entry, g);
 	}
 	Touch(&dir->file, g);
 	return TRUE;
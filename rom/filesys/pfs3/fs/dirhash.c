@@ -0,0 +1,535 @@
+/* $Id$ */
+/*
+ * In-memory name index for directories.
+ *
+ * Looking up a name in a directory means reading every dirblock of it,
+ * which gets slow for directories with many thousands of entries. The
+ * index maps a hash of the (intl uppercase) name of every entry to the
+ * dirblock holding it, so a lookup only has to scan the blocks of entries
+ * whose hash matches, and a miss needs no disk access at all. For each
+ * dirblock the index also remembers how many bytes are in use, so
+ * AddDirectoryEntry() can go straight to a block with enough free space.
+ *
+ * Dirblocks are identified by block number. Offsets within a block change
+ * whenever an entry in front of them is removed, so those are not kept;
+ * the block itself is scanned instead. The index is built on first use of
+ * a directory and then kept up to date by the functions in directory.c
+ * that add, remove or rename entries, and by update.c when it moves or
+ * frees a dirblock. Whenever that fails the index is dropped, so it can
+ * never hide an existing entry.
+ *
+ * Memory is bounded: the indexes of a volume together hold at most
+ * DIRHASH_PERBUFFER entries per LRU buffer, least recently used indexes
+ * are dropped to make room, and directories that do not fit at all are
+ * marked as such and searched the old way. Running out of memory only
+ * drops an index; it is built again on the next lookup.
+ */
+
+#define __USE_SYSBASE
+
+/*
+ * includes
+ */
+
+#include <exec/types.h>
+#include <exec/memory.h>
+#include <dos/dos.h>
+#include <string.h>
+#include "debug.h"
+
+#include "blocks.h"
+#include "struct.h"
+#include "anodes_protos.h"
+#include "directory_protos.h"
+#include "dirhash_protos.h"
+#include "ass_protos.h"
+
+#define DIRHASH_PERBUFFER   256
+#define DIRHASH_MINENTRIES  64
+#define DIRHASH_MINSLOTS    8
+#define DIRHASH_NOSLOT      0xffffffffUL
+
+/* results of AddEntry() */
+#define DIRHASH_OK          0
+#define DIRHASH_NOMEM       1   /* out of memory, may work later */
+#define DIRHASH_FULL        2   /* over the volume limit on its own */
+
+struct dirhashentry
+{
+	ULONG hash;
+	ULONG next;         /* index+1 of next entry in chain, 0 = end */
+	ULONG slot;         /* dirblock holding the entry, DIRHASH_NOSLOT = free */
+};
+
+struct dirhashslot
+{
+	ULONG blocknr;      /* 0 = free slot */
+	UWORD used;         /* bytes used by entries */
+};
+
+struct dirhash
+{
+	struct dirhash *next;
+	struct dirhash *prev;
+	ULONG dirnodenr;
+	BOOL toobig;        /* directory too large, don't index */
+	ULONG numentries;
+	ULONG maxentries;   /* also the number of buckets */
+	ULONG freeentry;    /* index+1 of first free entry */
+	ULONG *buckets;
+	struct dirhashentry *entries;
+	ULONG numslots;
+	ULONG maxslots;
+	struct dirhashslot *slots;
+};
+
+#define DIRHASH_LIMIT(g) ((g)->glob_lrudata.poolsize * DIRHASH_PERBUFFER)
+
+/* FNV-1a over an intl uppercase DSTR */
+static ULONG HashName(UBYTE *name)
+{
+	ULONG hash = 2166136261UL;
+	UBYTE len = *name;
+
+	while (len--)
+		hash = (hash ^ *++name) * 16777619UL;
+
+	return hash;
+}
+
+ULONG DirHashName(UBYTE *intlname)
+{
+	return HashName(intlname);
+}
+
+ULONG DirHashEntry(struct direntry *de, globaldata *g)
+{
+	UBYTE name[PATHSIZE];
+
+	memcpy(name, DIRENTRYNAME(de), de->nlength + 1);
+	intltoupper(name);
+	return HashName(name);
+}
+
+static UWORD BlockUsed(struct cdirblock *blk)
+{
+	struct direntry *de;
+	UWORD used = 0;
+
+	for (de = FIRSTENTRY(blk); de->next; de = NEXTENTRY(de))
+		used += de->next;
+
+	return used;
+}
+
+static struct dirhash *FindDirHash(struct volumedata *volume, ULONG dirnodenr)
+{
+	struct dirhash *dh;
+
+	for (dh = HeadOf(&volume->dirhashes); dh->next; dh = dh->next)
+	{
+		if (dh->dirnodenr == dirnodenr)
+			return dh;
+	}
+
+	return NULL;
+}
+
+static void FreeDirHashArrays(struct volumedata *volume, struct dirhash *dh, globaldata *g)
+{
+	volume->dirhashentries -= dh->maxentries;
+	FreeMemP(dh->buckets, g);
+	FreeMemP(dh->entries, g);
+	FreeMemP(dh->slots, g);
+	dh->buckets = NULL;
+	dh->entries = NULL;
+	dh->slots = NULL;
+	dh->numentries = dh->maxentries = dh->freeentry = 0;
+	dh->numslots = dh->maxslots = 0;
+}
+
+static void DropDirHash(struct volumedata *volume, struct dirhash *dh, globaldata *g)
+{
+	DB(Trace(1, "DropDirHash", "dir %lx\n", dh->dirnodenr));
+	MinRemove(dh);
+	FreeDirHashArrays(volume, dh, g);
+	FreeMemP(dh, g);
+}
+
+/* Stop indexing a directory but remember it does not fit */
+static void MarkTooBig(struct volumedata *volume, struct dirhash *dh, globaldata *g)
+{
+	DB(Trace(1, "MarkTooBig", "dir %lx\n", dh->dirnodenr));
+	FreeDirHashArrays(volume, dh, g);
+	dh->toobig = TRUE;
+}
+
+/* Grow entry array and buckets of 'dh', evicting other indexes if needed */
+static int GrowEntries(struct volumedata *volume, struct dirhash *dh, globaldata *g)
+{
+	ULONG newmax = dh->maxentries ? dh->maxentries * 2 : DIRHASH_MINENTRIES;
+	ULONG *buckets;
+	struct dirhashentry *entries;
+	struct dirhash *victim;
+	ULONG i;
+
+	while (volume->dirhashentries - dh->maxentries + newmax > DIRHASH_LIMIT(g))
+	{
+		victim = (struct dirhash *)volume->dirhashes.mlh_TailPred;
+		if (victim == dh)
+			victim = dh->prev;
+		if (!victim->prev)      /* list header, nothing left to evict */
+			return DIRHASH_FULL;
+		DropDirHash(volume, victim, g);
+	}
+
+	buckets = AllocMemP(newmax * sizeof(ULONG), g);
+	entries = AllocMemP(newmax * sizeof(struct dirhashentry), g);
+	if (!buckets || !entries)
+	{
+		FreeMemP(buckets, g);
+		FreeMemP(entries, g);
+		return DIRHASH_NOMEM;
+	}
+
+	memset(buckets, 0, newmax * sizeof(ULONG));
+	if (dh->entries)
+		memcpy(entries, dh->entries, dh->maxentries * sizeof(struct dirhashentry));
+
+	/* rehash used entries, put the rest on the free list */
+	dh->freeentry = 0;
+	for (i = newmax; i-- > 0; )
+	{
+		if (i < dh->maxentries && entries[i].slot != DIRHASH_NOSLOT)
+		{
+			ULONG bucket = entries[i].hash & (newmax - 1);
+			entries[i].next = buckets[bucket];
+			buckets[bucket] = i + 1;
+		}
+		else
+		{
+			entries[i].slot = DIRHASH_NOSLOT;
+			entries[i].next = dh->freeentry;
+			dh->freeentry = i + 1;
+		}
+	}
+
+	FreeMemP(dh->buckets, g);
+	FreeMemP(dh->entries, g);
+	volume->dirhashentries += newmax - dh->maxentries;
+	dh->buckets = buckets;
+	dh->entries = entries;
+	dh->maxentries = newmax;
+	return DIRHASH_OK;
+}
+
+static int AddEntry(struct volumedata *volume, struct dirhash *dh, ULONG hash, ULONG slot, globaldata *g)
+{
+	struct dirhashentry *e;
+	ULONG i, bucket;
+	int error;
+
+	if (!dh->freeentry && (error = GrowEntries(volume, dh, g)) != DIRHASH_OK)
+		return error;
+
+	i = dh->freeentry - 1;
+	e = &dh->entries[i];
+	dh->freeentry = e->next;
+
+	bucket = hash & (dh->maxentries - 1);
+	e->hash = hash;
+	e->slot = slot;
+	e->next = dh->buckets[bucket];
+	dh->buckets[bucket] = i + 1;
+	dh->numentries++;
+	return DIRHASH_OK;
+}
+
+static BOOL RemoveEntry(struct dirhash *dh, ULONG hash, ULONG slot)
+{
+	ULONG *link, i;
+
+	for (link = &dh->buckets[hash & (dh->maxentries - 1)]; (i = *link); link = &dh->entries[i - 1].next)
+	{
+		struct dirhashentry *e = &dh->entries[i - 1];
+
+		if (e->hash == hash && e->slot == slot)
+		{
+			*link = e->next;
+			e->slot = DIRHASH_NOSLOT;
+			e->next = dh->freeentry;
+			dh->freeentry = i;
+			dh->numentries--;
+			return TRUE;
+		}
+	}
+
+	return FALSE;
+}
+
+static LONG FindSlot(struct dirhash *dh, ULONG blocknr)
+{
+	ULONG i;
+
+	for (i = 0; i < dh->numslots; i++)
+	{
+		if (dh->slots[i].blocknr == blocknr)
+			return i;
+	}
+
+	return -1;
+}
+
+static LONG AddSlot(struct dirhash *dh, ULONG blocknr, UWORD used, globaldata *g)
+{
+	struct dirhashslot *slots;
+	ULONG i;
+
+	/* reuse a slot of a freed dirblock */
+	for (i = 0; i < dh->numslots; i++)
+	{
+		if (!dh->slots[i].blocknr)
+			goto found;
+	}
+
+	if (dh->numslots == dh->maxslots)
+	{
+		ULONG newmax = dh->maxslots ? dh->maxslots * 2 : DIRHASH_MINSLOTS;
+
+		if (!(slots = AllocMemP(newmax * sizeof(struct dirhashslot), g)))
+			return -1;
+		if (dh->slots)
+			memcpy(slots, dh->slots, dh->numslots * sizeof(struct dirhashslot));
+		FreeMemP(dh->slots, g);
+		dh->slots = slots;
+		dh->maxslots = newmax;
+	}
+	i = dh->numslots++;
+
+found:
+	dh->slots[i].blocknr = blocknr;
+	dh->slots[i].used = used;
+	return i;
+}
+
+/*
+ * Read all dirblocks of the directory into the index. Returns FALSE if
+ * that failed for now; the caller drops the partial index, so the next
+ * lookup tries again.
+ */
+static BOOL BuildDirHash(struct volumedata *volume, struct dirhash *dh, globaldata *g)
+{
+	struct canode anode;
+	struct cdirblock *blk;
+	struct direntry *de;
+	ULONG anodeoffset = 0;
+	LONG slot;
+
+	DB(Trace(1, "BuildDirHash", "dir %lx\n", dh->dirnodenr));
+
+	GetAnode(&anode, dh->dirnodenr, g);
+	do
+	{
+		if (!(blk = LoadDirBlock(anode.blocknr + anodeoffset, g)))
+			return FALSE;
+
+		if ((slot = AddSlot(dh, blk->blocknr, BlockUsed(blk), g)) < 0)
+			return FALSE;
+
+		for (de = FIRSTENTRY(blk); de->next; de = NEXTENTRY(de))
+		{
+			switch (AddEntry(volume, dh, DirHashEntry(de, g), slot, g))
+			{
+				case DIRHASH_NOMEM:
+					return FALSE;
+				case DIRHASH_FULL:
+					MarkTooBig(volume, dh, g);
+					return TRUE;
+			}
+		}
+	} while (NextBlock(&anode, &anodeoffset, g));
+
+	return TRUE;
+}
+
+/*
+ * Get the index of a directory, building it if there is none yet.
+ * Returns NULL if the directory has to be searched block by block.
+ */
+struct dirhash *GetDirHash(ULONG dirnodenr, globaldata *g)
+{
+	struct volumedata *volume = g->currentvolume;
+	struct dirhash *dh;
+
+	if ((dh = FindDirHash(volume, dirnodenr)))
+	{
+		MinRemove(dh);
+		MinAddHead(&volume->dirhashes, dh);
+		return dh->toobig ? NULL : dh;
+	}
+
+	if (!(dh = AllocMemP(sizeof(struct dirhash), g)))
+		return NULL;
+
+	memset(dh, 0, sizeof(struct dirhash));
+	dh->dirnodenr = dirnodenr;
+	MinAddHead(&volume->dirhashes, dh);
+
+	if (!BuildDirHash(volume, dh, g))
+	{
+		DropDirHash(volume, dh, g);
+		return NULL;
+	}
+
+	return dh->toobig ? NULL : dh;
+}
+
+/*
+ * Iterate over the dirblocks that may hold a name with hash 'hash'.
+ * '*cursor' must be 0 on the first call. Returns 0 when done.
+ */
+ULONG DirHashNext(struct dirhash *dh, ULONG hash, ULONG *cursor)
+{
+	ULONG i;
+
+	i = *cursor ? dh->entries[*cursor - 1].next : dh->buckets[hash & (dh->maxentries - 1)];
+	for (; i; i = dh->entries[i - 1].next)
+	{
+		if (dh->entries[i - 1].hash == hash)
+		{
+			*cursor = i;
+			return dh->slots[dh->entries[i - 1].slot].blocknr;
+		}
+	}
+
+	*cursor = 0;
+	return 0;
+}
+
+/*
+ * Find a dirblock that has room for an entry of 'needed' bytes,
+ * using the same test as AddDirectoryEntry(). Returns 0 if none has.
+ */
+ULONG DirHashFindSpace(struct dirhash *dh, int needed, globaldata *g)
+{
+	ULONG i;
+
+	for (i = 0; i < dh->numslots; i++)
+	{
+		if (dh->slots[i].blocknr && dh->slots[i].used + needed + 1 < DB_ENTRYSPACE)
+			return dh->slots[i].blocknr;
+	}
+
+	return 0;
+}
+
+/* Entry 'de' was added to 'blk' */
+void DirHashAdd(struct cdirblock *blk, struct direntry *de, globaldata *g)
+{
+	struct volumedata *volume = blk->volume;
+	struct dirhash *dh;
+	LONG slot;
+
+	if (!(dh = FindDirHash(volume, blk->blk.anodenr)) || dh->toobig)
+		return;
+
+	if ((slot = FindSlot(dh, blk->blocknr)) < 0)
+		slot = AddSlot(dh, blk->blocknr, 0, g);
+
+	if (slot < 0)
+	{
+		DropDirHash(volume, dh, g);
+		return;
+	}
+
+	dh->slots[slot].used = BlockUsed(blk);
+	switch (AddEntry(volume, dh, DirHashEntry(de, g), slot, g))
+	{
+		case DIRHASH_NOMEM:
+			DropDirHash(volume, dh, g);
+			break;
+		case DIRHASH_FULL:
+			MarkTooBig(volume, dh, g);
+			break;
+	}
+}
+
+/* An entry with name hash 'hash' was removed from 'blk' */
+void DirHashRemove(struct cdirblock *blk, ULONG hash, globaldata *g)
+{
+	struct volumedata *volume = blk->volume;
+	struct dirhash *dh;
+	LONG slot;
+
+	if (!(dh = FindDirHash(volume, blk->blk.anodenr)) || dh->toobig)
+		return;
+
+	if ((slot = FindSlot(dh, blk->blocknr)) < 0 || !RemoveEntry(dh, hash, slot))
+	{
+		/* should not happen; don't trust the index anymore */
+		DropDirHash(volume, dh, g);
+		return;
+	}
+
+	dh->slots[slot].used = BlockUsed(blk);
+}
+
+/* Refresh the free space of 'blk' after a failed DirHashFindSpace() hint */
+void DirHashUpdateBlock(struct cdirblock *blk, globaldata *g)
+{
+	struct dirhash *dh;
+	LONG slot;
+
+	if (!(dh = FindDirHash(blk->volume, blk->blk.anodenr)) || dh->toobig)
+		return;
+
+	if ((slot = FindSlot(dh, blk->blocknr)) >= 0)
+		dh->slots[slot].used = BlockUsed(blk);
+}
+
+/* A dirblock of directory 'dirnodenr' got a new block number */
+void DirHashMoveBlock(ULONG dirnodenr, ULONG oldblocknr, ULONG newblocknr, globaldata *g)
+{
+	struct dirhash *dh;
+	LONG slot;
+
+	if (!(dh = FindDirHash(g->currentvolume, dirnodenr)) || dh->toobig)
+		return;
+
+	if ((slot = FindSlot(dh, oldblocknr)) >= 0)
+		dh->slots[slot].blocknr = newblocknr;
+}
+
+/* An empty dirblock was removed from directory 'dirnodenr' */
+void DirHashRemoveBlock(ULONG dirnodenr, ULONG blocknr, globaldata *g)
+{
+	struct dirhash *dh;
+	LONG slot;
+
+	if (!(dh = FindDirHash(g->currentvolume, dirnodenr)) || dh->toobig)
+		return;
+
+	if ((slot = FindSlot(dh, blocknr)) >= 0)
+		dh->slots[slot].blocknr = 0;
+}
+
+/* Directory 'dirnodenr' is gone */
+void FreeDirHash(ULONG dirnodenr, globaldata *g)
+{
+	struct volumedata *volume = g->currentvolume;
+	struct dirhash *dh;
+
+	if ((dh = FindDirHash(volume, dirnodenr)))
+		DropDirHash(volume, dh, g);
+}
+
+void FreeDirHashes(struct volumedata *volume, globaldata *g)
+{
+	struct dirhash *dh;
+
+	while (!IsMinListEmpty(&volume->dirhashes))
+	{
+		dh = HeadOf(&volume->dirhashes);
+		DropDirHash(volume, dh, g);
+	}
+}
@@ -0,0 +1,18 @@
+/* Prototypes for functions defined in
+dirhash.c
+ */
+
+struct dirhash;
+
+struct dirhash *GetDirHash(ULONG , globaldata * );
+ULONG DirHashName(UBYTE * );
+ULONG DirHashEntry(struct direntry * , globaldata * );
+ULONG DirHashNext(struct dirhash * , ULONG , ULONG * );
+ULONG DirHashFindSpace(struct dirhash * , int , globaldata * );
+void DirHashAdd(struct cdirblock * , struct direntry * , globaldata * );
+void DirHashRemove(struct cdirblock * , ULONG , globaldata * );
+void DirHashUpdateBlock(struct cdirblock * , globaldata * );
+void DirHashMoveBlock(ULONG , ULONG , ULONG , globaldata * );
+void DirHashRemoveBlock(ULONG , ULONG , globaldata * );
+void FreeDirHash(ULONG , globaldata * );
+void FreeDirHashes(struct volumedata * , globaldata * );
@@ -682,6 +682,8 @@ struct volumedata
 	struct MinList bmindexblks;         /* cached bitmap index blocks           */
 	struct MinList anodechainlist;      /* list of cached anodechains           */
 	struct MinList notifylist;          /* list of notifications                */
+	struct MinList dirhashes;           /* directory name indexes (dirhash.c)   */
+	ULONG   dirhashentries;             /* total size of the name indexes       */
 
 	BOOL    rootblockchangeflag;        /* indicates if rootblock dirty         */
 	WORD    numsofterrors;              /* number of soft errors on this disk   */
@@ -125,6 +125,7 @@
 #include "lru_protos.h"
 #include "ass_protos.h"
 #include "init_protos.h"
+#include "dirhash_protos.h"
 
 /*
  * prototypes
@@ -310,6 +311,7 @@ static void RemoveEmptyDBlocks(struct volumedata *volume, globaldata *g)
 				previous = GetAnodeOfDBlk(blk, &anode, g);
 				RemoveFromAnodeChain(&anode, previous, blk->blk.anodenr, g);
 				MinRemove(blk);
+				DirHashRemoveBlock(blk->blk.anodenr, blk->blocknr, g);
 				FreeReservedBlock(blk->blocknr, g);
 				ResToBeFreed(blk->oldblocknr, g);
 				FreeLRU((struct cachedblock *)blk);
@@ -659,6 +661,7 @@ static void UpdateDBLK (struct cachedblock *blk, ULONG newblocknr, globaldata *g
 	SaveAnode(&anode, anode.nr, g);
 
 	ReHash(blk, g->currentvolume->dirblks, HASHM_DIR);
+	DirHashMoveBlock(dblk->blk.anodenr, oldblocknr, newblocknr, g);
 }
 
 static void UpdateABLK (struct cachedblock *blk, ULONG newblocknr, globaldata *g)
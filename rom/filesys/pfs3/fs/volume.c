@@ -162,6 +162,7 @@
 #include "ass_protos.h"
 #include "init_protos.h"
 #include "format_protos.h"
+#include "dirhash_protos.h"
 
 static VOID CreateInputEvent(BOOL inserted, globaldata *g);
 static BOOL GetCurrentRoot(struct rootblock **rootblock, globaldata *g);
@@ -591,8 +592,9 @@ struct volumedata *MakeVolumeData (struct rootblock *rootblock, globaldata *g)
 	volume->rootblockchangeflag = FALSE;
 
 	/* lijsten initieren */
-	for (list = &volume->fileentries; list <= &volume->notifylist; list++)
+	for (list = &volume->fileentries; list <= &volume->dirhashes; list++)
 		NewList((struct List *)list);
+	volume->dirhashentries = 0;
 
 	/* andere gegevens invullen */
 	volume->numsofterrors   = 0;
@@ -708,6 +710,9 @@ void FreeUnusedResources(struct volumedata *volume, globaldata *g)
 	if (!volume)
 		return;
 
+	/* name indexes are rebuilt on demand */
+	FreeDirHashes(volume, g);
+
 	/* start with anblks!, fileentries are to be kept! */
 	for (list = volume->anblks; list<=&volume->bmindexblks; list++)
 	{
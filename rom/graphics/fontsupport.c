@@ -162,5 +162,149 @@ UBYTE *colorfontbm_to_chunkybuffer(struct TextFont *font, struct GfxBase *GfxBas
 
 /****************************************************************************************/
 
+static struct glyph_cache *glyphcache_build(struct TextFont *tf, UBYTE style, struct GfxBase *GfxBase)
+{
+    struct glyph_cache  *gc;
+    UWORD   	    	 numchars = NUMCHARS(tf);
+    UWORD   	    	 rows = tf->tf_YSize;
+    WORD    	    	 smear = (style & FSF_BOLD) ? tf->tf_BoldSmear : 0;
+    WORD    	    	*shifts, minshift = 0, maxshift = 0;
+    ULONG   	    	 idx, words = 0, size;
+    UWORD   	    	 y;
+
+    if(rows == 0)
+        return NULL;
+
+    if(!(shifts = AllocMem(rows * sizeof(WORD), MEMF_ANY | MEMF_CLEAR)))
+        return NULL;
+
+    /* Same slant as the per pixel renderer: start half the baseline to the
+       right and move one column left every other row */
+    if(style & FSF_ITALIC) {
+        WORD italiccheck = tf->tf_Baseline;
+        WORD italicshift = italiccheck / 2;
+
+        minshift = maxshift = italicshift;
+
+        for(y = 0; y < rows; y++) {
+            shifts[y] = italicshift;
+            if(italicshift < minshift) minshift = italicshift;
+            if(italicshift > maxshift) maxshift = italicshift;
+
+            italiccheck--;
+            if(italiccheck & 1) italicshift--;
+        }
+    }
+
+    for(idx = 0; idx < numchars; idx++) {
+        UWORD glyphwidth = ((ULONG *)tf->tf_CharLoc)[idx] & 0xFFFF;
+
+        if(glyphwidth)
+            words += ((glyphwidth + smear + maxshift - minshift + 15) >> 4) * rows;
+    }
+
+    size = sizeof(struct glyph_cache) + numchars * sizeof(struct glyph_cache_entry) + words * sizeof(UWORD);
+    if(size > GLYPHCACHE_MAXSIZE) {
+        FreeMem(shifts, rows * sizeof(WORD));
+        return NULL;
+    }
+
+    if((gc = AllocMem(size, MEMF_ANY | MEMF_CLEAR))) {
+        ULONG offset = 0;
+
+        gc->gc_Size    = size;
+        gc->gc_Rows    = rows;
+        gc->gc_Entries = (struct glyph_cache_entry *)(gc + 1);
+        gc->gc_Data    = (UWORD *)(gc->gc_Entries + numchars);
+
+        for(idx = 0; idx < numchars; idx++) {
+            struct glyph_cache_entry *ge = &gc->gc_Entries[idx];
+            ULONG   charloc = ((ULONG *)tf->tf_CharLoc)[idx];
+            UWORD   glyphwidth = charloc & 0xFFFF;
+            UWORD   glyphpos = charloc >> 16;
+            UBYTE  *glyphdata = tf->tf_CharData;
+            UWORD  *dst;
+
+            ge->gce_Offset  = offset;
+            ge->gce_XOffset = minshift;
+
+            if(glyphwidth == 0)
+                continue;
+
+            ge->gce_Words = (glyphwidth + smear + maxshift - minshift + 15) >> 4;
+            dst = gc->gc_Data + offset;
+
+            for(y = 0; y < rows; y++) {
+                UWORD gx;
+
+                for(gx = 0; gx < glyphwidth; gx++) {
+                    UWORD sx = glyphpos + gx;
+
+                    if(glyphdata[sx >> 3] & (0x80 >> (sx & 7))) {
+                        UWORD dx = gx + shifts[y] - minshift;
+
+                        dst[dx >> 4] |= 0x8000 >> (dx & 15);
+                        dx += smear;
+                        dst[dx >> 4] |= 0x8000 >> (dx & 15);
+                    }
+                }
+
+                glyphdata += tf->tf_Modulo;
+                dst += ge->gce_Words;
+            }
+
+            offset += ge->gce_Words * rows;
+        }
+    }
 
+    FreeMem(shifts, rows * sizeof(WORD));
 
+    return gc;
+}
+
+/****************************************************************************************/
+
+/* Return the expanded glyphs of tf for the bold/italic combination in style,
+   building them on first use. Returns NULL if the font has no extension or
+   the glyphs could not be cached, the caller then renders bit by bit */
+struct glyph_cache *glyphcache_obtain(struct TextFont *tf, UBYTE style, struct GfxBase *GfxBase)
+{
+    struct tfe_hashnode *hn;
+    UBYTE   	    	 variant = GLYPHCACHE_VARIANT(style);
+    struct glyph_cache  *gc;
+
+    if(!(hn = tfe_hashlookup(tf, GfxBase)))
+        return NULL;
+
+    if((gc = hn->glyphs[variant]) || (hn->glyphs_failed & (1 << variant)))
+        return gc;
+
+    ObtainSemaphore(&GFBI(GfxBase)->fontsem);
+
+    if(!(gc = hn->glyphs[variant]) && !(hn->glyphs_failed & (1 << variant))) {
+        if((gc = glyphcache_build(tf, style, GfxBase)))
+            hn->glyphs[variant] = gc;
+        else
+            hn->glyphs_failed |= 1 << variant;
+    }
+
+    ReleaseSemaphore(&GFBI(GfxBase)->fontsem);
+
+    return gc;
+}
+
+/****************************************************************************************/
+
+void glyphcache_free(struct tfe_hashnode *hn)
+{
+    UBYTE variant;
+
+    for(variant = 0; variant < GLYPHCACHE_VARIANTS; variant++) {
+        if(hn->glyphs[variant]) {
+            FreeMem(hn->glyphs[variant], hn->glyphs[variant]->gc_Size);
+            hn->glyphs[variant] = NULL;
+        }
+    }
+}
+
+/****************************************************************************************/
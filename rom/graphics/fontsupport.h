@@ -15,6 +15,31 @@
 #define NUMCHARS(tf) 	((tf->tf_HiChar - tf->tf_LoChar) + 2)
 #define CTF(x)      	((struct ColorTextFont *)x)
 
+/* Glyphs of a font pre-expanded for BltTemplateBasedText(). Every glyph
+   is stored as gc_Rows rows of gce_Words host order words, left aligned,
+   with the algorithmic bold and italic styles of the variant applied */
+struct glyph_cache_entry {
+    ULONG   gce_Offset; 	/* First word of the glyph in gc_Data */
+    WORD    gce_XOffset;	/* Column of the left edge relative to the pen */
+    UWORD   gce_Words;  	/* Words per row, 0 for empty glyphs */
+};
+
+struct glyph_cache {
+    ULONG   	    	    	 gc_Size;	/* Size of the allocation */
+    UWORD   	    	    	 gc_Rows;
+    struct glyph_cache_entry	*gc_Entries;	/* NUMCHARS() entries */
+    UWORD   	    	    	*gc_Data;
+};
+
+/* Variants are indexed by GLYPHCACHE_VARIANT(rp->AlgoStyle) */
+#define GLYPHCACHE_VARIANTS 	4
+#define GLYPHCACHE_VARIANT(style) \
+    ((((style) & FSF_BOLD) ? 1 : 0) | (((style) & FSF_ITALIC) ? 2 : 0))
+
+/* Fonts whose expanded glyphs would exceed this many bytes are rendered
+   without a cache */
+#define GLYPHCACHE_MAXSIZE  	(256 * 1024)
+
 struct tfe_hashnode {
     struct tfe_hashnode 	*next;
     struct TextFont		*back;
@@ -22,6 +47,10 @@ struct tfe_hashnode {
 
     /* Color font data in chunky format */
     UBYTE   	    	    	*chunky_colorfont;
+
+    /* Expanded glyphs, built on first use under fontsem */
+    struct glyph_cache   	*glyphs[GLYPHCACHE_VARIANTS];
+    UBYTE   	    	    	 glyphs_failed;	/* Variants that could not be built */
 };
 
 struct TextFontExtension_intern {
@@ -42,5 +71,8 @@ struct tfe_hashnode *tfe_hashnode_create(struct GfxBase *GfxBase);
 
 UBYTE *colorfontbm_to_chunkybuffer(struct TextFont *font, struct GfxBase *GfxBase);
 
+struct glyph_cache *glyphcache_obtain(struct TextFont *tf, UBYTE style, struct GfxBase *GfxBase);
+void glyphcache_free(struct tfe_hashnode *hn);
+
 
 #endif /* FONTSUPPORT_H */
@@ -60,6 +60,7 @@ static int GfxInit(struct GfxBase *LIBBASE)
     InitSemaphore(&PrivGBase(GfxBase)->view_sema);
     InitSemaphore(&PrivGBase(GfxBase)->tfe_hashtab_sema);
     InitSemaphore(&PrivGBase(GfxBase)->fontsem);
+    InitSemaphore(&PrivGBase(GfxBase)->textraster_sema);
 
     NEWLIST(&LIBBASE->MonitorList);
     LIBBASE->MonitorList.lh_Type = MONITOR_SPEC_TYPE;
@@ -185,6 +185,11 @@ struct GfxBase_intern {
     struct SignalSemaphore  	tfe_hashtab_sema;
     struct SignalSemaphore  	fontsem;
 
+    /* Template shared by Text() calls on RastPorts without a TmpRas */
+    struct SignalSemaphore      textraster_sema;
+    PLANEPTR                    textraster;
+    ULONG                       textraster_size;
+
 #if REGIONS_USE_MEMPOOL
     /* Regions pool */
     struct SignalSemaphore  	regionsem;
@@ -65,6 +65,7 @@
         tfe = hn->ext;
 
         if(hn->chunky_colorfont) FreeVec(hn->chunky_colorfont);
+        glyphcache_free(hn);
 
         /* Remove the hashitem (tfe_hashdelete() has semaphore protection) */
         tfe_hashdelete(font, GfxBase);
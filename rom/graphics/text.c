@@ -94,13 +94,113 @@ void ColorFontBasedText(struct RastPort *rp, CONST_STRPTR text, ULONG len,
 
 /***************************************************************************/
 
+/* Templates up to this size are kept in GfxBase between Text() calls */
+#define TEXTRASTER_MAXSIZE  32768
+
+#define TEXTRASTER_TMPRAS   0
+#define TEXTRASTER_SHARED   1
+#define TEXTRASTER_ALLOC    2
+
+/* Get a template of at least size bytes: the RastPort's TmpRas if it is
+   big enough, else the buffer in GfxBase if no other task is using it,
+   else a fresh allocation */
+static PLANEPTR ObtainTextRaster(struct RastPort *rp, ULONG size, UBYTE *owner,
+                                 struct GfxBase *GfxBase)
+{
+    PLANEPTR raster;
+
+    if(rp->TmpRas && rp->TmpRas->RasPtr && (ULONG)rp->TmpRas->Size >= size) {
+        *owner = TEXTRASTER_TMPRAS;
+        return rp->TmpRas->RasPtr;
+    }
+
+    if(size <= TEXTRASTER_MAXSIZE && AttemptSemaphore(&PrivGBase(GfxBase)->textraster_sema)) {
+        if(PrivGBase(GfxBase)->textraster_size < size) {
+            ULONG newsize = (size + 1023) & ~1023;
+
+            if(PrivGBase(GfxBase)->textraster)
+                FreeMem(PrivGBase(GfxBase)->textraster, PrivGBase(GfxBase)->textraster_size);
+            PrivGBase(GfxBase)->textraster_size = 0;
+
+            if((PrivGBase(GfxBase)->textraster = AllocMem(newsize, MEMF_CHIP)))
+                PrivGBase(GfxBase)->textraster_size = newsize;
+        }
+
+        if(PrivGBase(GfxBase)->textraster) {
+            *owner = TEXTRASTER_SHARED;
+            return PrivGBase(GfxBase)->textraster;
+        }
+
+        ReleaseSemaphore(&PrivGBase(GfxBase)->textraster_sema);
+    }
+
+    raster = AllocMem(size, MEMF_CHIP);
+    *owner = TEXTRASTER_ALLOC;
+
+    return raster;
+}
+
+static void ReleaseTextRaster(PLANEPTR raster, ULONG size, UBYTE owner,
+                              struct GfxBase *GfxBase)
+{
+    if(owner == TEXTRASTER_SHARED)
+        ReleaseSemaphore(&PrivGBase(GfxBase)->textraster_sema);
+    else if(owner == TEXTRASTER_ALLOC)
+        FreeMem(raster, size);
+}
+
+/* OR a cached glyph into a template of raswords words per row, with its
+   left edge at column x. Rows and words outside the template are clipped */
+static void MergeCachedGlyph(UWORD *raster, WORD raswords, WORD rows, WORD x,
+                             struct glyph_cache *gc, struct glyph_cache_entry *ge)
+{
+    UWORD  *src = gc->gc_Data + ge->gce_Offset;
+    WORD    shift = x & 15;
+    WORD    first = (x - shift) / 16;
+    WORD    words = ge->gce_Words;
+    WORD    y, w;
+
+    if(rows > gc->gc_Rows) rows = gc->gc_Rows;
+
+    raster += first;
+
+    if(first >= 0 && first + words < raswords) {
+        for(y = 0; y < rows; y++) {
+            for(w = 0; w < words; w++) {
+                ULONG val = (ULONG)src[w] << (16 - shift);
+
+                raster[w]     |= AROS_WORD2BE(val >> 16);
+                raster[w + 1] |= AROS_WORD2BE(val & 0xFFFF);
+            }
+            src += words;
+            raster += raswords;
+        }
+    } else {
+        for(y = 0; y < rows; y++) {
+            for(w = 0; w < words; w++) {
+                ULONG val = (ULONG)src[w] << (16 - shift);
+
+                if(first + w >= 0 && first + w < raswords)
+                    raster[w] |= AROS_WORD2BE(val >> 16);
+                if(first + w + 1 >= 0 && first + w + 1 < raswords)
+                    raster[w + 1] |= AROS_WORD2BE(val & 0xFFFF);
+            }
+            src += words;
+            raster += raswords;
+        }
+    }
+}
+
 void BltTemplateBasedText(struct RastPort *rp, CONST_STRPTR text, ULONG len,
                           struct GfxBase *GfxBase)
 {
     struct TextExtent    te;
     struct TextFont     *tf;
+    struct glyph_cache  *gc;
     WORD                 raswidth, raswidth16, raswidth_bpr, rasheight, x, y, gx;
+    ULONG                rassize;
     UBYTE               *raster;
+    UBYTE                owner;
     BOOL                 is_bold, is_italic;
 
     TextExtent(rp, text, len, &te);
@@ -110,11 +210,13 @@ void BltTemplateBasedText(struct RastPort *rp, CONST_STRPTR text, ULONG len,
 
     raswidth16 = (raswidth + 15) & ~15;
     raswidth_bpr = raswidth16 / 8;
+    rassize = RASSIZE(raswidth, rasheight);
 
-    if((raster = AllocRaster(raswidth, rasheight))) {
-        SetMem(raster, 0, RASSIZE(raswidth, rasheight));
+    if((raster = ObtainTextRaster(rp, rassize, &owner, GfxBase))) {
+        SetMem(raster, 0, rassize);
 
         tf = rp->Font;
+        gc = glyphcache_obtain(tf, rp->AlgoStyle, GfxBase);
 
         x = -te.te_Extent.MinX;
 
@@ -137,81 +239,90 @@ void BltTemplateBasedText(struct RastPort *rp, CONST_STRPTR text, ULONG len,
                 idx = c - tf->tf_LoChar;
             }
 
-            charloc = ((ULONG *)tf->tf_CharLoc)[idx];
-
-            glyphwidth = charloc & 0xFFFF;
-            glyphpos = charloc >> 16;
-
             if(tf->tf_CharKern) {
                 x += ((WORD *)tf->tf_CharKern)[idx];
             }
 
+            if(gc) {
+                struct glyph_cache_entry *ge = &gc->gc_Entries[idx];
 
-            for(bold = 0; bold <= is_bold; bold++) {
-                WORD wx;
-                WORD italicshift, italiccheck = 0;
-
-                if(is_italic) {
-                    italiccheck = tf->tf_Baseline;
-                    italicshift = italiccheck / 2;
-                } else {
-                    italicshift = 0;
+                if(ge->gce_Words) {
+                    MergeCachedGlyph((UWORD *)raster, raswidth_bpr / 2, rasheight,
+                                     x + ge->gce_XOffset, gc, ge);
                 }
+            } else {
+                charloc = ((ULONG *)tf->tf_CharLoc)[idx];
 
-                wx = x + italicshift + (bold ? tf->tf_BoldSmear : 0);
+                glyphwidth = charloc & 0xFFFF;
+                glyphpos = charloc >> 16;
 
-                glyphdata = ((UBYTE *)tf->tf_CharData) + glyphpos / 8;
-                dst = raster + wx / 8;
+                for(bold = 0; bold <= is_bold; bold++) {
+                    WORD wx;
+                    WORD italicshift, italiccheck = 0;
 
-                for(y = 0; y < rasheight; y++) {
-                    UBYTE *glyphdatax = glyphdata;
-                    UBYTE *dstx = dst;
-                    UBYTE srcdata;
+                    if(is_italic) {
+                        italiccheck = tf->tf_Baseline;
+                        italicshift = italiccheck / 2;
+                    } else {
+                        italicshift = 0;
+                    }
 
-                    srcmask = 0x80 >> (glyphpos & 7);
-                    dstmask = 0x80 >> (wx & 7);
+                    wx = x + italicshift + (bold ? tf->tf_BoldSmear : 0);
 
-                    srcdata = *glyphdatax;
+                    glyphdata = ((UBYTE *)tf->tf_CharData) + glyphpos / 8;
+                    dst = raster + wx / 8;
 
-                    for(gx = 0; gx < glyphwidth; gx++) {
-                        if(srcdata & srcmask) {
-                            *dstx |= dstmask;
-                        }
+                    for(y = 0; y < rasheight; y++) {
+                        UBYTE *glyphdatax = glyphdata;
+                        UBYTE *dstx = dst;
+                        UBYTE srcdata;
 
-                        if(dstmask == 0x1) {
-                            dstmask = 0x80;
-                            dstx++;
-                        } else {
-                            dstmask >>= 1;
-                        }
+                        srcmask = 0x80 >> (glyphpos & 7);
+                        dstmask = 0x80 >> (wx & 7);
 
-                        if(srcmask == 0x1) {
-                            srcmask = 0x80;
-                            glyphdatax++;
-                            srcdata = *glyphdatax;
-                        } else {
-                            srcmask >>= 1;
-                        }
+                        srcdata = *glyphdatax;
 
-                    } /* for(gx = 0; gx < glyphwidth; gx++) */
+                        for(gx = 0; gx < glyphwidth; gx++) {
+                            if(srcdata & srcmask) {
+                                *dstx |= dstmask;
+                            }
 
-                    glyphdata += tf->tf_Modulo;
-                    dst += raswidth_bpr;
+                            if(dstmask == 0x1) {
+                                dstmask = 0x80;
+                                dstx++;
+                            } else {
+                                dstmask >>= 1;
+                            }
 
-                    if(is_italic) {
-                        italiccheck--;
-                        if(italiccheck & 1) {
-                            italicshift--;
+                            if(srcmask == 0x1) {
+                                srcmask = 0x80;
+                                glyphdatax++;
+                                srcdata = *glyphdatax;
+                            } else {
+                                srcmask >>= 1;
+                            }
+
+                        } /* for(gx = 0; gx < glyphwidth; gx++) */
+
+                        glyphdata += tf->tf_Modulo;
+                        dst += raswidth_bpr;
+
+                        if(is_italic) {
+                            italiccheck--;
+                            if(italiccheck & 1) {
+                                italicshift--;
 
-                            wx--;
-                            if((wx & 7) == 7) dst--;
+                                wx--;
+                                if((wx & 7) == 7) dst--;
 
+                            }
                         }
-                    }
 
-                } /* for(y = 0; y < rasheight; y++) */
+                    } /* for(y = 0; y < rasheight; y++) */
 
-            } /* for(bold = 0; bold < ((rp->AlgoStyle & FSF_BOLD) ? 2 : 1); bold++) */
+                } /* for(bold = 0; bold < ((rp->AlgoStyle & FSF_BOLD) ? 2 : 1); bold++) */
+
+            } /* if(gc) */
 
             if(tf->tf_CharSpace) {
                 x += ((WORD *)tf->tf_CharSpace)[idx];
@@ -279,9 +390,9 @@ void BltTemplateBasedText(struct RastPort *rp, CONST_STRPTR text, ULONG len,
                     raswidth,
                     rasheight);
 
-        FreeRaster(raster, raswidth, rasheight);
+        ReleaseTextRaster(raster, rassize, owner, GfxBase);
 
-    } /* if ((raster = AllocRaster(raswidth, rasheight))) */
+    } /* if ((raster = ObtainTextRaster(rp, rassize, &owner, GfxBase))) */
 
     Move(rp, rp->cp_x + te.te_Width, rp->cp_y);
 
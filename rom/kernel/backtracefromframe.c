@@ -1,5 +1,5 @@
 /*
-    Copyright (C) 2025, The AROS Development Team. All rights reserved.
+    Copyright (C) 2025-2026, The AROS Development Team. All rights reserved.
 
     Desc:
 */
@@ -9,6 +9,7 @@
 #include <aros/libcall.h>
 
 #include <kernel_base.h>
+#include <kernel_sample.h>
 
 /*****************************************************************************
 
@@ -78,8 +79,13 @@
 {
     AROS_LIBFUNC_INIT
 
-    /* The implementation of this function is architecture-specific */
-    return 0;
+    return krnBacktrace(frame_in, (APTR)~(IPTR)0, out_pcs, max_depth);
 
     AROS_LIBFUNC_EXIT
 }
+
+ULONG krnBacktrace(APTR frame, APTR limit, APTR *out_pcs, ULONG max_depth)
+{
+    /* The implementation of this function is architecture-specific */
+    return 0;
+}
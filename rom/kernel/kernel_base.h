@@ -2,7 +2,7 @@
 #define KERNEL_BASE_H
 
 /*
-    Copyright  1995-2025, The AROS Development Team. All rights reserved.
+    Copyright  1995-2026, The AROS Development Team. All rights reserved.
     $Id$
 
     Desc:
@@ -84,6 +84,8 @@ struct KernelBase
 #endif
     KrnSymResolver_t    kb_gResolver;
     APTR                kb_gResolvPrivate;
+    struct KrnSampler * volatile kb_Sampler;         /* active sampler, see KrnSetSampler()  */
+    volatile ULONG      kb_SamplerBusy;                 /* interrupts currently taking a sample */
 };
 
 /*
@@ -0,0 +1,69 @@
+/*
+    Copyright (C) 2026, The AROS Development Team. All rights reserved.
+
+    Desc: Statistical sampling from the timer interrupt
+*/
+
+#include <aros/atomic.h>
+#include <aros/kernel.h>
+#include <exec/tasks.h>
+
+#include <kernel_base.h>
+#include <kernel_sample.h>
+
+void krnSample(struct KernelBase *KernelBase, ULONG cpu, struct Task *task, APTR pc, APTR frame)
+{
+    struct KrnSampler *ksr;
+
+    /* Cheap check for the common case of nobody sampling */
+    if (KernelBase->kb_Sampler == NULL)
+        return;
+
+    /*
+     * KrnSetSampler(NULL) clears kb_Sampler and then waits for kb_SamplerBusy
+     * to drop to zero, so the sampler stays valid until we are done with it.
+     */
+    AROS_ATOMIC_INC(KernelBase->kb_SamplerBusy);
+
+    ksr = KernelBase->kb_Sampler;
+    if (ksr && cpu < ksr->ksr_CPUCount)
+    {
+        struct KrnSampleBuffer *ksb = &ksr->ksr_Buffers[cpu];
+
+        if (++ksb->ksb_Ticks >= ksr->ksr_Period)
+        {
+            ULONG head = ksb->ksb_Head;
+
+            ksb->ksb_Ticks = 0;
+
+            if (head - ksb->ksb_Tail >= ksr->ksr_Size)
+                ksb->ksb_Dropped++;
+            else
+            {
+                struct KrnSample *ks = &ksb->ksb_Samples[head & (ksr->ksr_Size - 1)];
+                ULONG depth = 1;
+
+                ks->ks_Task = task;
+                ks->ks_PC[0] = pc;
+
+                /*
+                 * Only follow frame pointers into the stack of the interrupted
+                 * task. Code built without frame pointers may use the register
+                 * for anything else.
+                 */
+                if (task && ksr->ksr_Depth > 1 &&
+                    frame >= task->tc_SPLower && frame < task->tc_SPUpper)
+                {
+                    depth += krnBacktrace(frame, task->tc_SPUpper, &ks->ks_PC[1], ksr->ksr_Depth - 1);
+                }
+                ks->ks_Depth = depth;
+
+                /* Publish the sample only once it is complete */
+                __sync_synchronize();
+                ksb->ksb_Head = head + 1;
+            }
+        }
+    }
+
+    AROS_ATOMIC_DEC(KernelBase->kb_SamplerBusy);
+}
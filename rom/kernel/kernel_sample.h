@@ -0,0 +1,24 @@
+#ifndef KERNEL_SAMPLE_H
+#define KERNEL_SAMPLE_H
+
+/*
+    Copyright (C) 2026, The AROS Development Team. All rights reserved.
+
+    Desc: Statistical sampling from the timer interrupt
+*/
+
+#include <exec/tasks.h>
+
+/*
+ * Called by the timer interrupt of the given CPU. task is the task that was
+ * interrupted, or NULL if the timer interrupted other interrupt code.
+ */
+void krnSample(struct KernelBase *KernelBase, ULONG cpu, struct Task *task, APTR pc, APTR frame);
+
+/*
+ * KrnBacktraceFromFrame() that does not follow frames at or above limit.
+ * Implemented in backtracefromframe.c.
+ */
+ULONG krnBacktrace(APTR frame, APTR limit, APTR *out_pcs, ULONG max_depth);
+
+#endif /* !KERNEL_SAMPLE_H */
@@ -0,0 +1,94 @@
+/*
+    Copyright (C) 2026, The AROS Development Team. All rights reserved.
+
+    Desc:
+*/
+
+#include <aros/kernel.h>
+#include <aros/libcall.h>
+
+#include <kernel_base.h>
+
+/*****************************************************************************
+
+    NAME */
+#include <proto/kernel.h>
+
+        AROS_LH1(BOOL, KrnSetSampler,
+
+/*  SYNOPSIS */
+        AROS_LHA(struct KrnSampler *, sampler, A0),
+
+/*  LOCATION */
+        struct KernelBase *, KernelBase, 71, Kernel)
+
+/*  FUNCTION
+        Starts or stops statistical sampling of the running code.
+
+        While a sampler is installed, the timer interrupt of every CPU
+        records the interrupted program counter, the interrupted task and
+        a short backtrace into that CPU's buffer every ksr_Period timer
+        ticks. The caller drains the buffers while sampling goes on.
+
+    INPUTS
+        sampler - Sampler to install, with its buffers and ksb_Samples
+                  arrays allocated in public memory and the rest of the
+                  buffers cleared. NULL stops sampling.
+
+    RESULT
+        TRUE if the sampler was installed, FALSE if the sampler is not
+        valid or another one is already installed. Stopping always
+        returns TRUE.
+
+    NOTES
+        Once sampling has been stopped the timer interrupt no longer
+        touches the sampler, so the caller may free it.
+
+        Only the owner of the active sampler should stop it.
+
+        Backtraces are taken with KrnBacktraceFromFrame() and are only
+        followed within the stack of the interrupted task. They require
+        code built with frame pointers.
+
+        Sampling is not supported on all architectures. Where the timer
+        interrupt does not take samples the buffers stay empty.
+
+    EXAMPLE
+
+    BUGS
+
+    SEE ALSO
+        KrnBacktraceFromFrame(), KrnGetCPUCount()
+
+    INTERNALS
+        The timer interrupt calls krnSample(). To stop, we clear
+        kb_Sampler and wait for samples in progress on other CPUs to
+        finish, which krnSample() counts in kb_SamplerBusy.
+
+******************************************************************************/
+{
+    AROS_LIBFUNC_INIT
+
+    if (sampler == NULL)
+    {
+        KernelBase->kb_Sampler = NULL;
+        __sync_synchronize();
+
+        while (KernelBase->kb_SamplerBusy)
+            ;
+
+        return TRUE;
+    }
+
+    if ((sampler->ksr_Period == 0) ||
+        (sampler->ksr_Depth == 0) || (sampler->ksr_Depth > KRNSAMPLE_DEPTH) ||
+        (sampler->ksr_Size == 0) || (sampler->ksr_Size & (sampler->ksr_Size - 1)) ||
+        (sampler->ksr_Buffers == NULL))
+    {
+        return FALSE;
+    }
+
+    return __sync_bool_compare_and_swap(&KernelBase->kb_Sampler, NULL, sampler);
+
+    AROS_LIBFUNC_EXIT
+}
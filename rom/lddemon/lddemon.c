@@ -1,5 +1,5 @@
 /*
-    Copyright (C) 1995-2019, The AROS Development Team. All rights reserved.
+    Copyright (C) 1995-2026, The AROS Development Team. All rights reserved.
 
     Loader for shared libraries and devices.
 */
@@ -26,14 +26,18 @@
 
 #include <proto/lddemon.h>
 
+#include "lddemon.h"
+
+#if LDDEMON_TIMING
+#include <proto/timer.h>
+#endif
+
 #include <resources/execlock.h>
 #include <aros/types/spinlock_s.h>
 
 #include <stddef.h>
 #include <string.h>
 
-#include "lddemon.h"
-
 #ifdef __mc68000
 #define INIT_IN_LDDEMON_CONTEXT 1
 #else
@@ -77,9 +81,45 @@ struct LDDMsg
 #else
     BPTR                 ldd_Return;        /* Loaded seglist */
 #endif
+#if LDDEMON_TIMING
+    UQUAD                ldd_LoadTime;      /* Microseconds spent loading */
+    UQUAD                ldd_InitTime;      /* ... and initialising */
+#endif
 };
 
 static const char ldDemonName[] = "Lib & Dev Loader Daemon";
+static const char ldLoaderName[] = "Lib & Dev Loader";
+
+#if LDDEMON_TIMING
+static UQUAD LDTime(struct IntLDDemonBase *ldBase)
+{
+    struct Device *TimerBase = ldBase->dl_TimerBase;
+    struct EClockVal ev;
+    UQUAD ticks;
+    ULONG freq;
+
+    if (!TimerBase)
+        return 0;
+
+    freq = ReadEClock(&ev);
+    ticks = ((UQUAD)ev.ev_hi << 32) | ev.ev_lo;
+
+    return (ticks / freq) * 1000000 + (ticks % freq) * 1000000 / freq;
+}
+#endif
+
+/* Is the task one of the loader processes? */
+static BOOL LDIsLoader(struct IntLDDemonBase *ldBase, struct Task *task)
+{
+    ULONG i;
+
+    for (i = 0; i < ldBase->dl_NumLoaders; i++)
+    {
+        if (&ldBase->dl_Loaders[i].ll_Process->pr_Task == task)
+            return TRUE;
+    }
+    return FALSE;
+}
 
 /*
     overridable LoadSeg
@@ -422,12 +462,16 @@ static struct LDObjectNode *LDRequestObject(STRPTR libname, ULONG version, STRPT
         ldd.ldd_List    = list;
 #endif
 
+#if LDDEMON_TIMING
+        UQUAD started = LDTime(ldBase), replied;
+#endif
+
         D(bug("[LDCaller] Sending request for %s, InLDProcess %d\n",
-            stripped_libname, (struct Process*)FindTask(NULL) == ldBase->dl_LDDemonTask));
+            stripped_libname, LDIsLoader(ldBase, FindTask(NULL))));
 
 #if INIT_IN_LDDEMON_CONTEXT
         /* Direct call if already in LDDemon context */
-        if ((struct Process*)FindTask(NULL) == ldBase->dl_LDDemonTask) {
+        if (LDIsLoader(ldBase, FindTask(NULL))) {
             ProcessLDMessage(ldBase, &ldd, SysBase);
         } else
 #endif
@@ -439,11 +483,24 @@ static struct LDObjectNode *LDRequestObject(STRPTR libname, ULONG version, STRPT
 
         D(bug("[LDCaller] Returned 0x%p\n", ldd.ldd_Return));
 
+#if LDDEMON_TIMING
+        replied = LDTime(ldBase);
+#endif
+
 #if INIT_IN_LDDEMON_CONTEXT
         tmplib = ldd.ldd_Return;
 #else
         tmplib = CallLDInit(ldd.ldd_Return, list, stripped_libname, DOSBase, SysBase);
 #endif
+
+#if LDDEMON_TIMING
+        ldd.ldd_InitTime += LDTime(ldBase) - replied;
+        bug("[LDDemon] %s: queued %u us, loaded in %u us, initialised in %u us%s\n",
+            stripped_libname,
+            (ULONG)(replied - started - ldd.ldd_LoadTime - ldd.ldd_InitTime),
+            (ULONG)ldd.ldd_LoadTime, (ULONG)ldd.ldd_InitTime,
+            tmplib ? "" : " (failed)");
+#endif
     }
 
     if (!tmplib)
@@ -745,12 +802,23 @@ static void ProcessLDMessage(struct IntLDDemonBase *ldBase, struct LDDMsg *ldd,
     struct Library *DOSBase = ldBase->dl_DOSBase;
 #endif
     BPTR seglist;
+#if LDDEMON_TIMING
+    UQUAD started = LDTime(ldBase);
+#endif
     D(bug("[LDDemon] Got a request for %s in %s\n", ldd->ldd_Name, ldd->ldd_BaseDir));
 
     seglist = LDLoad(ldBase, ldd->ldd_ReplyPort.mp_SigTask, ldd->ldd_Name, ldd->ldd_BaseDir, SysBase);
 
+#if LDDEMON_TIMING
+    ldd->ldd_LoadTime = LDTime(ldBase) - started;
+    started += ldd->ldd_LoadTime;
+#endif
+
 #if INIT_IN_LDDEMON_CONTEXT
     ldd->ldd_Return = CallLDInit(seglist, ldd->ldd_List, FilePart(ldd->ldd_Name), ldBase->dl_DOSBase, SysBase);
+#if LDDEMON_TIMING
+    ldd->ldd_InitTime = LDTime(ldBase) - started;
+#endif
     D(bug("[LDDemon] Replying with %p as result, seglist was %p\n", ldd->ldd_Return, seglist));
 #else
     ldd->ldd_Return = seglist;
@@ -758,26 +826,106 @@ static void ProcessLDMessage(struct IntLDDemonBase *ldBase, struct LDDMsg *ldd,
 #endif
 }
 
+/*
+  void LDLoaderProc()
+    Entry of the loader processes. Each one serves the requests the
+    LDDemon process hands to it, one at a time, so that unrelated
+    objects can be loaded from disk concurrently. Requests for the
+    same object never get here together: the caller holds the
+    object's LDObjectNode semaphore until it is loaded.
+*/
+static AROS_PROCH(LDLoaderProc, argptr, argsize, SysBase)
+{
+    AROS_PROCFUNC_INIT
+
+    struct IntLDDemonBase *ldBase = SysBase->ex_RamLibPrivate;
+    struct LDLoader *loader = FindTask(NULL)->tc_UserData;
+    struct LDDMsg *ldd;
+
+    for(;;)
+    {
+        Wait(SIGBREAKF_CTRL_F);
+        if ((ldd = loader->ll_Request))
+        {
+            ProcessLDMessage(ldBase, ldd, SysBase);
+            loader->ll_Request = NULL;
+            ReplyMsg((struct Message *)ldd);
+            Signal(&ldBase->dl_LDDemonTask->pr_Task, 1L << ldBase->dl_IdleSigBit);
+        }
+    }
+
+    return 0;
+
+    AROS_PROCFUNC_EXIT
+}
+
+/* Find a loader with nothing to do, starting another one if all are busy */
+static struct LDLoader *LDIdleLoader(struct IntLDDemonBase *ldBase, struct ExecBase *SysBase)
+{
+    struct Library *DOSBase = ldBase->dl_DOSBase;
+    struct LDLoader *loader;
+    ULONG i;
+
+    for (i = 0; i < ldBase->dl_NumLoaders; i++)
+    {
+        if (!ldBase->dl_Loaders[i].ll_Request)
+            return &ldBase->dl_Loaders[i];
+    }
+
+    if (ldBase->dl_NumLoaders == LDDEMON_MAXLOADERS)
+        return NULL;
+
+    loader = &ldBase->dl_Loaders[ldBase->dl_NumLoaders];
+    loader->ll_Request = NULL;
+    loader->ll_Process = CreateNewProcTags(
+        NP_Entry, (IPTR)LDLoaderProc,
+        NP_Input, 0,
+        NP_Output, 0,
+        NP_WindowPtr, -1,
+        NP_Name, (IPTR)ldLoaderName,
+        NP_Priority, 5,
+        NP_UserData, (IPTR)loader,
+        TAG_END);
+    if (!loader->ll_Process)
+        return NULL;
+
+    D(bug("[LDDemon] Started loader %u\n", (unsigned)ldBase->dl_NumLoaders));
+    ldBase->dl_NumLoaders++;
+
+    return loader;
+}
+
 /*
   void LDDemon()
     The LDDemon process entry. Sits around and does nothing until a
-    request for a library comes, when it will then find the library
-    and hopefully open it.
+    request for a library comes, when it will hand it to an idle loader
+    process. Requests stay queued on the port while all loaders are busy.
 */
 static AROS_PROCH(LDDemon, argptr, argsize, SysBase)
 {
     AROS_PROCFUNC_INIT
 
     struct IntLDDemonBase *ldBase = SysBase->ex_RamLibPrivate;
+    struct LDLoader *loader;
     struct LDDMsg *ldd;
+    ULONG sigs;
+
+    ldBase->dl_IdleSigBit = AllocSignal(-1);
+    if (ldBase->dl_IdleSigBit == -1 || !LDIdleLoader(ldBase, SysBase))
+    {
+        Alert( AT_DeadEnd | AN_RAMLib | AG_ProcCreate );
+    }
+    sigs = (1L << ldBase->dl_LDDemonPort->mp_SigBit) | (1L << ldBase->dl_IdleSigBit);
 
     for(;;)
     {
-        WaitPort(ldBase->dl_LDDemonPort);
-        while( (ldd = (struct LDDMsg *)GetMsg(ldBase->dl_LDDemonPort)) )
+        Wait(sigs);
+        while( ldBase->dl_LDDemonPort->mp_MsgList.lh_Head->ln_Succ &&
+               (loader = LDIdleLoader(ldBase, SysBase)) &&
+               (ldd = (struct LDDMsg *)GetMsg(ldBase->dl_LDDemonPort)) )
         {
-            ProcessLDMessage(ldBase, ldd, SysBase);
-            ReplyMsg((struct Message *)ldd);
+            loader->ll_Request = ldd;
+            Signal(&loader->ll_Process->pr_Task, SIGBREAKF_CTRL_F);
         } /* messages available */
     }
 
@@ -834,6 +982,12 @@ static ULONG LDDemon_Init(struct IntLDDemonBase *ldBase)
     ldBase->dl_ExecLockRes = OpenResource("execlock.resource");
 #endif
 
+#if LDDEMON_TIMING
+    /* Only needed for ReadEClock(), open it before OpenDevice() is patched */
+    if (OpenDevice("timer.device", UNIT_MICROHZ, &ldBase->dl_TimerReq.tr_node, 0) == 0)
+        ldBase->dl_TimerBase = ldBase->dl_TimerReq.tr_node.io_Device;
+#endif
+
     /*
      *  Grab the semaphore ourself. The reason for this is that it will
      *  cause all other tasks to wait until we have finished initialising
@@ -5,6 +5,24 @@
 #include <exec/interrupts.h>
 #include <exec/semaphores.h>
 
+/* Set to 1 to log how long each library or device took to load and init */
+#define LDDEMON_TIMING      0
+
+#if LDDEMON_TIMING
+#include <devices/timer.h>
+#endif
+
+/* Number of processes that may load objects from disk at the same time */
+#define LDDEMON_MAXLOADERS  4
+
+struct LDDMsg;
+
+struct LDLoader
+{
+    struct Process          *ll_Process;
+    struct LDDMsg           *ll_Request;    /* NULL while idle */
+};
+
 struct IntLDDemonBase
 {
     /* Public*/
@@ -21,6 +39,16 @@ struct IntLDDemonBase
     struct MsgPort	        *dl_LDDemonPort;
     struct Process	        *dl_LDDemonTask;
 
+    /* Requests on dl_LDDemonPort are handed to these by dl_LDDemonTask */
+    struct LDLoader         dl_Loaders[LDDEMON_MAXLOADERS];
+    ULONG                   dl_NumLoaders;
+    BYTE                    dl_IdleSigBit;  /* Loader finished a request */
+
+#if LDDEMON_TIMING
+    struct Device           *dl_TimerBase;
+    struct timerequest      dl_TimerReq;
+#endif
+
 #if defined(__AROSEXEC_SMP__)
     struct Library 	        *dl_ExecLockRes;
 #endif
@@ -1,5 +1,5 @@
 /*
-    Copyright (C) 2001-2017, The AROS Development Team. All rights reserved.
+    Copyright (C) 2001-2026, The AROS Development Team. All rights reserved.
 
     Desc: Copy CLI command
 */
@@ -18,7 +18,7 @@
         PAT=PATTERN/K, DIRECT/S,SILENT/S, ERRWARN/S, MAKEDIR/S, MOVE/S,
         DELETE/S, HARD=HARDLINK/S, SOFT=SOFTLINK/S, FOLNK=FORCELINK/S,
         FODEL=FORCEDELETE/S, FOOVR=FORCEOVERWRITE/S, DONTOVR=DONTOVERWRITE/S,
-        FORCE/S,NEWER/S
+        FORCE/S,NEWER/S,STATS/S
 
     LOCATION
 
@@ -57,6 +57,7 @@
         DONTOVR   --  never overwrite destination
         FORCE     --  DO NOT USE. Call compatibility only.
         NEWER     --  compare version strings and only overwrites older files.
+        STATS     --  print the amount of data copied and the throughput
 
 
     More detailed descriptions:
@@ -178,6 +179,10 @@
     This option scans the version strings of the source and destination files and
     only overwrites if the source file is newer than the destination file.
 
+    STATS:
+    When Copy has finished, the number of files and kilobytes copied, the
+    time taken and the resulting throughput are printed.
+
     RESULT
 
     NOTES
@@ -221,6 +226,13 @@
         with a sub directory of source as destination and ALL option is not
         possible.
 
+        Files are copied with asynchronous DOS packets: the copy buffer is
+        split into several parts, and the next part is read from the source
+        while the previous one is written to the destination. When the
+        source size is known, the destination is sized up front with
+        SetFileSize(). Interactive and non-filesystem streams are copied
+        with plain Read() and Write() calls.
+
         Example: Copy RAM:S RAM:S/C ALL
 
 
@@ -319,7 +331,7 @@ typedef ULONG IPTR;
 
 #include <string.h>
 
-const TEXT version[] = "\0$VER: Copy 50.18 (08.05.2025)";
+const TEXT version[] = "\0$VER: Copy 50.19 (19.10.2026)";
 
 static const UBYTE *PARAM =
 "FROM/M/A,TO/A,PAT=PATTERN/K,BUF=BUFFER/K/N,ALL/S,"
@@ -332,7 +344,7 @@ static const UBYTE *PARAM =
 "MOVE/S,DELETE/S,HARD=HARDLINK/S,SOFT=SOFTLINK/S,"
 "FOLNK=FORCELINK/S,FODEL=FORCEDELETE/S,"
 "FOOVR=FORCEOVERWRITE/S,DONTOVR=DONTOVERWRITE/S,"
-"FORCE/S,NEWER/S";
+"FORCE/S,NEWER/S,STATS/S";
 
 #define COPYFLAG_ALL            (1<<0)
 #define COPYFLAG_DATES          (1<<1)
@@ -346,6 +358,7 @@ static const UBYTE *PARAM =
 #define COPYFLAG_VERBOSE        (1<<9)
 #define COPYFLAG_ERRWARN        (1<<10)
 #define COPYFLAG_NEWER          (1<<11)
+#define COPYFLAG_STATS          (1<<12)
 
 #define COPYFLAG_SOFTLINK       (1<<20) /* produce softlinks */
 #define COPYFLAG_DEST_FILE      (1<<21) /* one file mode */
@@ -366,6 +379,8 @@ static const UBYTE *PARAM =
 
 #define FILEPATH_SIZE           2048    /* maximum size of filepaths     */
 
+#define COPY_PIPEBUFFERS        4       /* parts of the copy buffer      */
+
 /* return values */
 #define TESTDEST_DIR_OK         2       /* directory exists, go in */
 #define TESTDEST_DELETED        1       /* file or empty directory deleted */
@@ -402,6 +417,7 @@ struct IptrArgs
     IPTR  dontoverwrite;
     IPTR  force;
     IPTR  newer;
+    IPTR  stats;
 };
 
 
@@ -432,6 +448,7 @@ struct Args
     LONG    dontoverwrite;
     LONG    force;
     LONG    newer;
+    LONG    stats;
 };
 
 
@@ -457,6 +474,12 @@ struct CopyData
 
     STRPTR      CopyBuf;
     ULONG       CopyBufLen;
+    struct DosPacket *ReadPkt;  /* packets for the pipelined copy */
+    struct DosPacket *WritePkt;
+
+    UQUAD       CopiedBytes;    /* totals for the STATS output */
+    ULONG       CopiedFiles;
+    struct DateStamp StartTime;
 };
 
 /*
@@ -501,6 +524,7 @@ struct VersionData {
 #define TEXT_ERR_DEST_DIR       texts[20]
 #define TEXT_ERR_INFINITE_LOOP  texts[21]
 #define TEXT_ERR_WILDCARD_DEST  texts[22]
+#define TEXT_STATS              texts[23]
 
 const CONST_STRPTR texts[] =
     {
@@ -527,9 +551,13 @@ const CONST_STRPTR texts[] =
         "Destination must be a directory.\n",
         "Infinite loop not allowed.\n",
         "Wildcard destination invalid.\n",
+        "%lu files, %lu KB copied in %lu.%02lu seconds (%lu KB/s)\n",
     };
 
 LONG  CopyFile(BPTR, BPTR, ULONG, struct CopyData *);
+static BOOL CanPipeline(BPTR, BPTR, ULONG, struct CopyData *);
+static LONG CopyFilePipelined(BPTR, BPTR, STRPTR, ULONG, struct CopyData *);
+static void PrintStats(struct CopyData *);
 void  DoWork(STRPTR, struct CopyData *);
 LONG  IsMatchPattern(STRPTR name, struct CopyData *cd);
 LONG  IsPattern(STRPTR, struct CopyData *); /* return 0 -> NOPATTERN, return -1 --> ERROR */
@@ -629,7 +657,8 @@ __startup static AROS_PROCH(Start, argstr, argsize, SysBase)
                 "FOOVR    also overwrite protected files\n"
                 "DONTOVR  do never overwrite destination\n"
                 "FORCE    DO NOT USE. Call compatibility only.\n"
-                "NEWER    will compare version strings and only overwrites older files\n";
+                "NEWER    will compare version strings and only overwrites older files\n"
+                "STATS    print the amount copied and the throughput\n";
 
             if (ReadArgs(PARAM, (IPTR *)&iArgs, rda))
             {
@@ -666,6 +695,7 @@ __startup static AROS_PROCH(Start, argstr, argsize, SysBase)
                 args.dontoverwrite = (LONG)iArgs.dontoverwrite;
                 args.force = (LONG)iArgs.force;
                 args.newer = (LONG)iArgs.newer;
+                args.stats = (LONG)iArgs.stats;
 
                 if (args.quiet) /* when QUIET, SILENT and NOREQ are also
                                    true! */
@@ -741,6 +771,12 @@ __startup static AROS_PROCH(Start, argstr, argsize, SysBase)
                     cd->Flags |= COPYFLAG_NEWER|COPYFLAG_DONTOVERWRITE;
                 }
 
+                if (args.stats)
+                {
+                    cd->Flags |= COPYFLAG_STATS;
+                    DateStamp(&cd->StartTime);
+                }
+
                 if (args.errwarn)
                 {
                     cd->Flags |= COPYFLAG_ERRWARN;
@@ -1181,11 +1217,27 @@ __startup static AROS_PROCH(Start, argstr, argsize, SysBase)
             cd->RetVal2 = RETURN_ERROR;
         }
 
+        if ((cd->Flags & (COPYFLAG_STATS|COPYFLAG_QUIET)) == COPYFLAG_STATS &&
+            cd->CopiedFiles)
+        {
+            PrintStats(cd);
+        }
+
         if (cd->CopyBuf)
         {
             FreeMem(cd->CopyBuf, cd->CopyBufLen);
         }
 
+        if (cd->ReadPkt)
+        {
+            FreeDosObject(DOS_STDPKT, cd->ReadPkt);
+        }
+
+        if (cd->WritePkt)
+        {
+            FreeDosObject(DOS_STDPKT, cd->WritePkt);
+        }
+
 #undef SysBase
 #undef DOSBase
     }
@@ -2203,6 +2255,11 @@ LONG CopyFile(BPTR from, BPTR to, ULONG bufsize, struct CopyData *cd)
         }
         else
 #endif /* USE_BOGUSEOFWORKAROUND */
+        if (CanPipeline(from, to, bufsize, cd))
+        {
+            err = CopyFilePipelined(from, to, buffer, bufsize, cd);
+        }
+        else
         {
             /* Stream or so, copy until EOF or error */
             do
@@ -2221,9 +2278,15 @@ LONG CopyFile(BPTR from, BPTR to, ULONG bufsize, struct CopyData *cd)
                     err = RETURN_FAIL;
                     break;
                 }
+                cd->CopiedBytes += s;
             } while (s > 0);
         }
 
+        if (!err)
+        {
+            cd->CopiedFiles++;
+        }
+
         /* Freed at exit to avoid fragmentation */
         /*FreeMem(buffer, bufsize);*/
     }
@@ -2236,6 +2299,169 @@ LONG CopyFile(BPTR from, BPTR to, ULONG bufsize, struct CopyData *cd)
 }
 
 
+/* Both handles must be handled by a packet handler, and neither may be
+   interactive: Flush() is needed on those, and only a file offers a size
+   to pre-allocate. */
+static BOOL CanPipeline(BPTR from, BPTR to, ULONG bufsize, struct CopyData *cd)
+{
+    struct FileHandle *src = BADDR(from), *dst = BADDR(to);
+
+    if (bufsize < COPY_PIPEBUFFERS * 512 || !src->fh_Type || !dst->fh_Type ||
+        IsInteractive(from) || IsInteractive(to))
+    {
+        return FALSE;
+    }
+
+    if (!cd->ReadPkt)
+    {
+        cd->ReadPkt = AllocDosObject(DOS_STDPKT, NULL);
+    }
+
+    if (!cd->WritePkt)
+    {
+        cd->WritePkt = AllocDosObject(DOS_STDPKT, NULL);
+    }
+
+    return cd->ReadPkt && cd->WritePkt;
+}
+
+
+/* The copy buffer is split into COPY_PIPEBUFFERS parts. The reader fills
+ * them ahead of the writer, so that the source is read while the previous
+ * part is written to the destination. Only one packet per handle is
+ * outstanding at any time, so both handlers see the requests in file order.
+ */
+static LONG CopyFilePipelined(BPTR from, BPTR to, STRPTR buffer, ULONG bufsize, struct CopyData *cd)
+{
+    struct FileHandle *src = BADDR(from), *dst = BADDR(to);
+    struct MsgPort *replyport = &((struct Process *)FindTask(NULL))->pr_MsgPort;
+    struct DosPacket *rdpkt = cd->ReadPkt, *wrpkt = cd->WritePkt, *dp;
+    struct FileInfoBlock *fib = (struct FileInfoBlock *) buffer; /* NOTE: bufsize is min 512 bytes */
+    ULONG partsize = (bufsize / COPY_PIPEBUFFERS) & ~511;
+    LONG len[COPY_PIPEBUFFERS];
+    ULONG head = 0, filled = 0;
+    BOOL reading = FALSE, writing = FALSE, eof = FALSE;
+    LONG err = 0, ioerr = 0, presize = 0;
+    UQUAD copied = 0;
+
+    /* Let the destination allocate the whole file at once */
+    if (ExamineFH(from, fib) && fib->fib_Size > (LONG)partsize)
+    {
+        presize = fib->fib_Size;
+        if (SetFileSize(to, presize, OFFSET_BEGINNING) == -1)
+        {
+            presize = 0;
+        }
+    }
+
+    for (;;)
+    {
+        if (!err && !eof && !reading && filled < COPY_PIPEBUFFERS)
+        {
+            ULONG tail = (head + filled) % COPY_PIPEBUFFERS;
+
+            rdpkt->dp_Type = ACTION_READ;
+            rdpkt->dp_Arg1 = src->fh_Arg1;
+            rdpkt->dp_Arg2 = (SIPTR)(buffer + tail * partsize);
+            rdpkt->dp_Arg3 = partsize;
+            SendPkt(rdpkt, src->fh_Type, replyport);
+            reading = TRUE;
+        }
+
+        if (!err && !writing && filled > 0)
+        {
+            wrpkt->dp_Type = ACTION_WRITE;
+            wrpkt->dp_Arg1 = dst->fh_Arg1;
+            wrpkt->dp_Arg2 = (SIPTR)(buffer + head * partsize);
+            wrpkt->dp_Arg3 = len[head];
+            SendPkt(wrpkt, dst->fh_Type, replyport);
+            writing = TRUE;
+        }
+
+        if (!reading && !writing)
+        {
+            break;
+        }
+
+        dp = WaitPkt();
+
+        if (dp == rdpkt)
+        {
+            reading = FALSE;
+            if (dp->dp_Res1 < 0)
+            {
+                err = RETURN_FAIL;
+                ioerr = dp->dp_Res2;
+            }
+            else if (dp->dp_Res1 == 0)
+            {
+                eof = TRUE;
+            }
+            else
+            {
+                len[(head + filled) % COPY_PIPEBUFFERS] = dp->dp_Res1;
+                filled++;
+            }
+        }
+        else if (dp == wrpkt)
+        {
+            writing = FALSE;
+            if (dp->dp_Res1 != len[head])
+            {
+                err = RETURN_FAIL;
+                ioerr = dp->dp_Res2;
+            }
+            else
+            {
+                copied += len[head];
+                head = (head + 1) % COPY_PIPEBUFFERS;
+                filled--;
+            }
+        }
+
+        /* Stop issuing packets, but wait for the ones in flight */
+        if (!err && CTRL_C)
+        {
+            err = RETURN_FAIL;
+            ioerr = cd->IoErr = ERROR_BREAK;
+        }
+    }
+
+    cd->CopiedBytes += copied;
+
+    if (err)
+    {
+        SetIoErr(ioerr);
+    }
+    else if (presize && copied != presize)
+    {
+        SetFileSize(to, copied, OFFSET_BEGINNING);
+    }
+
+    return err;
+}
+
+
+static void PrintStats(struct CopyData *cd)
+{
+    struct DateStamp now;
+    ULONG ticks;
+
+    DateStamp(&now);
+    ticks = ((now.ds_Days - cd->StartTime.ds_Days) * 24 * 60 +
+             now.ds_Minute - cd->StartTime.ds_Minute) * 60 * TICKS_PER_SECOND +
+            now.ds_Tick - cd->StartTime.ds_Tick;
+    if (!ticks)
+    {
+        ticks = 1;
+    }
+
+    Printf(TEXT_STATS, cd->CopiedFiles, (ULONG)(cd->CopiedBytes >> 10),
+           ticks / TICKS_PER_SECOND, (ticks % TICKS_PER_SECOND) * 2,
+           (ULONG)((cd->CopiedBytes * TICKS_PER_SECOND / ticks) >> 10));
+}
+
+
 /* Softlink's path starts always with device name! f.e. "Ram Disk:T/..." */
 LONG LinkFile(BPTR from, STRPTR to, ULONG soft, struct CopyData *cd)
 {
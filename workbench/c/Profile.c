@@ -0,0 +1,612 @@
+/*
+    Copyright (C) 2026, The AROS Development Team. All rights reserved.
+
+    Desc: Statistical profiler
+*/
+
+/******************************************************************************
+
+
+    NAME
+
+        Profile
+
+    SYNOPSIS
+
+        TIME/N,EVERY/N/K,DEPTH/N/K,TOP/N/K
+
+    LOCATION
+
+        C:
+
+    FUNCTION
+
+        Finds out where the system spends its time. The timer interrupt of
+        every CPU samples the code it interrupted, until Ctrl-C is pressed
+        or TIME seconds have passed. Profile then prints, for each task,
+        the functions that it was running most often.
+
+        For each function the "Self" column is the share of the task's
+        samples taken in the function itself, and the "Total" column the
+        share taken in the function or in any function it called.
+
+        Sampling costs very little, so it can be left running on a busy
+        system to find out what keeps it busy.
+
+    INPUTS
+
+        TIME    -- Seconds to sample for. By default sampling goes on until
+                   Ctrl-C is pressed.
+        EVERY   -- Timer ticks between samples. The default is 1.
+        DEPTH   -- Return addresses to record with each sample, from 0 to
+                   7. The default is 7.
+        TOP     -- Functions to print for each task. The default is 10.
+
+    RESULT
+
+    NOTES
+
+        The timer ticks 1000 times per second on PCs with a local APIC,
+        and 200 times per second on hosted systems.
+
+        Return addresses are only found in code built with frame pointers.
+        Without them, the Total column only counts the interrupted function.
+
+        Samples taken while interrupt code was running are shown under
+        "<interrupts>".
+
+    EXAMPLE
+
+        Run >RAM:profile.txt Profile TIME 30 TOP 20
+
+    BUGS
+
+        Tasks that end before their samples are read are shown by address.
+
+    SEE ALSO
+
+        TaskList
+
+    INTERNALS
+
+        Samples are taken by the kernel, see KrnSetSampler(). Addresses are
+        resolved with DecodeLocationA() as soon as they are read, so that
+        code that is unloaded later still gets a name.
+
+    HISTORY
+
+******************************************************************************/
+
+#include <aros/kernel.h>
+#include <exec/memory.h>
+#include <exec/tasks.h>
+#include <dos/dos.h>
+#include <dos/dosextens.h>
+#include <libraries/debug.h>
+#include <proto/exec.h>
+#include <proto/dos.h>
+#include <proto/debug.h>
+#include <proto/kernel.h>
+#include <proto/task.h>
+
+#include <resources/task.h>
+
+#include <stdlib.h>
+#include <string.h>
+
+const TEXT version[] = "$VER: Profile 1.0 (19.10.2026)\n";
+
+#define ARG_TEMPLATE "TIME/N,EVERY/N/K,DEPTH/N/K,TOP/N/K"
+
+enum
+{
+    ARG_TIME = 0,
+    ARG_EVERY,
+    ARG_DEPTH,
+    ARG_TOP,
+    NOOFARGS
+};
+
+/* Samples per CPU. At 1000 ticks per second we read them every 1/10 s */
+#define SAMPLES         1024
+#define READ_INTERVAL   5
+
+APTR KernelBase = NULL;
+APTR TaskResBase = NULL;
+struct Library *DebugBase = NULL;
+
+int __nocommandline = 1;
+
+/* Pointer keyed hash table */
+struct Table
+{
+    APTR   *t_Keys;
+    APTR   *t_Values;
+    ULONG   t_Count;
+    ULONG   t_Size;
+};
+
+struct Func
+{
+    CONST_STRPTR    f_Module;
+    CONST_STRPTR    f_Symbol;
+};
+
+struct FuncCount
+{
+    struct Func    *fc_Func;
+    ULONG           fc_Self;
+    ULONG           fc_Total;
+    ULONG           fc_LastSample;      /* Counts each function once per sample in fc_Total */
+};
+
+struct TaskStat
+{
+    APTR            ts_Task;
+    CONST_STRPTR    ts_Name;
+    ULONG           ts_Samples;
+    struct Table    ts_Funcs;           /* struct Func -> struct FuncCount */
+};
+
+static APTR pool;
+static struct Table pcs;                /* PC -> struct Func */
+static struct Table symbols;            /* Symbol start -> struct Func */
+static struct Table segments;           /* Segment start -> struct Func, for code without symbols */
+static struct Table tasks;              /* Task -> struct TaskStat */
+static struct Func unknown = { NULL, "???" };
+static struct Task interrupts;          /* Key for samples of interrupt code */
+static ULONG numsamples;
+
+static ULONG hashPtr(APTR p)
+{
+    IPTR h = (IPTR)p;
+
+    return (ULONG)(h ^ (h >> 7) ^ (h >> 17));
+}
+
+/* Return the value of key, or a NULL value if the key was just added */
+static APTR *tableSlot(struct Table *t, APTR key)
+{
+    ULONG i;
+
+    if (t->t_Count * 2 >= t->t_Size)
+    {
+        struct Table old = *t;
+        ULONG j;
+
+        t->t_Size = old.t_Size ? old.t_Size * 2 : 64;
+        t->t_Keys = AllocVec(t->t_Size * 2 * sizeof(APTR), MEMF_ANY | MEMF_CLEAR);
+        if (t->t_Keys == NULL)
+        {
+            *t = old;
+            if (t->t_Size == 0 || t->t_Count >= t->t_Size - 1)
+                return NULL;
+        }
+        else
+        {
+            t->t_Values = t->t_Keys + t->t_Size;
+            t->t_Count = 0;
+
+            for (j = 0; j < old.t_Size; j++)
+            {
+                if (old.t_Keys[j])
+                    *tableSlot(t, old.t_Keys[j]) = old.t_Values[j];
+            }
+            FreeVec(old.t_Keys);
+        }
+    }
+
+    for (i = hashPtr(key) % t->t_Size; t->t_Keys[i]; i = (i + 1) % t->t_Size)
+    {
+        if (t->t_Keys[i] == key)
+            return &t->t_Values[i];
+    }
+
+    t->t_Keys[i] = key;
+    t->t_Values[i] = NULL;
+    t->t_Count++;
+
+    return &t->t_Values[i];
+}
+
+static CONST_STRPTR copyName(CONST_STRPTR name)
+{
+    STRPTR copy;
+
+    if (name == NULL || (copy = AllocPooled(pool, strlen(name) + 1)) == NULL)
+        return NULL;
+
+    strcpy(copy, name);
+
+    return copy;
+}
+
+static struct Func *findFunc(APTR pc)
+{
+    struct Func **pcfunc = (struct Func **)tableSlot(&pcs, pc), **func;
+    STRPTR module = NULL, symbol = NULL;
+    APTR symstart = NULL, segstart = NULL;
+
+    if (pcfunc == NULL)
+        return &unknown;
+    if (*pcfunc)
+        return *pcfunc;
+
+    DecodeLocation(pc,
+        DL_ModuleName, &module, DL_SegmentStart, &segstart,
+        DL_SymbolName, &symbol, DL_SymbolStart, &symstart,
+        TAG_DONE);
+
+    if (symbol && symstart)
+        func = (struct Func **)tableSlot(&symbols, symstart);
+    else if (module && segstart)
+        func = (struct Func **)tableSlot(&segments, segstart);
+    else
+        func = NULL;
+
+    if (func == NULL)
+        return (*pcfunc = &unknown);
+
+    if (*func == NULL && (*func = AllocPooled(pool, sizeof(struct Func))) != NULL)
+    {
+        (*func)->f_Module = copyName(module);
+        (*func)->f_Symbol = symbol ? copyName(symbol) : NULL;
+    }
+
+    return (*pcfunc = *func ? *func : &unknown);
+}
+
+/* Get the name now, the task may be gone by the time we print it */
+static CONST_STRPTR findTaskName(APTR task)
+{
+    struct TaskList *taskList;
+    struct Task *t;
+    TEXT name[64];
+
+    if (task == &interrupts)
+        return "<interrupts>";
+
+    name[0] = '\0';
+
+    taskList = LockTaskList(LTF_ALL);
+    while ((t = NextTaskEntry(taskList, LTF_ALL)) != NULL)
+    {
+        if (t == task)
+        {
+            CONST_STRPTR s = t->tc_Node.ln_Name;
+
+            if (t->tc_Node.ln_Type == NT_PROCESS && ((struct Process *)t)->pr_CLI)
+            {
+                struct CommandLineInterface *cli = BADDR(((struct Process *)t)->pr_CLI);
+
+                if (cli->cli_CommandName)
+                    s = AROS_BSTR_ADDR(cli->cli_CommandName);
+            }
+
+            if (s)
+            {
+                strncpy(name, s, sizeof(name) - 1);
+                name[sizeof(name) - 1] = '\0';
+            }
+            break;
+        }
+    }
+    UnLockTaskList(taskList, LTF_ALL);
+
+    if (name[0] == '\0')
+        return NULL;
+
+    return copyName(name);
+}
+
+static void addSample(struct KrnSample *ks)
+{
+    APTR key = ks->ks_Task ? ks->ks_Task : &interrupts;
+    struct TaskStat **slot = (struct TaskStat **)tableSlot(&tasks, key), *ts;
+    ULONG i;
+
+    if (slot == NULL)
+        return;
+
+    if ((ts = *slot) == NULL)
+    {
+        if ((ts = AllocPooled(pool, sizeof(struct TaskStat))) == NULL)
+            return;
+        memset(ts, 0, sizeof(struct TaskStat));
+        ts->ts_Task = key;
+        ts->ts_Name = findTaskName(key);
+        *slot = ts;
+    }
+
+    numsamples++;
+    ts->ts_Samples++;
+
+    for (i = 0; i < ks->ks_Depth && i < KRNSAMPLE_DEPTH; i++)
+    {
+        /* Return addresses point after the call, which may be the next function */
+        APTR pc = i ? (APTR)((UBYTE *)ks->ks_PC[i] - 1) : ks->ks_PC[i];
+        struct Func *func = findFunc(pc);
+        struct FuncCount **fcslot = (struct FuncCount **)tableSlot(&ts->ts_Funcs, func), *fc;
+
+        if (fcslot == NULL)
+            continue;
+
+        if ((fc = *fcslot) == NULL)
+        {
+            if ((fc = AllocPooled(pool, sizeof(struct FuncCount))) == NULL)
+                continue;
+            memset(fc, 0, sizeof(struct FuncCount));
+            fc->fc_Func = func;
+            *fcslot = fc;
+        }
+
+        if (i == 0)
+            fc->fc_Self++;
+
+        /* Count recursive functions only once */
+        if (fc->fc_LastSample != numsamples)
+        {
+            fc->fc_LastSample = numsamples;
+            fc->fc_Total++;
+        }
+    }
+}
+
+static void readSamples(struct KrnSampler *ksr)
+{
+    ULONG cpu;
+
+    for (cpu = 0; cpu < ksr->ksr_CPUCount; cpu++)
+    {
+        struct KrnSampleBuffer *ksb = &ksr->ksr_Buffers[cpu];
+        ULONG head, tail;
+
+        head = ksb->ksb_Head;
+        __sync_synchronize();
+
+        for (tail = ksb->ksb_Tail; tail != head; tail++)
+            addSample(&ksb->ksb_Samples[tail & (ksr->ksr_Size - 1)]);
+
+        __sync_synchronize();
+        ksb->ksb_Tail = tail;
+    }
+}
+
+static int compareTasks(const void *a, const void *b)
+{
+    ULONG sa = (*(struct TaskStat * const *)a)->ts_Samples;
+    ULONG sb = (*(struct TaskStat * const *)b)->ts_Samples;
+
+    return (sa < sb) - (sa > sb);
+}
+
+static int compareCounts(const void *a, const void *b)
+{
+    const struct FuncCount *fa = *(struct FuncCount * const *)a;
+    const struct FuncCount *fb = *(struct FuncCount * const *)b;
+
+    if (fa->fc_Self != fb->fc_Self)
+        return (fa->fc_Self < fb->fc_Self) - (fa->fc_Self > fb->fc_Self);
+
+    return (fa->fc_Total < fb->fc_Total) - (fa->fc_Total > fb->fc_Total);
+}
+
+/* Collect the values of a table into an array, sorted with compare */
+static APTR *sortTable(struct Table *t, int (*compare)(const void *, const void *))
+{
+    APTR *array = AllocVec((t->t_Count + 1) * sizeof(APTR), MEMF_ANY);
+    ULONG i, n = 0;
+
+    if (array == NULL)
+        return NULL;
+
+    for (i = 0; i < t->t_Size; i++)
+    {
+        if (t->t_Keys[i] && t->t_Values[i])
+            array[n++] = t->t_Values[i];
+    }
+    array[n] = NULL;
+
+    qsort(array, n, sizeof(APTR), compare);
+
+    return array;
+}
+
+static ULONG permille(ULONG part, ULONG total)
+{
+    return total ? (ULONG)(((UQUAD)part * 1000 + total / 2) / total) : 0;
+}
+
+static void printProfile(ULONG top)
+{
+    struct TaskStat **tasklist = (struct TaskStat **)sortTable(&tasks, compareTasks);
+    ULONG t;
+
+    if (tasklist == NULL)
+        return;
+
+    for (t = 0; tasklist[t] && !CheckSignal(SIGBREAKF_CTRL_C); t++)
+    {
+        struct TaskStat *ts = tasklist[t];
+        struct FuncCount **counts;
+        ULONG share = permille(ts->ts_Samples, numsamples), i;
+
+        if (ts->ts_Name)
+            Printf("\n%s (0x%p), ", ts->ts_Name, ts->ts_Task);
+        else
+            Printf("\nTask 0x%p, ", ts->ts_Task);
+        Printf("%lu samples (%lu.%lu%%)\n", ts->ts_Samples, share / 10, share % 10);
+
+        if ((counts = (struct FuncCount **)sortTable(&ts->ts_Funcs, compareCounts)) == NULL)
+            continue;
+
+        PutStr("   Self  Total  Function\n");
+
+        for (i = 0; counts[i] && i < top; i++)
+        {
+            struct FuncCount *fc = counts[i];
+            ULONG self = permille(fc->fc_Self, ts->ts_Samples);
+            ULONG total = permille(fc->fc_Total, ts->ts_Samples);
+
+            /* Functions that only appear as callers are sorted last */
+            if (fc->fc_Self == 0)
+                break;
+
+            Printf("  %3lu.%lu%% %3lu.%lu%%  ", self / 10, self % 10, total / 10, total % 10);
+            if (fc->fc_Func->f_Symbol)
+                Printf("%s", fc->fc_Func->f_Symbol);
+            else
+                PutStr("???");
+            if (fc->fc_Func->f_Module)
+                Printf(" (%s)", fc->fc_Func->f_Module);
+            PutStr("\n");
+        }
+
+        FreeVec(counts);
+    }
+
+    FreeVec(tasklist);
+}
+
+static void freeTable(struct Table *t)
+{
+    FreeVec(t->t_Keys);
+    t->t_Keys = NULL;
+    t->t_Count = t->t_Size = 0;
+}
+
+int main(void)
+{
+    IPTR args[NOOFARGS] = { 0 };
+    struct RDArgs *rda;
+    struct KrnSampler sampler;
+    struct DateStamp start, now;
+    ULONG cpus = 0, cpu, time = 0, top = 10, dropped = 0, elapsed, i;
+    LONG return_code = RETURN_FAIL;
+
+    memset(&sampler, 0, sizeof(sampler));
+    sampler.ksr_Period = 1;
+    sampler.ksr_Depth = KRNSAMPLE_DEPTH;
+    sampler.ksr_Size = SAMPLES;
+
+    rda = ReadArgs(ARG_TEMPLATE, args, NULL);
+    if (rda == NULL)
+    {
+        PrintFault(IoErr(), "Profile");
+        return RETURN_FAIL;
+    }
+
+    if (args[ARG_TIME])
+        time = *(LONG *)args[ARG_TIME];
+    if (args[ARG_EVERY] && *(LONG *)args[ARG_EVERY] > 0)
+        sampler.ksr_Period = *(LONG *)args[ARG_EVERY];
+    if (args[ARG_DEPTH])
+    {
+        LONG depth = *(LONG *)args[ARG_DEPTH];
+
+        sampler.ksr_Depth = (depth < 0) ? 1 : (depth >= KRNSAMPLE_DEPTH) ? KRNSAMPLE_DEPTH : depth + 1;
+    }
+    if (args[ARG_TOP])
+        top = *(LONG *)args[ARG_TOP];
+
+    KernelBase = OpenResource("kernel.resource");
+    TaskResBase = OpenResource("task.resource");
+    DebugBase = OpenLibrary("debug.library", 0);
+
+    if (!KernelBase || !TaskResBase || !DebugBase)
+    {
+        PutStr("Profile: Can't open kernel.resource, task.resource or debug.library\n");
+        goto exit;
+    }
+
+    cpus = KrnGetCPUCount();
+    pool = CreatePool(MEMF_ANY, 16384, 4096);
+    sampler.ksr_CPUCount = cpus;
+    sampler.ksr_Buffers = AllocVec(cpus * sizeof(struct KrnSampleBuffer), MEMF_PUBLIC | MEMF_CLEAR);
+    if (sampler.ksr_Buffers)
+    {
+        for (cpu = 0; cpu < cpus; cpu++)
+        {
+            sampler.ksr_Buffers[cpu].ksb_Samples = AllocVec(SAMPLES * sizeof(struct KrnSample), MEMF_PUBLIC);
+            if (sampler.ksr_Buffers[cpu].ksb_Samples == NULL)
+                break;
+        }
+    }
+
+    if (!pool || !sampler.ksr_Buffers || cpu < cpus)
+    {
+        PrintFault(ERROR_NO_FREE_STORE, "Profile");
+        goto exit;
+    }
+
+    if (!KrnSetSampler(&sampler))
+    {
+        PutStr("Profile: Somebody else is sampling already\n");
+        return_code = RETURN_WARN;
+        goto exit;
+    }
+
+    if (time)
+        Printf("Sampling for %lu seconds, press Ctrl-C to stop\n", time);
+    else
+        PutStr("Sampling, press Ctrl-C to stop\n");
+
+    DateStamp(&start);
+    do
+    {
+        Delay(READ_INTERVAL);
+        readSamples(&sampler);
+
+        DateStamp(&now);
+        elapsed = (now.ds_Days - start.ds_Days) * 24 * 60 * 60 * TICKS_PER_SECOND +
+                  (now.ds_Minute - start.ds_Minute) * 60 * TICKS_PER_SECOND +
+                  (now.ds_Tick - start.ds_Tick);
+    } while (!CheckSignal(SIGBREAKF_CTRL_C) && (time == 0 || elapsed < time * TICKS_PER_SECOND));
+
+    KrnSetSampler(NULL);
+    readSamples(&sampler);
+
+    for (cpu = 0; cpu < cpus; cpu++)
+        dropped += sampler.ksr_Buffers[cpu].ksb_Dropped;
+
+    i = elapsed * 100 / TICKS_PER_SECOND;
+    Printf("%lu samples in %lu.%02lu seconds on %lu CPU(s)", numsamples, i / 100, i % 100, cpus);
+    if (dropped)
+        Printf(", %lu lost", dropped);
+    PutStr("\n");
+
+    printProfile(top);
+
+    return_code = RETURN_OK;
+
+exit:
+    if (sampler.ksr_Buffers)
+    {
+        for (cpu = 0; cpu < cpus; cpu++)
+            FreeVec(sampler.ksr_Buffers[cpu].ksb_Samples);
+        FreeVec(sampler.ksr_Buffers);
+    }
+
+    if (pool)
+    {
+        for (i = 0; i < tasks.t_Size; i++)
+        {
+            struct TaskStat *ts = tasks.t_Values[i];
+
+            if (tasks.t_Keys[i] && ts)
+                freeTable(&ts->ts_Funcs);
+        }
+        DeletePool(pool);
+    }
+    freeTable(&tasks);
+    freeTable(&pcs);
+    freeTable(&symbols);
+    freeTable(&segments);
+
+    if (DebugBase)
+        CloseLibrary(DebugBase);
+
+    FreeArgs(rda);
+
+    return return_code;
+}
@@ -1,5 +1,5 @@
 /*
-    Copyright (C) 1995-2022, The AROS Development Team. All rights reserved.
+    Copyright (C) 1995-2026, The AROS Development Team. All rights reserved.
 */
 
 /* TODO:
@@ -299,7 +299,9 @@ static void unloadCommand(ShellState *ss, BPTR commandSeg,
 
 /* Function: loadCommand
  *
- * Action:   Load a command, searching the resident lists, paths and C:
+ * Action:   Load a command, searching the resident lists, paths and C:.
+ *           Pure commands are returned as resident segments owned by the
+ *           segment cache.
  *
  * Input:    ShellState    *ss              --  this state
  *           STRPTR         commandName     --  the command to load
@@ -318,7 +320,8 @@ static BPTR loadCommand(ShellState *ss, STRPTR commandName, BPTR *scriptLock,
     BPTR  *paths;
     struct Segment *residentSeg;
     BOOL absolutePath = strpbrk(commandName, "/:") != NULL;
-    BPTR file;
+    BPTR file, cachedDir;
+    TEXT fullName[FILE_MAX];
     LONG err = 0;
 
     /* We check the resident lists only if we do not have an absolute path */
@@ -368,6 +371,25 @@ static BPTR loadCommand(ShellState *ss, STRPTR commandName, BPTR *scriptLock,
         )
             return BNULL;
 
+        /* Try where the command was found the last time */
+        if (pathCacheFind(ss, commandName, &cachedDir))
+        {
+            if (cachedDir)
+            {
+                CurrentDir(cachedDir);
+                file = Open(commandName, MODE_OLDFILE);
+            }
+            else
+            {
+                file = Open(commandName - 2, MODE_OLDFILE);
+                if (file)
+                    commandName -= 2;
+            }
+
+            if (!file)
+                pathCacheForget(ss, commandName);
+        }
+
         /* Search the command in the path */
         for
         (
@@ -378,20 +400,55 @@ static BPTR loadCommand(ShellState *ss, STRPTR commandName, BPTR *scriptLock,
         {
             CurrentDir(paths[1]);
             file = Open(commandName, MODE_OLDFILE);
+            if (file)
+                pathCacheStore(ss, commandName, paths[1]);
         }
 
         /* The last resort -- the C: multiassign */
         if (!file)
         {
+            file = Open(commandName - 2, MODE_OLDFILE);
+            if (file)
+                pathCacheStore(ss, commandName, BNULL);
             commandName -= 2;
-            file = Open(commandName, MODE_OLDFILE);
         }
     }
 
     if (file)
     {
-        commandSeg = LoadSeg(commandName);
-        err = IoErr();
+        struct FileInfoBlock *fib = AllocDosObject(DOS_FIB, NULL);
+        BOOL examined = fib && ExamineFH(file, fib);
+        BOOL pure = examined && (fib->fib_Protection & FIBF_PURE) &&
+                    NameFromFH(file, fullName, sizeof(fullName));
+        struct Segment *cachedSeg = NULL;
+
+        /* Pure commands may already be loaded by this or another Shell */
+        if (pure && (cachedSeg = segCacheFind(ss, fullName, &fib->fib_Date)))
+        {
+            commandSeg = MKBADDR(cachedSeg);
+            *residentCommand = TRUE;
+            err = 0;
+        }
+        else
+        {
+            commandSeg = LoadSeg(commandName);
+            err = IoErr();
+
+            if (commandSeg)
+            {
+                if (pure)
+                    cachedSeg = segCacheAdd(ss, fullName, &fib->fib_Date,
+                                            fib->fib_Size, commandSeg);
+                else
+                    segCacheImpure(ss);
+
+                if (cachedSeg)
+                {
+                    commandSeg = MKBADDR(cachedSeg);
+                    *residentCommand = TRUE;
+                }
+            }
+        }
 
         if (commandSeg)
         {
@@ -406,8 +463,7 @@ static BPTR loadCommand(ShellState *ss, STRPTR commandName, BPTR *scriptLock,
         /* Do not attempt to execute corrupted executables (BAD_HUNK)
          * Do not swallow original error code */
         if (!commandSeg && err == ERROR_NOT_EXECUTABLE) {
-            struct FileInfoBlock *fib = AllocDosObject(DOS_FIB, NULL);
-            if (fib && ExamineFH(file, fib) && (fib->fib_Protection & FIBF_SCRIPT))
+            if (examined && (fib->fib_Protection & FIBF_SCRIPT))
             {
                 commandSeg = LoadSeg("C:Execute");
                 if (commandSeg) {
@@ -420,9 +476,10 @@ static BPTR loadCommand(ShellState *ss, STRPTR commandName, BPTR *scriptLock,
             }
             else
                 err = ERROR_FILE_NOT_OBJECT;
-            FreeDosObject(DOS_FIB, fib);
         }
 
+        if (fib)
+            FreeDosObject(DOS_FIB, fib);
         Close(file);
     } else
         err = IoErr();
@@ -709,6 +766,7 @@ __startup AROS_CLI(ShellStart)
     if (ss->arg_rd)
         FreeDosObject(DOS_RDARGS, ss->arg_rd);
 
+    pathCacheFree(ss);
     FreeMem(ss, sizeof(ShellState));
 
     /* Make sure Input(), Output() and pr_CES don't
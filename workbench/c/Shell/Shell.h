@@ -1,5 +1,5 @@
 /*
-    Copyright (C) 1995-2021, The AROS Development Team. All rights reserved.
+    Copyright (C) 1995-2026, The AROS Development Team. All rights reserved.
 */
 
 #ifndef SHELL_H
@@ -133,6 +133,17 @@ void setPath(ShellState *ss, BPTR lock);
  */
 void cliPrompt(ShellState *ss);
 
+/* Command caches, see segcache.c */
+struct SegCache *segCacheGet(ShellState *ss);
+struct Segment *segCacheFind(ShellState *ss, CONST_STRPTR name, struct DateStamp *date);
+struct Segment *segCacheAdd(ShellState *ss, CONST_STRPTR name, struct DateStamp *date,
+                            ULONG size, BPTR seg);
+void segCacheImpure(ShellState *ss);
+BOOL pathCacheFind(ShellState *ss, CONST_STRPTR name, BPTR *dir);
+void pathCacheStore(ShellState *ss, CONST_STRPTR name, BPTR dir);
+void pathCacheForget(ShellState *ss, CONST_STRPTR name);
+void pathCacheFree(ShellState *ss);
+
 /* Other internal functions
  *
  * FIXME: some doc ?
@@ -0,0 +1,452 @@
+/*
+    Copyright (C) 2026, The AROS Development Team. All rights reserved.
+ */
+
+#define __EXEC_NOLIBBASE__
+
+#include <aros/debug.h>
+
+#include <exec/memory.h>
+#include <proto/exec.h>
+#include <proto/dos.h>
+
+#include <string.h>
+
+/* Before Shell.h, whose state.h turns SysBase and DOSBase into macros */
+#include "segcache.h"
+#include "Shell.h"
+
+static ULONG hashName(CONST_STRPTR name)
+{
+    ULONG hash = 0;
+
+    while (*name)
+        hash = hash * 31 + (UBYTE)*name++;
+
+    return hash;
+}
+
+/* Function: segCacheGet
+ *
+ * Action:   Find the segment cache shared by all Shells, creating it if
+ *           this is the first Shell to use it.
+ *
+ * Input:    ShellState    *ss  --  this state
+ *
+ * Output:   struct SegCache *  --  the cache or NULL
+ */
+struct SegCache *segCacheGet(ShellState *ss)
+{
+    struct SegCache *sc;
+
+    if (ss->segCache)
+        return ss->segCache;
+
+    Forbid();
+
+    sc = (struct SegCache *)FindSemaphore(SEGCACHE_NAME);
+    if (sc == NULL)
+    {
+        sc = AllocMem(sizeof(struct SegCache), MEMF_PUBLIC | MEMF_CLEAR);
+        if (sc)
+        {
+            NEWLIST((struct List *)&sc->sc_LRU);
+            NEWLIST((struct List *)&sc->sc_Retired);
+            sc->sc_Version = SEGCACHE_VERSION;
+            sc->sc_MaxSize = SEGCACHE_DEFMAXSIZE;
+            strcpy(sc->sc_Name, SEGCACHE_NAME);
+            sc->sc_Semaphore.ss_Link.ln_Name = sc->sc_Name;
+            sc->sc_Semaphore.ss_Link.ln_Pri = -128;
+            AddSemaphore(&sc->sc_Semaphore);
+        }
+    }
+    else if (sc->sc_Version != SEGCACHE_VERSION)
+        sc = NULL;
+
+    Permit();
+
+    ss->segCache = sc;
+
+    return sc;
+}
+
+/* Function: segCacheFind
+ *
+ * Action:   Look up a pure command in the segment cache.
+ *
+ * Input:    ShellState       *ss    --  this state
+ *           CONST_STRPTR      name  --  full path of the command file
+ *           struct DateStamp *date  --  date of the command file
+ *
+ * Output:   struct Segment *  --  resident segment with its usage count
+ *                                 raised, or NULL if it is not cached
+ */
+struct Segment *segCacheFind(ShellState *ss, CONST_STRPTR name, struct DateStamp *date)
+{
+    struct SegCache *sc = segCacheGet(ss);
+    struct SegCacheEntry *sce;
+    ULONG hash = hashName(name);
+
+    if (sc == NULL)
+        return NULL;
+
+    ObtainSemaphore(&sc->sc_Semaphore);
+
+    segCacheReapRetired(sc, SysBase, DOSBase);
+
+    for (sce = sc->sc_Hash[hash % SEGCACHE_HASHSIZE]; sce; sce = sce->sce_HashNext)
+    {
+        if (sce->sce_Hash == hash && strcmp(sce->sce_Name, name) == 0)
+            break;
+    }
+
+    if (sce && CompareDates(&sce->sce_Date, date) != 0)
+    {
+        /* The file was replaced, drop the old version */
+        D(bug("[Shell] segcache: %s changed\n", name));
+
+        segCacheUnlink(sc, sce);
+
+        Forbid();
+        if (sce->sce_Segment.seg_UC > 0)
+        {
+            AddTail((struct List *)&sc->sc_Retired, (struct Node *)&sce->sce_Node);
+            sce = NULL;
+        }
+        Permit();
+
+        if (sce)
+            segCacheFree(sce, SysBase, DOSBase);
+        sce = NULL;
+    }
+
+    if (sce)
+    {
+        Forbid();
+        sce->sce_Segment.seg_UC++;
+        Permit();
+
+        Remove((struct Node *)&sce->sce_Node);
+        AddHead((struct List *)&sc->sc_LRU, (struct Node *)&sce->sce_Node);
+        sc->sc_Hits++;
+    }
+    else
+        sc->sc_Misses++;
+
+    ReleaseSemaphore(&sc->sc_Semaphore);
+
+    return sce ? &sce->sce_Segment : NULL;
+}
+
+/* Function: segCacheAdd
+ *
+ * Action:   Hand a freshly loaded pure command over to the segment cache,
+ *           evicting the least recently used idle commands to make room.
+ *
+ * Input:    ShellState       *ss    --  this state
+ *           CONST_STRPTR      name  --  full path of the command file
+ *           struct DateStamp *date  --  date of the command file
+ *           ULONG             size  --  size of the command file
+ *           BPTR              seg   --  the loaded segment list
+ *
+ * Output:   struct Segment *  --  resident segment owning seg with a usage
+ *                                 count of one, or NULL if it was not
+ *                                 cached and the caller still owns seg
+ */
+struct Segment *segCacheAdd(ShellState *ss, CONST_STRPTR name, struct DateStamp *date,
+                            ULONG size, BPTR seg)
+{
+    struct SegCache *sc = segCacheGet(ss);
+    struct SegCacheEntry *sce;
+    struct MinNode *node, *prev;
+    ULONG namelen = strlen(name);
+    ULONG hash = hashName(name);
+
+    if (sc == NULL)
+        return NULL;
+
+    ObtainSemaphore(&sc->sc_Semaphore);
+
+    /* Another Shell may have loaded the same command meanwhile */
+    for (sce = sc->sc_Hash[hash % SEGCACHE_HASHSIZE]; sce; sce = sce->sce_HashNext)
+    {
+        if (sce->sce_Hash == hash && strcmp(sce->sce_Name, name) == 0)
+            break;
+    }
+
+    if (sce || size > sc->sc_MaxSize)
+    {
+        ReleaseSemaphore(&sc->sc_Semaphore);
+        return NULL;
+    }
+
+    /* Evict idle entries, oldest first */
+    for
+    (
+        node = sc->sc_LRU.mlh_TailPred;
+        sc->sc_Size + size > sc->sc_MaxSize && (prev = node->mln_Pred);
+        node = prev
+    )
+    {
+        sce = SCE_FROMNODE(node);
+
+        if (segCacheIdle(sce, SysBase))
+        {
+            segCacheUnlink(sc, sce);
+            segCacheFree(sce, SysBase, DOSBase);
+            sc->sc_Evictions++;
+        }
+    }
+
+    sce = NULL;
+    if (sc->sc_Size + size <= sc->sc_MaxSize)
+        sce = AllocVec(sizeof(struct SegCacheEntry) + namelen, MEMF_PUBLIC | MEMF_CLEAR);
+
+    if (sce)
+    {
+        sce->sce_Segment.seg_UC = 1;
+        sce->sce_Segment.seg_Seg = seg;
+        sce->sce_Date = *date;
+        sce->sce_Size = size;
+        sce->sce_Hash = hash;
+        CopyMem(name, sce->sce_Name, namelen + 1);
+
+        sce->sce_HashNext = sc->sc_Hash[sce->sce_Hash % SEGCACHE_HASHSIZE];
+        sc->sc_Hash[sce->sce_Hash % SEGCACHE_HASHSIZE] = sce;
+        AddHead((struct List *)&sc->sc_LRU, (struct Node *)&sce->sce_Node);
+        sc->sc_Size += size;
+        sc->sc_Entries++;
+
+        D(bug("[Shell] segcache: added %s, %lu bytes cached\n", name, sc->sc_Size));
+    }
+
+    ReleaseSemaphore(&sc->sc_Semaphore);
+
+    return sce ? &sce->sce_Segment : NULL;
+}
+
+/* Function: segCacheImpure
+ *
+ * Action:   Count a command that was loaded without being cacheable.
+ *
+ * Input:    ShellState    *ss  --  this state
+ *
+ * Output:   --
+ */
+void segCacheImpure(ShellState *ss)
+{
+    struct SegCache *sc = segCacheGet(ss);
+
+    if (sc)
+    {
+        ObtainSemaphore(&sc->sc_Semaphore);
+        sc->sc_Impure++;
+        ReleaseSemaphore(&sc->sc_Semaphore);
+    }
+}
+
+/* The path cache is valid as long as the path list has the same nodes
+ * and locks it had when the entries were stored.
+ */
+static ULONG pathSignature(ShellState *ss)
+{
+    struct CommandLineInterface *cli = Cli();
+    BPTR *paths;
+    ULONG sig = 1;
+
+    for (paths = (BPTR *)BADDR(cli->cli_CommandDir); paths; paths = (BPTR *)BADDR(paths[0]))
+        sig = sig * 31 + (ULONG)(IPTR)paths + (ULONG)(IPTR)paths[1];
+
+    return sig ? sig : 1;
+}
+
+static void pathCacheReset(ShellState *ss)
+{
+    ss->pathCache->pc_Signature = 0;
+    memset(ss->pathCache->pc_Entries, 0, sizeof(ss->pathCache->pc_Entries));
+}
+
+/* Fill the cache afresh: remember the path list and the dates of its
+ * directories.
+ */
+static BOOL pathCacheInit(ShellState *ss)
+{
+    struct PathCache *pc = ss->pathCache;
+    struct CommandLineInterface *cli = Cli();
+    BPTR *paths;
+    ULONG i = 0;
+
+    pathCacheReset(ss);
+
+    for (paths = (BPTR *)BADDR(cli->cli_CommandDir); paths && i < PATHCACHE_DIRS;
+         paths = (BPTR *)BADDR(paths[0]), i++)
+    {
+        if (!Examine(paths[1], pc->pc_FIB))
+            return FALSE;
+        pc->pc_Dates[i] = pc->pc_FIB->fib_Date;
+    }
+
+    pc->pc_Signature = pathSignature(ss);
+    return TRUE;
+}
+
+/* Check that none of the first 'count' path directories has changed
+ * since the cache was filled.
+ */
+static BOOL pathCacheValid(ShellState *ss, ULONG count)
+{
+    struct PathCache *pc = ss->pathCache;
+    struct CommandLineInterface *cli = Cli();
+    BPTR *paths;
+    ULONG i;
+
+    for (paths = (BPTR *)BADDR(cli->cli_CommandDir), i = 0; paths && i < count;
+         paths = (BPTR *)BADDR(paths[0]), i++)
+    {
+        if (!Examine(paths[1], pc->pc_FIB) ||
+            CompareDates(&pc->pc_Dates[i], &pc->pc_FIB->fib_Date) != 0)
+        {
+            return FALSE;
+        }
+    }
+
+    return TRUE;
+}
+
+static struct PathCacheEntry *pathCacheSlot(ShellState *ss, CONST_STRPTR name)
+{
+    if (ss->pathCache == NULL || strlen(name) >= PATHCACHE_NAMELEN)
+        return NULL;
+
+    return &ss->pathCache->pc_Entries[hashName(name) % PATHCACHE_SIZE];
+}
+
+/* Function: pathCacheFind
+ *
+ * Action:   Look up the path directory a command was last found in.
+ *
+ * Input:    ShellState    *ss    --  this state
+ *           CONST_STRPTR   name  --  command name as typed
+ *           BPTR          *dir   --  path directory, or BNULL if the
+ *                                    command was found in C:
+ *
+ * Output:   BOOL  --  TRUE if the command is in the cache
+ */
+BOOL pathCacheFind(ShellState *ss, CONST_STRPTR name, BPTR *dir)
+{
+    struct PathCacheEntry *pce;
+    struct SegCache *sc = segCacheGet(ss);
+    BOOL found = FALSE;
+
+    if (ss->pathCache && ss->pathCache->pc_Signature != pathSignature(ss))
+    {
+        D(bug("[Shell] pathcache: path changed\n"));
+        pathCacheReset(ss);
+    }
+
+    pce = pathCacheSlot(ss, name);
+    if (pce && strcmp(pce->pce_Name, name) == 0)
+    {
+        /* A command may have been added to a directory in front of it */
+        if (pathCacheValid(ss, pce->pce_Index))
+        {
+            *dir = pce->pce_Dir;
+            found = TRUE;
+        }
+        else
+        {
+            D(bug("[Shell] pathcache: path directory changed\n"));
+            pathCacheReset(ss);
+        }
+    }
+
+    if (sc)
+    {
+        ObtainSemaphore(&sc->sc_Semaphore);
+        if (found)
+            sc->sc_PathHits++;
+        else
+            sc->sc_PathMisses++;
+        ReleaseSemaphore(&sc->sc_Semaphore);
+    }
+
+    return found;
+}
+
+/* Function: pathCacheStore
+ *
+ * Action:   Remember the path directory a command was found in.
+ *
+ * Input:    ShellState    *ss    --  this state
+ *           CONST_STRPTR   name  --  command name as typed
+ *           BPTR           dir   --  path directory, or BNULL for C:
+ *
+ * Output:   --
+ */
+void pathCacheStore(ShellState *ss, CONST_STRPTR name, BPTR dir)
+{
+    struct CommandLineInterface *cli = Cli();
+    struct PathCacheEntry *pce;
+    BPTR *paths;
+    ULONG index = 0;
+
+    if (ss->pathCache == NULL)
+    {
+        ss->pathCache = AllocMem(sizeof(struct PathCache), MEMF_ANY | MEMF_CLEAR);
+        if (ss->pathCache == NULL)
+            return;
+        ss->pathCache->pc_FIB = AllocDosObject(DOS_FIB, NULL);
+        if (ss->pathCache->pc_FIB == NULL)
+        {
+            pathCacheFree(ss);
+            return;
+        }
+    }
+
+    if (ss->pathCache->pc_Signature != pathSignature(ss) && !pathCacheInit(ss))
+        return;
+
+    /* Find the position of the directory, C: comes after all of them */
+    for (paths = (BPTR *)BADDR(cli->cli_CommandDir); paths && paths[1] != dir;
+         paths = (BPTR *)BADDR(paths[0]))
+    {
+        index++;
+    }
+    if (index > PATHCACHE_DIRS)
+        return;
+
+    if ((pce = pathCacheSlot(ss, name)))
+    {
+        pce->pce_Dir = dir;
+        pce->pce_Index = index;
+        strcpy(pce->pce_Name, name);
+    }
+}
+
+/* Function: pathCacheForget
+ *
+ * Action:   Drop a command whose cached location turned out to be wrong.
+ *
+ * Input:    ShellState    *ss    --  this state
+ *           CONST_STRPTR   name  --  command name as typed
+ *
+ * Output:   --
+ */
+void pathCacheForget(ShellState *ss, CONST_STRPTR name)
+{
+    struct PathCacheEntry *pce = pathCacheSlot(ss, name);
+
+    if (pce && strcmp(pce->pce_Name, name) == 0)
+        pce->pce_Name[0] = '\0';
+}
+
+void pathCacheFree(ShellState *ss)
+{
+    if (ss->pathCache)
+    {
+        if (ss->pathCache->pc_FIB)
+            FreeDosObject(DOS_FIB, ss->pathCache->pc_FIB);
+        FreeMem(ss->pathCache, sizeof(struct PathCache));
+    }
+    ss->pathCache = NULL;
+}
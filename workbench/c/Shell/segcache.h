@@ -0,0 +1,148 @@
+/*
+    Copyright (C) 2026, The AROS Development Team. All rights reserved.
+*/
+
+#ifndef SHELL_SEGCACHE_H
+#define SHELL_SEGCACHE_H 1
+
+#include <exec/semaphores.h>
+#include <exec/lists.h>
+#include <dos/dos.h>
+#include <dos/dosextens.h>
+#include <proto/exec.h>
+#include <proto/dos.h>
+
+#include <stddef.h>
+
+/* Pure (FIBF_PURE) commands loaded by any Shell are kept loaded in a
+ * cache shared by all Shells, found with FindSemaphore(SEGCACHE_NAME).
+ * An entry is reused only while the file keeps its path and DateStamp.
+ * C:SegCache shows the hit rates and can flush or resize the cache.
+ */
+#define SEGCACHE_NAME           "Shell Segment Cache"
+#define SEGCACHE_VERSION        1
+#define SEGCACHE_HASHSIZE       32
+#define SEGCACHE_DEFMAXSIZE     (512 * 1024)
+
+struct SegCacheEntry
+{
+    /* Handed to the Shell as a resident segment, so seg_UC counts the
+       Shells currently running the command */
+    struct Segment        sce_Segment;
+    struct MinNode        sce_Node;      /* sc_LRU or sc_Retired */
+    struct SegCacheEntry *sce_HashNext;
+    struct DateStamp      sce_Date;
+    ULONG                 sce_Size;      /* Size of the executable file */
+    ULONG                 sce_Hash;
+    TEXT                  sce_Name[1];   /* Full path, NUL terminated */
+};
+
+#define SCE_FROMNODE(n) \
+    ((struct SegCacheEntry *)((UBYTE *)(n) - offsetof(struct SegCacheEntry, sce_Node)))
+
+struct SegCache
+{
+    struct SignalSemaphore sc_Semaphore;
+    UWORD                  sc_Version;
+    struct MinList         sc_LRU;       /* Most recently used first */
+    struct MinList         sc_Retired;   /* Replaced while still running */
+    struct SegCacheEntry  *sc_Hash[SEGCACHE_HASHSIZE];
+    ULONG                  sc_Size;      /* Bytes of cached executables */
+    ULONG                  sc_MaxSize;
+    ULONG                  sc_Entries;
+    ULONG                  sc_Hits;
+    ULONG                  sc_Misses;
+    ULONG                  sc_Impure;    /* Loads of commands without FIBF_PURE */
+    ULONG                  sc_Evictions;
+    ULONG                  sc_PathHits;
+    ULONG                  sc_PathMisses;
+    TEXT                   sc_Name[sizeof(SEGCACHE_NAME)];
+};
+
+/* The helpers below are shared by the Shell and C:SegCache. They take the
+ * library bases as arguments because the Shell keeps them in its state,
+ * so the Shell must include this file before state.h.
+ */
+
+/* Unlink an entry from the hash chains and the LRU list. The caller holds
+ * the cache semaphore and has checked that nobody runs the segment.
+ */
+static inline void segCacheUnlink(struct SegCache *sc, struct SegCacheEntry *sce)
+{
+    struct SegCacheEntry **prev = &sc->sc_Hash[sce->sce_Hash % SEGCACHE_HASHSIZE];
+
+    while (*prev != sce)
+        prev = &(*prev)->sce_HashNext;
+    *prev = sce->sce_HashNext;
+
+    REMOVE(&sce->sce_Node);
+    sc->sc_Size -= sce->sce_Size;
+    sc->sc_Entries--;
+}
+
+static inline BOOL segCacheIdle(struct SegCacheEntry *sce, struct ExecBase *SysBase)
+{
+    BOOL idle;
+
+    Forbid();
+    idle = sce->sce_Segment.seg_UC == 0;
+    Permit();
+
+    return idle;
+}
+
+static inline void segCacheFree(struct SegCacheEntry *sce,
+                                struct ExecBase *SysBase, struct DosLibrary *DOSBase)
+{
+    UnLoadSeg(sce->sce_Segment.seg_Seg);
+    FreeVec(sce);
+}
+
+/* Free retired entries whose last user has finished. The caller holds the
+ * cache semaphore.
+ */
+static inline void segCacheReapRetired(struct SegCache *sc,
+                                       struct ExecBase *SysBase, struct DosLibrary *DOSBase)
+{
+    struct MinNode *node, *next;
+
+    for (node = sc->sc_Retired.mlh_Head; (next = node->mln_Succ); node = next)
+    {
+        struct SegCacheEntry *sce = SCE_FROMNODE(node);
+
+        if (segCacheIdle(sce, SysBase))
+        {
+            REMOVE(node);
+            segCacheFree(sce, SysBase, DOSBase);
+        }
+    }
+}
+
+/* Per Shell cache of where in the command path a command was found, so
+ * that running it again costs one Open() instead of one per path entry.
+ * An entry also says that the command is in none of the directories in
+ * front of that one, so it is only used while their DateStamps are the
+ * ones they had when the cache was filled. Adding a file to a directory
+ * changes its date. The cache is dropped whenever the path list
+ * (cli_CommandDir) or one of those dates changes.
+ */
+#define PATHCACHE_SIZE          64
+#define PATHCACHE_NAMELEN       32
+#define PATHCACHE_DIRS          16      /* Commands found further down aren't cached */
+
+struct PathCacheEntry
+{
+    BPTR  pce_Dir;                       /* Path directory, BNULL for C: */
+    UWORD pce_Index;                     /* Its position in the path */
+    TEXT  pce_Name[PATHCACHE_NAMELEN];   /* Empty if the slot is free */
+};
+
+struct PathCache
+{
+    ULONG                 pc_Signature;  /* Of the path list the entries are for, 0 = empty */
+    struct FileInfoBlock  *pc_FIB;
+    struct DateStamp      pc_Dates[PATHCACHE_DIRS];     /* Of the path directories */
+    struct PathCacheEntry pc_Entries[PATHCACHE_SIZE];
+};
+
+#endif
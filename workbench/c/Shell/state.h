@@ -1,5 +1,5 @@
 /*
-    Copyright (C) 2021, The AROS Development Team. All rights reserved.
+    Copyright (C) 2021-2026, The AROS Development Team. All rights reserved.
 */
 
 #ifndef SHELL_STATE_H
@@ -49,6 +49,9 @@ typedef struct _ShellState
 
     ULONG	flags;		/* DOS/CliInit*() flags cache */
 
+    struct SegCache  *segCache;	/* Shared cache of pure commands */
+    struct PathCache *pathCache;	/* Where path commands were found */
+
     APTR        ss_DOSBase;
     APTR        ss_SysBase;
 } ShellState;
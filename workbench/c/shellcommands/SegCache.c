@@ -0,0 +1,151 @@
+/*
+    Copyright (C) 2026, The AROS Development Team. All rights reserved.
+
+    Desc: SegCache CLI command
+*/
+
+/******************************************************************************
+
+
+    NAME
+
+        SegCache
+
+    SYNOPSIS
+
+        SIZE/N/K,FLUSH/S,RESET/S
+
+    LOCATION
+
+        C:
+
+    FUNCTION
+
+        Shows and controls the cache in which the Shell keeps pure
+        commands loaded after they have run, so that running them again
+        does not load them from disk.
+
+        Commands are cached when they have the "P" protection flag set,
+        and are reused while the file keeps its path and date.
+
+        Without arguments it prints the size of the cache and its hit
+        rates, together with those of the per Shell cache of where
+        commands were found in the command path.
+
+    INPUTS
+
+        SIZE    -- Maximum size in bytes of the executables kept in the
+                   cache. 0 disables caching.
+        FLUSH   -- Unload all cached commands that are not running,
+                   and old versions of replaced commands that have
+                   finished running.
+        RESET   -- Reset the statistics.
+
+    RESULT
+
+    NOTES
+
+    EXAMPLE
+
+        SEGCACHE SIZE=1048576
+
+    BUGS
+
+    SEE ALSO
+
+        Resident, Path
+
+    INTERNALS
+
+        The cache is found through a public semaphore created by the
+        first Shell that runs a command, see Shell/segcache.h.
+
+    HISTORY
+
+******************************************************************************/
+
+#include <proto/exec.h>
+#include <proto/dos.h>
+#include <dos/dosextens.h>
+#include <exec/lists.h>
+
+#include <aros/shcommands.h>
+
+#include "../Shell/segcache.h"
+
+static ULONG percent(ULONG part, ULONG total)
+{
+    return total ? (ULONG)((UQUAD)part * 100 / total) : 0;
+}
+
+AROS_SH3(SegCache, 41.1,
+AROS_SHA(LONG *, , SIZE,/N/K,NULL),
+AROS_SHA(BOOL, , FLUSH,/S,FALSE),
+AROS_SHA(BOOL, , RESET,/S,FALSE))
+{
+    AROS_SHCOMMAND_INIT
+
+    struct SegCache *sc;
+    struct MinNode *node, *next;
+
+    Forbid();
+    sc = (struct SegCache *)FindSemaphore(SEGCACHE_NAME);
+    Permit();
+
+    /* The cache is never freed, so it can be used after Permit() */
+    if (sc == NULL || sc->sc_Version != SEGCACHE_VERSION)
+    {
+        PutStr("No segment cache found.\n");
+        return RETURN_WARN;
+    }
+
+    ObtainSemaphore(&sc->sc_Semaphore);
+
+    if (SHArg(SIZE))
+        sc->sc_MaxSize = *SHArg(SIZE) > 0 ? *SHArg(SIZE) : 0;
+
+    /* Flush idle entries, and trim the cache to a smaller size */
+    for (node = sc->sc_LRU.mlh_TailPred; (next = node->mln_Pred); node = next)
+    {
+        struct SegCacheEntry *sce = SCE_FROMNODE(node);
+
+        if (!SHArg(FLUSH) && sc->sc_Size <= sc->sc_MaxSize)
+            break;
+
+        if (segCacheIdle(sce, SysBase))
+        {
+            segCacheUnlink(sc, sce);
+            segCacheFree(sce, SysBase, DOSBase);
+        }
+    }
+
+    /* Old versions of replaced commands that have finished running */
+    if (SHArg(FLUSH) || SHArg(RESET))
+        segCacheReapRetired(sc, SysBase, DOSBase);
+
+    if (SHArg(RESET))
+    {
+        sc->sc_Hits = sc->sc_Misses = sc->sc_Impure = sc->sc_Evictions = 0;
+        sc->sc_PathHits = sc->sc_PathMisses = 0;
+    }
+
+    if (!SHArg(SIZE) && !SHArg(FLUSH) && !SHArg(RESET))
+    {
+        Printf("Cached commands : %lu (%lu of %lu bytes)\n",
+               sc->sc_Entries, sc->sc_Size, sc->sc_MaxSize);
+        Printf("Segment hits    : %lu of %lu (%lu%%)\n",
+               sc->sc_Hits, sc->sc_Hits + sc->sc_Misses,
+               percent(sc->sc_Hits, sc->sc_Hits + sc->sc_Misses));
+        Printf("Not pure        : %lu\n", sc->sc_Impure);
+        Printf("Evictions       : %lu\n", sc->sc_Evictions);
+        Printf("Path hits       : %lu of %lu (%lu%%)\n",
+               sc->sc_PathHits, sc->sc_PathHits + sc->sc_PathMisses,
+               percent(sc->sc_PathHits, sc->sc_PathHits + sc->sc_PathMisses));
+    }
+
+    ReleaseSemaphore(&sc->sc_Semaphore);
+
+    return RETURN_OK;
+
+    AROS_SHCOMMAND_EXIT
+}
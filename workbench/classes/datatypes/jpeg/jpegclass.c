@@ -1,5 +1,5 @@
 /*
-    Copyright (C) 1995-2025, The AROS Development Team. All rights reserved.
+    Copyright (C) 1995-2026, The AROS Development Team. All rights reserved.
 */
 
 /**********************************************************************/
@@ -171,7 +171,7 @@ static void JPEG_Exit(JpegHandleType *jpeghandle, LONG errorcode)
 
 /**************************************************************************************************/
 
-static BOOL LoadJPEG(struct IClass *cl, Object *o)
+static BOOL LoadJPEG(struct IClass *cl, Object *o, ULONG max_size)
 {
     JpegHandleType          *jpeghandle;
     union {
@@ -241,6 +241,17 @@ static BOOL LoadJPEG(struct IClass *cl, Object *o)
     
     D(bug("jpeg.datatype/LoadJPEG(): Read Header\n"));
     (void) jpeg_read_header(&cinfo, TRUE);
+    if (max_size)
+    {
+        /* Only a thumbnail is needed, let the IDCT scale down by up to 1/8 */
+        long size = (cinfo.image_width > cinfo.image_height) ? cinfo.image_width : cinfo.image_height;
+
+        cinfo.scale_num = 1;
+        cinfo.scale_denom = 1;
+        while ((cinfo.scale_denom < 8) && ((size / (cinfo.scale_denom * 2)) >= max_size))
+            cinfo.scale_denom *= 2;
+        D(bug("jpeg.datatype/LoadJPEG(): Scaling by 1/%d\n", (int)cinfo.scale_denom));
+    }
     D(bug("jpeg.datatype/LoadJPEG(): Starting decompression\n"));
     (void) jpeg_start_decompress(&cinfo);
     /* set BitMapHeader with image size */
@@ -480,7 +491,9 @@ IPTR JPEG__OM_NEW(Class *cl, Object *o, Msg msg)
     newobj = (Object *)DoSuperMethodA(cl, o, (Msg)msg);
     if (newobj)
     {
-        if (!LoadJPEG(cl, newobj))
+        ULONG max_size = GetTagData(PDTA_ThumbnailSize, 0, ((struct opSet *)msg)->ops_AttrList);
+
+        if (!LoadJPEG(cl, newobj, max_size))
         {
             CoerceMethod(cl, newobj, OM_DISPOSE);
             newobj = NULL;
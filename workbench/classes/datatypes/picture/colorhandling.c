@@ -1,5 +1,5 @@
 /*
-    Copyright (C) 1995-2020, The AROS Development Team. All rights reserved.
+    Copyright (C) 1995-2026, The AROS Development Team. All rights reserved.
 */
 
 #include <stdio.h>
@@ -36,6 +36,7 @@ static BOOL RemapCM2CM( struct Picture_Data *pd );
 static BOOL RemapTC2CM( struct Picture_Data *pd );
 static int HistSort( const void *HistEntry1, const void *HistEntry2 );
 static void RemapPens( struct Picture_Data *pd, int NumColors, int DestNumColors );
+static UBYTE *PrepareInvColMap( struct Picture_Data *pd, int DestNumColors );
 
 /**************************************************************************************************/
 /*
@@ -105,7 +106,11 @@ BOOL ConvertTC2TC( struct Picture_Data *pd )
     }
     else
     {
-        success = ScaleArraySimple( pd, DestRP );
+        success = FALSE;
+        if( pd->ScaleQuality )
+            success = ScaleArrayFiltered( pd, &DestRP, NULL );
+        if( !success )
+            success = ScaleArraySimple( pd, DestRP );
     }
 
     return success ? TRUE : FALSE;
@@ -136,7 +141,11 @@ BOOL ConvertCM2TC( struct Picture_Data *pd )
     }
     else
     {
-        success = ScaleArraySimple( pd, DestRP );
+        success = FALSE;
+        if( pd->ScaleQuality )
+            success = ScaleArrayFiltered( pd, &DestRP, NULL );
+        if( !success )
+            success = ScaleArraySimple( pd, DestRP );
     }
 
     return success ? TRUE : FALSE;
@@ -328,6 +337,7 @@ BOOL AllocSrcBuffer( struct Picture_Data *pd, long width, long height, ULONG pix
         pd->SrcPixelFormat = RECTFMT_ARGB;
 
     pd->SrcPixelBytes = pixelbytes;
+    pd->HistValid = FALSE;
     D(bug("picture.datatype/AllocSrcBuffer: Chunky source buffer allocated, %ld bytes\n", (long)(pd->SrcWidthBytes * height)));
     return TRUE;
 }
@@ -400,6 +410,7 @@ void FreeSource( struct Picture_Data *pd )
         D(bug("picture.datatype/FreeSource: Freeing SrcBuffer\n"));
         FreeVec( (void *) pd->SrcBuffer );
         pd->SrcBuffer = NULL;
+        pd->HistValid = FALSE;
     }
     if( pd->SrcBM && !pd->KeepSrcBM )
     {
@@ -409,6 +420,17 @@ void FreeSource( struct Picture_Data *pd )
     }
 }
 
+void FreeColorCache( struct Picture_Data *pd )
+{
+    if( pd->InvColMap )
+    {
+        D(bug("picture.datatype/FreeColorCache: Freeing inverse colormap\n"));
+        FreeVec( (void *) pd->InvColMap );
+        pd->InvColMap = NULL;
+        pd->InvColMapNum = 0;
+    }
+}
+
 void FreeDest( struct Picture_Data *pd )
 {
     int i;
@@ -637,6 +659,93 @@ BOOL CreateMaskPlane( struct Picture_Data *pd )
 #define SKIPFIRSTBYTE (1 << 0)
 #define SKIPLASTBYTE (1 << 1)
 
+/*
+ *  Inverse colormap for truecolor -> colormapped remapping: one pen per
+ *  RGB555 color, filled in lazily on first use. It is kept across layouts
+ *  and only flushed when the obtained pens or their colors change, so
+ *  remapping the same picture again (after scaling, on another window of
+ *  the same screen ...) doesn't redo the nearest color searches.
+ */
+#define INVMAP_ENTRIES  32768
+#define INVMAP_INDEX(r, g, b) ((((r) & 0xf8) << 7) | (((g) & 0xf8) << 2) | ((b) >> 3))
+
+#define TC2CMPEN(pd, invmap, sparse, r, g, b) \
+    ((invmap) ? InvColMapPen( (pd), (invmap), (r), (g), (b) ) \
+              : (sparse)[((r)>>2 & 0x38) | ((g)>>5 & 0x07) | ((b) & 0xc0)])
+
+static UBYTE *PrepareInvColMap( struct Picture_Data *pd, int DestNumColors )
+{
+    ULONG pens[256];
+    int i, pen;
+
+    for( i=0; i<DestNumColors; i++ )
+    {
+        pen = pd->ColTable[i];
+        pens[i] = ((ULONG) pen << 24) |
+                  ((pd->DestColRegs[pen*3+0] >> 8) & 0x00ff0000) |
+                  ((pd->DestColRegs[pen*3+1] >> 16) & 0x0000ff00) |
+                  ((pd->DestColRegs[pen*3+2] >> 24) & 0x000000ff);
+    }
+
+    if( !pd->InvColMap )
+    {
+        /* pens followed by a bitmap of valid entries */
+        pd->InvColMap = AllocVec( INVMAP_ENTRIES + INVMAP_ENTRIES / 8, MEMF_ANY );
+        if( !pd->InvColMap )
+            return NULL;
+        pd->InvColMapNum = 0;
+    }
+
+    if( pd->InvColMapNum != DestNumColors ||
+        memcmp( pd->InvColMapPens, pens, DestNumColors * sizeof(ULONG) ) )
+    {
+        D(bug("picture.datatype/PrepareInvColMap: pens changed, flushing inverse colormap\n"));
+        memset( pd->InvColMap + INVMAP_ENTRIES, 0, INVMAP_ENTRIES / 8 );
+        CopyMem( pens, pd->InvColMapPens, DestNumColors * sizeof(ULONG) );
+        pd->InvColMapNum = DestNumColors;
+    }
+
+    return pd->InvColMap;
+}
+
+static UBYTE InvColMapPen( struct Picture_Data *pd, UBYTE *invmap, int r, int g, int b )
+{
+    ULONG index = INVMAP_INDEX( r, g, b );
+    UBYTE *valid = invmap + INVMAP_ENTRIES + (index >> 3);
+    ULONG dist, bestdist;
+    LONG dr, dg, db;
+    ULONG pen;
+    int i;
+
+    if( *valid & (1 << (index & 7)) )
+        return invmap[index];
+
+    /* Use the center of the RGB555 cell */
+    r = (r & 0xf8) | 4;
+    g = (g & 0xf8) | 4;
+    b = (b & 0xf8) | 4;
+
+    bestdist = 0xFFFFFFFF;
+    for( i=0; i<pd->InvColMapNum; i++ )
+    {
+        pen = pd->InvColMapPens[i];
+        dr = r - (LONG) ((pen >> 16) & 0xff);
+        dg = g - (LONG) ((pen >> 8) & 0xff);
+        db = b - (LONG) (pen & 0xff);
+        dist = dr*dr + dg*dg + db*db;
+        if( dist < bestdist )
+        {
+            invmap[index] = pen >> 24;
+            bestdist = dist;
+            if( !dist )
+                break;
+        }
+    }
+
+    *valid |= 1 << (index & 7);
+    return invmap[index];
+}
+
 static BOOL RemapTC2CM( struct Picture_Data *pd )
 {
     unsigned int DestNumColors;
@@ -681,7 +790,8 @@ static BOOL RemapTC2CM( struct Picture_Data *pd )
     RemapPens( pd, 256, DestNumColors );
 
     /*
-     *  Remap line-by-line truecolor source buffer to destination using sparse table
+     *  Remap line-by-line truecolor source buffer to destination using the
+     *  inverse colormap (or the sparse table, if there's no memory for it)
      */
     {
         struct RastPort DestRP;
@@ -690,9 +800,12 @@ static BOOL RemapTC2CM( struct Picture_Data *pd )
         UBYTE *srcline, *destline, *thissrc, *thisdest;
 
         UBYTE *srcbuf = pd->SrcBuffer;
+        UBYTE *scaledbuf = NULL;
         ULONG srcwidth = pd->SrcWidth;
+        ULONG srcmod = pd->SrcWidthBytes;
         ULONG destwidth = pd->DestWidth;
         UBYTE *sparsetable = pd->SparseTable;
+        UBYTE *invmap = PrepareInvColMap( pd, DestNumColors );
         int skipbyte = 0;
         BOOL scale = pd->Scale;
 
@@ -701,15 +814,36 @@ static BOOL RemapTC2CM( struct Picture_Data *pd )
         else if (pd->SrcPixelFormat == PBPAFMT_RGBA)
             skipbyte = SKIPLASTBYTE;
 
+        /* Filtered scaling is done up front, the result is remapped like an unscaled ARGB picture */
+        if( scale && pd->ScaleQuality )
+        {
+            scaledbuf = AllocLineBuffer( destwidth, pd->DestHeight, 4 );
+            if( scaledbuf && ScaleArrayFiltered( pd, NULL, scaledbuf ) )
+            {
+                srcbuf = scaledbuf;
+                srcwidth = destwidth;
+                srcmod = destwidth * 4;     /* as written by ScaleArrayFiltered() */
+                skipbyte = SKIPFIRSTBYTE;
+                scale = FALSE;
+            }
+        }
+
         srcline = AllocLineBuffer( MAX(srcwidth, destwidth) * 4, 1, 1 );
         if( !srcline )
+        {
+            FreeVec( scaledbuf );
             return FALSE;
+        }
         if( scale )
             destline = AllocLineBuffer( destwidth, 1, 1 );
         else
             destline = srcline;
         if( !destline )
+        {
+            FreeVec( scaledbuf );
+            FreeVec( srcline );
             return FALSE;
+        }
 
         InitRastPort( &DestRP );
         DestRP.BitMap = pd->DestBM;
@@ -763,8 +897,7 @@ static BOOL RemapTC2CM( struct Picture_Data *pd )
                         rval = CLIP( rerr );
                         gval = CLIP( gerr );
                         bval = CLIP( berr );
-                        index = (rval>>2 & 0x38) | (gval>>5 & 0x07) | (bval & 0xc0);
-                        destindex = sparsetable[index];
+                        destindex = TC2CMPEN( pd, invmap, sparsetable, rval, gval, bval );
                         *thisdest++ = destindex;
                         colregs = destcolregs + destindex*3;
                         rerr -= (*colregs++)>>24;
@@ -786,8 +919,8 @@ static BOOL RemapTC2CM( struct Picture_Data *pd )
                                     destwidth );
                 if( srcyinc )
                 {
-                    if( srcyinc == 1 )  srcbuf += pd->SrcWidthBytes;
-                    else                srcbuf += pd->SrcWidthBytes * srcyinc;
+                    if( srcyinc == 1 )  srcbuf += srcmod;
+                    else                srcbuf += srcmod * srcyinc;
                     srcy += srcyinc;
                 }
             }
@@ -806,13 +939,10 @@ static BOOL RemapTC2CM( struct Picture_Data *pd )
                     {
                         if( skipbyte == SKIPFIRSTBYTE )
                             thissrc++;
-                        index  = (*thissrc++)>>2 & 0x38; // red
-                        index |= (*thissrc++)>>5 & 0x07; // green
-                        index |= (*thissrc++)    & 0xc0; // blue
+                        *thisdest++ = TC2CMPEN( pd, invmap, sparsetable, thissrc[0], thissrc[1], thissrc[2] );
+                        thissrc += 3;
                         if( skipbyte == SKIPLASTBYTE )
                             thissrc++;
-
-                        *thisdest++ = sparsetable[index];
                     }
                     if( scale )
                         ScaleLineSimple( srcline, destline, destwidth, 1, pd->XScale );
@@ -831,8 +961,8 @@ static BOOL RemapTC2CM( struct Picture_Data *pd )
                                     destwidth );
                 if( srcyinc )
                 {
-                    if( srcyinc == 1 )  srcbuf += pd->SrcWidthBytes;
-                    else                srcbuf += pd->SrcWidthBytes * srcyinc;
+                    if( srcyinc == 1 )  srcbuf += srcmod;
+                    else                srcbuf += srcmod * srcyinc;
                     srcy += srcyinc;
                 }
             }
@@ -841,6 +971,7 @@ static BOOL RemapTC2CM( struct Picture_Data *pd )
         FreeVec( (void *) srcline );
         if( scale )
             FreeVec( (void *) destline );
+        FreeVec( (void *) scaledbuf );
     }
     return TRUE;
 }
@@ -879,19 +1010,28 @@ static BOOL RemapCM2CM( struct Picture_Data *pd )
     }
 
     /*
-     *  Determine the number of colors in histogram
+     *  Determine the number of colors in histogram. Counting needs a pass
+     *  over the whole picture, so the counts are kept until the source
+     *  buffer changes.
      */
+    if( !pd->HistValid )
     {
         UBYTE *sb = pd->SrcBuffer;
     
+        memset( pd->HistCount, 0, sizeof(pd->HistCount) );
         for( i=0; i<height; i++ )
         {
             for( j=0; j<width; j++ )
             {
-                TheHist[sb[j]].Count++;
+                pd->HistCount[sb[j]]++;
             }
             sb += pd->SrcWidthBytes;
         }
+        pd->HistValid = TRUE;
+    }
+    for( i=0; i<NumColors; i++ )
+    {
+        TheHist[i].Count = pd->HistCount[i];
     }
     
     /*
@@ -1,5 +1,5 @@
 /*
-    Copyright (C) 1995-2003, The AROS Development Team. All rights reserved.
+    Copyright (C) 1995-2026, The AROS Development Team. All rights reserved.
 */
 
 #define CLIP(x) ((x)>0xff ? 0xff : ((x)<0x00 ? 0x00 : (x)))
@@ -28,3 +28,6 @@ BOOL ConvertTC2TC( struct Picture_Data *pd );
 BOOL ConvertCM2TC( struct Picture_Data *pd );
 BOOL ConvertCM2CM( struct Picture_Data *pd );
 BOOL ConvertTC2CM( struct Picture_Data *pd );
+void FreeColorCache( struct Picture_Data *pd );
+
+BOOL ScaleArrayFiltered( struct Picture_Data *pd, struct RastPort *rp, UBYTE *argbbuf );
@@ -1,5 +1,5 @@
 /*
-    Copyright (C) 1995-2020, The AROS Development Team. All rights reserved.
+    Copyright (C) 1995-2026, The AROS Development Team. All rights reserved.
 */
 
 /* Supported Attributes (Init (new), Set, Get)
@@ -233,6 +233,7 @@ IPTR DT_DisposeMethod(struct IClass *cl, Object *o, Msg msg)
     {
         FreeDest(pd);
         FreeSource(pd);
+        FreeColorCache(pd);
     }
 
     RetVal += DoSuperMethodA(cl, o, msg);
@@ -1202,6 +1203,7 @@ IPTR PDT_WritePixelArray(struct IClass *cl, struct Gadget *g, struct pdtBlitPixe
     }
 
     pd->Layouted = FALSE;       /* re-layout required */
+    pd->HistValid = FALSE;
     return TRUE;
 }
 
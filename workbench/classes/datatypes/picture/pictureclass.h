@@ -1,5 +1,5 @@
 /*
-    Copyright (C) 1995-2020, The AROS Development Team. All rights reserved.
+    Copyright (C) 1995-2026, The AROS Development Team. All rights reserved.
 */
 
 #define	MIN(a,b) (((a) < (b)) ?	(a) : (b))
@@ -70,4 +70,11 @@ struct Picture_Data
     LONG		  ClickX;
     LONG		  ClickY;
     struct Screen         *RemapScreen;
+
+    /* remapping caches, see colorhandling.c */
+    ULONG		  HistCount[256];
+    BOOL		  HistValid;
+    UBYTE		  *InvColMap;
+    ULONG		  InvColMapPens[256];
+    UWORD		  InvColMapNum;
 };
@@ -0,0 +1,623 @@
+/*
+    Copyright (C) 2026, The AROS Development Team. All rights reserved.
+
+    Desc: Filtered, separable scaling of the chunky source buffer.
+*/
+
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+
+#include <exec/memory.h>
+#include <exec/tasks.h>
+#include <exec/semaphores.h>
+#include <graphics/gfxbase.h>
+#include <datatypes/datatypesclass.h>
+#include <datatypes/pictureclass.h>
+#include <cybergraphx/cybergraphics.h>
+
+#include <proto/exec.h>
+#include <proto/graphics.h>
+#include <proto/cybergraphics.h>
+#ifdef __AROS__
+#include <resources/processor.h>
+#include <proto/processor.h>
+#endif
+
+#include "debug.h"
+#include "pictureclass.h"
+#include "colorhandling.h"
+
+/*
+ *  The picture is scaled in two passes: every source row that is needed is
+ *  first scaled horizontally into a small ring of rows, which are then
+ *  combined vertically into the destination. Destination rows are produced
+ *  in strips; on SMP systems the rows of each strip are split between the
+ *  calling task and a few worker tasks.
+ *
+ *  The filter is selected with PDTA_ScaleQuality (or SCALEQUALITY in the
+ *  prefs file): 0 = nearest neighbour (ScaleArraySimple), 1 = box,
+ *  2 = bilinear, 3 and above = Lanczos3.
+ */
+
+#define SCALE_FRACBITS      14
+#define SCALE_ONE           (1 << SCALE_FRACBITS)
+#define SCALE_STRIPROWS     32
+#define SCALE_MAXWORKERS    8
+#define SCALE_MINPIXELS     (256 * 256)     /* below this workers aren't worth the startup */
+
+#define SCALEQ_BOX          1
+#define SCALEQ_BILINEAR     2
+#define SCALEQ_LANCZOS      3
+
+struct ScaleFilter
+{
+    ULONG               sf_Size;        /* destination size */
+    ULONG               sf_Taps;        /* max. source pixels per destination pixel */
+    LONG               *sf_First;       /* first source pixel */
+    LONG               *sf_Count;       /* number of source pixels */
+    WORD               *sf_Weights;     /* sf_Taps weights per destination pixel */
+};
+
+struct ScaleContext
+{
+    struct Picture_Data *sc_PD;
+    struct ScaleFilter   sc_H;
+    struct ScaleFilter   sc_V;
+    ULONG                sc_RowBytes;   /* bytes in one ARGB destination row */
+};
+
+struct ScalePool
+{
+    struct SignalSemaphore sp_Lock;
+    struct Task         *sp_Parent;
+    BYTE                 sp_SigBit;
+    ULONG                sp_DoneMask;
+    ULONG                sp_Done;
+};
+
+struct ScaleWorker
+{
+    struct ScaleContext *sw_Ctx;
+    struct ScalePool    *sw_Pool;
+    struct Task         *sw_Task;
+    ULONG                sw_SigMask;
+    UBYTE               *sw_SrcRow;     /* source row converted to ARGB */
+    UBYTE               *sw_Rows;       /* ring of horizontally scaled rows */
+    LONG                *sw_RowNum;     /* source row held by each ring slot */
+    UBYTE              **sw_RowPtrs;    /* rows used for the current destination row */
+    /* current job */
+    ULONG                sw_Y0;
+    ULONG                sw_Y1;
+    UBYTE               *sw_Out;        /* destination of row sw_Y0 */
+    BOOL                 sw_Quit;
+};
+
+/**************************************************************************************************/
+
+static double ScaleKernelRadius( UWORD quality )
+{
+    switch( quality )
+    {
+        case SCALEQ_BOX:        return 0.5;
+        case SCALEQ_BILINEAR:   return 1.0;
+        default:                return 3.0;
+    }
+}
+
+static double ScaleKernel( UWORD quality, double x )
+{
+    if( x < 0.0 )
+        x = -x;
+
+    switch( quality )
+    {
+        case SCALEQ_BOX:
+            return (x <= 0.5) ? 1.0 : 0.0;
+
+        case SCALEQ_BILINEAR:
+            return (x < 1.0) ? 1.0 - x : 0.0;
+
+        default:
+            if( x < 1e-8 )
+                return 1.0;
+            if( x >= 3.0 )
+                return 0.0;
+            x *= M_PI;
+            return 3.0 * sin( x ) * sin( x / 3.0 ) / (x * x);
+    }
+}
+
+static void FreeScaleFilter( struct ScaleFilter *sf )
+{
+    FreeVec( sf->sf_First );
+    FreeVec( sf->sf_Weights );
+    sf->sf_First = NULL;
+    sf->sf_Weights = NULL;
+}
+
+static BOOL InitScaleFilter( struct ScaleFilter *sf, ULONG srcsize, ULONG dstsize, UWORD quality )
+{
+    double scale, fscale, radius, center, total;
+    double *w;
+    ULONG d, i;
+
+    scale = (double) dstsize / (double) srcsize;
+    fscale = (scale < 1.0) ? scale : 1.0;       /* widen the filter when shrinking */
+    radius = ScaleKernelRadius( quality ) / fscale;
+
+    sf->sf_Size = dstsize;
+    sf->sf_Taps = (ULONG) ceil( radius * 2.0 ) + 2;
+    sf->sf_First = AllocVec( dstsize * 2 * sizeof(LONG), MEMF_ANY );
+    sf->sf_Weights = AllocVec( dstsize * sf->sf_Taps * sizeof(WORD), MEMF_ANY );
+    w = AllocVec( sf->sf_Taps * sizeof(double), MEMF_ANY );
+    if( !sf->sf_First || !sf->sf_Weights || !w )
+    {
+        D(bug("picture.datatype/InitScaleFilter: Out of memory\n"));
+        FreeVec( w );
+        FreeScaleFilter( sf );
+        return FALSE;
+    }
+    sf->sf_Count = sf->sf_First + dstsize;
+
+    for( d=0; d<dstsize; d++ )
+    {
+        LONG first, last, count, sum, best;
+        WORD *fw = sf->sf_Weights + d * sf->sf_Taps;
+
+        center = ((double) d + 0.5) / scale;
+        first = (LONG) floor( center - radius );
+        last = (LONG) ceil( center + radius );
+        if( first < 0 )
+            first = 0;
+        if( last > (LONG) srcsize - 1 )
+            last = srcsize - 1;
+        count = last - first + 1;
+        if( count > (LONG) sf->sf_Taps )
+            count = sf->sf_Taps;
+
+        total = 0.0;
+        for( i=0; i<count; i++ )
+        {
+            w[i] = ScaleKernel( quality, ((double) (first + i) + 0.5 - center) * fscale );
+            total += w[i];
+        }
+
+        if( total == 0.0 )
+        {
+            /* Can happen at the borders, fall back to the nearest pixel */
+            first = (LONG) center;
+            if( first > (LONG) srcsize - 1 )
+                first = srcsize - 1;
+            count = 1;
+            w[0] = total = 1.0;
+        }
+
+        /* Convert to fixed point, rounding errors go to the biggest weight */
+        sum = 0;
+        best = 0;
+        for( i=0; i<count; i++ )
+        {
+            fw[i] = (WORD) floor( w[i] / total * SCALE_ONE + 0.5 );
+            sum += fw[i];
+            if( fw[i] > fw[best] )
+                best = i;
+        }
+        fw[best] += SCALE_ONE - sum;
+
+        sf->sf_First[d] = first;
+        sf->sf_Count[d] = count;
+    }
+
+    FreeVec( w );
+    return TRUE;
+}
+
+/**************************************************************************************************/
+
+/* Convert one source row to ARGB */
+static void FetchSourceRow( struct Picture_Data *pd, ULONG row, UBYTE *dest )
+{
+    UBYTE *src = pd->SrcBuffer + row * pd->SrcWidthBytes;
+    ULONG x = pd->SrcWidth;
+    ULONG xrgb;
+
+    switch( pd->SrcPixelBytes )
+    {
+        case 1:
+            while( x-- )
+            {
+                xrgb = pd->ColTableXRGB[*src++];
+                *dest++ = 0xff;
+                *dest++ = xrgb >> 16;
+                *dest++ = xrgb >> 8;
+                *dest++ = xrgb;
+            }
+            break;
+
+        case 3:
+            while( x-- )
+            {
+                *dest++ = 0xff;
+                *dest++ = *src++;
+                *dest++ = *src++;
+                *dest++ = *src++;
+            }
+            break;
+
+        default:
+            if( pd->SrcPixelFormat == PBPAFMT_RGBA )
+            {
+                while( x-- )
+                {
+                    *dest++ = src[3];
+                    *dest++ = src[0];
+                    *dest++ = src[1];
+                    *dest++ = src[2];
+                    src += 4;
+                }
+            }
+            else
+            {
+                CopyMem( src, dest, pd->SrcWidth * 4 );
+            }
+            break;
+    }
+}
+
+/* Return source row 'row' scaled horizontally, using the worker's row ring as cache */
+static UBYTE *GetScaledRow( struct ScaleWorker *sw, LONG row )
+{
+    struct ScaleContext *sc = sw->sw_Ctx;
+    struct ScaleFilter *sf = &sc->sc_H;
+    ULONG slot = row % sc->sc_V.sf_Taps;
+    UBYTE *dest = sw->sw_Rows + slot * sc->sc_RowBytes;
+    UBYTE *src = sw->sw_SrcRow;
+    WORD *fw = sf->sf_Weights;
+    ULONG x;
+
+    if( sw->sw_RowNum[slot] == row )
+        return dest;
+
+    FetchSourceRow( sc->sc_PD, row, src );
+
+    for( x=0; x<sf->sf_Size; x++, fw += sf->sf_Taps )
+    {
+        UBYTE *s = src + (sf->sf_First[x] << 2);
+        LONG a = 0, r = 0, g = 0, b = 0;
+        LONG i;
+
+        for( i=0; i<sf->sf_Count[x]; i++ )
+        {
+            a += fw[i] * *s++;
+            r += fw[i] * *s++;
+            g += fw[i] * *s++;
+            b += fw[i] * *s++;
+        }
+        *dest++ = CLIP( (a + SCALE_ONE / 2) >> SCALE_FRACBITS );
+        *dest++ = CLIP( (r + SCALE_ONE / 2) >> SCALE_FRACBITS );
+        *dest++ = CLIP( (g + SCALE_ONE / 2) >> SCALE_FRACBITS );
+        *dest++ = CLIP( (b + SCALE_ONE / 2) >> SCALE_FRACBITS );
+    }
+
+    sw->sw_RowNum[slot] = row;
+    return sw->sw_Rows + slot * sc->sc_RowBytes;
+}
+
+/* Produce destination rows sw_Y0 .. sw_Y1 - 1 */
+static void ScaleRows( struct ScaleWorker *sw )
+{
+    struct ScaleContext *sc = sw->sw_Ctx;
+    struct ScaleFilter *sf = &sc->sc_V;
+    UBYTE **rows = sw->sw_RowPtrs;
+    UBYTE *out = sw->sw_Out;
+    ULONG y, x;
+    LONG i, count;
+
+    for( y=sw->sw_Y0; y<sw->sw_Y1; y++, out += sc->sc_RowBytes )
+    {
+        WORD *fw = sf->sf_Weights + y * sf->sf_Taps;
+
+        count = sf->sf_Count[y];
+        for( i=0; i<count; i++ )
+            rows[i] = GetScaledRow( sw, sf->sf_First[y] + i );
+
+        if( count == 1 )
+        {
+            CopyMem( rows[0], out, sc->sc_RowBytes );
+            continue;
+        }
+
+        for( x=0; x<sc->sc_RowBytes; x++ )
+        {
+            LONG acc = 0;
+
+            for( i=0; i<count; i++ )
+                acc += fw[i] * rows[i][x];
+            out[x] = CLIP( (acc + SCALE_ONE / 2) >> SCALE_FRACBITS );
+        }
+    }
+}
+
+/**************************************************************************************************/
+
+static BOOL InitScaleWorker( struct ScaleWorker *sw, struct ScaleContext *sc )
+{
+    ULONG i;
+
+    memset( sw, 0, sizeof(struct ScaleWorker) );
+    sw->sw_Ctx = sc;
+    sw->sw_SrcRow = AllocVec( sc->sc_PD->SrcWidth * 4, MEMF_ANY );
+    sw->sw_Rows = AllocVec( sc->sc_V.sf_Taps * sc->sc_RowBytes, MEMF_ANY );
+    sw->sw_RowNum = AllocVec( sc->sc_V.sf_Taps * sizeof(LONG), MEMF_ANY );
+    sw->sw_RowPtrs = AllocVec( sc->sc_V.sf_Taps * sizeof(UBYTE *), MEMF_ANY );
+    if( !sw->sw_SrcRow || !sw->sw_Rows || !sw->sw_RowNum || !sw->sw_RowPtrs )
+        return FALSE;
+
+    for( i=0; i<sc->sc_V.sf_Taps; i++ )
+        sw->sw_RowNum[i] = -1;
+
+    return TRUE;
+}
+
+static void FreeScaleWorker( struct ScaleWorker *sw )
+{
+    FreeVec( sw->sw_SrcRow );
+    FreeVec( sw->sw_Rows );
+    FreeVec( sw->sw_RowNum );
+    FreeVec( sw->sw_RowPtrs );
+}
+
+#ifdef __AROS__
+
+static void ScaleReport( struct ScalePool *sp )
+{
+    struct Task *parent = sp->sp_Parent;
+    ULONG donemask = sp->sp_DoneMask;
+
+    ObtainSemaphore( &sp->sp_Lock );
+    sp->sp_Done++;
+    ReleaseSemaphore( &sp->sp_Lock );
+    /* The parent may free everything as soon as it sees this, don't touch sp afterwards */
+    Signal( parent, donemask );
+}
+
+static void ScaleWaitDone( struct ScalePool *sp, ULONG count )
+{
+    ULONG done;
+
+    for( ;; )
+    {
+        ObtainSemaphore( &sp->sp_Lock );
+        done = sp->sp_Done;
+        ReleaseSemaphore( &sp->sp_Lock );
+        if( done >= count )
+            break;
+        Wait( sp->sp_DoneMask );
+    }
+    sp->sp_Done = 0;
+}
+
+static void ScaleWorkerEntry( struct ScaleWorker *sw )
+{
+    struct ScalePool *sp = sw->sw_Pool;
+    BYTE sigbit;
+
+    sigbit = AllocSignal( -1 );
+    sw->sw_SigMask = (sigbit != -1) ? (1L << sigbit) : 0;
+    ScaleReport( sp );
+    if( !sw->sw_SigMask )
+        return;
+
+    for( ;; )
+    {
+        Wait( sw->sw_SigMask );
+        if( sw->sw_Quit )
+            break;
+        ScaleRows( sw );
+        ScaleReport( sp );
+    }
+    ScaleReport( sp );
+}
+
+static void StopScaleWorkers( struct ScalePool *sp, struct ScaleWorker *workers, ULONG num, BOOL freesig );
+
+static ULONG ScaleNumCPUs( void )
+{
+    APTR ProcessorBase;
+    IPTR count = 1;
+
+    ProcessorBase = OpenResource( PROCESSORNAME );
+    if( ProcessorBase )
+        GetCPUInfoTags( GCIT_NumberOfProcessors, (IPTR) &count, TAG_DONE );
+
+    return (count > 0) ? count : 1;
+}
+
+/* Returns the number of running workers */
+static ULONG StartScaleWorkers( struct ScaleContext *sc, struct ScalePool *sp, struct ScaleWorker *workers )
+{
+    struct Task *me = FindTask( NULL );
+    ULONG num, started, i;
+    BYTE sigbit;
+
+    num = ScaleNumCPUs() - 1;
+    if( num > SCALE_MAXWORKERS )
+        num = SCALE_MAXWORKERS;
+    if( num == 0 || sc->sc_H.sf_Size * sc->sc_V.sf_Size < SCALE_MINPIXELS )
+        return 0;
+
+    sigbit = AllocSignal( -1 );
+    if( sigbit == -1 )
+        return 0;
+
+    memset( sp, 0, sizeof(struct ScalePool) );
+    InitSemaphore( &sp->sp_Lock );
+    sp->sp_Parent = me;
+    sp->sp_SigBit = sigbit;
+    sp->sp_DoneMask = 1L << sigbit;
+
+    started = 0;
+    for( i=0; i<num; i++ )
+    {
+        struct ScaleWorker *sw = &workers[started];
+
+        if( !InitScaleWorker( sw, sc ) )
+        {
+            FreeScaleWorker( sw );
+            break;
+        }
+        sw->sw_Pool = sp;
+        sw->sw_Task = NewCreateTask( TASKTAG_NAME,      "picture.datatype scaler",
+                                     TASKTAG_AFFINITY,  TASKAFFINITY_ANY,
+                                     TASKTAG_PRI,       me->tc_Node.ln_Pri,
+                                     TASKTAG_PC,        ScaleWorkerEntry,
+                                     TASKTAG_ARG1,      sw,
+                                     TAG_DONE );
+        if( !sw->sw_Task )
+        {
+            FreeScaleWorker( sw );
+            break;
+        }
+        started++;
+    }
+
+    /* Wait for all of them to allocate their signal */
+    ScaleWaitDone( sp, started );
+
+    /* The ones which couldn't are gone already, stop the others if there
+       is a gap. Running workers must stay at their place in the array. */
+    for( i=0; i<started; i++ )
+    {
+        if( !workers[i].sw_SigMask )
+        {
+            FreeScaleWorker( &workers[i] );
+            StopScaleWorkers( sp, &workers[i + 1], started - i - 1, FALSE );
+            started = i;
+        }
+    }
+
+    if( !started )
+        FreeSignal( sigbit );
+
+    D(bug("picture.datatype/StartScaleWorkers: %ld workers\n", (long) started));
+    return started;
+}
+
+static void StopScaleWorkers( struct ScalePool *sp, struct ScaleWorker *workers, ULONG num, BOOL freesig )
+{
+    ULONG i, running = 0;
+
+    for( i=0; i<num; i++ )
+    {
+        if( workers[i].sw_SigMask )
+        {
+            workers[i].sw_Quit = TRUE;
+            Signal( workers[i].sw_Task, workers[i].sw_SigMask );
+            running++;
+        }
+    }
+    ScaleWaitDone( sp, running );
+
+    for( i=0; i<num; i++ )
+        FreeScaleWorker( &workers[i] );
+
+    if( freesig )
+        FreeSignal( sp->sp_SigBit );
+}
+
+#endif /* __AROS__ */
+
+/**************************************************************************************************/
+
+/*
+ *  Scale the source buffer to DestWidth x DestHeight with the filter selected
+ *  by pd->ScaleQuality. The ARGB result is either written to rp, or, if argbbuf
+ *  is given, stored there with a modulo of DestWidth * 4.
+ */
+BOOL ScaleArrayFiltered( struct Picture_Data *pd, struct RastPort *rp, UBYTE *argbbuf )
+{
+    struct ScaleContext sc;
+    struct ScaleWorker self;
+    struct ScaleWorker workers[SCALE_MAXWORKERS];
+    struct ScalePool pool;
+    ULONG numworkers = 0;
+    UBYTE *strip = NULL;
+    ULONG y0, y1, rows, part, i;
+    BOOL success = FALSE;
+
+    D(bug("picture.datatype/ScaleArrayFiltered: %ldx%ld -> %ldx%ld quality %ld\n",
+        (long) pd->SrcWidth, (long) pd->SrcHeight, (long) pd->DestWidth, (long) pd->DestHeight, (long) pd->ScaleQuality));
+
+    memset( &sc, 0, sizeof(sc) );
+    memset( &self, 0, sizeof(self) );
+    sc.sc_PD = pd;
+    sc.sc_RowBytes = pd->DestWidth * 4;
+
+    if( !InitScaleFilter( &sc.sc_H, pd->SrcWidth, pd->DestWidth, pd->ScaleQuality ) ||
+        !InitScaleFilter( &sc.sc_V, pd->SrcHeight, pd->DestHeight, pd->ScaleQuality ) ||
+        !InitScaleWorker( &self, &sc ) )
+        goto done;
+
+    if( !argbbuf )
+    {
+        strip = AllocVec( SCALE_STRIPROWS * sc.sc_RowBytes, MEMF_ANY );
+        if( !strip )
+            goto done;
+    }
+
+#ifdef __AROS__
+    numworkers = StartScaleWorkers( &sc, &pool, workers );
+#endif
+
+    for( y0=0; y0<pd->DestHeight; y0=y1 )
+    {
+        UBYTE *out = argbbuf ? argbbuf + y0 * sc.sc_RowBytes : strip;
+
+        y1 = y0 + SCALE_STRIPROWS;
+        if( y1 > pd->DestHeight )
+            y1 = pd->DestHeight;
+        rows = y1 - y0;
+
+        /* The workers get the upper parts of the strip, we do the rest */
+        part = rows / (numworkers + 1);
+        self.sw_Y0 = y0;
+#ifdef __AROS__
+        if( part )
+        {
+            for( i=0; i<numworkers; i++ )
+            {
+                workers[i].sw_Y0 = y0 + i * part;
+                workers[i].sw_Y1 = workers[i].sw_Y0 + part;
+                workers[i].sw_Out = out + i * part * sc.sc_RowBytes;
+                Signal( workers[i].sw_Task, workers[i].sw_SigMask );
+            }
+            self.sw_Y0 = y0 + numworkers * part;
+        }
+#endif
+        self.sw_Y1 = y1;
+        self.sw_Out = out + (self.sw_Y0 - y0) * sc.sc_RowBytes;
+        ScaleRows( &self );
+#ifdef __AROS__
+        if( part )
+            ScaleWaitDone( &pool, numworkers );
+#endif
+
+        if( rp && !WritePixelArray( out, 0, 0, sc.sc_RowBytes, rp, 0, y0, pd->DestWidth, rows, RECTFMT_ARGB ) )
+            break;
+    }
+    success = (y0 >= pd->DestHeight);
+
+#ifdef __AROS__
+    if( numworkers )
+        StopScaleWorkers( &pool, workers, numworkers, TRUE );
+#endif
+
+done:
+    FreeVec( strip );
+    FreeScaleWorker( &self );
+    FreeScaleFilter( &sc.sc_H );
+    FreeScaleFilter( &sc.sc_V );
+
+    return success;
+}
@@ -1,5 +1,5 @@
 /*
-    Copyright  1995-2019, The AROS Development Team. All rights reserved.
+    Copyright  1995-2026, The AROS Development Team. All rights reserved.
 */
 
 /**************************************************************************************************/
@@ -61,6 +61,25 @@ struct PNGStuff
     int         png_num_lace_passes;
     int         png_depth;
     int         dtbuffer_format;
+
+    /* Progressive loading state */
+    struct IClass       *cl;
+    Object              *o;
+    struct BitMapHeader *bmhd;
+    ULONG       max_size;       /* PDTA_ThumbnailSize, 0 = full size */
+    ULONG       scale_shift;    /* decode every (1 << scale_shift)th pixel */
+    ULONG       rowbytes;       /* bytes per decoded (full width) row */
+    ULONG       pixelbytes;
+    ULONG       out_width;
+    ULONG       out_height;
+    ULONG       out_rowbytes;
+    int         last_pass;      /* last Adam7 pass which needs decoding */
+    UBYTE       *buffer;        /* whole output image, interlaced only */
+    UBYTE       *strip;         /* rows waiting for PDTM_WRITEPIXELARRAY */
+    ULONG       strip_rows;
+    ULONG       strip_count;
+    ULONG       strip_top;
+    BOOL        done;
 };
 
 /**************************************************************************************************/
@@ -137,6 +156,21 @@ void my_flush_fn(png_structp png_ptr)
     }
 }
 
+/* Number of bytes fed to the progressive reader per Read() */
+#define PNG_READ_CHUNK      16384
+
+/* Rows are collected into strips of about this size before they are
+   passed to picture.datatype with a single PDTM_WRITEPIXELARRAY */
+#define PNG_STRIP_BYTES     65536
+
+/* Largest reduction (as a power of two) used for thumbnail decoding.
+   Adam7 pass 0 already holds every 8th pixel of every 8th row. */
+#define PNG_MAX_SCALE_SHIFT 3
+
+/* First column and column step of the pixels of each Adam7 pass */
+static const UBYTE adam7_xstart[7] = { 0, 4, 0, 2, 0, 1, 0 };
+static const UBYTE adam7_xinc[7]   = { 8, 8, 4, 4, 2, 2, 1 };
+
 /**************************************************************************************************/
 
 static void PNG_Exit(struct PNGStuff *png, LONG errorcode)
@@ -147,154 +181,139 @@ static void PNG_Exit(struct PNGStuff *png, LONG errorcode)
 
 /**************************************************************************************************/
 
-static BOOL LoadPNG(struct IClass *cl, Object *o)
+static void PNG_WriteStrip(struct PNGStuff *png, UBYTE *data, ULONG modulo, ULONG top, ULONG height)
 {
-    struct PNGStuff         png;
-    union {
-        struct IFFHandle    *iff;
-        BPTR                 bptr;
-    } filehandle;
-    struct BitMapHeader     *bmhd;
-    UBYTE                   *buffer = NULL;
-    IPTR                    sourcetype;
-    STRPTR                  name;
-    UBYTE                   fileheader[HEADER_CHECK_SIZE];
+    D(bug("[png.datatype] %s: rows %ld..%ld\n", __func__, top, top + height - 1));
 
-    D(bug("png.datatype/LoadPNG()\n"));
-
-    if( GetDTAttrs(o,   DTA_SourceType    , (IPTR)&sourcetype ,
-                        DTA_Handle        , (IPTR)&filehandle,
-                        PDTA_BitMapHeader , (IPTR)&bmhd,
-                        TAG_DONE) != 3 )
+    if(!DoSuperMethod(png->cl, png->o,
+                      PDTM_WRITEPIXELARRAY, /* Method_ID */
+                      (IPTR) data,          /* PixelData */
+                      png->dtbuffer_format, /* PixelFormat */
+                      modulo,               /* PixelArrayMod (number of bytes per row) */
+                      0,                    /* Left edge */
+                      top,                  /* Top edge */
+                      png->out_width,       /* Width */
+                      height))              /* Height */
     {
-        PNG_Exit(&png, ERROR_OBJECT_NOT_FOUND);
-        return FALSE;
+        png_error(png->png_ptr, "Out of memory!");
     }
+}
 
-    if ( sourcetype == DTST_RAM && filehandle.iff == NULL && bmhd )
-    {
-        D(bug("png.datatype/LoadPNG(): Creating an empty object\n"));
-        PNG_Exit(&png, 0);
-        return TRUE;
-    }
+/**************************************************************************************************/
 
-    if ( sourcetype != DTST_FILE || !filehandle.bptr || !bmhd )
-    {
-        D(bug("png.datatype/LoadPNG(): unsupported mode\n"));
-        PNG_Exit(&png, ERROR_NOT_IMPLEMENTED);
-        return FALSE;
-    }
+static void PNG_CopyRow(struct PNGStuff *png, UBYTE *dest, UBYTE *src)
+{
+    ULONG x;
 
-    if (Read(filehandle.bptr, fileheader, sizeof(fileheader)) != sizeof(fileheader))
+    if (png->scale_shift == 0)
     {
-        return FALSE;
+        CopyMem(src, dest, png->out_rowbytes);
+        return;
     }
 
-    if (png_sig_cmp(fileheader, 0, sizeof(fileheader)) != 0)
+    /* Nearest neighbour subsampling, good enough for thumbnails */
+    for (x = 0; x < png->out_width; x++)
     {
-        PNG_Exit(&png, ERROR_OBJECT_WRONG_TYPE);
-        return FALSE;
+        CopyMem(src + (x << png->scale_shift) * png->pixelbytes, dest, png->pixelbytes);
+        dest += png->pixelbytes;
     }
+}
 
-    memset(&png, 0, sizeof(png));
-
-    png.png_ptr = png_create_read_struct_2(PNG_LIBPNG_VER_STRING,
-                                           0,               /* error ptr */
-                                           my_error_fn,     /* error function */
-                                           my_warning_fn,   /* warning function */
-                                           0,               /* mem ptr */
-                                           my_malloc_fn,    /* malloc function */
-                                           my_free_fn       /* free function */
-                                           );
+/**************************************************************************************************/
 
-    if (!png.png_ptr)
+static void PNG_FlushStrip(struct PNGStuff *png)
+{
+    if (png->strip_count)
     {
-        D(bug("png.datatype/LoadPNG(): Can't create png read struct!"));
-        PNG_Exit(&png, ERROR_NO_FREE_STORE);
-        return FALSE;
+        PNG_WriteStrip(png, png->strip, png->out_rowbytes, png->strip_top, png->strip_count);
+        png->strip_top += png->strip_count;
+        png->strip_count = 0;
     }
+}
 
-    png.png_info_ptr = png_create_info_struct(png.png_ptr);
-    if (!png.png_info_ptr)
-    {
-        D(bug("png.datatype/LoadPNG():Can't create png info struct!\n"));
-        png_destroy_read_struct(&png.png_ptr, NULL, NULL);
-        PNG_Exit(&png, ERROR_NO_FREE_STORE);
-        return FALSE;
+/**************************************************************************************************/
 
-    }
+/* Put the pixels of an interlaced row which are part of the reduced
+   picture into their place. libpng has spread the pixels of the pass
+   over the full row, so only those of this pass are picked. */
+static void PNG_CombineRow(struct PNGStuff *png, UBYTE *dest, UBYTE *src, int pass)
+{
+    ULONG mask = (1 << png->scale_shift) - 1;
+    ULONG x;
 
-    png.png_end_info_ptr = png_create_info_struct(png.png_ptr);
-    if (!png.png_end_info_ptr)
+    for (x = adam7_xstart[pass]; x < png->png_width; x += adam7_xinc[pass])
     {
-        D(bug("png.datatype/LoadPNG():Can't create png end info struct!\n"));
-        png_destroy_read_struct(&png.png_ptr, &png.png_info_ptr, NULL);
-        PNG_Exit(&png, ERROR_NO_FREE_STORE);
-        return FALSE;
+        if ((x & mask) == 0)
+            CopyMem(src + x * png->pixelbytes,
+                    dest + (x >> png->scale_shift) * png->pixelbytes, png->pixelbytes);
     }
+}
 
-    png_set_read_fn(png.png_ptr, BADDR(filehandle.bptr), my_read_fn);
+/**************************************************************************************************/
 
-    png_set_sig_bytes(png.png_ptr, HEADER_CHECK_SIZE);
+/* Hand a completely decoded interlaced image over to picture.datatype */
+static void PNG_FlushImage(struct PNGStuff *png)
+{
+    PNG_WriteStrip(png, png->buffer, png->out_rowbytes, 0, png->out_height);
+}
 
-    if (setjmp(png_jmpbuf(png.png_ptr)))
-    {
-        D(bug("png.datatype/LoadPNG(): Error!\n"));
-        png_destroy_read_struct(&png.png_ptr, &png.png_info_ptr, &png.png_end_info_ptr);
-        FreeVec(buffer);
-        PNG_Exit(&png, ERROR_UNKNOWN);
-        return FALSE;
-    }
+/**************************************************************************************************/
+
+static void PNG_InfoCallback(png_structp png_ptr, png_infop info_ptr)
+{
+    struct PNGStuff         *png = png_get_progressive_ptr(png_ptr);
+    struct BitMapHeader     *bmhd = png->bmhd;
+    Object                  *o = png->o;
+    ULONG                   size;
 
-    png_read_info(png.png_ptr, png.png_info_ptr);
-    png_get_IHDR(png.png_ptr, png.png_info_ptr,
-                 &png.png_width, &png.png_height, &png.png_bits,
-                 &png.png_type, &png.png_lace, NULL, NULL);
+    png_get_IHDR(png_ptr, info_ptr,
+                 &png->png_width, &png->png_height, &png->png_bits,
+                 &png->png_type, &png->png_lace, NULL, NULL);
 
     D(
         bug("[png.datatype] %s: PNG IHDR: %ldx%ldx  (type:%d, lace:%d)\n", __func__,
-           png.png_width,
-           png.png_height,
-           png.png_type,
-           png.png_lace);
+           png->png_width,
+           png->png_height,
+           png->png_type,
+           png->png_lace);
         bug("[png.datatype] %s: PNG IHDR: %d bits per channel\n", __func__,
-           png.png_bits);
+           png->png_bits);
     )
 
-    if (png.png_bits == 16)
+    if (png->png_bits == 16)
     {
         D(bug("[png.datatype] %s: set_strip_16\n", __func__);)
-        png_set_strip_16(png.png_ptr);
+        png_set_strip_16(png_ptr);
     }
 
 #if defined(PNGDATATYPE_ALWAYS_ARGB)
-    if(png.png_type == PNG_COLOR_TYPE_PALETTE)
+    if(png->png_type == PNG_COLOR_TYPE_PALETTE)
     {
         D(bug("[png.datatype] %s: set_palette_to_rgb\n", __func__);)
-        png_set_palette_to_rgb(png.png_ptr);
-        png.png_type = PNG_COLOR_TYPE_RGB_ALPHA;
+        png_set_palette_to_rgb(png_ptr);
+        png->png_type = PNG_COLOR_TYPE_RGB_ALPHA;
     }
 #endif
 
-    if (png.png_bits < 8)
+    if (png->png_bits < 8)
     {
-        if (png.png_type == PNG_COLOR_TYPE_GRAY)
+        if (png->png_type == PNG_COLOR_TYPE_GRAY)
         {
             D(bug("[png.datatype] %s: set_expand_gray_1_2_4_to_8\n", __func__);)
-            png_set_expand_gray_1_2_4_to_8(png.png_ptr);
+            png_set_expand_gray_1_2_4_to_8(png_ptr);
         }
         else
         {
             D(bug("[png.datatype] %s: set_packing\n", __func__);)
-            png_set_packing(png.png_ptr);
+            png_set_packing(png_ptr);
         }
     }
 
-    if (png.png_type == PNG_COLOR_TYPE_PALETTE)
+    if (png->png_type == PNG_COLOR_TYPE_PALETTE)
     {
         png_bytep trans;
         int       num_trans;
-        if (png_get_tRNS(png.png_ptr, png.png_info_ptr, &trans, &num_trans, NULL))
+        if (png_get_tRNS(png_ptr, info_ptr, &trans, &num_trans, NULL))
         {
             if (num_trans > 1)
             {
@@ -309,19 +328,19 @@ static BOOL LoadPNG(struct IClass *cl, Object *o)
                     D(bug("[png.datatype] %s: converting palette with mixed-alpha to truecolor, nonopaque %d\n",
                         __func__, num_nonopaque));
 
-                    png_set_tRNS_to_alpha(png.png_ptr);
-                    png.png_type = PNG_COLOR_TYPE_RGB_ALPHA;
+                    png_set_tRNS_to_alpha(png_ptr);
+                    png->png_type = PNG_COLOR_TYPE_RGB_ALPHA;
                 }
             }
         }
     }
-    else if (png.png_type == PNG_COLOR_TYPE_RGB)
+    else if (png->png_type == PNG_COLOR_TYPE_RGB)
     {
-        if(png_get_valid(png.png_ptr, png.png_info_ptr, PNG_INFO_tRNS))
+        if(png_get_valid(png_ptr, info_ptr, PNG_INFO_tRNS))
         {
             D(bug("[png.datatype] %s: set_tRNS_to_alpha\n", __func__));
-            png_set_tRNS_to_alpha(png.png_ptr);
-            png.png_type = PNG_COLOR_TYPE_RGB_ALPHA;
+            png_set_tRNS_to_alpha(png_ptr);
+            png->png_type = PNG_COLOR_TYPE_RGB_ALPHA;
         }
     }
 
@@ -330,99 +349,121 @@ static BOOL LoadPNG(struct IClass *cl, Object *o)
      * as/to argb
      */
     if(
-        png.png_type == PNG_COLOR_TYPE_RGB
-        || png.png_type == PNG_COLOR_TYPE_GRAY
-        || png.png_type == PNG_COLOR_TYPE_PALETTE
+        png->png_type == PNG_COLOR_TYPE_RGB
+        || png->png_type == PNG_COLOR_TYPE_GRAY
+        || png->png_type == PNG_COLOR_TYPE_PALETTE
       )
     {
         D(bug("[png.datatype] %s: set_filler\n", __func__);)
-        png_set_filler(png.png_ptr, 0xFF, PNG_FILLER_AFTER);
+        png_set_filler(png_ptr, 0xFF, PNG_FILLER_AFTER);
     }
 #endif
 
     if(
 #if defined(PNGDATATYPE_ALWAYS_ARGB)
-        (png.png_type == PNG_COLOR_TYPE_GRAY) ||
+        (png->png_type == PNG_COLOR_TYPE_GRAY) ||
 #endif
-        (png.png_type == PNG_COLOR_TYPE_GRAY_ALPHA)
+        (png->png_type == PNG_COLOR_TYPE_GRAY_ALPHA)
       )
     {
         D(bug("[png.datatype] %s: set_gray_to_rgb\n", __func__);)
-        png_set_gray_to_rgb(png.png_ptr);
+        png_set_gray_to_rgb(png_ptr);
     }
 
     {
         double png_file_gamma;
         double png_screen_gamma = 2.2;
 
-        if (!(png_get_gAMA(png.png_ptr, png.png_info_ptr, &png_file_gamma)))
+        if (!(png_get_gAMA(png_ptr, info_ptr, &png_file_gamma)))
         {
             png_file_gamma = 0.45455;
         }
         D(bug("[png.datatype] %s: set_gamma\n", __func__);)
-        png_set_gamma(png.png_ptr, png_file_gamma, png_screen_gamma);
+        png_set_gamma(png_ptr, png_file_gamma, png_screen_gamma);
     }
 
-    png.png_num_lace_passes = png_set_interlace_handling(png.png_ptr);
+    png->png_num_lace_passes = png_set_interlace_handling(png_ptr);
 
-    switch(png.png_type)
+    switch(png->png_type)
     {
         case PNG_COLOR_TYPE_GRAY:
 #if !defined(PNGDATATYPE_ALWAYS_ARGB)
-            png.png_depth = 8;
-            png.dtbuffer_format = PBPAFMT_GREY8;
+            png->png_depth = 8;
+            png->dtbuffer_format = PBPAFMT_GREY8;
             break;
 #endif
         case PNG_COLOR_TYPE_PALETTE:
 #if !defined(PNGDATATYPE_ALWAYS_ARGB)
-            png.png_depth = 8;
-            png.dtbuffer_format = PBPAFMT_LUT8;
+            png->png_depth = 8;
+            png->dtbuffer_format = PBPAFMT_LUT8;
             break;
 #endif
         case PNG_COLOR_TYPE_RGB:
 #if !defined(PNGDATATYPE_ALWAYS_ARGB)
-            png.png_depth = 24;
-            png.dtbuffer_format = PBPAFMT_RGB;
+            png->png_depth = 24;
+            png->dtbuffer_format = PBPAFMT_RGB;
             break;
 #endif
         case PNG_COLOR_TYPE_GRAY_ALPHA:
         case PNG_COLOR_TYPE_RGB_ALPHA:
-            png.png_depth = 32;
+            png->png_depth = 32;
 #if defined(PBPAFMT_RGBA)
-            png.dtbuffer_format = PBPAFMT_RGBA;
+            png->dtbuffer_format = PBPAFMT_RGBA;
 #else
-            png.dtbuffer_format = PBPAFMT_ARGB;
-            png_set_swap_alpha(png.png_ptr);
+            png->dtbuffer_format = PBPAFMT_ARGB;
+            png_set_swap_alpha(png_ptr);
 #endif
 
             bmhd->bmh_Masking = mskHasAlpha;
             break;
 
         default:
-            png_error(png.png_ptr, "Unknown PNG Color Type!");
+            png_error(png_ptr, "Unknown PNG Color Type!");
             break;
     }
 
-    png_read_update_info(png.png_ptr, png.png_info_ptr);
+    /* Also does png_read_update_info() */
+    png_start_read_image(png_ptr);
 
     D(
-        bug("[png.datatype] %s: depth = %d\n", __func__, png.png_depth);
-        bug("[png.datatype] %s: channels = %d\n", __func__, png_get_channels(png.png_ptr, png.png_info_ptr));
+        bug("[png.datatype] %s: depth = %d\n", __func__, png->png_depth);
+        bug("[png.datatype] %s: channels = %d\n", __func__, png_get_channels(png_ptr, info_ptr));
     )
 
-    bmhd->bmh_Width = png.png_width;
-    bmhd->bmh_Height = png.png_height;
-    bmhd->bmh_Depth = png.png_depth;
+    /* Reduced resolution decoding, if the application only wants a thumbnail */
+    png->scale_shift = 0;
+    if (png->max_size)
+    {
+        size = (png->png_width > png->png_height) ? png->png_width : png->png_height;
+        while ((png->scale_shift < PNG_MAX_SCALE_SHIFT) &&
+               ((size >> (png->scale_shift + 1)) >= png->max_size))
+        {
+            png->scale_shift++;
+        }
+    }
+
+    png->rowbytes = png_get_rowbytes(png_ptr, info_ptr);
+    png->pixelbytes = png->rowbytes / png->png_width;
+    png->out_width = (png->png_width + (1 << png->scale_shift) - 1) >> png->scale_shift;
+    png->out_height = (png->png_height + (1 << png->scale_shift) - 1) >> png->scale_shift;
+    png->out_rowbytes = png->out_width * png->pixelbytes;
+
+    D(bug("[png.datatype] %s: decoding at %ldx%ld (shift %ld)\n", __func__,
+        png->out_width, png->out_height, png->scale_shift));
+
+    bmhd->bmh_Width = png->out_width;
+    bmhd->bmh_Height = png->out_height;
+    bmhd->bmh_Depth = png->png_depth;
 
     /* Mask? */
-    if (png.png_type == PNG_COLOR_TYPE_PALETTE)
+    if (png->png_type == PNG_COLOR_TYPE_PALETTE)
     {
         png_bytep trans;
         int       num_trans;
 
         D(bug("[png.datatype] %s: handling mask\n", __func__));
 
-        if (png_get_tRNS(png.png_ptr, png.png_info_ptr, &trans, &num_trans, NULL))
+        if (png_get_tRNS(png_ptr, info_ptr, &trans, &num_trans, NULL))
         {
             D(bug("[png.datatype] %s: %d trans @ 0x%p\n", __func__, num_trans, trans));
 
@@ -442,21 +483,21 @@ static BOOL LoadPNG(struct IClass *cl, Object *o)
     }
 
     /* Palette? */
-    if ((png.png_type == PNG_COLOR_TYPE_PALETTE) ||
-        (png.png_type == PNG_COLOR_TYPE_GRAY))
+    if ((png->png_type == PNG_COLOR_TYPE_PALETTE) ||
+        (png->png_type == PNG_COLOR_TYPE_GRAY))
     {
         struct ColorRegister    *colorregs = 0;
         ULONG                   *cregs = 0;
         png_colorp              col = 0;
-        int                     numcolors = 1L << png.png_depth;
+        int                     numcolors = 1L << png->png_depth;
 
         D(bug("[png.datatype] %s: reading palette\n", __func__);)
 
-        if (png.png_type == PNG_COLOR_TYPE_PALETTE)
+        if (png->png_type == PNG_COLOR_TYPE_PALETTE)
         {
-            if (!png_get_PLTE(png.png_ptr, png.png_info_ptr, &col, &numcolors))
+            if (!png_get_PLTE(png_ptr, info_ptr, &col, &numcolors))
             {
-                png_error(png.png_ptr, "PLTE chunk missing!");
+                png_error(png_ptr, "PLTE chunk missing!");
             }
         }
 
@@ -474,7 +515,7 @@ static BOOL LoadPNG(struct IClass *cl, Object *o)
 
             for(i = 0; i < numcolors; i++)
             {
-                if (png.png_type == PNG_COLOR_TYPE_PALETTE)
+                if (png->png_type == PNG_COLOR_TYPE_PALETTE)
                 {
                     colorregs->red   = col->red;
                     colorregs->green = col->green;
@@ -501,61 +542,213 @@ static BOOL LoadPNG(struct IClass *cl, Object *o)
 
     } /* if image needs palette */
 
+    /* Interlaced images are combined in a buffer of the output size. For
+       thumbnails only the Adam7 passes which contain every
+       (1 << scale_shift)th pixel of every (1 << scale_shift)th row are
+       decoded, the rest is skipped. */
+    if (png->png_lace != PNG_INTERLACE_NONE)
     {
-        ULONG buffersize, modulo, y;
-        UBYTE *buf;
+        static const UBYTE lastpass[PNG_MAX_SCALE_SHIFT + 1] = { 6, 4, 2, 0 };
 
-        buffersize = png_get_rowbytes(png.png_ptr, png.png_info_ptr);
-        if (png.png_lace == PNG_INTERLACE_NONE)
-        {
-            modulo = 0;
-        }
-        else
+        png->last_pass = lastpass[png->scale_shift];
+        png->buffer = AllocVec(png->out_rowbytes * png->out_height, MEMF_CLEAR);
+        if (!png->buffer) png_error(png_ptr, "Out of memory!");
+        return;
+    }
+
+    png->strip_rows = PNG_STRIP_BYTES / png->out_rowbytes;
+    if (png->strip_rows < 1) png->strip_rows = 1;
+    if (png->strip_rows > png->out_height) png->strip_rows = png->out_height;
+
+    png->strip = AllocVec(png->strip_rows * png->out_rowbytes, 0);
+    if (!png->strip) png_error(png_ptr, "Out of memory!");
+}
+
+/**************************************************************************************************/
+
+static void PNG_RowCallback(png_structp png_ptr, png_bytep new_row, png_uint_32 row_num, int pass)
+{
+    struct PNGStuff *png = png_get_progressive_ptr(png_ptr);
+
+    if (png->done)
+        return;
+
+    if (png->png_lace != PNG_INTERLACE_NONE)
+    {
+        if (pass > png->last_pass)
         {
-            modulo = buffersize; buffersize *= png.png_height;
+            /* All passes needed for the requested resolution are in */
+            PNG_FlushImage(png);
+            png->done = TRUE;
+            return;
         }
 
-        buffer = AllocVec(buffersize, 0);
-        if (!buffer) png_error(png.png_ptr, "Out of memory!");
+        /* NULL new_row means "row not part of this pass" */
+        if (png->scale_shift == 0)
+            png_progressive_combine_row(png_ptr, png->buffer + row_num * png->out_rowbytes, new_row);
+        else if ((new_row != NULL) && !(row_num & ((1 << png->scale_shift) - 1)))
+            PNG_CombineRow(png, png->buffer + (row_num >> png->scale_shift) * png->out_rowbytes,
+                           new_row, pass);
+        return;
+    }
 
-        while(png.png_num_lace_passes--)
-        {
-            for(y = 0, buf = buffer; y < png.png_height; y++, buf += modulo)
-            {
-                png_read_row(png.png_ptr, buf, NULL);
+    if ((new_row == NULL) || (row_num & ((1 << png->scale_shift) - 1)))
+        return;
 
-                if (png.png_num_lace_passes == 0)
-                {
-                    if(!DoSuperMethod(cl, o,
-                                      PDTM_WRITEPIXELARRAY, /* Method_ID */
-                                      (IPTR) buf,           /* PixelData */
-                                      png.dtbuffer_format,  /* PixelFormat */
-                                      0,                    /* PixelArrayMod (number of bytes per row) */
-                                      0,                    /* Left edge */
-                                      y,                    /* Top edge */
-                                      png.png_width,        /* Width */
-                                      1))                   /* Height (here: one line) */
-                    {
-                        png_error(png.png_ptr, "Out of memory!");
-                    }
+    PNG_CopyRow(png, png->strip + png->strip_count * png->out_rowbytes, new_row);
 
-                }
+    if ((++png->strip_count == png->strip_rows) ||
+        ((row_num >> png->scale_shift) == png->out_height - 1))
+    {
+        PNG_FlushStrip(png);
+    }
+}
+
+/**************************************************************************************************/
+
+static void PNG_EndCallback(png_structp png_ptr, png_infop info_ptr)
+{
+    struct PNGStuff *png = png_get_progressive_ptr(png_ptr);
+
+    if (png->done)
+        return;
+
+    if (png->png_lace != PNG_INTERLACE_NONE)
+        PNG_FlushImage(png);
+
+    png->done = TRUE;
+}
+
+/**************************************************************************************************/
+
+static BOOL LoadPNG(struct IClass *cl, Object *o, ULONG max_size)
+{
+    struct PNGStuff         png;
+    union {
+        struct IFFHandle    *iff;
+        BPTR                 bptr;
+    } filehandle;
+    struct BitMapHeader     *bmhd;
+    UBYTE                   *readbuf = NULL;
+    LONG                    readlen;
+    IPTR                    sourcetype;
+    STRPTR                  name;
+    UBYTE                   fileheader[HEADER_CHECK_SIZE];
+
+    D(bug("png.datatype/LoadPNG()\n"));
+
+    if( GetDTAttrs(o,   DTA_SourceType    , (IPTR)&sourcetype ,
+                        DTA_Handle        , (IPTR)&filehandle,
+                        PDTA_BitMapHeader , (IPTR)&bmhd,
+                        TAG_DONE) != 3 )
+    {
+        PNG_Exit(&png, ERROR_OBJECT_NOT_FOUND);
+        return FALSE;
+    }
+
+    if ( sourcetype == DTST_RAM && filehandle.iff == NULL && bmhd )
+    {
+        D(bug("png.datatype/LoadPNG(): Creating an empty object\n"));
+        PNG_Exit(&png, 0);
+        return TRUE;
+    }
+
+    if ( sourcetype != DTST_FILE || !filehandle.bptr || !bmhd )
+    {
+        D(bug("png.datatype/LoadPNG(): unsupported mode\n"));
+        PNG_Exit(&png, ERROR_NOT_IMPLEMENTED);
+        return FALSE;
+    }
+
+    if (Read(filehandle.bptr, fileheader, sizeof(fileheader)) != sizeof(fileheader))
+    {
+        return FALSE;
+    }
 
-            } /* for(y = 0, buf = buffer; y < png.png_height; y++, buf += modulo) */
+    if (png_sig_cmp(fileheader, 0, sizeof(fileheader)) != 0)
+    {
+        PNG_Exit(&png, ERROR_OBJECT_WRONG_TYPE);
+        return FALSE;
+    }
 
-        } /* while(png.png_num_lace_passes--) */
+    memset(&png, 0, sizeof(png));
+    png.cl = cl;
+    png.o = o;
+    png.bmhd = bmhd;
+    png.max_size = max_size;
 
-        FreeVec(buffer); buffer = NULL;
+    png.png_ptr = png_create_read_struct_2(PNG_LIBPNG_VER_STRING,
+                                           0,               /* error ptr */
+                                           my_error_fn,     /* error function */
+                                           my_warning_fn,   /* warning function */
+                                           0,               /* mem ptr */
+                                           my_malloc_fn,    /* malloc function */
+                                           my_free_fn       /* free function */
+                                           );
 
-    } /**/
+    if (!png.png_ptr)
+    {
+        D(bug("png.datatype/LoadPNG(): Can't create png read struct!"));
+        PNG_Exit(&png, ERROR_NO_FREE_STORE);
+        return FALSE;
+    }
 
-    png_read_end(png.png_ptr, png.png_end_info_ptr);
-    png_destroy_read_struct(&png.png_ptr, &png.png_info_ptr, &png.png_end_info_ptr);
+    png.png_info_ptr = png_create_info_struct(png.png_ptr);
+    if (!png.png_info_ptr)
+    {
+        D(bug("png.datatype/LoadPNG():Can't create png info struct!\n"));
+        png_destroy_read_struct(&png.png_ptr, NULL, NULL);
+        PNG_Exit(&png, ERROR_NO_FREE_STORE);
+        return FALSE;
+
+    }
+
+    readbuf = AllocVec(PNG_READ_CHUNK, 0);
+    if (!readbuf)
+    {
+        png_destroy_read_struct(&png.png_ptr, &png.png_info_ptr, NULL);
+        PNG_Exit(&png, ERROR_NO_FREE_STORE);
+        return FALSE;
+    }
+
+    /* Use libpng's progressive reader: the data is pushed to it in
+       PNG_READ_CHUNK sized blocks and decoded rows are delivered to
+       PNG_RowCallback(), which batches them into strips */
+    png_set_progressive_read_fn(png.png_ptr, &png,
+                                PNG_InfoCallback, PNG_RowCallback, PNG_EndCallback);
+
+    png_set_sig_bytes(png.png_ptr, HEADER_CHECK_SIZE);
+
+    if (setjmp(png_jmpbuf(png.png_ptr)))
+    {
+        D(bug("png.datatype/LoadPNG(): Error!\n"));
+        png_destroy_read_struct(&png.png_ptr, &png.png_info_ptr, NULL);
+        FreeVec(png.strip);
+        FreeVec(png.buffer);
+        FreeVec(readbuf);
+        PNG_Exit(&png, ERROR_UNKNOWN);
+        return FALSE;
+    }
+
+    while (!png.done)
+    {
+        readlen = Read(filehandle.bptr, readbuf, PNG_READ_CHUNK);
+        if (readlen <= 0)
+        {
+            png_error(png.png_ptr, "Read error!");
+        }
+        png_process_data(png.png_ptr, png.png_info_ptr, readbuf, readlen);
+    }
+
+    png_destroy_read_struct(&png.png_ptr, &png.png_info_ptr, NULL);
+    FreeVec(png.strip);
+    FreeVec(png.buffer);
+    FreeVec(readbuf);
 
     /* Pass picture size to picture.datatype */
     GetDTAttrs( o, DTA_Name, (IPTR) &name, TAG_DONE );
-    SetDTAttrs(o, NULL, NULL, DTA_NominalHoriz,        png.png_width,
-                              DTA_NominalVert ,        png.png_height,
+    SetDTAttrs(o, NULL, NULL, DTA_NominalHoriz,        png.out_width,
+                              DTA_NominalVert ,        png.out_height,
                               DTA_ObjName     , (IPTR) name,
                               TAG_DONE);
 
@@ -745,7 +938,9 @@ IPTR PNG__OM_NEW(struct IClass *cl, Object *o, Msg msg)
     IPTR retval = DoSuperMethodA(cl, o, (Msg)msg);
     if (retval != (IPTR)0)
     {
-        if (!LoadPNG(cl, (Object *)retval))
+        ULONG max_size = GetTagData(PDTA_ThumbnailSize, 0, ((struct opSet *)msg)->ops_AttrList);
+
+        if (!LoadPNG(cl, (Object *)retval, max_size))
         {
             CoerceMethod(cl, (Object *)retval, OM_DISPOSE);
             return (IPTR)0;
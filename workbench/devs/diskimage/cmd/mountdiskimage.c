@@ -57,7 +57,8 @@ CONST TEXT USED verstag[] = VERSTAG;
 
 #define PROGNAME "MountDiskImage"
 #define TEMPLATE "D=DEVICE=DRIVE/K,U=UNIT/K/N,INSERT=FILE,EJECT/S," \
-	"P=PLUGIN/K,WP=WRITEPROTECT/S,PWD=PASSWORD/K,RELOADPLUGINS/S"
+	"P=PLUGIN/K,WP=WRITEPROTECT/S,PWD=PASSWORD/K,RELOADPLUGINS/S," \
+	"OVL=OVERLAY/K,COMMIT/S,DISCARD/S"
 
 enum {
 	ARG_DRIVE,
@@ -68,6 +69,9 @@ enum {
 	ARG_WRITEPROTECT,
 	ARG_PASSWORD,
 	ARG_RELOADPLUGINS,
+	ARG_OVERLAY,
+	ARG_COMMIT,
+	ARG_DISCARD,
 	MAX_ARGS
 };
 
@@ -94,8 +98,10 @@ int main (int argc, char **argv) {
 	BOOL writeprotect = FALSE;
 	CONST_STRPTR password = NULL;
 	CONST_STRPTR plugin = NULL;
+	CONST_STRPTR overlay = NULL;
 	BOOL eject = FALSE;
 	BOOL reloadplugins = FALSE;
+	ULONG overlay_cmd = TAG_IGNORE;
 	LONG error = NO_ERROR;
 	LONG error2 = NO_ERROR;
 	TEXT error_buffer[256];
@@ -139,6 +145,11 @@ int main (int argc, char **argv) {
 			password = NULL;
 		}
 		plugin = TTString(icon, "PLUGIN", NULL);
+		if (!(overlay = TTString(icon, "OVL", NULL)) &&
+			!(overlay = TTString(icon, "OVERLAY", NULL)))
+		{
+			overlay = NULL;
+		}
 	} else {
 		IPTR args[MAX_ARGS];
 		ClearMem(args, sizeof(args));
@@ -151,14 +162,24 @@ int main (int argc, char **argv) {
 		filename = (CONST_STRPTR)args[ARG_INSERT];
 		eject = args[ARG_EJECT] ? TRUE : FALSE;
 		reloadplugins = args[ARG_RELOADPLUGINS] ? TRUE : FALSE;
+		if (args[ARG_COMMIT] && args[ARG_DISCARD]) {
+			PrintFault(ERROR_TOO_MANY_ARGS, PROGNAME);
+			goto error;
+		}
+		if (args[ARG_COMMIT]) overlay_cmd = DITAG_CommitOverlay;
+		if (args[ARG_DISCARD]) overlay_cmd = DITAG_DiscardOverlay;
 		if (reloadplugins) {
 			unit = -1;
+		} else if (overlay_cmd != TAG_IGNORE) {
+			if (args[ARG_DRIVE]) drivestr = (CONST_STRPTR)args[ARG_DRIVE];
+			if (args[ARG_UNIT]) unit = *(LONG *)args[ARG_UNIT];
 		} else if (filename || eject) {
 			if (args[ARG_DRIVE]) drivestr = (CONST_STRPTR)args[ARG_DRIVE];
 			if (args[ARG_UNIT]) unit = *(LONG *)args[ARG_UNIT];
 			if (filename) {
 				if (args[ARG_PASSWORD]) password = (CONST_STRPTR)args[ARG_PASSWORD];
 				if (args[ARG_PLUGIN]) plugin = (CONST_STRPTR)args[ARG_PLUGIN];
+				if (args[ARG_OVERLAY]) overlay = (CONST_STRPTR)args[ARG_OVERLAY];
 				writeprotect = args[ARG_WRITEPROTECT] ? TRUE : FALSE;
 			}
 		} else {
@@ -223,7 +244,7 @@ int main (int argc, char **argv) {
 		}
 	}
 
-	if ((filename || eject) && unit == -1) {
+	if ((filename || eject || overlay_cmd != TAG_IGNORE) && unit == -1) {
 		if (WBMsg)
 			IoErrRequester(ERROR_REQUIRED_ARG_MISSING, NULL);
 		else
@@ -247,6 +268,22 @@ int main (int argc, char **argv) {
 			PrintFault(error, PROGNAME);
 			goto error;
 		}
+	} else if (overlay_cmd != TAG_IGNORE) {
+		error_buffer[0] = 0;
+		error = UnitControl(unit,
+			DITAG_Error,				(IPTR)&error2,
+			DITAG_ErrorString,			(IPTR)error_buffer,
+			DITAG_ErrorStringLength,	sizeof(error_buffer),
+			overlay_cmd,				TRUE,
+			TAG_END);
+		if (error == NO_ERROR) error = error2;
+		if (error_buffer[0]) {
+			FPrintf(stderr, "%s: %s\n", PROGNAME, error_buffer);
+			goto error;
+		} else if (error) {
+			PrintFault(error, PROGNAME);
+			goto error;
+		}
 	} else if (filename || eject) {
 		error_buffer[0] = 0;
 		if (filename) {
@@ -265,6 +302,7 @@ int main (int argc, char **argv) {
 				DITAG_Password,				(IPTR)password,
 				DITAG_Plugin,				(IPTR)plugin,
 				DITAG_CurrentDir,			(IPTR)filedir,
+				DITAG_Overlay,				(IPTR)overlay,
 				DITAG_Filename,				(IPTR)filename,
 				DITAG_WriteProtect,			writeprotect,
 				TAG_END);
@@ -0,0 +1,230 @@
+/* Copyright 2026 The AROS Development Team. All rights reserved.
+**
+** Redistribution and use in source and binary forms, with or without
+** modification, are permitted provided that the following conditions
+** are met:
+**
+** 1. Redistributions of source code must retain the above copyright
+**    notice, this list of conditions and the following disclaimer.
+**
+** 2. Redistributions in binary form must reproduce the above copyright
+**    notice, this list of conditions and the following disclaimer in the
+**    documentation and/or other materials provided with the distribution.
+**
+** THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS `AS IS'
+** AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+** IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+** ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+** LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+** CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+** SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+** INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+** CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+** ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+** POSSIBILITY OF SUCH DAMAGE.
+*/
+
+/*
+** Compress a raw disk image (ADF, HDF, ISO...) into the zstd seekable
+** format read by the ZST plugin. Every FRAMESIZE bytes of the image become
+** an independent zstd frame, and a seek table listing the frame sizes is
+** appended as a skippable frame, so the image can still be read with any
+** zstd decompressor.
+*/
+
+#include <exec/exec.h>
+#include <dos/dos.h>
+#include <devices/diskimage.h>
+#include <proto/exec.h>
+#include <proto/dos.h>
+#include <proto/zstd.h>
+#include <string.h>
+#include "endian.h"
+#include "support.h"
+#include "rev/ZSTImage_rev.h"
+
+CONST TEXT USED verstag[] = VERSTAG;
+
+#define PROGNAME "ZSTImage"
+#define TEMPLATE "FROM/A,TO/A,FRAMESIZE/K/N,LEVEL/K/N"
+
+enum {
+	ARG_FROM,
+	ARG_TO,
+	ARG_FRAMESIZE,
+	ARG_LEVEL,
+	MAX_ARGS
+};
+
+#define SKIPPABLE_MAGIC		0x184D2A5E
+#define SEEKABLE_MAGIC		0x8F92EAB1
+#define DEFAULT_FRAMESIZE	65536
+#define MIN_FRAMESIZE		512
+#define MAX_FRAMESIZE		(1UL << 20)
+#define DEFAULT_LEVEL		19
+
+static BOOL WriteLE32 (BPTR file, ULONG value) {
+	ULONG le;
+	wle32(&le, value);
+	return Write(file, &le, sizeof(le)) == sizeof(le);
+}
+
+int main (int argc, char **argv) {
+	int rc = RETURN_FAIL;
+	BPTR stderr = Output();
+	struct RDArgs *rdargs = NULL;
+	IPTR args[MAX_ARGS];
+	BPTR in = ZERO, out = ZERO;
+	ULONG frame_size = DEFAULT_FRAMESIZE;
+	LONG level = DEFAULT_LEVEL;
+	UBYTE *in_buf = NULL, *out_buf = NULL;
+	ULONG *table = NULL;
+	ULONG table_len = 0, table_max = 0;
+	size_t out_max;
+	ZSTD_CCtx *cctx = NULL;
+	UQUAD total_in = 0, total_out = 0;
+	LONG error = NO_ERROR;
+	LONG len;
+	UBYTE descriptor = 0;
+	ULONG i;
+
+	ClearMem(args, sizeof(args));
+	rdargs = ReadArgs(TEMPLATE, args, NULL);
+	if (!rdargs) {
+		PrintFault(IoErr(), PROGNAME);
+		goto error;
+	}
+	if (args[ARG_FRAMESIZE]) frame_size = *(LONG *)args[ARG_FRAMESIZE];
+	if (args[ARG_LEVEL]) level = *(LONG *)args[ARG_LEVEL];
+
+	/* The ZST plugin needs whole sectors per frame */
+	if (frame_size < MIN_FRAMESIZE || frame_size > MAX_FRAMESIZE || (frame_size % MIN_FRAMESIZE)) {
+		FPrintf(stderr, "%s: FRAMESIZE must be a multiple of %lu up to %lu\n", PROGNAME,
+			MIN_FRAMESIZE, MAX_FRAMESIZE);
+		goto error;
+	}
+	if (level < ZSTD_minCLevel()) level = ZSTD_minCLevel();
+	if (level > ZSTD_maxCLevel()) level = ZSTD_maxCLevel();
+
+	in = Open((CONST_STRPTR)args[ARG_FROM], MODE_OLDFILE);
+	if (!in) {
+		error = IoErr();
+		PrintFault(error, (CONST_STRPTR)args[ARG_FROM]);
+		goto error;
+	}
+	out = Open((CONST_STRPTR)args[ARG_TO], MODE_NEWFILE);
+	if (!out) {
+		error = IoErr();
+		PrintFault(error, (CONST_STRPTR)args[ARG_TO]);
+		goto error;
+	}
+
+	out_max = ZSTD_compressBound(frame_size);
+	in_buf = AllocVec(frame_size, MEMF_ANY);
+	out_buf = AllocVec(out_max, MEMF_ANY);
+	cctx = ZSTD_createCCtx();
+	if (!in_buf || !out_buf || !cctx) {
+		error = ERROR_NO_FREE_STORE;
+		PrintFault(error, PROGNAME);
+		goto error;
+	}
+
+	for (;;) {
+		size_t csize;
+
+		if (CheckSignal(SIGBREAKF_CTRL_C)) {
+			error = ERROR_BREAK;
+			PrintFault(error, PROGNAME);
+			goto error;
+		}
+
+		len = Read(in, in_buf, frame_size);
+		if (len == -1) {
+			error = IoErr();
+			PrintFault(error, (CONST_STRPTR)args[ARG_FROM]);
+			goto error;
+		}
+		if (len == 0) break;
+
+		csize = ZSTD_compressCCtx(cctx, out_buf, out_max, in_buf, len, level);
+		if (ZSTD_isError(csize)) {
+			FPrintf(stderr, "%s: %s\n", PROGNAME, ZSTD_getErrorName(csize));
+			goto error;
+		}
+		if (Write(out, out_buf, csize) != csize) {
+			error = IoErr();
+			PrintFault(error, (CONST_STRPTR)args[ARG_TO]);
+			goto error;
+		}
+
+		if (table_len == table_max) {
+			ULONG *new_table;
+			table_max = table_max ? table_max << 1 : 256;
+			new_table = AllocVec(table_max * 2 * sizeof(ULONG), MEMF_ANY);
+			if (!new_table) {
+				error = ERROR_NO_FREE_STORE;
+				PrintFault(error, PROGNAME);
+				goto error;
+			}
+			if (table) CopyMem(table, new_table, table_len * 2 * sizeof(ULONG));
+			FreeVec(table);
+			table = new_table;
+		}
+		table[table_len * 2] = csize;
+		table[table_len * 2 + 1] = len;
+		table_len++;
+
+		total_in += len;
+		total_out += csize;
+
+		/* Only the last frame may be short */
+		if ((ULONG)len != frame_size) break;
+	}
+
+	if (table_len == 0) {
+		PrintFault(ERROR_OBJECT_WRONG_TYPE, (CONST_STRPTR)args[ARG_FROM]);
+		goto error;
+	}
+
+	/* Seek table: skippable frame header, entries and footer */
+	if (!WriteLE32(out, SKIPPABLE_MAGIC) ||
+		!WriteLE32(out, table_len * 8 + 9))
+	{
+		goto write_error;
+	}
+	for (i = 0; i < table_len * 2; i++) {
+		wle32(&table[i], table[i]);
+	}
+	if (Write(out, table, table_len * 8) != table_len * 8) {
+		goto write_error;
+	}
+	if (!WriteLE32(out, table_len) ||
+		Write(out, &descriptor, 1) != 1 ||
+		!WriteLE32(out, SEEKABLE_MAGIC))
+	{
+		goto write_error;
+	}
+
+	Printf("%s: %lu frames, %lu KB -> %lu KB\n", PROGNAME, table_len,
+		(ULONG)(total_in >> 10), (ULONG)(total_out >> 10));
+
+	rc = RETURN_OK;
+	goto error;
+
+write_error:
+	error = IoErr();
+	PrintFault(error, (CONST_STRPTR)args[ARG_TO]);
+
+error:
+	if (cctx) ZSTD_freeCCtx(cctx);
+	FreeVec(table);
+	FreeVec(out_buf);
+	FreeVec(in_buf);
+	if (out) {
+		Close(out);
+		if (rc != RETURN_OK) DeleteFile((CONST_STRPTR)args[ARG_TO]);
+	}
+	if (in) Close(in);
+	if (rdargs) FreeArgs(rdargs);
+	return rc;
+}
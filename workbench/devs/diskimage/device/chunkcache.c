@@ -0,0 +1,278 @@
+/* Copyright 2026 The AROS Development Team. All rights reserved.
+**
+** Redistribution and use in source and binary forms, with or without
+** modification, are permitted provided that the following conditions
+** are met:
+**
+** 1. Redistributions of source code must retain the above copyright
+**    notice, this list of conditions and the following disclaimer.
+**
+** 2. Redistributions in binary form must reproduce the above copyright
+**    notice, this list of conditions and the following disclaimer in the
+**    documentation and/or other materials provided with the distribution.
+**
+** THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS `AS IS'
+** AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+** IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+** ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+** LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+** CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+** SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+** INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+** CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+** ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+** POSSIBILITY OF SUCH DAMAGE.
+*/
+
+/*
+** LRU cache of decoded chunks for plugins of compressed image formats.
+**
+** A plugin describes its image as a row of equally sized chunks (the
+** last one may be short) and supplies a function that decodes one of
+** them. Reads are served from the cache, so metadata that the filesystem
+** reads over and over is only decoded once. A miss directly after the
+** previously read chunk is taken as sequential access and also decodes
+** the chunks following it, doubling the read-ahead window on every such
+** miss up to the unit's "ReadAhead" setting. Any other miss resets it.
+**
+** Everything runs on the unit process, so no locking is needed.
+*/
+
+#include "diskimage_device.h"
+
+#define CACHE_DEFAULT_KB	1024
+#define CACHE_MIN_ENTRIES	4
+#define READAHEAD_DEFAULT	8
+#define INVALID_CHUNK		(~(UQUAD)0)
+
+struct ChunkCacheEntry {
+	struct MinNode Node;
+	struct ChunkCacheEntry *HashNext;
+	UQUAD Chunk;
+	UBYTE *Data;
+};
+
+struct ChunkCache {
+	struct Library *SysBase;
+	APTR Image;
+	DIReadChunkFunc ReadChunk;
+	ULONG ChunkSize;
+	UQUAD TotalBytes;
+	UQUAD TotalChunks;
+	ULONG NumEntries;
+	ULONG HashMask;
+	struct ChunkCacheEntry **Hash;
+	struct MinList LRU;
+	UBYTE *Buffer;
+	UQUAD NextChunk;
+	ULONG Window;
+	ULONG MaxWindow;
+	ULONG Hits;
+	ULONG Misses;
+	ULONG Prefetched;
+	struct ChunkCacheEntry Entries[];
+};
+
+static inline ULONG HashChunk (struct ChunkCache *cache, UQUAD chunk) {
+	return ((ULONG)chunk ^ (ULONG)(chunk >> 32)) & cache->HashMask;
+}
+
+static inline ULONG ChunkLength (struct ChunkCache *cache, UQUAD chunk) {
+	UQUAD start = chunk * cache->ChunkSize;
+	return min(cache->TotalBytes - start, (UQUAD)cache->ChunkSize);
+}
+
+static struct ChunkCacheEntry *FindEntry (struct ChunkCache *cache, UQUAD chunk) {
+	struct ChunkCacheEntry *entry;
+	for (entry = cache->Hash[HashChunk(cache, chunk)]; entry; entry = entry->HashNext) {
+		if (entry->Chunk == chunk) break;
+	}
+	return entry;
+}
+
+static void UnhashEntry (struct ChunkCache *cache, struct ChunkCacheEntry *entry) {
+	struct ChunkCacheEntry **ptr;
+	if (entry->Chunk == INVALID_CHUNK) return;
+	for (ptr = &cache->Hash[HashChunk(cache, entry->Chunk)]; *ptr; ptr = &(*ptr)->HashNext) {
+		if (*ptr == entry) {
+			*ptr = entry->HashNext;
+			break;
+		}
+	}
+	entry->Chunk = INVALID_CHUNK;
+}
+
+static inline void TouchEntry (struct ChunkCache *cache, struct ChunkCacheEntry *entry) {
+	struct Library *SysBase = cache->SysBase;
+	Remove((struct Node *)entry);
+	AddHead((struct List *)&cache->LRU, (struct Node *)entry);
+}
+
+/* Decode a chunk into the least recently used entry */
+static LONG LoadEntry (struct ChunkCache *cache, UQUAD chunk, struct ChunkCacheEntry **result) {
+	struct Library *SysBase = cache->SysBase;
+	struct ChunkCacheEntry *entry;
+	ULONG slot;
+	LONG error;
+
+	entry = (struct ChunkCacheEntry *)cache->LRU.mlh_TailPred;
+	UnhashEntry(cache, entry);
+
+	error = cache->ReadChunk(cache->Image, chunk, entry->Data, ChunkLength(cache, chunk));
+	if (error != IOERR_SUCCESS) {
+		/* Leave it at the tail for the next load */
+		return error;
+	}
+
+	entry->Chunk = chunk;
+	slot = HashChunk(cache, chunk);
+	entry->HashNext = cache->Hash[slot];
+	cache->Hash[slot] = entry;
+	Remove((struct Node *)entry);
+	AddHead((struct List *)&cache->LRU, (struct Node *)entry);
+
+	*result = entry;
+	return IOERR_SUCCESS;
+}
+
+static LONG GetEntry (struct ChunkCache *cache, UQUAD chunk, struct ChunkCacheEntry **result) {
+	struct ChunkCacheEntry *entry, *ra_entry;
+	BOOL sequential;
+	ULONG i;
+	LONG error;
+
+	sequential = (chunk == cache->NextChunk);
+	cache->NextChunk = chunk + 1;
+
+	entry = FindEntry(cache, chunk);
+	if (entry) {
+		cache->Hits++;
+		TouchEntry(cache, entry);
+		*result = entry;
+		return IOERR_SUCCESS;
+	}
+
+	cache->Misses++;
+	error = LoadEntry(cache, chunk, &entry);
+	if (error != IOERR_SUCCESS) {
+		cache->Window = 0;
+		return error;
+	}
+
+	if (sequential && cache->MaxWindow) {
+		cache->Window = cache->Window ? min(cache->Window << 1, cache->MaxWindow) : 1;
+		for (i = 1; i <= cache->Window && chunk + i < cache->TotalChunks; i++) {
+			if (FindEntry(cache, chunk + i)) continue;
+			if (LoadEntry(cache, chunk + i, &ra_entry) != IOERR_SUCCESS) break;
+			cache->Prefetched++;
+		}
+		/* The window is at most half the cache, so entry is still valid */
+		TouchEntry(cache, entry);
+	} else {
+		cache->Window = 0;
+	}
+
+	*result = entry;
+	return IOERR_SUCCESS;
+}
+
+APTR CreateChunkCache (APTR Self, struct DiskImageUnit *unit, APTR image, ULONG chunk_size,
+	UQUAD total_bytes, DIReadChunkFunc read_chunk)
+{
+	struct DiskImageBase *libBase = unit->LibBase;
+	struct Library *SysBase = libBase->SysBase;
+	struct ChunkCache *cache;
+	ULONG num_entries, hash_size, i;
+	LONG cache_kb, readahead;
+
+	if (chunk_size == 0 || total_bytes == 0) return NULL;
+
+	cache_kb = DictGetIntegerForKey(unit->Prefs, "ChunkCacheSize", CACHE_DEFAULT_KB);
+	readahead = DictGetIntegerForKey(unit->Prefs, "ReadAhead", READAHEAD_DEFAULT);
+
+	num_entries = ((UQUAD)max(cache_kb, 0) << 10) / chunk_size;
+	num_entries = max(num_entries, CACHE_MIN_ENTRIES);
+	for (hash_size = 1; hash_size < num_entries; hash_size <<= 1);
+
+	cache = AllocVec(sizeof(*cache) + num_entries * sizeof(struct ChunkCacheEntry), MEMF_CLEAR);
+	if (!cache) return NULL;
+
+	cache->SysBase = SysBase;
+	cache->Image = image;
+	cache->ReadChunk = read_chunk;
+	cache->ChunkSize = chunk_size;
+	cache->TotalBytes = total_bytes;
+	cache->TotalChunks = (total_bytes + chunk_size - 1) / chunk_size;
+	cache->NumEntries = num_entries;
+	cache->HashMask = hash_size - 1;
+	cache->NextChunk = INVALID_CHUNK;
+	cache->MaxWindow = min((ULONG)max(readahead, 0), num_entries >> 1);
+
+	cache->Hash = AllocVec(hash_size * sizeof(struct ChunkCacheEntry *), MEMF_CLEAR);
+	cache->Buffer = AllocVec(num_entries * chunk_size, MEMF_ANY);
+	if (!cache->Hash || !cache->Buffer) {
+		DeleteChunkCache(Self, cache);
+		return NULL;
+	}
+
+	NewList((struct List *)&cache->LRU);
+	for (i = 0; i < num_entries; i++) {
+		struct ChunkCacheEntry *entry = &cache->Entries[i];
+		entry->Chunk = INVALID_CHUNK;
+		entry->Data = cache->Buffer + i * chunk_size;
+		AddTail((struct List *)&cache->LRU, (struct Node *)entry);
+	}
+
+	dbug(("CreateChunkCache: %lu entries of %lu bytes, read-ahead %lu\n",
+		num_entries, chunk_size, cache->MaxWindow));
+
+	return cache;
+}
+
+void DeleteChunkCache (APTR Self, APTR cache_ptr) {
+	struct ChunkCache *cache = cache_ptr;
+	if (cache) {
+		struct Library *SysBase = cache->SysBase;
+		dbug(("DeleteChunkCache: %lu hits, %lu misses, %lu prefetched\n",
+			cache->Hits, cache->Misses, cache->Prefetched));
+		FreeVec(cache->Buffer);
+		FreeVec(cache->Hash);
+		FreeVec(cache);
+	}
+}
+
+LONG ReadChunkCache (APTR Self, APTR cache_ptr, UQUAD offset, APTR buffer, ULONG length,
+	ULONG *actual)
+{
+	struct ChunkCache *cache = cache_ptr;
+	struct Library *SysBase = cache->SysBase;
+	struct ChunkCacheEntry *entry;
+	UBYTE *dst = buffer;
+	UQUAD chunk;
+	ULONG skip, to_copy;
+	LONG error = IOERR_SUCCESS;
+
+	*actual = 0;
+	if (offset >= cache->TotalBytes) return IOERR_BADADDRESS;
+	if (length > cache->TotalBytes - offset) {
+		length = cache->TotalBytes - offset;
+		error = IOERR_BADLENGTH;
+	}
+
+	chunk = offset / cache->ChunkSize;
+	skip = offset % cache->ChunkSize;
+	while (length) {
+		LONG status = GetEntry(cache, chunk, &entry);
+		if (status != IOERR_SUCCESS) return status;
+
+		to_copy = min(length, ChunkLength(cache, chunk) - skip);
+		CopyMem(entry->Data + skip, dst, to_copy);
+
+		dst += to_copy;
+		*actual += to_copy;
+		length -= to_copy;
+		skip = 0;
+		chunk++;
+	}
+	return error;
+}
@@ -121,6 +121,9 @@ struct DiskImageUnit {
 	struct DiskImagePlugin *Plugin;
 	APTR ImageData;
 
+	APTR Overlay;
+	STRPTR OverlayName;
+
 	BPTR TempDir;
 	STRPTR TempName;
 
@@ -205,4 +208,20 @@ void RemoveTempFile (APTR Self, struct DiskImageUnit *unit);
 /* password.c */
 STRPTR RequestPassword (APTR Self, struct DiskImageUnit *unit);
 
+/* chunkcache.c */
+APTR CreateChunkCache (APTR Self, struct DiskImageUnit *unit, APTR image, ULONG chunk_size,
+	UQUAD total_bytes, DIReadChunkFunc read_chunk);
+void DeleteChunkCache (APTR Self, APTR cache);
+LONG ReadChunkCache (APTR Self, APTR cache, UQUAD offset, APTR buffer, ULONG length,
+	ULONG *actual);
+
+/* overlay.c */
+LONG OpenOverlay (APTR Self, struct DiskImageUnit *unit, BPTR dir, CONST_STRPTR filename,
+	STRPTR fullpath, ULONG fullpath_size);
+void CloseOverlay (APTR Self, struct DiskImageUnit *unit);
+LONG OverlayRead (APTR Self, struct DiskImageUnit *unit, struct IOStdReq *io);
+LONG OverlayWrite (APTR Self, struct DiskImageUnit *unit, struct IOStdReq *io);
+LONG CommitOverlay (APTR Self, struct DiskImageUnit *unit);
+LONG DiscardOverlay (APTR Self, struct DiskImageUnit *unit);
+
 #endif
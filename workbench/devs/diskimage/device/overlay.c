@@ -0,0 +1,439 @@
+/* Copyright 2026 The AROS Development Team. All rights reserved.
+**
+** Redistribution and use in source and binary forms, with or without
+** modification, are permitted provided that the following conditions
+** are met:
+**
+** 1. Redistributions of source code must retain the above copyright
+**    notice, this list of conditions and the following disclaimer.
+**
+** 2. Redistributions in binary form must reproduce the above copyright
+**    notice, this list of conditions and the following disclaimer in the
+**    documentation and/or other materials provided with the distribution.
+**
+** THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS `AS IS'
+** AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+** IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+** ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+** LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+** CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+** SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+** INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+** CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+** ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+** POSSIBILITY OF SUCH DAMAGE.
+*/
+
+
+/*
+** Copy-on-write overlays.
+**
+** With an overlay attached, writes to a unit go to a delta file instead
+** of the disk image, and reads of blocks that were never written fall
+** through to the image. The image is only read, so any plugin format can
+** be used as the base, and many units can share one base image.
+**
+** The overlay file starts with a header, followed by a block map with one
+** big endian ULONG per block of the image. A zero entry means the block
+** is not in the overlay, otherwise it is the 1-based number of the slot
+** holding the block data. Slots are allocated at the end of the file as
+** blocks are first written, so the file only grows with the amount of
+** data changed. New block data is written before its map entry, so an
+** interrupted write at worst leaves an unused slot behind.
+*/
+
+#include "diskimage_device.h"
+#include "endian.h"
+
+#define OVERLAY_MAGIC		MAKE_ID('D','I','O','V')
+#define OVERLAY_VERSION		1
+#define OVERLAY_BLOCKSIZE	4096
+#define OVERLAY_MAPOFFSET	512
+
+struct OverlayHeader {
+	ULONG Magic;
+	ULONG Version;
+	ULONG BlockSize;
+	ULONG NumBlocks;
+	ULONG TotalBytesHi;
+	ULONG TotalBytesLo;
+	ULONG MapOffset;
+	ULONG Reserved;
+};
+
+struct DiskImageOverlay {
+	BPTR File;
+	ULONG BlockSize;
+	ULONG NumBlocks;
+	UQUAD TotalBytes;
+	UQUAD DataOffset;
+	ULONG NextSlot;
+	ULONG *Map;
+	UBYTE *Buffer;
+	LONG IoErr;
+};
+
+static inline ULONG BlockLength (struct DiskImageOverlay *ov, ULONG block) {
+	UQUAD start = (UQUAD)block * ov->BlockSize;
+	return min(ov->TotalBytes - start, (UQUAD)ov->BlockSize);
+}
+
+static inline UQUAD SlotOffset (struct DiskImageOverlay *ov, ULONG slot) {
+	return ov->DataOffset + (UQUAD)(slot - 1) * ov->BlockSize;
+}
+
+static LONG OverlayFileIO (struct DiskImageUnit *unit, UQUAD offset, APTR buffer, LONG size,
+	BOOL write)
+{
+	struct Library *DOSBase = unit->LibBase->DOSBase;
+	struct DiskImageOverlay *ov = unit->Overlay;
+	UBYTE *ptr = buffer;
+	LONG len;
+
+	if (!ChangeFilePosition(ov->File, offset, OFFSET_BEGINNING)) {
+		ov->IoErr = ERROR_SEEK_ERROR;
+		return TDERR_SeekError;
+	}
+	while (size) {
+		if (write)
+			len = Write(ov->File, ptr, size);
+		else
+			len = Read(ov->File, ptr, size);
+		if (len == 0) {
+			ov->IoErr = ERROR_OBJECT_WRONG_TYPE;
+			return IOERR_BADLENGTH;
+		} else if (len == -1) {
+			ov->IoErr = IoErr();
+			return DOS2IOErr(NULL, ov->IoErr);
+		}
+		ptr += len;
+		size -= len;
+	}
+	return IOERR_SUCCESS;
+}
+
+static LONG BaseIO (struct DiskImageUnit *unit, struct IOStdReq *io, UQUAD offset, APTR buffer,
+	ULONG size, BOOL write)
+{
+	struct DiskImagePlugin *plugin = unit->Plugin;
+	struct IOStdReq base_io;
+
+	base_io = *io;
+	base_io.io_Data = buffer;
+	base_io.io_Length = size;
+	base_io.io_Offset = (ULONG)offset;
+	base_io.io_Actual = (ULONG)(offset >> 32);
+	if (write)
+		return Plugin_Write(plugin, unit->ImageData, &base_io);
+	else
+		return Plugin_Read(plugin, unit->ImageData, &base_io);
+}
+
+/* Writes a zeroed map and truncates the file after it */
+static LONG ClearOverlay (struct DiskImageUnit *unit) {
+	struct Library *DOSBase = unit->LibBase->DOSBase;
+	struct DiskImageOverlay *ov = unit->Overlay;
+	UQUAD offset = OVERLAY_MAPOFFSET;
+	UQUAD end = ov->DataOffset;
+	LONG error;
+
+	memset(ov->Map, 0, ov->NumBlocks * sizeof(ULONG));
+	memset(ov->Buffer, 0, ov->BlockSize);
+	while (offset < end) {
+		ULONG len = min(end - offset, (UQUAD)ov->BlockSize);
+		error = OverlayFileIO(unit, offset, ov->Buffer, len, TRUE);
+		if (error != IOERR_SUCCESS) return error;
+		offset += len;
+	}
+	ov->NextSlot = 1;
+
+	if (SetFileSize(ov->File, ov->DataOffset, OFFSET_BEGINNING) == -1) {
+		ov->IoErr = IoErr();
+		return DOS2IOErr(NULL, ov->IoErr);
+	}
+	return IOERR_SUCCESS;
+}
+
+LONG OpenOverlay (APTR Self, struct DiskImageUnit *unit, BPTR dir, CONST_STRPTR filename,
+	STRPTR fullpath, ULONG fullpath_size)
+{
+	struct DiskImageBase *libBase = unit->LibBase;
+	struct Library *SysBase = libBase->SysBase;
+	struct Library *DOSBase = libBase->DOSBase;
+	struct DiskImageOverlay *ov;
+	struct OverlayHeader hdr;
+	struct DriveGeometry dg;
+	BPTR curr_dir;
+	BOOL created = FALSE;
+	ULONG block_size, num_blocks, i;
+	UQUAD total_bytes, map_end;
+	LONG error;
+
+	if (unit->Overlay) return ERROR_OBJECT_IN_USE;
+
+	memset(&dg, 0, sizeof(dg));
+	dg.dg_SectorSize = 512;
+	if (Plugin_Geometry(unit->Plugin, unit->ImageData, &dg) != IOERR_SUCCESS ||
+		dg.dg_SectorSize == 0 || dg.dg_TotalSectors == 0)
+	{
+		return ERROR_OBJECT_WRONG_TYPE;
+	}
+	total_bytes = (UQUAD)dg.dg_TotalSectors * dg.dg_SectorSize;
+	block_size = (OVERLAY_BLOCKSIZE % dg.dg_SectorSize) ? dg.dg_SectorSize : OVERLAY_BLOCKSIZE;
+	if ((total_bytes + block_size - 1) / block_size > 0x3fffffff) {
+		return ERROR_OBJECT_TOO_LARGE;
+	}
+	num_blocks = (total_bytes + block_size - 1) / block_size;
+
+	ov = AllocVec(sizeof(*ov), MEMF_CLEAR);
+	if (!ov) return ERROR_NO_FREE_STORE;
+	unit->Overlay = ov;
+
+	ov->BlockSize = block_size;
+	ov->NumBlocks = num_blocks;
+	ov->TotalBytes = total_bytes;
+	map_end = OVERLAY_MAPOFFSET + (UQUAD)num_blocks * sizeof(ULONG);
+	ov->DataOffset = (map_end + block_size - 1) / block_size * block_size;
+	ov->NextSlot = 1;
+	ov->Map = AllocVec(num_blocks * sizeof(ULONG), MEMF_ANY);
+	ov->Buffer = AllocVec(block_size, MEMF_ANY);
+	if (!ov->Map || !ov->Buffer) {
+		error = ERROR_NO_FREE_STORE;
+		goto error;
+	}
+
+	curr_dir = CurrentDir(dir);
+	ov->File = Open(filename, MODE_OLDFILE);
+	if (!ov->File && IoErr() == ERROR_OBJECT_NOT_FOUND) {
+		ov->File = Open(filename, MODE_NEWFILE);
+		created = TRUE;
+	}
+	if (ov->File && fullpath && fullpath_size) {
+		NameFromFH(ov->File, fullpath, fullpath_size);
+	}
+	CurrentDir(curr_dir);
+	if (!ov->File) {
+		error = IoErr();
+		goto error;
+	}
+
+	if (created) {
+		wbe32(&hdr.Magic, OVERLAY_MAGIC);
+		wbe32(&hdr.Version, OVERLAY_VERSION);
+		wbe32(&hdr.BlockSize, block_size);
+		wbe32(&hdr.NumBlocks, num_blocks);
+		wbe32(&hdr.TotalBytesHi, total_bytes >> 32);
+		wbe32(&hdr.TotalBytesLo, total_bytes);
+		wbe32(&hdr.MapOffset, OVERLAY_MAPOFFSET);
+		hdr.Reserved = 0;
+		error = OverlayFileIO(unit, 0, &hdr, sizeof(hdr), TRUE);
+		if (error == IOERR_SUCCESS) {
+			error = ClearOverlay(unit);
+		}
+		if (error != IOERR_SUCCESS) {
+			error = ov->IoErr;
+			goto error;
+		}
+	} else {
+		error = OverlayFileIO(unit, 0, &hdr, sizeof(hdr), FALSE);
+		if (error != IOERR_SUCCESS ||
+			rbe32(&hdr.Magic) != OVERLAY_MAGIC ||
+			rbe32(&hdr.Version) != OVERLAY_VERSION ||
+			rbe32(&hdr.MapOffset) != OVERLAY_MAPOFFSET)
+		{
+			error = ERROR_OBJECT_WRONG_TYPE;
+			goto error;
+		}
+		/* The overlay only makes sense on top of the image it was made for */
+		if (rbe32(&hdr.BlockSize) != block_size ||
+			rbe32(&hdr.NumBlocks) != num_blocks ||
+			rbe32(&hdr.TotalBytesHi) != (ULONG)(total_bytes >> 32) ||
+			rbe32(&hdr.TotalBytesLo) != (ULONG)total_bytes)
+		{
+			error = ERROR_OBJECT_WRONG_TYPE;
+			goto error;
+		}
+		error = OverlayFileIO(unit, OVERLAY_MAPOFFSET, ov->Map, num_blocks * sizeof(ULONG), FALSE);
+		if (error != IOERR_SUCCESS) {
+			error = ERROR_OBJECT_WRONG_TYPE;
+			goto error;
+		}
+		for (i = 0; i < num_blocks; i++) {
+			ULONG slot = rbe32(&ov->Map[i]);
+			ov->Map[i] = slot;
+			if (slot >= ov->NextSlot) ov->NextSlot = slot + 1;
+		}
+	}
+
+	unit->OverlayName = ASPrintf("%s", FilePart(filename));
+	if (!unit->OverlayName) {
+		error = ERROR_NO_FREE_STORE;
+		goto error;
+	}
+
+	dbug(("OpenOverlay: %lu blocks of %lu bytes, %lu in use\n",
+		num_blocks, block_size, ov->NextSlot - 1));
+
+	return NO_ERROR;
+
+error:
+	CloseOverlay(Self, unit);
+	if (created) {
+		curr_dir = CurrentDir(dir);
+		DeleteFile(filename);
+		CurrentDir(curr_dir);
+	}
+	return error;
+}
+
+void CloseOverlay (APTR Self, struct DiskImageUnit *unit) {
+	struct DiskImageBase *libBase = unit->LibBase;
+	struct Library *SysBase = libBase->SysBase;
+	struct Library *DOSBase = libBase->DOSBase;
+	struct DiskImageOverlay *ov = unit->Overlay;
+	if (ov) {
+		if (ov->File) Close(ov->File);
+		FreeVec(ov->Buffer);
+		FreeVec(ov->Map);
+		FreeVec(ov);
+		unit->Overlay = NULL;
+	}
+	FreeVec(unit->OverlayName);
+	unit->OverlayName = NULL;
+}
+
+LONG OverlayRead (APTR Self, struct DiskImageUnit *unit, struct IOStdReq *io) {
+	struct DiskImageOverlay *ov = unit->Overlay;
+	UQUAD offset;
+	UBYTE *buffer;
+	ULONG size, block, skip, len, run;
+	LONG error = IOERR_SUCCESS;
+
+	offset = ((UQUAD)io->io_Offset)|((UQUAD)io->io_Actual << 32);
+	buffer = io->io_Data;
+	size = io->io_Length;
+	io->io_Actual = 0;
+
+	if (offset >= ov->TotalBytes) return IOERR_BADADDRESS;
+	if (size > ov->TotalBytes - offset) {
+		size = ov->TotalBytes - offset;
+		error = IOERR_BADLENGTH;
+	}
+
+	while (size) {
+		LONG status;
+		block = offset / ov->BlockSize;
+		skip = offset % ov->BlockSize;
+		len = min(size, BlockLength(ov, block) - skip);
+		if (ov->Map[block]) {
+			status = OverlayFileIO(unit, SlotOffset(ov, ov->Map[block]) + skip, buffer, len, FALSE);
+		} else {
+			/* Pass runs of unchanged blocks to the plugin in one go */
+			for (run = len; run < size && !ov->Map[++block]; ) {
+				run += min(size - run, BlockLength(ov, block));
+			}
+			len = run;
+			status = BaseIO(unit, io, offset, buffer, len, FALSE);
+		}
+		if (status != IOERR_SUCCESS) return status;
+		io->io_Actual += len;
+		buffer += len;
+		offset += len;
+		size -= len;
+	}
+	return error;
+}
+
+LONG OverlayWrite (APTR Self, struct DiskImageUnit *unit, struct IOStdReq *io) {
+	struct DiskImageOverlay *ov = unit->Overlay;
+	UQUAD offset;
+	UBYTE *buffer;
+	ULONG size, block, skip, len, block_len, slot, entry;
+	LONG error = IOERR_SUCCESS;
+
+	offset = ((UQUAD)io->io_Offset)|((UQUAD)io->io_Actual << 32);
+	buffer = io->io_Data;
+	size = io->io_Length;
+	io->io_Actual = 0;
+
+	if (offset >= ov->TotalBytes) return IOERR_BADADDRESS;
+	if (size > ov->TotalBytes - offset) {
+		size = ov->TotalBytes - offset;
+		error = IOERR_BADLENGTH;
+	}
+
+	while (size) {
+		LONG status;
+		block = offset / ov->BlockSize;
+		skip = offset % ov->BlockSize;
+		block_len = BlockLength(ov, block);
+		len = min(size, block_len - skip);
+		slot = ov->Map[block];
+		if (slot) {
+			status = OverlayFileIO(unit, SlotOffset(ov, slot) + skip, buffer, len, TRUE);
+		} else {
+			slot = ov->NextSlot;
+			if (len == ov->BlockSize) {
+				status = OverlayFileIO(unit, SlotOffset(ov, slot), buffer, len, TRUE);
+			} else {
+				/* Copy the rest of the block from the image first */
+				memset(ov->Buffer, 0, ov->BlockSize);
+				status = BaseIO(unit, io, offset - skip, ov->Buffer, block_len, FALSE);
+				if (status == IOERR_SUCCESS) {
+					CopyMem(buffer, ov->Buffer + skip, len);
+					status = OverlayFileIO(unit, SlotOffset(ov, slot), ov->Buffer,
+						ov->BlockSize, TRUE);
+				}
+			}
+			if (status == IOERR_SUCCESS) {
+				wbe32(&entry, slot);
+				status = OverlayFileIO(unit, OVERLAY_MAPOFFSET + (UQUAD)block * sizeof(ULONG),
+					&entry, sizeof(entry), TRUE);
+			}
+			if (status == IOERR_SUCCESS) {
+				ov->Map[block] = slot;
+				ov->NextSlot++;
+			}
+		}
+		if (status != IOERR_SUCCESS) return status;
+		io->io_Actual += len;
+		buffer += len;
+		offset += len;
+		size -= len;
+	}
+	return error;
+}
+
+/* Writes all changed blocks back to the image and empties the overlay */
+LONG CommitOverlay (APTR Self, struct DiskImageUnit *unit) {
+	struct DiskImageOverlay *ov = unit->Overlay;
+	struct IOStdReq io;
+	ULONG block, block_len;
+	LONG error;
+
+	if (!ov) return ERROR_OBJECT_NOT_FOUND;
+	if (!unit->Plugin->plugin_Write) return ERROR_DISK_WRITE_PROTECTED;
+
+	memset(&io, 0, sizeof(io));
+	for (block = 0; block < ov->NumBlocks; block++) {
+		if (!ov->Map[block]) continue;
+		block_len = BlockLength(ov, block);
+		error = OverlayFileIO(unit, SlotOffset(ov, ov->Map[block]), ov->Buffer, block_len, FALSE);
+		if (error != IOERR_SUCCESS) {
+			return ov->IoErr;
+		}
+		error = BaseIO(unit, &io, (UQUAD)block * ov->BlockSize, ov->Buffer, block_len, TRUE);
+		if (error != IOERR_SUCCESS) {
+			return error == TDERR_WriteProt ? ERROR_DISK_WRITE_PROTECTED : ERROR_SEEK_ERROR;
+		}
+	}
+
+	return DiscardOverlay(Self, unit);
+}
+
+LONG DiscardOverlay (APTR Self, struct DiskImageUnit *unit) {
+	struct DiskImageOverlay *ov = unit->Overlay;
+	if (!ov) return ERROR_OBJECT_NOT_FOUND;
+	if (ClearOverlay(unit) != IOERR_SUCCESS) return ov->IoErr;
+	return NO_ERROR;
+}
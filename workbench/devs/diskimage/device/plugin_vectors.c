@@ -28,7 +28,7 @@
 #include "progress.h"
 
 struct DIPluginIFace IPluginIFace = {
-	{ NULL, 1 },
+	{ NULL, 2 },
 	(APTR)DOS2IOErr,
 	(APTR)OpenImage,
 	(APTR)CreateTempFile,
@@ -44,5 +44,8 @@ struct DIPluginIFace IPluginIFace = {
 #if !defined(__AROS__)
 	(APTR)SetDiskImageError,
 #endif
+	(APTR)CreateChunkCache,
+	(APTR)DeleteChunkCache,
+	(APTR)ReadChunkCache,
 };
 
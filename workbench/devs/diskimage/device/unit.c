@@ -49,6 +49,8 @@ static LONG TDRead (struct DiskImageUnit *unit, struct IOStdReq *io);
 static LONG TDWrite (struct DiskImageUnit *unit, struct IOStdReq *io);
 static void InsertDisk (struct DiskImageUnit *unit, BPTR dir, CONST_STRPTR filename,
 	struct DiskImagePlugin *plugin, STRPTR fullpath, ULONG fullpath_size);
+static void AttachOverlay (struct DiskImageUnit *unit, BPTR dir, CONST_STRPTR filename,
+	STRPTR fullpath, ULONG fullpath_size);
 static void RemoveDisk (struct DiskImageUnit *unit);
 static void DiskChange (struct DiskImageUnit *unit);
 
@@ -96,7 +98,7 @@ int UnitProcMain (struct DiskImageUnit *unit) {
 	struct TagItem *ti, *tstate;
 	LONG err;
 	ULONG sigmask;
-	CONST_STRPTR filename, plugin_name;
+	CONST_STRPTR filename, plugin_name, overlay_name;
 	struct ChangeInt *handler;
 	BOOL disk_change = FALSE;
 
@@ -132,6 +134,7 @@ int UnitProcMain (struct DiskImageUnit *unit) {
 	unit->Flags = DictGetIntegerForKey(unit->Prefs, "Flags", DGF_REMOVABLE);
 	filename = DictGetStringForKey(unit->Prefs, "DiskImageFile", NULL);
 	plugin_name = DictGetStringForKey(unit->Prefs, "Plugin", NULL);
+	overlay_name = DictGetStringForKey(unit->Prefs, "OverlayFile", NULL);
 	if (filename) {
 		struct DiskImagePlugin *plugin = NULL;
 		ObtainSemaphoreShared(libBase->PluginSemaphore);
@@ -142,6 +145,9 @@ int UnitProcMain (struct DiskImageUnit *unit) {
 			APTR window;
 			window = SetProcWindow((APTR)-1);
 			InsertDisk(unit, ZERO, filename, plugin, NULL, 0);
+			if (unit->ImageData && overlay_name) {
+				AttachOverlay(unit, ZERO, overlay_name, NULL, 0);
+			}
 			SetProcWindow(window);
 		}
 		ReleaseSemaphore(libBase->PluginSemaphore);
@@ -162,6 +168,7 @@ int UnitProcMain (struct DiskImageUnit *unit) {
 					if ((tstate = (struct TagItem *)msg->dim_Tags)) {
 						BPTR curr_dir = ZERO;
 						struct DiskImagePlugin *plugin = NULL;
+						CONST_STRPTR overlay = NULL;
 
 						unit->Error = NO_ERROR;
 						unit->ErrorString = NULL;
@@ -211,14 +218,22 @@ int UnitProcMain (struct DiskImageUnit *unit) {
 									}
 									break;
 
+								case DITAG_Overlay:
+									overlay = (CONST_STRPTR)ti->ti_Data;
+									break;
+
 								case DITAG_Filename: {
 									APTR image_data = unit->ImageData;
 									TEXT fullpath[512];
+									TEXT overlay_path[512];
 									RemoveDisk(unit);
 									filename = (CONST_STRPTR)ti->ti_Data;
 									if (filename) {
 										InsertDisk(unit, curr_dir, filename, plugin, fullpath, sizeof(fullpath));
 									}
+									if (unit->ImageData && overlay) {
+										AttachOverlay(unit, curr_dir, overlay, overlay_path, sizeof(overlay_path));
+									}
 									if (image_data || unit->ImageData) {
 										disk_change = TRUE;
 										if (unit->ImageData) {
@@ -237,6 +252,14 @@ int UnitProcMain (struct DiskImageUnit *unit) {
 											DictRemoveObjForKey(unit->Prefs,
 												"Plugin");
 										}
+										if (unit->Overlay) {
+											DictSetObjectForKey(unit->Prefs,
+												AllocPrefsString(overlay_path),
+												"OverlayFile");
+										} else {
+											DictRemoveObjForKey(unit->Prefs,
+												"OverlayFile");
+										}
 										WriteUnitPrefs(unit, TRUE);
 									}
 									break;
@@ -252,7 +275,7 @@ int UnitProcMain (struct DiskImageUnit *unit) {
 										break;
 									}
 									*(STRPTR *)ti->ti_Data = ASPrintf("%s", unit->Name);
-									if (!ti->ti_Data) {
+									if (!*(STRPTR *)ti->ti_Data) {
 										SetDiskImageError(NULL, unit, ERROR_NO_FREE_STORE, 0);
 										break;
 									}
@@ -262,6 +285,37 @@ int UnitProcMain (struct DiskImageUnit *unit) {
 									*(BOOL *)ti->ti_Data = unit->WriteProtect;
 									break;
 
+								case DITAG_GetOverlayName:
+									if (!unit->OverlayName) {
+										*(STRPTR *)ti->ti_Data = NULL;
+										break;
+									}
+									*(STRPTR *)ti->ti_Data = ASPrintf("%s", unit->OverlayName);
+									if (!*(STRPTR *)ti->ti_Data) {
+										SetDiskImageError(NULL, unit, ERROR_NO_FREE_STORE, 0);
+										break;
+									}
+									break;
+
+								case DITAG_CommitOverlay:
+									if (!ti->ti_Data) break;
+									err = CommitOverlay(NULL, unit);
+									if (err != NO_ERROR) {
+										SetDiskImageError(NULL, unit, err, 0);
+										break;
+									}
+									break;
+
+								case DITAG_DiscardOverlay:
+									if (!ti->ti_Data) break;
+									err = DiscardOverlay(NULL, unit);
+									if (err != NO_ERROR) {
+										SetDiskImageError(NULL, unit, err, 0);
+									}
+									/* The filesystem must not keep any of the old blocks */
+									disk_change = TRUE;
+									break;
+
 								case DITAG_DiskImageType:
 									if (unit->ImageData)
 										*(ULONG *)ti->ti_Data = DITYPE_RAW;
@@ -531,6 +585,9 @@ static LONG TDRead (struct DiskImageUnit *unit, struct IOStdReq *io) {
 	if (!unit->ImageData || !plugin) {
 		return TDERR_DiskChanged;
 	}
+	if (unit->Overlay) {
+		return OverlayRead(NULL, unit, io);
+	}
 	return Plugin_Read(plugin, unit->ImageData, io);
 }
 
@@ -539,7 +596,13 @@ static LONG TDWrite (struct DiskImageUnit *unit, struct IOStdReq *io) {
 	if (!unit->ImageData || !plugin) {
 		return TDERR_DiskChanged;
 	}
-	if (unit->WriteProtect || !plugin->plugin_Write) {
+	if (unit->WriteProtect) {
+		return TDERR_WriteProt;
+	}
+	if (unit->Overlay) {
+		return OverlayWrite(NULL, unit, io);
+	}
+	if (!plugin->plugin_Write) {
 		return TDERR_WriteProt;
 	}
 	return Plugin_Write(plugin, unit->ImageData, io);
@@ -576,9 +639,22 @@ static void InsertDisk (struct DiskImageUnit *unit, BPTR dir, CONST_STRPTR filen
 	CurrentDir(curr_dir);
 }
 
+static void AttachOverlay (struct DiskImageUnit *unit, BPTR dir, CONST_STRPTR filename,
+	STRPTR fullpath, ULONG fullpath_size)
+{
+	LONG error;
+	error = OpenOverlay(NULL, unit, dir, filename, fullpath, fullpath_size);
+	if (error != NO_ERROR) {
+		SetDiskImageError(NULL, unit, error, 0);
+		RemoveDisk(unit);
+	}
+}
+
 static void RemoveDisk (struct DiskImageUnit *unit) {
 	struct Library *SysBase = unit->LibBase->SysBase;
 
+	CloseOverlay(NULL, unit);
+
 	if (unit->Plugin && unit->ImageData) {
 		Plugin_CloseImage(unit->Plugin, unit->ImageData);
 	}
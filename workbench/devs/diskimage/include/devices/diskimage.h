@@ -90,7 +90,11 @@ enum {
 	DITAG_SetDeviceType,
 	DITAG_GetDeviceType,
 	DITAG_SetFlags,
-	DITAG_GetFlags
+	DITAG_GetFlags,
+	DITAG_Overlay,
+	DITAG_GetOverlayName,
+	DITAG_CommitOverlay,
+	DITAG_DiscardOverlay
 };
 
 enum {
@@ -34,6 +34,9 @@ struct InterfaceData {
 	ULONG Version;
 };
 
+/* Decodes chunk number chunk, size bytes long, into buffer */
+typedef LONG (*DIReadChunkFunc)(APTR image, UQUAD chunk, UBYTE *buffer, ULONG size);
+
 struct DIPluginIFace {
 	struct InterfaceData Data;
 	LONG (*DOS2IOErr)(struct DIPluginIFace *Self, LONG error);
@@ -54,6 +57,12 @@ struct DIPluginIFace {
 	void (*SetDiskImageErrorA)(struct DIPluginIFace *Self, APTR unit, LONG error, LONG error_string, CONST_APTR error_args);
 	VARARGS68K void (*SetDiskImageError)(struct DIPluginIFace *Self, APTR unit, LONG error, LONG error_string, ...);
 #endif
+	/* Version 2 */
+	APTR (*CreateChunkCache)(struct DIPluginIFace *Self, APTR unit, APTR image, ULONG chunk_size,
+		UQUAD total_bytes, DIReadChunkFunc read_chunk);
+	void (*DeleteChunkCache)(struct DIPluginIFace *Self, APTR cache);
+	LONG (*ReadChunkCache)(struct DIPluginIFace *Self, APTR cache, UQUAD offset, APTR buffer,
+		ULONG length, ULONG *actual);
 };
 
 #define IPlugin_DOS2IOErr(a) IPlugin->DOS2IOErr(IPlugin,a)
@@ -68,6 +77,9 @@ struct DIPluginIFace {
 #define IPlugin_SetProgressBarAttrsA(a,b) IPlugin->SetProgressBarAttrsA(IPlugin,a,b)
 #define IPlugin_SetProgressBarAttrs(a,...) IPlugin->SetProgressBarAttrs(IPlugin,a,__VA_ARGS__)
 #define IPlugin_SetDiskImageErrorA(a,b,c,d) IPlugin->SetDiskImageErrorA(IPlugin,a,b,c,d)
+#define IPlugin_CreateChunkCache(a,b,c,d,e) IPlugin->CreateChunkCache(IPlugin,a,b,c,d,e)
+#define IPlugin_DeleteChunkCache(a) IPlugin->DeleteChunkCache(IPlugin,a)
+#define IPlugin_ReadChunkCache(a,b,c,d,e) IPlugin->ReadChunkCache(IPlugin,a,b,c,d,e)
 #if !defined(__AROS__)
 #define IPlugin_SetDiskImageError(a,b,...) IPlugin->SetDiskImageError(IPlugin,a,b,__VA_ARGS__)
 #else
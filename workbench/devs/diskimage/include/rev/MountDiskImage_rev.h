@@ -1,6 +1,6 @@
 #define VERSION  52
-#define REVISION 32
-#define DATE     "14.12.2020"
-#define VERS     "MountDiskImage 52.32"
-#define VSTRING  "MountDiskImage 52.32 (14.12.2020)\r\n"
-#define VERSTAG  "\0$VER: MountDiskImage 52.32 (14.12.2020)"
+#define REVISION 33
+#define DATE     "19.10.2026"
+#define VERS     "MountDiskImage 52.33"
+#define VSTRING  "MountDiskImage 52.33 (19.10.2026)\r\n"
+#define VERSTAG  "\0$VER: MountDiskImage 52.33 (19.10.2026)"
@@ -0,0 +1,6 @@
+#define VERSION  52
+#define REVISION 33
+#define DATE     "19.10.2026"
+#define VERS     "ZSTImage 52.33"
+#define VSTRING  "ZSTImage 52.33 (19.10.2026)\r\n"
+#define VERSTAG  "\0$VER: ZSTImage 52.33 (19.10.2026)"
@@ -1,6 +1,6 @@
 #define VERSION  52
-#define REVISION 32
-#define DATE     "14.12.2020"
-#define VERS     "diskimage.device 52.32"
-#define VSTRING  "diskimage.device 52.32 (14.12.2020)\r\n"
-#define VERSTAG  "\0$VER: diskimage.device 52.32 (14.12.2020)"
+#define REVISION 34
+#define DATE     "19.10.2026"
+#define VERS     "diskimage.device 52.34"
+#define VSTRING  "diskimage.device 52.34 (19.10.2026)\r\n"
+#define VERSTAG  "\0$VER: diskimage.device 52.34 (19.10.2026)"
@@ -61,6 +61,7 @@ struct CISOImage {
 	z_stream zs;
 	ULONG *index_buf;
 	struct Library *zbase;
+	APTR cache;
 };
 
 BOOL CISO_Init (struct DiskImagePlugin *Self, const struct PluginData *data);
@@ -104,7 +105,7 @@ BOOL CISO_Init (struct DiskImagePlugin *Self, const struct PluginData *data) {
 	SysBase = data->SysBase;
 	DOSBase = data->DOSBase;
 	IPlugin = data->IPlugin;
-	return TRUE;
+	return IPlugin->Data.Version >= 2;
 }
 
 #define CISO_MAGIC MAKE_ID('C','I','S','O')
@@ -129,6 +130,8 @@ typedef struct {
 
 #pragma pack()
 
+static LONG CISO_ReadBlock (APTR image_ptr, UQUAD block, UBYTE *buffer, ULONG size);
+
 APTR CISO_OpenImage (struct DiskImagePlugin *Self, APTR unit, BPTR file, CONST_STRPTR name) {
 	LONG done = FALSE;
 	LONG error = NO_ERROR;
@@ -202,6 +205,13 @@ APTR CISO_OpenImage (struct DiskImagePlugin *Self, APTR unit, BPTR file, CONST_S
 		image->index_buf[i] = rle32(&image->index_buf[i]);
 	}
 
+	image->cache = IPlugin_CreateChunkCache(unit, image, block_size,
+		(UQUAD)total_blocks * block_size, CISO_ReadBlock);
+	if (!image->cache) {
+		error = ERROR_NO_FREE_STORE;
+		goto error;
+	}
+
 	done = TRUE;
 
 error:
@@ -228,6 +238,7 @@ error:
 void CISO_CloseImage (struct DiskImagePlugin *Self, APTR image_ptr) {
 	struct CISOImage *image = image_ptr;
 	if (image) {
+		IPlugin_DeleteChunkCache(image->cache);
 		if (image->zbase) {
 			if (CheckLib(image->zbase, 1, 6)) InflateEnd(&image->zs);
 			CloseLibrary(image->zbase);
@@ -250,70 +261,60 @@ LONG CISO_Geometry (struct DiskImagePlugin *Self, APTR image_ptr, struct DriveGe
 	return IOERR_SUCCESS;
 }
 
-LONG CISO_Read (struct DiskImagePlugin *Self, APTR image_ptr, struct IOStdReq *io) {
+static LONG CISO_ReadBlock (APTR image_ptr, UQUAD block, UBYTE *buffer, ULONG size) {
 	struct CISOImage *image = image_ptr;
-	UBYTE *buffer;
-	UQUAD offset;
-	ULONG size;
 	ULONG block_size = image->block_size;
 	UBYTE align = image->align;
-	UBYTE *block_buf = image->block_buf;
-	ULONG *index_buf, index, index2, plain;
+	ULONG index, index2, plain;
 	UBYTE *read_buf;
 	ULONG read_pos, read_size;
-	LONG error = IOERR_SUCCESS;
 	BPTR file = image->file;
 
-	buffer = io->io_Data;
+	index = image->index_buf[block];
+	plain = index & 0x80000000;
+	index -= plain;
+	read_pos = index << align;
+	if (plain) {
+		read_size = block_size;
+		read_buf = buffer;
+	} else {
+		index2 = image->index_buf[block + 1] & 0x7fffffff;
+		read_size = (index2 - index) << align;
+		read_buf = image->block_buf;
+		if (read_size > (block_size << 1)) {
+			return TDERR_NotSpecified;
+		}
+	}
+	if (!ChangeFilePosition(file, read_pos, OFFSET_BEGINNING) ||
+		Read(file, read_buf, read_size) != read_size)
+	{
+		return IPlugin_DOS2IOErr(IoErr());
+	}
+	if (!plain) {
+		InflateReset(&image->zs);
+		image->zs.next_in = read_buf;
+		image->zs.avail_in = read_size;
+		image->zs.next_out = buffer;
+		image->zs.avail_out = block_size;
+		if (Inflate(&image->zs, Z_SYNC_FLUSH) != Z_STREAM_END) {
+			return TDERR_NotSpecified;
+		}
+	}
+	return IOERR_SUCCESS;
+}
+
+LONG CISO_Read (struct DiskImagePlugin *Self, APTR image_ptr, struct IOStdReq *io) {
+	struct CISOImage *image = image_ptr;
+	UQUAD offset;
+	ULONG size;
+	ULONG block_size = image->block_size;
+
 	offset = ((UQUAD)io->io_Offset)|((UQUAD)io->io_Actual << 32);
 	size = io->io_Length;
 	io->io_Actual = 0;
 
 	if (offset % block_size) return IOERR_BADADDRESS;
 	if (size % block_size) return IOERR_BADLENGTH;
-	
-	offset /= block_size;
-	size /= block_size;
-	if (offset >= image->total_blocks) {
-		return IOERR_BADADDRESS;
-	}
-	if (offset + size > image->total_blocks) {
-		size = image->total_blocks - offset;
-		error = IOERR_BADLENGTH;
-	}
 
-	index_buf = image->index_buf + offset;
-	while (size--) {
-		index = *index_buf++;
-		plain = index & 0x80000000;
-		index -= plain;
-		read_pos = index << align;
-		if (plain) {
-			read_size = block_size;
-			read_buf = buffer;
-		} else {
-			index2 = *index_buf & 0x7fffffff;
-			read_size = (index2 - index) << align;
-			read_buf = block_buf;
-		}
-		if (!ChangeFilePosition(file, read_pos, OFFSET_BEGINNING) ||
-			Read(file, read_buf, read_size) != read_size)
-		{
-			return IPlugin_DOS2IOErr(IoErr());
-		}
-		if (!plain) {
-			InflateReset(&image->zs);
-			image->zs.next_in = read_buf;
-			image->zs.avail_in = read_size;
-			image->zs.next_out = buffer;
-			image->zs.avail_out = block_size;
-			if (Inflate(&image->zs, Z_SYNC_FLUSH) != Z_STREAM_END) {
-				return TDERR_NotSpecified;
-			}
-		}
-		buffer += block_size;
-		io->io_Actual += block_size;
-	}
-	return error;
+	return IPlugin_ReadChunkCache(image->cache, offset, io->io_Data, size, &io->io_Actual);
 }
-
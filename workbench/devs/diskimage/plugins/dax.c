@@ -56,14 +56,14 @@ typedef struct {
 
 struct DAXImage {
 	BPTR file;
-	UBYTE *in_buf, *out_buf;
+	UBYTE *in_buf;
 	ULONG nframes;
 	frame_t *frames;
-	frame_t *frame_in_buf;
 	ULONG total_bytes;
 	ULONG block_size;
 	ULONG total_blocks;
 	struct Library *zbase;
+	APTR cache;
 };
 
 BOOL DAX_Init (struct DiskImagePlugin *Self, const struct PluginData *data);
@@ -107,7 +107,7 @@ BOOL DAX_Init (struct DiskImagePlugin *Self, const struct PluginData *data) {
 	SysBase = data->SysBase;
 	DOSBase = data->DOSBase;
 	IPlugin = data->IPlugin;
-	return TRUE;
+	return IPlugin->Data.Version >= 2;
 }
 
 #define DAX_MAGIC MAKE_ID('D','A','X',0)
@@ -138,6 +138,8 @@ typedef struct {
 
 #pragma pack()
 
+static LONG DAX_ReadFrame (APTR image_ptr, UQUAD frame_num, UBYTE *buffer, ULONG size);
+
 static inline BOOL IsNCArea (ncarea_t *ncareas, ULONG frame, ULONG count) {
 	ULONG i;
 	for (i = 0; i < count; i++) {
@@ -257,8 +259,9 @@ APTR DAX_OpenImage (struct DiskImagePlugin *Self, APTR unit, BPTR file,
 	}
 
 	image->in_buf = AllocVec(DAX_FRAME_SIZE+1024, MEMF_ANY);
-	image->out_buf = AllocVec(DAX_FRAME_SIZE, MEMF_ANY);
-	if (!image->in_buf || !image->out_buf) {
+	image->cache = IPlugin_CreateChunkCache(unit, image, DAX_FRAME_SIZE,
+		image->total_bytes, DAX_ReadFrame);
+	if (!image->in_buf || !image->cache) {
 		error = ERROR_NO_FREE_STORE;
 		goto error;
 	}
@@ -292,9 +295,9 @@ error:
 void DAX_CloseImage (struct DiskImagePlugin *Self, APTR image_ptr) {
 	struct DAXImage *image = image_ptr;
 	if (image) {
+		IPlugin_DeleteChunkCache(image->cache);
 		if (image->zbase) CloseLibrary(image->zbase);
 		FreeVec(image->in_buf);
-		FreeVec(image->out_buf);
 		FreeVec(image->frames);
 		Close(image->file);
 		FreeVec(image);
@@ -312,66 +315,38 @@ LONG DAX_Geometry (struct DiskImagePlugin *Self, APTR image_ptr, struct DriveGeo
 	return IOERR_SUCCESS;
 }
 
-LONG DAX_Read (struct DiskImagePlugin *Self, APTR image_ptr, struct IOStdReq *io) {
+static LONG DAX_ReadFrame (APTR image_ptr, UQUAD frame_num, UBYTE *buffer, ULONG size) {
 	struct DAXImage *image = image_ptr;
+	frame_t *frame = &image->frames[frame_num];
 	BPTR file = image->file;
-	ULONG offset;
-	UBYTE *buffer;
-	ULONG size;
-	ULONG i;
-	ULONG to_skip, to_read;
-	frame_t *frame;
-
-	offset = io->io_Offset;
-	buffer = io->io_Data;
-	size = io->io_Length;
-	io->io_Actual = 0;
-
-	i = offset / DAX_FRAME_SIZE;
-	to_skip = offset % DAX_FRAME_SIZE;
-	if (i >= image->nframes) return IOERR_BADADDRESS;
-
-	frame = &image->frames[i];
-	io->io_Actual = size;
-	while (size) {
-		if (i >= image->nframes) {
-			io->io_Actual -= size;
-			return IOERR_BADLENGTH;
-		}
 
-		to_read = min(size, DAX_FRAME_SIZE - to_skip);
-		if (frame->comp) {
-			if (image->frame_in_buf != frame) {
-				uLongf bytes;
-				image->frame_in_buf = NULL;
-				if (!ChangeFilePosition(file, frame->offset, OFFSET_BEGINNING) ||
-					Read(file, image->in_buf, frame->size) != frame->size)
-				{
-					io->io_Actual -= size;
-					return IPlugin_DOS2IOErr(IoErr());
-				}
-				bytes = DAX_FRAME_SIZE;
-				if (Uncompress(image->out_buf, &bytes, image->in_buf, frame->size) != Z_OK) {
-					io->io_Actual -= size;
-					return TDERR_NotSpecified;
-				}
-				image->frame_in_buf = frame;
-			}
-			CopyMem(image->out_buf + to_skip, buffer, to_read);
-		} else {
-			if (!ChangeFilePosition(file, frame->offset + to_skip, OFFSET_BEGINNING) ||
-				Read(file, buffer, to_read) != to_read)
-			{
-				io->io_Actual -= size;
-				return IPlugin_DOS2IOErr(IoErr());
-			}
+	if (frame->comp) {
+		uLongf bytes;
+		if (frame->size > DAX_FRAME_SIZE+1024) {
+			return TDERR_NotSpecified;
+		}
+		if (!ChangeFilePosition(file, frame->offset, OFFSET_BEGINNING) ||
+			Read(file, image->in_buf, frame->size) != frame->size)
+		{
+			return IPlugin_DOS2IOErr(IoErr());
+		}
+		bytes = size;
+		if (Uncompress(buffer, &bytes, image->in_buf, frame->size) != Z_OK) {
+			return TDERR_NotSpecified;
+		}
+	} else {
+		if (!ChangeFilePosition(file, frame->offset, OFFSET_BEGINNING) ||
+			Read(file, buffer, size) != size)
+		{
+			return IPlugin_DOS2IOErr(IoErr());
 		}
-
-		buffer += to_read;
-		size -= to_read;
-		to_skip = 0;
-		frame++;
-		i++;
 	}
 	return IOERR_SUCCESS;
 }
+
+LONG DAX_Read (struct DiskImagePlugin *Self, APTR image_ptr, struct IOStdReq *io) {
+	struct DAXImage *image = image_ptr;
+
+	return IPlugin_ReadChunkCache(image->cache, io->io_Offset, io->io_Data, io->io_Length,
+		&io->io_Actual);
+}
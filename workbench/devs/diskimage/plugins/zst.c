@@ -0,0 +1,321 @@
+/* Copyright 2026 The AROS Development Team. All rights reserved.
+**
+** Redistribution and use in source and binary forms, with or without
+** modification, are permitted provided that the following conditions
+** are met:
+**
+** 1. Redistributions of source code must retain the above copyright
+**    notice, this list of conditions and the following disclaimer.
+**
+** 2. Redistributions in binary form must reproduce the above copyright
+**    notice, this list of conditions and the following disclaimer in the
+**    documentation and/or other materials provided with the distribution.
+**
+** THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS `AS IS'
+** AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+** IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+** ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+** LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+** CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+** SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+** INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+** CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+** ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+** POSSIBILITY OF SUCH DAMAGE.
+*/
+
+/*
+** Plugin for raw disk images compressed in the zstd seekable format: a row
+** of independent zstd frames followed by a skippable frame holding the
+** seek table. Images made with C:ZSTImage have frames of equal
+** decompressed size (except the last), which is all this plugin accepts,
+** so each frame maps to one chunk of the device's chunk cache.
+*/
+
+#define USED_PLUGIN_API_VERSION 8
+#include <devices/diskimage.h>
+#include <proto/exec.h>
+#include <proto/dos.h>
+#include <proto/zstd.h>
+
+#include "endian.h"
+#include "device_locale.h"
+#include <SDI_compiler.h>
+#include "rev/diskimage.device_rev.h"
+
+PLUGIN_VERSTAG("ZST")
+
+extern struct DiskImagePlugin zst_plugin;
+
+PLUGIN_TABLE(&zst_plugin)
+
+struct ZSTImage {
+	BPTR file;
+	ULONG block_size;
+	ULONG total_blocks;
+	UQUAD total_bytes;
+	ULONG frame_size;
+	ULONG nframes;
+	UQUAD *offsets;
+	ULONG *sizes;
+	UBYTE *in_buf;
+	ZSTD_DCtx *dctx;
+	APTR cache;
+};
+
+BOOL ZST_Init (struct DiskImagePlugin *Self, const struct PluginData *data);
+void ZST_Exit (struct DiskImagePlugin *Self);
+BOOL ZST_CheckImage (struct DiskImagePlugin *Self, BPTR file, CONST_STRPTR name, QUAD file_size,
+	const UBYTE *test, LONG testsize);
+APTR ZST_OpenImage (struct DiskImagePlugin *Self, APTR unit, BPTR file, CONST_STRPTR name);
+void ZST_CloseImage (struct DiskImagePlugin *Self, APTR image_ptr);
+LONG ZST_Geometry (struct DiskImagePlugin *Self, APTR image_ptr, struct DriveGeometry *dg);
+LONG ZST_Read (struct DiskImagePlugin *Self, APTR image_ptr, struct IOStdReq *io);
+
+struct DiskImagePlugin zst_plugin = {
+	PLUGIN_NODE(0, "ZST"),
+	PLUGIN_FLAG_FOOTER,
+	9,
+	ZERO,
+	NULL,
+	ZST_Init,
+	ZST_Exit,
+	ZST_CheckImage,
+	ZST_OpenImage,
+	ZST_CloseImage,
+	ZST_Geometry,
+	ZST_Read,
+	NULL,
+	NULL,
+	NULL,
+	NULL,
+	NULL
+};
+
+struct Library *SysBase;
+struct Library *DOSBase;
+struct Library *ZSTDBase;
+static struct DIPluginIFace *IPlugin;
+
+BOOL ZST_Init (struct DiskImagePlugin *Self, const struct PluginData *data) {
+	SysBase = data->SysBase;
+	DOSBase = data->DOSBase;
+	IPlugin = data->IPlugin;
+	return IPlugin->Data.Version >= 2;
+}
+
+void ZST_Exit (struct DiskImagePlugin *Self) {
+	if (ZSTDBase) CloseLibrary(ZSTDBase);
+}
+
+#define SKIPPABLE_MAGIC	0x184D2A5E
+#define SEEKABLE_MAGIC	0x8F92EAB1
+#define SEEKTABLE_CHECKSUM_FLAG	0x80
+#define MAX_FRAME_SIZE	(1UL << 20)
+
+#pragma pack(1)
+
+typedef struct {
+	ULONG nframes;
+	UBYTE descriptor;
+	ULONG magic;
+} seek_footer_t;
+
+typedef struct {
+	ULONG magic;
+	ULONG size;
+} skippable_t;
+
+#pragma pack()
+
+BOOL ZST_CheckImage (struct DiskImagePlugin *Self, BPTR file, CONST_STRPTR name, QUAD file_size,
+	const UBYTE *test, LONG testsize)
+{
+	return testsize >= sizeof(seek_footer_t) &&
+		rle32(test + testsize - sizeof(ULONG)) == SEEKABLE_MAGIC;
+}
+
+static LONG ZST_ReadFrame (APTR image_ptr, UQUAD frame, UBYTE *buffer, ULONG size) {
+	struct ZSTImage *image = image_ptr;
+	ULONG csize = image->sizes[frame];
+	size_t res;
+
+	if (!ChangeFilePosition(image->file, image->offsets[frame], OFFSET_BEGINNING) ||
+		Read(image->file, image->in_buf, csize) != csize)
+	{
+		return IPlugin_DOS2IOErr(IoErr());
+	}
+	res = ZSTD_decompressDCtx(image->dctx, buffer, size, image->in_buf, csize);
+	if (ZSTD_isError(res) || res != size) {
+		return TDERR_NotSpecified;
+	}
+	return IOERR_SUCCESS;
+}
+
+APTR ZST_OpenImage (struct DiskImagePlugin *Self, APTR unit, BPTR file, CONST_STRPTR name) {
+	LONG done = FALSE;
+	LONG error = NO_ERROR;
+	LONG error_string = NO_ERROR_STRING;
+	IPTR error_args[4] = {0};
+	struct ZSTImage *image = NULL;
+	seek_footer_t footer;
+	skippable_t header;
+	ULONG entry_size, table_size;
+	ULONG *entries = NULL;
+	ULONG nframes, max_csize, i;
+	UQUAD offset, last_size;
+
+	if (!ChangeFilePosition(file, -(QUAD)sizeof(footer), OFFSET_END) ||
+		Read(file, &footer, sizeof(footer)) != sizeof(footer))
+	{
+		error = IoErr();
+		goto error;
+	}
+
+	nframes = rle32(&footer.nframes);
+	entry_size = (footer.descriptor & SEEKTABLE_CHECKSUM_FLAG) ? 12 : 8;
+	if (nframes == 0 || nframes > (0x7fffffffUL / entry_size)) {
+		error = ERROR_OBJECT_WRONG_TYPE;
+		error_string = MSG_BADDATA;
+		goto error;
+	}
+	table_size = nframes * entry_size;
+
+	image = AllocVec(sizeof(*image), MEMF_CLEAR);
+	if (!image) {
+		error = ERROR_NO_FREE_STORE;
+		goto error;
+	}
+	image->file = file;
+	image->nframes = nframes;
+
+	/* Opened once for all images, closed in ZST_Exit() */
+	if (!ZSTDBase) {
+		ZSTDBase = OpenLibrary("zstd.library", 1);
+	}
+	if (!ZSTDBase) {
+		error = ERROR_OBJECT_NOT_FOUND;
+		error_string = MSG_REQVER;
+		error_args[0] = (IPTR)"zstd.library";
+		error_args[1] = 1;
+		error_args[2] = 0;
+		goto error;
+	}
+
+	if (!ChangeFilePosition(file, -(QUAD)(sizeof(header) + table_size + sizeof(footer)), OFFSET_END) ||
+		Read(file, &header, sizeof(header)) != sizeof(header))
+	{
+		error = IoErr();
+		goto error;
+	}
+	if (rle32(&header.magic) != SKIPPABLE_MAGIC ||
+		rle32(&header.size) != table_size + sizeof(footer))
+	{
+		error = ERROR_OBJECT_WRONG_TYPE;
+		error_string = MSG_BADDATA;
+		goto error;
+	}
+
+	entries = AllocVec(table_size, MEMF_ANY);
+	image->offsets = AllocVec(nframes * sizeof(UQUAD), MEMF_ANY);
+	image->sizes = AllocVec(nframes * sizeof(ULONG), MEMF_ANY);
+	if (!entries || !image->offsets || !image->sizes) {
+		error = ERROR_NO_FREE_STORE;
+		goto error;
+	}
+	if (Read(file, entries, table_size) != table_size) {
+		error = IoErr();
+		goto error;
+	}
+
+	/* The frames must all decompress to the same size, bar the last */
+	offset = 0;
+	max_csize = 0;
+	image->frame_size = rle32((UBYTE *)entries + sizeof(ULONG));
+	for (i = 0; i < nframes; i++) {
+		UBYTE *entry = (UBYTE *)entries + i * entry_size;
+		ULONG csize = rle32(entry);
+		ULONG dsize = rle32(entry + sizeof(ULONG));
+
+		if (dsize > image->frame_size || (dsize != image->frame_size && i != nframes - 1)) {
+			error = ERROR_NOT_IMPLEMENTED;
+			error_string = MSG_UNKNCOMPMETHOD;
+			goto error;
+		}
+		image->offsets[i] = offset;
+		image->sizes[i] = csize;
+		offset += csize;
+		max_csize = max(max_csize, csize);
+	}
+	last_size = rle32((UBYTE *)entries + (nframes - 1) * entry_size + sizeof(ULONG));
+	if (image->frame_size == 0 || image->frame_size > MAX_FRAME_SIZE || max_csize > MAX_FRAME_SIZE + 1024) {
+		error = ERROR_OBJECT_WRONG_TYPE;
+		error_string = MSG_BADDATA;
+		goto error;
+	}
+
+	image->total_bytes = (UQUAD)(nframes - 1) * image->frame_size + last_size;
+	image->block_size = 512;
+	image->total_blocks = image->total_bytes >> 9;
+
+	image->in_buf = AllocVec(max_csize, MEMF_ANY);
+	image->dctx = ZSTD_createDCtx();
+	image->cache = IPlugin_CreateChunkCache(unit, image, image->frame_size,
+		image->total_bytes, ZST_ReadFrame);
+	if (!image->in_buf || !image->dctx || !image->cache) {
+		error = ERROR_NO_FREE_STORE;
+		goto error;
+	}
+
+	done = TRUE;
+
+error:
+	FreeVec(entries);
+	if (!done) {
+		if (image) {
+			Plugin_CloseImage(Self, image);
+			image = NULL;
+		} else {
+			Close(file);
+		}
+		if (error == NO_ERROR) {
+			error = ERROR_OBJECT_WRONG_TYPE;
+			error_string = MSG_EOF;
+		}
+		IPlugin_SetDiskImageErrorA(unit, error, error_string, (RAWARG)error_args);
+	}
+	return image;
+}
+
+void ZST_CloseImage (struct DiskImagePlugin *Self, APTR image_ptr) {
+	struct ZSTImage *image = image_ptr;
+	if (image) {
+		IPlugin_DeleteChunkCache(image->cache);
+		if (image->dctx) ZSTD_freeDCtx(image->dctx);
+		FreeVec(image->in_buf);
+		FreeVec(image->sizes);
+		FreeVec(image->offsets);
+		Close(image->file);
+		FreeVec(image);
+	}
+}
+
+LONG ZST_Geometry (struct DiskImagePlugin *Self, APTR image_ptr, struct DriveGeometry *dg) {
+	struct ZSTImage *image = image_ptr;
+	dg->dg_SectorSize = image->block_size;
+	dg->dg_Heads =
+	dg->dg_TrackSectors =
+	dg->dg_CylSectors = 1;
+	dg->dg_Cylinders =
+	dg->dg_TotalSectors = image->total_blocks;
+	return IOERR_SUCCESS;
+}
+
+LONG ZST_Read (struct DiskImagePlugin *Self, APTR image_ptr, struct IOStdReq *io) {
+	struct ZSTImage *image = image_ptr;
+	UQUAD offset;
+
+	offset = ((UQUAD)io->io_Offset)|((UQUAD)io->io_Actual << 32);
+	return IPlugin_ReadChunkCache(image->cache, offset, io->io_Data, io->io_Length,
+		&io->io_Actual);
+}
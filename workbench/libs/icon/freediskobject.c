@@ -1,10 +1,11 @@
 /*
-    Copyright (C) 1995-2013, The AROS Development Team. All rights reserved.
+    Copyright (C) 1995-2026, The AROS Development Team. All rights reserved.
 
     Desc:
 */
 #include <proto/arossupport.h>
 #include "icon_intern.h"
+#include "iconcache.h"
 #include <stddef.h>
 
 extern const IPTR IconDesc[];
@@ -52,8 +53,10 @@ extern const IPTR IconDesc[];
     if ( ! diskobj) return;
 
     struct NativeIcon *nativeicon;
+    struct IconCacheEntry *cacheentry;
     
     nativeicon = NATIVEICON(diskobj);
+    cacheentry = nativeicon->ni_CacheEntry;
    
     /* Remove all layout specific data
      * (i.e. displayable bitmaps, pen allocations, etc.)
@@ -66,6 +69,10 @@ extern const IPTR IconDesc[];
     FreeFreeList(&nativeicon->ni_FreeList);
     FreeMem(nativeicon, sizeof(struct NativeIcon));
 
+    /* Copies from the cache share the imagery of the cached icon */
+    if (cacheentry)
+        ReleaseCachedIcon(cacheentry);
+
     AROS_LIBFUNC_EXIT
     
 } /* FreeDiskObject */
@@ -1,5 +1,5 @@
 /*
-    Copyright (C) 1995-2023, The AROS Development Team. All rights reserved.
+    Copyright (C) 1995-2026, The AROS Development Team. All rights reserved.
 */
 
 #include <aros/debug.h>
@@ -9,6 +9,7 @@
 #include "support.h"
 #include "support_builtin.h"
 #include "identify.h"
+#include "iconcache.h"
 
 /*****************************************************************************
 
@@ -51,14 +52,19 @@
     RESULT
 
     NOTES
+        Decoded icons are cached by icon.library, so reading the same
+        icon again is cheap. The returned icon is always private to the
+        caller though, and may be changed as usual.
 
     EXAMPLE
 
     BUGS
 
     SEE ALSO
+        IconControlA()
 
     INTERNALS
+        See iconcache.c for the cache.
 
 *****************************************************************************/
 {
@@ -79,6 +85,7 @@
     STRPTR                label                = NULL; // FIXME: not used
     LONG                 error                 = 0;
     LONG                 *errorCode            = NULL;
+    struct IconCacheEntry *cacheEntry          = NULL;
     
 #   define SET_ISDEFAULTICON(value) (isDefaultIcon != NULL ? *isDefaultIcon = (value) : (value))
 
@@ -134,43 +141,52 @@
         }
     }
     
+    /* The screen is needed early, cached icons may already be laid out */
+    if (generateImageMasks) {
+        /* A side effect of palette mapping the icon... */
+        getPaletteMappedIcon = TRUE;
+    }
+
+    if (getPaletteMappedIcon) {
+        /* A side effect of remapping the icon to the DefaultPubScreen */
+        remapIcon = TRUE;
+    }
+
+    if (remapIcon) {
+        if (screen == NULL)
+            IconControl(NULL, ICONCTRLA_GetGlobalScreen, &screen, TAG_END);
+    } else {
+        screen = NULL;
+    }
+
     if (defaultType != -1 || defaultName != NULL)
     {
-        if (defaultName != NULL)
+        CONST_STRPTR defaultIconName = defaultName;
+
+        if (defaultIconName == NULL)
         {
-            BPTR file = OpenDefaultIcon(defaultName, MODE_OLDFILE);
+            D(bug("[%s] Find default icon type %d\n", __func__, defaultType));
+            defaultIconName = GetDefaultIconName(defaultType);
+        }
+
+        if (defaultIconName != NULL)
+        {
+            BPTR file = OpenDefaultIcon(defaultIconName, MODE_OLDFILE);
             
-            D(bug("[%s] Find default icon '%s'\n", __func__, defaultName));
+            D(bug("[%s] Find default icon '%s'\n", __func__, defaultIconName));
             if (file != BNULL)
             {
-                D(bug("[%s] Found default icon '%s'\n", __func__, defaultName));
-                icon = ReadIcon(file);
+                D(bug("[%s] Found default icon '%s'\n", __func__, defaultIconName));
+                icon = ReadCachedIcon(file, TRUE, screen, (struct TagItem *)tags, &cacheEntry);
                 CloseDefaultIcon(file);
                 SET_ISDEFAULTICON(TRUE);
             }
-        }
 
-        if (icon == NULL && defaultType != -1 && defaultName == NULL)
-        {
-            CONST_STRPTR defaultIconName = GetDefaultIconName(defaultType);
-            
-            D(bug("[%s] Find default icon type %d\n", __func__, defaultType));
-            if (defaultIconName != NULL)
+            if (icon == NULL && defaultName == NULL)
             {
-                icon = GetIconTags
-                (
-                    NULL,
-                    ICONGETA_GetDefaultName, (IPTR) defaultIconName,
-                    TAG_END
-                );
-                D(bug("[%s] Find default icon type %d as %p\n", __func__, defaultType, icon));
-                
-                if (icon == NULL)
-                {
-                    icon = GetBuiltinIcon(defaultType);
-                    D(bug("[%s] Using builtin icon %p\n", __func__, icon));
-                    SET_ISDEFAULTICON(TRUE);
-                }
+                icon = GetBuiltinIcon(defaultType);
+                D(bug("[%s] Using builtin icon %p\n", __func__, icon));
+                SET_ISDEFAULTICON(TRUE);
             }
         }
     }
@@ -182,7 +198,7 @@
         if (file != BNULL)
         {
             D(bug("[%s] Found custom icon '%s'\n", __func__, name));
-            icon = ReadIcon(file);
+            icon = ReadCachedIcon(file, FALSE, screen, (struct TagItem *)tags, &cacheEntry);
             CloseIcon(file);
             
             if (icon != NULL && icon->do_Type == 0)
@@ -319,28 +335,13 @@
         /* TODO: Add the label specified in 'label' to the icon */
     }
 
-    if (generateImageMasks) {
-        D(bug("[%s] %p: Generate image masks\n", __func__, icon));
-        /* A side effect of palette mapping the icon... */
-        getPaletteMappedIcon = TRUE;
-    }
-
-    if (getPaletteMappedIcon) {
-        D(bug("[%s] %p: Generate palette mapped icon\n", __func__, icon));
-        /* A side effect of remapping the icon to the DefaultPubScreen */
-        remapIcon = TRUE;
-    }
-
-    if (remapIcon) {
-        if (screen == NULL)
-            IconControl(NULL, ICONCTRLA_GetGlobalScreen, &screen, TAG_END);
-    } else {
-        screen = NULL;
-    }
-
     /* Any last-minute fixups */
     PrepareIcon(icon);
 
+    /* A freshly read icon goes to the cache, the caller gets a copy */
+    if (cacheEntry != NULL)
+        icon = AddCachedIcon(cacheEntry, icon, screen, (struct TagItem *)tags);
+
     D(bug("[%s] %p: Performing initial layout for screen %p\n", __func__, icon, screen));
     LayoutIconA(icon, screen, (struct TagItem *)tags);
 
@@ -1,5 +1,5 @@
 /*
-    Copyright (C) 1995-2017, The AROS Development Team. All rights reserved.
+    Copyright (C) 1995-2026, The AROS Development Team. All rights reserved.
 
 */
 
@@ -13,6 +13,7 @@
 
 #include "icon_intern.h"
 #include "identify.h"
+#include "iconcache.h"
 
 #include LC_LIBDEFS_FILE
 
@@ -51,6 +52,8 @@ static int GM_UNIQUENAME(Init)(LIBBASETYPEPTR lh)
     LB(lh)->ib_ColorIconSupport     = TRUE;
 
     IconBase = LB(lh);
+
+    InitIconCache();
     
     UtilityBase = OpenLibrary("utility.library", 0);
     if (UtilityBase != NULL) {
@@ -75,6 +78,9 @@ static int GM_UNIQUENAME(Init)(LIBBASETYPEPTR lh)
 
 static int GM_UNIQUENAME(Expunge)(LIBBASETYPEPTR LIBBASE)
 {
+    /* Before dropping the libraries it needs */
+    FlushIconCache();
+
     /* Drop optional libraries */
     if (LIBBASE->ib_CyberGfxBase)  CloseLibrary(LIBBASE->ib_CyberGfxBase);
     if (LIBBASE->ib_DataTypesBase) CloseLibrary(LIBBASE->ib_DataTypesBase);
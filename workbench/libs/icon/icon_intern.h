@@ -2,7 +2,7 @@
 #define ICON_INTERN_H
 
 /*
-    Copyright  1995-2013, The AROS Development Team. All rights reserved.
+    Copyright  1995-2026, The AROS Development Team. All rights reserved.
     $Id$
 */
 
@@ -47,6 +47,15 @@
 #define ICONLIST_HASHSIZE 256
 #endif
 
+/* Decoded icon cache, see iconcache.c. The hash size must be a power of 2 */
+#ifdef __mc68000
+#define ICONCACHE_HASHSIZE      16
+#define ICONCACHE_DEFAULTSIZE   (256 * 1024)
+#else
+#define ICONCACHE_HASHSIZE      64
+#define ICONCACHE_DEFAULTSIZE   (4 * 1024 * 1024)
+#endif
+
 /****************************************************************************************/
 
 /* 
@@ -134,6 +143,13 @@ struct NativeIcon
          */
         struct Image   Render;
     } ni_Image[2];
+
+    /* Icons handed out by the cache share the decoded imagery
+     * and ni_Extra of the cached icon, and its layout while
+     * ni_SharedLayout is set.
+     */
+    struct IconCacheEntry *ni_CacheEntry;
+    BOOL              ni_SharedLayout;
 };
 
 #define RSS_OLDDRAWERDATA_READ  (1 << 0)
@@ -167,6 +183,15 @@ struct IconBase
     BOOL                    ib_ColorIconSupport;
     BPTR                    ib_SegList;
 
+    /* Decoded icon cache --------------------------------------------------*/
+    struct SignalSemaphore  ib_CacheLock;
+    struct MinList          ib_CacheHash[ICONCACHE_HASHSIZE];
+    struct MinList          ib_CacheLRU;        /* Least recently used first */
+    ULONG                   ib_CacheSize;       /* Bytes used by non-default icons */
+    ULONG                   ib_CacheMaxSize;
+    ULONG                   ib_CacheHits;
+    ULONG                   ib_CacheMisses;
+
     /* Required External libraries */
     APTR                    ib_DOSBase;
     APTR                    ib_GfxBase;
@@ -0,0 +1,462 @@
+/*
+    Copyright (C) 2026, The AROS Development Team. All rights reserved.
+
+    Cache of decoded icons.
+*/
+
+/*
+ * Decoding an icon (PNG inflating in particular) and laying it out for a
+ * screen is expensive, and the same icons are read over and over by
+ * Workbench, file requesters and docks. So the first time an icon file is
+ * read, the icon is kept here and callers get a copy of it.
+ *
+ * A copy is a normal DiskObject with its own strings, tooltypes and
+ * drawer data, so it can be changed and freed as usual. Only the decoded
+ * imagery and ni_Extra are shared with the cached icon, plus its screen
+ * layout when the copy was laid out for the same screen (ni_SharedLayout).
+ * The cached icon is only dropped once no copies of it are left.
+ *
+ * Icons are looked up by the full path of the .info file, and only used
+ * while its DateStamp and size are unchanged. The layout of an icon that
+ * is no longer used is freed, so the next user may lay it out for any
+ * screen. Unused icons are dropped, least recently used first, while the
+ * cache is larger than ib_CacheMaxSize. Default icons are few and used
+ * all the time, they are always cached and not counted.
+ */
+
+#include <aros/debug.h>
+
+#include <exec/memory.h>
+#include <dos/dos.h>
+#include <workbench/icon.h>
+
+#include "icon_intern.h"
+#include "support.h"
+#include "iconcache.h"
+
+#define ICEF_DEFAULT    (1 << 0)    /* Default icon, not counted or evicted */
+#define ICEF_STALE      (1 << 1)    /* No longer cached, freed when released */
+
+struct IconCacheEntry
+{
+    struct MinNode      ice_HashNode;
+    struct MinNode      ice_LRUNode;
+    struct DiskObject  *ice_Icon;       /* Never handed out itself */
+    ULONG               ice_UseCount;   /* Number of copies */
+    ULONG               ice_Size;       /* Estimated memory use */
+    ULONG               ice_Hash;
+    UWORD               ice_Flags;
+    struct DateStamp    ice_Date;
+    LONG                ice_FileSize;
+    TEXT                ice_Path[1];
+};
+
+#define HASHNODE2ENTRY(node) \
+    ((struct IconCacheEntry *)((UBYTE *)(node) - offsetof(struct IconCacheEntry, ice_HashNode)))
+#define LRUNODE2ENTRY(node) \
+    ((struct IconCacheEntry *)((UBYTE *)(node) - offsetof(struct IconCacheEntry, ice_LRUNode)))
+
+/* FNV-1 over the lower case path, AmigaDOS names are not case sensitive */
+static ULONG HashPath(CONST_STRPTR path, struct IconBase *IconBase)
+{
+    ULONG hash = 2166136261UL;
+
+    while (*path)
+    {
+        hash *= 16777619UL;
+        hash ^= (UBYTE)ToLower(*path++);
+    }
+
+    return hash;
+}
+
+static ULONG EstimateSize(struct NativeIcon *ni)
+{
+    ULONG area = ni->ni_Face.Width * ni->ni_Face.Height;
+    ULONG size = sizeof(struct NativeIcon) + ni->ni_Extra.Size;
+    int i;
+
+    for (i = 0; i < 2; i++)
+    {
+        struct NativeIconImage *image = &ni->ni_Image[i];
+
+        if (image->ARGB)
+            size += area * sizeof(ULONG);
+        if (image->ImageData)
+            size += area;
+        if (image->Palette)
+            size += image->Pens * sizeof(struct ColorRegister);
+    }
+
+    return size;
+}
+
+/* Make an entry for an opened .info file, not yet in the cache */
+static struct IconCacheEntry *NewEntry(BPTR file, BOOL examine, struct IconBase *IconBase)
+{
+    struct IconCacheEntry *entry;
+    struct FileInfoBlock  *fib;
+    TEXT                   path[256];
+    ULONG                  length;
+
+    if (!NameFromFH(file, path, sizeof(path)))
+        return NULL;
+
+    length = strlen(path);
+    entry = AllocVec(sizeof(struct IconCacheEntry) + length, MEMF_PUBLIC | MEMF_CLEAR);
+    if (entry == NULL)
+        return NULL;
+
+    CopyMem(path, entry->ice_Path, length + 1);
+    entry->ice_Hash = HashPath(path, IconBase);
+
+    if (examine)
+    {
+        fib = AllocDosObject(DOS_FIB, NULL);
+        if (fib == NULL || !ExamineFH(file, fib))
+        {
+            if (fib)
+                FreeDosObject(DOS_FIB, fib);
+            FreeVec(entry);
+            return NULL;
+        }
+
+        entry->ice_Date     = fib->fib_Date;
+        entry->ice_FileSize = fib->fib_Size;
+        FreeDosObject(DOS_FIB, fib);
+    }
+
+    return entry;
+}
+
+static VOID DisposeEntry(struct IconCacheEntry *entry, struct IconBase *IconBase)
+{
+    if (entry->ice_Icon)
+        FreeDiskObject(entry->ice_Icon);
+    FreeVec(entry);
+}
+
+/* Take an entry out of the cache. Must hold ib_CacheLock */
+static VOID UnlinkEntry(struct IconCacheEntry *entry, struct IconBase *IconBase)
+{
+    Remove((struct Node *)&entry->ice_HashNode);
+    Remove((struct Node *)&entry->ice_LRUNode);
+
+    if (!(entry->ice_Flags & ICEF_DEFAULT))
+        IconBase->ib_CacheSize -= entry->ice_Size;
+
+    if (entry->ice_UseCount == 0)
+        DisposeEntry(entry, IconBase);
+    else
+        entry->ice_Flags |= ICEF_STALE;
+}
+
+/* Drop unused icons until the cache fits. Must hold ib_CacheLock */
+static VOID TrimCache(struct IconBase *IconBase)
+{
+    struct MinNode *node, *next;
+
+    ForeachNodeSafe(&IconBase->ib_CacheLRU, node, next)
+    {
+        struct IconCacheEntry *entry = LRUNODE2ENTRY(node);
+
+        if (IconBase->ib_CacheSize <= IconBase->ib_CacheMaxSize)
+            break;
+
+        if (entry->ice_UseCount == 0 && !(entry->ice_Flags & ICEF_DEFAULT))
+        {
+            D(bug("[%s] Dropping '%s'\n", __func__, entry->ice_Path));
+            UnlinkEntry(entry, IconBase);
+        }
+    }
+}
+
+/* Find the entry of a path, dropping it if outdated. Must hold ib_CacheLock */
+static struct IconCacheEntry *FindEntry(struct IconCacheEntry *key, struct IconBase *IconBase)
+{
+    struct MinNode *node, *next;
+
+    ForeachNodeSafe(&IconBase->ib_CacheHash[key->ice_Hash & (ICONCACHE_HASHSIZE - 1)], node, next)
+    {
+        struct IconCacheEntry *entry = HASHNODE2ENTRY(node);
+
+        if (entry->ice_Hash != key->ice_Hash || Stricmp(entry->ice_Path, key->ice_Path) != 0)
+            continue;
+
+        if (CompareDates(&entry->ice_Date, &key->ice_Date) == 0 &&
+            entry->ice_FileSize == key->ice_FileSize)
+        {
+            return entry;
+        }
+
+        D(bug("[%s] '%s' has changed\n", __func__, entry->ice_Path));
+        UnlinkEntry(entry, IconBase);
+        break;
+    }
+
+    return NULL;
+}
+
+/* Hand out a copy of a cached icon. Must hold ib_CacheLock */
+static struct DiskObject *CopyIcon(struct IconCacheEntry *entry, struct Screen *screen,
+    struct TagItem *tags, struct IconBase *IconBase)
+{
+    struct NativeIcon *master = NATIVEICON(entry->ice_Icon);
+    struct NativeIcon *ni;
+    struct DiskObject *icon;
+    struct TagItem     duptags[] =
+    {
+        { ICONDUPA_DuplicateImageData, FALSE },
+        { TAG_DONE,                    0     }
+    };
+    BOOL shared;
+    int i;
+
+    /* Nobody uses the layout, so it can be moved to this screen */
+    if (entry->ice_UseCount == 0)
+        LayoutIconA(entry->ice_Icon, screen, tags);
+
+    icon = DupDiskObjectA(entry->ice_Icon, duptags);
+    if (icon == NULL)
+        return NULL;
+
+    ni = NATIVEICON(icon);
+    shared = (screen != NULL && master->ni_Screen == screen);
+
+    ni->ni_IsDefault = master->ni_IsDefault;
+    ni->ni_Frameless = master->ni_Frameless;
+    ni->ni_ScaleBox  = master->ni_ScaleBox;
+    ni->ni_Face      = master->ni_Face;
+    ni->ni_Extra     = master->ni_Extra;
+
+    for (i = 0; i < 2; i++)
+    {
+        struct NativeIconImage *src = &master->ni_Image[i];
+        struct NativeIconImage *dst = &ni->ni_Image[i];
+
+        dst->TransparentColor = src->TransparentColor;
+        dst->Pens             = src->Pens;
+        dst->Palette          = src->Palette;
+        dst->ImageData        = src->ImageData;
+        dst->ARGB             = src->ARGB;
+
+        if (shared)
+        {
+            dst->Pen     = src->Pen;
+            dst->BitMap  = src->BitMap;
+            dst->BitMask = src->BitMask;
+            dst->ARGBMap = src->ARGBMap;
+        }
+    }
+
+    if (shared)
+    {
+        ni->ni_Screen = master->ni_Screen;
+        ni->ni_Width  = master->ni_Width;
+        ni->ni_Height = master->ni_Height;
+        CopyMem(master->ni_Pens, ni->ni_Pens, sizeof(ni->ni_Pens));
+        ni->ni_SharedLayout = TRUE;
+    }
+
+    ni->ni_CacheEntry = entry;
+    entry->ice_UseCount++;
+
+    return icon;
+}
+
+/****************************************************************************************/
+
+VOID __InitIconCache_WB(struct IconBase *IconBase)
+{
+    int i;
+
+    InitSemaphore(&IconBase->ib_CacheLock);
+    for (i = 0; i < ICONCACHE_HASHSIZE; i++)
+        NewList((struct List *)&IconBase->ib_CacheHash[i]);
+    NewList((struct List *)&IconBase->ib_CacheLRU);
+
+    IconBase->ib_CacheSize    = 0;
+    IconBase->ib_CacheMaxSize = ICONCACHE_DEFAULTSIZE;
+    IconBase->ib_CacheHits    = 0;
+    IconBase->ib_CacheMisses  = 0;
+}
+
+/*
+ * Read an icon from an opened .info file. A cached icon is returned as
+ * a copy, sharing the layout for the screen if possible. Otherwise the
+ * icon is read from the file, and *newEntry is set if it should be
+ * passed to AddCachedIcon() once it is ready.
+ */
+struct DiskObject *__ReadCachedIcon_WB(BPTR file, BOOL isDefault, struct Screen *screen,
+    struct TagItem *tags, struct IconCacheEntry **newEntry, struct IconBase *IconBase)
+{
+    struct IconCacheEntry *key = NULL, *entry;
+    struct DiskObject     *icon = NULL;
+
+    *newEntry = NULL;
+
+    if (isDefault || IconBase->ib_CacheMaxSize > 0)
+        key = NewEntry(file, TRUE, IconBase);
+
+    if (key != NULL)
+    {
+        ObtainSemaphore(&IconBase->ib_CacheLock);
+
+        entry = FindEntry(key, IconBase);
+        if (entry != NULL)
+        {
+            IconBase->ib_CacheHits++;
+            Remove((struct Node *)&entry->ice_LRUNode);
+            AddTail((struct List *)&IconBase->ib_CacheLRU, (struct Node *)&entry->ice_LRUNode);
+
+            icon = CopyIcon(entry, screen, tags, IconBase);
+        }
+        else
+        {
+            IconBase->ib_CacheMisses++;
+        }
+
+        ReleaseSemaphore(&IconBase->ib_CacheLock);
+
+        if (entry == NULL)
+        {
+            if (isDefault)
+                key->ice_Flags |= ICEF_DEFAULT;
+            *newEntry = key;
+        }
+        else
+        {
+            FreeVec(key);
+        }
+
+        D(bug("[%s] %s\n", __func__, icon ? "Hit" : "Miss"));
+    }
+
+    if (icon == NULL)
+    {
+        icon = ReadIcon(file);
+        if (icon == NULL && *newEntry != NULL)
+        {
+            FreeVec(*newEntry);
+            *newEntry = NULL;
+        }
+    }
+
+    return icon;
+}
+
+/*
+ * Put an icon returned by ReadCachedIcon() into the cache, and return
+ * a copy for the caller instead. If that fails, the icon itself is
+ * returned and stays private.
+ */
+struct DiskObject *__AddCachedIcon_WB(struct IconCacheEntry *entry, struct DiskObject *icon,
+    struct Screen *screen, struct TagItem *tags, struct IconBase *IconBase)
+{
+    struct DiskObject *copy;
+
+    /* Decode the imagery now, so that all copies share it */
+    FetchIconARGB(icon, 0);
+    FetchIconARGB(icon, 1);
+
+    entry->ice_Icon = icon;
+    entry->ice_Size = EstimateSize(NATIVEICON(icon));
+
+    ObtainSemaphore(&IconBase->ib_CacheLock);
+
+    copy = CopyIcon(entry, screen, tags, IconBase);
+    if (copy != NULL)
+    {
+        AddHead((struct List *)&IconBase->ib_CacheHash[entry->ice_Hash & (ICONCACHE_HASHSIZE - 1)],
+            (struct Node *)&entry->ice_HashNode);
+        AddTail((struct List *)&IconBase->ib_CacheLRU, (struct Node *)&entry->ice_LRUNode);
+
+        if (!(entry->ice_Flags & ICEF_DEFAULT))
+        {
+            IconBase->ib_CacheSize += entry->ice_Size;
+            TrimCache(IconBase);
+        }
+    }
+
+    ReleaseSemaphore(&IconBase->ib_CacheLock);
+
+    if (copy == NULL)
+    {
+        FreeVec(entry);
+        return icon;
+    }
+
+    return copy;
+}
+
+/* Called by FreeDiskObject() for copies */
+VOID __ReleaseCachedIcon_WB(struct IconCacheEntry *entry, struct IconBase *IconBase)
+{
+    ObtainSemaphore(&IconBase->ib_CacheLock);
+
+    if (--entry->ice_UseCount == 0)
+    {
+        if (entry->ice_Flags & ICEF_STALE)
+        {
+            DisposeEntry(entry, IconBase);
+        }
+        else
+        {
+            /* Don't hold on to the pens and bitmaps of the screen */
+            LayoutIconA(entry->ice_Icon, NULL, NULL);
+            TrimCache(IconBase);
+        }
+    }
+
+    ReleaseSemaphore(&IconBase->ib_CacheLock);
+}
+
+/* Forget the cached icon of a .info file that is being written */
+VOID __ForgetCachedIcon_WB(BPTR file, struct IconBase *IconBase)
+{
+    struct IconCacheEntry *key;
+    struct MinNode        *node, *next;
+
+    key = NewEntry(file, FALSE, IconBase);
+    if (key == NULL)
+        return;
+
+    ObtainSemaphore(&IconBase->ib_CacheLock);
+
+    ForeachNodeSafe(&IconBase->ib_CacheHash[key->ice_Hash & (ICONCACHE_HASHSIZE - 1)], node, next)
+    {
+        struct IconCacheEntry *entry = HASHNODE2ENTRY(node);
+
+        if (entry->ice_Hash == key->ice_Hash && Stricmp(entry->ice_Path, key->ice_Path) == 0)
+            UnlinkEntry(entry, IconBase);
+    }
+
+    ReleaseSemaphore(&IconBase->ib_CacheLock);
+
+    FreeVec(key);
+}
+
+/* Drop all icons, those in use are freed when their last copy is */
+VOID __FlushIconCache_WB(struct IconBase *IconBase)
+{
+    struct MinNode *node, *next;
+
+    ObtainSemaphore(&IconBase->ib_CacheLock);
+
+    ForeachNodeSafe(&IconBase->ib_CacheLRU, node, next)
+    {
+        UnlinkEntry(LRUNODE2ENTRY(node), IconBase);
+    }
+
+    ReleaseSemaphore(&IconBase->ib_CacheLock);
+}
+
+VOID __SetIconCacheSize_WB(ULONG size, struct IconBase *IconBase)
+{
+    ObtainSemaphore(&IconBase->ib_CacheLock);
+
+    IconBase->ib_CacheMaxSize = size;
+    TrimCache(IconBase);
+
+    ReleaseSemaphore(&IconBase->ib_CacheLock);
+}
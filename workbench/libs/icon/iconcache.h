@@ -0,0 +1,34 @@
+#ifndef _ICONCACHE_H_
+#define _ICONCACHE_H_
+
+/*
+    Copyright (C) 2026, The AROS Development Team. All rights reserved.
+
+    Cache of decoded icons.
+*/
+
+#include "icon_intern.h"
+
+/*** Prototypes *************************************************************/
+VOID __InitIconCache_WB(struct IconBase *IconBase);
+struct DiskObject *__ReadCachedIcon_WB(BPTR file, BOOL isDefault, struct Screen *screen,
+    struct TagItem *tags, struct IconCacheEntry **newEntry, struct IconBase *IconBase);
+struct DiskObject *__AddCachedIcon_WB(struct IconCacheEntry *entry, struct DiskObject *icon,
+    struct Screen *screen, struct TagItem *tags, struct IconBase *IconBase);
+VOID __ReleaseCachedIcon_WB(struct IconCacheEntry *entry, struct IconBase *IconBase);
+VOID __ForgetCachedIcon_WB(BPTR file, struct IconBase *IconBase);
+VOID __FlushIconCache_WB(struct IconBase *IconBase);
+VOID __SetIconCacheSize_WB(ULONG size, struct IconBase *IconBase);
+
+/*** Macros *****************************************************************/
+#define InitIconCache() (__InitIconCache_WB(LB(IconBase)))
+#define ReadCachedIcon(file, isDefault, screen, tags, newEntry) \
+    (__ReadCachedIcon_WB((file), (isDefault), (screen), (tags), (newEntry), LB(IconBase)))
+#define AddCachedIcon(entry, icon, screen, tags) \
+    (__AddCachedIcon_WB((entry), (icon), (screen), (tags), LB(IconBase)))
+#define ReleaseCachedIcon(entry) (__ReleaseCachedIcon_WB((entry), LB(IconBase)))
+#define ForgetCachedIcon(file) (__ForgetCachedIcon_WB((file), LB(IconBase)))
+#define FlushIconCache() (__FlushIconCache_WB(LB(IconBase)))
+#define SetIconCacheSize(size) (__SetIconCacheSize_WB((size), LB(IconBase)))
+
+#endif /* _ICONCACHE_H_ */
@@ -1,5 +1,5 @@
 /*
-    Copyright (C) 1995-2007, The AROS Development Team. All rights reserved.
+    Copyright (C) 1995-2026, The AROS Development Team. All rights reserved.
 */
 
 #include <exec/types.h>
@@ -8,6 +8,7 @@
 #include <proto/icon.h>
 
 #include "icon_intern.h"
+#include "iconcache.h"
 
 #   include <aros/debug.h>
 
@@ -34,6 +35,10 @@
         Number of processed tags.
 
     NOTES
+        ICONCTRLA_SetGlobalCacheSize, ICONCTRLA_FlushGlobalCache,
+        ICONCTRLA_GetGlobalCacheHits and ICONCTRLA_GetGlobalCacheMisses
+        control the cache of decoded icons used by GetIconTagList().
+        Changing the scale box, NewIcons or color icon support flushes it.
 
     EXAMPLE
 
@@ -161,6 +166,8 @@
                 break;
                 
             case ICONCTRLA_SetGlobalNewIconsSupport:
+                if (LB(IconBase)->ib_NewIconsSupport != (BOOL)tag->ti_Data)
+                    FlushIconCache();
                 LB(IconBase)->ib_NewIconsSupport = tag->ti_Data;
                 processed++;
                 SET_ERRORCODE(0);
@@ -172,6 +179,8 @@
                 break;
                 
             case ICONCTRLA_SetGlobalColorIconSupport:
+                if (LB(IconBase)->ib_ColorIconSupport != (BOOL)tag->ti_Data)
+                    FlushIconCache();
                 LB(IconBase)->ib_ColorIconSupport = tag->ti_Data;
                 processed++;
                 SET_ERRORCODE(0);
@@ -183,6 +192,8 @@
                 break;
 
             case ICONCTRLA_SetGlobalScaleBox:
+                if (LB(IconBase)->ib_ScaleBox != (ULONG)tag->ti_Data)
+                    FlushIconCache();
                 LB(IconBase)->ib_ScaleBox = (ULONG)tag->ti_Data;
                 processed++;
                 break;
@@ -191,6 +202,34 @@
                 STORE((ULONG *) tag->ti_Data, LB(IconBase)->ib_ScaleBox);
                 processed++;
                 break;
+
+            case ICONCTRLA_SetGlobalCacheSize:
+                SetIconCacheSize((ULONG)tag->ti_Data);
+                processed++;
+                SET_ERRORCODE(0);
+                break;
+
+            case ICONCTRLA_GetGlobalCacheSize:
+                STORE((ULONG *) tag->ti_Data, LB(IconBase)->ib_CacheMaxSize);
+                processed++;
+                break;
+
+            case ICONCTRLA_FlushGlobalCache:
+                if (tag->ti_Data)
+                    FlushIconCache();
+                processed++;
+                SET_ERRORCODE(0);
+                break;
+
+            case ICONCTRLA_GetGlobalCacheHits:
+                STORE((ULONG *) tag->ti_Data, LB(IconBase)->ib_CacheHits);
+                processed++;
+                break;
+
+            case ICONCTRLA_GetGlobalCacheMisses:
+                STORE((ULONG *) tag->ti_Data, LB(IconBase)->ib_CacheMisses);
+                processed++;
+                break;
             
             
             /* Local tags --------------------------------------------------*/
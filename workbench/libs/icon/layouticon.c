@@ -1,5 +1,5 @@
 /*
-    Copyright (C) 1995-2007, The AROS Development Team. All rights reserved.
+    Copyright (C) 1995-2026, The AROS Development Team. All rights reserved.
 */
 
 #include <aros/debug.h>
@@ -96,6 +96,17 @@ static void ScaleRect(ULONG *Target, const ULONG *Source, int SrcWidth, int SrcH
     if (screen == ni->ni_Screen)
         return TRUE;
 
+    /* A layout shared with the cached icon is not ours to free */
+    if (ni->ni_SharedLayout) {
+        for (i = 0; i < 2; i++) {
+            ni->ni_Image[i].Pen     = NULL;
+            ni->ni_Image[i].BitMap  = NULL;
+            ni->ni_Image[i].BitMask = NULL;
+            ni->ni_Image[i].ARGBMap = NULL;
+        }
+        ni->ni_SharedLayout = FALSE;
+    }
+
     for (i = 0; i < 2; i++) {
         struct NativeIconImage *image = &ni->ni_Image[i];
 
@@ -107,6 +118,7 @@ static void ScaleRect(ULONG *Target, const ULONG *Source, int SrcWidth, int SrcH
         if (image->ARGBMap && image->ARGBMap != image->ARGB) {
             FreeVec(image->ARGBMap);
         }
+        image->ARGBMap = NULL;
 
         if (image->Pen) {
             for (j = 0; j < image->Pens; j++) {
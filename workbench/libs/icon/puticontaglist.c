@@ -1,5 +1,5 @@
 /*
-    Copyright (C) 1995-2014, The AROS Development Team. All rights reserved.
+    Copyright (C) 1995-2026, The AROS Development Team. All rights reserved.
 */
 
 #include <aros/debug.h>
@@ -9,6 +9,7 @@
 #include <proto/workbench.h>
 
 #include "icon_intern.h"
+#include "iconcache.h"
 
 /*****************************************************************************
 
@@ -115,6 +116,7 @@
         
         if (file != BNULL)
         {
+            ForgetCachedIcon(file);
             success = WriteIcon(file, icon, tags);
             if (!success)
                 error = IoErr();
@@ -126,6 +128,7 @@
         BPTR file = OpenIcon(name, onlyUpdatePosition ? MODE_OLDFILE : MODE_NEWFILE);
         if (file != BNULL)
         {
+            ForgetCachedIcon(file);
             success = WriteIcon(file, icon, tags);
             if (!success)
                 error = IoErr();
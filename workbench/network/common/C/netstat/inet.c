@@ -223,6 +223,12 @@ tcp_stats(off, name)
 		"\t%d segment%s updated rtt (of %d attempt%s)\n");
 	p(tcps_rexmttimeo, "\t%d retransmit timeout%s\n");
 	p(tcps_timeoutdrop, "\t\t%d connection%s dropped by rexmit timeout\n");
+	p(tcps_fastrecovery, "\t%d fast recovery episode%s\n");
+	p(tcps_sack_recovery, "\t\t%d of them SACK based\n");
+	p2(tcps_sack_rexmits, tcps_sack_rexmit_bytes,
+		"\t\t%d segment rexmit%s in SACK recovery (%d byte%s)\n");
+	p(tcps_sack_rcvblocks, "\t%d SACK block%s received\n");
+	p(tcps_sack_sndblocks, "\t%d SACK block%s sent\n");
 	p(tcps_persisttimeo, "\t%d persist timeout%s\n");
 	p(tcps_keeptimeo, "\t%d keepalive timeout%s\n");
 	p(tcps_keepprobe, "\t\t%d keepalive probe%s sent\n");
@@ -272,6 +278,39 @@ udp_stats(off, name)
 #undef p
 }
 
+/*
+ * Dump PCB lookup statistics structure.
+ */
+void
+pcb_stats(off, name)
+	u_long off;
+	char *name;
+{
+	struct inpcbstat pcbstat;
+
+	if (off == 0)
+		return;
+	kread(off, (char *)&pcbstat, sizeof (pcbstat));
+	printf("%s:\n", name);
+#define	p(f, m) if (pcbstat.f || sflag <= 1) \
+    printf(m, pcbstat.f, plural(pcbstat.f))
+#define	p1(f, m) if (pcbstat.f || sflag <= 1) \
+    printf(m, pcbstat.f)
+	p(pcbs_lookups, "\t%lu lookup%s\n");
+	p1(pcbs_hashhits, "\t\t%lu found in the connection hash\n");
+	p1(pcbs_wildhits, "\t\t%lu found in the listen hash\n");
+	p1(pcbs_misses, "\t\t%lu not found\n");
+	p(pcbs_compares, "\t%lu PCB%s compared\n");
+	p1(pcbs_maxchain, "\t%lu PCBs on the longest chain walked\n");
+	p(pcbs_portallocs, "\t%lu port%s allocated\n");
+	p1(pcbs_porttries, "\t\t%lu tried\n");
+	p1(pcbs_portfails, "\t\t%lu time(s) no port was free\n");
+	printf("\t%lu PCB%s in %lu hash buckets\n", pcbstat.pcbs_pcbs,
+	    plural(pcbstat.pcbs_pcbs), pcbstat.pcbs_hashsize);
+#undef p
+#undef p1
+}
+
 /*
  * Dump IP statistics structure.
  */
@@ -160,6 +160,10 @@ struct nlist nl[] = {
 	{ "_mrttable" },
 #define N_VIFTABLE	30
 	{ "_viftable" },
+#define N_TCPPCBSTAT	31
+	{ "_tcppcbstat" },
+#define N_UDPPCBSTAT	32
+	{ "_udppcbstat" },
 	"",
 };
 
@@ -175,6 +179,10 @@ struct protox {
 	  tcp_stats,	"tcp" },
 	{ N_UDB,	N_UDPSTAT,	1,	protopr,
 	  udp_stats,	"udp" },
+	{ -1,		N_TCPPCBSTAT,	1,	0,
+	  pcb_stats,	"tcppcb" },
+	{ -1,		N_UDPPCBSTAT,	1,	0,
+	  pcb_stats,	"udppcb" },
 	{ -1,		N_IPSTAT,	1,	0,
 	  ip_stats,	"ip" },
 	{ -1,		N_ICMPSTAT,	1,	0,
@@ -64,6 +64,7 @@ char	*plurales __P((int));
 void	protopr __P((u_long, char *));
 void	tcp_stats __P((u_long, char *));
 void	udp_stats __P((u_long, char *));
+void	pcb_stats __P((u_long, char *));
 void	ip_stats __P((u_long, char *));
 void	icmp_stats __P((u_long, char *));
 void	igmp_stats __P((u_long, char *));
@@ -0,0 +1,55 @@
+#ifndef BSDSOCKET_EVENTSET_H
+#define BSDSOCKET_EVENTSET_H
+/*
+ * Copyright (C) 2026, The AROS Development Team. All rights reserved.
+ *
+ *       Definitions for the socket event set functions
+ *       CreateSocketEventSet(), ModifySocketEventSet(),
+ *       WaitSocketEventSet() and DeleteSocketEventSet()
+ *       (bsdsocket.library 4.60)
+ */
+
+#include <exec/types.h>
+
+/*
+ * An event set is a persistent list of sockets and the FD_* events
+ * (see <sys/socket.h>) the caller is interested in. Unlike WaitSelect()
+ * the sockets are registered only once, and WaitSocketEventSet() only
+ * looks at the sockets that had some activity since the last call.
+ *
+ * FD_ERROR and FD_CLOSE are always reported, whether asked for or not.
+ * FD_ACCEPT is reported for listening sockets with pending connections,
+ * FD_READ for sockets with data, a pending error or end of file, and
+ * FD_WRITE for sockets with room in the send buffer.
+ */
+
+/*
+ * One event, passed to ModifySocketEventSet() and returned by
+ * WaitSocketEventSet()
+ */
+struct SocketEvent {
+  LONG	se_Socket;		/* descriptor, filled in by the wait */
+  ULONG	se_Events;		/* FD_* events and SEVF_* flags */
+  IPTR	se_UserData;		/* returned as is by the wait */
+};
+
+/*
+ * Flags in se_Events for ModifySocketEventSet()
+ *
+ * Without SEVF_EDGE an event is reported by every wait for as long as
+ * the condition holds. With SEVF_EDGE it is reported once for every
+ * change on the socket, so the caller should read or write until it
+ * gets EWOULDBLOCK before it waits again. SEVF_ONESHOT disables the
+ * socket after one report until it is modified with SEVOP_MODIFY.
+ */
+#define SEVF_EDGE	0x80000000
+#define SEVF_ONESHOT	0x40000000
+
+/*
+ * Operations for ModifySocketEventSet()
+ */
+#define SEVOP_ADD	1	/* add a socket to the set */
+#define SEVOP_MODIFY	2	/* change events and user data */
+#define SEVOP_REMOVE	3	/* remove a socket from the set */
+
+#endif /* !BSDSOCKET_EVENTSET_H */
@@ -0,0 +1,38 @@
+#ifndef BSDSOCKET_SENDFILE_H
+#define BSDSOCKET_SENDFILE_H
+/*
+ * Copyright (C) 2026, The AROS Development Team. All rights reserved.
+ *
+ *       Definitions for the send functions that do not copy the data
+ *       through a buffer of the caller, SendNoCopy() and SendFile()
+ *       (bsdsocket.library 4.61)
+ */
+
+#include <exec/types.h>
+#include <exec/nodes.h>
+
+/*
+ * SendNoCopy() queues the caller's buffer on the socket itself instead
+ * of a copy of it. The buffer must not be changed or freed until the
+ * stack is done with it: when all the data has been acknowledged by
+ * the peer, or dropped with the connection. The stack then sets
+ * sc_Done and sends sc_Signals to sc_Task.
+ *
+ * This may happen long after the socket has been closed. If the
+ * library is closed before, no signal is sent, and the buffer must
+ * not be freed until the process exits.
+ */
+struct SendCompletion {
+  struct MinNode sc_Node;	/* free for use by the caller */
+  struct Task *	sc_Task;	/* task to signal, or NULL */
+  ULONG		sc_Signals;	/* signal mask for sc_Task */
+  volatile LONG	sc_Done;	/* set when the buffer is free again */
+  IPTR		sc_UserData;	/* not used by the stack */
+};
+
+/*
+ * SendFile() length to send everything up to the end of the file
+ */
+#define SENDFILE_EOF	(-1)
+
+#endif /* !BSDSOCKET_SENDFILE_H */
@@ -8,6 +8,8 @@
 #include <aros/libcall.h>
 #include <sys/types.h>
 #include <sys/select.h>
+#include <bsdsocket/eventset.h>
+#include <bsdsocket/sendfile.h>
 /* Stub macros for 'emulation' of some functions */
 #define select(nfds,rfds,wfds,efds,timeout) WaitSelect(nfds,rfds,wfds,efds,timeout,NULL)
 #define inet_ntoa(addr) Inet_NtoA(((struct in_addr)addr).s_addr)
@@ -259,6 +261,44 @@ AROS_LP1(LONG, GetSocketEvents,
          AROS_LPA(ULONG *, eventsp, A0),
          LIBBASETYPEPTR, SocketBase, 50, BSDSocket
 );
+AROS_LP1(LONG, CreateSocketEventSet,
+         AROS_LPA(ULONG, flags, D0),
+         LIBBASETYPEPTR, SocketBase, 51, BSDSocket
+);
+AROS_LP4(LONG, ModifySocketEventSet,
+         AROS_LPA(LONG, set, D0),
+         AROS_LPA(LONG, op, D1),
+         AROS_LPA(LONG, sd, D2),
+         AROS_LPA(struct SocketEvent *, event, A0),
+         LIBBASETYPEPTR, SocketBase, 52, BSDSocket
+);
+AROS_LP5(LONG, WaitSocketEventSet,
+         AROS_LPA(LONG, set, D0),
+         AROS_LPA(struct SocketEvent *, events, A0),
+         AROS_LPA(LONG, maxevents, D1),
+         AROS_LPA(struct timeval *, timeout, A1),
+         AROS_LPA(ULONG *, sigmp, A2),
+         LIBBASETYPEPTR, SocketBase, 53, BSDSocket
+);
+AROS_LP1(LONG, DeleteSocketEventSet,
+         AROS_LPA(LONG, set, D0),
+         LIBBASETYPEPTR, SocketBase, 54, BSDSocket
+);
+AROS_LP5(LONG, SendNoCopy,
+         AROS_LPA(LONG, s, D0),
+         AROS_LPA(APTR, buf, A0),
+         AROS_LPA(LONG, len, D1),
+         AROS_LPA(LONG, flags, D2),
+         AROS_LPA(struct SendCompletion *, sc, A1),
+         LIBBASETYPEPTR, SocketBase, 55, BSDSocket
+);
+AROS_LP4(LONG, SendFile,
+         AROS_LPA(LONG, s, D0),
+         AROS_LPA(BPTR, file, D1),
+         AROS_LPA(LONG, len, D2),
+         AROS_LPA(LONG, flags, D3),
+         LIBBASETYPEPTR, SocketBase, 56, BSDSocket
+);
 
 /* RoadShow Extensions .. */
 #if defined(__CONFIG_ROADSHOW__)
@@ -484,6 +484,74 @@
 #define GetSocketEvents(arg1) \
     __GetSocketEvents_WB(SocketBase, (arg1))
 
+#define __CreateSocketEventSet_WB(__SocketBase, __arg1) \
+        AROS_LC1(LONG, CreateSocketEventSet, \
+                  AROS_LCA(ULONG,(__arg1),D0), \
+        struct Library *, (__SocketBase), 51, BSDSocket)
+
+#define CreateSocketEventSet(arg1) \
+    __CreateSocketEventSet_WB(SocketBase, (arg1))
+
+#define __ModifySocketEventSet_WB(__SocketBase, __arg1, __arg2, __arg3, __arg4) \
+        AROS_LC4(LONG, ModifySocketEventSet, \
+                  AROS_LCA(LONG,(__arg1),D0), \
+                  AROS_LCA(LONG,(__arg2),D1), \
+                  AROS_LCA(LONG,(__arg3),D2), \
+                  AROS_LCA(struct SocketEvent *,(__arg4),A0), \
+        struct Library *, (__SocketBase), 52, BSDSocket)
+
+#define ModifySocketEventSet(arg1, arg2, arg3, arg4) \
+    __ModifySocketEventSet_WB(SocketBase, (arg1), (arg2), (arg3), (arg4))
+
+#define __WaitSocketEventSet_WB(__SocketBase, __arg1, __arg2, __arg3, __arg4, __arg5) \
+        AROS_LC5(LONG, WaitSocketEventSet, \
+                  AROS_LCA(LONG,(__arg1),D0), \
+                  AROS_LCA(struct SocketEvent *,(__arg2),A0), \
+                  AROS_LCA(LONG,(__arg3),D1), \
+                  AROS_LCA(struct timeval *,(__arg4),A1), \
+                  AROS_LCA(ULONG *,(__arg5),A2), \
+        struct Library *, (__SocketBase), 53, BSDSocket)
+
+#ifndef PTHREAD_H
+#define WaitSocketEventSet(arg1, arg2, arg3, arg4, arg5) \
+    __WaitSocketEventSet_WB(SocketBase, (arg1), (arg2), (arg3), (arg4), (arg5))
+#endif
+
+#define __DeleteSocketEventSet_WB(__SocketBase, __arg1) \
+        AROS_LC1(LONG, DeleteSocketEventSet, \
+                  AROS_LCA(LONG,(__arg1),D0), \
+        struct Library *, (__SocketBase), 54, BSDSocket)
+
+#define DeleteSocketEventSet(arg1) \
+    __DeleteSocketEventSet_WB(SocketBase, (arg1))
+
+#define __SendNoCopy_WB(__SocketBase, __arg1, __arg2, __arg3, __arg4, __arg5) \
+        AROS_LC5(LONG, SendNoCopy, \
+                  AROS_LCA(LONG,(__arg1),D0), \
+                  AROS_LCA(APTR,(__arg2),A0), \
+                  AROS_LCA(LONG,(__arg3),D1), \
+                  AROS_LCA(LONG,(__arg4),D2), \
+                  AROS_LCA(struct SendCompletion *,(__arg5),A1), \
+        struct Library *, (__SocketBase), 55, BSDSocket)
+
+#ifndef PTHREAD_H
+#define SendNoCopy(arg1, arg2, arg3, arg4, arg5) \
+    __SendNoCopy_WB(SocketBase, (arg1), (arg2), (arg3), (arg4), (arg5))
+#endif
+
+#define __SendFile_WB(__SocketBase, __arg1, __arg2, __arg3, __arg4) \
+        AROS_LC4(LONG, SendFile, \
+                  AROS_LCA(LONG,(__arg1),D0), \
+                  AROS_LCA(BPTR,(__arg2),D1), \
+                  AROS_LCA(LONG,(__arg3),D2), \
+                  AROS_LCA(LONG,(__arg4),D3), \
+        struct Library *, (__SocketBase), 56, BSDSocket)
+
+#ifndef PTHREAD_H
+#define SendFile(arg1, arg2, arg3, arg4) \
+    __SendFile_WB(SocketBase, (arg1), (arg2), (arg3), (arg4))
+#endif
+
 #if defined(__CONFIG_ROADSHOW__)
 
 /* RoadShow Extensions .. */
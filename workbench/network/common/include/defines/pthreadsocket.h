@@ -42,6 +42,11 @@
 #undef WaitSelect
 #endif
 #define WaitSelect(...) (pthread_testcancel(), __WaitSelect_WB(SocketBase, __VA_ARGS__))
+
+#ifdef WaitSocketEventSet
+#undef WaitSocketEventSet
+#endif
+#define WaitSocketEventSet(...) (pthread_testcancel(), __WaitSocketEventSet_WB(SocketBase, __VA_ARGS__))
 #endif
 
 #ifdef send
@@ -59,4 +64,14 @@
 #endif
 #define sendto(...) (pthread_testcancel(), __sendto_WB(SocketBase, __VA_ARGS__))
 
+#ifdef SendNoCopy
+#undef SendNoCopy
+#endif
+#define SendNoCopy(...) (pthread_testcancel(), __SendNoCopy_WB(SocketBase, __VA_ARGS__))
+
+#ifdef SendFile
+#undef SendFile
+#endif
+#define SendFile(...) (pthread_testcancel(), __SendFile_WB(SocketBase, __VA_ARGS__))
+
 #endif /* PTHREAD_SOCKET_H */
@@ -206,6 +206,13 @@
 #define	IPPORT_RESERVED		1024
 #define	IPPORT_USERRESERVED	5000
 
+/*
+ * Ports assigned to sockets that are not bound explicitly are taken
+ * from the dynamic range (RFC 6335).
+ */
+#define	IPPORT_HIFIRSTAUTO	49152
+#define	IPPORT_HILASTAUTO	65535
+
 /*
  * Internet address (a structure for historical reasons)
  */
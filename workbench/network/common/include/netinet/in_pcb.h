@@ -49,7 +49,8 @@ LIST_HEAD(inpcbhead, inpcb);
 
 struct inpcb {
 	LIST_ENTRY(inpcb) inp_list;		/* list for all PCBs of this proto */
-	LIST_ENTRY(inpcb) inp_hash;		/* hash list */
+	LIST_ENTRY(inpcb) inp_hash;		/* connection or listen hash list */
+	LIST_ENTRY(inpcb) inp_porthash;		/* local port hash list */
 	struct	inpcbinfo *inp_pcbinfo;
 	struct	in_addr inp_faddr;	/* foreign host table entry */
 	u_short	inp_fport;		/* foreign port */
@@ -64,19 +65,54 @@ struct inpcb {
 	struct	ip_moptions *inp_moptions; /* IP multicast options */
 };
 
+/*
+ * PCB lookup statistics, one set per protocol.
+ */
+struct inpcbstat {
+	u_long	pcbs_lookups;		/* lookups for input packets */
+	u_long	pcbs_hashhits;		/* found in the connection hash */
+	u_long	pcbs_wildhits;		/* found in the listen hash */
+	u_long	pcbs_misses;		/* not found */
+	u_long	pcbs_compares;		/* PCBs compared in those lookups */
+	u_long	pcbs_maxchain;		/* longest hash chain walked */
+	u_long	pcbs_portallocs;	/* ephemeral ports allocated */
+	u_long	pcbs_porttries;		/* ports tried for them */
+	u_long	pcbs_portfails;		/* no ephemeral port was free */
+	u_long	pcbs_pcbs;		/* PCBs in the hash tables */
+	u_long	pcbs_hashsize;		/* buckets in the connection hash */
+};
+
+/*
+ * Every PCB with a local port is in two hash tables: the connection
+ * hash by both addresses and ports if it is connected, or the listen
+ * hash by the local port if it is not, and the port hash by the local
+ * port. Input looks in the connection hash first and then in the
+ * listen hash; binding and port allocation use the port hash.
+ */
 struct inpcbinfo {
 	struct inpcbhead *listhead;
-	struct inpcbhead *hashbase;
+	struct inpcbhead *hashbase;	/* connection hash */
 	unsigned long hashsize;
+	struct inpcbhead *wildbase;	/* listen hash */
+	unsigned long wildsize;
+	struct inpcbhead *porthashbase;	/* port hash */
+	unsigned long porthashsize;
 	unsigned short lastport;
+	struct inpcbstat *stat;
 };
 
+#define	INP_PCBHASH(faddr, fport, laddr, lport, size) \
+	(((((u_int32_t)(faddr) * 31) + (u_int32_t)(laddr)) * 31 + \
+	  ((u_int32_t)(fport) << 16 | (u_int32_t)(lport))) % (size))
+#define	INP_PORTHASH(lport, size)	((u_int32_t)(lport) % (size))
+
 /* flags in inp_flags: */
 #define	INP_RECVOPTS		0x01	/* receive incoming IP options */
 #define	INP_RECVRETOPTS		0x02	/* receive IP options for reply */
 #define	INP_RECVDSTADDR		0x04	/* receive IP dst address */
 #define	INP_CONTROLOPTS		(INP_RECVOPTS|INP_RECVRETOPTS|INP_RECVDSTADDR)
 #define	INP_HDRINCL		0x08	/* user supplies entire IP header */
+#define	INP_INHASH		0x100	/* in the hash tables */
 
 #ifdef sotorawcb		/* defined in net/raw_cb.h */
 /*
@@ -111,11 +147,13 @@ void	 in_pcbinshash __P((struct inpcb *));
 int	 in_pcbladdr __P((struct inpcb *, struct mbuf *,
 	    struct sockaddr_in **));
 struct inpcb *
-	 in_pcblookup __P((struct inpcbhead *,
+	 in_pcblookup __P((struct inpcbinfo *,
 	    struct in_addr, u_int, struct in_addr, u_int, int));
 struct inpcb *
 	 in_pcblookuphash __P((struct inpcbinfo *,
-	    struct in_addr, u_int, struct in_addr, u_int));
+	    struct in_addr, u_int, struct in_addr, u_int, int));
+void	 in_pcbinfo_init __P((struct inpcbinfo *, struct inpcbhead *,
+	    struct inpcbstat *, int, int, int));
 void	 in_pcbnotify __P((struct inpcbhead *, struct sockaddr *,
 	    u_int, struct in_addr, u_int, int, void (*)(struct inpcb *, int)));
 void	 in_pcbrehash __P((struct inpcb *));
@@ -40,6 +40,18 @@
  * Kernel variables for tcp.
  */
 
+/*
+ * A range of sequence space, as carried in a SACK option.
+ */
+struct sackblk {
+	tcp_seq	start;			/* first sequence number */
+	tcp_seq	end;			/* sequence number after the block */
+};
+
+#define	TCP_SACK_SCOREBOARD	8	/* SACK blocks kept by the sender */
+
+struct tcp_cc_algo;
+
 /*
  * Tcp control block, one per tcp; fields:
  */
@@ -53,7 +65,7 @@ struct tcpcb {
 	u_short	t_maxseg;		/* maximum segment size */
 	u_short	t_maxopd;		/* mss plus options */
 	char	t_force;		/* 1 if forcing out a byte */
-	u_short	t_flags;
+	u_int	t_flags;
 #define	TF_ACKNOW	0x0001		/* ack peer immediately */
 #define	TF_DELACK	0x0002		/* ack, but try to delay it */
 #define	TF_NODELAY	0x0004		/* don't delay packets to coalesce */
@@ -69,6 +81,8 @@ struct tcpcb {
 #define TF_NOPUSH	0x1000		/* don't push */
 #define TF_REQ_CC	0x2000		/* have/will request CC */
 #define	TF_RCVD_CC	0x4000		/* a CC was received in SYN */
+#define	TF_REQ_SACK	0x8000		/* have/will request SACK */
+#define	TF_FASTRECOVERY	0x10000		/* in fast recovery after a loss */
 
 	struct	tcpiphdr *t_template;	/* skeletal packet for transmit */
 	struct	inpcb *t_inpcb;		/* back pointer to internet pcb */
@@ -136,6 +150,19 @@ struct tcpcb {
 	tcp_cc	cc_send;		/* send connection count */
 	tcp_cc	cc_recv;		/* receive connection count */
 	u_long	t_duration;		/* connection duration */
+/* RFC 2018 variables */
+	struct	sackblk rcv_sack[MAX_SACK_BLKS]; /* blocks to report, newest first */
+	short	rcv_numsacks;		/* number of blocks in rcv_sack */
+	short	snd_numsacks;		/* number of blocks in snd_sack */
+	struct	sackblk snd_sack[TCP_SACK_SCOREBOARD]; /* blocks sacked by peer,
+					 * in ascending order */
+	tcp_seq	sack_rxtnext;		/* next lost byte to retransmit */
+/* congestion control */
+	struct	tcp_cc_algo *t_cc;	/* congestion control algorithm */
+	u_long	t_cubic_wmax;		/* CUBIC: window before last reduction */
+	u_long	t_cubic_k;		/* CUBIC: time to regain it (ms) */
+	u_long	t_cubic_epoch;		/* CUBIC: start of this epoch (ms) */
+	u_long	t_cubic_west;		/* CUBIC: estimated Reno window */
 
 /* TUBA stuff */
 	caddr_t	t_tuba_pcb;		/* next level down pcb for TCP over z */
@@ -153,12 +180,23 @@ struct tcpopt {
 #define TOF_CC		0x0002		/* CC and CCnew are exclusive */
 #define TOF_CCNEW	0x0004
 #define	TOF_CCECHO	0x0008
+#define	TOF_SACK	0x0010		/* SACK blocks */
 	u_int32_t	to_tsval;
 	u_int32_t	to_tsecr;
 	tcp_cc	to_cc;		/* holds CC or CCnew */
 	tcp_cc	to_ccecho;
+	int	to_nsacks;		/* number of SACK blocks */
+	u_char	*to_sacks;		/* pointer to the first SACK block */
 };
 
+/*
+ * SACK is used when both ends asked for it in their SYNs.
+ */
+#define	TCP_DO_SACK(tp) \
+	(((tp)->t_flags & (TF_REQ_SACK|TF_SACK_PERMIT)) == \
+	    (TF_REQ_SACK|TF_SACK_PERMIT))
+#define	IN_FASTRECOVERY(tp)	((tp)->t_flags & TF_FASTRECOVERY)
+
 /*
  * The TAO cache entry which is stored in the protocol family specific
  * portion of the route metrics.
@@ -277,6 +315,13 @@ struct	tcpstat {
 	u_long	tcps_predack;		/* times hdr predict ok for acks */
 	u_long	tcps_preddat;		/* times hdr predict ok for data pkts */
 	u_long	tcps_pcbcachemiss;
+
+	u_long	tcps_fastrecovery;	/* fast recovery episodes */
+	u_long	tcps_sack_recovery;	/* of which SACK based */
+	u_long	tcps_sack_rexmits;	/* segments retransmitted from holes */
+	u_long	tcps_sack_rexmit_bytes;	/* bytes retransmitted from holes */
+	u_long	tcps_sack_rcvblocks;	/* SACK blocks received */
+	u_long	tcps_sack_sndblocks;	/* SACK blocks sent */
 };
 
 /*
@@ -291,7 +336,9 @@ struct	tcpstat {
 #define	TCPCTL_KEEPINTVL	7	/* interval to send keepalives */
 #define	TCPCTL_SENDSPACE	8	/* send buffer space */
 #define	TCPCTL_RECVSPACE	9	/* receive buffer space */
-#define TCPCTL_MAXID		10
+#define	TCPCTL_DO_SACK		10	/* use RFC-2018 selective acks */
+#define	TCPCTL_CC		11	/* congestion control algorithm */
+#define TCPCTL_MAXID		12
 
 #define TCPCTL_NAMES { \
 	{ 0, 0 }, \
@@ -304,14 +351,19 @@ struct	tcpstat {
 	{ "keepintvl", CTLTYPE_INT }, \
 	{ "sendspace", CTLTYPE_INT }, \
 	{ "recvspace", CTLTYPE_INT }, \
+	{ "sack", CTLTYPE_INT }, \
+	{ "cc", CTLTYPE_INT }, \
 }
 
 #ifdef KERNEL
 extern	struct inpcbhead tcb;		/* head of queue of active tcpcb's */
 extern	struct inpcbinfo tcbinfo;
 extern	struct tcpstat tcpstat;	/* tcp statistics */
+extern	struct inpcbstat tcppcbstat;	/* tcp PCB lookup statistics */
 extern	int tcp_do_rfc1323;	/* XXX */
 extern	int tcp_do_rfc1644;	/* XXX */
+extern	int tcp_do_sack;
+extern	int tcp_cc_default;	/* index into tcp_cc_algos */
 extern	int tcp_mssdflt;	/* XXX */
 extern	u_long tcp_now;		/* for RFC 1323 timestamps */
 extern	int tcp_rttdflt;	/* XXX */
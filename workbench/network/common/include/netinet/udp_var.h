@@ -91,6 +91,7 @@ struct	udpstat {
 extern struct	inpcbhead udb;
 extern struct	inpcbinfo udbinfo;
 extern struct	udpstat udpstat;
+extern struct	inpcbstat udppcbstat;
 
 void	 udp_ctlinput __P((int, struct sockaddr *, void *));
 void	 udp_init __P((void));
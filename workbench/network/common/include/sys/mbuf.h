@@ -122,18 +122,27 @@ struct m_hdr {
 /* record/packet header in first mbuf of chain; valid if M_PKTHDR set */
 struct	pkthdr {
 	int	len;		/* total packet length */
+	u_int	csum_data;	/* partial checksum, see M_CSUM_* */
 	struct	ifnet *rcvif;	/* rcv interface */
 	/* variables for ip and tcp reassembly */
 	caddr_t header;                 /* pointer to packet header */	
 };
 
+/*
+ * Reference counted external storage that is not a cluster, such as a
+ * buffer an application lends to the stack. mr_free is called with
+ * mbuf_lock held when the last mbuf referencing the storage is freed.
+ */
+struct mextref {
+	long	mr_refcnt;		/* reference count */
+	void	(*mr_free) __P((struct mextref *));
+};
+
 /* description of external storage mapped into mbuf, valid if M_EXT set */
 struct m_ext {
 	struct mcluster *ext_buf;	/* external buffer */
-#if 0					/* Not used in AmiTCP/IP */
-	void	(*ext_free)();		/* free routine if not the usual */
-#endif
-	u_int	ext_size;		/* size of buffer, for ext_free */
+	struct mextref *ext_ref;	/* other storage, ext_buf is unused */
+	u_int	ext_size;		/* size of buffer */
 };
 
 struct mbuf {
@@ -174,8 +183,13 @@ struct mbuf {
 /* mbuf pkthdr flags, also in m_flags */
 #define	M_BCAST		0x0100	/* send/received as link-level broadcast */
 #define	M_MCAST		0x0200	/* send/received as link-level multicast */
+#define	M_CSUM_DATA	0x0400	/* csum_data is the sum of the data as sent */
+#define	M_CSUM_RCVD	0x0800	/* csum_data is the sum of the packet as received */
 
-/* flags copied when copying m_pkthdr */
+/*
+ * flags copied when copying m_pkthdr; the M_CSUM_* flags are not, as
+ * the copy is usually of other data
+ */
 #ifdef USE_M_EOR
 #define	M_COPYFLAGS	(M_PKTHDR|M_EOR|M_BCAST|M_MCAST)
 #else
@@ -214,21 +228,27 @@ struct mbuf {
  *	MGETHDR(struct mbuf *m, int canwait, int type)
  * allocates an mbuf and initializes it to contain a packet header
  * and internal data.
+ *
+ * The free lists are protected by mbuf_lock instead of splimp(), so
+ * allocating and freeing mbufs doesn't wait for protocol processing.
+ * mbuf_lock must not be held while raising the spl-level.
  */
 #define	MGET(m, canwait, type) { \
-	spl_t ms = splimp(); \
+	netlock_obtain(&mbuf_lock); \
         (m) = mfree; \
 	if (m) { \
 		mfree = (m)->m_next; \
-		(m)->m_type = (type); \
 		mbstat.m_mtypes[type]++; \
+		netlock_release(&mbuf_lock); \
+		(m)->m_type = (type); \
 		(m)->m_next = NULL; \
 		(m)->m_nextpkt = NULL; \
 		(m)->m_data = (m)->m_dat; \
 		(m)->m_flags = 0; \
-	} else \
+	} else { \
+		netlock_release(&mbuf_lock); \
 		(m) = m_retry((canwait), (type)); \
-	splx(ms); \
+	} \
 }
 
 #define	MGETHDR(m, canwait, type) { \
@@ -249,7 +269,7 @@ struct mbuf {
  */
 
 #define	MCLALLOC(p, canwait) \
-	{ spl_t ms = splimp(); \
+	{ netlock_obtain(&mbuf_lock); \
 	  if (mclfree == 0) \
 		(void)m_clalloc(mbconf.clusterchunk, (canwait)); \
 	  if ((p) = mclfree) { \
@@ -257,7 +277,7 @@ struct mbuf {
 		mclfree = (p)->mcl.mcl_next; \
 		(p)->mcl.mcl_refcnt = 1; \
 	  } \
-	  splx(ms); \
+	  netlock_release(&mbuf_lock); \
 	}
 
 #define	MCLGET(m, canwait) \
@@ -266,18 +286,35 @@ struct mbuf {
 		(m)->m_data = (m)->m_ext.ext_buf->mcl_buf; \
 		(m)->m_flags |= M_EXT; \
 		(m)->m_ext.ext_size = mbconf.mclbytes; \
-/*	        (m)->m_ext.ext_free = mcl_free_routine; */ \
+		(m)->m_ext.ext_ref = NULL; \
 	  } \
 	}
 
 #define	MCLFREE(p) \
-	{ spl_t ms = splimp(); \
+	{ netlock_obtain(&mbuf_lock); \
 	  if (--((p)->mcl.mcl_refcnt) == 0) { \
 		(p)->mcl.mcl_next = mclfree; \
 		mclfree = (p); \
 		mbstat.m_clfree++; \
 	  } \
-	  splx(ms); \
+	  netlock_release(&mbuf_lock); \
+	}
+
+/*
+ * MEXTREF adds a reference to storage other than a cluster, MEXTFREE
+ * releases one and calls the free routine when none are left.
+ */
+#define	MEXTREF(r) \
+	{ netlock_obtain(&mbuf_lock); \
+	  (r)->mr_refcnt++; \
+	  netlock_release(&mbuf_lock); \
+	}
+
+#define	MEXTFREE(r) \
+	{ netlock_obtain(&mbuf_lock); \
+	  if (--((r)->mr_refcnt) == 0) \
+		(*(r)->mr_free)(r); \
+	  netlock_release(&mbuf_lock); \
 	}
 
 /*
@@ -286,18 +323,17 @@ struct mbuf {
  * Place the successor, if any, in n.
  */
 #define	MFREE(m, n) \
-	{ spl_t ms = splimp(); \
+	{ netlock_obtain(&mbuf_lock); \
 	  mbstat.m_mtypes[(m)->m_type]--; \
 	  if ((m)->m_flags & M_EXT) { \
-/*		if ((m)->m_ext.ext_free) */ \
-/*			(*((m)->m_ext.ext_free))((m)->m_ext.ext_buf, */ \
-/*			    (m)->m_ext.ext_size); */ \
-/*		else */ \
+		if ((m)->m_ext.ext_ref) \
+			MEXTFREE((m)->m_ext.ext_ref) \
+		else \
 			MCLFREE((m)->m_ext.ext_buf); \
 	  } \
 	  (n) = (m)->m_next; \
 	  (m)->m_next = mfree; mfree = (m); \
-	  splx(ms); \
+	  netlock_release(&mbuf_lock); \
 	}
 
 /*
@@ -334,11 +370,13 @@ struct mbuf {
 
 /*
  * Compute the amount of space available
- * after the end of data in an mbuf.
+ * after the end of data in an mbuf. Storage
+ * that is not a cluster is never written to.
  */
 #define	M_TRAILINGSPACE(m) \
-	((m)->m_flags & M_EXT ? (m)->m_ext.ext_buf->mcl_buf + (m)->m_ext.ext_size - \
-	    ((m)->m_data + (m)->m_len) : \
+	((m)->m_flags & M_EXT ? ((m)->m_ext.ext_ref ? 0 : \
+	    (m)->m_ext.ext_buf->mcl_buf + (m)->m_ext.ext_size - \
+	    ((m)->m_data + (m)->m_len)) : \
 	    &(m)->m_dat[MLEN] - ((m)->m_data + (m)->m_len))
 
 /*
@@ -404,6 +442,7 @@ struct mbstat {
  * in kern/uipc_mbuf.c
  */
 extern struct mcluster *mclfree;
+extern struct netlock  mbuf_lock;	/* protects mfree, mclfree & mbstat */
 extern struct mbconf   mbconf;
 extern struct mbstat   mbstat;
 extern int             max_linkhdr;	/* largest link-level header */
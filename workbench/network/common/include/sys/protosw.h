@@ -125,6 +125,7 @@ struct protosw {
 #define	PR_WANTRCVD	0x08		/* want PRU_RCVD calls */
 #define	PR_RIGHTS	0x10		/* passes capabilities */
 #define PR_IMPLOPCL	0x20		/* implied open/close */
+#define	PR_CKSUMDATA	0x40		/* wants the sum of sent data, M_CSUM_DATA */
 
 /*
  * The arguments to usrreq are:
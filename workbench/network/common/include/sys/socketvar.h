@@ -68,6 +68,7 @@
 #endif
 
 struct newselitem;
+struct eventreg;
 
 /*
  * Kernel structure per socket.
@@ -118,7 +119,7 @@ struct socket {
 		short	sb_flags;	     /* flags, see below */
 		struct timeval sb_timeo;     /* timeout for read/write */
 	} so_rcv, so_snd;
-#define	SB_MAX		(64*1024)	/* default for max chars in sockbuf */
+#define	SB_MAX		(1024*1024)	/* default for max chars in sockbuf */
 #define	SB_LOCK		0x01		/* lock on data queue */
 #define	SB_WANT		0x02		/* someone is waiting to lock */
 #define	SB_WAIT		0x04		/* someone is waiting for data/space */
@@ -129,6 +130,7 @@ struct socket {
 #define	SB_NOINTR	0x40		/* operations not interruptible */
 
 	u_long so_eventmask;		/* Events mask */
+	struct eventreg *so_evregs;	/* event set registrations */
 	caddr_t	so_tpcb;		/* Wisc. protocol control block XXX */
 };
 
@@ -44,6 +44,7 @@
 
 #include <kern/amiga_subr.h>
 #include <kern/amiga_log.h>
+#include <kern/amiga_eventset_protos.h>
 
 #if 0
 /*#if sizeof (fd_mask) != 4 || sizeof (long) != 4*/
@@ -51,9 +52,9 @@
 #endif
 
 /*
- *  Semaphore to prevent simultaneous access to library functions.
+ *  Lock to prevent simultaneous access to library functions.
  */
-struct SignalSemaphore syscall_semaphore = { {0} };
+struct netlock syscall_lock;
 
 /*
  *  some globals.
@@ -233,6 +234,8 @@ D(bug("[AROSTCP](amiga_api.c) ELL_Open: Created user library base @ 0x%p\n", new
   /* Initialize events list */
   InitSemaphore(&newBase->EventLock);
   NewList((struct List *)&newBase->EventList);
+  NewList((struct List *)&newBase->EventSets);
+  NewList((struct List *)&newBase->LoanList);
 
   /* initialize dtable variables */
 #if 0 /* initialization to zero is implicit */
@@ -375,6 +378,10 @@ D(bug("[AROSTCP](amiga_api.c) __UL_Close: Closing proc 0x%lx base 0x%lx\n", libP
   for (i = 0; i < libPtr->dTableSize; i++)
     if (libPtr->dTable[i] != NULL)
       __CloseSocket(i, libPtr);
+  if (libPtr->EventSets.mlh_Head)
+    eventset_cleanup(libPtr);
+  if (libPtr->LoanList.mlh_Head)
+    __SendLoanCleanup(libPtr);
   
   Remove((struct Node *)libPtr); /* remove this librarybase from our list
 				    of opened library bases */
@@ -495,8 +502,9 @@ D(bug("[AROSTCP](amiga_api.c) api_init: Created MIAMI library base: 0x%p\n", Mas
   if (MasterMiamiBase == NULL)
     return FALSE;
 
-  InitSemaphore(&syscall_semaphore);
+  netlock_init(&syscall_lock, "syscall");
   select_init(); /* initializes data Select() needs */
+  eventset_init();
   NewList(&socketBaseList);
   NewList(&garbageSocketBaseList);
   NewList(&releasedSocketList);
@@ -51,6 +51,10 @@
 #include "sys/queue2.h"
 #endif
 
+#ifndef SYS_SYNCH_H
+#include <sys/synch.h>
+#endif
+
 #ifndef API_RESOLV_H
 #include <api/resolv.h>
 #endif
@@ -154,6 +158,11 @@ struct SocketBase {
 /* -- socket events -- */
   struct SignalSemaphore EventLock;
   struct MinList	EventList;
+/* -- socket event sets -- */
+  struct MinList	EventSets;
+  LONG			lastEventSetId;
+/* -- buffers lent with SendNoCopy(), protected by mbuf_lock -- */
+  struct MinList	LoanList;
 /* -- buffer for string returns -- */
   UBYTE			result_str[REPLYBUFLEN + 1];
 /* -- NetDB pointers for getXXXent() and friends -- */
@@ -174,7 +183,6 @@ struct SocketBase {
  */
 int readErrnoValue(struct SocketBase *);
 
-extern struct SignalSemaphore syscall_semaphore;
 extern struct List releasedSocketList;
 
 /*
@@ -200,7 +208,7 @@ static inline void ObtainSyscallSemaphore(struct SocketBase *libPtr)
 {
   extern struct Task *AROSTCP_Task;
 
-  ObtainSemaphore(&syscall_semaphore);
+  netlock_obtain(&syscall_lock);
   libPtr->myPri = SetTaskPri(libPtr->thisTask,
   libPtr->libCallPri = AROSTCP_Task->tc_Node.ln_Pri);
 }
@@ -210,7 +218,7 @@ static inline void ReleaseSyscallSemaphore(struct SocketBase *libPtr)
   if (libPtr->libCallPri != (libPtr->myPri = SetTaskPri(libPtr->thisTask,
 							libPtr->myPri)))
     SetTaskPri(libPtr->thisTask, libPtr->myPri);
-  ReleaseSemaphore(&syscall_semaphore);
+  netlock_release(&syscall_lock);
 }
 
 /*
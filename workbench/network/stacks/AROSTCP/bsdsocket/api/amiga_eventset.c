@@ -0,0 +1,560 @@
+/*
+ * Copyright (C) 2026 The AROS Dev Team
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place - Suite 330, Boston,
+ * MA 02111-1307, USA.
+ *
+ */
+
+/*
+ * Socket event sets.
+ *
+ * WaitSelect() has to look at every descriptor in the masks twice per
+ * call and put the task on the select chain of every socket again each
+ * time, which makes it O(descriptors) even when only one socket is
+ * ready. An event set instead keeps a registration per socket for as
+ * long as the application wants it. sowakeup() puts the registrations
+ * of the socket on the ready list of their set, and the wait only has
+ * to check the sockets on that list.
+ *
+ * Locking: the registrations and ready lists are protected by
+ * eventset_semaphore. It is obtained while holding the spl lock (the
+ * wakeups come from protocol code at splnet()), so the spl lock must be
+ * obtained first when both are needed.
+ */
+
+#include <conf.h>
+
+#include <aros/asmcall.h>
+#include <aros/libcall.h>
+
+#include <sys/param.h>
+#include <sys/systm.h>
+#include <sys/socketvar.h>
+#include <sys/protosw.h>
+#include <sys/malloc.h>
+#include <sys/synch.h>
+
+#include <sys/time.h>
+#include <sys/errno.h>
+
+#include <sys/socket.h>
+
+#include <kern/amiga_includes.h>
+
+#include <api/amiga_api.h>
+#include <api/amiga_libcallentry.h>
+
+#include <bsdsocket/eventset.h>
+
+#include <kern/amiga_eventset_protos.h>
+
+struct eventset {
+  struct MinNode	es_node;	/* in the EventSets of the owner */
+  LONG			es_id;		/* handle given to the application */
+  struct SocketBase *	es_owner;
+  struct MinList	es_regs;	/* all registrations */
+  struct MinList	es_ready;	/* registrations which may be ready */
+  short			es_state;	/* ES_CLEAR or ES_WAITING */
+};
+
+#define	ES_CLEAR	0		/* nobody waiting */
+#define	ES_WAITING	1		/* owner sleeping on the set */
+
+struct eventreg {
+  struct MinNode	er_node;	/* in es_regs */
+  struct MinNode	er_readynode;	/* in es_ready if ER_QUEUED */
+  struct eventreg *	er_sonext;	/* next registration of the socket */
+  struct eventset *	er_set;
+  struct socket *	er_socket;	/* NULL if the socket has been freed */
+  LONG			er_fd;
+  ULONG			er_events;	/* FD_* events and SEVF_* flags */
+  IPTR			er_userdata;
+  UWORD			er_flags;
+};
+
+#define	ER_QUEUED	0x01		/* on the ready list */
+#define	ER_DISABLED	0x02		/* one shot registration reported */
+
+#define	READYREG(node) \
+  ((struct eventreg *)((caddr_t)(node) - offsetof(struct eventreg, er_readynode)))
+
+/* Events that can be asked for */
+#define	FD_EVENTS	(FD_ACCEPT|FD_OOB|FD_READ|FD_WRITE|FD_ERROR|FD_CLOSE)
+/* Events that are reported whether asked for or not */
+#define	FD_ALWAYS	(FD_ERROR|FD_CLOSE)
+
+static struct SignalSemaphore eventset_semaphore;
+
+void eventset_init(void)
+{
+  InitSemaphore(&eventset_semaphore);
+}
+
+static struct eventset *eventset_find(struct SocketBase *p, LONG id)
+{
+  struct eventset *es;
+
+  for (es = (struct eventset *)p->EventSets.mlh_Head;
+       es->es_node.mln_Succ;
+       es = (struct eventset *)es->es_node.mln_Succ)
+    if (es->es_id == id)
+      return es;
+  return NULL;
+}
+
+/*
+ * Queue a registration on the ready list of its set.
+ * MUST be called with eventset_semaphore held.
+ */
+static void eventreg_queue(struct eventreg *er)
+{
+  if ((er->er_flags & (ER_QUEUED|ER_DISABLED)) == 0) {
+    er->er_flags |= ER_QUEUED;
+    AddTail((struct List *)&er->er_set->es_ready, (struct Node *)&er->er_readynode);
+  }
+}
+
+/*
+ * Remove a registration from its set and its socket.
+ * MUST be called with eventset_semaphore held.
+ */
+static void eventreg_unlink(struct eventreg *er)
+{
+  struct eventreg **erp;
+
+  Remove((struct Node *)&er->er_node);
+  if (er->er_flags & ER_QUEUED)
+    Remove((struct Node *)&er->er_readynode);
+  if (er->er_socket) {
+    for (erp = &er->er_socket->so_evregs; *erp; erp = &(*erp)->er_sonext)
+      if (*erp == er) {
+	*erp = er->er_sonext;
+	break;
+      }
+  }
+}
+
+/*
+ * Called by sowakeup() when something happened on one of the socket
+ * buffers. 'events' are the FD_* events the buffer can cause.
+ */
+void eventset_wakeup(struct socket *so, ULONG events)
+{
+  struct eventreg *er;
+  struct eventset *es;
+
+  if (so->so_error || (so->so_state & SS_CANTRCVMORE))
+    events |= FD_ALWAYS;
+
+  ObtainSemaphore(&eventset_semaphore);
+  for (er = so->so_evregs; er; er = er->er_sonext) {
+    if ((er->er_events & events) == 0 && (events & FD_ALWAYS) == 0)
+      continue;
+    eventreg_queue(er);
+    es = er->er_set;
+    if (es->es_state == ES_WAITING) {
+      es->es_state = ES_CLEAR;
+      wakeup((caddr_t)es);
+    }
+  }
+  ReleaseSemaphore(&eventset_semaphore);
+}
+
+/*
+ * Forget the registrations of a socket which is about to be freed.
+ */
+void eventset_sofree(struct socket *so)
+{
+  struct eventreg *er;
+
+  ObtainSemaphore(&eventset_semaphore);
+  while ((er = so->so_evregs) != NULL) {
+    so->so_evregs = er->er_sonext;
+    er->er_socket = NULL;
+    er->er_sonext = NULL;
+  }
+  ReleaseSemaphore(&eventset_semaphore);
+}
+
+/*
+ * Remove the registrations of a descriptor which is being closed or
+ * released by its owner.
+ */
+void eventset_closefd(struct SocketBase *p, LONG fd, struct socket *so)
+{
+  struct eventreg *er, *next, *dead = NULL;
+  spl_t s;
+
+  s = splnet();
+  ObtainSemaphore(&eventset_semaphore);
+  for (er = so->so_evregs; er; er = next) {
+    next = er->er_sonext;
+    if (er->er_fd == fd && er->er_set->es_owner == p) {
+      eventreg_unlink(er);
+      er->er_sonext = dead;
+      dead = er;
+    }
+  }
+  ReleaseSemaphore(&eventset_semaphore);
+  splx(s);
+
+  while ((er = dead) != NULL) {
+    dead = er->er_sonext;
+    bsd_free(er, M_TEMP);
+  }
+}
+
+static void eventset_free(struct eventset *es)
+{
+  struct eventreg *er;
+  spl_t s;
+
+  s = splnet();
+  ObtainSemaphore(&eventset_semaphore);
+  while ((er = (struct eventreg *)es->es_regs.mlh_Head)->er_node.mln_Succ) {
+    eventreg_unlink(er);
+    bsd_free(er, M_TEMP);
+  }
+  ReleaseSemaphore(&eventset_semaphore);
+  splx(s);
+
+  bsd_free(es, M_TEMP);
+}
+
+/*
+ * Free all event sets of a library base which is being closed.
+ */
+void eventset_cleanup(struct SocketBase *p)
+{
+  struct eventset *es;
+
+  while ((es = (struct eventset *)RemHead((struct List *)&p->EventSets)) != NULL)
+    eventset_free(es);
+}
+
+/*
+ * Current state of a socket as FD_* events.
+ * MUST be called at splnet().
+ */
+static ULONG eventset_poll(struct socket *so)
+{
+  ULONG events = 0;
+
+  if (so->so_options & SO_ACCEPTCONN) {
+    if (so->so_qlen)
+      events |= FD_ACCEPT|FD_READ;
+  }
+  else {
+    if (soreadable(so))
+      events |= FD_READ;
+    if (sowriteable(so))
+      events |= FD_WRITE;
+  }
+  if (so->so_oobmark || (so->so_state & SS_RCVATMARK))
+    events |= FD_OOB;
+  if (so->so_error)
+    events |= FD_ERROR;
+  if (so->so_state & SS_CANTRCVMORE)
+    events |= FD_CLOSE;
+
+  return events;
+}
+
+/*
+ * Check the registrations on the ready list and fill in the events of
+ * those which really are ready. Level triggered registrations stay on
+ * the list (at the end, so that busy sockets do not starve the others)
+ * until a wait finds them not ready.
+ * MUST be called at splnet() with eventset_semaphore held.
+ */
+static LONG eventset_collect(struct SocketBase *p, struct eventset *es,
+			     struct SocketEvent *events, LONG maxevents)
+{
+  struct MinList again;
+  struct MinNode *node;
+  struct eventreg *er;
+  ULONG ready;
+  LONG n = 0;
+
+  NewList((struct List *)&again);
+
+  while (n < maxevents &&
+	 (node = (struct MinNode *)RemHead((struct List *)&es->es_ready)) != NULL) {
+    er = READYREG(node);
+    er->er_flags &= ~ER_QUEUED;
+
+    if (er->er_socket == NULL || p->dTable[er->er_fd] != er->er_socket)
+      continue;
+
+    ready = eventset_poll(er->er_socket) & (er->er_events | FD_ALWAYS) & FD_EVENTS;
+    if (ready == 0)
+      continue;
+
+    events[n].se_Socket = er->er_fd;
+    events[n].se_Events = ready;
+    events[n].se_UserData = er->er_userdata;
+    n++;
+
+    if (er->er_events & SEVF_ONESHOT)
+      er->er_flags |= ER_DISABLED;
+    else if ((er->er_events & SEVF_EDGE) == 0) {
+      er->er_flags |= ER_QUEUED;
+      AddTail((struct List *)&again, (struct Node *)node);
+    }
+  }
+
+  while ((node = (struct MinNode *)RemHead((struct List *)&again)) != NULL)
+    AddTail((struct List *)&es->es_ready, (struct Node *)node);
+
+  return n;
+}
+
+AROS_LH1(LONG, CreateSocketEventSet,
+   AROS_LHA(ULONG, flags, D0),
+   struct SocketBase *, libPtr, 51, UL)
+{
+  AROS_LIBFUNC_INIT
+  struct eventset *es = NULL;
+  int error = 0;
+
+  CHECK_TASK();
+  DSYSCALLS(log(LOG_DEBUG,"CreateSocketEventSet(0x%08lx) called", flags);)
+
+  if (flags != 0) {
+    error = EINVAL;
+    goto Return;
+  }
+  if ((es = bsd_malloc(sizeof (*es), M_TEMP, M_WAITOK)) == NULL) {
+    error = ENOMEM;
+    goto Return;
+  }
+
+  /* handles are never reused, so a stale one cannot hit a new set */
+  do {
+    if (++libPtr->lastEventSetId <= 0)
+      libPtr->lastEventSetId = 1;
+  } while (eventset_find(libPtr, libPtr->lastEventSetId));
+
+  es->es_id = libPtr->lastEventSetId;
+  es->es_owner = libPtr;
+  es->es_state = ES_CLEAR;
+  NewList((struct List *)&es->es_regs);
+  NewList((struct List *)&es->es_ready);
+  AddTail((struct List *)&libPtr->EventSets, (struct Node *)es);
+
+ Return:
+  API_STD_RETURN(error, es->es_id);
+  AROS_LIBFUNC_EXIT
+}
+
+AROS_LH4(LONG, ModifySocketEventSet,
+   AROS_LHA(LONG, set, D0),
+   AROS_LHA(LONG, op, D1),
+   AROS_LHA(LONG, fd, D2),
+   AROS_LHA(struct SocketEvent *, event, A0),
+   struct SocketBase *, libPtr, 52, UL)
+{
+  AROS_LIBFUNC_INIT
+  struct eventset *es;
+  struct eventreg *er, *new = NULL;
+  struct socket *so;
+  spl_t s;
+  int error;
+
+  CHECK_TASK();
+  DSYSCALLS(log(LOG_DEBUG,"ModifySocketEventSet(%ld, %ld, %ld, 0x%08lx) called", set, op, fd, event);)
+
+  if ((es = eventset_find(libPtr, set)) == NULL) {
+    error = EBADF;
+    goto Return;
+  }
+  if ((error = getSock(libPtr, fd, &so)) != 0)
+    goto Return;
+  if (op != SEVOP_REMOVE &&
+      (event == NULL || (event->se_Events & ~(FD_EVENTS|SEVF_EDGE|SEVF_ONESHOT)))) {
+    error = EINVAL;
+    goto Return;
+  }
+  if (op == SEVOP_ADD &&
+      (new = bsd_malloc(sizeof (*new), M_TEMP, M_WAITOK)) == NULL) {
+    error = ENOMEM;
+    goto Return;
+  }
+
+  s = splnet();
+  ObtainSemaphore(&eventset_semaphore);
+
+  for (er = so->so_evregs; er; er = er->er_sonext)
+    if (er->er_set == es && er->er_fd == fd)
+      break;
+
+  switch (op) {
+  case SEVOP_ADD:
+    if (er) {
+      error = EEXIST;
+      break;
+    }
+    er = new;
+    new = NULL;
+    er->er_set = es;
+    er->er_socket = so;
+    er->er_fd = fd;
+    er->er_events = event->se_Events;
+    er->er_userdata = event->se_UserData;
+    er->er_flags = 0;
+    er->er_sonext = so->so_evregs;
+    so->so_evregs = er;
+    AddTail((struct List *)&es->es_regs, (struct Node *)&er->er_node);
+    /* let the next wait find out the current state */
+    eventreg_queue(er);
+    break;
+
+  case SEVOP_MODIFY:
+    if (er == NULL) {
+      error = ENOENT;
+      break;
+    }
+    er->er_events = event->se_Events;
+    er->er_userdata = event->se_UserData;
+    er->er_flags &= ~ER_DISABLED;
+    eventreg_queue(er);
+    break;
+
+  case SEVOP_REMOVE:
+    if (er == NULL) {
+      error = ENOENT;
+      break;
+    }
+    eventreg_unlink(er);
+    new = er;			/* freed below */
+    break;
+
+  default:
+    error = EINVAL;
+    break;
+  }
+
+  ReleaseSemaphore(&eventset_semaphore);
+  splx(s);
+
+  if (new)
+    bsd_free(new, M_TEMP);
+
+ Return:
+  API_STD_RETURN(error, 0);
+  AROS_LIBFUNC_EXIT
+}
+
+AROS_LH5(LONG, WaitSocketEventSet,
+   AROS_LHA(LONG, set, D0),
+   AROS_LHA(struct SocketEvent *, events, A0),
+   AROS_LHA(LONG, maxevents, D1),
+   AROS_LHA(struct timeval *, timeout, A1),
+   AROS_LHA(ULONG *, sigmp, A2),
+   struct SocketBase *, libPtr, 53, UL)
+{
+  AROS_LIBFUNC_INIT
+  struct eventset *es;
+  ULONG sigmask = sigmp ? *sigmp : 0;
+  BOOL timer = FALSE;
+  LONG n = 0;
+  spl_t s;
+  int error = 0;
+
+  CHECK_TASK();
+  DSYSCALLS(log(LOG_DEBUG,"WaitSocketEventSet(%ld, 0x%08lx, %ld, 0x%08lx, 0x%08lx) called", set, events, maxevents, timeout, sigmp);)
+
+  if ((es = eventset_find(libPtr, set)) == NULL) {
+    error = EBADF;
+    goto Return;
+  }
+  if (events == NULL || maxevents <= 0 ||
+      (timeout && (timeout->tv_sec > 100000000 || timeout->tv_usec >= 1000000))) {
+    error = EINVAL;
+    goto Return;
+  }
+
+  s = splnet();
+  ObtainSemaphore(&eventset_semaphore);
+
+  for (;;) {
+    n = eventset_collect(libPtr, es, events, maxevents);
+    if (n > 0 || (timeout && timeout->tv_sec == 0 && timeout->tv_usec == 0))
+      break;
+
+    if (timeout && !timer) {
+      tsleep_send_timeout(libPtr, timeout);
+      timer = TRUE;
+    }
+
+    /*
+     * Get on the sleep queue before letting the wakeups in, so that a
+     * wakeup between the release and the sleep is not lost.
+     */
+    es->es_state = ES_WAITING;
+    tsleep_enter(libPtr, (caddr_t)es, "evset");
+    ReleaseSemaphore(&eventset_semaphore);
+    splx(s);
+
+    error = tsleep_main(libPtr, sigmask);
+
+    s = splnet();
+    ObtainSemaphore(&eventset_semaphore);
+    es->es_state = ES_CLEAR;
+
+    if (error != 0) {
+      /* timeout and user signals are not errors, just as in WaitSelect() */
+      if (error == ERESTART || error == EWOULDBLOCK)
+	error = 0;
+      break;
+    }
+  }
+
+  ReleaseSemaphore(&eventset_semaphore);
+  splx(s);
+
+  if (timer)
+    tsleep_abort_timeout(libPtr, timeout);
+
+  if (error == 0 && sigmp)
+    *sigmp &= SetSignal(0L, sigmask);
+
+ Return:
+  API_STD_RETURN(error, n);
+  AROS_LIBFUNC_EXIT
+}
+
+AROS_LH1(LONG, DeleteSocketEventSet,
+   AROS_LHA(LONG, set, D0),
+   struct SocketBase *, libPtr, 54, UL)
+{
+  AROS_LIBFUNC_INIT
+  struct eventset *es;
+  int error = 0;
+
+  CHECK_TASK();
+  DSYSCALLS(log(LOG_DEBUG,"DeleteSocketEventSet(%ld) called", set);)
+
+  if ((es = eventset_find(libPtr, set)) == NULL) {
+    error = EBADF;
+    goto Return;
+  }
+  Remove((struct Node *)es);
+  eventset_free(es);
+
+ Return:
+  API_STD_RETURN(error, 0);
+  AROS_LIBFUNC_EXIT
+}
@@ -55,6 +55,7 @@
 #include <kern/uipc_domain_protos.h>
 #include <kern/uipc_socket_protos.h>
 #include <kern/uipc_socket2_protos.h>
+#include <kern/amiga_eventset_protos.h>
 
 /* Local protos */
 static int selscan(struct SocketBase *p, 
@@ -382,11 +383,11 @@ LONG __WaitSelect(ULONG nfds, fd_set *readfds, fd_set *writefds, fd_set *exeptfd
 	  newselbuf->s_state = SB_WAITING;
 	  tsleep_enter(libPtr, (caddr_t)newselbuf, "select");
 	  ReleaseSemaphore(&select_semaphore);
-	  /* ReleaseSemaphore(&syscall_semaphore); don't have this */
+	  /* netlock_release(&syscall_lock); don't have this */
 	  
 	  error = tsleep_main(libPtr, sigmask);
 	  
-	  /* ObtainSemaphore(&syscall_semaphore); see above */
+	  /* netlock_obtain(&syscall_lock); see above */
 	  ObtainSemaphore(&select_semaphore);
 	  unselect(newselbuf);
 	  ReleaseSemaphore(&select_semaphore);
@@ -735,6 +736,9 @@ LONG __CloseSocket(LONG fd, struct SocketBase *libPtr)
   if (so->so_pgid == libPtr && countSockets(libPtr, so) == 1) 
     so->so_pgid = NULL;		/* not ours any more */
 
+  if (so->so_evregs)
+    eventset_closefd(libPtr, fd, so);
+
   /*
    * Decrease the reference count of a socket (AmiTCP addition) and return if
    * not zero.
@@ -871,6 +875,8 @@ AROS_LH2(LONG, ReleaseSocket,
     so->so_pgid = NULL;*/	  /* not ours any more */
   sn->sn_Id = id;
   sn->sn_Socket = so;
+  if (so->so_evregs)
+    eventset_closefd(libPtr, fd, so);
   libPtr->dTable[fd] = NULL;
   FD_CLR(fd, (fd_set *)(libPtr->dTable + libPtr->dTableSize));
   
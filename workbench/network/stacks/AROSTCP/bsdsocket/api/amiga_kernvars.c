@@ -16,8 +16,10 @@ struct kernel_var kvars[] = {
 	{ "_ipstat" , &ipstat },
 	{ "_tcb" , &tcb },
 	{ "_tcpstat", &tcpstat },
+	{ "_tcppcbstat", &tcppcbstat },
 	{ "_udb" , &udb },
 	{ "_udpstat" , &udpstat },
+	{ "_udppcbstat" , &udppcbstat },
 	{ "_ifnet" , &ifnet },
 	{ "_icmpstat" , &icmpstat },
 	{ "_rtstat" , &rtstat },
@@ -113,6 +113,16 @@ void AROS_SLIB_ENTRY(SocketBaseTagList, UL, 49)(void);
   /* bsdsocket.library 4 extensions */
 void AROS_SLIB_ENTRY(GetSocketEvents, UL, 50)(void);
 
+  /* bsdsocket.library 4.60 extensions */
+void AROS_SLIB_ENTRY(CreateSocketEventSet, UL, 51)(void);
+void AROS_SLIB_ENTRY(ModifySocketEventSet, UL, 52)(void);
+void AROS_SLIB_ENTRY(WaitSocketEventSet, UL, 53)(void);
+void AROS_SLIB_ENTRY(DeleteSocketEventSet, UL, 54)(void);
+
+  /* bsdsocket.library 4.61 extensions */
+void AROS_SLIB_ENTRY(SendNoCopy, UL, 55)(void);
+void AROS_SLIB_ENTRY(SendFile, UL, 56)(void);
+
 #if defined(__CONFIG_ROADSHOW__)
   /* Roadshow extensions  */
 void AROS_SLIB_ENTRY(bpf_open, UL, 61)(void);
@@ -223,14 +233,18 @@ f_void UserLibrary_funcTable[] = {
   /* bsdsocket.library 4 extensions */
   AROS_SLIB_ENTRY(GetSocketEvents, UL, 50),
 
+  /* bsdsocket.library 4.60 extensions, in slots Roadshow keeps reserved */
+  AROS_SLIB_ENTRY(CreateSocketEventSet, UL, 51),
+  AROS_SLIB_ENTRY(ModifySocketEventSet, UL, 52),
+  AROS_SLIB_ENTRY(WaitSocketEventSet, UL, 53),
+  AROS_SLIB_ENTRY(DeleteSocketEventSet, UL, 54),
+
+  /* bsdsocket.library 4.61 extensions, in slots Roadshow keeps reserved */
+  AROS_SLIB_ENTRY(SendNoCopy, UL, 55),
+  AROS_SLIB_ENTRY(SendFile, UL, 56),
+
 #if defined(__CONFIG_ROADSHOW__)
   /* Roadshow extensions  */
-  AROS_SLIB_ENTRY(Null, LIB, 0),	    /* Reserved1()  */
-  AROS_SLIB_ENTRY(Null, LIB, 0),	    /* Reserved2()  */
-  AROS_SLIB_ENTRY(Null, LIB, 0),	    /* Reserved3()  */
-  AROS_SLIB_ENTRY(Null, LIB, 0),	    /* Reserved4()  */
-  AROS_SLIB_ENTRY(Null, LIB, 0),	    /* Reserved5()  */
-  AROS_SLIB_ENTRY(Null, LIB, 0),	    /* Reserved6()  */
   AROS_SLIB_ENTRY(Null, LIB, 0),	    /* Reserved7()  */
   AROS_SLIB_ENTRY(Null, LIB, 0),	    /* Reserved8()  */
   AROS_SLIB_ENTRY(Null, LIB, 0),	    /* Reserved9()  */
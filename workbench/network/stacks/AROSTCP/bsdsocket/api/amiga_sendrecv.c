@@ -37,6 +37,8 @@
 #include <exec/types.h>
 #include <exec/libraries.h>
 #include <exec/semaphores.h>
+#include <proto/exec.h>
+#include <bsdsocket/sendfile.h>
 
 #include <api/amiga_api.h>
 #include <api/amiga_libcallentry.h>
@@ -46,12 +48,16 @@
 #include <kern/uipc_socket2_protos.h>
   
 #include <sys/uio.h>
+
+#include <stddef.h>
   
 static LONG sendit(struct SocketBase * p,
 		   LONG	s,
 		   struct msghdr * mp,
 		   LONG flags,
-		   LONG * retsize);
+		   LONG * retsize,
+		   int segflg,
+		   void * src);
 
 static LONG recvit(struct SocketBase * p,
 		   LONG s,
@@ -78,7 +84,7 @@ LONG __send(LONG s, caddr_t buf, LONG len, LONG flags, struct SocketBase *libPtr
   aiov.iov_len = len;
   
   ObtainSyscallSemaphore(libPtr);
-  error = sendit(libPtr, s, &msg, flags, &retval);
+  error = sendit(libPtr, s, &msg, flags, &retval, UIO_USERSPACE, NULL);
   ReleaseSyscallSemaphore(libPtr);
   
   API_STD_RETURN(error, retval);
@@ -127,7 +133,7 @@ LONG __sendto(LONG s, caddr_t buf, LONG len, LONG flags, caddr_t to, LONG tolen,
       aiov.iov_len = len;
 
       ObtainSyscallSemaphore(libPtr);
-      error = sendit(libPtr, s, &msg, flags, &retval);
+      error = sendit(libPtr, s, &msg, flags, &retval, UIO_USERSPACE, NULL);
       ReleaseSyscallSemaphore(libPtr);
 #ifdef ENABLE_TTCP_SHUTUP
     }
@@ -169,25 +175,31 @@ AROS_LH3(LONG, sendmsg,
   CHECK_TASK();
   DSYSCALLS(log(LOG_DEBUG,"sendmsg(%ld, msghdr, 0x%08lx) called", s, flags);)
   ObtainSyscallSemaphore(libPtr);
-  error = sendit(libPtr, s, msg_p, flags, &retval);
+  error = sendit(libPtr, s, msg_p, flags, &retval, UIO_USERSPACE, NULL);
   ReleaseSyscallSemaphore(libPtr);
 
   API_STD_RETURN(error, retval);
   AROS_LIBFUNC_EXIT
 }
 
+/*
+ * The data is taken from the iovecs of mp as segflg says, see
+ * <kern/uio.h>.
+ */
 static LONG sendit(struct SocketBase * p,
 		   LONG	s,
 		   struct msghdr * mp,
 		   LONG flags,
-		   LONG * retsize)
+		   LONG * retsize,
+		   int segflg,
+		   void * src)
 {
   struct socket *so;
   struct uio auio;
   register int i;
   register struct iovec *iov;
   struct mbuf *to, *control;
-  LONG len, error;
+  LONG len, left, error;
 
   if (error = getSock(p, s, &so))
     return (error);
@@ -196,6 +208,8 @@ static LONG sendit(struct SocketBase * p,
   auio.uio_iovcnt = mp->msg_iovlen;
   auio.uio_procp = p;
   auio.uio_resid = 0;
+  auio.uio_segflg = segflg;
+  auio.uio_src = src;
   iov = mp->msg_iov;
 
   for(i = 0; i < mp->msg_iovlen; i++, iov++) {
@@ -225,13 +239,16 @@ static LONG sendit(struct SocketBase * p,
     control = 0;
 
   len = auio.uio_resid;
-  if (error = sosend(so, to, &auio, (struct mbuf *)0, control, flags)) {
-    if (auio.uio_resid != len && (error == ERESTART || error == EINTR ||
-				  error == EWOULDBLOCK))
+  error = sosend(so, to, &auio, (struct mbuf *)0, control, flags);
+  /* A file may end before all of it was sent */
+  left = segflg == UIO_DOSFILE ? mp->msg_iov->iov_len : auio.uio_resid;
+  if (error) {
+    if (left != len && (error == ERESTART || error == EINTR ||
+			error == EWOULDBLOCK))
       error = 0;
   }
   if (error == 0)
-    *retsize = len - auio.uio_resid;
+    *retsize = len - left;
 
   /* sosend() frees control if allocated */
  bad:
@@ -241,6 +258,137 @@ static LONG sendit(struct SocketBase * p,
   return (error);
 }
 
+/*
+ * A buffer lent with SendNoCopy(). The mbufs referencing it hold
+ * references to sl_ref, and so does SendNoCopy() while it runs.
+ */
+struct sendloan {
+  struct MinNode	sl_node;	/* in LoanList of the library base */
+  struct mextref	sl_ref;
+  struct SendCompletion *sl_sc;		/* NULL once the library is closed */
+};
+
+/*
+ * Called with mbuf_lock held when the last reference is gone.
+ */
+static void sendloan_free(struct mextref *ref)
+{
+  struct sendloan *sl = (struct sendloan *)((UBYTE *)ref -
+					    offsetof(struct sendloan, sl_ref));
+  struct SendCompletion *sc = sl->sl_sc;
+
+  if (sc) {
+    Remove((struct Node *)&sl->sl_node);
+    sc->sc_Done = TRUE;
+    if (sc->sc_Task)
+      Signal(sc->sc_Task, sc->sc_Signals);
+  }
+  bsd_free(sl, M_TEMP);
+}
+
+/*
+ * Forget the completions of the buffers still lent when the library
+ * base is closed; their task may be gone by the time they complete.
+ */
+void __SendLoanCleanup(struct SocketBase *p)
+{
+  struct sendloan *sl;
+
+  netlock_obtain(&mbuf_lock);
+  while ((sl = (struct sendloan *)RemHead((struct List *)&p->LoanList)))
+    sl->sl_sc = NULL;
+  netlock_release(&mbuf_lock);
+}
+
+AROS_LH5(LONG, SendNoCopy,
+   AROS_LHA(LONG, s, D0),
+   AROS_LHA(APTR, buf, A0),
+   AROS_LHA(LONG, len, D1),
+   AROS_LHA(LONG, flags, D2),
+   AROS_LHA(struct SendCompletion *, sc, A1),
+   struct SocketBase *, libPtr, 55, UL)
+{
+  AROS_LIBFUNC_INIT
+  struct msghdr msg;
+  struct iovec aiov;
+  struct sendloan *sl;
+  LONG error, retval = 0;
+
+  CHECK_TASK();
+  DSYSCALLS(log(LOG_DEBUG,"SendNoCopy(%ld, buf, %ld, 0x%08lx, sc) called", s, len, flags);)
+  if (sc == NULL || len < 0) {
+    error = EINVAL;
+    API_STD_RETURN(error, retval);
+  }
+  if ((sl = bsd_malloc(sizeof (*sl), M_TEMP, M_WAITOK)) == NULL) {
+    error = ENOMEM;
+    API_STD_RETURN(error, retval);
+  }
+  sl->sl_ref.mr_refcnt = 1;
+  sl->sl_ref.mr_free = sendloan_free;
+  sl->sl_sc = sc;
+  sc->sc_Done = FALSE;
+  netlock_obtain(&mbuf_lock);
+  AddTail((struct List *)&libPtr->LoanList, (struct Node *)&sl->sl_node);
+  netlock_release(&mbuf_lock);
+
+  msg.msg_name = 0;
+  msg.msg_namelen = 0;
+  msg.msg_iov = &aiov;
+  msg.msg_iovlen = 1;
+  msg.msg_control = 0;
+  aiov.iov_base = buf;
+  aiov.iov_len = len;
+
+  ObtainSyscallSemaphore(libPtr);
+  error = sendit(libPtr, s, &msg, flags, &retval, UIO_LOAN, &sl->sl_ref);
+  ReleaseSyscallSemaphore(libPtr);
+
+  /*
+   * Completes at once if nothing was queued, or if everything has
+   * already been sent and freed.
+   */
+  MEXTFREE(&sl->sl_ref);
+
+  API_STD_RETURN(error, retval);
+  AROS_LIBFUNC_EXIT
+}
+
+AROS_LH4(LONG, SendFile,
+   AROS_LHA(LONG, s, D0),
+   AROS_LHA(BPTR, file, D1),
+   AROS_LHA(LONG, len, D2),
+   AROS_LHA(LONG, flags, D3),
+   struct SocketBase *, libPtr, 56, UL)
+{
+  AROS_LIBFUNC_INIT
+  struct msghdr msg;
+  struct iovec aiov;
+  LONG error, retval = 0;
+
+  CHECK_TASK();
+  DSYSCALLS(log(LOG_DEBUG,"SendFile(%ld, 0x%08lx, %ld, 0x%08lx) called", s, file, len, flags);)
+  if (file == BNULL || len < SENDFILE_EOF) {
+    error = EINVAL;
+    API_STD_RETURN(error, retval);
+  }
+
+  msg.msg_name = 0;
+  msg.msg_namelen = 0;
+  msg.msg_iov = &aiov;
+  msg.msg_iovlen = 1;
+  msg.msg_control = 0;
+  aiov.iov_base = NULL;
+  aiov.iov_len = len == SENDFILE_EOF ? 0x7fffffff : len;
+
+  ObtainSyscallSemaphore(libPtr);
+  error = sendit(libPtr, s, &msg, flags, &retval, UIO_DOSFILE, (void *)file);
+  ReleaseSyscallSemaphore(libPtr);
+
+  API_STD_RETURN(error, retval);
+  AROS_LIBFUNC_EXIT
+}
+
 LONG __recv(LONG s, caddr_t buf, LONG len, LONG flags, struct SocketBase *libPtr)
 {
   struct msghdr msg;
@@ -55,6 +55,7 @@ extern LONG __recv(LONG, char *, LONG, LONG, struct SocketBase *);
 extern LONG __send(LONG, const char *, LONG, LONG, struct SocketBase *);
 extern LONG __sendto(LONG, const char *, LONG, LONG, struct sockaddr *, LONG, struct SocketBase *);
 extern LONG __socket(LONG, LONG, LONG, struct SocketBase *);
+extern void __SendLoanCleanup(struct SocketBase *);
 extern LONG __IoctlSocket(LONG fdes, ULONG cmd, caddr_t data, struct SocketBase *libPtr);
 extern LONG __WaitSelect(ULONG, fd_set *, fd_set *, fd_set *, struct timeval *, ULONG *, struct SocketBase *);
 extern struct hostent * __gethostbyaddr(UBYTE *, int, int, struct SocketBase *);
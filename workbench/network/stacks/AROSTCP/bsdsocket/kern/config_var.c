@@ -32,7 +32,10 @@
  "RC=RCHKSUM,ROF=ROFFSET,RPS=RPSHORT,RDUPP=RDUPPACK,RDUPB=RDUPBYTE," \
  "RPDUPD=RPDUPDATA,RPDUPB=RPDUPBYTE,ROOP=ROOPACK,ROOB=ROOBYTE," \
  "RPL=RPLATE,RBL=RBLATE,RAF=RAFTER,RWP=RWPROBE,RDUPA=RDUPACK," \
- "RACKT=RACKTOOM,RACKP=RACKPACK,RACKB=RACKBYTE,RWU=RWUPDATE"
+ "RACKT=RACKTOOM,RACKP=RACKPACK,RACKB=RACKBYTE,RWU=RWUPDATE," \
+ "PAWS=PAWSDROP,PRA=PREDACK,PRD=PREDDAT,PCBM=PCBCACHEMISS," \
+ "FR=FASTRECOVERY,SACKREC=SACKRECOVERY,SACKRP=SACKREXPACK," \
+ "SACKRB=SACKREXBYTE,RSACKB=RSACKBLOCK,SSACKB=SSACKBLOCK"
 
 /* Variables related to User Datagram Protocol. */
 #define KW_UDP \
@@ -68,11 +71,13 @@
 /* Level 1 variables */
 STRPTR KW_VARS =
   "WITH,IC=ICMP,ICH=ICMPHIST,IP,T=TCP,U=UDP,CONNECTIONS,HOSTNAME,ROUTES,"
-  "MBS=MBUF_STAT,MBTS=MBUF_TYPE_STATS,MBC=MBUF_CONF,LOG,GUI,SHOW,"
-  "TASKNAME,NTH=NTHBASE,DBSANA=DEBUGSANA,DBICMP=DEBUGICMP,"
-  "DBIP=DEBUGIP,GTW=GATEWAY,REDIR=IPSENDREDIRECTS,"
+  "MBS=MBUF_STAT,MBTS=MBUF_TYPE_STATS,LKS=LOCK_STATS,MBC=MBUF_CONF,"
+  "LOG,GUI,SHOW,TASKNAME,NTH=NTHBASE,DBSANA=DEBUGSANA,"
+  "DBICMP=DEBUGICMP,DBIP=DEBUGIP,GTW=GATEWAY,REDIR=IPSENDREDIRECTS,"
   "USENS=USENAMESERVER,ULO=USELOOPBACK,TCPSND=TCP_SENDSPACE,"
-  "TCPRCV=TCP_RECVSPACE,CON=CONSOLENAME,LOGF=LOGFILENAME,OPENGUI,REFRESH";
+  "TCPRCV=TCP_RECVSPACE,TCPRFC1323=TCP_RFC1323,TCPSACK=TCP_SACK,"
+  "TCPCC=TCP_CC,SBMAX=SOCKBUF_MAX,LOLOSS=LOOPBACK_LOSS,"
+  "CON=CONSOLENAME,LOGF=LOGFILENAME,OPENGUI,REFRESH";
 
 /* extern declarations */
 
@@ -87,6 +92,7 @@ LONG rexx_gethostname(struct CSource *args, UBYTE **errstrp, struct CSource *res
 LONG getroutes(struct CSource *args, UBYTE **errstrp, struct CSource *res);
 extern struct mbstat mbstat;
 extern LONG mb_read_stats(struct CSource *args, UBYTE **errstrp, struct CSource *res);
+extern LONG netlock_read_stats(struct CSource *args, UBYTE **errstrp, struct CSource *res);
 extern struct mbconf mbconf; int mb_check_conf(void *pt, IPTR new);
 extern LONG log_cnf;
 extern LONG gui_cnf;
@@ -102,6 +108,11 @@ extern LONG usens;
 extern LONG useloopback;
 extern ULONG tcp_sendspace;
 extern ULONG tcp_recvspace;
+extern LONG tcp_do_rfc1323;
+extern LONG tcp_do_sack;
+extern LONG tcp_cc_default;
+extern ULONG sb_max;
+extern LONG loop_loss;
 extern STRPTR consolename ;	 int logname_changed(void *pt, IPTR new);
 extern STRPTR logfilename;
 extern LONG OpenGUIOnStartup;
@@ -122,6 +133,7 @@ struct cfg_variable variables[] = {
 { VAR_FUNC, VF_READ, NULL, (notify_f)getroutes, NULL },
 { VAR_LONG, VF_TABLE|VF_READ, KW_MBUF_STAT, &mbstat, NULL },
 { VAR_FUNC, VF_READ, NULL, (notify_f)mb_read_stats, NULL },
+{ VAR_FUNC, VF_READ, NULL, (notify_f)netlock_read_stats, NULL },
 { VAR_LONG, VF_TABLE|VF_RCONF,   KW_MBUF_CONF, &mbconf, mb_check_conf },
 { VAR_LONG, VF_TABLE|VF_RCONF,   KW_LOG, &log_cnf, NULL },
 { VAR_STRP, VF_TABLE|VF_RCONF,   KW_GUI, &gui_cnf, NULL },
@@ -137,6 +149,11 @@ struct cfg_variable variables[] = {
 { VAR_ENUM, VF_RW, NULL, &useloopback, boolean_enum },
 { VAR_LONG, VF_RW, NULL, (LONG*)&tcp_sendspace, NULL },
 { VAR_LONG, VF_RW, NULL, (LONG*)&tcp_recvspace, NULL },
+{ VAR_ENUM, VF_RW, NULL, &tcp_do_rfc1323, boolean_enum },
+{ VAR_ENUM, VF_RW, NULL, &tcp_do_sack, boolean_enum },
+{ VAR_ENUM, VF_RW, NULL, &tcp_cc_default, (notify_f)"NEWRENO,CUBIC" },
+{ VAR_LONG, VF_RW, NULL, (LONG*)&sb_max, NULL },
+{ VAR_LONG, VF_RW, NULL, &loop_loss, NULL },
 { VAR_STRP, VF_RW, NULL, &consolename, logname_changed },
 { VAR_STRP, VF_RW, NULL, &logfilename, logname_changed },
 { VAR_ENUM, VF_RCONF, NULL, &OpenGUIOnStartup, boolean_enum },
@@ -32,6 +32,8 @@
 
 #include <api/amiga_api.h>
 
+#include <dos/rdargs.h>
+
 #include <proto/exec.h>
 
 /*
@@ -293,7 +295,7 @@ D(bug("[AROSTCP](kern_synch.c) tsleep_main()\n"));
 
 /*
  * General sleep call. 
- * NOTE: caller is assumed to hold the syscall_semaphore!         \* XXX *\
+ * NOTE: caller is assumed to hold the syscall_lock!              \* XXX *\
  * Suspends current process until a wakeup is made on chan.
  * Sleeps at most the time specified in a time_out (NULL means no timeout).
  * Lowers the current spl-level to 0 while in sleep.
@@ -328,8 +330,8 @@ D(bug("[AROSTCP](kern_synch.c) tsleep()\n"));
 #endif 
 
 #if DIAGNOSTIC
-  if (FindTask(NULL) != syscall_semaphore.ss_Owner) {
-    log(LOG_ERR, "tsleep() called with NO syscall_semaphore!");
+  if (!netlock_owned(&syscall_lock)) {
+    log(LOG_ERR, "tsleep() called with NO syscall_lock!");
     return (-1);
   }
 #endif
@@ -341,18 +343,18 @@ D(bug("[AROSTCP](kern_synch.c) tsleep()\n"));
   /*
    * release spl-level while in sleep.
    * 
-   * NOTE: syscall_semaphore must be freed as well!
+   * NOTE: syscall_lock must be freed as well!
    */
 
   old_spl = spl0();
-  ReleaseSemaphore(&syscall_semaphore);	                     /* XXX */
+  netlock_release(&syscall_lock);	                     /* XXX */
 
   result = tsleep_main(p, 0);
 
   /*
    * return old spl-level
    */
-  ObtainSemaphore(&syscall_semaphore);	                     /* XXX */
+  netlock_obtain(&syscall_lock);	                     /* XXX */
   splx(old_spl);
 
   /*
@@ -421,19 +423,59 @@ D(bug("[AROSTCP](kern_synch.c) wakeup()\n"));
  * is now always used.
  */
 
+/*
+ * List of all network locks, for LOCK_STATS
+ */
+static struct netlock *netlocks = NULL;
+
+void
+netlock_init(struct netlock *nl, const char *name)
+{
+  InitSemaphore(&nl->nl_semaphore);
+  nl->nl_name = name;
+  nl->nl_obtained = 0;
+  nl->nl_contended = 0;
+
+  Forbid();
+  nl->nl_next = netlocks;
+  netlocks = nl;
+  Permit();
+}
+
+/*
+ * Read function of the LOCK_STATS variable. Returns the name of each
+ * lock followed by the number of times it was obtained and the number
+ * of times the caller had to wait for it.
+ */
+LONG
+netlock_read_stats(struct CSource *args, UBYTE **errstrp, struct CSource *res)
+{
+  struct netlock *nl;
+  UBYTE *p = res->CS_Buffer;
+  UBYTE *end = p + res->CS_Length - 1;
+
+  for (nl = netlocks; nl != NULL; nl = nl->nl_next) {
+    if (end - p < 40)
+      break;
+    p += sprintf(p, "%s%s %lu %lu", (p == res->CS_Buffer) ? "" : " ",
+		 nl->nl_name, (unsigned long)nl->nl_obtained,
+		 (unsigned long)nl->nl_contended);
+  }
+
+  res->CS_CurChr = p - res->CS_Buffer;
+  return RETURN_OK;
+}
+
 /*#ifndef DEBUG*/ /* NC */
 #if 1
 /*
- * spl_semaphore is used as mutex for all spl-levels
- *
- * Note that InitSemaphore() requires the signalSemaphore to be initialized
- * to zero (here done statically).
+ * spl_lock is used as mutex for all spl-levels
  */
-struct SignalSemaphore spl_semaphore = { };
+struct netlock spl_lock;
 
 /*
  * spl_level holds the current pseudo priority level.
- * NOTE: this may be accessed only while holding the spl_semaphore.
+ * NOTE: this may be accessed only while holding the spl_lock.
  */
 spl_t spl_level = SPL0;
 static BOOL spl_initialized = FALSE;
@@ -446,10 +488,10 @@ D(bug("[AROSTCP](kern_synch.c) spl_init()\n"));
 #endif
   if (!spl_initialized) {
     /*
-     * Initialize spl_semaphore for use. After this call any number of 
+     * Initialize spl_lock for use. After this call any number of
      * tasks may use spl-functions.
      */
-    InitSemaphore(&spl_semaphore);
+    netlock_init(&spl_lock, "spl");
     spl_initialized = TRUE;
   }
   return TRUE;
@@ -464,7 +506,7 @@ spl_n(spl_t new_level)
 //D(bug("[AROSTCP](kern_synch.c) spl_n()\n"));
 //#endif
 
-  ObtainSemaphore(&spl_semaphore);
+  netlock_obtain(&spl_lock);
   old_level = spl_level;
   spl_level = new_level;
   
@@ -480,9 +522,9 @@ spl_n(spl_t new_level)
       /*
        * now release the lock kept above
        */
-      ReleaseSemaphore(&spl_semaphore);
+      netlock_release(&spl_lock);
   }
-  ReleaseSemaphore(&spl_semaphore);
+  netlock_release(&spl_lock);
 
   return old_level;
 }
@@ -86,9 +86,23 @@ struct uio {
 	int	uio_iovcnt;
 	int	uio_resid;
 	struct	SocketBase *uio_procp;
+	int	uio_segflg;	/* where sosend() takes the data from */
+	void	*uio_src;	/* UIO_LOAN: mextref, UIO_DOSFILE: file */
 #endif	
 };
 
+#ifdef AMITCP
+/*
+ * Segment flag values. With UIO_LOAN the mbufs reference the data in
+ * the iovecs instead of a copy. With UIO_DOSFILE the data is read from
+ * the file handle; the length of the only iovec is what is left to
+ * read, and its base is not used.
+ */
+#define	UIO_USERSPACE	0	/* copy from the iovecs */
+#define	UIO_LOAN	1	/* lent by the caller */
+#define	UIO_DOSFILE	2	/* read from a DOS file */
+#endif /* AMITCP */
+
  /*
   * Limits
   */
@@ -112,7 +112,12 @@ struct mbconf mbconf = {
 };
 
 /*
- * List of free mbufs. Access to this list is protected by splimp()
+ * Lock protecting the free lists and the statistics below
+ */
+struct netlock mbuf_lock;
+
+/*
+ * List of free mbufs. Access to this list is protected by mbuf_lock
  */
 struct mbuf *mfree = NULL;
 
@@ -208,7 +213,6 @@ D(bug("[AROSTCP](uipc_mbuf.c) mb_check_conf(0x%08x, %d)\n", dp, newvalue));
 BOOL
 mbinit(void)
 {
-  spl_t s;
 #if defined(__AROS__)
 D(bug("[AROSTCP](uipc_mbuf.c) mbinit()\n"));
 #endif
@@ -219,7 +223,8 @@ D(bug("[AROSTCP](uipc_mbuf.c) mbinit()\n"));
   if (initialized)
     return TRUE;
 
-  s = splimp();
+  netlock_init(&mbuf_lock, "mbuf");
+  netlock_obtain(&mbuf_lock);
   /*
    * Initialize the list headers to NULL
    */
@@ -233,7 +238,7 @@ D(bug("[AROSTCP](uipc_mbuf.c) mbinit()\n"));
     (m_alloc(mbconf.initial_mbuf_chunks * mbconf.mbufchunk, M_WAIT)
      && m_clalloc(mbconf.clusterchunk, M_WAIT));
 
-  splx(s);
+  netlock_release(&mbuf_lock);
   
   if (!initialized) {
 #if defined(__AROS__)
@@ -280,7 +285,7 @@ D(bug("[AROSTCP](uipc_mbuf.c) mbdeinit: Freeing %d bytes @ 0x%08x\n", mbufmem, m
  * and place on the mbuf free list.
  * The canwait argument is currently ignored.
  *
- * MUST be called at splimp!
+ * MUST be called with mbuf_lock held!
  */
 BOOL
 m_alloc(int howmany, int canwait)
@@ -351,7 +356,7 @@ D(bug("[AROSTCP](uipc_mbuf.c) m_alloc: Cannot allocate memory for mbufs\n"));
  * Allocate some number of mbuf clusters
  * and place on cluster free list.
  * The canwait argument is currently ignored.
- * MUST be called at splimp.
+ * MUST be called with mbuf_lock held.
  */
 BOOL
 m_clalloc(int ncl, int canwait)
@@ -424,7 +429,8 @@ D(bug("[AROSTCP](uipc_mbuf.c) m_clalloc: Cannot allocate memory for mbuf cluster
  *
  * Allocate more memory for mbufs if there still are no mbufs left 
  *
- * MUST be called at splimp.
+ * MUST NOT be called with mbuf_lock held, as the protocols are drained
+ * at splimp.
  */
 struct mbuf *
 m_retry(int canwait, int type)
@@ -439,8 +445,10 @@ D(bug("[AROSTCP](uipc_mbuf.c) m_retry()\n"));
   /*
    * Try to allocate more memory if still no free mbufs
    */
+  netlock_obtain(&mbuf_lock);
   if (!mfree)
     m_alloc(mbconf.mbufchunk, canwait);
+  netlock_release(&mbuf_lock);
   
 #define m_retry(i, t)	/*mbstat.m_drops++,*/NULL
   MGET(m, canwait, type);
@@ -661,7 +669,10 @@ D(bug("[AROSTCP](uipc_mbuf.c) m_copym: short mbuf chain!!\n"));
 
 		if (m->m_flags & M_EXT) {
 			n->m_data = m->m_data + off;
-			m->m_ext.ext_buf->mcl.mcl_refcnt++;
+			if (m->m_ext.ext_ref)
+				MEXTREF(m->m_ext.ext_ref)
+			else
+				m->m_ext.ext_buf->mcl.mcl_refcnt++;
 			n->m_ext = m->m_ext;
 			n->m_flags |= M_EXT;
 		} else
@@ -97,6 +97,7 @@
 #include <api/amiga_api.h>
 
 #include <kern/amiga_includes.h>
+#include <proto/dos.h>
 
 #include <kern/uipc_socket_protos.h>
 #include <kern/uipc_socket2_protos.h>
@@ -105,6 +106,8 @@
 
 #include <sys/uio.h>
 
+#include <netinet/in_cksum.h>
+
 #ifndef SO_EVENTMASK
 #define SO_EVENTMASK	0x2001
 #endif
@@ -210,6 +213,8 @@ sofree(so)
 	}
 	sbrelease(&so->so_snd);
 	sorflush(so);
+	if (so->so_evregs)
+		eventset_sofree(so);
 	FREE(so, M_SOCKET);
 }
 
@@ -375,13 +380,16 @@ bad:
 
 #ifdef AMITCP
 /*
- * uioread() replaces uiomove() in sosend
+ * uioread() replaces uiomove() in sosend. If sump is given, the partial
+ * checksum of the data is added to it while copying; off is the offset
+ * of cp in the packet.
  */
 
-static inline void uioread(caddr_t cp, int n, struct uio *uio)
+static inline void uioread(caddr_t cp, int n, struct uio *uio,
+			   int off, u_int64_t *sump)
 {
   struct iovec *iov;
-  u_int cnt;
+  u_int cnt, sum;
 
   while (n > 0 && uio->uio_resid) {
     iov = uio->uio_iov;
@@ -394,7 +402,12 @@ static inline void uioread(caddr_t cp, int n, struct uio *uio)
     if (cnt > n)
       cnt = n;
 
-    bcopy(iov->iov_base, cp, cnt); /* wrong direction //pp */
+    if (sump) {
+      sum = in_cksum_copy(iov->iov_base, cp, cnt);
+      *sump += (off & 1) ? in_cksum_swap(sum) : sum;
+      off += cnt;
+    } else
+      bcopy(iov->iov_base, cp, cnt); /* wrong direction //pp */
 
     iov->iov_base += cnt;
     iov->iov_len -= cnt;
@@ -404,6 +417,78 @@ static inline void uioread(caddr_t cp, int n, struct uio *uio)
   }
 }
 
+/*
+ * uioloan() makes m reference at most n bytes of the lent data in uio,
+ * up to the end of the current iovec, and returns their number.
+ */
+static inline int uioloan(struct mbuf *m, int n, struct uio *uio,
+			  int off, u_int64_t *sump)
+{
+  struct iovec *iov;
+  u_int cnt, sum;
+
+  while ((iov = uio->uio_iov)->iov_len == 0) {
+    uio->uio_iov++;
+    uio->uio_iovcnt--;
+  }
+  cnt = iov->iov_len;
+  if (cnt > n)
+    cnt = n;
+
+  m->m_data = iov->iov_base;
+  m->m_ext.ext_buf = NULL;
+  m->m_ext.ext_ref = uio->uio_src;
+  m->m_ext.ext_size = cnt;
+  m->m_flags |= M_EXT;
+  MEXTREF(m->m_ext.ext_ref);
+
+  if (sump) {
+    sum = in_cksum_block(iov->iov_base, cnt);
+    *sump += (off & 1) ? in_cksum_swap(sum) : sum;
+  }
+
+  iov->iov_base += cnt;
+  iov->iov_len -= cnt;
+  uio->uio_resid -= cnt;
+  return (cnt);
+}
+
+/*
+ * uiofile() reads at most n bytes from the file in uio to cp and
+ * returns their number, or -1 if the read failed. Pipes, consoles and
+ * the like may return less than asked for, so it keeps reading until
+ * n bytes are in or Read() returns 0. Only at the end of the file
+ * uio_resid is cleared, so that sosend() stops.
+ */
+static inline int uiofile(caddr_t cp, int n, struct uio *uio,
+			  int off, u_int64_t *sump)
+{
+  struct iovec *iov = uio->uio_iov;
+  LONG cnt, done = 0;
+  u_int sum;
+
+  if (n > iov->iov_len)
+    n = iov->iov_len;
+  while (done < n) {
+    if ((cnt = Read((BPTR)uio->uio_src, cp + done, n - done)) < 0)
+      return (-1);
+    if (cnt == 0) {
+      uio->uio_resid = done;	/* end of file */
+      break;
+    }
+    done += cnt;
+  }
+
+  if (sump) {
+    sum = in_cksum_block(cp, done);
+    *sump += (off & 1) ? in_cksum_swap(sum) : sum;
+  }
+
+  iov->iov_len -= done;
+  uio->uio_resid -= done;
+  return (done);
+}
+
 #endif /* AMITCP */
 
 
@@ -441,7 +526,10 @@ sosend(so, addr, uio, top, control, flags)
 	register long space, len, resid;
 	int clen = 0, error, dontroute, mlen;
 	spl_t s;
+	BOOL unlocked;
 	int atomic = sosendallatonce(so) || top;
+	int cksum = so->so_proto->pr_flags & PR_CKSUMDATA;
+	u_int64_t sum = 0;
 
 	if (uio)
 		resid = uio->uio_resid;
@@ -505,16 +593,35 @@ restart:
 			if (flags & MSG_EOR)
 				top->m_flags |= M_EOR;
 #endif
-		    } else do {
+		    } else {
+		      /*
+		       * The send buffer is locked and the mbuf chain
+		       * is still private, so other tasks may use the
+		       * stack while the data is copied.
+		       */
+		      unlocked = syscall_unlock();
+		      do {
 			if (top == 0) {
 				MGETHDR(m, M_WAIT, MT_DATA);
 				mlen = MHLEN;
 				m->m_pkthdr.len = 0;
 				m->m_pkthdr.rcvif = (struct ifnet *)0;
+				sum = 0;
 			} else {
 				MGET(m, M_WAIT, MT_DATA);
 				mlen = MLEN;
 			}
+			if (uio->uio_segflg == UIO_LOAN) {
+				/*
+				 * Lent data is referenced where it is, it
+				 * only has to fit in the send buffer.
+				 */
+				len = uioloan(m, (int)MIN(resid, space), uio,
+				    top ? top->m_pkthdr.len : 0,
+				    cksum ? &sum : NULL);
+				space -= len;
+				goto filled;
+			}
 			if (resid >= mlen && space >= mbconf.mclbytes) {
 				MCLGET(m, M_WAIT);
 				if ((m->m_flags & M_EXT) == 0)
@@ -542,13 +649,25 @@ nopages:
 				if (atomic && top == 0 && len < mlen)
 					MH_ALIGN(m, len);
 			}
-			uioread(mtod(m, caddr_t), (int)len, uio);
+			if (uio->uio_segflg == UIO_DOSFILE) {
+				len = uiofile(mtod(m, caddr_t), (int)len, uio,
+				    top ? top->m_pkthdr.len : 0,
+				    cksum ? &sum : NULL);
+				if (len < 0) {
+					m_free(m);
+					syscall_relock(unlocked);
+					error = EIO;
+					goto release;
+				}
+			} else
+				uioread(mtod(m, caddr_t), (int)len, uio,
+				    top ? top->m_pkthdr.len : 0,
+				    cksum ? &sum : NULL);
+filled:
 			resid = uio->uio_resid;
 			m->m_len = len;
 			*mp = m;
 			top->m_pkthdr.len += len;
-			if (error)
-				goto release;
 			mp = &m->m_next;
 			if (resid <= 0) {
 #ifdef USE_M_EOR
@@ -564,6 +683,16 @@ nopages:
 #else
 		    while (space > 0 && atomic);
 #endif
+		      /*
+		       * The data was summed while it was copied, the
+		       * protocol only has to add its headers.
+		       */
+		      if (cksum && top) {
+			top->m_pkthdr.csum_data = in_cksum_fold(sum);
+			top->m_flags |= M_CSUM_DATA;
+		      }
+		      syscall_relock(unlocked);
+		    }
 		    if (dontroute)
 			    so->so_options |= SO_DONTROUTE;
 		    s = splnet();				/* XXX */
@@ -861,8 +990,12 @@ dontblock:
 		 */
 
 		if (mp == 0) {
+			BOOL unlocked;
+
 			splx(s);
+			unlocked = syscall_unlock();
 			uiowrite(mtod(m, caddr_t) + moff, (int)len, uio);
+			syscall_relock(unlocked);
 			s = splnet();
 		} else
 			uio->uio_resid -= len;
@@ -98,6 +98,7 @@
 
 #include <kern/uipc_socket2_protos.h>
 #include <kern/amiga_select_protos.h>
+#include <kern/amiga_eventset_protos.h>
 
 /*
  * Primitive routines for operating on sockets and socket buffers
@@ -396,6 +397,9 @@ sowakeup(so, sb)
 		sb->sb_flags &= ~SB_SEL; /* do not notify us any more */
 		selwakeup(&sb->sb_sel);
 	}
+	if (so->so_evregs)
+		eventset_wakeup(so, sb == &so->so_rcv ?
+				(FD_ACCEPT|FD_READ|FD_OOB) : FD_WRITE);
 	if (sb->sb_flags & SB_WAIT) {
 		sb->sb_flags &= ~SB_WAIT;
 		wakeup((caddr_t)&sb->sb_cc);
@@ -99,6 +99,13 @@
 
 struct	ifnet loif = {0};
 
+/*
+ * Packets per thousand to drop on purpose (LOOPBACK_LOSS), so loss
+ * recovery can be tested without a real network.
+ */
+int	loop_loss = 0;
+static	u_long loop_seed = 1;
+
 void
 loattach()
 {
@@ -147,6 +154,15 @@ looutput(ifp, m, dst, rt)
 	}
 	ifp->if_opackets++;
 	ifp->if_obytes += m->m_pkthdr.len;
+	if (loop_loss > 0) {
+		loop_seed = loop_seed * 1103515245 + 12345;
+		if ((loop_seed >> 16) % 1000 < loop_loss) {
+			/* Lost "on the wire", the sender does not know */
+			ifp->if_iqdrops++;
+			m_freem(m);
+			return (0);
+		}
+	}
 	switch (dst->sa_family) {
 
 #if INET
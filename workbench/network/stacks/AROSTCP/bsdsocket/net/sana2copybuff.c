@@ -43,6 +43,8 @@
 #include <netinet/ip.h>
 #endif
 
+#include <netinet/in_cksum.h>
+
 #include <net/if_sana.h>
 #include <api/amiga_raf.h>
 #define bcopy(a,b,c) CopyMem((APTR)(a),b,c)
@@ -222,6 +224,8 @@ AROS_UFH3(BOOL, m_copy_from_mbuf,
  * starting from the beginning, continuing for "n" bytes.
  * Mbufs in the preallocated chain must have their m_len field set to maximum
  * amount of data that they can have.
+ * The packet is summed while it is copied, so that TCP and UDP input
+ * do not have to read it again to verify their checksums.
  * 
  * NOTE: this WILL be called from INTERRUPTS, so compile with stack checking
  *       disabled and use __saveds if near data is needed.
@@ -238,6 +242,8 @@ AROS_UFH3(BOOL, m_copy_to_mbuf,
   AROS_USERFUNC_INIT
   register struct mbuf *f, *m = to->ioip_reserved;
   unsigned totlen = n;
+  u_int64_t sum = 0;
+  u_int msum;
 
 #if DIAGNOSTIC
   if (!(m->m_flags & M_PKTHDR)) {
@@ -260,7 +266,8 @@ AROS_UFH3(BOOL, m_copy_to_mbuf,
 #endif
     if (n < m->m_len)
       m->m_len = n;
-    bcopy(from, mtod(m, caddr_t), m->m_len);
+    msum = in_cksum_copy(from, mtod(m, caddr_t), m->m_len);
+    sum += ((totlen - n) & 1) ? in_cksum_swap(msum) : msum;
     from += m->m_len;
     n -= m->m_len;
     if (n > 0)
@@ -276,6 +283,8 @@ AROS_UFH3(BOOL, m_copy_to_mbuf,
 
   to->ioip_packet = to->ioip_reserved;
   to->ioip_packet->m_pkthdr.len = totlen; /* set packet length */
+  to->ioip_packet->m_pkthdr.csum_data = in_cksum_fold(sum);
+  to->ioip_packet->m_flags |= M_CSUM_RCVD;
   to->ioip_reserved = f;		/* leftover mbufs */
 
   /*
@@ -0,0 +1,279 @@
+/*
+ * Copyright (C) 2026 The AROS Dev Team
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place - Suite 330, Boston,
+ * MA 02111-1307, USA.
+ *
+ */
+
+#ifndef NETINET_IN_CKSUM_H
+#define NETINET_IN_CKSUM_H
+
+/*
+ * Building blocks of the Internet checksum (RFC 1071).
+ *
+ * A partial sum is the one's complement sum of the 16-bit words of a
+ * buffer, taken in memory order and folded to 16 bits; complementing
+ * it gives the checksum. 32-bit words can be added into a 64-bit
+ * accumulator instead, since 2^16 is 1 modulo 0xffff. A buffer that
+ * starts at an odd offset of the packet contributes its partial sum
+ * byte swapped.
+ *
+ * Nothing here depends on the rest of the stack, so that the checksum
+ * benchmark can build the same code.
+ */
+
+#if defined(__x86_64__)
+#include <emmintrin.h>
+#define	IN_CKSUM_SSE2	1
+#elif defined(__aarch64__) && defined(__ARM_NEON)
+#include <arm_neon.h>
+#define	IN_CKSUM_NEON	1
+#endif
+
+static inline u_int
+in_cksum_fold(u_int64_t sum)
+{
+	sum = (sum >> 32) + (sum & 0xffffffff);
+	sum = (sum >> 32) + (sum & 0xffffffff);
+	sum = (sum >> 16) + (sum & 0xffff);
+	sum = (sum >> 16) + (sum & 0xffff);
+	return ((u_int)sum);
+}
+
+static inline u_int
+in_cksum_swap(u_int sum)
+{
+	return (((sum & 0xff) << 8) | (sum >> 8));
+}
+
+/*
+ * The word made of byte b and a zero byte, as it is found in memory.
+ */
+static inline u_int
+in_cksum_byte(u_char b)
+{
+	union {
+		u_char	c[2];
+		u_short	s;
+	} w;
+
+	w.c[0] = b;
+	w.c[1] = 0;
+	return (w.s);
+}
+
+/*
+ * Partial sum of the pseudo header words a, b and c, which are in
+ * network byte order.
+ */
+static inline u_int
+in_pseudo(u_int32_t a, u_int32_t b, u_int32_t c)
+{
+	return (in_cksum_fold((u_int64_t)a + b + c));
+}
+
+/*
+ * Sum of len bytes at a 4 byte aligned p, using integer registers only.
+ */
+static inline u_int64_t
+in_cksum_words_int(const u_char *p, int len)
+{
+	const u_int32_t *w = (const u_int32_t *)p;
+	u_int64_t sum = 0;
+
+	while (len >= 32) {
+		sum += w[0]; sum += w[1]; sum += w[2]; sum += w[3];
+		sum += w[4]; sum += w[5]; sum += w[6]; sum += w[7];
+		w += 8;
+		len -= 32;
+	}
+	while (len >= 4) {
+		sum += *w++;
+		len -= 4;
+	}
+	p = (const u_char *)w;
+	if (len >= 2) {
+		sum += *(const u_short *)p;
+		p += 2;
+		len -= 2;
+	}
+	if (len)
+		sum += in_cksum_byte(*p);
+	return (sum);
+}
+
+/*
+ * Sum of len bytes at a 4 byte aligned p.
+ */
+static inline u_int64_t
+in_cksum_words(const u_char *p, int len)
+{
+	u_int64_t sum = 0;
+
+#if IN_CKSUM_SSE2
+	if (len >= 64) {
+		__m128i zero = _mm_setzero_si128();
+		__m128i acc0 = zero, acc1 = zero, v0, v1;
+		u_int64_t lanes[2];
+
+		/* Widen the 32-bit words to 64 bits before adding */
+		do {
+			v0 = _mm_loadu_si128((const __m128i *)p);
+			v1 = _mm_loadu_si128((const __m128i *)(p + 16));
+			acc0 = _mm_add_epi64(acc0, _mm_unpacklo_epi32(v0, zero));
+			acc1 = _mm_add_epi64(acc1, _mm_unpackhi_epi32(v0, zero));
+			acc0 = _mm_add_epi64(acc0, _mm_unpacklo_epi32(v1, zero));
+			acc1 = _mm_add_epi64(acc1, _mm_unpackhi_epi32(v1, zero));
+			v0 = _mm_loadu_si128((const __m128i *)(p + 32));
+			v1 = _mm_loadu_si128((const __m128i *)(p + 48));
+			acc0 = _mm_add_epi64(acc0, _mm_unpacklo_epi32(v0, zero));
+			acc1 = _mm_add_epi64(acc1, _mm_unpackhi_epi32(v0, zero));
+			acc0 = _mm_add_epi64(acc0, _mm_unpacklo_epi32(v1, zero));
+			acc1 = _mm_add_epi64(acc1, _mm_unpackhi_epi32(v1, zero));
+			p += 64;
+			len -= 64;
+		} while (len >= 64);
+		_mm_storeu_si128((__m128i *)lanes, _mm_add_epi64(acc0, acc1));
+		sum = (u_int64_t)in_cksum_fold(lanes[0]) + in_cksum_fold(lanes[1]);
+	}
+#elif IN_CKSUM_NEON
+	if (len >= 64) {
+		uint64x2_t acc0 = vdupq_n_u64(0), acc1 = vdupq_n_u64(0);
+
+		/* Pairwise add and accumulate into 64-bit lanes */
+		do {
+			acc0 = vpadalq_u32(acc0, vreinterpretq_u32_u8(vld1q_u8(p)));
+			acc1 = vpadalq_u32(acc1, vreinterpretq_u32_u8(vld1q_u8(p + 16)));
+			acc0 = vpadalq_u32(acc0, vreinterpretq_u32_u8(vld1q_u8(p + 32)));
+			acc1 = vpadalq_u32(acc1, vreinterpretq_u32_u8(vld1q_u8(p + 48)));
+			p += 64;
+			len -= 64;
+		} while (len >= 64);
+		acc0 = vaddq_u64(acc0, acc1);
+		sum = (u_int64_t)in_cksum_fold(vgetq_lane_u64(acc0, 0)) +
+		    in_cksum_fold(vgetq_lane_u64(acc0, 1));
+	}
+#endif
+
+	return (sum + in_cksum_words_int(p, len));
+}
+
+/*
+ * Partial sum of len bytes at buf, which may have any alignment. With
+ * intonly set no vector registers are touched.
+ */
+static inline u_int
+in_cksum_partial(const void *buf, int len, int intonly)
+{
+	const u_char *p = buf;
+	u_int64_t sum = 0;
+	u_int lead = 0;
+	int odd;
+
+	if (len <= 0)
+		return (0);
+	/*
+	 * Sum an odd buffer from its second byte on, as if that started
+	 * the packet, and add the first byte to the swapped result.
+	 */
+	if ((odd = (IPTR)p & 1)) {
+		lead = in_cksum_byte(*p++);
+		len--;
+	}
+	if (((IPTR)p & 2) && len >= 2) {
+		sum = *(const u_short *)p;
+		p += 2;
+		len -= 2;
+	}
+	sum += intonly ? in_cksum_words_int(p, len) : in_cksum_words(p, len);
+	if (odd)
+		return (in_cksum_fold((u_int64_t)lead +
+		    in_cksum_swap(in_cksum_fold(sum))));
+	return (in_cksum_fold(sum));
+}
+
+static inline u_int
+in_cksum_block(const void *buf, int len)
+{
+	return (in_cksum_partial(buf, len, 0));
+}
+
+/*
+ * Copy len bytes from src to dst and return the partial sum of the
+ * data, reading every word only once. This is plain integer code, so
+ * that it may be used from interrupts.
+ */
+static inline u_int
+in_cksum_copy(const void *src, void *dst, int len)
+{
+	const u_char *s = src;
+	u_char *d = dst;
+	const u_int32_t *ws;
+	u_int32_t *wd, a, b, c, e;
+	u_int64_t sum = 0;
+	u_int lead = 0;
+	int odd;
+
+	if (len <= 0)
+		return (0);
+	if (((IPTR)s ^ (IPTR)d) & 3) {
+		/* The words cannot be both loaded and stored aligned */
+		CopyMem((APTR)s, d, len);
+		return (in_cksum_partial(d, len, 1));
+	}
+
+	if ((odd = (IPTR)s & 1)) {
+		lead = in_cksum_byte(*d++ = *s++);
+		len--;
+	}
+	if (((IPTR)s & 2) && len >= 2) {
+		sum = *(u_short *)d = *(const u_short *)s;
+		s += 2;
+		d += 2;
+		len -= 2;
+	}
+
+	ws = (const u_int32_t *)s;
+	wd = (u_int32_t *)d;
+	while (len >= 16) {
+		a = ws[0]; b = ws[1]; c = ws[2]; e = ws[3];
+		wd[0] = a; wd[1] = b; wd[2] = c; wd[3] = e;
+		sum += a; sum += b; sum += c; sum += e;
+		ws += 4;
+		wd += 4;
+		len -= 16;
+	}
+	while (len >= 4) {
+		sum += *wd++ = *ws++;
+		len -= 4;
+	}
+	s = (const u_char *)ws;
+	d = (u_char *)wd;
+	if (len >= 2) {
+		sum += *(u_short *)d = *(const u_short *)s;
+		s += 2;
+		d += 2;
+		len -= 2;
+	}
+	if (len)
+		sum += in_cksum_byte(*d = *s);
+
+	if (odd)
+		return (in_cksum_fold((u_int64_t)lead +
+		    in_cksum_swap(in_cksum_fold(sum))));
+	return (in_cksum_fold(sum));
+}
+
+#endif /* !NETINET_IN_CKSUM_H */
@@ -59,10 +59,36 @@
 #include <netinet/in_var.h>
 #include <netinet/ip_var.h>
 
+#include <kern/kern_subr_protos.h>
+
 extern u_char inetctlerrmap[];
 
 struct	in_addr zeroin_addr;
 
+static void in_pcbremhash __P((struct inpcb *));
+
+/*
+ * Set up the PCB list and hash tables of a protocol. The sizes are
+ * rounded down to prime numbers.
+ */
+void
+in_pcbinfo_init(pcbinfo, listhead, stat, hashsize, wildsize, portsize)
+	struct inpcbinfo *pcbinfo;
+	struct inpcbhead *listhead;
+	struct inpcbstat *stat;
+	int hashsize, wildsize, portsize;
+{
+	LIST_INIT(listhead);
+	pcbinfo->listhead = listhead;
+	pcbinfo->hashbase = phashinit(hashsize, M_PCB, &pcbinfo->hashsize);
+	pcbinfo->wildbase = phashinit(wildsize, M_PCB, &pcbinfo->wildsize);
+	pcbinfo->porthashbase = phashinit(portsize, M_PCB,
+	    &pcbinfo->porthashsize);
+	pcbinfo->lastport = IPPORT_HIFIRSTAUTO - 1;
+	pcbinfo->stat = stat;
+	stat->pcbs_hashsize = pcbinfo->hashsize;
+}
+
 int
 in_pcballoc(so, pcbinfo)
 	struct socket *so;
@@ -79,7 +105,6 @@ in_pcballoc(so, pcbinfo)
 	inp->inp_socket = so;
 	s = splnet();
 	LIST_INSERT_HEAD(pcbinfo->listhead, inp, inp_list);
-	in_pcbinshash(inp);
 	splx(s);
 	so->so_pcb = (caddr_t)inp;
 	return (0);
@@ -91,11 +116,12 @@ in_pcbbind(inp, nam)
 	struct mbuf *nam;
 {
 	register struct socket *so = inp->inp_socket;
-	struct inpcbhead *head = inp->inp_pcbinfo->listhead;
-	unsigned short *lastport = &inp->inp_pcbinfo->lastport;
+	struct inpcbinfo *pcbinfo = inp->inp_pcbinfo;
+	struct inpcbstat *stat = pcbinfo->stat;
 	struct sockaddr_in *sin;
 //	struct proc *p = curproc;		/* XXX */
 	u_short lport = 0;
+	u_int port, count;
 	int wild = 0, reuseport = (so->so_options & SO_REUSEPORT);
 //	int error;
 
@@ -142,22 +168,36 @@ in_pcbbind(inp, nam)
 /*			if (ntohs(lport) < IPPORT_RESERVED &&
 			    (error = suser(p->p_ucred, &p->p_acflag)))
 				return (error);*/
-			t = in_pcblookup(head, zeroin_addr, 0,
+			t = in_pcblookup(pcbinfo, zeroin_addr, 0,
 			    sin->sin_addr, lport, wild);
 			if (t && (reuseport & t->inp_socket->so_options) == 0)
 				return (EADDRINUSE);
 		}
 		inp->inp_laddr = sin->sin_addr;
 	}
-	if (lport == 0)
+	if (lport == 0) {
+		/*
+		 * Take the next port of the dynamic range that is not in
+		 * use, trying every port at most once.
+		 */
+		port = pcbinfo->lastport;
+		count = IPPORT_HILASTAUTO - IPPORT_HIFIRSTAUTO + 1;
 		do {
-			++*lastport;
-			if (*lastport < IPPORT_RESERVED ||
-			    *lastport > IPPORT_USERRESERVED)
-				*lastport = IPPORT_RESERVED;
-			lport = htons(*lastport);
-		} while (in_pcblookup(head,
+			if (count-- == 0) {
+				stat->pcbs_portfails++;
+				inp->inp_laddr.s_addr = INADDR_ANY;
+				return (EADDRNOTAVAIL);
+			}
+			if (++port < IPPORT_HIFIRSTAUTO ||
+			    port > IPPORT_HILASTAUTO)
+				port = IPPORT_HIFIRSTAUTO;
+			lport = htons(port);
+			stat->pcbs_porttries++;
+		} while (in_pcblookup(pcbinfo,
 			    zeroin_addr, 0, inp->inp_laddr, lport, wild));
+		pcbinfo->lastport = port;
+		stat->pcbs_portallocs++;
+	}
 	inp->inp_lport = lport;
 	in_pcbrehash(inp);
 	return (0);
@@ -312,11 +352,12 @@ in_pcbconnect(inp, nam)
 
 	if (in_pcblookuphash(inp->inp_pcbinfo, sin->sin_addr, sin->sin_port,
 	    inp->inp_laddr.s_addr ? inp->inp_laddr : ifaddr->sin_addr,
-	    inp->inp_lport) != NULL)
+	    inp->inp_lport, 0) != NULL)
 		return (EADDRINUSE);
 	if (inp->inp_laddr.s_addr == INADDR_ANY) {
-		if (inp->inp_lport == 0)
-			(void)in_pcbbind(inp, (struct mbuf *)0);
+		if (inp->inp_lport == 0 &&
+		    (error = in_pcbbind(inp, (struct mbuf *)0)))
+			return (error);
 		inp->inp_laddr = ifaddr->sin_addr;
 	}
 	inp->inp_faddr = sin->sin_addr;
@@ -354,7 +395,7 @@ in_pcbdetach(inp)
 	ip_freemoptions(inp->inp_moptions);
 #endif
 	s = splnet();
-	LIST_REMOVE(inp, inp_hash);
+	in_pcbremhash(inp);
 	LIST_REMOVE(inp, inp_list);
 	splx(s);
 	FREE(inp, M_PCB);
@@ -505,21 +546,30 @@ in_rtchange(inp, _errno)
 	}
 }
 
+/*
+ * Find the PCB bound to lport that matches the other arguments best,
+ * counting INADDR_ANY on either side as a wildcard if flags allow it.
+ * Only the PCBs on the port's hash chain need to be looked at.
+ */
 struct inpcb *
-in_pcblookup(head, faddr, fport_arg, laddr, lport_arg, flags)
-	struct inpcbhead *head;
+in_pcblookup(pcbinfo, faddr, fport_arg, laddr, lport_arg, flags)
+	struct inpcbinfo *pcbinfo;
 	struct in_addr faddr, laddr;
 	u_int fport_arg, lport_arg;
 	int flags;
 {
 	register struct inpcb *inp, *match = NULL;
+	struct inpcbhead *head;
 	int matchwild = 3, wildcard;
 	u_short fport = fport_arg, lport = lport_arg;
 	int s;
 
 	s = splnet();
 
-	for (inp = head->lh_first; inp != NULL; inp = inp->inp_list.le_next) {
+	head = &pcbinfo->porthashbase[INP_PORTHASH(lport,
+	    pcbinfo->porthashsize)];
+	for (inp = head->lh_first; inp != NULL;
+	    inp = inp->inp_porthash.le_next) {
 		if (inp->inp_lport != lport)
 			continue;
 		wildcard = 0;
@@ -557,26 +607,36 @@ in_pcblookup(head, faddr, fport_arg, laddr, lport_arg, flags)
 }
 
 /*
- * Lookup PCB in hash list.
+ * Find the PCB for a packet. The connection with this exact address
+ * and port pair is looked up first; if there is none and wildcard is
+ * set, an unconnected PCB on the local port, preferably one bound to
+ * laddr.
  */
 struct inpcb *
-in_pcblookuphash(pcbinfo, faddr, fport_arg, laddr, lport_arg)
+in_pcblookuphash(pcbinfo, faddr, fport_arg, laddr, lport_arg, wildcard)
 	struct inpcbinfo *pcbinfo;
 	struct in_addr faddr, laddr;
 	u_int fport_arg, lport_arg;
+	int wildcard;
 {
+	struct inpcbstat *stat = pcbinfo->stat;
 	struct inpcbhead *head;
 	register struct inpcb *inp;
+	struct inpcb *local_wild = NULL;
 	u_short fport = fport_arg, lport = lport_arg;
+	u_long chain = 0;
 	int s;
 
 	s = splnet();
+	stat->pcbs_lookups++;
 	/*
 	 * First look for an exact match.
 	 */
-	head = &pcbinfo->hashbase[(faddr.s_addr + lport + fport) % pcbinfo->hashsize];
+	head = &pcbinfo->hashbase[INP_PCBHASH(faddr.s_addr, fport,
+	    laddr.s_addr, lport, pcbinfo->hashsize)];
 
 	for (inp = head->lh_first; inp != NULL; inp = inp->inp_hash.le_next) {
+		chain++;
 		if (inp->inp_faddr.s_addr != faddr.s_addr ||
 		    inp->inp_fport != fport ||
 		    inp->inp_lport != lport ||
@@ -590,40 +650,100 @@ in_pcblookuphash(pcbinfo, faddr, fport_arg, laddr, lport_arg)
 			LIST_REMOVE(inp, inp_hash);
 			LIST_INSERT_HEAD(head, inp, inp_hash);
 		}
-		break;
+		stat->pcbs_hashhits++;
+		goto done;
 	}
+	if (wildcard) {
+		/*
+		 * Then for a PCB listening on the port, bound to this
+		 * address or to any.
+		 */
+		head = &pcbinfo->wildbase[INP_PORTHASH(lport,
+		    pcbinfo->wildsize)];
+		for (inp = head->lh_first; inp != NULL;
+		    inp = inp->inp_hash.le_next) {
+			chain++;
+			if (inp->inp_lport != lport)
+				continue;
+			if (inp->inp_laddr.s_addr == laddr.s_addr)
+				break;
+			if (inp->inp_laddr.s_addr == INADDR_ANY &&
+			    local_wild == NULL)
+				local_wild = inp;
+		}
+		if (inp == NULL)
+			inp = local_wild;
+		if (inp != NULL) {
+			stat->pcbs_wildhits++;
+			goto done;
+		}
+	}
+	stat->pcbs_misses++;
+done:
+	stat->pcbs_compares += chain;
+	if (chain > stat->pcbs_maxchain)
+		stat->pcbs_maxchain = chain;
 	splx(s);
 	return (inp);
 }
 
 /*
- * Insert PCB into hash chain. Must be called at splnet.
+ * Insert PCB into the hash chains for its addresses. PCBs without a
+ * local port cannot receive anything and stay out of the tables.
+ * Must be called at splnet.
  */
 void
 in_pcbinshash(inp)
 	struct inpcb *inp;
 {
+	struct inpcbinfo *pcbinfo = inp->inp_pcbinfo;
 	struct inpcbhead *head;
 
-	head = &inp->inp_pcbinfo->hashbase[(inp->inp_faddr.s_addr +
-		inp->inp_lport + inp->inp_fport) % inp->inp_pcbinfo->hashsize];
-
+	if (inp->inp_lport == 0)
+		return;
+	if (inp->inp_faddr.s_addr != INADDR_ANY)
+		head = &pcbinfo->hashbase[INP_PCBHASH(inp->inp_faddr.s_addr,
+		    inp->inp_fport, inp->inp_laddr.s_addr, inp->inp_lport,
+		    pcbinfo->hashsize)];
+	else
+		head = &pcbinfo->wildbase[INP_PORTHASH(inp->inp_lport,
+		    pcbinfo->wildsize)];
 	LIST_INSERT_HEAD(head, inp, inp_hash);
+
+	head = &pcbinfo->porthashbase[INP_PORTHASH(inp->inp_lport,
+	    pcbinfo->porthashsize)];
+	LIST_INSERT_HEAD(head, inp, inp_porthash);
+
+	inp->inp_flags |= INP_INHASH;
+	pcbinfo->stat->pcbs_pcbs++;
+}
+
+/*
+ * Remove PCB from the hash chains. Must be called at splnet.
+ */
+static void
+in_pcbremhash(inp)
+	struct inpcb *inp;
+{
+	if ((inp->inp_flags & INP_INHASH) == 0)
+		return;
+	LIST_REMOVE(inp, inp_hash);
+	LIST_REMOVE(inp, inp_porthash);
+	inp->inp_flags &= ~INP_INHASH;
+	inp->inp_pcbinfo->stat->pcbs_pcbs--;
 }
 
+/*
+ * Move PCB to the chains for its current addresses.
+ */
 void
 in_pcbrehash(inp)
 	struct inpcb *inp;
 {
-	struct inpcbhead *head;
 	int s;
 
 	s = splnet();
-	LIST_REMOVE(inp, inp_hash);
-
-	head = &inp->inp_pcbinfo->hashbase[(inp->inp_faddr.s_addr +
-		inp->inp_lport + inp->inp_fport) % inp->inp_pcbinfo->hashsize];
-
-	LIST_INSERT_HEAD(head, inp, inp_hash);
+	in_pcbremhash(inp);
+	in_pcbinshash(inp);
 	splx(s);
 }
@@ -108,7 +108,7 @@ struct protosw inetsw[] = {
   NULL,
   ip_init,	NULL,		ip_slowtimo,	ip_drain,
 },
-{ SOCK_DGRAM,	&inetdomain,	IPPROTO_UDP,	PR_ATOMIC|PR_ADDR,
+{ SOCK_DGRAM,	&inetdomain,	IPPROTO_UDP,	PR_ATOMIC|PR_ADDR|PR_CKSUMDATA,
   udp_input,
   NULL,
   udp_ctlinput,
@@ -271,6 +271,8 @@ next:
 			m->m_pkthdr.len = ip->ip_len;
 		} else
 			m_adj(m, ip->ip_len - m->m_pkthdr.len);
+		/* The sum from the driver included the trimmed bytes */
+		m->m_flags &= ~M_CSUM_RCVD;
 	}
 
 	/*
@@ -343,6 +345,8 @@ ours:
 	 * but it's not worth the time; just let them time out.)
 	 */
 	if (ip->ip_off &~ IP_DF) {
+		/* The sum from the driver is of this fragment only */
+		m->m_flags &= ~M_CSUM_RCVD;
 		if (m->m_flags & M_EXT) {		/* XXX */
 			if ((m = m_pullup(m, sizeof (struct ip))) == 0) {
 				ipstat.ips_toosmall++;
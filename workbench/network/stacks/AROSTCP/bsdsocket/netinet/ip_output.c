@@ -112,6 +112,11 @@ int	STKARGFUN ip_output(void *args, ...)
 	if ((m->m_flags & M_PKTHDR) == 0)
 		panic("ip_output no HDR");
 #endif
+	/*
+	 * A packet looped back or forwarded must not carry a partial sum
+	 * into ip_input() again.
+	 */
+	m->m_flags &= ~(M_CSUM_DATA|M_CSUM_RCVD);
 	if (opt) {
 		m = ip_insertoptions(m, opt, &len);
 		hlen = len;
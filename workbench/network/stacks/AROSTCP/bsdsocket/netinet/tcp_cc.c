@@ -0,0 +1,298 @@
+/*
+ * Copyright (C) 2026 The AROS Dev Team
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place - Suite 330, Boston,
+ * MA 02111-1307, USA.
+ *
+ */
+
+/*
+ * TCP congestion control algorithms: NewReno (RFC 5681, RFC 6582)
+ * and CUBIC (RFC 9438).
+ *
+ * Windows are kept in bytes. CUBIC needs a finer clock than the 500ms
+ * tcp_now, so it reads the system time in milliseconds.
+ */
+
+#include <conf.h>
+
+#include <sys/param.h>
+#include <sys/systm.h>
+#include <sys/mbuf.h>
+#include <sys/socket.h>
+#include <sys/socketvar.h>
+#include <sys/protosw.h>
+#include <sys/time.h>
+
+#include <netinet/in.h>
+#include <netinet/in_systm.h>
+#include <netinet/ip.h>
+#include <netinet/in_pcb.h>
+#include <netinet/tcp.h>
+#include <netinet/tcp_fsm.h>
+#include <netinet/tcp_seq.h>
+#include <netinet/tcp_timer.h>
+#include <netinet/tcp_var.h>
+
+#include <kern/amiga_time.h>
+
+#include "tcp_cc.h"
+
+#include <netinet/tcp_cc_protos.h>
+
+int	tcp_cc_default = TCP_CC_CUBIC;
+
+/*
+ * Attach the default algorithm to a new connection.
+ */
+void
+tcp_cc_init(tp)
+	struct tcpcb *tp;
+{
+	int i = tcp_cc_default;
+
+	if (i < 0 || i >= TCP_CC_MAX)
+		i = TCP_CC_NEWRENO;
+	tp->t_cc = tcp_cc_algos[i];
+}
+
+/*
+ * Half the window in use, but not less than two segments.
+ */
+static u_long
+tcp_cc_halfwin(tp)
+	struct tcpcb *tp;
+{
+	u_int win = MIN(tp->snd_wnd, tp->snd_cwnd) / 2 / tp->t_maxseg;
+
+	if (win < 2)
+		win = 2;
+	return (win * tp->t_maxseg);
+}
+
+/*
+ * NewReno
+ */
+
+/*
+ * If the window gives us less than ssthresh packets in flight, open
+ * exponentially (maxseg per packet). Otherwise open linearly: maxseg
+ * per window (maxseg^2 / cwnd per packet).
+ */
+static void
+newreno_ack_received(tp, acked)
+	struct tcpcb *tp;
+	u_long acked;
+{
+	register u_int cw = tp->snd_cwnd;
+	register u_int incr = tp->t_maxseg;
+
+	if (cw > tp->snd_ssthresh)
+		incr = incr * incr / cw;
+	tp->snd_cwnd = MIN(cw + incr, TCP_MAXWIN<<tp->snd_scale);
+}
+
+static void
+newreno_cong_signal(tp, type)
+	struct tcpcb *tp;
+	int type;
+{
+	tp->snd_ssthresh = tcp_cc_halfwin(tp);
+	if (type == CC_RTO)
+		tp->snd_cwnd = tp->t_maxseg;
+}
+
+/*
+ * Deflate the window to ssthresh, or to what is in flight plus one
+ * segment if that is less, so that the full ack does not release a
+ * burst of segments (RFC 6582).
+ */
+static void
+newreno_post_recovery(tp)
+	struct tcpcb *tp;
+{
+	u_long flight = tp->snd_max - tp->snd_una;
+
+	if (flight < tp->snd_ssthresh)
+		tp->snd_cwnd = flight + tp->t_maxseg;
+	else
+		tp->snd_cwnd = tp->snd_ssthresh;
+}
+
+/*
+ * No acks are expected to clock out any data we send, slow start to
+ * get the ack clock running again.
+ */
+static void
+newreno_after_idle(tp)
+	struct tcpcb *tp;
+{
+	tp->snd_cwnd = tp->t_maxseg;
+}
+
+static struct tcp_cc_algo newreno = {
+	"NewReno",
+	newreno_ack_received,
+	newreno_cong_signal,
+	newreno_post_recovery,
+	newreno_after_idle
+};
+
+/*
+ * CUBIC
+ *
+ * After a loss the window grows along W(t) = C * (t - K)^3 + Wmax,
+ * where Wmax is the window before the loss and K the time it takes to
+ * get back there, so the window stays near Wmax for a while and then
+ * probes further. The window never grows slower than a Reno flow
+ * would. The factors are scaled by 1024.
+ */
+#define	CUBIC_SHIFT	10
+#define	CUBIC_BETA	717	/* window after a loss, 0.7 */
+#define	CUBIC_FC	870	/* fast convergence, (1 + beta) / 2 */
+#define	CUBIC_ALPHA	542	/* Reno friendly increase, 3(1-beta)/(1+beta) */
+#define	CUBIC_TMAX	100000	/* ms, limits t - K so t^3 cannot overflow */
+
+static u_long
+cubic_msecs(void)
+{
+	struct timeval now;
+
+	GetSysTime(&now);
+	return (now.tv_sec * 1000 + now.tv_usec / 1000);
+}
+
+/*
+ * Integer cube root, bit by bit.
+ */
+static u_long
+cubic_root(a)
+	u_int64_t a;
+{
+	u_int64_t x = 0, b;
+	int s;
+
+	for (s = 63; s >= 0; s -= 3) {
+		x <<= 1;
+		b = 3 * x * (x + 1) + 1;
+		if ((a >> s) >= b) {
+			a -= b << s;
+			x++;
+		}
+	}
+	return ((u_long)x);
+}
+
+static void
+cubic_ack_received(tp, acked)
+	struct tcpcb *tp;
+	u_long acked;
+{
+	u_long cwnd = tp->snd_cwnd, mss = tp->t_maxseg, now;
+	int64_t t, target;
+
+	/*
+	 * Slow start, and grow like NewReno until the first loss gives
+	 * us a Wmax.
+	 */
+	if (cwnd <= tp->snd_ssthresh || tp->t_cubic_wmax == 0) {
+		newreno_ack_received(tp, acked);
+		return;
+	}
+
+	now = cubic_msecs();
+	if (tp->t_cubic_epoch == 0) {
+		tp->t_cubic_epoch = now ? now : 1;
+		tp->t_cubic_west = cwnd;
+		if (cwnd < tp->t_cubic_wmax)
+			/* K = cbrt((Wmax - cwnd) / C), in ms */
+			tp->t_cubic_k = cubic_root((u_int64_t)
+			    (tp->t_cubic_wmax - cwnd) * 2500000000ULL / mss);
+		else {
+			tp->t_cubic_k = 0;
+			tp->t_cubic_wmax = cwnd;
+		}
+	}
+
+	/* Where the curve will be one round trip from now */
+	t = (int64_t)(now - tp->t_cubic_epoch) +
+	    (tp->t_srtt >> TCP_RTT_SHIFT) * 1000 / PR_SLOWHZ -
+	    (int64_t)tp->t_cubic_k;
+	if (t > CUBIC_TMAX)
+		t = CUBIC_TMAX;
+	else if (t < -CUBIC_TMAX)
+		t = -CUBIC_TMAX;
+	/* C = 0.4 segments per second^3 */
+	target = (int64_t)tp->t_cubic_wmax +
+	    t * t * t / 1000 * (int64_t)mss * 4 / 10000000;
+	if (target > (int64_t)(cwnd + cwnd / 2))
+		target = cwnd + cwnd / 2;
+
+	/* The window a Reno flow would have by now */
+	tp->t_cubic_west += (u_long)(((u_int64_t)mss * CUBIC_ALPHA * acked /
+	    cwnd) >> CUBIC_SHIFT);
+	if (target < (int64_t)tp->t_cubic_west)
+		target = tp->t_cubic_west;
+
+	if (target > (int64_t)cwnd)
+		cwnd += (u_long)((u_int64_t)(target - cwnd) * acked / cwnd);
+	tp->snd_cwnd = MIN(cwnd, TCP_MAXWIN<<tp->snd_scale);
+}
+
+static void
+cubic_cong_signal(tp, type)
+	struct tcpcb *tp;
+	int type;
+{
+	u_long cwnd = MIN(tp->snd_wnd, tp->snd_cwnd);
+
+	/*
+	 * If we lost before getting back to the previous Wmax another
+	 * flow is probably taking its share, make room for it sooner.
+	 */
+	if (cwnd < tp->t_cubic_wmax)
+		tp->t_cubic_wmax = (u_long)(((u_int64_t)cwnd * CUBIC_FC) >>
+		    CUBIC_SHIFT);
+	else
+		tp->t_cubic_wmax = cwnd;
+	tp->t_cubic_epoch = 0;
+
+	tp->snd_ssthresh = (u_long)(((u_int64_t)cwnd * CUBIC_BETA) >>
+	    CUBIC_SHIFT);
+	if (tp->snd_ssthresh < 2 * tp->t_maxseg)
+		tp->snd_ssthresh = 2 * tp->t_maxseg;
+	if (type == CC_RTO)
+		tp->snd_cwnd = tp->t_maxseg;
+}
+
+static void
+cubic_after_idle(tp)
+	struct tcpcb *tp;
+{
+	tp->t_cubic_epoch = 0;
+	tp->snd_cwnd = tp->t_maxseg;
+}
+
+static struct tcp_cc_algo cubic = {
+	"CUBIC",
+	cubic_ack_received,
+	cubic_cong_signal,
+	newreno_post_recovery,
+	cubic_after_idle
+};
+
+struct tcp_cc_algo *tcp_cc_algos[TCP_CC_MAX] = {
+	&newreno,		/* TCP_CC_NEWRENO */
+	&cubic			/* TCP_CC_CUBIC */
+};
@@ -0,0 +1,53 @@
+/*
+ * Copyright (C) 2026 The AROS Dev Team
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place - Suite 330, Boston,
+ * MA 02111-1307, USA.
+ *
+ */
+
+#ifndef NETINET_TCP_CC_H
+#define NETINET_TCP_CC_H
+
+/*
+ * Congestion control algorithms.
+ *
+ * Every connection gets the algorithm selected by tcp_cc_default (the
+ * TCP_CC configuration variable) when its tcpcb is created. Loss
+ * detection and fast recovery stay in tcp_input() and tcp_timers();
+ * the algorithm only decides how snd_cwnd and snd_ssthresh change.
+ */
+struct tcp_cc_algo {
+	const char *name;
+	/* new data acked outside of fast recovery */
+	void	(*ack_received) __P((struct tcpcb *, u_long acked));
+	/* loss detected, type is one of CC_* below */
+	void	(*cong_signal) __P((struct tcpcb *, int type));
+	/* fast recovery ended with a full ack */
+	void	(*post_recovery) __P((struct tcpcb *));
+	/* sending again after an idle period */
+	void	(*after_idle) __P((struct tcpcb *));
+};
+
+#define	CC_DUPACK	1	/* loss detected by duplicate acks */
+#define	CC_RTO		2	/* retransmit timeout */
+
+/* Indexes into tcp_cc_algos, same order as the TCP_CC keywords */
+#define	TCP_CC_NEWRENO	0
+#define	TCP_CC_CUBIC	1
+#define	TCP_CC_MAX	2
+
+extern struct tcp_cc_algo *tcp_cc_algos[TCP_CC_MAX];
+
+#endif /* !NETINET_TCP_CC_H */
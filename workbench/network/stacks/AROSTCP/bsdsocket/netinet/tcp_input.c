@@ -79,11 +79,18 @@ struct	tcpstat tcpstat;
 u_long	tcp_now;
 struct inpcbhead tcb;
 struct inpcbinfo tcbinfo;
+struct inpcbstat tcppcbstat;
 
 #endif /* TUBA_INCLUDE */
 
 #include <kern/uipc_socket2_protos.h>
 //#include <netinet/tcp_subr_protos.h>
+#include <netinet/tcp_sack_protos.h>
+
+#include "tcp_cc.h"
+#include "in_cksum.h"
+
+static void tcp_newreno_partial_ack __P((struct tcpcb *, struct tcpiphdr *));
 
 /*
  * Insert segment ti into reassembly queue of tcp with
@@ -207,6 +214,12 @@ tcp_reass(tp, ti, m)
                 p->m_nextpkt = m;
         }
 
+        /*
+         * Report the new out-of-order data first in our SACK option.
+         */
+        if (TCP_DO_SACK(tp))
+                tcp_sack_rcv_update(tp, ti->ti_seq, ti->ti_seq + ti->ti_len);
+
 present:
         /*
          * Present data to user, advancing rcv_nxt through
@@ -295,7 +308,16 @@ void tcp_input(void *arg, ...)
 	bzero(ti->ti_x1, sizeof(ti->ti_x1));
 	ti->ti_len = (u_short)tlen;
 	HTONS(ti->ti_len);
-	ti->ti_sum = in_cksum(m, len);
+	/*
+	 * If the driver copy summed the packet, the valid IP header
+	 * adds nothing to it and only the pseudo header is missing.
+	 */
+	if (m->m_flags & M_CSUM_RCVD)
+		ti->ti_sum = ~in_cksum_fold((u_int64_t)m->m_pkthdr.csum_data +
+		    in_pseudo(ti->ti_src.s_addr, ti->ti_dst.s_addr,
+		    htonl(tlen + IPPROTO_TCP))) & 0xffff;
+	else
+		ti->ti_sum = in_cksum(m, len);
 	if (ti->ti_sum) {
 		tcpstat.tcps_rcvbadsum++;
 		goto drop;
@@ -360,18 +382,8 @@ void tcp_input(void *arg, ...)
 	 * Locate pcb for segment.
 	 */
 findpcb:
-	/*
-	 * First look for an exact match.
-	 */
 	inp = in_pcblookuphash(&tcbinfo, ti->ti_src, ti->ti_sport,
-	    ti->ti_dst, ti->ti_dport);
-	/*
-	 * ...and if that fails, do a wildcard search.
-	 */
-	if (inp == NULL) {
-		inp = in_pcblookup(&tcb, ti->ti_src, ti->ti_sport,
-		    ti->ti_dst, ti->ti_dport, INPLOOKUP_WILDCARD);
-	}
+	    ti->ti_dst, ti->ti_dport, INPLOOKUP_WILDCARD);
 
 	/*
 	 * If the state is CLOSED (i.e., TCB does not exist) then
@@ -504,12 +516,19 @@ findpcb:
 		if (ti->ti_len == 0) {
 			if (SEQ_GT(ti->ti_ack, tp->snd_una) &&
 			    SEQ_LEQ(ti->ti_ack, tp->snd_max) &&
-			    tp->snd_cwnd >= tp->snd_wnd) {
+			    tp->snd_cwnd >= tp->snd_wnd &&
+			    (to.to_flag & TOF_SACK) == 0 &&
+			    !IN_FASTRECOVERY(tp)) {
 				/*
 				 * this is a pure ack for outstanding data.
 				 */
 				++tcpstat.tcps_predack;
-				if ((to.to_flag & TOF_TS) != 0)
+				/*
+				 * A zero echo reply means the peer has
+				 * nothing to echo (RFC 7323, section 3.2).
+				 */
+				if ((to.to_flag & TOF_TS) != 0 &&
+				    to.to_tsecr != 0)
 					tcp_xmit_timer(tp,
 					    tcp_now - to.to_tsecr + 1);
 				else if (tp->t_rtt &&
@@ -520,6 +539,9 @@ findpcb:
 				tcpstat.tcps_rcvackbyte += acked;
 				sbdrop(&so->so_snd, acked);
 				tp->snd_una = ti->ti_ack;
+				tp->t_dupacks = 0;
+				if (tp->snd_numsacks)
+					tcp_sack_clear(tp);
 				m_freem(m);
 
 				/*
@@ -1203,6 +1225,15 @@ trimthenstep6:
 	case TCPS_LAST_ACK:
 	case TCPS_TIME_WAIT:
 
+		/*
+		 * Update the SACK scoreboard before the ack is used
+		 * for loss detection.
+		 */
+		if (TCP_DO_SACK(tp) &&
+		    SEQ_GEQ(ti->ti_ack, tp->snd_una) &&
+		    SEQ_LEQ(ti->ti_ack, tp->snd_max))
+			tcp_sack_doack(tp, &to, ti->ti_ack);
+
 		if (SEQ_LEQ(ti->ti_ack, tp->snd_una)) {
 			if (ti->ti_len == 0 && tiwin == tp->snd_wnd) {
 				tcpstat.tcps_rcvdupack++;
@@ -1228,22 +1259,46 @@ trimthenstep6:
 				 * network (they're now cached at the receiver)
 				 * so bump cwnd by the amount in the receiver
 				 * to keep a constant cwnd packets in the
-				 * network.
+				 * network.  With SACK the scoreboard tells
+				 * exactly what has left the network and what
+				 * is lost, and tcp_output() retransmits the
+				 * holes as the pipe drains (RFC 6675).
 				 */
 				if (tp->t_timer[TCPT_REXMT] == 0 ||
 				    ti->ti_ack != tp->snd_una)
 					tp->t_dupacks = 0;
-				else if (++tp->t_dupacks == tcprexmtthresh) {
+				else if (IN_FASTRECOVERY(tp)) {
+					if (!TCP_DO_SACK(tp))
+						tp->snd_cwnd += tp->t_maxseg;
+					(void) tcp_output(tp);
+					goto drop;
+				} else if (++tp->t_dupacks == tcprexmtthresh) {
 					tcp_seq onxt = tp->snd_nxt;
-					u_int win =
-					    MIN(tp->snd_wnd, tp->snd_cwnd) / 2 /
-						tp->t_maxseg;
 
-					if (win < 2)
-						win = 2;
-					tp->snd_ssthresh = win * tp->t_maxseg;
+					/*
+					 * Do not start another recovery for
+					 * losses in the window that was
+					 * outstanding when the last one
+					 * started (RFC 6582, section 3.2).
+					 */
+					if (SEQ_LEQ(ti->ti_ack,
+					    tp->snd_recover)) {
+						tp->t_dupacks = 0;
+						break;
+					}
+					tcpstat.tcps_fastrecovery++;
+					(*tp->t_cc->cong_signal)(tp, CC_DUPACK);
+					tp->t_flags |= TF_FASTRECOVERY;
+					tp->snd_recover = tp->snd_max;
 					tp->t_timer[TCPT_REXMT] = 0;
 					tp->t_rtt = 0;
+					if (TCP_DO_SACK(tp)) {
+						tcpstat.tcps_sack_recovery++;
+						tp->sack_rxtnext = tp->snd_una;
+						tp->snd_cwnd = tp->snd_ssthresh;
+						(void) tcp_output(tp);
+						goto drop;
+					}
 					tp->snd_nxt = ti->ti_ack;
 					tp->snd_cwnd = tp->t_maxseg;
 					(void) tcp_output(tp);
@@ -1252,22 +1307,11 @@ trimthenstep6:
 					if (SEQ_GT(onxt, tp->snd_nxt))
 						tp->snd_nxt = onxt;
 					goto drop;
-				} else if (tp->t_dupacks > tcprexmtthresh) {
-					tp->snd_cwnd += tp->t_maxseg;
-					(void) tcp_output(tp);
-					goto drop;
 				}
 			} else
 				tp->t_dupacks = 0;
 			break;
 		}
-		/*
-		 * If the congestion window was inflated to account
-		 * for the other side's cached packets, retract it.
-		 */
-		if (tp->t_dupacks > tcprexmtthresh &&
-		    tp->snd_cwnd > tp->snd_ssthresh)
-			tp->snd_cwnd = tp->snd_ssthresh;
 		tp->t_dupacks = 0;
 		if (SEQ_GT(ti->ti_ack, tp->snd_max)) {
 			tcpstat.tcps_rcvacktoomuch++;
@@ -1287,6 +1331,19 @@ trimthenstep6:
 			tp->t_flags &= ~TF_NEEDSYN;
 			tp->snd_una++;
 		}
+		/*
+		 * An ack for part of the data outstanding when fast
+		 * recovery started means the next segment was lost as
+		 * well.  With SACK tcp_output() finds it in the
+		 * scoreboard, otherwise retransmit it now (RFC 6582).
+		 */
+		if (IN_FASTRECOVERY(tp) &&
+		    SEQ_LT(ti->ti_ack, tp->snd_recover)) {
+			if (TCP_DO_SACK(tp))
+				needoutput = 1;
+			else
+				tcp_newreno_partial_ack(tp, ti);
+		}
 
 process_ACK:
 		acked = ti->ti_ack - tp->snd_una;
@@ -1301,8 +1358,10 @@ process_ACK:
 		 * Since we now have an rtt measurement, cancel the
 		 * timer backoff (cf., Phil Karn's retransmit alg.).
 		 * Recompute the initial retransmit timer.
+		 * A zero timestamp echo reply is not valid for RTT
+		 * measurement (RFC 7323, section 3.2).
 		 */
-		if (to.to_flag & TOF_TS)
+		if ((to.to_flag & TOF_TS) != 0 && to.to_tsecr != 0)
 			tcp_xmit_timer(tp, tcp_now - to.to_tsecr + 1);
 		else if (tp->t_rtt && SEQ_GT(ti->ti_ack, tp->t_rtseq))
 			tcp_xmit_timer(tp,tp->t_rtt);
@@ -1327,20 +1386,12 @@ process_ACK:
 			goto step6;
 
 		/*
-		 * When new data is acked, open the congestion window.
-		 * If the window gives us less than ssthresh packets
-		 * in flight, open exponentially (maxseg per packet).
-		 * Otherwise open linearly: maxseg per window
-		 * (maxseg^2 / cwnd per packet).
+		 * When new data is acked, let the congestion control
+		 * algorithm open the window.  During fast recovery the
+		 * window is managed by the recovery code above.
 		 */
-		{
-		register u_int cw = tp->snd_cwnd;
-		register u_int incr = tp->t_maxseg;
-
-		if (cw > tp->snd_ssthresh)
-			incr = incr * incr / cw;
-		tp->snd_cwnd = MIN(cw + incr, TCP_MAXWIN<<tp->snd_scale);
-		}
+		if (!IN_FASTRECOVERY(tp))
+			(*tp->t_cc->ack_received)(tp, acked);
 		if (acked > so->so_snd.sb_cc) {
 			tp->snd_wnd -= so->so_snd.sb_cc;
 			sbdrop(&so->so_snd, (int)so->so_snd.sb_cc);
@@ -1355,6 +1406,15 @@ process_ACK:
 		tp->snd_una = ti->ti_ack;
 		if (SEQ_LT(tp->snd_nxt, tp->snd_una))
 			tp->snd_nxt = tp->snd_una;
+		/*
+		 * All data outstanding when fast recovery started
+		 * has been acked, recovery is over.
+		 */
+		if (IN_FASTRECOVERY(tp) &&
+		    SEQ_GEQ(tp->snd_una, tp->snd_recover)) {
+			tp->t_flags &= ~TF_FASTRECOVERY;
+			(*tp->t_cc->post_recovery)(tp);
+		}
 
 		switch (tp->t_state) {
 
@@ -1667,6 +1727,37 @@ drop:
 #ifndef TUBA_INCLUDE
 }
 
+/*
+ * A partial ack during NewReno fast recovery: retransmit the first
+ * unacked segment right away and deflate the window by the amount of
+ * new data acked, adding back one segment for the retransmission so
+ * roughly ssthresh bytes stay in flight (RFC 6582, section 3.2).
+ */
+static void
+tcp_newreno_partial_ack(tp, ti)
+	struct tcpcb *tp;
+	struct tcpiphdr *ti;
+{
+	tcp_seq onxt = tp->snd_nxt;
+	u_long ocwnd = tp->snd_cwnd;
+	u_long acked = ti->ti_ack - tp->snd_una;
+
+	tp->t_timer[TCPT_REXMT] = 0;
+	tp->t_rtt = 0;
+	tp->snd_nxt = ti->ti_ack;
+	/* snd_una has not moved yet, allow exactly one segment past ack */
+	tp->snd_cwnd = tp->t_maxseg + acked;
+	(void) tcp_output(tp);
+	tp->snd_cwnd = ocwnd;
+	if (SEQ_GT(onxt, tp->snd_nxt))
+		tp->snd_nxt = onxt;
+	if (tp->snd_cwnd > acked)
+		tp->snd_cwnd -= acked;
+	else
+		tp->snd_cwnd = 0;
+	tp->snd_cwnd += tp->t_maxseg;
+}
+
 void
 tcp_dooptions(tp, cp, cnt, ti, to)
 	struct tcpcb *tp;
@@ -1685,8 +1776,10 @@ tcp_dooptions(tp, cp, cnt, ti, to)
 		if (opt == TCPOPT_NOP)
 			optlen = 1;
 		else {
+			if (cnt < 2)
+				break;
 			optlen = cp[1];
-			if (optlen <= 0)
+			if (optlen < 2 || optlen > cnt)
 				break;
 		}
 		switch (opt) {
@@ -1715,6 +1808,13 @@ tcp_dooptions(tp, cp, cnt, ti, to)
 		case TCPOPT_TIMESTAMP:
 			if (optlen != TCPOLEN_TIMESTAMP)
 				continue;
+			/*
+			 * Timestamps not negotiated on the SYN are
+			 * ignored (RFC 7323, section 3.2).
+			 */
+			if (!(ti->ti_flags & TH_SYN) &&
+			    !(tp->t_flags & TF_RCVD_TSTMP))
+				continue;
 			to->to_flag |= TOF_TS;
 			bcopy((char *)cp + 2,
 			    (char *)&to->to_tsval, sizeof(to->to_tsval));
@@ -1772,6 +1872,23 @@ tcp_dooptions(tp, cp, cnt, ti, to)
 			    (char *)&to->to_ccecho, sizeof(to->to_ccecho));
 			NTOHL(to->to_ccecho);
 			break;
+		case TCPOPT_SACK_PERMITTED:
+			if (optlen != TCPOLEN_SACK_PERMITTED)
+				continue;
+			if (!(ti->ti_flags & TH_SYN))
+				continue;
+			tp->t_flags |= TF_SACK_PERMIT;
+			break;
+		case TCPOPT_SACK:
+			if (optlen <= TCPOLEN_SACKHDR ||
+			    (optlen - TCPOLEN_SACKHDR) % TCPOLEN_SACK != 0)
+				continue;
+			if (ti->ti_flags & TH_SYN)
+				continue;
+			to->to_flag |= TOF_SACK;
+			to->to_nsacks = (optlen - TCPOLEN_SACKHDR) / TCPOLEN_SACK;
+			to->to_sacks = cp + 2;
+			break;
 		}
 	}
 	if (ti->ti_flags & TH_SYN)
@@ -63,6 +63,9 @@
 #ifdef TCPDEBUG
 #include <netinet/tcp_debug.h>
 #endif
+#include <netinet/tcp_sack_protos.h>
+
+#include "tcp_cc.h"
 
 #ifdef notyet
 extern struct mbuf *m_copypack();
@@ -83,7 +86,8 @@ tcp_output(tp)
 	register struct tcpiphdr *ti;
 	u_char opt[TCP_MAXOLEN];
 	unsigned optlen, hdrlen;
-	int idle, sendalot;
+	int idle, sendalot, sack_rxmit;
+	tcp_seq sack_seq = 0;
 	struct rmxp_tao *taop;
 	struct rmxp_tao tao_noncached;
 
@@ -100,9 +104,10 @@ tcp_output(tp)
 		 * expected to clock out any data we send --
 		 * slow start to get ack "clock" running again.
 		 */
-		tp->snd_cwnd = tp->t_maxseg;
+		(*tp->t_cc->after_idle)(tp);
 again:
 	sendalot = 0;
+	sack_rxmit = 0;
 	off = tp->snd_nxt - tp->snd_una;
 	win = MIN(tp->snd_wnd, tp->snd_cwnd);
 
@@ -151,6 +156,38 @@ again:
 
 	len = MIN(so->so_snd.sb_cc, win) - off;
 
+	/*
+	 * During SACK recovery the congestion window limits the data
+	 * in flight as estimated from the scoreboard, not the data
+	 * past snd_una.  Retransmit the next lost range if the pipe
+	 * has room, otherwise send new data (RFC 6675, section 5).
+	 * The first unacked segment is resent regardless.
+	 */
+	if (IN_FASTRECOVERY(tp) && TCP_DO_SACK(tp) && tp->t_force == 0) {
+		long cwin = tp->snd_cwnd - tcp_sack_pipe(tp);
+		long hlen;
+
+		if (cwin < 0)
+			cwin = 0;
+		if (tcp_sack_nexthole(tp, &sack_seq, &hlen) &&
+		    (cwin > 0 || sack_seq == tp->snd_una)) {
+			off = sack_seq - tp->snd_una;
+			len = MIN(hlen, (long)so->so_snd.sb_cc - off);
+			if (cwin > 0 && len > cwin)
+				len = cwin;
+			if (len > 0) {
+				sack_rxmit = 1;
+				sendalot = 1;
+			}
+		}
+		if (!sack_rxmit) {
+			off = tp->snd_nxt - tp->snd_una;
+			len = MIN(so->so_snd.sb_cc, tp->snd_wnd) - off;
+			if (len > cwin)
+				len = cwin;
+		}
+	}
+
 	if ((taop = tcp_gettaocache(tp->t_inpcb)) == NULL) {
 		taop = &tao_noncached;
 		bzero(taop, sizeof(*taop));
@@ -190,11 +227,15 @@ again:
 		len = tp->t_maxseg;
 		sendalot = 1;
 	}
-	if (SEQ_LT(tp->snd_nxt + len, tp->snd_una + so->so_snd.sb_cc))
+	if (sack_rxmit ||
+	    SEQ_LT(tp->snd_nxt + len, tp->snd_una + so->so_snd.sb_cc))
 		flags &= ~TH_FIN;
 
 	win = sbspace(&so->so_rcv);
 
+	if (sack_rxmit)
+		goto send;
+
 	/*
 	 * Sender silly window avoidance.  If connection is idle
 	 * and can send all data, a maximum segment,
@@ -326,6 +367,21 @@ send:
 					tp->request_r_scale);
 				optlen += 4;
 			}
+
+			/*
+			 * Offer SACK if we want it; on a SYN,ACK only
+			 * when the peer has offered it too.
+			 */
+			if ((tp->t_flags & TF_REQ_SACK) &&
+			    ((flags & TH_ACK) == 0 ||
+			    (tp->t_flags & TF_SACK_PERMIT))) {
+				*((u_int32_t *) (opt + optlen)) = htonl(
+					TCPOPT_NOP << 24 |
+					TCPOPT_NOP << 16 |
+					TCPOPT_SACK_PERMITTED << 8 |
+					TCPOLEN_SACK_PERMITTED);
+				optlen += 4;
+			}
 		}
  	}
 
@@ -436,6 +492,13 @@ send:
 		}
  	}
 
+	/*
+	 * Tell a SACK capable peer about the out-of-order data we hold.
+	 */
+	if (TCP_DO_SACK(tp) && tp->rcv_numsacks > 0 &&
+	    (flags & (TH_SYN|TH_RST)) == 0)
+		optlen = tcp_sack_option(tp, opt, optlen);
+
  	hdrlen += optlen;
 
 	/*
@@ -467,9 +530,13 @@ send:
 	if (len) {
 		if (tp->t_force && len == 1)
 			tcpstat.tcps_sndprobe++;
-		else if (SEQ_LT(tp->snd_nxt, tp->snd_max)) {
+		else if (sack_rxmit || SEQ_LT(tp->snd_nxt, tp->snd_max)) {
 			tcpstat.tcps_sndrexmitpack++;
 			tcpstat.tcps_sndrexmitbyte += len;
+			if (sack_rxmit) {
+				tcpstat.tcps_sack_rexmits++;
+				tcpstat.tcps_sack_rexmit_bytes += len;
+			}
 		} else {
 			tcpstat.tcps_sndpack++;
 			tcpstat.tcps_sndbyte += len;
@@ -556,7 +623,9 @@ send:
 	 * case, since we know we aren't doing a retransmission.
 	 * (retransmit and persist are mutually exclusive...)
 	 */
-	if (len || (flags & (TH_SYN|TH_FIN)) || tp->t_timer[TCPT_PERSIST])
+	if (sack_rxmit)
+		ti->ti_seq = htonl(sack_seq);
+	else if (len || (flags & (TH_SYN|TH_FIN)) || tp->t_timer[TCPT_PERSIST])
 		ti->ti_seq = htonl(tp->snd_nxt);
 	else
 		ti->ti_seq = htonl(tp->snd_max);
@@ -616,7 +685,14 @@ send:
 				tp->t_flags |= TF_SENTFIN;
 			}
 		}
-		tp->snd_nxt += len;
+		/*
+		 * A SACK retransmission only moves the retransmission
+		 * point, snd_nxt keeps pointing at new data.
+		 */
+		if (sack_rxmit)
+			tp->sack_rxtnext = sack_seq + len;
+		else
+			tp->snd_nxt += len;
 		if (SEQ_GT(tp->snd_nxt, tp->snd_max)) {
 			tp->snd_max = tp->snd_nxt;
 			/*
@@ -0,0 +1,316 @@
+/*
+ * Copyright (C) 2026 The AROS Dev Team
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place - Suite 330, Boston,
+ * MA 02111-1307, USA.
+ *
+ */
+
+/*
+ * TCP selective acknowledgements (RFC 2018) and SACK based loss
+ * recovery (after RFC 6675).
+ *
+ * The receiver remembers the blocks of out-of-order data it has queued
+ * in rcv_sack, the block with the latest segment first, and reports
+ * them in every ACK while there is a hole.
+ *
+ * The sender keeps the blocks reported by the peer in snd_sack, a small
+ * sorted scoreboard above snd_una. Everything below the highest sacked
+ * byte that is not sacked itself is considered lost. In fast recovery
+ * the lost ranges are retransmitted in order from sack_rxtnext, and the
+ * data in flight (the "pipe") is estimated as what was sent above the
+ * highest sacked byte plus what has been retransmitted.
+ */
+
+#include <conf.h>
+
+#include <sys/param.h>
+#include <sys/systm.h>
+#include <sys/mbuf.h>
+#include <sys/socket.h>
+#include <sys/socketvar.h>
+#include <sys/protosw.h>
+
+#include <netinet/in.h>
+#include <netinet/in_systm.h>
+#include <netinet/ip.h>
+#include <netinet/in_pcb.h>
+#include <netinet/tcp.h>
+#include <netinet/tcp_fsm.h>
+#include <netinet/tcp_seq.h>
+#include <netinet/tcp_timer.h>
+#include <netinet/tcp_var.h>
+
+#include <netinet/tcp_sack_protos.h>
+
+/*
+ * Note that the receiver has queued out-of-order data from start to
+ * end. The block containing it becomes the first one reported; blocks
+ * it overlaps or touches are merged into it.
+ */
+void
+tcp_sack_rcv_update(tp, start, end)
+	struct tcpcb *tp;
+	tcp_seq start, end;
+{
+	struct sackblk blks[MAX_SACK_BLKS];
+	int i, n = 1;
+
+	for (i = 0; i < tp->rcv_numsacks; i++) {
+		struct sackblk *sb = &tp->rcv_sack[i];
+
+		if (SEQ_LEQ(sb->end, tp->rcv_nxt))
+			continue;
+		if (SEQ_LEQ(sb->start, end) && SEQ_GEQ(sb->end, start)) {
+			if (SEQ_LT(sb->start, start))
+				start = sb->start;
+			if (SEQ_GT(sb->end, end))
+				end = sb->end;
+		} else if (n < MAX_SACK_BLKS)
+			blks[n++] = *sb;
+	}
+	blks[0].start = start;
+	blks[0].end = end;
+
+	bcopy(blks, tp->rcv_sack, n * sizeof(struct sackblk));
+	tp->rcv_numsacks = n;
+}
+
+/*
+ * Append a SACK option with as many blocks as fit after the other
+ * options. Returns the new length of the options.
+ */
+unsigned
+tcp_sack_option(tp, opt, optlen)
+	struct tcpcb *tp;
+	u_char *opt;
+	unsigned optlen;
+{
+	int i, n, count;
+	u_int32_t seq;
+
+	/* Forget blocks the cumulative ack has caught up with */
+	for (i = n = 0; i < tp->rcv_numsacks; i++) {
+		struct sackblk *sb = &tp->rcv_sack[i];
+
+		if (SEQ_LEQ(sb->end, tp->rcv_nxt))
+			continue;
+		if (SEQ_LT(sb->start, tp->rcv_nxt))
+			sb->start = tp->rcv_nxt;
+		tp->rcv_sack[n++] = *sb;
+	}
+	tp->rcv_numsacks = n;
+
+	count = (TCP_MAXOLEN - optlen - 2 * TCPOLEN_NOP - TCPOLEN_SACKHDR) /
+	    TCPOLEN_SACK;
+	if (count > n)
+		count = n;
+	if (count > TCP_MAX_SACK)
+		count = TCP_MAX_SACK;
+	if (count <= 0)
+		return (optlen);
+
+	opt[optlen++] = TCPOPT_NOP;
+	opt[optlen++] = TCPOPT_NOP;
+	opt[optlen++] = TCPOPT_SACK;
+	opt[optlen++] = TCPOLEN_SACKHDR + count * TCPOLEN_SACK;
+	for (i = 0; i < count; i++) {
+		seq = htonl(tp->rcv_sack[i].start);
+		bcopy(&seq, opt + optlen, sizeof(seq));
+		seq = htonl(tp->rcv_sack[i].end);
+		bcopy(&seq, opt + optlen + 4, sizeof(seq));
+		optlen += TCPOLEN_SACK;
+	}
+	tcpstat.tcps_sack_sndblocks += count;
+	return (optlen);
+}
+
+/*
+ * Insert a block into the scoreboard, merging it with the blocks it
+ * overlaps or touches. If the scoreboard is full the lowest block is
+ * forgotten; its data will only be retransmitted needlessly.
+ */
+static void
+tcp_sack_insert(tp, start, end)
+	struct tcpcb *tp;
+	tcp_seq start, end;
+{
+	struct sackblk *sb = tp->snd_sack;
+	int i, j, n = tp->snd_numsacks;
+
+	/* Find the first block that ends at or after the new one starts */
+	for (i = 0; i < n && SEQ_LT(sb[i].end, start); i++)
+		;
+	/* Absorb all blocks that overlap or touch the new one */
+	for (j = i; j < n && SEQ_LEQ(sb[j].start, end); j++) {
+		if (SEQ_LT(sb[j].start, start))
+			start = sb[j].start;
+		if (SEQ_GT(sb[j].end, end))
+			end = sb[j].end;
+	}
+	if (i == j) {
+		/* Nothing merged, make room at i */
+		if (n == TCP_SACK_SCOREBOARD) {
+			if (i == 0)
+				return;
+			bcopy(&sb[1], &sb[0], (i - 1) * sizeof(*sb));
+			i--;
+		} else {
+			bcopy(&sb[i], &sb[i + 1], (n - i) * sizeof(*sb));
+			n++;
+		}
+	} else if (j > i + 1) {
+		/* Blocks i to j - 1 become one */
+		bcopy(&sb[j], &sb[i + 1], (n - j) * sizeof(*sb));
+		n -= j - i - 1;
+	}
+	sb[i].start = start;
+	sb[i].end = end;
+	tp->snd_numsacks = n;
+}
+
+/*
+ * Process an ACK on the sending side: drop the scoreboard below the
+ * cumulative ack and add the blocks of the SACK option, if any.
+ */
+void
+tcp_sack_doack(tp, to, ack)
+	struct tcpcb *tp;
+	struct tcpopt *to;
+	tcp_seq ack;
+{
+	struct sackblk *sb = tp->snd_sack;
+	tcp_seq start, end;
+	int i, n;
+
+	for (i = n = 0; i < tp->snd_numsacks; i++) {
+		if (SEQ_LEQ(sb[i].end, ack))
+			continue;
+		if (SEQ_LT(sb[i].start, ack))
+			sb[i].start = ack;
+		sb[n++] = sb[i];
+	}
+	tp->snd_numsacks = n;
+	if (SEQ_LT(tp->sack_rxtnext, ack))
+		tp->sack_rxtnext = ack;
+
+	if ((to->to_flag & TOF_SACK) == 0)
+		return;
+	for (i = 0; i < to->to_nsacks; i++) {
+		bcopy(to->to_sacks + i * TCPOLEN_SACK, &start, sizeof(start));
+		bcopy(to->to_sacks + i * TCPOLEN_SACK + 4, &end, sizeof(end));
+		NTOHL(start);
+		NTOHL(end);
+		tcpstat.tcps_sack_rcvblocks++;
+		/*
+		 * Ignore blocks at or below the cumulative ack (D-SACK)
+		 * and blocks for data we have not sent.
+		 */
+		if (SEQ_GEQ(start, end) || SEQ_LEQ(end, ack) ||
+		    SEQ_GT(end, tp->snd_max))
+			continue;
+		if (SEQ_LT(start, ack))
+			start = ack;
+		tcp_sack_insert(tp, start, end);
+	}
+}
+
+/*
+ * Forget everything the peer has sacked. After a retransmit timeout
+ * the receiver may have discarded the data (RFC 2018, section 8).
+ */
+void
+tcp_sack_clear(tp)
+	struct tcpcb *tp;
+{
+	tp->snd_numsacks = 0;
+	tp->sack_rxtnext = tp->snd_una;
+}
+
+/*
+ * Everything below this is lost unless sacked. The first unacked
+ * segment always is, since recovery starts with retransmitting it.
+ */
+static tcp_seq
+tcp_sack_lostend(tp)
+	struct tcpcb *tp;
+{
+	tcp_seq lost = tp->snd_una + tp->t_maxseg;
+
+	if (tp->snd_numsacks > 0 &&
+	    SEQ_GT(tp->snd_sack[tp->snd_numsacks - 1].end, lost))
+		lost = tp->snd_sack[tp->snd_numsacks - 1].end;
+	if (SEQ_GT(lost, tp->snd_max))
+		lost = tp->snd_max;
+	return (lost);
+}
+
+/*
+ * Estimate the data in flight: what was sent after the lost range,
+ * plus the lost data that has been retransmitted.
+ */
+u_long
+tcp_sack_pipe(tp)
+	struct tcpcb *tp;
+{
+	tcp_seq lost = tcp_sack_lostend(tp);
+	tcp_seq seq = tp->snd_una, rxt = tp->sack_rxtnext;
+	u_long pipe = tp->snd_max - lost;
+	int i;
+
+	if (SEQ_GT(rxt, lost))
+		rxt = lost;
+	for (i = 0; i < tp->snd_numsacks && SEQ_LT(seq, rxt); i++) {
+		if (SEQ_GT(tp->snd_sack[i].start, seq))
+			pipe += (SEQ_LT(tp->snd_sack[i].start, rxt) ?
+			    tp->snd_sack[i].start : rxt) - seq;
+		seq = tp->snd_sack[i].end;
+	}
+	if (SEQ_LT(seq, rxt))
+		pipe += rxt - seq;
+	return (pipe);
+}
+
+/*
+ * Find the next lost range that has not been retransmitted yet.
+ * Returns 0 if there is none.
+ */
+int
+tcp_sack_nexthole(tp, seqp, lenp)
+	struct tcpcb *tp;
+	tcp_seq *seqp;
+	long *lenp;
+{
+	tcp_seq lost = tcp_sack_lostend(tp);
+	tcp_seq seq = tp->sack_rxtnext;
+	int i;
+
+	if (SEQ_LT(seq, tp->snd_una))
+		seq = tp->snd_una;
+	for (i = 0; i < tp->snd_numsacks; i++) {
+		if (SEQ_LEQ(tp->snd_sack[i].end, seq))
+			continue;
+		if (SEQ_GT(tp->snd_sack[i].start, seq))
+			break;
+		/* seq is inside a sacked block, skip past it */
+		seq = tp->snd_sack[i].end;
+	}
+	if (SEQ_GEQ(seq, lost))
+		return (0);
+	if (i < tp->snd_numsacks && SEQ_LT(tp->snd_sack[i].start, lost))
+		lost = tp->snd_sack[i].start;
+	*seqp = seq;
+	*lenp = lost - seq;
+	return (1);
+}
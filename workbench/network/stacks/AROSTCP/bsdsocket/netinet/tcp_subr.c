@@ -68,6 +68,7 @@
 #include "tcp_compat.h"
 
 #include <kern/kern_subr_protos.h>
+#include <netinet/tcp_cc_protos.h>
 
 /* patchable/settable parameters for tcp */
 int	ip_defttl = 60;				  /* default time to live for TCP segs */
@@ -75,17 +76,24 @@ int 	tcp_mssdflt = TCP_MSS;
 int 	tcp_rttdflt = TCPTV_SRTTDFLT / PR_SLOWHZ;
 int	tcp_do_rfc1323 = 1;
 int	tcp_do_rfc1644 = 1;
+int	tcp_do_sack = 1;
 static	void tcp_cleartaocache(void);
 
 extern u_char inetctlerrmap[];
 extern struct in_addr zeroin_addr;
 
 /*
- * Target size of TCP PCB hash table. Will be rounded down to a prime
- * number.
+ * Target sizes of the TCP PCB hash tables: connections, listening
+ * sockets and local ports. Will be rounded down to prime numbers.
  */
 #ifndef TCBHASHSIZE
-#define TCBHASHSIZE	128
+#define TCBHASHSIZE	4096
+#endif
+#ifndef TCBWILDHASHSIZE
+#define TCBWILDHASHSIZE	64
+#endif
+#ifndef TCBPORTHASHSIZE
+#define TCBPORTHASHSIZE	512
 #endif
 
 /*
@@ -98,9 +106,8 @@ tcp_init()
 	tcp_iss = 1;		/* wrong */
 	tcp_ccgen = 1;
 	tcp_cleartaocache();
-	LIST_INIT(&tcb);
-	tcbinfo.listhead = &tcb;
-	tcbinfo.hashbase = phashinit(TCBHASHSIZE, M_PCB, &tcbinfo.hashsize);
+	in_pcbinfo_init(&tcbinfo, &tcb, &tcppcbstat, TCBHASHSIZE,
+	    TCBWILDHASHSIZE, TCBPORTHASHSIZE);
 	if (max_protohdr < sizeof(struct tcpiphdr))
 		max_protohdr = sizeof(struct tcpiphdr);
 	if (max_linkhdr + sizeof(struct tcpiphdr) > MHLEN)
@@ -252,6 +259,9 @@ tcp_newtcpcb(inp)
 		tp->t_flags = (TF_REQ_SCALE|TF_REQ_TSTMP);
 	if (tcp_do_rfc1644)
 		tp->t_flags |= TF_REQ_CC;
+	if (tcp_do_sack)
+		tp->t_flags |= TF_REQ_SACK;
+	tcp_cc_init(tp);
 	tp->t_inpcb = inp;
 	/*
 	 * Init srtt to TCPTV_SRTTBASE (0), so we can tell that we have no
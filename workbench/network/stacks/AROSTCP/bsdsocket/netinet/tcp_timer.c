@@ -69,6 +69,9 @@ int	tcp_maxidle;
 #endif /* TUBA_INCLUDE */
 
 #include "tcp_compat.h"
+#include "tcp_cc.h"
+
+#include <netinet/tcp_sack_protos.h>
 
 /*
  * Fast timeout routine for processing delayed acks
@@ -254,15 +257,18 @@ tcp_timers(tp, timer)
 		 * (the minimum cwnd that will give us exponential
 		 * growth is 2 mss.  We don't allow the threshhold
 		 * to go below this.)
+		 *
+		 * The congestion control algorithm picks the threshhold.
+		 * Any fast recovery in progress is abandoned, and the
+		 * SACK scoreboard is forgotten since the receiver may
+		 * have dropped what it sacked.  Dup acks for data sent
+		 * before the timeout must not start a new recovery.
 		 */
-		{
-		u_int win = MIN(tp->snd_wnd, tp->snd_cwnd) / 2 / tp->t_maxseg;
-		if (win < 2)
-			win = 2;
-		tp->snd_cwnd = tp->t_maxseg;
-		tp->snd_ssthresh = win * tp->t_maxseg;
+		(*tp->t_cc->cong_signal)(tp, CC_RTO);
 		tp->t_dupacks = 0;
-		}
+		tp->t_flags &= ~TF_FASTRECOVERY;
+		tp->snd_recover = tp->snd_max;
+		tcp_sack_clear(tp);
 		(void) tcp_output(tp);
 		break;
 
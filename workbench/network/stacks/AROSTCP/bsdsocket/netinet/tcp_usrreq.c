@@ -415,7 +415,7 @@ tcp_connect(tp, nam)
 	error = in_pcbladdr(inp, nam, &ifaddr);
 	if (error)
 		return error;
-	oinp = in_pcblookup(inp->inp_pcbinfo->listhead,
+	oinp = in_pcblookuphash(inp->inp_pcbinfo,
 	    sin->sin_addr, sin->sin_port,
 	    inp->inp_laddr.s_addr != INADDR_ANY ? inp->inp_laddr
 						: ifaddr->sin_addr,
@@ -716,6 +716,12 @@ tcp_sysctl(name, namelen, oldp, oldlenp, newp, newlen)
 	case TCPCTL_RECVSPACE:
 		return (sysctl_int(oldp, oldlenp, newp, newlen,
 				   (int *)&tcp_recvspace)); /* XXX */
+	case TCPCTL_DO_SACK:
+		return (sysctl_int(oldp, oldlenp, newp, newlen,
+				   &tcp_do_sack));
+	case TCPCTL_CC:
+		return (sysctl_int(oldp, oldlenp, newp, newlen,
+				   &tcp_cc_default));
 	default:
 		return (ENOPROTOOPT);
 	}
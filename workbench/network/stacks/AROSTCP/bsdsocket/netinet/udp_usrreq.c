@@ -66,6 +66,8 @@
 
 #include <kern/kern_subr_protos.h>
 
+#include "in_cksum.h"
+
 /*
  * UDP protocol implementation.
  * Per RFC 768, August, 1980.
@@ -82,8 +84,15 @@ struct	inpcbinfo udbinfo;
 #ifndef UDBHASHSIZE
 #define UDBHASHSIZE 64
 #endif
+#ifndef UDBWILDHASHSIZE
+#define UDBWILDHASHSIZE 256
+#endif
+#ifndef UDBPORTHASHSIZE
+#define UDBPORTHASHSIZE 256
+#endif
 
 struct	udpstat udpstat;	/* from udp_var.h */
+struct	inpcbstat udppcbstat;	/* from udp_var.h */
 
 struct	sockaddr_in udp_in = { sizeof(udp_in), AF_INET };
 
@@ -98,9 +107,8 @@ static	struct mbuf *udp_saveopt __P((caddr_t, int, int));
 void
 udp_init()
 {
-	LIST_INIT(&udb);
-	udbinfo.listhead = &udb;
-	udbinfo.hashbase = phashinit(UDBHASHSIZE, M_PCB, &udbinfo.hashsize);
+	in_pcbinfo_init(&udbinfo, &udb, &udppcbstat, UDBHASHSIZE,
+	    UDBWILDHASHSIZE, UDBPORTHASHSIZE);
 }
 
 void udp_input(void *args, ...)
@@ -156,6 +164,7 @@ void udp_input(void *args, ...)
 			goto bad;
 		}
 		m_adj(m, len - ip->ip_len);
+		m->m_flags &= ~M_CSUM_RCVD;
 		/* ip->ip_len = len; */
 	}
 	/*
@@ -168,9 +177,20 @@ void udp_input(void *args, ...)
 	 * Checksum extended UDP header and data.
 	 */
 	if (udpcksum && uh->uh_sum) {
-		bzero(((struct ipovly *)ip)->ih_x1, 9);
-		((struct ipovly *)ip)->ih_len = uh->uh_ulen;
-		uh->uh_sum = in_cksum(m, len + sizeof (struct ip));
+		/*
+		 * If the driver copy summed the packet, the valid IP
+		 * header adds nothing to it and only the pseudo header
+		 * is missing.
+		 */
+		if (m->m_flags & M_CSUM_RCVD)
+			uh->uh_sum = ~in_cksum_fold((u_int64_t)
+			    m->m_pkthdr.csum_data + in_pseudo(ip->ip_src.s_addr,
+			    ip->ip_dst.s_addr, htonl(len + IPPROTO_UDP))) & 0xffff;
+		else {
+			bzero(((struct ipovly *)ip)->ih_x1, 9);
+			((struct ipovly *)ip)->ih_len = uh->uh_ulen;
+			uh->uh_sum = in_cksum(m, len + sizeof (struct ip));
+		}
 		if (uh->uh_sum) {
 			udpstat.udps_badsum++;
 			m_freem(m);
@@ -205,11 +225,14 @@ void udp_input(void *args, ...)
 		m->m_len -= sizeof (struct udpiphdr);
 		m->m_data += sizeof (struct udpiphdr);
 		/*
-		 * Locate pcb(s) for datagram.
+		 * Locate pcb(s) for datagram. All of them are on the
+		 * hash chain of the destination port.
 		 * (Algorithm copied from raw_intr().)
 		 */
 		last = NULL;
-		for (inp = udb.lh_first; inp != NULL; inp = inp->inp_list.le_next) {
+		for (inp = udbinfo.porthashbase[INP_PORTHASH(uh->uh_dport,
+		    udbinfo.porthashsize)].lh_first; inp != NULL;
+		    inp = inp->inp_porthash.le_next) {
 			if (inp->inp_lport != uh->uh_dport)
 				continue;
 			if (inp->inp_laddr.s_addr != INADDR_ANY) {
@@ -268,17 +291,10 @@ void udp_input(void *args, ...)
 		return;
 	}
 	/*
-	 * Locate pcb for datagram. First look for an exact match.
+	 * Locate pcb for datagram.
 	 */
 	inp = in_pcblookuphash(&udbinfo, ip->ip_src, uh->uh_sport,
-	    ip->ip_dst, uh->uh_dport);
-	/*
-	 * ...and if that fails, do a wildcard search.
-	 */
-	if (inp == NULL) {
-		inp = in_pcblookup(&udb, ip->ip_src, uh->uh_sport, ip->ip_dst,
-		    uh->uh_dport, INPLOOKUP_WILDCARD);
-	}
+	    ip->ip_dst, uh->uh_dport, INPLOOKUP_WILDCARD);
 	if (inp == NULL) {
 		udpstat.udps_noport++;
 		if (m->m_flags & (M_BCAST | M_MCAST)) {
@@ -407,7 +423,7 @@ udp_output(void *arg, ...)
 	register struct udpiphdr *ui;
 	register int len;
 	struct in_addr laddr;
-	int s = 0, error = 0;
+	int s = 0, error = 0, datasum = -1;
 	va_list va;
 
 	va_start(va, arg);
@@ -417,6 +433,11 @@ udp_output(void *arg, ...)
 	va_end(va);
 
 	len = m->m_pkthdr.len;
+	/* sosend() may have summed the data while copying it */
+	if (m->m_flags & M_CSUM_DATA) {
+		datasum = m->m_pkthdr.csum_data;
+		m->m_flags &= ~M_CSUM_DATA;
+	}
 
 	if (control)
 		m_freem(control);		/* XXX */
@@ -473,7 +494,12 @@ udp_output(void *arg, ...)
 	 */
 	ui->ui_sum = 0;
 	if (udpcksum) {
-	    if ((ui->ui_sum = in_cksum(m, sizeof (struct udpiphdr) + len)) == 0)
+	    if (datasum >= 0)
+		ui->ui_sum = ~in_cksum_fold((u_int64_t)datasum +
+		    in_cksum_block(ui, sizeof (struct udpiphdr))) & 0xffff;
+	    else
+		ui->ui_sum = in_cksum(m, sizeof (struct udpiphdr) + len);
+	    if (ui->ui_sum == 0)
 		ui->ui_sum = 0xffff;
 	}
 	((struct ip *)ui)->ip_len = sizeof (struct udpiphdr) + len;
@@ -0,0 +1,15 @@
+/* Prototypes for functions defined in amiga_eventset.c
+ */
+
+void eventset_init(void);
+
+void eventset_wakeup(struct socket * so,
+                     ULONG events);
+
+void eventset_sofree(struct socket * so);
+
+void eventset_closefd(struct SocketBase * p,
+                      LONG fd,
+                      struct socket * so);
+
+void eventset_cleanup(struct SocketBase * p);
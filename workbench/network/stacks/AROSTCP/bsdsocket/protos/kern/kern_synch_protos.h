@@ -15,6 +15,10 @@ int tsleep(struct SocketBase * , caddr_t , char * , struct timeval const * );
 
 void wakeup(caddr_t );
 
+void netlock_init(struct netlock * , const char * );
+
+LONG netlock_read_stats(struct CSource * , UBYTE ** , struct CSource * );
+
 BOOL spl_init(void);
 
 int spl_n(int );
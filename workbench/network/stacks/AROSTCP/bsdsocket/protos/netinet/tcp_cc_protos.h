@@ -0,0 +1,5 @@
+/* Prototypes for functions defined in
+tcp_cc.c
+ */
+
+void tcp_cc_init(struct tcpcb * tp);
@@ -0,0 +1,23 @@
+/* Prototypes for functions defined in
+tcp_sack.c
+ */
+
+void tcp_sack_rcv_update(struct tcpcb * tp,
+                tcp_seq start,
+                tcp_seq end);
+
+unsigned tcp_sack_option(struct tcpcb * tp,
+                u_char * opt,
+                unsigned optlen);
+
+void tcp_sack_doack(struct tcpcb * tp,
+                struct tcpopt * to,
+                tcp_seq ack);
+
+void tcp_sack_clear(struct tcpcb * tp);
+
+u_long tcp_sack_pipe(struct tcpcb * tp);
+
+int tcp_sack_nexthole(struct tcpcb * tp,
+                tcp_seq * seqp,
+                long * lenp);
@@ -49,6 +49,80 @@ extern int  tsleep_main(struct SocketBase *, ULONG blockmask);
 extern int  tsleep(struct SocketBase *, caddr_t, const char *,const struct timeval *);
 extern void wakeup(caddr_t);
 
+/*
+ * Network locks
+ *
+ * A netlock is a signal semaphore with a name and counters telling how
+ * often it was obtained and how often the caller had to wait for it.
+ * All netlocks are linked together so that the counters can be read
+ * with the LOCK_STATS configuration variable.
+ *
+ * The locks must be obtained in this order:
+ *
+ *   syscall -> spl -> mbuf
+ *
+ * syscall is held by an application task for the duration of a socket
+ * call, spl implements the spl-levels below and mbuf protects the mbuf
+ * and cluster free lists.
+ */
+struct netlock {
+  struct SignalSemaphore nl_semaphore;
+  struct netlock        *nl_next;
+  const char            *nl_name;
+  ULONG                  nl_obtained;	/* times obtained */
+  ULONG                  nl_contended;	/* times had to wait */
+};
+
+extern struct netlock syscall_lock;
+extern struct netlock spl_lock;
+
+extern void netlock_init(struct netlock *nl, const char *name);
+
+static inline void
+netlock_obtain(struct netlock *nl)
+{
+  if (!AttemptSemaphore(&nl->nl_semaphore)) {
+    ObtainSemaphore(&nl->nl_semaphore);
+    nl->nl_contended++;
+  }
+  nl->nl_obtained++;
+}
+
+static inline void
+netlock_release(struct netlock *nl)
+{
+  ReleaseSemaphore(&nl->nl_semaphore);
+}
+
+#define netlock_owned(nl) ((nl)->nl_semaphore.ss_Owner == FindTask(NULL))
+
+/*
+ * syscall_unlock() lets other tasks make socket calls while the caller
+ * copies data between user buffers and mbufs.  It does nothing unless
+ * the caller holds syscall_lock exactly once and is at spl0, so it is
+ * also safe to use in code run by the AROSTCP task itself.  The socket
+ * buffer being copied must be locked with sblock() so that no other
+ * task uses it meanwhile.  syscall_relock() takes the lock back.
+ */
+static inline BOOL
+syscall_unlock(void)
+{
+  if (netlock_owned(&syscall_lock) &&
+      syscall_lock.nl_semaphore.ss_NestCount == 1 &&
+      !netlock_owned(&spl_lock)) {
+    netlock_release(&syscall_lock);
+    return TRUE;
+  }
+  return FALSE;
+}
+
+static inline void
+syscall_relock(BOOL unlocked)
+{
+  if (unlocked)
+    netlock_obtain(&syscall_lock);
+}
+
 /*
  * Spl-levels used in this implementation
  */
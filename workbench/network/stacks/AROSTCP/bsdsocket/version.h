@@ -33,11 +33,11 @@
 #define MIAMILIBNAME    "miami.library"
 
 #define VERSION         4
-#define REVISION        59
-#define DATE    "11.9.2025"
-#define VERS    SOCLIBNAME "4.59"
+#define REVISION        61
+#define DATE    "19.10.2026"
+#define VERS    SOCLIBNAME "4.61"
 #define VSTRING SOCLIBNAME STR(VERSION) "." STR(REVISION) "(" DATE ")"
-#define VERSTAG "\0$VER:" SOCLIBNAME "4.59 (" DATE ")"
+#define VERSTAG "\0$VER:" SOCLIBNAME "4.61 (" DATE ")"
 
 #define MIAMI_VERSION 13
 #define MIAMI_REVISION 5
@@ -2,7 +2,7 @@
 #define _WANDERER_CLASSES_ICON_ATTRIBUTES_H
 
 /*
-    Copyright  2008-2023, The AROS Development Team. All rights reserved.
+    Copyright  2008-2026, The AROS Development Team. All rights reserved.
     $Id$
 */
 
@@ -75,6 +75,7 @@
 #define ICONENTRY_FLAG_TODAY            (1<<6)        /* entry's timestamp is from today    */
 #define ICONENTRY_FLAG_LASSO            (1<<7)        /* icon is being altered by a lasso   */
 #define ICONENTRY_FLAG_ISONLYICON       (1<<8)        /* entry represents an '.info' file without a real file behind it */
+#define ICONENTRY_FLAG_ICONPENDING      (1<<9)        /* entry is shown with a default icon until its own is loaded */
 
 
 /* For Icons of type ST_ROOT */
@@ -1,5 +1,5 @@
 /*
-Copyright  2002-2009, The AROS Development Team. All rights reserved.
+Copyright  2002-2026, The AROS Development Team. All rights reserved.
 */
 
 #define DEBUG 0
@@ -69,136 +69,310 @@ Copyright  2002-2009, The AROS Development Team. All rights reserved.
 extern struct Library *MUIMasterBase;
 
 
+/* Large enough to read most drawers with a single ExAll() call */
+#define EXALL_BUFFERSIZE        (64 * 1024)
+
+/*
+ * A directory entry, kept until the whole drawer has been read so that
+ * files and their .info files can be paired in memory.
+ */
+struct DrawerEntry
+{
+    struct DrawerEntry          *de_Next;                       /* In directory order */
+    struct DrawerEntry          *de_HashNext;
+    LONG                        de_Type;
+    UQUAD                       de_Size;
+    ULONG                       de_Prot;
+    struct DateStamp            de_Date;
+    UWORD                       de_OwnerUID;
+    UWORD                       de_OwnerGID;
+    STRPTR                      de_Comment;
+    ULONG                       de_NameLen;
+    char                        de_Name[];
+};
+
+///IconDrawerList__HashName()
+/* File names are case insensitive, so is the hash */
+static ULONG IconDrawerList__HashName(CONST_STRPTR name, ULONG len)
+{
+    ULONG hash = 2166136261UL;
+
+    while (len--)
+        hash = (hash ^ ToLower(*name++)) * 16777619UL;
+
+    return hash;
+}
+///
+
+///IconDrawerList__FindEntry()
+static struct DrawerEntry *IconDrawerList__FindEntry(struct DrawerEntry **hashtable, ULONG hashmask,
+                                                   CONST_STRPTR name, ULONG len)
+{
+    struct DrawerEntry *de;
+
+    for (de = hashtable[IconDrawerList__HashName(name, len) & hashmask]; de; de = de->de_HashNext)
+    {
+        if ((de->de_NameLen == len) && !Strnicmp(de->de_Name, name, len))
+            return de;
+    }
+    return NULL;
+}
+///
+
+///IconDrawerList__ReadDrawer()
+/*
+ * Read the whole drawer with ExAll(), returns the entries in directory
+ * order or NULL. *count is set to the number of entries read.
+ */
+static struct DrawerEntry *IconDrawerList__ReadDrawer(BPTR lock, APTR pool, ULONG *count)
+{
+    struct ExAllControl *eac;
+    struct ExAllData    *buffer, *ead;
+    struct DrawerEntry  *first = NULL, **last = &first, *de;
+    BOOL                more, failed = FALSE;
+
+    *count = 0;
+
+    if ((eac = AllocDosObject(DOS_EXALLCONTROL, NULL)) == NULL)
+        return NULL;
+
+    if ((buffer = AllocVec(EXALL_BUFFERSIZE, MEMF_ANY)) == NULL)
+    {
+        FreeDosObject(DOS_EXALLCONTROL, eac);
+        return NULL;
+    }
+
+    eac->eac_LastKey = 0;
+    do
+    {
+        more = ExAll(lock, buffer, EXALL_BUFFERSIZE, ED_OWNER, eac);
+        if (!more && (IoErr() != ERROR_NO_MORE_ENTRIES))
+        {
+            D(bug("[IconDrawerList] %s: ExAll failed (%ld)\n", __PRETTY_FUNCTION__, IoErr()));
+        }
+
+        if (eac->eac_Entries == 0)
+            continue;
+
+        for (ead = buffer; ead; ead = ead->ed_Next)
+        {
+            ULONG namelen = strlen(ead->ed_Name);
+            ULONG commentlen = ead->ed_Comment ? strlen(ead->ed_Comment) + 1 : 0;
+
+            if ((de = AllocPooled(pool, sizeof(struct DrawerEntry) + namelen + 1 + commentlen)) == NULL)
+            {
+                failed = TRUE;
+                break;
+            }
+
+            de->de_Next = NULL;
+            de->de_HashNext = NULL;
+            de->de_Type = ead->ed_Type;
+            de->de_Size = ead->ed_Size;
+            de->de_Prot = ead->ed_Prot;
+            de->de_Date.ds_Days = ead->ed_Days;
+            de->de_Date.ds_Minute = ead->ed_Mins;
+            de->de_Date.ds_Tick = ead->ed_Ticks;
+            de->de_OwnerUID = ead->ed_OwnerUID;
+            de->de_OwnerGID = ead->ed_OwnerGID;
+            de->de_NameLen = namelen;
+            CopyMem(ead->ed_Name, de->de_Name, namelen + 1);
+            if (commentlen)
+            {
+                de->de_Comment = &de->de_Name[namelen + 1];
+                CopyMem(ead->ed_Comment, de->de_Comment, commentlen);
+            }
+            else
+                de->de_Comment = NULL;
+
+            *last = de;
+            last = &de->de_Next;
+            (*count)++;
+        }
+
+        if (failed && more)
+        {
+            ExAllEnd(lock, buffer, EXALL_BUFFERSIZE, ED_OWNER, eac);
+            more = FALSE;
+        }
+    } while (more);
+
+    FreeVec(buffer);
+    FreeDosObject(DOS_EXALLCONTROL, eac);
+
+    return first;
+}
+///
+
 ///IconDrawerList__ParseContents()
 /**************************************************************************
-Read icons in
+Read icons in. The drawer is read with ExAll() and files are paired with
+their .info files in memory, the icons themselves are loaded by IconList
+in the background.
 **************************************************************************/
 static int IconDrawerList__ParseContents(struct IClass *CLASS, Object *obj)
 {
     struct IconDrawerList_DATA  *data = INST_DATA(CLASS, obj);
-    BPTR                        lock = BNULL, tmplock = BNULL;
+    BPTR                        lock = BNULL;
     char                        filename[256];
     char                        namebuffer[512];
     ULONG                       list_DisplayFlags = 0;
+    struct FileInfoBlock        *fib;
+    struct DrawerEntry          *entries, *de, **hashtable = NULL;
+    ULONG                       count, hashsize, hashmask;
+    APTR                        pool;
 
     D(bug("[IconDrawerList]: %s()\n", __PRETTY_FUNCTION__));
 
     if (!data->drawer) return 1;
 
+    if ((pool = CreatePool(MEMF_ANY, 16384, 16384)) == NULL)
+        return 1;
+
+    fib = AllocDosObject(DOS_FIB, NULL);
     lock = Lock(data->drawer, SHARED_LOCK);
 
-    if (lock)
+    if (lock && fib)
     {
-        struct FileInfoBlock *fib = AllocDosObject(DOS_FIB, NULL);
-        if (fib)
+        entries = IconDrawerList__ReadDrawer(lock, pool, &count);
+
+        D(bug("[IconDrawerList] %s: %lu entries\n", __PRETTY_FUNCTION__, count));
+
+        for (hashsize = 16; hashsize < count; hashsize <<= 1)
+            ;
+        hashmask = hashsize - 1;
+
+        if (entries && (hashtable = AllocPooled(pool, hashsize * sizeof(struct DrawerEntry *))))
         {
-            if (Examine(lock, fib))
+            memset(hashtable, 0, hashsize * sizeof(struct DrawerEntry *));
+            for (de = entries; de; de = de->de_Next)
             {
-                GET(obj, MUIA_IconList_DisplayFlags, &list_DisplayFlags);
-                D(bug("[IconDrawerList] %s: DisplayFlags = 0x%p\n", __PRETTY_FUNCTION__, list_DisplayFlags));
+                ULONG bucket = IconDrawerList__HashName(de->de_Name, de->de_NameLen) & hashmask;
 
-                while(ExNext(lock, fib))
-                {
-                    int len = strlen(fib->fib_FileName);
-                    struct IconEntry *this_Icon;
-                    BOOL isonlyicon = FALSE;
+                de->de_HashNext = hashtable[bucket];
+                hashtable[bucket] = de;
+            }
+        }
 
-                    memset(namebuffer, 0, 512);
-                    strcpy(filename, fib->fib_FileName);
+        GET(obj, MUIA_IconList_DisplayFlags, &list_DisplayFlags);
+        D(bug("[IconDrawerList] %s: DisplayFlags = 0x%p\n", __PRETTY_FUNCTION__, list_DisplayFlags));
 
-                    D(bug("[IconDrawerList] %s: '%s', len = %d\n", __PRETTY_FUNCTION__, filename, len));
+        for (de = (hashtable) ? entries : NULL; de; de = de->de_Next)
+        {
+            int len = de->de_NameLen;
+            struct IconEntry *this_Icon;
+            BOOL isonlyicon = FALSE, hasicon = FALSE;
 
-                    if (len >= 5)
-                    {
-                        if (!Stricmp(&filename[len-5],".info"))
-                        {
-                            /* Its a .info file .. skip "disk.info" and just ".info" files*/
-                            if ((len == 5) || ((len == 9) && (!Strnicmp(filename, "Disk", 4))))
-                            {
-                                D(bug("[IconDrawerList] %s: Skiping file named disk.info or just .info ('%s')\n", __PRETTY_FUNCTION__, filename));
-                                continue;
-                            }
-
-                            strcpy(namebuffer, data->drawer);
-                            memset((filename + len - 5), 0, 1); //Remove the .info section
-                            AddPart(namebuffer, filename, sizeof(namebuffer));
-                            D(bug("[IconDrawerList] %s: Checking for .info files real file '%s'\n", __PRETTY_FUNCTION__, namebuffer));
-
-                            if ((tmplock = Lock(namebuffer, SHARED_LOCK)))
-                            {
-                                /* We have a real file so skip it for now and let it be found seperately */
-                                D(bug("[IconDrawerList] %s: File found .. skipping\n", __PRETTY_FUNCTION__));
-                                UnLock(tmplock);
-                                continue;
-                            }
-                            else
-                            {
-                                /* There is no real file, mark accordingly */
-                                isonlyicon = TRUE;
-                            }
-                        }
-                    }
+            if (len >= sizeof(filename))
+                continue;
 
-                    D(bug("[IconDrawerList] %s: Registering file '%s'\n", __PRETTY_FUNCTION__, filename));
-                    strcpy(namebuffer, data->drawer);
-                    AddPart(namebuffer, filename, sizeof(namebuffer));
+            memset(namebuffer, 0, 512);
+            strcpy(filename, de->de_Name);
 
-                    this_Icon = NULL;
+            D(bug("[IconDrawerList] %s: '%s', len = %d\n", __PRETTY_FUNCTION__, filename, len));
 
-                    if ((this_Icon = (struct IconEntry *)DoMethod(obj, MUIM_IconList_CreateEntry, (IPTR)namebuffer, (IPTR)filename, (IPTR)fib, (IPTR)NULL, 0, (IPTR)NULL)))
+            if (len >= 5)
+            {
+                if (!Stricmp(&filename[len-5],".info"))
+                {
+                    /* Its a .info file .. skip "disk.info" and just ".info" files*/
+                    if ((len == 5) || ((len == 9) && (!Strnicmp(filename, "Disk", 4))))
                     {
-                        D(bug("[IconDrawerList] %s: Icon entry allocated @ 0x%p\n", __PRETTY_FUNCTION__, this_Icon));
-                        DoMethod(obj, MUIM_Family_AddTail, (struct Node*)&this_Icon->ie_IconNode);
-
-                        sprintf(namebuffer + strlen(namebuffer), ".info");
-                        if ((tmplock = Lock(namebuffer, SHARED_LOCK)))
-                        {
-                            D(bug("[IconDrawerList] %s: File has a .info file .. updating info\n", __PRETTY_FUNCTION__));
-                            UnLock(tmplock);
-                            if (!(this_Icon->ie_Flags & ICONENTRY_FLAG_HASICON))
-                                this_Icon->ie_Flags |= ICONENTRY_FLAG_HASICON;
-                        }
-
-                        if (list_DisplayFlags & ICONLIST_DISP_SHOWINFO)
-                        {
-                            if ((this_Icon->ie_Flags & ICONENTRY_FLAG_HASICON) && !(this_Icon->ie_Flags & ICONENTRY_FLAG_VISIBLE))
-                                this_Icon->ie_Flags |= ICONENTRY_FLAG_VISIBLE;
-                        }
-                        else if (!(this_Icon->ie_Flags & ICONENTRY_FLAG_VISIBLE))
-                        {
-                            this_Icon->ie_Flags |= ICONENTRY_FLAG_VISIBLE;
-                        }
-                        this_Icon->ie_IconNode.ln_Pri = 0;
-
-                        if (fib->fib_DirEntryType == ST_FILE)
-                        {
-                            if (isonlyicon) this_Icon->ie_Flags |= ICONENTRY_FLAG_ISONLYICON;
-
-                            this_Icon->ie_IconListEntry.type = ST_FILE;
-                            D(bug("[IconDrawerList] %s: ST_FILE Entry created\n", __PRETTY_FUNCTION__));
-                        }
-                        else if (fib->fib_DirEntryType == ST_USERDIR)
-                        {
-                            this_Icon->ie_IconListEntry.type = ST_USERDIR;
-                            D(bug("[IconDrawerList] %s: ST_USERDIR Entry created\n", __PRETTY_FUNCTION__));
-                        }
-                        else
-                        {
-                            D(bug("[IconDrawerList] %s: Unknown Entry Type created\n", __PRETTY_FUNCTION__));
-                        }
+                        D(bug("[IconDrawerList] %s: Skiping file named disk.info or just .info ('%s')\n", __PRETTY_FUNCTION__, filename));
+                        continue;
                     }
-                    else
+
+                    if (IconDrawerList__FindEntry(hashtable, hashmask, filename, len - 5))
                     {
-                        D(bug("[IconDrawerList] %s: Failed to Register file!!!\n", __PRETTY_FUNCTION__));
+                        /* We have a real file so skip it for now and let it be found seperately */
+                        D(bug("[IconDrawerList] %s: '%s' has a real file .. skipping\n", __PRETTY_FUNCTION__, filename));
+                        continue;
                     }
+
+                    /* There is no real file, mark accordingly */
+                    memset((filename + len - 5), 0, 1); //Remove the .info section
+                    isonlyicon = TRUE;
+                    hasicon = TRUE;
                 }
             }
 
-            FreeDosObject(DOS_FIB, fib);
+            if (!hasicon && (len + 5 < sizeof(filename)))
+            {
+                strcpy(namebuffer, filename);
+                strcat(namebuffer, ".info");
+                hasicon = (IconDrawerList__FindEntry(hashtable, hashmask, namebuffer, len + 5) != NULL);
+            }
+
+            D(bug("[IconDrawerList] %s: Registering file '%s'\n", __PRETTY_FUNCTION__, filename));
+            strcpy(namebuffer, data->drawer);
+            AddPart(namebuffer, filename, sizeof(namebuffer));
+
+            memset(fib, 0, sizeof(struct FileInfoBlock));
+            strncpy(fib->fib_FileName, de->de_Name, MAXFILENAMELENGTH - 1);
+            fib->fib_DirEntryType = de->de_Type;
+            fib->fib_EntryType = de->de_Type;
+            fib->fib_Protection = de->de_Prot;
+            fib->fib_Size = de->de_Size;
+            fib->fib_Date = de->de_Date;
+            if (de->de_Comment)
+                strncpy(fib->fib_Comment, de->de_Comment, MAXCOMMENTLENGTH - 1);
+            fib->fib_OwnerUID = de->de_OwnerUID;
+            fib->fib_OwnerGID = de->de_OwnerGID;
+
+            this_Icon = NULL;
+
+            if ((this_Icon = (struct IconEntry *)DoMethod(obj, MUIM_IconList_CreateEntry, (IPTR)namebuffer, (IPTR)filename, (IPTR)fib, (IPTR)NULL, 0, (IPTR)NULL)))
+            {
+                D(bug("[IconDrawerList] %s: Icon entry allocated @ 0x%p\n", __PRETTY_FUNCTION__, this_Icon));
+                DoMethod(obj, MUIM_Family_AddTail, (struct Node*)&this_Icon->ie_IconNode);
+
+                if (hasicon)
+                {
+                    D(bug("[IconDrawerList] %s: File has a .info file .. updating info\n", __PRETTY_FUNCTION__));
+                    if (!(this_Icon->ie_Flags & ICONENTRY_FLAG_HASICON))
+                        this_Icon->ie_Flags |= ICONENTRY_FLAG_HASICON;
+                }
+
+                if (list_DisplayFlags & ICONLIST_DISP_SHOWINFO)
+                {
+                    if ((this_Icon->ie_Flags & ICONENTRY_FLAG_HASICON) && !(this_Icon->ie_Flags & ICONENTRY_FLAG_VISIBLE))
+                        this_Icon->ie_Flags |= ICONENTRY_FLAG_VISIBLE;
+                }
+                else if (!(this_Icon->ie_Flags & ICONENTRY_FLAG_VISIBLE))
+                {
+                    this_Icon->ie_Flags |= ICONENTRY_FLAG_VISIBLE;
+                }
+                this_Icon->ie_IconNode.ln_Pri = 0;
+
+                if (de->de_Type == ST_FILE)
+                {
+                    if (isonlyicon) this_Icon->ie_Flags |= ICONENTRY_FLAG_ISONLYICON;
+
+                    this_Icon->ie_IconListEntry.type = ST_FILE;
+                    D(bug("[IconDrawerList] %s: ST_FILE Entry created\n", __PRETTY_FUNCTION__));
+                }
+                else if (de->de_Type == ST_USERDIR)
+                {
+                    this_Icon->ie_IconListEntry.type = ST_USERDIR;
+                    D(bug("[IconDrawerList] %s: ST_USERDIR Entry created\n", __PRETTY_FUNCTION__));
+                }
+                else
+                {
+                    D(bug("[IconDrawerList] %s: Unknown Entry Type created\n", __PRETTY_FUNCTION__));
+                }
+            }
+            else
+            {
+                D(bug("[IconDrawerList] %s: Failed to Register file!!!\n", __PRETTY_FUNCTION__));
+            }
         }
+    }
 
+    if (lock)
         UnLock(lock);
-    }
+    if (fib)
+        FreeDosObject(DOS_FIB, fib);
+    DeletePool(pool);
 
     return 1;
 }
@@ -1,5 +1,5 @@
 /*
-    Copyright (C) 2001-2025, The AROS Development Team. All rights reserved.
+    Copyright (C) 2001-2026, The AROS Development Team. All rights reserved.
 */
 
 #define DEBUG 0
@@ -504,16 +504,58 @@ static void IconList_InvertLassoOutlines(Object *obj, struct IconList_DATA *data
 }
 ///
 
+///IconList_EntryDiskObj()
+/* The DiskObject to render, a default icon while the entry's own is being loaded */
+static struct DiskObject *IconList_EntryDiskObj(struct IconList_DATA *data, struct IconEntry *entry)
+{
+    if (entry->ie_Flags & ICONENTRY_FLAG_ICONPENDING)
+    {
+        if (entry->ie_IconListEntry.type > 0)
+            return data->icld_PendingDrawerIcon;
+        return data->icld_PendingFileIcon;
+    }
+    return entry->ie_DiskObj;
+}
+///
+
+///IconList_PrioritiseView()
+/* Let the icon loader decode what the user is looking at first */
+static void IconList_PrioritiseView(Object *obj, struct IconList_DATA *data)
+{
+    struct Rectangle            view;
+
+    if (data->icld_IconLoader.ild_Process == NULL)
+        return;
+
+    view.MinX = data->icld_ViewX;
+    view.MinY = data->icld_ViewY;
+    view.MaxX = data->icld_ViewX + _mwidth(obj) - 1;
+    view.MaxY = data->icld_ViewY + _mheight(obj) - 1;
+
+    IconLoader_Prioritise(&data->icld_IconLoader, &view);
+}
+///
+
 ///IconList_GetIconImageRectangle()
 //We don't use icon.library's label drawing so we do this by hand
 static void IconList_GetIconImageRectangle(Object *obj, struct IconList_DATA *data, struct IconEntry *entry, struct Rectangle *rect)
 {
+    struct DiskObject   *dob = IconList_EntryDiskObj(data, entry);
+
 #if defined(DEBUG_ILC_ICONPOSITIONING) || defined(DEBUG_ILC_FUNCS)
     D(bug("[IconList]: %s(entry @ %p)\n", __func__, entry));
 #endif
 
+    if (dob == NULL)
+    {
+        rect->MinX = rect->MinY = 0;
+        rect->MaxX = rect->MaxY = -1;
+        entry->ie_IconWidth = entry->ie_IconHeight = 0;
+        return;
+    }
+
     /* Get basic width/height */
-    GetIconRectangleA(NULL, entry->ie_DiskObj, NULL, rect, __iconList_DrawIconStateTags);
+    GetIconRectangleA(NULL, dob, NULL, rect, __iconList_DrawIconStateTags);
 #if defined(DEBUG_ILC_ICONPOSITIONING)
     D(bug("[IconList] %s: MinX %d, MinY %d      MaxX %d, MaxY %d\n", __func__, rect->MinX, rect->MinY, rect->MaxX, rect->MaxY));
 #endif
@@ -1048,7 +1090,7 @@ IPTR IconList__MUIM_IconList_DrawEntry(struct IClass *CLASS, Object *obj, struct
 
     if ((!(message->entry->ie_Flags & ICONENTRY_FLAG_VISIBLE)) ||
         (data->icld_BufferRastPort == NULL) ||
-        (!(message->entry->ie_DiskObj)))
+        (!(IconList_EntryDiskObj(data, message->entry))))
     {
 #if defined(DEBUG_ILC_ICONRENDERING)
         D(bug("[IconList] %s: Not visible or missing DOB\n", __func__));
@@ -1185,7 +1227,7 @@ IPTR IconList__MUIM_IconList_DrawEntry(struct IClass *CLASS, Object *obj, struct
         BOOL renderSelected = ((message->entry->ie_Flags & (ICONENTRY_FLAG_SELECTED | ICONENTRY_FLAG_LASSO)) != 0);
         DrawIconStateA
           (
-            data->icld_BufferRastPort, message->entry->ie_DiskObj, NULL,
+            data->icld_BufferRastPort, IconList_EntryDiskObj(data, message->entry), NULL,
             iconX,
             iconY,
             (renderSelected) ? IDS_SELECTED : IDS_NORMAL,
@@ -1505,7 +1547,7 @@ IPTR IconList__MUIM_IconList_DrawEntryLabel(struct IClass *CLASS, Object *obj, s
 
     if ((!(message->entry->ie_Flags & ICONENTRY_FLAG_VISIBLE)) ||
         (data->icld_BufferRastPort == NULL) ||
-        (!(message->entry->ie_DiskObj)))
+        (!(IconList_EntryDiskObj(data, message->entry))))
     {
 #if defined(DEBUG_ILC_ICONRENDERING)
         D(bug("[IconList] %s: Not visible or missing DOB\n", __func__));
@@ -1863,7 +1905,7 @@ IPTR IconList__MUIM_IconList_RethinkDimensions(struct IClass *CLASS, Object *obj
 
     while (entry != NULL)
     {
-        if (entry->ie_DiskObj &&
+        if (IconList_EntryDiskObj(data, entry) &&
             (entry->ie_Flags & ICONENTRY_FLAG_VISIBLE))
         {
             if ((data->icld_DisplayFlags & ICONLIST_DISP_MODELIST) == ICONLIST_DISP_MODELIST)
@@ -1949,7 +1991,7 @@ static VOID IconList_Layout_FullAutoLayout(struct IClass *CLASS, Object *obj)
     while (entry != NULL)
     {
         calcnextpos = FALSE;
-        if ((entry->ie_DiskObj != NULL) && (entry->ie_Flags & ICONENTRY_FLAG_VISIBLE))
+        if ((IconList_EntryDiskObj(data, entry) != NULL) && (entry->ie_Flags & ICONENTRY_FLAG_VISIBLE))
         {
             calcnextpos = TRUE;
 
@@ -2095,7 +2137,7 @@ static VOID IconList_Layout_PartialAutoLayout(struct IClass *CLASS, Object *obj)
     entry = (struct IconEntry *)GetHead(&data->icld_IconList);
     while (entry != NULL)
     {
-        if ((entry->ie_DiskObj != NULL) && (entry->ie_Flags & ICONENTRY_FLAG_VISIBLE))
+        if ((IconList_EntryDiskObj(data, entry) != NULL) && (entry->ie_Flags & ICONENTRY_FLAG_VISIBLE))
         {
             if ((entry->ie_ProvidedIconX != NO_ICON_POSITION) && (entry->ie_ProvidedIconY != NO_ICON_POSITION))
             {
@@ -2378,6 +2420,8 @@ IPTR IconList__OM_NEW(struct IClass *CLASS, Object *obj, struct opSet *message)
     data->icld_SortFlags    = MUIV_IconList_Sort_ByName;
     data->icld_DisplayFlags = ICONLIST_DISP_SHOWINFO;
 
+    IconLoader_Init(&data->icld_IconLoader);
+
     __iconlist_UpdateLabels_hook.h_Entry = (HOOKFUNC)IconList__HookFunc_UpdateLabelsFunc;
 
     DoMethod
@@ -2786,6 +2830,7 @@ IPTR IconList__OM_SET(struct IClass *CLASS, Object *obj, struct opSet *message)
         data->icld_UpdateMode = UPDATE_SCROLL;
         data->update_scrolldx = data->icld_ViewX - oldleft;
         data->update_scrolldy = data->icld_ViewY - oldtop;
+        IconList_PrioritiseView(obj, data);
 #if defined(DEBUG_ILC_ATTRIBS)
         D(bug("[IconList] %s(), call MUI_Redraw()\n", __func__));
 #endif
@@ -3161,25 +3206,46 @@ D(bug("[IconList]: %s()\n", __func__));
 #endif
         }
 
+        /* Shown until the entries' own icons have been loaded */
+        if (data->icld_PendingDrawerIcon == NULL)
+        {
+            data->icld_PendingDrawerIcon = GetIconTags
+            (
+                NULL,
+                ICONGETA_GetDefaultType,           WBDRAWER,
+                (iconlistScreen) ? ICONGETA_Screen : TAG_IGNORE, iconlistScreen,
+                (iconlistScreen) ? ICONGETA_RemapIcon : TAG_IGNORE, TRUE,
+                ICONGETA_GenerateImageMasks,       TRUE,
+                TAG_DONE
+            );
+        }
+        if (data->icld_PendingFileIcon == NULL)
+        {
+            data->icld_PendingFileIcon = GetIconTags
+            (
+                NULL,
+                ICONGETA_GetDefaultType,           WBPROJECT,
+                (iconlistScreen) ? ICONGETA_Screen : TAG_IGNORE, iconlistScreen,
+                (iconlistScreen) ? ICONGETA_RemapIcon : TAG_IGNORE, TRUE,
+                ICONGETA_GenerateImageMasks,       TRUE,
+                TAG_DONE
+            );
+        }
+
+        if (!IconLoader_Start(&data->icld_IconLoader, _app(obj), obj, (struct Screen *)iconlistScreen))
+        {
+            D(bug("[IconList] %s: Failed to start the icon loader\n", __func__));
+        }
+
         ForeachNode(&data->icld_IconList, node)
         {
             if (!node->ie_DiskObj)
             {
-                if (!(node->ie_DiskObj = GetIconTags(node->ie_IconNode.ln_Name,
-                                                    (iconlistScreen) ? ICONGETA_Screen : TAG_IGNORE, iconlistScreen,
-                                                    (iconlistScreen) ? ICONGETA_RemapIcon : TAG_IGNORE, TRUE,
-                                                    ICONGETA_GenerateImageMasks, TRUE,
-                                                    ICONGETA_FailIfUnavailable, FALSE,
-                                                    ICONA_ErrorCode, &geticon_error,
-                                                    TAG_DONE)))
-                {
-#if defined(DEBUG_ILC_ICONRENDERING)
-                    D(bug("[IconList] %s: Failed to obtain Entry '%s's diskobj! (error code = 0x%p)\n", __func__, node->ie_IconNode.ln_Name, geticon_error));
-#endif
-                    /*  We should probably remove this node if the entry cant be obtained ? */
-                }
+                node->ie_Flags |= ICONENTRY_FLAG_ICONPENDING;
+                IconLoader_Queue(&data->icld_IconLoader, node);
             }
         }
+        IconList_PrioritiseView(obj, data);
     }
     return rc;
 }
@@ -3200,14 +3266,13 @@ D(bug("[IconList]: %s()\n", __func__));
 
     if ((rc = DoSuperMethodA(CLASS, obj, (Msg)message)))
     {
-        struct IconEntry *node = NULL;
+        /*
+         * Decoded icons need the rastport for layout, so loading stops here.
+         * The entries keep their icons until MUIM_Cleanup and what was not
+         * loaded yet is queued again by MUIM_Show.
+         */
+        IconLoader_Stop(&data->icld_IconLoader);
 
-        ForeachNode(&data->icld_IconList, node)
-        {
-            if (node->ie_DiskObj)
-                FreeDiskObject(node->ie_DiskObj);
-            node->ie_DiskObj = NULL;
-        }
         if (data->icld_LVMAttribs)
         {
             if (data->icld_LVMAttribs->lvma_IconDrawer)
@@ -3246,6 +3311,9 @@ IPTR IconList__MUIM_Cleanup(struct IClass *CLASS, Object *obj, struct MUIP_Clean
     D(bug("[IconList]: %s()\n", __func__));
 #endif
 
+    IconLoader_Stop(&data->icld_IconLoader);
+
+    /* The icons are remapped to our screen */
     ForeachNode(&data->icld_IconList, node)
     {
         if (node->ie_DiskObj)
@@ -3254,6 +3322,16 @@ IPTR IconList__MUIM_Cleanup(struct IClass *CLASS, Object *obj, struct MUIP_Clean
             node->ie_DiskObj = NULL;
         }
     }
+    if (data->icld_PendingDrawerIcon)
+    {
+        FreeDiskObject(data->icld_PendingDrawerIcon);
+        data->icld_PendingDrawerIcon = NULL;
+    }
+    if (data->icld_PendingFileIcon)
+    {
+        FreeDiskObject(data->icld_PendingFileIcon);
+        data->icld_PendingFileIcon = NULL;
+    }
 
     DoMethod(_win(obj), MUIM_Window_RemEventHandler, (IPTR)&data->ehn);
 
@@ -4174,7 +4252,7 @@ IPTR IconList__MUIM_Draw(struct IClass *CLASS, Object *obj, struct MUIP_Draw *me
             else
             {
                 if ((entry->ie_Flags & ICONENTRY_FLAG_VISIBLE) &&
-                    (entry->ie_DiskObj) &&
+                    (IconList_EntryDiskObj(data, entry)) &&
                     (entry->ie_IconX != NO_ICON_POSITION) &&
                     (entry->ie_IconY != NO_ICON_POSITION))
                 {
@@ -4340,6 +4418,8 @@ IPTR IconList__MUIM_IconList_DestroyEntry(struct IClass *CLASS, Object *obj, str
         if (message->entry->ie_TxtBuf_DATE)
             FreePooled(data->icld_Pool, message->entry->ie_TxtBuf_DATE, LEN_DATSTRING);
 
+        IconLoader_Cancel(&data->icld_IconLoader, message->entry);
+
         if (message->entry->ie_DiskObj)
             FreeDiskObject(message->entry->ie_DiskObj);
 
@@ -4385,8 +4465,6 @@ IPTR IconList__MUIM_IconList_CreateEntry(struct IClass *CLASS, Object *obj, stru
     struct DiskObject           *dob = NULL;
     struct Rectangle            rect;
 
-    IPTR                        geticon_error = 0;
-
 #if defined(DEBUG_ILC_FUNCS)
     D(bug("[IconList]: %s()\n", __func__));
 #endif
@@ -4396,45 +4474,25 @@ IPTR IconList__MUIM_IconList_CreateEntry(struct IClass *CLASS, Object *obj, stru
         return (IPTR)NULL;
     }
 
-    /*disk object (icon)*/
-    if (message->entry_dob == NULL)
-    {
-        IPTR iconlistScreen = (IPTR)_screen(obj);
-        D(bug("[IconList] %s: IconList Screen @ 0x%p)\n", __func__, iconlistScreen));
-
-        dob = GetIconTags
-        (
-            message->filename,
-            (iconlistScreen) ? ICONGETA_Screen : TAG_IGNORE, iconlistScreen,
-            (iconlistScreen) ? ICONGETA_RemapIcon : TAG_IGNORE, TRUE,
-            ICONGETA_FailIfUnavailable,        FALSE,
-            ICONGETA_GenerateImageMasks,       TRUE,
-            ICONA_ErrorCode,                   &geticon_error,
-            TAG_DONE
-        );
-        
-        if (dob == NULL)
-        {
-            D(bug("[IconList] %s: Fatal: Couldnt get DiskObject! (error code = 0x%p)\n", __func__, geticon_error));
-
-            return (IPTR)NULL;
-        }
-    }
-    else
-    {
-        dob = message->entry_dob;
-    }
+    /*
+     * disk object (icon). Without one, the entry is shown with a default
+     * icon and its own is decoded by the icon loader process.
+     */
+    dob = message->entry_dob;
 
     D(bug("[IconList] %s: DiskObject @ 0x%p\n", __func__, dob));
 
     if ((entry = AllocPooled(data->icld_Pool, sizeof(struct IconEntry))) == NULL)
     {
         D(bug("[IconList] %s: Failed to Allocate Entry Storage!\n", __func__));
-        FreeDiskObject(dob);
+        if (dob)
+            FreeDiskObject(dob);
         return (IPTR)NULL;
     }
     memset(entry, 0, sizeof(struct IconEntry));
     entry->ie_Flags |= ICONENTRY_FLAG_NEEDSUPDATE;
+    if (dob == NULL)
+        entry->ie_Flags |= ICONENTRY_FLAG_ICONPENDING;
     entry->ie_IconListEntry.ile_IconEntry = entry;
 
     /* Allocate Text Buffers */
@@ -4553,8 +4611,17 @@ IPTR IconList__MUIM_IconList_CreateEntry(struct IClass *CLASS, Object *obj, stru
 
     entry->ie_IconListEntry.udata = message->udata;
 
-    entry->ie_IconX = dob->do_CurrentX;
-    entry->ie_IconY = dob->do_CurrentY;
+    if (dob)
+    {
+        entry->ie_IconX = dob->do_CurrentX;
+        entry->ie_IconY = dob->do_CurrentY;
+    }
+    else
+    {
+        /* Set by MUIM_IconList_IconsLoaded if the icon has a position */
+        entry->ie_IconX = NO_ICON_POSITION;
+        entry->ie_IconY = NO_ICON_POSITION;
+    }
 
     DoMethod(obj, MUIM_IconList_PropagateEntryPos, entry);
 
@@ -4565,6 +4632,10 @@ IPTR IconList__MUIM_IconList_CreateEntry(struct IClass *CLASS, Object *obj, stru
         /* Use a geticonrectangle routine that gets textwidth! */
         IconList_GetIconAreaRectangle(obj, data, entry, &rect);
 
+        /* If we are not shown yet, MUIM_Show queues it */
+        if (dob == NULL)
+            IconLoader_Queue(&data->icld_IconLoader, entry);
+
         return (IPTR)entry;
     }
 
@@ -4586,16 +4657,25 @@ IPTR IconList__MUIM_IconList_UpdateEntry(struct IClass *CLASS, Object *obj, stru
     // UBYTE                       *sp = NULL;
 
     struct Rectangle            rect;
+    BOOL                        wasPending = FALSE;
 
 #if defined(DEBUG_ILC_FUNCS)
     D(bug("[IconList]: %s()\n", __func__));
 #endif
 
+    if (message->entry->ie_Flags & ICONENTRY_FLAG_ICONPENDING)
+    {
+        /* What the loader would deliver may be outdated now, load it here */
+        IconLoader_Cancel(&data->icld_IconLoader, message->entry);
+        message->entry->ie_Flags &= ~ICONENTRY_FLAG_ICONPENDING;
+        wasPending = TRUE;
+    }
+
     if (!message->entry->ie_DiskObj && message->entry_dob)
         message->entry->ie_DiskObj = message->entry_dob;
     else
     {
-        if (message->entry->ie_DiskObj != message->entry_dob)
+        if ((message->entry->ie_DiskObj != message->entry_dob) || wasPending)
         {
             struct DiskObject *dob;
             if ((dob = message->entry_dob) == NULL)
@@ -6548,6 +6628,8 @@ static void DrawIconOnDragImage(struct RastPort *rp, struct DiskObject *icon, LO
         { TAG_DONE,                                     }
     };
 
+    if (icon == NULL)
+        return;
 
     IconControlA(icon, tags);
 
@@ -6718,7 +6800,7 @@ IPTR IconList__MUIM_CreateDragImage(struct IClass *CLASS, Object *obj, struct MU
 
                         IconList_GetIconImageOffsets(data, entry, &offsetx, &offsety);
 
-                        DrawIconOnDragImage(&temprp, entry->ie_DiskObj, (entry->ie_IconX + 1) - first_x + offsetx,
+                        DrawIconOnDragImage(&temprp, IconList_EntryDiskObj(data, entry), (entry->ie_IconX + 1) - first_x + offsetx,
                             (entry->ie_IconY + 1) - first_y + offsety, transp);
                     }
                 }
@@ -6731,7 +6813,7 @@ IPTR IconList__MUIM_CreateDragImage(struct IClass *CLASS, Object *obj, struct MU
             }
             else
             {
-                DrawIconOnDragImage(&temprp, entry->ie_DiskObj, 0, 0, transp);
+                DrawIconOnDragImage(&temprp, IconList_EntryDiskObj(data, entry), 0, 0, transp);
             }
 #endif
 
@@ -6939,6 +7021,7 @@ IPTR IconList__MUIM_DragDrop(struct IClass *CLASS, Object *obj, struct MUIP_Drag
         if ((drop_target_node != NULL) &&
             (drop_target_node->ie_IconListEntry.type == ST_FILE) &&
             (drop_target_node->ie_Flags & ICONENTRY_FLAG_ISONLYICON) &&
+            (drop_target_node->ie_DiskObj != NULL) &&
             (drop_target_node->ie_DiskObj->do_Type == WBDRAWER || drop_target_node->ie_DiskObj->do_Type == WBDISK)
         )
         {
@@ -7565,6 +7648,7 @@ IPTR IconList__MUIM_IconList_Sort(struct IClass *CLASS, Object *obj, struct MUIP
     }
 
     DoMethod(obj, MUIM_IconList_PositionIcons);
+    IconList_PrioritiseView(obj, data);
     MUI_Redraw(obj, MADF_DRAWOBJECT);
 
     if ((data->icld_SortFlags & MUIV_IconList_Sort_Orders) != 0)
@@ -7686,6 +7770,76 @@ D(bug("[IconList]: %s()\n", __func__));
     }
     return 1;
 }
+///
+
+///MUIM_IconList_IconsLoaded()
+/**************************************************************************
+ Pushed by the icon loader process, swap the default icons of the loaded
+ entries for their own. Entries without a position stay where they are
+ unless the list is auto sorted.
+**************************************************************************/
+IPTR IconList__MUIM_IconList_IconsLoaded(struct IClass *CLASS, Object *obj, struct MUIP_IconList_IconsLoaded *message)
+{
+    struct IconList_DATA        *data = INST_DATA(CLASS, obj);
+    struct IconLoadRequest      *req;
+    struct IconEntry            *entry;
+    struct DiskObject           *dob;
+    struct Rectangle            rect;
+    struct List                 loaded;
+    BOOL                        changed = FALSE;
+
+#if defined(DEBUG_ILC_FUNCS)
+    D(bug("[IconList]: %s()\n", __func__));
+#endif
+
+    NEWLIST(&loaded);
+    IconLoader_TakeLoaded(&data->icld_IconLoader, &loaded);
+
+    while ((req = (struct IconLoadRequest *)RemHead(&loaded)))
+    {
+        entry = req->ilr_Entry;
+        entry->ie_IconLoad = NULL;
+
+        /* Without an icon of its own, the entry keeps the default one */
+        if ((dob = req->ilr_DiskObj) != NULL)
+        {
+            req->ilr_DiskObj = NULL;
+
+            entry->ie_DiskObj = dob;
+            entry->ie_Flags &= ~ICONENTRY_FLAG_ICONPENDING;
+            entry->ie_Flags |= ICONENTRY_FLAG_NEEDSUPDATE;
+
+            if (((data->icld_SortFlags & MUIV_IconList_Sort_AutoSort) == 0) &&
+                (dob->do_CurrentX != NO_ICON_POSITION) && (dob->do_CurrentY != NO_ICON_POSITION))
+            {
+                entry->ie_IconX = dob->do_CurrentX;
+                entry->ie_IconY = dob->do_CurrentY;
+                DoMethod(obj, MUIM_IconList_PropagateEntryPos, entry);
+            }
+
+            IconList_GetIconAreaRectangle(obj, data, entry, &rect);
+
+            if (entry->ie_Flags & ICONENTRY_FLAG_VISIBLE)
+            {
+                if (entry->ie_AreaWidth > data->icld_IconAreaLargestWidth)
+                    data->icld_IconAreaLargestWidth = entry->ie_AreaWidth;
+                if (entry->ie_AreaHeight > data->icld_IconAreaLargestHeight)
+                    data->icld_IconAreaLargestHeight = entry->ie_AreaHeight;
+                changed = TRUE;
+            }
+        }
+        IconLoader_FreeRequest(req);
+    }
+
+    if (changed)
+    {
+        DoMethod(obj, MUIM_IconList_PositionIcons);
+        MUI_Redraw(obj, MADF_DRAWOBJECT);
+    }
+
+    return (IPTR)changed;
+}
+///
 
 #if defined(WANDERER_BUILTIN_ICONLIST)
 BOOPSI_DISPATCHER(IPTR,IconList_Dispatcher, CLASS, obj, message)
@@ -7733,6 +7887,7 @@ BOOPSI_DISPATCHER(IPTR,IconList_Dispatcher, CLASS, obj, message)
         case MUIM_IconList_PositionIcons:       return IconList__MUIM_IconList_PositionIcons(CLASS, obj, (APTR)message);
         case MUIM_IconList_SelectAll:           return IconList__MUIM_IconList_SelectAll(CLASS, obj, (APTR)message);
         case MUIM_IconList_MakeEntryVisible:    return IconList__MUIM_IconList_MakeEntryVisible(CLASS, obj, (APTR)message);
+        case MUIM_IconList_IconsLoaded:         return IconList__MUIM_IconList_IconsLoaded(CLASS, obj, (APTR)message);
     }
 
     return DoSuperMethodA(CLASS, obj, message);
@@ -2,7 +2,7 @@
 #define _MUI_CLASSES_ICONLIST_H
 
 /*
-    Copyright  2002-2010, The AROS Development Team. All rights reserved.
+    Copyright  2002-2026, The AROS Development Team. All rights reserved.
     $Id$
 */
 
@@ -37,10 +37,11 @@
 #define MUIM_IconList_Clear             (MUIB_IconList | 0x00000000)
 #define MUIM_IconList_Update            (MUIB_IconList | 0x00000001)
 #define MUIM_IconList_RethinkDimensions (MUIB_IconList | 0x00000002)
-#define MUIM_IconList_CreateEntry       (MUIB_IconList | 0x00000010) /* returns 0 For Failure or (struct IconEntry *) */
+#define MUIM_IconList_CreateEntry       (MUIB_IconList | 0x00000010) /* returns 0 For Failure or (struct IconEntry *), entry_dob NULL loads the icon in the background */
 #define MUIM_IconList_UpdateEntry       (MUIB_IconList | 0x00000011) /* returns 0 For Failure or (struct IconEntry *) */
 #define MUIM_IconList_DestroyEntry      (MUIB_IconList | 0x00000012)
 #define MUIM_IconList_PropagateEntryPos (MUIB_IconList | 0x00000013)
+#define MUIM_IconList_IconsLoaded       (MUIB_IconList | 0x00000014) /* private, pushed by the icon loader process */
 #define MUIM_IconList_DrawEntry         (MUIB_IconList | 0x00000020)
 #define MUIM_IconList_DrawEntryLabel    (MUIB_IconList | 0x00000021)
 #define MUIM_IconList_MakeEntryVisible  (MUIB_IconList | 0x00000024)
@@ -59,6 +60,7 @@ struct MUIP_IconList_CreateEntry        {STACKED ULONG MethodID; STACKED STRPTR
 struct MUIP_IconList_UpdateEntry        {STACKED ULONG MethodID; STACKED struct IconEntry *entry; STACKED STRPTR filename; STACKED STRPTR label; STACKED struct FileInfoBlock *fib; STACKED struct DiskObject *entry_dob; STACKED ULONG type;};
 struct MUIP_IconList_DestroyEntry       {STACKED ULONG MethodID; STACKED struct IconEntry *entry;};
 struct MUIP_IconList_PropagateEntryPos  {STACKED ULONG MethodID; STACKED struct IconEntry *entry;};
+struct MUIP_IconList_IconsLoaded        {STACKED ULONG MethodID;};
 struct MUIP_IconList_DrawEntry          {STACKED ULONG MethodID; STACKED struct IconEntry *entry; STACKED IPTR drawmode;};
 struct MUIP_IconList_DrawEntryLabel     {STACKED ULONG MethodID; STACKED struct IconEntry *entry; STACKED IPTR drawmode;};
 struct MUIP_IconList_NextIcon           {STACKED ULONG MethodID; STACKED IPTR nextflag; STACKED struct IconList_Entry **entry;};
@@ -134,6 +136,7 @@ struct IconEntry
     ULONG                       ie_TxtBuf_SIZEWidth;
     UBYTE                       *ie_TxtBuf_PROT;
 
+    struct IconLoadRequest      *ie_IconLoad;                   /* Set while ICONENTRY_FLAG_ICONPENDING and queued */
 
     APTR                        *ie_User1;                      /* Pointer to data provided by user */
 };
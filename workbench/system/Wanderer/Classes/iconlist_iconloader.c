@@ -0,0 +1,294 @@
+/*
+    Copyright (C) 2026, The AROS Development Team. All rights reserved.
+*/
+
+/*
+ * Background icon loading for IconList.
+ *
+ * Entries created without a DiskObject are shown with a default icon and
+ * queued here. A low priority process decodes the icons one by one with
+ * GetIconTags() and hands them back to the application task by pushing
+ * MUIM_IconList_IconsLoaded, so the IconList object itself is only ever
+ * touched by the application task. Requests only carry a copy of the
+ * file name; the entry pointer is used as a key by the application side.
+ */
+
+#define DEBUG 0
+#include <aros/debug.h>
+
+#include <exec/memory.h>
+#include <dos/dostags.h>
+#include <workbench/icon.h>
+
+#include <clib/alib_protos.h>
+
+#include <proto/exec.h>
+#include <proto/dos.h>
+#include <proto/icon.h>
+#include <proto/muimaster.h>
+
+#include <libraries/mui.h>
+#include "iconlist_attributes.h"
+#include "icon_attributes.h"
+#include "iconlist.h"
+#include "iconlist_private.h"
+
+static const char iconloader_procname[] = "Wanderer Icon Loader";
+
+VOID IconLoader_FreeRequest(struct IconLoadRequest *req)
+{
+    if (req->ilr_DiskObj)
+        FreeDiskObject(req->ilr_DiskObj);
+    FreeVec(req);
+}
+
+AROS_UFH3(void, IconLoader__Func_Process,
+        AROS_UFHA(STRPTR,              argPtr, A0),
+        AROS_UFHA(ULONG,               argSize, D0),
+        AROS_UFHA(struct ExecBase *,   SysBase, A6))
+{
+    AROS_USERFUNC_INIT
+
+    struct IconLoader           *ild = FindTask(NULL)->tc_UserData;
+    struct IconLoadRequest      *req;
+    IPTR                        geticon_error;
+
+    D(bug("[IconList] %s: started\n", __func__));
+
+    for (;;)
+    {
+        ObtainSemaphore(&ild->ild_Lock);
+        if (ild->ild_Quit)
+        {
+            ReleaseSemaphore(&ild->ild_Lock);
+            break;
+        }
+        req = (struct IconLoadRequest *)RemHead(&ild->ild_Pending);
+        ild->ild_Current = req;
+        ReleaseSemaphore(&ild->ild_Lock);
+
+        if (req == NULL)
+        {
+            /* Signals sent since we looked at the list are still pending */
+            Wait(SIGBREAKF_CTRL_C | SIGBREAKF_CTRL_F);
+            continue;
+        }
+
+        geticon_error = 0;
+        req->ilr_DiskObj = GetIconTags
+        (
+            req->ilr_Name,
+            ICONGETA_Screen,                   ild->ild_Screen,
+            ICONGETA_RemapIcon,                TRUE,
+            ICONGETA_FailIfUnavailable,        FALSE,
+            ICONGETA_GenerateImageMasks,       TRUE,
+            ICONA_ErrorCode,                   &geticon_error,
+            TAG_DONE
+        );
+
+        D(bug("[IconList] %s: '%s' DiskObject @ 0x%p (error code = 0x%p)\n", __func__,
+            req->ilr_Name, req->ilr_DiskObj, geticon_error));
+
+        ObtainSemaphore(&ild->ild_Lock);
+        ild->ild_Current = NULL;
+        if (req->ilr_Entry == NULL)
+        {
+            /* Entry destroyed while we were loading */
+            IconLoader_FreeRequest(req);
+        }
+        else
+        {
+            AddTail(&ild->ild_Loaded, &req->ilr_Node);
+            if (!ild->ild_Pushed)
+            {
+                ild->ild_Pushed = TRUE;
+                DoMethod(ild->ild_App, MUIM_Application_PushMethod,
+                    (IPTR)ild->ild_Obj, 1, MUIM_IconList_IconsLoaded);
+            }
+        }
+        ReleaseSemaphore(&ild->ild_Lock);
+    }
+
+    D(bug("[IconList] %s: exiting\n", __func__));
+
+    /* IconLoader_Stop() waits for this, we are gone once Forbid() is broken */
+    Forbid();
+    ild->ild_Process = NULL;
+    Signal(ild->ild_Parent, 1L << ild->ild_ExitSignal);
+
+    AROS_USERFUNC_EXIT
+}
+
+VOID IconLoader_Init(struct IconLoader *ild)
+{
+    InitSemaphore(&ild->ild_Lock);
+    NEWLIST(&ild->ild_Pending);
+    NEWLIST(&ild->ild_Loaded);
+}
+
+/* Must be called by the application task, with obj between MUIM_Setup and MUIM_Cleanup */
+BOOL IconLoader_Start(struct IconLoader *ild, Object *app, Object *obj, struct Screen *screen)
+{
+    if (ild->ild_Process)
+        return TRUE;
+
+    if ((ild->ild_ExitSignal = AllocSignal(-1)) == -1)
+        return FALSE;
+
+    ild->ild_Parent = FindTask(NULL);
+    ild->ild_App = app;
+    ild->ild_Obj = obj;
+    ild->ild_Screen = screen;
+    ild->ild_Quit = FALSE;
+    ild->ild_Pushed = FALSE;
+
+    ild->ild_Process = CreateNewProcTags(
+                            NP_Entry,       (IPTR)IconLoader__Func_Process,
+                            NP_Name,        (IPTR)iconloader_procname,
+                            NP_Synchronous, FALSE,
+                            NP_UserData,    (IPTR)ild,
+                            NP_Priority,    -1,
+                            NP_StackSize,   40000,
+                            TAG_DONE);
+
+    if (ild->ild_Process == NULL)
+    {
+        FreeSignal(ild->ild_ExitSignal);
+        return FALSE;
+    }
+
+    return TRUE;
+}
+
+/*
+ * Stop the process and forget all requests. The entries keep
+ * ICONENTRY_FLAG_ICONPENDING so they can be queued again later.
+ */
+VOID IconLoader_Stop(struct IconLoader *ild)
+{
+    struct IconLoadRequest      *req;
+
+    if (ild->ild_Process)
+    {
+        ObtainSemaphore(&ild->ild_Lock);
+        ild->ild_Quit = TRUE;
+        Signal(&ild->ild_Process->pr_Task, SIGBREAKF_CTRL_C);
+        ReleaseSemaphore(&ild->ild_Lock);
+
+        while (ild->ild_Process)
+            Wait(1L << ild->ild_ExitSignal);
+
+        FreeSignal(ild->ild_ExitSignal);
+
+        /* The application would otherwise deliver it after we are gone */
+        DoMethod(ild->ild_App, MUIM_Application_UnpushMethod,
+            (IPTR)ild->ild_Obj, 0, MUIM_IconList_IconsLoaded);
+        ild->ild_Pushed = FALSE;
+    }
+
+    while ((req = (struct IconLoadRequest *)RemHead(&ild->ild_Pending)) ||
+           (req = (struct IconLoadRequest *)RemHead(&ild->ild_Loaded)))
+    {
+        if (req->ilr_Entry)
+            req->ilr_Entry->ie_IconLoad = NULL;
+        IconLoader_FreeRequest(req);
+    }
+}
+
+/* Returns FALSE if the entry could not be queued, it then stays pending */
+BOOL IconLoader_Queue(struct IconLoader *ild, struct IconEntry *entry)
+{
+    struct IconLoadRequest      *req;
+    ULONG                       len;
+
+    if (entry->ie_IconLoad)
+        return TRUE;
+
+    if (ild->ild_Process == NULL)
+        return FALSE;
+
+    len = strlen(entry->ie_IconNode.ln_Name) + 1;
+    if ((req = AllocVec(sizeof(struct IconLoadRequest) + len, MEMF_ANY)) == NULL)
+        return FALSE;
+
+    req->ilr_Entry = entry;
+    req->ilr_DiskObj = NULL;
+    CopyMem(entry->ie_IconNode.ln_Name, req->ilr_Name, len);
+    entry->ie_IconLoad = req;
+
+    ObtainSemaphore(&ild->ild_Lock);
+    AddTail(&ild->ild_Pending, &req->ilr_Node);
+    ReleaseSemaphore(&ild->ild_Lock);
+
+    Signal(&ild->ild_Process->pr_Task, SIGBREAKF_CTRL_F);
+
+    return TRUE;
+}
+
+VOID IconLoader_Cancel(struct IconLoader *ild, struct IconEntry *entry)
+{
+    struct IconLoadRequest      *req = entry->ie_IconLoad;
+
+    if (req == NULL)
+        return;
+
+    ObtainSemaphore(&ild->ild_Lock);
+    if (req == ild->ild_Current)
+    {
+        /* The process frees it when done */
+        req->ilr_Entry = NULL;
+        req = NULL;
+    }
+    else
+        Remove(&req->ilr_Node);
+    ReleaseSemaphore(&ild->ild_Lock);
+
+    if (req)
+        IconLoader_FreeRequest(req);
+
+    entry->ie_IconLoad = NULL;
+}
+
+/*
+ * Move the requests of entries inside the view to the front of the queue,
+ * keeping their order. Called after layout and scrolling.
+ */
+VOID IconLoader_Prioritise(struct IconLoader *ild, struct Rectangle *view)
+{
+    struct IconLoadRequest      *req, *next;
+    struct List                 visible;
+
+    NEWLIST(&visible);
+
+    ObtainSemaphore(&ild->ild_Lock);
+
+    ForeachNodeSafe(&ild->ild_Pending, req, next)
+    {
+        struct IconEntry *entry = req->ilr_Entry;
+
+        if ((entry->ie_IconX != NO_ICON_POSITION) && (entry->ie_IconY != NO_ICON_POSITION) &&
+            (entry->ie_IconX <= view->MaxX) && (entry->ie_IconX + (LONG)entry->ie_AreaWidth > view->MinX) &&
+            (entry->ie_IconY <= view->MaxY) && (entry->ie_IconY + (LONG)entry->ie_AreaHeight > view->MinY))
+        {
+            Remove(&req->ilr_Node);
+            AddTail(&visible, &req->ilr_Node);
+        }
+    }
+
+    while ((req = (struct IconLoadRequest *)RemTail(&visible)))
+        AddHead(&ild->ild_Pending, &req->ilr_Node);
+
+    ReleaseSemaphore(&ild->ild_Lock);
+}
+
+/* Take the decoded requests, the caller frees them with IconLoader_FreeRequest() */
+VOID IconLoader_TakeLoaded(struct IconLoader *ild, struct List *loaded)
+{
+    struct IconLoadRequest      *req;
+
+    ObtainSemaphore(&ild->ild_Lock);
+    while ((req = (struct IconLoadRequest *)RemHead(&ild->ild_Loaded)))
+        AddTail(loaded, &req->ilr_Node);
+    ild->ild_Pushed = FALSE;
+    ReleaseSemaphore(&ild->ild_Lock);
+}
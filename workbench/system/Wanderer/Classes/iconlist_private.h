@@ -1,5 +1,5 @@
 /*
-    Copyright (C) 1995-2013, The AROS Development Team. All rights reserved.
+    Copyright (C) 1995-2026, The AROS Development Team. All rights reserved.
 */
 
 #ifndef _ICONLIST_PRIVATE_H_
@@ -45,6 +45,40 @@ struct ListViewModeAttribs
 #define LVMCF_COLCLICKABLE    (1<<1)
 #define LVMCF_COLSORTABLE    (1<<2)
 
+/* Asynchronous icon loading, see iconlist_iconloader.c */
+struct IconLoadRequest
+{
+    struct Node                   ilr_Node;
+    struct IconEntry              *ilr_Entry;                         /* NULL once the entry is gone */
+    struct DiskObject             *ilr_DiskObj;                       /* Result, NULL on failure */
+    char                          ilr_Name[];
+};
+
+struct IconLoader
+{
+    struct SignalSemaphore        ild_Lock;                           /* Protects everything below */
+    struct List                   ild_Pending;                        /* IconLoadRequest(s) in load order */
+    struct List                   ild_Loaded;                         /* Decoded, waiting for MUIM_IconList_IconsLoaded */
+    struct IconLoadRequest        *ild_Current;                       /* Being decoded by the loader process */
+    struct Process                *ild_Process;
+    struct Task                   *ild_Parent;
+    Object                        *ild_App;
+    Object                        *ild_Obj;
+    struct Screen                 *ild_Screen;
+    BYTE                          ild_ExitSignal;
+    BOOL                          ild_Quit;
+    BOOL                          ild_Pushed;                         /* MUIM_IconList_IconsLoaded is queued at the application */
+};
+
+VOID IconLoader_Init(struct IconLoader *ild);
+BOOL IconLoader_Start(struct IconLoader *ild, Object *app, Object *obj, struct Screen *screen);
+VOID IconLoader_Stop(struct IconLoader *ild);
+BOOL IconLoader_Queue(struct IconLoader *ild, struct IconEntry *entry);
+VOID IconLoader_Cancel(struct IconLoader *ild, struct IconEntry *entry);
+VOID IconLoader_Prioritise(struct IconLoader *ild, struct Rectangle *view);
+VOID IconLoader_TakeLoaded(struct IconLoader *ild, struct List *loaded);
+VOID IconLoader_FreeRequest(struct IconLoadRequest *req);
+
 struct IconList_DATA
 {
     APTR                          icld_Pool;                          /* Pool to allocate data from */
@@ -120,6 +154,10 @@ struct IconList_DATA
 
     struct ListViewModeAttribs    *icld_LVMAttribs;
 
+    struct IconLoader             icld_IconLoader;
+    struct DiskObject             *icld_PendingDrawerIcon;            /* Shown for entries whose own icon is not loaded yet */
+    struct DiskObject             *icld_PendingFileIcon;
+
     /* TODO: move config options to a seperate struct */
     /* IconList configuration settings ... */
     ULONG                         icld_LabelPen;        
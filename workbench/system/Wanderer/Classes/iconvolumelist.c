@@ -1,5 +1,5 @@
 /*
-    Copyright  2002-2023, The AROS Development Team. All rights reserved.
+    Copyright  2002-2026, The AROS Development Team. All rights reserved.
 */
 
 #define DEBUG 0
@@ -613,7 +613,8 @@ IPTR IconVolumeList__MUIM_IconList_Update(struct IClass * CLASS,
                             entrychanged = TRUE;
                         }
 
-                        if (!(volDOB))
+                        /* A pending icon is delivered by the icon loader */
+                        if (!(volDOB) && !(this_Icon->ie_Flags & ICONENTRY_FLAG_ICONPENDING))
                         {
                             IPTR iconlistScreen = (IPTR)_screen(obj);
                             IPTR geticon_error = 0;
@@ -1,5 +1,5 @@
 /*
-  Copyright (C) 2004-2020, The AROS Development Team. All rights reserved.
+  Copyright (C) 2004-2026, The AROS Development Team. All rights reserved.
 */
 
 #define DEBUG 0
@@ -1615,6 +1615,13 @@ IPTR IconWindow__MUIM_IconWindow_Snapshot
                      * 3) select icon->snapshot */
                     D(bug("[Wanderer:IconWindow] %s: SNAPSHOT entry = '%s' @ %p, (%p)\n", __PRETTY_FUNCTION__,
                             icon_entry->ile_IconEntry->ie_IconNode.ln_Name, icon_entry, node));
+
+                    /* The background loader may not have got to this icon yet */
+                    if (node->ie_Flags & ICONENTRY_FLAG_ICONPENDING)
+                        DoMethod(iconList, MUIM_IconList_UpdateEntry, (IPTR)node, (IPTR)node->ie_IconNode.ln_Name,
+                            (IPTR)node->ie_IconListEntry.label, (IPTR)node->ie_FileInfoBlock, (IPTR)NULL,
+                            node->ie_IconListEntry.type);
+
                     if (node->ie_DiskObj)
                     {
                         node->ie_DiskObj->do_CurrentX = node->ie_IconX;
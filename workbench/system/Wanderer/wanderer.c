@@ -1,5 +1,5 @@
 /*
-    Copyright (C) 2004-2023, The AROS Development Team. All rights reserved.
+    Copyright (C) 2004-2026, The AROS Development Team. All rights reserved.
 */
 
 #define ZCC_QUIET
@@ -597,6 +597,7 @@ D(bug("[Wanderer] %s: ICONWINDOW_ACTION_OPEN: offset = %d, buf = %s\n", __func__
                     if ( !OpenWorkbenchObjectA(ent->ile_IconEntry->ie_IconNode.ln_Name, argsTagList) )
                     {
                         if ((ent->ile_IconEntry->ie_Flags & ICONENTRY_FLAG_ISONLYICON) &&
+                            (ent->ile_IconEntry->ie_DiskObj != NULL) &&
                             (ent->ile_IconEntry->ie_DiskObj->do_Type == WBDRAWER ||
                             ent->ile_IconEntry->ie_DiskObj->do_Type == WBDISK))
                         {
@@ -2033,6 +2034,13 @@ void wanderer_menufunc_icon_snapshot(IPTR *flags)
             node = (struct IconEntry *)((IPTR)entry - ((IPTR)&node->ie_IconListEntry - (IPTR)node));
             D(bug("[Wanderer] %s: %s entry = '%s' @ %p, (%p)\n", __func__,
                     (snapshot) ? "SNAPSHOT" : "UNSNAPSHOT", entry->ile_IconEntry->ie_IconNode.ln_Name, entry, node));
+
+            /* The background loader may not have got to this icon yet */
+            if (node->ie_Flags & ICONENTRY_FLAG_ICONPENDING)
+                DoMethod(iconList, MUIM_IconList_UpdateEntry, (IPTR)node, (IPTR)node->ie_IconNode.ln_Name,
+                    (IPTR)node->ie_IconListEntry.label, (IPTR)node->ie_FileInfoBlock, (IPTR)NULL,
+                    node->ie_IconListEntry.type);
+
             if (node->ie_DiskObj)
             {
                 if (snapshot)